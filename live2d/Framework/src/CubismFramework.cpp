@@ -34,6 +34,7 @@ csmBool                           s_isInitialized = false;
 ICubismAllocator*                 s_allocator = NULL;
 const CubismFramework::Option*    s_option = NULL;
 CubismIdManager*                  s_cubismIdManager = NULL;
+ICubismJobSystem*                 s_jobSystem = NULL;
 
 }
 
@@ -100,6 +101,7 @@ void CubismFramework::CleanUp()
     s_allocator = NULL;
     s_option = NULL;
     s_cubismIdManager = NULL;
+    s_jobSystem = NULL;
 #ifdef CSM_DEBUG_MEMORY_LEAKING
     s_allocationList = NULL;
 #endif
@@ -218,11 +220,21 @@ CubismIdManager* CubismFramework::GetIdManager()
     return s_cubismIdManager;
 }
 
+void CubismFramework::SetJobSystem(ICubismJobSystem* jobSystem)
+{
+    s_jobSystem = jobSystem;
+}
+
+ICubismJobSystem* CubismFramework::GetJobSystem()
+{
+    return s_jobSystem;
+}
+
 #ifdef CSM_DEBUG_MEMORY_LEAKING
 
 void* CubismFramework::Allocate(csmSizeType size, const csmChar* fileName, csmInt32 lineNumber)
 {
-    void* address = GetAllocator()->Allocate(size);
+    void* address = GetAllocator()->AllocateWithLocation(size, fileName, lineNumber);
 
     CubismLogVerbose("CubismFramework::Allocate(0x%p, %dbytes) %s(%d)", address, size, fileName, lineNumber);
 
@@ -236,7 +248,7 @@ void* CubismFramework::Allocate(csmSizeType size, const csmChar* fileName, csmIn
 
 void* CubismFramework::AllocateAligned(csmSizeType size, csmUint32 alignment, const csmChar* fileName, csmInt32 lineNumber)
 {
-    void* address = GetAllocator()->AllocateAligned(size, alignment);
+    void* address = GetAllocator()->AllocateAlignedWithLocation(size, alignment, fileName, lineNumber);
 
     CubismLogVerbose("CubismFramework::AllocateAligned(0x%p, a:%d, %dbytes) %s(%d)", address, alignment, size, fileName, lineNumber);
 
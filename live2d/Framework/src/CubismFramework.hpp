@@ -25,6 +25,7 @@
 //========================================================
 #include <new>
 #include "ICubismAllocator.hpp"
+#include "ICubismJobSystem.hpp"
 
 #ifdef __linux__
 #include <cstdlib>
@@ -314,6 +315,20 @@ public:
      */
     static CubismIdManager* GetIdManager();
 
+    /**
+     * Sets the job system used to execute the Framework processes in parallel.
+     *
+     * @param jobSystem Instance of job system. If `NULL` is set, the processes are executed serially.
+     */
+    static void SetJobSystem(ICubismJobSystem* jobSystem);
+
+    /**
+     * Returns the job system set by SetJobSystem().
+     *
+     * @return Instance of job system if set; otherwise `NULL`
+     */
+    static ICubismJobSystem* GetJobSystem();
+
 #ifdef CSM_DEBUG_MEMORY_LEAKING
 
     /**
@@ -24,6 +24,14 @@
  */
 // #define CSM_DEBUG_MEMORY_LEAKING
 
+/**
+ * Records tracing spans marked with CSM_TRACE_SCOPE in Cubism Framework and the application.
+ *
+ * @note Spans are kept in per-thread ring buffers and exported with Utils::CubismTrace::WriteChromeTrace().
+ *       When not defined, the macros expand to nothing.
+ */
+// #define CSM_TRACE
+
 
 /**
  * A set of macros to configure the logging level forcefully.
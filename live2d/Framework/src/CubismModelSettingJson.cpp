@@ -77,6 +77,12 @@ const csmChar* Val = "val";
 #if defined(__clang__)
 #pragma clang diagnostic pop
 #endif
+
+/// Returns true if the node holds a value.
+csmBool IsExistValue(Utils::Value& node)
+{
+    return !node.IsNull() && !node.IsError();
+}
 }
 
 // キーが存在するかどうかのチェック
@@ -122,62 +128,39 @@ csmBool CubismModelSettingJson::IsExistMotionGroups() const
 }
 csmBool CubismModelSettingJson::IsExistMotionGroupName(const csmChar* groupName) const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName];
-    return !node.IsNull() && !node.IsError();
+    return FindMotionGroup(groupName) != NULL;
 }
 csmBool CubismModelSettingJson::IsExistMotionSoundFile(const csmChar* groupName, csmInt32 index) const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName][index][SoundPath];
-    return !node.IsNull() && !node.IsError();
+    const MotionSetting* motion = FindMotion(groupName, index);
+    return motion != NULL && motion->IsExistSoundFile;
 }
 csmBool CubismModelSettingJson::IsExistMotionFadeIn(const csmChar* groupName, csmInt32 index) const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeInTime];
-    return !node.IsNull() && !node.IsError();
+    const MotionSetting* motion = FindMotion(groupName, index);
+    return motion != NULL && motion->IsExistFadeIn;
 }
 csmBool CubismModelSettingJson::IsExistMotionFadeOut(const csmChar* groupName, csmInt32 index) const
 {
-    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeOutTime];
-    return !node.IsNull() && !node.IsError();
+    const MotionSetting* motion = FindMotion(groupName, index);
+    return motion != NULL && motion->IsExistFadeOut;
 }
 csmBool CubismModelSettingJson::IsExistUserDataFile() const { return !_json->GetRoot()[FileReferences][UserData].IsNull(); }
 
 
 csmBool CubismModelSettingJson::IsExistEyeBlinkParameters() const
 {
-    if (_jsonValue[FrequentNode_Groups]->IsNull() || _jsonValue[FrequentNode_Groups]->IsError())
-    {
-        return false;
-    }
-
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); ++i)
-    {
-        if (strcmp((*_jsonValue[FrequentNode_Groups])[i][Name].GetRawString(), EyeBlink) == 0)
-        {
-            return true;
-        }
-    }
-    return false;
+    return _isExistEyeBlinkParameters;
 }
 
 csmBool CubismModelSettingJson::IsExistLipSyncParameters() const
 {
-    if (_jsonValue[FrequentNode_Groups]->IsNull() || _jsonValue[FrequentNode_Groups]->IsError())
-    {
-        return false;
-    }
-
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); ++i)
-    {
-        if (strcmp((*_jsonValue[FrequentNode_Groups])[i][Name].GetRawString(), LipSync) == 0)
-        {
-            return true;
-        }
-    }
-    return false;
+    return _isExistLipSyncParameters;
 }
 
 CubismModelSettingJson::CubismModelSettingJson(const csmByte* buffer, csmSizeInt size)
+    : _isExistEyeBlinkParameters(false)
+    , _isExistLipSyncParameters(false)
 {
     CreateCubismJson(buffer, size);
 
@@ -195,6 +178,8 @@ CubismModelSettingJson::CubismModelSettingJson(const csmByte* buffer, csmSizeInt
         _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][Physics]));
         _jsonValue.PushBack(&(_json->GetRoot()[FileReferences][Pose]));
         _jsonValue.PushBack(&(_json->GetRoot()[HitAreas]));
+
+        FlattenSettings();
     }
 }
 
@@ -203,6 +188,141 @@ CubismModelSettingJson::~CubismModelSettingJson()
     DeleteCubismJson();
 }
 
+void CubismModelSettingJson::FlattenSettings()
+{
+    // モーショングループはキーの順番のまま、モーションは全グループを一つの配列にまとめる
+    // Keep the Motion Groups in key order and pack the Motions of every group into one array.
+    if (IsExistMotionGroups())
+    {
+        Utils::Value& motions = *_jsonValue[FrequentNode_Motions];
+        csmVector<csmString>& groupNames = motions.GetKeys();
+
+        for (csmUint32 i = 0; i < groupNames.GetSize(); ++i)
+        {
+            const csmString& groupName = groupNames[i];
+            Utils::Value& group = motions[groupName];
+
+            MotionGroupSetting groupSetting;
+            groupSetting.Name = groupName.GetRawString();
+            groupSetting.NameHash = Utils::Map::HashKey(groupName.GetRawString(), groupName.GetLength());
+            groupSetting.IsExist = IsExistValue(group);
+            groupSetting.BaseMotionIndex = static_cast<csmInt32>(_motions.GetSize());
+            groupSetting.MotionCount = groupSetting.IsExist ? group.GetSize() : 0;
+
+            for (csmInt32 j = 0; j < groupSetting.MotionCount; ++j)
+            {
+                Utils::Value& motion = group[j];
+                Utils::Value& fileName = motion[FilePath];
+                Utils::Value& soundFileName = motion[SoundPath];
+                Utils::Value& fadeInTime = motion[FadeInTime];
+                Utils::Value& fadeOutTime = motion[FadeOutTime];
+
+                MotionSetting motionSetting;
+                motionSetting.FileName = IsExistValue(fileName) ? fileName.GetRawString() : "";
+                motionSetting.IsExistSoundFile = IsExistValue(soundFileName);
+                motionSetting.SoundFileName = motionSetting.IsExistSoundFile ? soundFileName.GetRawString() : "";
+                motionSetting.IsExistFadeIn = IsExistValue(fadeInTime);
+                motionSetting.FadeInTime = motionSetting.IsExistFadeIn ? fadeInTime.ToFloat() : -1.0f;
+                motionSetting.IsExistFadeOut = IsExistValue(fadeOutTime);
+                motionSetting.FadeOutTime = motionSetting.IsExistFadeOut ? fadeOutTime.ToFloat() : -1.0f;
+                _motions.PushBack(motionSetting, false);
+            }
+
+            _motionGroups.PushBack(groupSetting, false);
+        }
+    }
+
+    if (IsExistExpressionFile())
+    {
+        Utils::Value& expressions = *_jsonValue[FrequentNode_Expressions];
+
+        for (csmInt32 i = 0; i < expressions.GetSize(); ++i)
+        {
+            ExpressionSetting expressionSetting;
+            expressionSetting.Name = expressions[i][Name].GetRawString();
+            expressionSetting.FileName = expressions[i][FilePath].GetRawString();
+            _expressions.PushBack(expressionSetting, false);
+        }
+    }
+
+    if (IsExistHitAreas())
+    {
+        Utils::Value& hitAreas = *_jsonValue[FrequentNode_HitAreas];
+
+        for (csmInt32 i = 0; i < hitAreas.GetSize(); ++i)
+        {
+            HitAreaSetting hitAreaSetting;
+            hitAreaSetting.Id = CubismFramework::GetIdManager()->GetId(hitAreas[i][Id].GetRawString());
+            hitAreaSetting.Name = hitAreas[i][Name].GetRawString();
+            _hitAreas.PushBack(hitAreaSetting, false);
+        }
+    }
+
+    _isExistEyeBlinkParameters = FlattenParameterGroup(EyeBlink, _eyeBlinkParameterIds);
+    _isExistLipSyncParameters = FlattenParameterGroup(LipSync, _lipSyncParameterIds);
+}
+
+csmBool CubismModelSettingJson::FlattenParameterGroup(const csmChar* groupName, csmVector<CubismIdHandle>& outIds) const
+{
+    Utils::Value& groups = *_jsonValue[FrequentNode_Groups];
+    if (!IsExistValue(groups))
+    {
+        return false;
+    }
+
+    for (csmInt32 i = 0; i < groups.GetSize(); ++i)
+    {
+        Utils::Value& group = groups[i];
+        if (!IsExistValue(group))
+        {
+            continue;
+        }
+
+        if (strcmp(group[Name].GetRawString(), groupName) == 0)
+        {
+            Utils::Value& ids = group[Ids];
+            const csmInt32 idCount = ids.IsArray() ? ids.GetSize() : 0;
+
+            for (csmInt32 j = 0; j < idCount; ++j)
+            {
+                outIds.PushBack(CubismFramework::GetIdManager()->GetId(ids[j].GetRawString()), false);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+const CubismModelSettingJson::MotionGroupSetting* CubismModelSettingJson::FindMotionGroup(const csmChar* groupName) const
+{
+    if (groupName == NULL)
+    {
+        return NULL;
+    }
+
+    const csmUint32 nameHash = Utils::Map::HashKey(groupName, static_cast<csmInt32>(strlen(groupName)));
+
+    for (csmUint32 i = 0; i < _motionGroups.GetSize(); ++i)
+    {
+        const MotionGroupSetting& group = _motionGroups[i];
+        if (group.NameHash == nameHash && strcmp(group.Name, groupName) == 0)
+        {
+            return group.IsExist ? &group : NULL;
+        }
+    }
+    return NULL;
+}
+
+const CubismModelSettingJson::MotionSetting* CubismModelSettingJson::FindMotion(const csmChar* groupName, csmInt32 index) const
+{
+    const MotionGroupSetting* group = FindMotionGroup(groupName);
+    if (group == NULL || index < 0 || group->MotionCount <= index)
+    {
+        return NULL;
+    }
+    return &_motions[group->BaseMotionIndex + index];
+}
+
 Utils::CubismJson* CubismModelSettingJson::GetJsonPointer() const
 {
     return _json;
@@ -270,18 +390,19 @@ const csmChar* CubismModelSettingJson::GetTextureFileName(csmInt32 index)
 // あたり判定について
 csmInt32 CubismModelSettingJson::GetHitAreasCount()
 {
-    if (!IsExistHitAreas())return 0;
-    return (*_jsonValue[FrequentNode_HitAreas]).GetSize();
+    return static_cast<csmInt32>(_hitAreas.GetSize());
 }
 
 CubismIdHandle CubismModelSettingJson::GetHitAreaId(csmInt32 index)
 {
-    return CubismFramework::GetIdManager()->GetId((*_jsonValue[FrequentNode_HitAreas])[index][Id].GetRawString());
+    if (index < 0 || GetHitAreasCount() <= index)return NULL;
+    return _hitAreas[index].Id;
 }
 
 const csmChar* CubismModelSettingJson::GetHitAreaName(csmInt32 index)
 {
-    return (*_jsonValue[FrequentNode_HitAreas])[index][Name].GetRawString();
+    if (index < 0 || GetHitAreasCount() <= index)return "";
+    return _hitAreas[index].Name;
 }
 
 // 物理演算、表示名称、パーツ切り替え、表情ファイルについて
@@ -305,67 +426,69 @@ const csmChar* CubismModelSettingJson::GetDisplayInfoFileName()
 
 csmInt32 CubismModelSettingJson::GetExpressionCount()
 {
-    if (!IsExistExpressionFile())return 0;
-    return (*_jsonValue[FrequentNode_Expressions]).GetSize();
+    return static_cast<csmInt32>(_expressions.GetSize());
 }
 
 const csmChar* CubismModelSettingJson::GetExpressionName(csmInt32 index)
 {
-    return (*_jsonValue[FrequentNode_Expressions])[index][Name].GetRawString();
+    if (index < 0 || GetExpressionCount() <= index)return "";
+    return _expressions[index].Name;
 }
 
 const csmChar* CubismModelSettingJson::GetExpressionFileName(csmInt32 index)
 {
-    return (*_jsonValue[FrequentNode_Expressions])[index][FilePath].GetRawString();
+    if (index < 0 || GetExpressionCount() <= index)return "";
+    return _expressions[index].FileName;
 }
 
 // モーションについて
 csmInt32 CubismModelSettingJson::GetMotionGroupCount()
 {
-    if (!IsExistMotionGroups())
-    {
-        return 0;
-    }
-    return (*_jsonValue[FrequentNode_Motions]).GetKeys().GetSize();
+    return static_cast<csmInt32>(_motionGroups.GetSize());
 }
 
 const csmChar* CubismModelSettingJson::GetMotionGroupName(csmInt32 index)
 {
-    if (!IsExistMotionGroups())
+    if (index < 0 || GetMotionGroupCount() <= index)
     {
         return NULL;
     }
-    return (*_jsonValue[FrequentNode_Motions]).GetKeys()[index].GetRawString();
+    return _motionGroups[index].Name;
 }
 
 csmInt32 CubismModelSettingJson::GetMotionCount(const csmChar* groupName)
 {
-    if (!IsExistMotionGroupName(groupName))return 0;
-    return (*_jsonValue[FrequentNode_Motions])[groupName].GetSize();
+    const MotionGroupSetting* group = FindMotionGroup(groupName);
+    if (group == NULL)return 0;
+    return group->MotionCount;
 }
 
 const csmChar* CubismModelSettingJson::GetMotionFileName(const csmChar* groupName, csmInt32 index)
 {
-    if (!IsExistMotionGroupName(groupName))return "";
-    return (*_jsonValue[FrequentNode_Motions])[groupName][index][FilePath].GetRawString();
+    const MotionSetting* motion = FindMotion(groupName, index);
+    if (motion == NULL)return "";
+    return motion->FileName;
 }
 
 const csmChar* CubismModelSettingJson::GetMotionSoundFileName(const csmChar* groupName, csmInt32 index)
 {
-    if (!IsExistMotionSoundFile(groupName, index))return "";
-    return (*_jsonValue[FrequentNode_Motions])[groupName][index][SoundPath].GetRawString();
+    const MotionSetting* motion = FindMotion(groupName, index);
+    if (motion == NULL)return "";
+    return motion->SoundFileName;
 }
 
 csmFloat32 CubismModelSettingJson::GetMotionFadeInTimeValue(const csmChar* groupName, csmInt32 index)
 {
-    if (!IsExistMotionFadeIn(groupName, index))return -1.0f;
-    return (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeInTime].ToFloat();
+    const MotionSetting* motion = FindMotion(groupName, index);
+    if (motion == NULL)return -1.0f;
+    return motion->FadeInTime;
 }
 
 csmFloat32 CubismModelSettingJson::GetMotionFadeOutTimeValue(const csmChar* groupName, csmInt32 index)
 {
-    if (!IsExistMotionFadeOut(groupName, index))return -1.0f;
-    return (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeOutTime].ToFloat();
+    const MotionSetting* motion = FindMotion(groupName, index);
+    if (motion == NULL)return -1.0f;
+    return motion->FadeOutTime;
 }
 
 
@@ -397,100 +520,30 @@ csmBool CubismModelSettingJson::GetLayoutMap(csmMap<csmString, csmFloat32>& outL
 
 csmInt32 CubismModelSettingJson::GetEyeBlinkParameterCount()
 {
-    if (!IsExistEyeBlinkParameters())
-    {
-        return 0;
-    }
-
-    csmInt32 num = 0;
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); i++)
-    {
-        Utils::Value& refI = (*_jsonValue[FrequentNode_Groups])[i];
-        if(refI.IsNull() || refI.IsError())
-        {
-            continue;
-        }
-
-        if (strcmp(refI[Name].GetRawString(), EyeBlink) == 0)
-        {
-            num = refI[Ids].GetVector()->GetSize();
-            break;
-        }
-    }
-
-    return num;
+    return static_cast<csmInt32>(_eyeBlinkParameterIds.GetSize());
 }
 
 CubismIdHandle CubismModelSettingJson::GetEyeBlinkParameterId(csmInt32 index)
 {
-    if (!IsExistEyeBlinkParameters())
+    if (index < 0 || GetEyeBlinkParameterCount() <= index)
     {
         return NULL;
     }
-
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); i++)
-    {
-        Utils::Value& refI = (*_jsonValue[FrequentNode_Groups])[i];
-        if (refI.IsNull() || refI.IsError())
-        {
-            continue;
-        }
-
-        if (strcmp(refI[Name].GetRawString(), EyeBlink) == 0)
-        {
-            return CubismFramework::GetIdManager()->GetId(refI[Ids][index].GetRawString());
-        }
-    }
-    return NULL;
+    return _eyeBlinkParameterIds[index];
 }
 
 csmInt32 CubismModelSettingJson::GetLipSyncParameterCount()
 {
-    if (!IsExistLipSyncParameters())
-    {
-        return 0;
-    }
-
-    csmInt32 num = 0;
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); i++)
-    {
-        Utils::Value& refI = (*_jsonValue[FrequentNode_Groups])[i];
-        if (refI.IsNull() || refI.IsError())
-        {
-            continue;
-        }
-
-        if (strcmp(refI[Name].GetRawString(), LipSync) == 0)
-        {
-            num = refI[Ids].GetVector()->GetSize();
-            break;
-        }
-    }
-
-    return num;
+    return static_cast<csmInt32>(_lipSyncParameterIds.GetSize());
 }
 
 CubismIdHandle CubismModelSettingJson::GetLipSyncParameterId(csmInt32 index)
 {
-    if (!IsExistLipSyncParameters())
+    if (index < 0 || GetLipSyncParameterCount() <= index)
     {
         return NULL;
     }
-
-    for (csmInt32 i = 0; i < _jsonValue[FrequentNode_Groups]->GetSize(); i++)
-    {
-        Utils::Value& refI = (*_jsonValue[FrequentNode_Groups])[i];
-        if (refI.IsNull() || refI.IsError())
-        {
-            continue;
-        }
-
-        if (strcmp(refI[Name].GetRawString(), LipSync) == 0)
-        {
-            return CubismFramework::GetIdManager()->GetId(refI[Ids][index].GetRawString());
-        }
-    }
-    return NULL;
+    return _lipSyncParameterIds[index];
 }
 
 }}}
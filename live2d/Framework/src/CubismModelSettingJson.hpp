@@ -387,7 +387,95 @@ private:
      */
     csmBool IsExistLipSyncParameters() const;
 
+    /**
+     * Motion flattened from the Model Settings File.
+     */
+    struct MotionSetting
+    {
+        const csmChar* FileName;            ///< Name of Motion File
+        const csmChar* SoundFileName;       ///< Name of Audio File; empty if it does not exist
+        csmFloat32 FadeInTime;              ///< Fade-in time in seconds; -1 if it does not exist
+        csmFloat32 FadeOutTime;             ///< Fade-out time in seconds; -1 if it does not exist
+        csmBool IsExistSoundFile;           ///< Whether Audio File information exists
+        csmBool IsExistFadeIn;              ///< Whether Fade-in time exists
+        csmBool IsExistFadeOut;             ///< Whether Fade-out time exists
+    };
+
+    /**
+     * Motion Group flattened from the Model Settings File.
+     */
+    struct MotionGroupSetting
+    {
+        const csmChar* Name;                ///< Name of Motion Group
+        csmUint32 NameHash;                 ///< Hash of the name
+        csmBool IsExist;                    ///< Whether the Motion Group has a value
+        csmInt32 BaseMotionIndex;           ///< Index of the first Motion in _motions
+        csmInt32 MotionCount;               ///< Number of Motions
+    };
+
+    /**
+     * Expression flattened from the Model Settings File.
+     */
+    struct ExpressionSetting
+    {
+        const csmChar* Name;                ///< Name of Expression
+        const csmChar* FileName;            ///< Name of Expression File
+    };
+
+    /**
+     * Hit Area flattened from the Model Settings File.
+     */
+    struct HitAreaSetting
+    {
+        CubismIdHandle Id;                  ///< ID of Drawable
+        const csmChar* Name;                ///< Name of Hit Area
+    };
+
+    /**
+     * Flattens the frequently accessed settings into arrays.<br>
+     * Strings refer to the JSON document, which lives as long as this instance.
+     */
+    void FlattenSettings();
+
+    /**
+     * Collects the parameter IDs of the first parameter group with the specified name.
+     *
+     * @param groupName Name of the parameter group
+     * @param outIds IDs of the parameters
+     *
+     * @return true if the parameter group exists; otherwise false
+     */
+    csmBool FlattenParameterGroup(const csmChar* groupName, csmVector<CubismIdHandle>& outIds) const;
+
+    /**
+     * Returns the Motion Group with the specified name.
+     *
+     * @param groupName Name of the desired Motion Group
+     *
+     * @return Motion Group if it exists and has a value; otherwise NULL
+     */
+    const MotionGroupSetting* FindMotionGroup(const csmChar* groupName) const;
+
+    /**
+     * Returns the Motion in the Motion Group with the specified name.
+     *
+     * @param groupName Name of the desired Motion Group
+     * @param index Index to the desired Motion
+     *
+     * @return Motion if it exists; otherwise NULL
+     */
+    const MotionSetting* FindMotion(const csmChar* groupName, csmInt32 index) const;
+
     /** Cache of JSON nodes */
     csmVector<Utils::Value*>    _jsonValue;
+
+    csmVector<MotionGroupSetting>   _motionGroups;              ///< Motion Groups in the order of the JSON keys
+    csmVector<MotionSetting>        _motions;                   ///< Motions of all Motion Groups
+    csmVector<ExpressionSetting>    _expressions;               ///< Expressions
+    csmVector<HitAreaSetting>       _hitAreas;                  ///< Hit Areas
+    csmVector<CubismIdHandle>       _eyeBlinkParameterIds;      ///< IDs of the Eye Blinking parameters
+    csmVector<CubismIdHandle>       _lipSyncParameterIds;       ///< IDs of the Lip-sync parameters
+    csmBool                         _isExistEyeBlinkParameters; ///< Whether the Eye Blinking parameter group exists
+    csmBool                         _isExistLipSyncParameters;  ///< Whether the Lip-sync parameter group exists
 };
 }}}
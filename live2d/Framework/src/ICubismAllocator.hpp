@@ -57,5 +57,39 @@ public:
      */
     virtual void DeallocateAligned(void* alignedMemory) = 0;
 
+    /**
+     * (For debugging) Allocates the memory with the location of the caller.
+     *
+     * @note Called instead of Allocate() when CSM_DEBUG_MEMORY_LEAKING is defined.<br>
+     *       The default implementation ignores the location.
+     *
+     * @param size Desired amount of memory in bytes
+     * @param fileName Name of source code that called
+     * @param lineNumber Number of line of source code that called
+     *
+     * @return Pointer to the allocated memory if succeeded; otherwise `0`
+     */
+    virtual void* AllocateWithLocation(const csmSizeType size, const csmChar* /*fileName*/, csmInt32 /*lineNumber*/)
+    {
+        return Allocate(size);
+    }
+
+    /**
+     * (For debugging) Allocates the memory with specified alignment and the location of the caller.
+     *
+     * @note Called instead of AllocateAligned() when CSM_DEBUG_MEMORY_LEAKING is defined.<br>
+     *       The default implementation ignores the location.
+     *
+     * @param size Desired amount of memory in bytes
+     * @param alignment Desired alignment of memory in bytes
+     * @param fileName Name of source code that called
+     * @param lineNumber Number of line of source code that called
+     *
+     * @return Pointer to the allocated memory if succeeded; otherwise `0`
+     */
+    virtual void* AllocateAlignedWithLocation(const csmSizeType size, const csmUint32 alignment, const csmChar* /*fileName*/, csmInt32 /*lineNumber*/)
+    {
+        return AllocateAligned(size, alignment);
+    }
 };
 }}}
@@ -0,0 +1,46 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "Type/CubismBasicType.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * An interface to implement parallel job execution<br>
+ * on the platform side and call from the Framework.
+ */
+class ICubismJobSystem
+{
+public:
+    /**
+     * Function executed for each job.
+     *
+     * @param context Context passed to Dispatch()
+     * @param jobIndex Index of the job in the range [0, jobCount)
+     */
+    typedef void (*JobFunction)(void* context, csmInt32 jobIndex);
+
+    /**
+     * Destructor
+     */
+    virtual ~ICubismJobSystem() {}
+
+    /**
+     * Executes the jobs and waits until all of them are completed.
+     *
+     * @param function Function executed for each job
+     * @param context Context passed to the function
+     * @param jobCount Number of jobs
+     *
+     * @note The jobs may be executed in any order and on any thread, including the calling thread.<br>
+     * Implementations must execute the jobs inline when they cannot be dispatched, e.g. on nested calls.
+     */
+    virtual void Dispatch(JobFunction function, void* context, csmInt32 jobCount) = 0;
+};
+}}}
@@ -11,15 +11,18 @@
 namespace Live2D { namespace Cubism { namespace Framework {
 
 CubismId::CubismId()
+                        : _hash(CalculateHash("", 0))
 { }
 
 CubismId::CubismId(const CubismId& c)
                         : _id(c._id)
+                        , _hash(c._hash)
 { }
 
 CubismId::CubismId(const csmChar* id)
 {
     _id = id;
+    _hash = CalculateHash(_id.GetRawString(), _id.GetLength());
 }
 
 CubismId::~CubismId()
@@ -30,6 +33,7 @@ CubismId& CubismId::operator=(const CubismId& c)
     if (this != &c)
     {
         _id = c._id;
+        _hash = c._hash;
     }
 
     return *this;
@@ -37,12 +41,12 @@ CubismId& CubismId::operator=(const CubismId& c)
 
 csmBool CubismId::operator==(const CubismId& c) const
 {
-    return (_id == c._id);
+    return (_hash == c._hash && _id == c._id);
 }
 
 csmBool CubismId::operator!=(const CubismId& c) const
 {
-    return !(_id == c._id);
+    return !(*this == c);
 }
 
 const csmString& CubismId::GetString() const
@@ -50,4 +54,16 @@ const csmString& CubismId::GetString() const
     return _id;
 }
 
+csmUint32 CubismId::CalculateHash(const csmChar* id, csmInt32 length)
+{
+    // FNV-1a
+    csmUint32 hash = 2166136261u;
+    for (csmInt32 i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<csmUint8>(id[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 }}}
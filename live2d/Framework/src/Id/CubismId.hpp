@@ -60,7 +60,17 @@ private:
 
     CubismId(const CubismId& c);
 
+    /**
+     * @brief ID名のハッシュ値の計算
+     *
+     * @param[in]   id      ID名
+     * @param[in]   length  ID名の長さ
+     * @return  ハッシュ値
+     */
+    static csmUint32 CalculateHash(const csmChar* id, csmInt32 length);
+
     csmString _id;      ///< ID名
+    csmUint32 _hash;    ///< ID名のハッシュ値
 };
 
 typedef const CubismId* CubismIdHandle;
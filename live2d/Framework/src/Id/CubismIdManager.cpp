@@ -7,18 +7,28 @@
 
 #include "CubismIdManager.hpp"
 #include "CubismId.hpp"
+#include <string.h>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
+namespace {
+
+const csmUint32 InitialSlotCount = 256;
+
+}
+
 CubismIdManager::CubismIdManager()
-{ }
+    : _table(NULL)
+    , _idCount(0)
+{
+    _table.store(CreateTable(InitialSlotCount), std::memory_order_release);
+}
 
 CubismIdManager::~CubismIdManager()
 {
-    for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
-    {
-        CSM_DELETE_SELF(CubismId, _ids[i]);
-    }
+    // IDはアリーナの終了処理で破棄される
+    // The IDs are destroyed by the arena finalizers.
+    _arena.Clear();
 }
 
 void CubismIdManager::RegisterIds(const csmChar** ids, csmInt32 count)
@@ -39,7 +49,7 @@ void CubismIdManager::RegisterIds(const csmVector<csmString>& ids)
 
 const CubismId* CubismIdManager::GetId(const csmString& id)
 {
-    return RegisterId(id.GetRawString());
+    return RegisterId(id.GetRawString(), id.GetLength());
 }
 
 const CubismId* CubismIdManager::GetId(const csmChar* id)
@@ -49,44 +59,123 @@ const CubismId* CubismIdManager::GetId(const csmChar* id)
 
 csmBool CubismIdManager::IsExist(const csmString& id) const
 {
-    return IsExist(id.GetRawString());
+    const csmChar* rawId = id.GetRawString();
+    const csmInt32 length = id.GetLength();
+    return (FindId(rawId, length, CubismId::CalculateHash(rawId, length)) != NULL);
 }
 csmBool CubismIdManager::IsExist(const csmChar* id) const
 {
-    return (FindId(id) != NULL);
+    const csmInt32 length = static_cast<csmInt32>(strlen(id));
+    return (FindId(id, length, CubismId::CalculateHash(id, length)) != NULL);
 }
 
 const CubismId* CubismIdManager::RegisterId(const csmChar* id)
 {
-    CubismId* result = NULL;
+    return RegisterId(id, static_cast<csmInt32>(strlen(id)));
+}
+
+const CubismId* CubismIdManager::RegisterId(const csmString& id)
+{
+    return RegisterId(id.GetRawString(), id.GetLength());
+}
+
+const CubismId* CubismIdManager::RegisterId(const csmChar* id, csmInt32 length)
+{
+    const csmUint32 hash = CubismId::CalculateHash(id, length);
+
+    CubismId* result = FindId(id, length, hash);
+    if (result != NULL)
+    {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(_registerMutex);
 
-    if ((result = FindId(id)) != NULL)
+    // ロックを待つ間に他のスレッドが登録している場合がある
+    // Another thread may have registered the ID while waiting for the lock.
+    if ((result = FindId(id, length, hash)) != NULL)
     {
         return result;
     }
 
-    result = CSM_NEW CubismId(id);
-    _ids.PushBack(result);
+    IdTable* table = _table.load(std::memory_order_relaxed);
+
+    // 負荷率を1/2以下に保つ。古い索引は読み込み中のスレッドのために残す
+    // Keep the load factor at most 1/2. The old table stays alive for concurrent readers.
+    if ((_idCount + 1) * 2 > table->SlotMask + 1)
+    {
+        IdTable* grownTable = CreateTable((table->SlotMask + 1) * 2);
+        for (csmUint32 i = 0; i <= table->SlotMask; ++i)
+        {
+            CubismId* registeredId = table->Slots[i].load(std::memory_order_relaxed);
+            if (registeredId != NULL)
+            {
+                InsertId(grownTable, registeredId);
+            }
+        }
+        _table.store(grownTable, std::memory_order_release);
+        table = grownTable;
+    }
+
+    void* storage = _arena.Allocate(sizeof(CubismId), &FinalizeId);
+    result = CSM_PLACEMENT_NEW(storage) CubismId(id);
+    InsertId(table, result);
+    ++_idCount;
 
     return result;
 }
 
-const CubismId* CubismIdManager::RegisterId(const csmString& id)
+CubismId* CubismIdManager::FindId(const csmChar* id, csmInt32 length, csmUint32 hash) const
 {
-    return RegisterId(id.GetRawString());
-}
+    const IdTable* table = _table.load(std::memory_order_acquire);
 
-CubismId* CubismIdManager::FindId(const csmChar* id) const
-{
-    for (csmUint32 i = 0; i < _ids.GetSize(); ++i)
+    for (csmUint32 i = hash & table->SlotMask; ; i = (i + 1) & table->SlotMask)
     {
-        if (_ids[i]->GetString() == id)
+        CubismId* registeredId = table->Slots[i].load(std::memory_order_acquire);
+        if (registeredId == NULL)
+        {
+            return NULL;
+        }
+
+        if (registeredId->_hash == hash
+            && registeredId->_id.GetLength() == length
+            && memcmp(registeredId->_id.GetRawString(), id, length) == 0)
         {
-            return _ids[i];
+            return registeredId;
         }
     }
+}
 
-    return NULL;
+CubismIdManager::IdTable* CubismIdManager::CreateTable(csmUint32 slotCount)
+{
+    IdTable* table = static_cast<IdTable*>(_arena.Allocate(sizeof(IdTable)));
+    table->SlotMask = slotCount - 1;
+    table->Slots = static_cast<std::atomic<CubismId*>*>(_arena.Allocate(sizeof(std::atomic<CubismId*>) * slotCount));
+
+    for (csmUint32 i = 0; i < slotCount; ++i)
+    {
+        CSM_PLACEMENT_NEW(&table->Slots[i]) std::atomic<CubismId*>(NULL);
+    }
+
+    return table;
+}
+
+void CubismIdManager::InsertId(IdTable* table, CubismId* id)
+{
+    csmUint32 i = id->_hash & table->SlotMask;
+    while (table->Slots[i].load(std::memory_order_relaxed) != NULL)
+    {
+        i = (i + 1) & table->SlotMask;
+    }
+
+    // IDの構築が完了してから読み込み側に公開する
+    // Publish the slot only after the ID is fully constructed.
+    table->Slots[i].store(id, std::memory_order_release);
+}
+
+void CubismIdManager::FinalizeId(void* id)
+{
+    static_cast<CubismId*>(id)->~CubismId();
 }
 
 }}}
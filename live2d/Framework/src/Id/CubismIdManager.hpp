@@ -10,6 +10,9 @@
 #include "Type/CubismBasicType.hpp"
 #include "Type/csmString.hpp"
 #include "Type/csmVector.hpp"
+#include "Utils/CubismArena.hpp"
+#include <atomic>
+#include <mutex>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -19,6 +22,9 @@ struct CubismId;
  * @brief ID名の管理
  *
  * ID名を管理する。
+ * ID名はハッシュ値で索引し、登録したIDはアリーナに確保して破棄まで移動しない。
+ * 検索はロックを取らないため、ワーカースレッドから同時にGetIdやIsExistを呼んでよい。
+ * 登録は内部でロックを取って直列化する。
  */
 class CubismIdManager
 {
@@ -119,20 +125,72 @@ public:
     csmBool IsExist(const csmChar* id) const;
 
 private:
+    /**
+     * @brief IDの索引
+     *
+     * オープンアドレス法のハッシュ表。拡張時は新しい索引を作って差し替え、古い索引は破棄まで残す。
+     */
+    struct IdTable
+    {
+        csmUint32 SlotMask;                 ///< スロットの数から1を引いた値。スロットの数は2のべき乗
+        std::atomic<CubismId*>* Slots;      ///< 登録されているID。空ならNULL
+    };
+
     CubismIdManager(const CubismIdManager&);
     CubismIdManager& operator=(const CubismIdManager&);
 
     /**
      * @brief ID名からIDを検索
      *
-     * ID名からIDを検索する。
+     * ID名からIDを検索する。ロックを取らない。
      *
-     * @param[in]   id  ID名
+     * @param[in]   id      ID名
+     * @param[in]   length  ID名の長さ
+     * @param[in]   hash    ID名のハッシュ値
      * @return  登録されているID。なければNULL。
      */
-    CubismId* FindId(const csmChar* id) const;
+    CubismId* FindId(const csmChar* id, csmInt32 length, csmUint32 hash) const;
+
+    /**
+     * @brief ID名を登録
+     *
+     * 未登録であればIDを作成して索引に追加する。
+     *
+     * @param[in]   id      ID名
+     * @param[in]   length  ID名の長さ
+     * @return  登録されているID
+     */
+    const CubismId* RegisterId(const csmChar* id, csmInt32 length);
+
+    /**
+     * @brief 索引の作成
+     *
+     * 空の索引をアリーナに作成する。
+     *
+     * @param[in]   slotCount   スロットの数。2のべき乗
+     * @return  作成した索引
+     */
+    IdTable* CreateTable(csmUint32 slotCount);
+
+    /**
+     * @brief 索引へのIDの追加
+     *
+     * @param[in]   table   追加先の索引
+     * @param[in]   id      追加するID
+     */
+    static void InsertId(IdTable* table, CubismId* id);
+
+    /**
+     * @brief アリーナに作成したIDの破棄
+     *
+     * @param[in]   id      破棄するID
+     */
+    static void FinalizeId(void* id);
 
-    csmVector<CubismId*> _ids;      ///< 登録されているIDのリスト
+    Utils::CubismArena _arena;              ///< IDと索引を確保するアリーナ
+    std::atomic<IdTable*> _table;           ///< 現在の索引
+    csmUint32 _idCount;                     ///< 登録されているIDの数
+    std::mutex _registerMutex;              ///< 登録を直列化するロック
 };
 
 }}}
@@ -0,0 +1,290 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismDrawableHitTester.hpp"
+#include "Math/CubismMath.hpp"
+#include <float.h>
+#include <string.h>
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+// 判定で辿る節のスタックの大きさ。中央値で分けるため、深さは三角形の数の対数程度になる
+const csmInt32 MaxTraversalDepth = 64;
+}
+
+CubismDrawableHitTester::CubismDrawableHitTester()
+    : _buildCount(0)
+{ }
+
+CubismDrawableHitTester::~CubismDrawableHitTester()
+{
+    for (csmUint32 i = 0; i < _trees.GetSize(); ++i)
+    {
+        if (_trees[i] != NULL)
+        {
+            CSM_DELETE(_trees[i]);
+        }
+    }
+}
+
+csmBool CubismDrawableHitTester::IsHit(const CubismModel& model, csmInt32 drawableIndex, csmFloat32 x, csmFloat32 y)
+{
+    const csmInt32 drawableCount = model.GetDrawableCount();
+    if (drawableIndex < 0 || drawableIndex >= drawableCount)
+    {
+        return false;
+    }
+
+    if (static_cast<csmInt32>(_trees.GetSize()) < drawableCount)
+    {
+        _trees.Resize(drawableCount, NULL);
+    }
+
+    if (_trees[drawableIndex] == NULL)
+    {
+        _trees[drawableIndex] = CSM_NEW DrawableTree();
+        Build(model, drawableIndex, *_trees[drawableIndex]);
+    }
+    else
+    {
+        // 前回の判定から頂点が変化した場合だけ作り直す
+        if (_trees[drawableIndex]->VertexRevision != model.GetDrawableVertexRevision(drawableIndex))
+        {
+            Build(model, drawableIndex, *_trees[drawableIndex]);
+        }
+    }
+
+    const DrawableTree& tree = *_trees[drawableIndex];
+    if (tree.Nodes.GetSize() == 0)
+    {
+        return false;
+    }
+
+    const csmFloat32* vertices = tree.Vertices.GetPtr();
+    const csmUint16* triangles = tree.Triangles.GetPtr();
+    const Node* nodes = tree.Nodes.GetPtr();
+
+    csmInt32 stack[MaxTraversalDepth];
+    csmInt32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const csmInt32 nodeIndex = stack[--stackSize];
+        const Node& node = nodes[nodeIndex];
+
+        if (x < node.MinX || node.MaxX < x || y < node.MinY || node.MaxY < y)
+        {
+            continue;
+        }
+
+        if (node.TriangleCount > 0)
+        {
+            for (csmInt32 i = 0; i < node.TriangleCount; ++i)
+            {
+                if (IsPointInTriangle(vertices, triangles + (node.FirstTriangle + i) * 3, x, y))
+                {
+                    return true;
+                }
+            }
+            continue;
+        }
+
+        CSM_ASSERT(stackSize + 2 <= MaxTraversalDepth);
+        stack[stackSize++] = node.RightChild;
+        stack[stackSize++] = nodeIndex + 1;
+    }
+
+    return false;
+}
+
+csmInt32 CubismDrawableHitTester::GetBuildCount() const
+{
+    return _buildCount;
+}
+
+void CubismDrawableHitTester::Build(const CubismModel& model, csmInt32 drawableIndex, DrawableTree& tree)
+{
+    const csmInt32 vertexCount = model.GetDrawableVertexCount(drawableIndex);
+    const csmInt32 indexCount = model.GetDrawableVertexIndexCount(drawableIndex);
+    const csmFloat32* vertices = model.GetDrawableVertices(drawableIndex);
+    const csmUint16* indices = model.GetDrawableVertexIndices(drawableIndex);
+
+    ++_buildCount;
+
+    tree.VertexRevision = model.GetDrawableVertexRevision(drawableIndex);
+    tree.Vertices.Resize(vertexCount * 2);
+    if (vertexCount > 0)
+    {
+        memcpy(tree.Vertices.GetPtr(), vertices, sizeof(csmFloat32) * 2 * vertexCount);
+    }
+    tree.Nodes.Clear();
+
+    // 面積のある三角形だけを集め、囲む矩形を求めておく
+    _order.Clear();
+    _triangleBounds.Resize(indexCount / 3 * 4);
+    for (csmInt32 i = 0; i < indexCount / 3; ++i)
+    {
+        const csmFloat32* a = vertices + indices[i * 3] * 2;
+        const csmFloat32* b = vertices + indices[i * 3 + 1] * 2;
+        const csmFloat32* c = vertices + indices[i * 3 + 2] * 2;
+
+        if ((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]) == 0.0f)
+        {
+            continue;
+        }
+
+        csmFloat32* bounds = _triangleBounds.GetPtr() + i * 4;
+        bounds[0] = CubismMath::Min(a[0], CubismMath::Min(b[0], c[0]));
+        bounds[1] = CubismMath::Min(a[1], CubismMath::Min(b[1], c[1]));
+        bounds[2] = CubismMath::Max(a[0], CubismMath::Max(b[0], c[0]));
+        bounds[3] = CubismMath::Max(a[1], CubismMath::Max(b[1], c[1]));
+        _order.PushBack(i);
+    }
+
+    const csmInt32 triangleCount = _order.GetSize();
+    if (triangleCount == 0)
+    {
+        tree.Triangles.Clear();
+        return;
+    }
+
+    tree.Nodes.PrepareCapacity(triangleCount * 2);
+    BuildNode(tree, 0, triangleCount);
+
+    // 葉の三角形を続けて読めるように、階層の順に並べる
+    tree.Triangles.Resize(triangleCount * 3);
+    csmUint16* triangles = tree.Triangles.GetPtr();
+    for (csmInt32 i = 0; i < triangleCount; ++i)
+    {
+        const csmUint16* triangle = indices + _order[i] * 3;
+        triangles[i * 3] = triangle[0];
+        triangles[i * 3 + 1] = triangle[1];
+        triangles[i * 3 + 2] = triangle[2];
+    }
+}
+
+void CubismDrawableHitTester::BuildNode(DrawableTree& tree, csmInt32 begin, csmInt32 end)
+{
+    Node node;
+    node.MinX = FLT_MAX;
+    node.MinY = FLT_MAX;
+    node.MaxX = -FLT_MAX;
+    node.MaxY = -FLT_MAX;
+    node.RightChild = 0;
+    node.FirstTriangle = begin;
+    node.TriangleCount = end - begin;
+
+    // 重心は矩形の中心の2倍で比べる
+    csmFloat32 minCentroidX = FLT_MAX, minCentroidY = FLT_MAX;
+    csmFloat32 maxCentroidX = -FLT_MAX, maxCentroidY = -FLT_MAX;
+
+    for (csmInt32 i = begin; i < end; ++i)
+    {
+        const csmFloat32* bounds = _triangleBounds.GetPtr() + _order[i] * 4;
+        node.MinX = CubismMath::Min(node.MinX, bounds[0]);
+        node.MinY = CubismMath::Min(node.MinY, bounds[1]);
+        node.MaxX = CubismMath::Max(node.MaxX, bounds[2]);
+        node.MaxY = CubismMath::Max(node.MaxY, bounds[3]);
+
+        const csmFloat32 centroidX = bounds[0] + bounds[2];
+        const csmFloat32 centroidY = bounds[1] + bounds[3];
+        minCentroidX = CubismMath::Min(minCentroidX, centroidX);
+        minCentroidY = CubismMath::Min(minCentroidY, centroidY);
+        maxCentroidX = CubismMath::Max(maxCentroidX, centroidX);
+        maxCentroidY = CubismMath::Max(maxCentroidY, centroidY);
+    }
+
+    const csmInt32 nodeIndex = tree.Nodes.GetSize();
+    tree.Nodes.PushBack(node);
+
+    // 三角形が少ないか、重心が重なっていて分けられない場合は葉にする
+    if (end - begin <= LeafTriangleCount || (maxCentroidX <= minCentroidX && maxCentroidY <= minCentroidY))
+    {
+        return;
+    }
+
+    const csmInt32 axis = (maxCentroidX - minCentroidX >= maxCentroidY - minCentroidY) ? 0 : 1;
+    const csmInt32 middle = begin + (end - begin) / 2;
+    SelectMedian(begin, middle, end, axis);
+
+    tree.Nodes[nodeIndex].TriangleCount = 0;
+    BuildNode(tree, begin, middle);
+    tree.Nodes[nodeIndex].RightChild = tree.Nodes.GetSize();
+    BuildNode(tree, middle, end);
+}
+
+void CubismDrawableHitTester::SelectMedian(csmInt32 begin, csmInt32 middle, csmInt32 end, csmInt32 axis)
+{
+    const csmFloat32* bounds = _triangleBounds.GetPtr();
+    csmInt32* order = _order.GetPtr();
+    csmInt32 low = begin;
+    csmInt32 high = end - 1;
+
+    // 重心の軸の値でmiddle番目の三角形を選ぶ
+    while (low < high)
+    {
+        const csmInt32 pivotTriangle = order[low + (high - low) / 2];
+        const csmFloat32 pivot = bounds[pivotTriangle * 4 + axis] + bounds[pivotTriangle * 4 + 2 + axis];
+        csmInt32 i = low;
+        csmInt32 j = high;
+
+        while (i <= j)
+        {
+            while (bounds[order[i] * 4 + axis] + bounds[order[i] * 4 + 2 + axis] < pivot)
+            {
+                ++i;
+            }
+            while (pivot < bounds[order[j] * 4 + axis] + bounds[order[j] * 4 + 2 + axis])
+            {
+                --j;
+            }
+
+            if (i <= j)
+            {
+                const csmInt32 temp = order[i];
+                order[i] = order[j];
+                order[j] = temp;
+                ++i;
+                --j;
+            }
+        }
+
+        if (middle <= j)
+        {
+            high = j;
+        }
+        else if (i <= middle)
+        {
+            low = i;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+csmBool CubismDrawableHitTester::IsPointInTriangle(const csmFloat32* vertices, const csmUint16* triangle, csmFloat32 x, csmFloat32 y)
+{
+    const csmFloat32* a = vertices + triangle[0] * 2;
+    const csmFloat32* b = vertices + triangle[1] * 2;
+    const csmFloat32* c = vertices + triangle[2] * 2;
+
+    // 各辺に対して点がどちら側にあるかを求め、すべて同じ側(または辺の上)なら含まれる
+    const csmFloat32 d0 = (b[0] - a[0]) * (y - a[1]) - (b[1] - a[1]) * (x - a[0]);
+    const csmFloat32 d1 = (c[0] - b[0]) * (y - b[1]) - (c[1] - b[1]) * (x - b[0]);
+    const csmFloat32 d2 = (a[0] - c[0]) * (y - c[1]) - (a[1] - c[1]) * (x - c[0]);
+
+    const csmBool hasNegative = (d0 < 0.0f) || (d1 < 0.0f) || (d2 < 0.0f);
+    const csmBool hasPositive = (d0 > 0.0f) || (d1 > 0.0f) || (d2 > 0.0f);
+
+    return !(hasNegative && hasPositive);
+}
+
+}}}
@@ -0,0 +1,143 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismModel.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * @brief Drawableの三角形による当たり判定
+ *
+ * Drawableの変形後の三角形から矩形の階層(BVH)を作り、点が三角形のどれかに含まれるかを判定する。
+ * 階層は判定したDrawableにだけ作り、CubismModel::GetDrawableVertexRevisionが前回の判定から進んだ場合にだけ作り直す。
+ */
+class CubismDrawableHitTester
+{
+public:
+    static const csmInt32 LeafTriangleCount = 4;   ///< 葉に入れる三角形の最大数
+
+    /**
+     * @brief コンストラクタ
+     */
+    CubismDrawableHitTester();
+
+    /**
+     * @brief デストラクタ
+     */
+    ~CubismDrawableHitTester();
+
+    /**
+     * @brief あたり判定
+     *
+     * 点がDrawableの三角形のどれかに含まれるかを判定する。辺の上の点も含まれるとする。
+     *
+     * @param[in]   model           モデル
+     * @param[in]   drawableIndex   Drawableのインデックス
+     * @param[in]   x               モデル座標系のX位置
+     * @param[in]   y               モデル座標系のY位置
+     * @retval  true    ヒットしている
+     * @retval  false   ヒットしていない
+     */
+    csmBool IsHit(const CubismModel& model, csmInt32 drawableIndex, csmFloat32 x, csmFloat32 y);
+
+    /**
+     * @brief 階層を作った回数の取得
+     *
+     * @return  インスタンスを作成してから階層を作った回数
+     */
+    csmInt32 GetBuildCount() const;
+
+private:
+    /**
+     * @brief 階層の節
+     *
+     * 葉ではTriangleCountが1以上で、FirstTriangleから続く三角形を持つ。
+     * 葉でない節ではTriangleCountが0で、左の子は直後の節、右の子はRightChildの節になる。
+     */
+    struct Node
+    {
+        csmFloat32 MinX;            ///< 矩形のX座標の最小値
+        csmFloat32 MinY;            ///< 矩形のY座標の最小値
+        csmFloat32 MaxX;            ///< 矩形のX座標の最大値
+        csmFloat32 MaxY;            ///< 矩形のY座標の最大値
+        csmInt32 RightChild;        ///< 右の子の節のインデックス。葉では使わない
+        csmInt32 FirstTriangle;     ///< 葉の最初の三角形のインデックス。葉でなければ使わない
+        csmInt32 TriangleCount;     ///< 葉の三角形の数。葉でなければ0
+    };
+
+    /**
+     * @brief 1つのDrawableの階層
+     */
+    struct DrawableTree
+    {
+        csmUint32 VertexRevision;           ///< 階層を作ったときのモデルの頂点の更新番号
+        csmVector<csmFloat32> Vertices;     ///< 階層を作ったときの頂点
+        csmVector<csmUint16> Triangles;     ///< 階層の順に並べ替えた三角形の頂点インデックス
+        csmVector<Node> Nodes;              ///< 節。先頭が根
+    };
+
+    // Prevention of copy Constructor
+    CubismDrawableHitTester(const CubismDrawableHitTester&);
+    CubismDrawableHitTester& operator=(const CubismDrawableHitTester&);
+
+    /**
+     * @brief 階層を作る
+     *
+     * 面積が0の三角形は点を含まないため、階層に入れない。
+     *
+     * @param[in]   model           モデル
+     * @param[in]   drawableIndex   Drawableのインデックス
+     * @param[out]  tree            作った階層
+     */
+    void Build(const CubismModel& model, csmInt32 drawableIndex, DrawableTree& tree);
+
+    /**
+     * @brief 三角形の範囲から節を作る
+     *
+     * 三角形が多い場合は、重心の広がりが大きい軸の重心の中央値で2つに分けて子を作る。
+     *
+     * @param[in,out]   tree    作っている階層
+     * @param[in]       begin   範囲の最初の三角形
+     * @param[in]       end     範囲の最後の三角形の次
+     */
+    void BuildNode(DrawableTree& tree, csmInt32 begin, csmInt32 end);
+
+    /**
+     * @brief 三角形の範囲を重心で分ける
+     *
+     * middleより前に重心が小さい三角形、middle以降に重心が大きい三角形が来るように並べ替える。
+     *
+     * @param[in]   begin   範囲の最初の三角形
+     * @param[in]   middle  分ける位置
+     * @param[in]   end     範囲の最後の三角形の次
+     * @param[in]   axis    比べる軸。0ならX、1ならY
+     */
+    void SelectMedian(csmInt32 begin, csmInt32 middle, csmInt32 end, csmInt32 axis);
+
+    /**
+     * @brief 点が三角形に含まれるかの判定
+     *
+     * 辺の上の点も含まれるとする。三角形の向きは問わない。
+     *
+     * @param[in]   vertices    頂点
+     * @param[in]   triangle    三角形の頂点インデックス
+     * @param[in]   x           X位置
+     * @param[in]   y           Y位置
+     * @retval  true    含まれる
+     * @retval  false   含まれない
+     */
+    static csmBool IsPointInTriangle(const csmFloat32* vertices, const csmUint16* triangle, csmFloat32 x, csmFloat32 y);
+
+    csmVector<DrawableTree*> _trees;        ///< Drawableごとの階層。判定していないDrawableではNULL
+    csmVector<csmInt32> _order;             ///< 階層を作るときの三角形の並び
+    csmVector<csmFloat32> _triangleBounds;  ///< 階層を作るときの三角形を囲む矩形。三角形ごとに最小X,最小Y,最大X,最大Yの順
+    csmInt32 _buildCount;                   ///< 階層を作った回数
+};
+
+}}}
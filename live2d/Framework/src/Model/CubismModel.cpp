@@ -9,6 +9,16 @@
 #include "Rendering/CubismRenderer.hpp"
 #include "Id/CubismId.hpp"
 #include "Id/CubismIdManager.hpp"
+#include <float.h>
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CSM_DRAWABLE_BOUNDS_NEON
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define CSM_DRAWABLE_BOUNDS_SSE
+#endif
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -17,6 +27,83 @@ static csmInt32 IsBitSet(const csmUint8 byte, const csmUint8 mask)
     return ((byte & mask) == mask);
 }
 
+/**
+ * @brief 頂点を囲む矩形の計算
+ *
+ * 1レジスタに2頂点(x0, y0, x1, y1)ずつ読み込み、レーン0と2にX、レーン1と3にYの最小値と最大値を集める。
+ *
+ * @param[in]   positions   頂点の配列
+ * @param[in]   count       頂点の個数
+ * @param[out]  bounds      頂点を囲む矩形
+ */
+static void CalculateDrawableBounds(const Core::csmVector2* positions, csmInt32 count, CubismModel::DrawableBounds& bounds)
+{
+    const csmFloat32* vertices = reinterpret_cast<const csmFloat32*>(positions);
+    csmFloat32 minX = FLT_MAX, minY = FLT_MAX;
+    csmFloat32 maxX = -FLT_MAX, maxY = -FLT_MAX;
+    csmInt32 i = 0;
+
+#if defined(CSM_DRAWABLE_BOUNDS_NEON)
+    if (count >= 4)
+    {
+        float32x4_t minimum = vdupq_n_f32(FLT_MAX);
+        float32x4_t maximum = vdupq_n_f32(-FLT_MAX);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4_t a = vld1q_f32(vertices + i * 2);
+            const float32x4_t b = vld1q_f32(vertices + i * 2 + 4);
+            minimum = vminq_f32(minimum, vminq_f32(a, b));
+            maximum = vmaxq_f32(maximum, vmaxq_f32(a, b));
+        }
+
+        const float32x2_t minimumXY = vmin_f32(vget_low_f32(minimum), vget_high_f32(minimum));
+        const float32x2_t maximumXY = vmax_f32(vget_low_f32(maximum), vget_high_f32(maximum));
+        minX = vget_lane_f32(minimumXY, 0);
+        minY = vget_lane_f32(minimumXY, 1);
+        maxX = vget_lane_f32(maximumXY, 0);
+        maxY = vget_lane_f32(maximumXY, 1);
+    }
+#elif defined(CSM_DRAWABLE_BOUNDS_SSE)
+    if (count >= 4)
+    {
+        __m128 minimum = _mm_set1_ps(FLT_MAX);
+        __m128 maximum = _mm_set1_ps(-FLT_MAX);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(vertices + i * 2);
+            const __m128 b = _mm_loadu_ps(vertices + i * 2 + 4);
+            minimum = _mm_min_ps(minimum, _mm_min_ps(a, b));
+            maximum = _mm_max_ps(maximum, _mm_max_ps(a, b));
+        }
+
+        csmFloat32 lanes[4];
+        _mm_storeu_ps(lanes, _mm_min_ps(minimum, _mm_movehl_ps(minimum, minimum)));
+        minX = lanes[0];
+        minY = lanes[1];
+        _mm_storeu_ps(lanes, _mm_max_ps(maximum, _mm_movehl_ps(maximum, maximum)));
+        maxX = lanes[0];
+        maxY = lanes[1];
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        const csmFloat32 x = vertices[i * 2];
+        const csmFloat32 y = vertices[i * 2 + 1];
+        if (x < minX) minX = x;
+        if (x > maxX) maxX = x;
+        if (y < minY) minY = y;
+        if (y > maxY) maxY = y;
+    }
+
+    bounds.MinX = minX;
+    bounds.MinY = minY;
+    bounds.MaxX = maxX;
+    bounds.MaxY = maxY;
+}
+
 CubismModel::CubismModel(Core::csmModel* model)
     : _model(model)
     , _parameterValues(NULL)
@@ -74,6 +161,28 @@ void CubismModel::Update() const
     // Update model.
     Core::csmUpdateModel(_model);
 
+    // VertexPositionsDidChangeは頂点が同じでも毎回立つため、フラグが立ったDrawableは前回の頂点と比べ、
+    // 実際に変化したものだけ更新番号を進める
+    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmVector2** positions = Core::csmGetDrawableVertexPositions(_model);
+    const csmInt32* vertexCounts = Core::csmGetDrawableVertexCounts(_model);
+    const csmInt32 drawableCount = static_cast<csmInt32>(_drawableVertexRevisions.GetSize());
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        if (!IsBitSet(dynamicFlags[i], Core::csmVertexPositionsDidChange))
+        {
+            continue;
+        }
+
+        csmFloat32* snapshot = _drawableVertexSnapshot.GetPtr() + _drawableVertexOffsets[i] * 2;
+        const csmSizeType vertexSize = sizeof(csmFloat32) * 2 * vertexCounts[i];
+        if (memcmp(snapshot, positions[i], vertexSize) != 0)
+        {
+            memcpy(snapshot, positions[i], vertexSize);
+            ++_drawableVertexRevisions[i];
+        }
+    }
+
     // Reset dynamic drawable flags.
     Core::csmResetDrawableDynamicFlags(_model);
 }
@@ -93,9 +202,10 @@ void CubismModel::SetPartOpacity(CubismIdHandle partId, csmFloat32 opacity)
 
 void CubismModel::SetPartOpacity(csmInt32 partIndex, csmFloat32 opacity)
 {
-    if (_notExistPartOpacities.IsExist(partIndex))
+    csmFloat32* notExistPartOpacity = _notExistPartOpacities.Find(partIndex);
+    if (notExistPartOpacity != NULL)
     {
-        _notExistPartOpacities[partIndex] = opacity;
+        *notExistPartOpacity = opacity;
         return;
     }
 
@@ -120,10 +230,11 @@ csmFloat32 CubismModel::GetPartOpacity(CubismIdHandle partId)
 
 csmFloat32 CubismModel::GetPartOpacity(csmInt32 partIndex)
 {
-    if (_notExistPartOpacities.IsExist(partIndex))
+    const csmFloat32* notExistPartOpacity = _notExistPartOpacities.Find(partIndex);
+    if (notExistPartOpacity != NULL)
     {
         // モデルに存在しないパーツIDの場合、非存在パーツリストから不透明度を返す
-        return _notExistPartOpacities[partIndex];
+        return *notExistPartOpacity;
     }
 
     //インデックスの範囲内検知
@@ -174,9 +285,10 @@ csmInt32 CubismModel::GetParameterIndex(CubismIdHandle parameterId)
     }
 
     // モデルに存在していない場合、非存在パラメータIDリスト内を検索し、そのインデックスを返す
-    if (_notExistParameterId.IsExist(parameterId))
+    const csmInt32* notExistParameterIndex = _notExistParameterId.Find(parameterId);
+    if (notExistParameterIndex != NULL)
     {
-        return _notExistParameterId[parameterId];
+        return *notExistParameterIndex;
     }
 
     // 非存在パラメータIDリストにない場合、新しく要素を追加する
@@ -196,9 +308,10 @@ CubismIdHandle CubismModel::GetParameterId(csmUint32 parameterIndex)
 
 csmFloat32 CubismModel::GetParameterValue(csmInt32 parameterIndex)
 {
-    if (_notExistParameterValues.IsExist(parameterIndex))
+    const csmFloat32* notExistParameterValue = _notExistParameterValues.Find(parameterIndex);
+    if (notExistParameterValue != NULL)
     {
-        return _notExistParameterValues[parameterIndex];
+        return *notExistParameterValue;
     }
 
     //インデックスの範囲内検知
@@ -209,12 +322,13 @@ csmFloat32 CubismModel::GetParameterValue(csmInt32 parameterIndex)
 
 void CubismModel::SetParameterValue(csmInt32 parameterIndex, csmFloat32 value, csmFloat32 weight)
 {
-    if (_notExistParameterValues.IsExist(parameterIndex))
+    csmFloat32* notExistParameterValue = _notExistParameterValues.Find(parameterIndex);
+    if (notExistParameterValue != NULL)
     {
-        _notExistParameterValues[parameterIndex] = (weight == 1)
-                                                         ? value
-                                                         : (_notExistParameterValues[parameterIndex] * (1 - weight)) +
-                                                         (value * weight);
+        *notExistParameterValue = (weight == 1)
+                                      ? value
+                                      : (*notExistParameterValue * (1 - weight)) +
+                                      (value * weight);
         return;
     }
 
@@ -351,9 +465,10 @@ csmInt32 CubismModel::GetPartIndex(CubismIdHandle partId)
     const csmInt32 partCount = Core::csmGetPartCount(_model);
 
     // モデルに存在していない場合、非存在パーツIDリスト内にあるかを検索し、そのインデックスを返す
-    if (_notExistPartId.IsExist(partId))
+    const csmInt32* notExistPartIndex = _notExistPartId.Find(partId);
+    if (notExistPartIndex != NULL)
     {
-        return _notExistPartId[partId];
+        return *notExistPartIndex;
     }
 
     // 非存在パーツIDリストにない場合、新しく要素を追加する
@@ -408,6 +523,25 @@ void CubismModel::Initialize()
         _userMultiplyColors.PrepareCapacity(drawableCount);
         _userScreenColors.PrepareCapacity(drawableCount);
         _userCullings.PrepareCapacity(drawableCount);
+        _drawableBounds.Resize(drawableCount);
+        _drawableBoundsRevisions.Resize(drawableCount, 0);
+
+        // 頂点の更新番号は1から始め、0を「未取得」として使えるようにする
+        const Core::csmVector2** positions = Core::csmGetDrawableVertexPositions(_model);
+        const csmInt32* vertexCounts = Core::csmGetDrawableVertexCounts(_model);
+        csmUint32 vertexCount = 0;
+        _drawableVertexRevisions.Resize(drawableCount, 1);
+        _drawableVertexOffsets.Resize(drawableCount);
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            _drawableVertexOffsets[i] = vertexCount;
+            vertexCount += vertexCounts[i];
+        }
+        _drawableVertexSnapshot.Resize(vertexCount * 2);
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            memcpy(_drawableVertexSnapshot.GetPtr() + _drawableVertexOffsets[i] * 2, positions[i], sizeof(csmFloat32) * 2 * vertexCounts[i]);
+        }
 
         // カリング設定
         DrawableCullingData userCulling;
@@ -535,6 +669,27 @@ const csmUint16* CubismModel::GetDrawableVertexIndices(csmInt32 drawableIndex) c
     return indicesArray[drawableIndex];
 }
 
+const CubismModel::DrawableBounds& CubismModel::GetDrawableBounds(csmInt32 drawableIndex) const
+{
+    CSM_ASSERT(0 <= drawableIndex && drawableIndex < _drawableBounds.GetSize());
+
+    DrawableBounds& bounds = _drawableBounds[drawableIndex];
+    if (_drawableBoundsRevisions[drawableIndex] != _drawableVertexRevisions[drawableIndex])
+    {
+        CalculateDrawableBounds(GetDrawableVertexPositions(drawableIndex), GetDrawableVertexCount(drawableIndex), bounds);
+        _drawableBoundsRevisions[drawableIndex] = _drawableVertexRevisions[drawableIndex];
+    }
+
+    return bounds;
+}
+
+csmUint32 CubismModel::GetDrawableVertexRevision(csmInt32 drawableIndex) const
+{
+    CSM_ASSERT(0 <= drawableIndex && drawableIndex < _drawableVertexRevisions.GetSize());
+
+    return _drawableVertexRevisions[drawableIndex];
+}
+
 const Core::csmVector2* CubismModel::GetDrawableVertexPositions(csmInt32 drawableIndex) const
 {
     const Core::csmVector2** verticesArray = Core::csmGetDrawableVertexPositions(_model);
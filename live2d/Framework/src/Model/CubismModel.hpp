@@ -8,7 +8,7 @@
 #pragma once
 
 #include "CubismFramework.hpp"
-#include "Type/csmMap.hpp"
+#include "Type/csmHashMap.hpp"
 #include "Type/csmVector.hpp"
 #include "Rendering/CubismRenderer.hpp"
 #include "Id/CubismId.hpp"
@@ -114,6 +114,19 @@ public:
 
     };  // PartColorData
 
+    /**
+     * @brief Drawableの頂点を囲む矩形
+     *
+     * 頂点を持たないDrawableでは、MinXとMinYがFLT_MAX、MaxXとMaxYが-FLT_MAXになる。
+     */
+    struct DrawableBounds
+    {
+        csmFloat32 MinX;    ///< 頂点のX座標の最小値
+        csmFloat32 MinY;    ///< 頂点のY座標の最小値
+        csmFloat32 MaxX;    ///< 頂点のX座標の最大値
+        csmFloat32 MaxY;    ///< 頂点のY座標の最大値
+    };
+
     /**
      * @brief モデルのパラメータの更新
      *
@@ -501,6 +514,29 @@ public:
      */
     const Core::csmVector2*     GetDrawableVertexPositions(csmInt32 drawableIndex) const;
 
+    /**
+     * @brief Drawableの頂点を囲む矩形の取得
+     *
+     * Drawableの頂点を囲む矩形を取得する。
+     * 矩形はキャッシュされ、頂点の更新番号が進んだDrawableだけ取得時に計算し直す。
+     *
+     * @param[in]   drawableIndex   Drawableのインデックス
+     * @return  Drawableの頂点を囲む矩形
+     */
+    const DrawableBounds&       GetDrawableBounds(csmInt32 drawableIndex) const;
+
+    /**
+     * @brief Drawableの頂点の更新番号の取得
+     *
+     * CubismModel::Update関数で頂点が前回から実際に変化したDrawableだけ値が進む。
+     * 頂点から作ったデータを持つ側は値を覚えておき、異なっていれば作り直す。
+     * 初期値は1のため、0を未取得の印に使える。
+     *
+     * @param[in]   drawableIndex   Drawableのインデックス
+     * @return  Drawableの頂点の更新番号
+     */
+    csmUint32                   GetDrawableVertexRevision(csmInt32 drawableIndex) const;
+
     /**
      * @brief Drawableの頂点のUVリストの取得
      *
@@ -941,11 +977,11 @@ private:
         csmVector<CubismModel::PartColorData>& partColors,
         csmVector <CubismModel::DrawableColorData>& drawableColors);
 
-    csmMap<csmInt32, csmFloat32>        _notExistPartOpacities;             ///< 存在していないパーツの不透明度のリスト
-    csmMap<CubismIdHandle, csmInt32>   _notExistPartId;                    ///< 存在していないパーツIDのリスト
+    csmHashMap<csmInt32, csmFloat32>        _notExistPartOpacities;     ///< 存在していないパーツの不透明度のリスト
+    csmHashMap<CubismIdHandle, csmInt32>   _notExistPartId;            ///< 存在していないパーツIDのリスト
 
-    csmMap<csmInt32, csmFloat32>        _notExistParameterValues;           ///< 存在していないパラメータの値のリスト
-    csmMap<CubismIdHandle, csmInt32>   _notExistParameterId;               ///< 存在していないパラメータIDのリスト
+    csmHashMap<csmInt32, csmFloat32>        _notExistParameterValues;   ///< 存在していないパラメータの値のリスト
+    csmHashMap<CubismIdHandle, csmInt32>   _notExistParameterId;       ///< 存在していないパラメータIDのリスト
 
     csmVector<csmFloat32>   _savedParameters;                   ///< 保存されたパラメータ
 
@@ -968,6 +1004,11 @@ private:
     csmVector<PartColorData> _userPartScreenColors; ///< Part 乗算色の配列
     csmVector<PartColorData> _userPartMultiplyColors; ///< Part スクリーン色の配列
     csmVector<csmVector<csmUint32> > _partChildDrawables; ///< Partの子DrawableIndexの配列
+    mutable csmVector<DrawableBounds> _drawableBounds; ///< Drawableの頂点を囲む矩形のキャッシュ
+    mutable csmVector<csmUint32> _drawableBoundsRevisions; ///< Drawableの矩形を計算した時の頂点の更新番号
+    mutable csmVector<csmUint32> _drawableVertexRevisions; ///< Drawableの頂点の更新番号
+    mutable csmVector<csmFloat32> _drawableVertexSnapshot; ///< 更新番号を進めた時のDrawableの頂点の写し
+    csmVector<csmUint32> _drawableVertexOffsets; ///< _drawableVertexSnapshotでの各Drawableの先頭の頂点番号
     csmBool _isOverwrittenModelMultiplyColors; ///< 乗算色を全て上書きするか？
     csmBool _isOverwrittenModelScreenColors; ///< スクリーン色を全て上書きするか？
     csmBool _isOverwrittenCullings; ///< モデルのカリング設定をすべて上書きするか？
@@ -23,6 +23,7 @@ CubismUserModel::CubismUserModel()
     , _dragManager(NULL)
     , _physics(NULL)
     , _modelUserData(NULL)
+    , _hitTester(NULL)
     , _initialized(false)
     , _updating(false)
     , _opacity(1.0f)
@@ -66,6 +67,7 @@ CubismUserModel::~CubismUserModel()
     CSM_DELETE(_dragManager);
     CubismPhysics::Delete(_physics);
     CubismModelUserData::Delete(_modelUserData);
+    CSM_DELETE(_hitTester);
 
     DeleteRenderer();
 }
@@ -148,44 +150,42 @@ csmBool CubismUserModel::IsHit(CubismIdHandle drawableId, csmFloat32 pointX, csm
         return false; // 存在しない場合はfalse
     }
 
-    const csmInt32    count = _model->GetDrawableVertexCount(drawIndex);
-    const csmFloat32* vertices = _model->GetDrawableVertices(drawIndex);
+    // 頂点を囲む矩形はモデルがキャッシュしている
+    const CubismModel::DrawableBounds& bounds = _model->GetDrawableBounds(drawIndex);
 
-    csmFloat32 left = vertices[0];
-    csmFloat32 right = vertices[0];
-    csmFloat32 top = vertices[1];
-    csmFloat32 bottom = vertices[1];
+    const csmFloat32 tx = _modelMatrix->InvertTransformX(pointX);
+    const csmFloat32 ty = _modelMatrix->InvertTransformY(pointY);
 
-    for (csmInt32 j = 1; j < count; ++j)
+    if (!((bounds.MinX <= tx) && (tx <= bounds.MaxX) && (bounds.MinY <= ty) && (ty <= bounds.MaxY)))
     {
-        csmFloat32 x = vertices[Constant::VertexOffset + j * Constant::VertexStep];
-        csmFloat32 y = vertices[Constant::VertexOffset + j * Constant::VertexStep + 1];
-
-        if (x < left)
-        {
-            left = x; // Min x
-        }
-
-        if (x > right)
-        {
-            right = x; // Max x
-        }
-
-        if (y < top)
-        {
-            top = y; // Min y
-        }
-
-        if (y > bottom)
-        {
-            bottom = y; // Max y
-        }
+        return false;
     }
 
-    const csmFloat32 tx = _modelMatrix->InvertTransformX(pointX);
-    const csmFloat32 ty = _modelMatrix->InvertTransformY(pointY);
+    // 矩形に含まれる位置だけを三角形で判定する
+    if (_hitTester != NULL)
+    {
+        return _hitTester->IsHit(*_model, drawIndex, tx, ty);
+    }
+
+    return true;
+}
 
-    return ((left <= tx) && (tx <= right) && (top <= ty) && (ty <= bottom));
+void CubismUserModel::UsePreciseHitTest(csmBool enable)
+{
+    if (enable && _hitTester == NULL)
+    {
+        _hitTester = CSM_NEW CubismDrawableHitTester();
+    }
+    else if (!enable && _hitTester != NULL)
+    {
+        CSM_DELETE(_hitTester);
+        _hitTester = NULL;
+    }
+}
+
+csmBool CubismUserModel::IsUsingPreciseHitTest() const
+{
+    return _hitTester != NULL;
 }
 
 ACubismMotion* CubismUserModel::LoadMotion(const csmByte* buffer, csmSizeInt size, const csmChar* name, ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
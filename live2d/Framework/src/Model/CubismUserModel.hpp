@@ -19,6 +19,7 @@
 #include "Physics/CubismPhysics.hpp"
 #include "Rendering/CubismRenderer.hpp"
 #include "Model/CubismModelUserData.hpp"
+#include "Model/CubismDrawableHitTester.hpp"
 #include "Motion/CubismExpressionMotionManager.hpp"
 
 namespace Live2D { namespace Cubism { namespace Framework {
@@ -200,6 +201,8 @@ public:
      * @brief あたり判定の取得
      *
      * 指定した位置にDrawableがヒットしているかどうかを取得する。
+     * 通常はDrawableの頂点を囲む矩形で判定する。
+     * UsePreciseHitTest(true)を設定した場合は、矩形に含まれる位置をさらにDrawableの三角形で判定する。
      *
      * @param[in]   drawableId  検証したいDrawableのID
      * @param[in]   pointX      X位置
@@ -209,6 +212,24 @@ public:
      */
     virtual csmBool         IsHit(CubismIdHandle drawableId, csmFloat32 pointX, csmFloat32 pointY);
 
+    /**
+     * @brief 三角形によるあたり判定の設定
+     *
+     * 有効にすると、IsHitでDrawableの変形後の三角形に位置が含まれるかを判定する。
+     * 三角形の階層は判定したDrawableにだけ作り、前回の判定から頂点が変化した場合だけ作り直す。
+     *
+     * @param[in]   enable  trueなら三角形で判定する
+     */
+    void                    UsePreciseHitTest(csmBool enable);
+
+    /**
+     * @brief 三角形によるあたり判定の取得
+     *
+     * @retval  true    三角形で判定する
+     * @retval  false   矩形で判定する
+     */
+    csmBool                 IsUsingPreciseHitTest() const;
+
     /**
      * @brief モデルの取得
      *
@@ -278,6 +299,7 @@ protected:
     CubismTargetPoint*      _dragManager;               ///< マウスドラッグ
     CubismPhysics*          _physics;                   ///< 物理演算
     CubismModelUserData*    _modelUserData;             ///< ユーザデータ
+    CubismDrawableHitTester*    _hitTester;             ///< 三角形によるあたり判定。三角形で判定しない場合はNULL
 
     csmBool     _initialized;                   ///< 初期化されたかどうか
     csmBool     _updating;                      ///< 更新されたかどうか
@@ -295,7 +295,7 @@ protected:
     csmFloat32    _weight;               ///< モーションの重み
     csmFloat32    _offsetSeconds;        ///< モーション再生の開始時刻[秒]
 
-    csmVector<const csmString*>    _firedEventValues;
+    csmSmallVector<const csmString*, 8>    _firedEventValues;     ///< 発火したイベントのリスト。通常は数個のため内部バッファに格納する
 
     FinishedMotionCallback _onFinishedMotion; ///< モーション再生終了コールバック関数ポインタ
     void* _onFinishedMotionCustomData;        ///< モーション再生終了コールバックに戻されるデータ
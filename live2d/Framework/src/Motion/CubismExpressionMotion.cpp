@@ -100,7 +100,7 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
         const csmFloat32 currentParameterValue = expressionParameterValue.OverwriteValue =
             model->GetParameterValue(expressionParameterValue.ParameterId);
 
-        csmVector<ExpressionParameter> expressionParameters = GetExpressionParameters();
+        const csmVector<ExpressionParameter>& expressionParameters = GetExpressionParameters();
         csmInt32 parameterIndex = -1;
         for (csmInt32 j = 0; j < expressionParameters.GetSize(); ++j)
         {
@@ -140,9 +140,9 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
         }
 
         // 値を計算
-        csmFloat32 value = expressionParameters.At(parameterIndex).Value;
+        csmFloat32 value = expressionParameters[parameterIndex].Value;
         csmFloat32 newAdditiveValue, newMultiplyValue, newSetValue;
-        switch (expressionParameters.At(parameterIndex).BlendType) {
+        switch (expressionParameters[parameterIndex].BlendType) {
         case Additive:
             newAdditiveValue = value;
             newMultiplyValue = DefaultMultiplyValue;
@@ -175,7 +175,7 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
     }
 }
 
-csmVector<CubismExpressionMotion::ExpressionParameter> CubismExpressionMotion::GetExpressionParameters()
+const csmVector<CubismExpressionMotion::ExpressionParameter>& CubismExpressionMotion::GetExpressionParameters() const
 {
     return _parameters;
 }
@@ -86,8 +86,9 @@ public:
      * @brief 表情が参照しているパラメータを取得
      *
      * 表情が参照しているパラメータを取得する。
+     * 毎フレーム呼ばれるため、コピーせずに参照を返す。
      */
-    csmVector<ExpressionParameter> GetExpressionParameters();
+    const csmVector<ExpressionParameter>& GetExpressionParameters() const;
 
     /**
      * @brief 表情のフェードの値を取得
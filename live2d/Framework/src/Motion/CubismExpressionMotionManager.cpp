@@ -84,12 +84,12 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
 
         if (expressionMotion == NULL)
         {
-            CSM_DELETE(motionQueueEntry);
+            ReleaseMotionQueueEntry(motionQueueEntry);
             ite = motions->Erase(ite);          // 削除
             continue;
         }
 
-        csmVector<CubismExpressionMotion::ExpressionParameter> expressionParameters = expressionMotion->GetExpressionParameters();
+        const csmVector<CubismExpressionMotion::ExpressionParameter>& expressionParameters = expressionMotion->GetExpressionParameters();
         if (motionQueueEntry->IsAvailable())
         {
             // 再生中のExpressionが参照しているパラメータをすべてリストアップ
@@ -163,7 +163,7 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
             for (csmInt32 i = motions->GetSize()-2; i >= 0; i--)
             {
                 CubismMotionQueueEntry* motionQueueEntry = motions->At(i);
-                CSM_DELETE(motionQueueEntry);
+                ReleaseMotionQueueEntry(motionQueueEntry);
                 motions->Remove(i);
                 _fadeWeights.Remove(i);
             }
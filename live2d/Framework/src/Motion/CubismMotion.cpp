@@ -814,41 +814,21 @@ const csmVector<const csmString*>& CubismMotion::GetFiredEvent(csmFloat32 before
 
 csmBool CubismMotion::IsExistModelOpacity() const
 {
-    for (csmInt32 i = 0; i < _motionData->CurveCount; i++)
-    {
-        CubismMotionCurve curve = _motionData->Curves[i];
-
-        if (curve.Type != CubismMotionCurveTarget_Model)
-        {
-            continue;
-        }
-
-        if (strcmp(curve.Id->GetString().GetRawString(), IdNameOpacity) == 0)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return GetModelOpacityIndex() != -1;
 }
 
 csmInt32 CubismMotion::GetModelOpacityIndex() const
 {
-    if (IsExistModelOpacity())
-    {
-        for (csmInt32 i = 0; i < _motionData->CurveCount; i++)
-        {
-            CubismMotionCurve curve = _motionData->Curves[i];
+    // IDは一意なハンドルなので、文字列ではなくハンドルで比較する
+    const CubismIdHandle opacityId = CubismFramework::GetIdManager()->GetId(IdNameOpacity);
 
-            if (curve.Type != CubismMotionCurveTarget_Model)
-            {
-                continue;
-            }
+    for (csmInt32 i = 0; i < _motionData->CurveCount; i++)
+    {
+        const CubismMotionCurve& curve = _motionData->Curves[i];
 
-            if (strcmp(curve.Id->GetString().GetRawString(), IdNameOpacity) == 0)
-            {
-                return i;
-            }
+        if (curve.Type == CubismMotionCurveTarget_Model && curve.Id == opacityId)
+        {
+            return i;
         }
     }
 
@@ -859,14 +839,11 @@ CubismIdHandle CubismMotion::GetModelOpacityId(csmInt32 index)
 {
     if (index != -1)
     {
-        CubismMotionCurve curve = _motionData->Curves[index];
+        const CubismMotionCurve& curve = _motionData->Curves[index];
 
-        if (curve.Type == CubismMotionCurveTarget_Model)
+        if (curve.Type == CubismMotionCurveTarget_Model && curve.Id == CubismFramework::GetIdManager()->GetId(IdNameOpacity))
         {
-            if (strcmp(curve.Id->GetString().GetRawString(), IdNameOpacity) == 0)
-            {
-                return CubismFramework::GetIdManager()->GetId(curve.Id->GetString().GetRawString());
-            }
+            return curve.Id;
         }
     }
 
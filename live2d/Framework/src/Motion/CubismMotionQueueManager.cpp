@@ -18,6 +18,7 @@ CubismMotionQueueManager::CubismMotionQueueManager()
     : _userTimeSeconds(0.0f)
     , _eventCallback(NULL)
     , _eventCustomData(NULL)
+    , _motionQueueEntryHandleCounter(0)
 {}
 
 CubismMotionQueueManager::~CubismMotionQueueManager()
@@ -29,6 +30,11 @@ CubismMotionQueueManager::~CubismMotionQueueManager()
             CSM_DELETE(_motions[i]);
         }
     }
+
+    for (csmUint32 i = 0; i < _freeMotionQueueEntries.GetSize(); ++i)
+    {
+        CSM_DELETE(_freeMotionQueueEntries[i]);
+    }
 }
 
 CubismMotionQueueEntryHandle CubismMotionQueueManager::StartMotion(ACubismMotion* motion, csmBool autoDelete)
@@ -52,7 +58,7 @@ CubismMotionQueueEntryHandle CubismMotionQueueManager::StartMotion(ACubismMotion
         motionQueueEntry->SetFadeout(motionQueueEntry->_motion->GetFadeOutTime());
     }
 
-    motionQueueEntry = CSM_NEW CubismMotionQueueEntry(); // 終了時に破棄する
+    motionQueueEntry = AcquireMotionQueueEntry(); // 終了時にプールへ戻す
     motionQueueEntry->_autoDelete = autoDelete;
     motionQueueEntry->_motion = motion;
 
@@ -86,7 +92,7 @@ CubismMotionQueueEntryHandle CubismMotionQueueManager::StartMotion(ACubismMotion
         motionQueueEntry->SetFadeout(motionQueueEntry->_motion->GetFadeOutTime());
     }
 
-    motionQueueEntry = CSM_NEW CubismMotionQueueEntry(); // 終了時に破棄する
+    motionQueueEntry = AcquireMotionQueueEntry(); // 終了時にプールへ戻す
     motionQueueEntry->_autoDelete = autoDelete;
     motionQueueEntry->_motion = motion;
 
@@ -116,7 +122,7 @@ csmBool CubismMotionQueueManager::DoUpdateMotion(CubismModel* model, csmFloat32
 
         if (motion == NULL)
         {
-            CSM_DELETE(motionQueueEntry);
+            ReleaseMotionQueueEntry(motionQueueEntry);
             ite = _motions.Erase(ite);          // 削除
 
             continue;
@@ -142,7 +148,7 @@ csmBool CubismMotionQueueManager::DoUpdateMotion(CubismModel* model, csmFloat32
         // ----- 終了済みの処理があれば削除する ------
         if (motionQueueEntry->IsFinished())
         {
-            CSM_DELETE(motionQueueEntry);
+            ReleaseMotionQueueEntry(motionQueueEntry);
             ite = _motions.Erase(ite);          // 削除
         }
         else
@@ -206,7 +212,7 @@ csmBool CubismMotionQueueManager::IsFinished()
 
         if (motion == NULL)
         {
-            CSM_DELETE(motionQueueEntry);
+            ReleaseMotionQueueEntry(motionQueueEntry);
             ite = _motions.Erase(ite);          // 削除
             continue;
         }
@@ -264,11 +270,46 @@ void CubismMotionQueueManager::StopAllMotions()
         }
 
         // ----- 終了済みの処理があれば削除する ------
-        CSM_DELETE(motionQueueEntry);
+        ReleaseMotionQueueEntry(motionQueueEntry);
         ite = _motions.Erase(ite); //削除
     }
 }
 
+CubismMotionQueueEntry* CubismMotionQueueManager::AcquireMotionQueueEntry()
+{
+    CubismMotionQueueEntry* motionQueueEntry;
+
+    if (_freeMotionQueueEntries.GetSize() > 0)
+    {
+        motionQueueEntry = _freeMotionQueueEntries[_freeMotionQueueEntries.GetSize() - 1];
+        _freeMotionQueueEntries.Remove(_freeMotionQueueEntries.GetSize() - 1);
+        *motionQueueEntry = CubismMotionQueueEntry();
+    }
+    else
+    {
+        motionQueueEntry = CSM_NEW CubismMotionQueueEntry();
+    }
+
+    // エントリを再利用するため、ハンドルはアドレスではなく通し番号で一意にする
+    ++_motionQueueEntryHandleCounter;
+    motionQueueEntry->_motionQueueEntryHandle = reinterpret_cast<CubismMotionQueueEntryHandle>(_motionQueueEntryHandleCounter);
+
+    return motionQueueEntry;
+}
+
+void CubismMotionQueueManager::ReleaseMotionQueueEntry(CubismMotionQueueEntry* motionQueueEntry)
+{
+    if (motionQueueEntry->_autoDelete && motionQueueEntry->_motion)
+    {
+        ACubismMotion::Delete(motionQueueEntry->_motion);
+    }
+
+    motionQueueEntry->_autoDelete = false;
+    motionQueueEntry->_motion = NULL;
+
+    _freeMotionQueueEntries.PushBack(motionQueueEntry, false);
+}
+
 void CubismMotionQueueManager::SetEventCallback(CubismMotionEventFunction callback, void* customData)
 {
     _eventCallback   = callback;
@@ -158,14 +158,37 @@ protected:
     */
     virtual csmBool     DoUpdateMotion(CubismModel* model, csmFloat32 userTimeSeconds);
 
+    /**
+    * @brief モーションキューエントリの取得
+    *
+    * 解放済みのエントリがあれば初期化して再利用し、なければ新規に確保する。
+    * ハンドルは取得ごとに新しい値が割り当てられる。
+    *
+    * @return  初期化済みのエントリ
+    */
+    CubismMotionQueueEntry* AcquireMotionQueueEntry();
+
+    /**
+    * @brief モーションキューエントリの解放
+    *
+    * 自動削除が指定されていればモーションを破棄し、エントリは再利用のため保持する。
+    * 呼び出し側でキューからエントリを取り除くこと。
+    *
+    * @param[in]   motionQueueEntry   解放するエントリ
+    */
+    void                ReleaseMotionQueueEntry(CubismMotionQueueEntry* motionQueueEntry);
+
 
     csmFloat32 _userTimeSeconds;        ///< デルタ時間の積算値[秒]
 
 private:
-    csmVector<CubismMotionQueueEntry*>      _motions;       ///< モーション
+    csmSmallVector<CubismMotionQueueEntry*, 4>  _motions;   ///< モーション。同時に再生するのは通常数個のため内部バッファに格納する
 
     CubismMotionEventFunction         _eventCallback;     ///< コールバック関数ポインタ
     void*                             _eventCustomData;   ///< コールバックに戻されるデータ
+
+    csmSmallVector<CubismMotionQueueEntry*, 4>  _freeMotionQueueEntries;          ///< 再利用待ちのエントリ。モーション開始のたびに確保しないよう保持する
+    csmSizeType                                 _motionQueueEntryHandleCounter;   ///< ハンドルの通し番号
 };
 
 }}}
@@ -7,6 +7,7 @@
 
 #include "CubismPhysics.hpp"
 #include "CubismPhysicsInternal.hpp"
+#include "CubismPhysicsKernel.hpp"
 #include "CubismPhysicsJson.hpp"
 #include "Model/CubismModel.hpp"
 #include "Utils/CubismString.hpp"
@@ -23,45 +24,41 @@ const csmChar* PhysicsTypeTagX = "X";
 const csmChar* PhysicsTypeTagY = "Y";
 const csmChar* PhysicsTypeTagAngle = "Angle";
 
-/// Constant of air resistance.
-const csmFloat32 AirResistance = 5.0f;
+/// Constant of maximum number of fixed time steps in one evaluation.
+const csmInt32 MaxFixedTimeStepCount = 8;
 
-/// Constant of maximum weight of input and output ratio.
-const csmFloat32 MaximumWeight = 100.0f;
+/// Constant of minimum particle count of a stage to evaluate its sub-rigs in parallel.
+const csmInt32 ParallelEvaluationMinimumParticleCount = 64;
 
-/// Constant of threshold of movement.
-const csmFloat32 MovementThreshold = 0.001f;
+/// Version of the snapshot layout. Increment when the layout changes.
+const csmUint32 SnapshotVersion = 1;
 
-/// Constant of maximum allowed delta time
-const csmFloat32 MaxDeltaTime = 5.0f;
+/// Flags of the snapshot.
+const csmUint32 SnapshotFlag_HasRigOutputs = 1 << 0;
+const csmUint32 SnapshotFlag_IsParameterCacheInitialized = 1 << 1;
 
-csmFloat32 GetRangeValue(csmFloat32 min, csmFloat32 max)
+/// Writes a value to the snapshot and advances the cursor.
+template <class T>
+void WriteSnapshotValue(csmByte*& cursor, const T& value)
 {
-    csmFloat32 maxValue = CubismMath::Max(min, max);
-    csmFloat32 minValue = CubismMath::Min(min, max);
-
-    return CubismMath::AbsF(maxValue - minValue);
+    memcpy(cursor, &value, sizeof(T));
+    cursor += sizeof(T);
 }
 
-/// Gets sign.
-///
-/// @param  value  Evaluation target value.
-///
-/// @return  Sign of value.
-csmInt32 Sign(csmFloat32 value)
+/// Reads a value from the snapshot and advances the cursor.
+template <class T>
+void ReadSnapshotValue(const csmByte*& cursor, T* value)
 {
-    csmInt32 ret = 0;
+    memcpy(value, cursor, sizeof(T));
+    cursor += sizeof(T);
+}
 
-    if (value > 0.0f)
-    {
-        ret = 1;
-    }
-    else if (value < 0.0f)
-    {
-        ret = -1;
-    }
+csmFloat32 GetRangeValue(csmFloat32 min, csmFloat32 max)
+{
+    csmFloat32 maxValue = CubismMath::Max(min, max);
+    csmFloat32 minValue = CubismMath::Min(min, max);
 
-    return ret;
+    return CubismMath::AbsF(maxValue - minValue);
 }
 
 csmFloat32 GetDefaultValue(csmFloat32 min, csmFloat32 max)
@@ -70,203 +67,265 @@ csmFloat32 GetDefaultValue(csmFloat32 min, csmFloat32 max)
     return minValue + (GetRangeValue(min, max) / 2.0f);
 }
 
-csmFloat32 NormalizeParameterValue(
-    csmFloat32 value,
-    csmFloat32 parameterMinimum,
-    csmFloat32 parameterMaximum,
-    csmFloat32 parameterDefault,
-    csmFloat32 normalizedMinimum,
-    csmFloat32 normalizedMaximum,
-    csmFloat32 normalizedDefault,
-    csmInt32 isInverted)
+/// Binds the parameter range of the model to the compiled input.
+///
+/// @param  input             Target compiled input.
+/// @param  parameterMinimum  Minimum of parameter value.
+/// @param  parameterMaximum  Maximum of parameter value.
+void BindInputParameterRange(CubismPhysicsCompiledInput* input, csmFloat32 parameterMinimum, csmFloat32 parameterMaximum)
 {
-    csmFloat32 result = 0.0f;
-
     const csmFloat32 maxValue = CubismMath::Max(parameterMaximum, parameterMinimum);
+    const csmFloat32 minValue = CubismMath::Min(parameterMaximum, parameterMinimum);
+    const csmFloat32 middleValue = GetDefaultValue(minValue, maxValue);
 
-    if (maxValue < value)
-    {
-        value = maxValue;
-    }
+    const csmFloat32 positiveLength = maxValue - middleValue;
+    const csmFloat32 negativeLength = minValue - middleValue;
 
-    const csmFloat32 minValue = CubismMath::Min(parameterMaximum, parameterMinimum);
+    input->ParameterMinimum = minValue;
+    input->ParameterMaximum = maxValue;
+    input->ParameterMiddle = middleValue;
+
+    input->HasPositiveRange = (positiveLength != 0.0f);
+    input->PositiveScale = (input->HasPositiveRange)
+        ? (input->NormalizedMaximum - input->NormalizedMiddle) / positiveLength
+        : 0.0f;
+
+    input->HasNegativeRange = (negativeLength != 0.0f);
+    input->NegativeScale = (input->HasNegativeRange)
+        ? (input->NormalizedMinimum - input->NormalizedMiddle) / negativeLength
+        : 0.0f;
+}
+
+/// Sums the normalized values of inputs of the same type.
+///
+/// @param  inputs           Compiled inputs of the same type.
+/// @param  inputCount       Count of inputs.
+/// @param  parameterCaches  Cached parameter values read by the inputs.
+///
+/// @return  Weighted sum of normalized values.
+csmFloat32 SumNormalizedInputs(const CubismPhysicsCompiledInput* inputs, csmInt32 inputCount, const csmFloat32* parameterCaches)
+{
+    csmFloat32 total = 0.0f;
 
-    if (minValue > value)
+    for (csmInt32 i = 0; i < inputCount; ++i)
     {
-        value = minValue;
+        total += Physics::GetWeightedNormalizedInput(inputs[i], parameterCaches[inputs[i].SourceCacheIndex]);
     }
 
-    const csmFloat32 minNormValue = CubismMath::Min(normalizedMinimum, normalizedMaximum);
-    const csmFloat32 maxNormValue = CubismMath::Max(normalizedMinimum, normalizedMaximum);
-    const csmFloat32 middleNormValue = normalizedDefault;
-
-    const csmFloat32 middleValue = GetDefaultValue(minValue, maxValue);
-    const csmFloat32 paramValue = value - middleValue;
+    return total;
+}
 
-    switch (Sign(paramValue))
+/// Evaluates outputs of the same type.
+///
+/// @param  outputs        Compiled outputs of the same type.
+/// @param  outputCount    Count of outputs.
+/// @param  particles      Particle states of the sub-rig.
+/// @param  parentGravity  Gravity.
+/// @param  rigOutputs     Output values of the sub-rig indexed by output index.
+template <CubismPhysicsSource Type>
+void EvaluateOutputs(const CubismPhysicsCompiledOutput* outputs, csmInt32 outputCount, const CubismPhysicsParticleState* particles,
+    CubismVector2 parentGravity, csmFloat32* rigOutputs)
+{
+    for (csmInt32 i = 0; i < outputCount; ++i)
     {
-    case 1: {
-        const csmFloat32 nLength = maxNormValue - middleNormValue;
-        const csmFloat32 pLength = maxValue - middleValue;
-        if (pLength != 0.0f)
-        {
-            result = paramValue * (nLength / pLength);
-            result += middleNormValue;
-        }
+        const CubismPhysicsCompiledOutput& output = outputs[i];
+        const csmInt32 particleIndex = output.VertexIndex;
 
-        break;
-    }
-    case -1: {
-        const csmFloat32 nLength = minNormValue - middleNormValue;
-        const csmFloat32 pLength = minValue - middleValue;
-        if (pLength != 0.0f)
+        CubismVector2 translation;
+        translation.X = particles[particleIndex].Position.X - particles[particleIndex - 1].Position.X;
+        translation.Y = particles[particleIndex].Position.Y - particles[particleIndex - 1].Position.Y;
+
+        // 角度の出力は1つ前の物理点の向きを基準にする。根元の物理点では重力の逆向きを使う
+        CubismVector2 parentDirection;
+        if (Type == CubismPhysicsSource_Angle)
         {
-            result = paramValue * (nLength / pLength);
-            result += middleNormValue;
+            parentDirection = (particleIndex >= 2)
+                ? CubismVector2(particles[particleIndex - 1].Position.X - particles[particleIndex - 2].Position.X,
+                                particles[particleIndex - 1].Position.Y - particles[particleIndex - 2].Position.Y)
+                : CubismVector2(parentGravity.X * -1.0f, parentGravity.Y * -1.0f);
         }
 
-        break;
-    }
-    case 0: {
-        result = middleNormValue;
-
-        break;
-    }
-    default: {
-        break;
+        rigOutputs[output.OutputIndex] =
+            Physics::GetOutputValue<Type>(translation, parentDirection) * output.ReflectSign;
     }
-    }
-
-    return (isInverted)
-        ? result
-        : (result * -1.0f);
 }
 
-void GetInputTranslationXFromNormalizedParameterValue(CubismVector2* targetTranslation, csmFloat32* targetAngle, csmFloat32 value,
-    csmFloat32 parameterMinimumValue, csmFloat32 parameterMaximumValue,
-    csmFloat32 parameterDefaultValue,
-    CubismPhysicsNormalization* normalizationPosition,
-    CubismPhysicsNormalization* normalizationAngle, csmInt32 isInverted,
-    csmFloat32 weight)
+/// Loads input parameters of the sub-rig.
+///
+/// @param  rig               Target rig.
+/// @param  setting           Target sub-rig.
+/// @param  parameterCaches   Cached parameter values read by the inputs.
+/// @param  totalTranslation  Total translation value.
+/// @param  totalAngle        Total angle.
+void LoadInputs(CubismPhysicsRig* rig, const CubismPhysicsSubRig* setting, const csmFloat32* parameterCaches,
+    CubismVector2* totalTranslation, csmFloat32* totalAngle)
 {
-    targetTranslation->X += NormalizeParameterValue(
-        value,
-        parameterMinimumValue,
-        parameterMaximumValue,
-        parameterDefaultValue,
-        normalizationPosition->Minimum,
-        normalizationPosition->Maximum,
-        normalizationPosition->Default,
-        isInverted
-    ) * weight;
+    totalTranslation->X = SumNormalizedInputs(
+        rig->CompiledInputs[CubismPhysicsSource_X].GetPtr() + setting->BaseCompiledInputIndex[CubismPhysicsSource_X],
+        setting->CompiledInputCount[CubismPhysicsSource_X],
+        parameterCaches
+    );
+    totalTranslation->Y = SumNormalizedInputs(
+        rig->CompiledInputs[CubismPhysicsSource_Y].GetPtr() + setting->BaseCompiledInputIndex[CubismPhysicsSource_Y],
+        setting->CompiledInputCount[CubismPhysicsSource_Y],
+        parameterCaches
+    );
+    *totalAngle = SumNormalizedInputs(
+        rig->CompiledInputs[CubismPhysicsSource_Angle].GetPtr() + setting->BaseCompiledInputIndex[CubismPhysicsSource_Angle],
+        setting->CompiledInputCount[CubismPhysicsSource_Angle],
+        parameterCaches
+    );
 }
 
-void GetInputTranslationYFromNormalizedParameterValue(CubismVector2* targetTranslation, csmFloat32* targetAngle, csmFloat32 value,
-    csmFloat32 parameterMinimumValue, csmFloat32 parameterMaximumValue,
-    csmFloat32 parameterDefaultValue,
-    CubismPhysicsNormalization* normalizationPosition,
-    CubismPhysicsNormalization* normalizationAngle,
-    csmInt32 isInverted, csmFloat32 weight)
+/// Evaluates outputs of the sub-rig.
+///
+/// @param  rig            Target rig.
+/// @param  setting        Target sub-rig.
+/// @param  particles      Particle states of the sub-rig.
+/// @param  parentGravity  Gravity.
+/// @param  rigOutputs     Output values of the sub-rig indexed by output index.
+void EvaluateSubRigOutputs(CubismPhysicsRig* rig, const CubismPhysicsSubRig* setting, const CubismPhysicsParticleState* particles,
+    CubismVector2 parentGravity, csmFloat32* rigOutputs)
 {
-    targetTranslation->Y += NormalizeParameterValue(
-        value,
-        parameterMinimumValue,
-        parameterMaximumValue,
-        parameterDefaultValue,
-        normalizationPosition->Minimum,
-        normalizationPosition->Maximum,
-        normalizationPosition->Default,
-        isInverted
-    ) * weight;
+    EvaluateOutputs<CubismPhysicsSource_X>(
+        rig->CompiledOutputs[CubismPhysicsSource_X].GetPtr() + setting->BaseCompiledOutputIndex[CubismPhysicsSource_X],
+        setting->CompiledOutputCount[CubismPhysicsSource_X],
+        particles, parentGravity, rigOutputs
+    );
+    EvaluateOutputs<CubismPhysicsSource_Y>(
+        rig->CompiledOutputs[CubismPhysicsSource_Y].GetPtr() + setting->BaseCompiledOutputIndex[CubismPhysicsSource_Y],
+        setting->CompiledOutputCount[CubismPhysicsSource_Y],
+        particles, parentGravity, rigOutputs
+    );
+    EvaluateOutputs<CubismPhysicsSource_Angle>(
+        rig->CompiledOutputs[CubismPhysicsSource_Angle].GetPtr() + setting->BaseCompiledOutputIndex[CubismPhysicsSource_Angle],
+        setting->CompiledOutputCount[CubismPhysicsSource_Angle],
+        particles, parentGravity, rigOutputs
+    );
 }
 
-void GetInputAngleFromNormalizedParameterValue(CubismVector2* targetTranslation, csmFloat32* targetAngle, csmFloat32 value,
-    csmFloat32 parameterMinimumValue, csmFloat32 parameterMaximumValue,
-    csmFloat32 parameterDefaultValue,
-    CubismPhysicsNormalization* normalizationPosition,
-    CubismPhysicsNormalization* normalizationAngle,
-    csmInt32 isInverted, csmFloat32 weight)
+/// Builds the stages of sub-rigs that can be evaluated independently.
+///
+/// A sub-rig is placed after every preceding sub-rig that writes a parameter it reads or writes,
+/// or reads a parameter it writes, so evaluating the stages in order gives the same result as the serial order.
+///
+/// @param  rig         Target rig.
+/// @param  cacheCount  Count of cached parameters.
+void BuildEvaluationStages(CubismPhysicsRig* rig, csmInt32 cacheCount)
 {
-    *targetAngle += NormalizeParameterValue(
-        value,
-        parameterMinimumValue,
-        parameterMaximumValue,
-        parameterDefaultValue,
-        normalizationAngle->Minimum,
-        normalizationAngle->Maximum,
-        normalizationAngle->Default,
-        isInverted
-    ) * weight;
-}
+    csmVector<csmInt32> lastReadStages;
+    csmVector<csmInt32> lastWrittenStages;
+    csmVector<csmInt32> subRigStages;
+    csmInt32 stageCount = 0;
 
-csmFloat32 GetOutputTranslationX(CubismVector2 translation, CubismPhysicsParticle* particles, csmInt32 particleIndex,
-    csmInt32 isInverted, CubismVector2 parentGravity)
-{
-    csmFloat32 outputValue = translation.X;
+    lastReadStages.Resize(cacheCount, -1);
+    lastWrittenStages.Resize(cacheCount, -1);
+    subRigStages.Resize(rig->SubRigCount, 0);
 
-    if (isInverted)
+    for (csmInt32 settingIndex = 0; settingIndex < rig->SubRigCount; ++settingIndex)
     {
-        outputValue *= -1.0f;
-    }
+        const CubismPhysicsSubRig& setting = rig->Settings[settingIndex];
+        csmInt32 stage = 0;
 
-    return outputValue;
-}
+        for (csmInt32 type = 0; type < CubismPhysicsSource_Count; ++type)
+        {
+            const CubismPhysicsCompiledInput* inputs = rig->CompiledInputs[type].GetPtr() + setting.BaseCompiledInputIndex[type];
 
-csmFloat32 GetOutputTranslationY(CubismVector2 translation, CubismPhysicsParticle* particles, csmInt32 particleIndex,
-    csmInt32 isInverted, CubismVector2 parentGravity)
-{
-    csmFloat32 outputValue = translation.Y;
+            for (csmInt32 i = 0; i < setting.CompiledInputCount[type]; ++i)
+            {
+                stage = CubismMath::Max(stage, lastWrittenStages[inputs[i].SourceCacheIndex] + 1);
+            }
+        }
 
-    if (isInverted)
-    {
-        outputValue *= -1.0f;
-    }
+        for (csmInt32 i = 0; i < setting.OutputCount; ++i)
+        {
+            const csmInt32 cacheIndex = rig->Outputs[setting.BaseOutputIndex + i].DestinationCacheIndex;
+            stage = CubismMath::Max(stage, lastWrittenStages[cacheIndex] + 1);
+            stage = CubismMath::Max(stage, lastReadStages[cacheIndex] + 1);
+        }
 
-    return outputValue;
-}
+        for (csmInt32 type = 0; type < CubismPhysicsSource_Count; ++type)
+        {
+            const CubismPhysicsCompiledInput* inputs = rig->CompiledInputs[type].GetPtr() + setting.BaseCompiledInputIndex[type];
 
-csmFloat32 GetOutputAngle(CubismVector2 translation, CubismPhysicsParticle* particles, csmInt32 particleIndex, csmInt32 isInverted,
-    CubismVector2 parentGravity)
-{
-    csmFloat32 outputValue;
+            for (csmInt32 i = 0; i < setting.CompiledInputCount[type]; ++i)
+            {
+                lastReadStages[inputs[i].SourceCacheIndex] = CubismMath::Max(lastReadStages[inputs[i].SourceCacheIndex], stage);
+            }
+        }
 
-    if (particleIndex >= 2)
-    {
-        parentGravity = particles[particleIndex - 1].Position - particles[particleIndex - 2].Position;
-    }
-    else
-    {
-        parentGravity *= -1.0f;
+        for (csmInt32 i = 0; i < setting.OutputCount; ++i)
+        {
+            const csmInt32 cacheIndex = rig->Outputs[setting.BaseOutputIndex + i].DestinationCacheIndex;
+            lastWrittenStages[cacheIndex] = CubismMath::Max(lastWrittenStages[cacheIndex], stage);
+        }
+
+        subRigStages[settingIndex] = stage;
+        stageCount = CubismMath::Max(stageCount, stage + 1);
     }
 
-    outputValue = CubismMath::DirectionToRadian(parentGravity, translation);
+    // 段ごとにサブリグを元の順番で並べる
+    rig->EvaluationOrder.Clear();
+    rig->EvaluationStageOffsets.Clear();
+    rig->EvaluationStageParticleCounts.Clear();
 
-    if (isInverted)
+    for (csmInt32 stage = 0; stage < stageCount; ++stage)
     {
-        outputValue *= -1.0f;
+        csmInt32 particleCount = 0;
+
+        rig->EvaluationStageOffsets.PushBack(rig->EvaluationOrder.GetSize());
+
+        for (csmInt32 settingIndex = 0; settingIndex < rig->SubRigCount; ++settingIndex)
+        {
+            if (subRigStages[settingIndex] != stage)
+            {
+                continue;
+            }
+
+            rig->EvaluationOrder.PushBack(settingIndex);
+            particleCount += rig->Settings[settingIndex].ParticleCount;
+        }
+
+        rig->EvaluationStageParticleCounts.PushBack(particleCount);
     }
 
-    return outputValue;
+    rig->EvaluationStageOffsets.PushBack(rig->EvaluationOrder.GetSize());
 }
 
-csmFloat32 GetOutputScaleTranslationX(CubismVector2 translationScale, csmFloat32 angleScale)
+/// Copies the parsed data of the rig. The copy is unresolved and referenced only by the caller.
+///
+/// @param  source  Rig to copy.
+///
+/// @return  Copied rig.
+CubismPhysicsRig* CloneRig(const CubismPhysicsRig* source)
 {
-    return translationScale.X;
-}
+    CubismPhysicsRig* rig = CSM_NEW CubismPhysicsRig;
 
-csmFloat32 GetOutputScaleTranslationY(CubismVector2 translationScale, csmFloat32 angleScale)
-{
-    return translationScale.Y;
-}
+    rig->SubRigCount = source->SubRigCount;
+    rig->Settings = source->Settings;
+    rig->Inputs = source->Inputs;
+    rig->Outputs = source->Outputs;
+    rig->Particles = source->Particles;
 
-csmFloat32 GetOutputScaleAngle(CubismVector2 translationScale, csmFloat32 angleScale)
-{
-    return angleScale;
+    for (csmInt32 type = 0; type < CubismPhysicsSource_Count; ++type)
+    {
+        rig->CompiledInputs[type] = source->CompiledInputs[type];
+        rig->CompiledOutputs[type] = source->CompiledOutputs[type];
+    }
+
+    rig->IsParameterIndexResolved = false;
+    rig->ReferenceCount = 1;
+    rig->Gravity = source->Gravity;
+    rig->Wind = source->Wind;
+    rig->Fps = source->Fps;
+
+    return rig;
 }
 
 /// Updates particles.
 ///
 /// @param  strand            Target array of particle.
+/// @param  states            States of the particles.
 /// @param  strandCount       Count of particle.
 /// @param  totalTranslation  Total translation value.
 /// @param  totalAngle        Total angle.
@@ -274,70 +333,29 @@ csmFloat32 GetOutputScaleAngle(CubismVector2 translationScale, csmFloat32 angleS
 /// @param  thresholdValue    Threshold of movement.
 /// @param  deltaTimeSeconds  Delta time.
 /// @param  airResistance     Air resistance.
-void UpdateParticles(CubismPhysicsParticle* strand, csmInt32 strandCount, CubismVector2 totalTranslation, csmFloat32 totalAngle,
-    CubismVector2 windDirection, csmFloat32 thresholdValue, csmFloat32 deltaTimeSeconds, csmFloat32 airResistance)
+void UpdateParticles(const CubismPhysicsParticle* strand, CubismPhysicsParticleState* states, csmInt32 strandCount,
+    CubismVector2 totalTranslation, csmFloat32 totalAngle, CubismVector2 windDirection, csmFloat32 thresholdValue,
+    csmFloat32 deltaTimeSeconds, csmFloat32 airResistance)
 {
-    csmInt32 i;
-    csmFloat32 totalRadian;
-    csmFloat32 delay;
-    csmFloat32 radian;
-    CubismVector2 currentGravity;
-    CubismVector2 direction;
-    CubismVector2 velocity;
-    CubismVector2 force;
-    CubismVector2 newDirection;
-
-    strand[0].Position = totalTranslation;
-
-    totalRadian = CubismMath::DegreesToRadian(totalAngle);
-    currentGravity = CubismMath::RadianToDirection(totalRadian);
-    currentGravity.Normalize();
-
-    for (i = 1; i < strandCount; ++i)
-    {
-        strand[i].Force = (currentGravity * strand[i].Acceleration) + windDirection;
-
-        strand[i].LastPosition = strand[i].Position;
-
-        delay = strand[i].Delay * deltaTimeSeconds * 30.0f;
-
-        direction.X = strand[i].Position.X - strand[i - 1].Position.X;
-        direction.Y = strand[i].Position.Y - strand[i - 1].Position.Y;
-
-        radian = CubismMath::DirectionToRadian(strand[i].LastGravity, currentGravity) / airResistance;
-
-        direction.X = ((CubismMath::CosF(radian) * direction.X) - (direction.Y * CubismMath::SinF(radian)));
-        direction.Y = ((CubismMath::SinF(radian) * direction.X) + (direction.Y * CubismMath::CosF(radian)));
+    states[0].Position = totalTranslation;
 
-        strand[i].Position = strand[i - 1].Position + direction;
-
-        velocity.X = strand[i].Velocity.X * delay;
-        velocity.Y = strand[i].Velocity.Y * delay;
-        force = strand[i].Force * delay * delay;
-
-        strand[i].Position = strand[i].Position + velocity + force;
-
-        newDirection = strand[i].Position - strand[i - 1].Position;
-
-        newDirection.Normalize();
-
-        strand[i].Position = strand[i - 1].Position + (newDirection * strand[i].Radius);
-
-        if (CubismMath::AbsF(strand[i].Position.X) < thresholdValue)
-        {
-            strand[i].Position.X = 0.0f;
-        }
+    const CubismVector2 currentGravity = Physics::GetGravityDirection(totalAngle);
 
-        if (delay != 0.0f)
-        {
-            strand[i].Velocity.X = strand[i].Position.X - strand[i].LastPosition.X;
-            strand[i].Velocity.Y = strand[i].Position.Y - strand[i].LastPosition.Y;
-            strand[i].Velocity /= delay;
-            strand[i].Velocity *= strand[i].Mobility;
-        }
-
-        strand[i].Force = CubismVector2(0.0f, 0.0f);
-        strand[i].LastGravity = currentGravity;
+    for (csmInt32 i = 1; i < strandCount; ++i)
+    {
+        Physics::UpdateParticle(
+            strand[i],
+            states[i - 1].Position,
+            &states[i].Position,
+            &states[i].LastPosition,
+            &states[i].Velocity,
+            &states[i].LastGravity,
+            currentGravity,
+            windDirection,
+            thresholdValue,
+            strand[i].Delay * deltaTimeSeconds * 30.0f,
+            airResistance
+        );
     }
 }
 
@@ -345,96 +363,33 @@ void UpdateParticles(CubismPhysicsParticle* strand, csmInt32 strandCount, Cubism
  * Updates particles for stabilization.
  *
  * @param strand                Target array of particle.
+ * @param states                States of the particles.
  * @param strandCount           Count of particle.
  * @param totalTranslation      Total translation value.
  * @param totalAngle            Total angle.
  * @param windDirection         Direction of Wind.
  * @param thresholdValue        Threshold of movement.
  */
-void UpdateParticlesForStabilization(CubismPhysicsParticle* strand, csmInt32 strandCount, CubismVector2 totalTranslation, csmFloat32 totalAngle,
-    CubismVector2 windDirection, csmFloat32 thresholdValue)
-{
-    csmInt32 i;
-    csmFloat32 totalRadian;
-    CubismVector2 currentGravity;
-    CubismVector2 force;
-
-    strand[0].Position = totalTranslation;
-
-    totalRadian = CubismMath::DegreesToRadian(totalAngle);
-    currentGravity = CubismMath::RadianToDirection(totalRadian);
-    currentGravity.Normalize();
-
-    for (i = 1; i < strandCount; ++i)
-    {
-        strand[i].Force = (currentGravity * strand[i].Acceleration) + windDirection;
-
-        strand[i].LastPosition = strand[i].Position;
-
-        strand[i].Velocity = CubismVector2(0.0, 0.0);
-
-        force = strand[i].Force;
-        force.Normalize();
-
-        force *= strand[i].Radius;
-        strand[i].Position = strand[i - 1].Position + force;
-
-        if (CubismMath::AbsF(strand[i].Position.X) < thresholdValue)
-        {
-            strand[i].Position.X = 0.0f;
-        }
-
-        strand[i].Force = CubismVector2(0.0f, 0.0f);
-        strand[i].LastGravity = currentGravity;
-    }
-}
-
-/// Updates output parameter value.
-///
-/// @param  parameterValue         Target parameter value.
-/// @param  parameterValueMinimum  Minimum of parameter value.
-/// @param  parameterValueMaximum  Maximum of parameter value.
-/// @param  translation            Translation value.
-void UpdateOutputParameterValue(csmFloat32* parameterValue, csmFloat32 parameterValueMinimum, csmFloat32 parameterValueMaximum,
-    csmFloat32 translation, CubismPhysicsOutput* output)
+void UpdateParticlesForStabilization(const CubismPhysicsParticle* strand, CubismPhysicsParticleState* states, csmInt32 strandCount,
+    CubismVector2 totalTranslation, csmFloat32 totalAngle, CubismVector2 windDirection, csmFloat32 thresholdValue)
 {
-    csmFloat32 outputScale;
-    csmFloat32 value;
-    csmFloat32 weight;
-
-    outputScale = output->GetScale(output->TranslationScale, output->AngleScale);
-
-    value = translation * outputScale;
-
-    if (value < parameterValueMinimum)
-    {
-        if (value < output->ValueBelowMinimum)
-        {
-            output->ValueBelowMinimum = value;
-        }
-
-        value = parameterValueMinimum;
-    }
-    else if (value > parameterValueMaximum)
-    {
-        if (value > output->ValueExceededMaximum)
-        {
-            output->ValueExceededMaximum = value;
-        }
-
-        value = parameterValueMaximum;
-    }
+    states[0].Position = totalTranslation;
 
-    weight = (output->Weight / MaximumWeight);
+    const CubismVector2 currentGravity = Physics::GetGravityDirection(totalAngle);
 
-    if (weight >= 1.0f)
+    for (csmInt32 i = 1; i < strandCount; ++i)
     {
-        *parameterValue = value;
-    }
-    else
-    {
-        value = (*parameterValue * (1.0f - weight)) + (value * weight);
-        *parameterValue = value;
+        Physics::StabilizeParticle(
+            strand[i],
+            states[i - 1].Position,
+            &states[i].Position,
+            &states[i].LastPosition,
+            &states[i].Velocity,
+            &states[i].LastGravity,
+            currentGravity,
+            windDirection,
+            thresholdValue
+        );
     }
 }
 
@@ -449,11 +404,19 @@ CubismPhysics::CubismPhysics()
     _options.Wind.X = 0;
     _options.Wind.Y = 0;
     _currentRemainTime = 0.0f;
+    _fixedTimeStep = 0.0f;
+    _isParameterCacheInitialized = false;
+    _hasRigOutputs = false;
+    _isSerialEvaluationForced = false;
 }
 
 CubismPhysics::~CubismPhysics()
 {
-    CSM_DELETE(_physicsRig);
+    if (_physicsRig != NULL)
+    {
+        ReleaseRig(_physicsRig);
+    }
+
     _parameterCaches.Clear();
     _parameterInputCaches.Clear();
 }
@@ -463,40 +426,50 @@ CubismPhysics::~CubismPhysics()
 /// @param  physics  Target rig.
 void CubismPhysics::Initialize()
 {
-    CubismPhysicsParticle* strand;
+    CubismPhysicsParticleState* states;
     CubismPhysicsSubRig* currentSetting;
+    const CubismPhysicsParticle* strand;
     csmInt32 i, settingIndex;
-    CubismVector2 radius;
 
     for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
     {
         currentSetting = &_physicsRig->Settings[settingIndex];
         strand = &_physicsRig->Particles[currentSetting->BaseParticleIndex];
-
-        // Initialize the top of particle.
-        strand[0].InitialPosition = CubismVector2(0.0f, 0.0f);
-        strand[0].LastPosition = strand[0].InitialPosition;
-        strand[0].LastGravity = CubismVector2(0.0f, -1.0f);
-        strand[0].LastGravity.Y *= -1.0f;
-        strand[0].Velocity = CubismVector2(0.0f, 0.0f);
-        strand[0].Force = CubismVector2(0.0f, 0.0f);
+        states = &_particleStates[currentSetting->BaseParticleIndex];
 
         // Initialize particles.
-        for (i = 1; i < currentSetting->ParticleCount; ++i)
+        for (i = 0; i < currentSetting->ParticleCount; ++i)
         {
-            radius = CubismVector2(0.0f, 0.0f);
-            radius.Y = strand[i].Radius;
-            strand[i].InitialPosition = strand[i - 1].InitialPosition + radius;
-            strand[i].Position = strand[i].InitialPosition;
-            strand[i].LastPosition = strand[i].InitialPosition;
-            strand[i].LastGravity = CubismVector2(0.0f, -1.0f);
-            strand[i].LastGravity.Y *= -1.0f;
-            strand[i].Velocity = CubismVector2(0.0f, 0.0f);
-            strand[i].Force = CubismVector2(0.0f, 0.0f);
+            states[i].Position = strand[i].InitialPosition;
+            states[i].LastPosition = strand[i].InitialPosition;
+            states[i].LastGravity = CubismVector2(0.0f, -1.0f);
+            states[i].LastGravity.Y *= -1.0f;
+            states[i].Velocity = CubismVector2(0.0f, 0.0f);
         }
     }
 }
 
+void CubismPhysics::InitializeState()
+{
+    _particleStates.Resize(_physicsRig->Particles.GetSize());
+
+    _currentRigOutputs.Clear();
+    _previousRigOutputs.Clear();
+
+    for (csmInt32 settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+    {
+        PhysicsOutput currentRigOutput;
+        currentRigOutput.outputs.Resize(_physicsRig->Settings[settingIndex].OutputCount);
+        _currentRigOutputs.PushBack(currentRigOutput);
+
+        PhysicsOutput previousRigOutput;
+        previousRigOutput.outputs.Resize(_physicsRig->Settings[settingIndex].OutputCount);
+        _previousRigOutputs.PushBack(previousRigOutput);
+    }
+
+    Initialize();
+}
+
 /// Reset the physics states.
 void CubismPhysics::Reset()
 {
@@ -506,11 +479,6 @@ void CubismPhysics::Reset()
     _options.Wind.X = 0.0f;
     _options.Wind.Y = 0.0f;
 
-    _physicsRig->Gravity.X = 0.0f;
-    _physicsRig->Gravity.Y = 0.0f;
-    _physicsRig->Wind.X = 0.0f;
-    _physicsRig->Wind.Y = 0.0f;
-
     Initialize();
 }
 
@@ -526,7 +494,24 @@ CubismPhysics* CubismPhysics::Create(const csmByte* buffer, csmSizeInt size)
         return NULL;
     }
 
-    ret->_physicsRig->Gravity.Y = 0;
+    ret->InitializeState();
+    return ret;
+}
+
+CubismPhysics* CubismPhysics::Create(const CubismPhysics* source)
+{
+    if (source == NULL)
+    {
+        return NULL;
+    }
+
+    CubismPhysics* ret = CSM_NEW CubismPhysics();
+
+    ret->_physicsRig = source->_physicsRig;
+    ret->_physicsRig->ReferenceCount++;
+    ret->_isJsonValid = true;
+
+    ret->InitializeState();
     return ret;
 }
 
@@ -538,6 +523,7 @@ void CubismPhysics::Delete(CubismPhysics* physics)
 void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
 {
     _physicsRig = CSM_NEW CubismPhysicsRig;
+    _physicsRig->ReferenceCount = 1;
 
     CubismPhysicsJson* json = CSM_NEW CubismPhysicsJson(physicsJson, size);
 
@@ -560,9 +546,6 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
     _physicsRig->Outputs.UpdateSize(json->GetTotalOutputCount(), CubismPhysicsOutput(), true);
     _physicsRig->Particles.UpdateSize(json->GetVertexCount(), CubismPhysicsParticle(), true);
 
-    _currentRigOutputs.Clear();
-    _previousRigOutputs.Clear();
-
     csmInt32 inputIndex = 0, outputIndex = 0, particleIndex = 0;
     for (csmUint32 i = 0; i < _physicsRig->Settings.GetSize(); ++i)
     {
@@ -586,17 +569,14 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
             if (strcmp(json->GetInputType(i, j), PhysicsTypeTagX) == 0)
             {
                 _physicsRig->Inputs[inputIndex + j].Type = CubismPhysicsSource_X;
-                _physicsRig->Inputs[inputIndex + j].GetNormalizedParameterValue = GetInputTranslationXFromNormalizedParameterValue;
             }
             else if (strcmp(json->GetInputType(i, j), PhysicsTypeTagY) == 0)
             {
                 _physicsRig->Inputs[inputIndex + j].Type = CubismPhysicsSource_Y;
-                _physicsRig->Inputs[inputIndex + j].GetNormalizedParameterValue = GetInputTranslationYFromNormalizedParameterValue;
             }
             else if (strcmp(json->GetInputType(i, j), PhysicsTypeTagAngle) == 0)
             {
                 _physicsRig->Inputs[inputIndex + j].Type = CubismPhysicsSource_Angle;
-                _physicsRig->Inputs[inputIndex + j].GetNormalizedParameterValue = GetInputAngleFromNormalizedParameterValue;
             }
 
             _physicsRig->Inputs[inputIndex + j].Source.TargetType = CubismPhysicsTargetType_Parameter;
@@ -608,14 +588,6 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
         _physicsRig->Settings[i].OutputCount = json->GetOutputCount(i);
         _physicsRig->Settings[i].BaseOutputIndex = outputIndex;
 
-        PhysicsOutput currentRigOutput;
-        currentRigOutput.outputs.Resize(_physicsRig->Settings[i].OutputCount);
-        _currentRigOutputs.PushBack(currentRigOutput);
-
-        PhysicsOutput previousRigOutput;
-        previousRigOutput.outputs.Resize(_physicsRig->Settings[i].OutputCount);
-        _previousRigOutputs.PushBack(previousRigOutput);
-
         for (csmInt32 j = 0; j < _physicsRig->Settings[i].OutputCount; ++j)
         {
             _physicsRig->Outputs[outputIndex + j].DestinationParameterIndex = -1;
@@ -628,20 +600,17 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
             if (strcmp(json->GetOutputType(i, j), PhysicsTypeTagX) == 0)
             {
                 _physicsRig->Outputs[outputIndex + j].Type = CubismPhysicsSource_X;
-                _physicsRig->Outputs[outputIndex + j].GetValue = GetOutputTranslationX;
-                _physicsRig->Outputs[outputIndex + j].GetScale = GetOutputScaleTranslationX;
+                _physicsRig->Outputs[outputIndex + j].Scale = _physicsRig->Outputs[outputIndex + j].TranslationScale.X;
             }
             else if (strcmp(json->GetOutputType(i, j), PhysicsTypeTagY) == 0)
             {
                 _physicsRig->Outputs[outputIndex + j].Type = CubismPhysicsSource_Y;
-                _physicsRig->Outputs[outputIndex + j].GetValue = GetOutputTranslationY;
-                _physicsRig->Outputs[outputIndex + j].GetScale = GetOutputScaleTranslationY;
+                _physicsRig->Outputs[outputIndex + j].Scale = _physicsRig->Outputs[outputIndex + j].TranslationScale.Y;
             }
             else if (strcmp(json->GetOutputType(i, j), PhysicsTypeTagAngle) == 0)
             {
                 _physicsRig->Outputs[outputIndex + j].Type = CubismPhysicsSource_Angle;
-                _physicsRig->Outputs[outputIndex + j].GetValue = GetOutputAngle;
-                _physicsRig->Outputs[outputIndex + j].GetScale = GetOutputScaleAngle;
+                _physicsRig->Outputs[outputIndex + j].Scale = _physicsRig->Outputs[outputIndex + j].AngleScale;
             }
 
             _physicsRig->Outputs[outputIndex + j].Reflect = json->GetOutputReflect(i, j);
@@ -657,149 +626,358 @@ void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
             _physicsRig->Particles[particleIndex + j].Delay = json->GetParticleDelay(i, j);
             _physicsRig->Particles[particleIndex + j].Acceleration = json->GetParticleAcceleration(i, j);
             _physicsRig->Particles[particleIndex + j].Radius = json->GetParticleRadius(i, j);
-            _physicsRig->Particles[particleIndex + j].Position = json->GetParticlePosition(i, j);
+
+            // 振り子の根元から距離だけ下に並べた位置を初期位置にする
+            CubismVector2 radius(0.0f, 0.0f);
+            if (j > 0)
+            {
+                radius.Y = _physicsRig->Particles[particleIndex + j].Radius;
+                radius = _physicsRig->Particles[particleIndex + j - 1].InitialPosition + radius;
+            }
+            _physicsRig->Particles[particleIndex + j].InitialPosition = radius;
         }
 
         particleIndex += _physicsRig->Settings[i].ParticleCount;
+
+        Compile(i);
     }
 
-    Initialize();
+    _physicsRig->IsParameterIndexResolved = false;
 
     CSM_DELETE(json);
 }
 
+void CubismPhysics::Compile(csmInt32 settingIndex)
+{
+    CubismPhysicsSubRig* currentSetting = &_physicsRig->Settings[settingIndex];
+    const CubismPhysicsInput* currentInputs = &_physicsRig->Inputs[currentSetting->BaseInputIndex];
+    const CubismPhysicsOutput* currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
+
+    for (csmInt32 type = 0; type < CubismPhysicsSource_Count; ++type)
+    {
+        csmVector<CubismPhysicsCompiledInput>& compiledInputs = _physicsRig->CompiledInputs[type];
+        currentSetting->BaseCompiledInputIndex[type] = compiledInputs.GetSize();
+
+        const CubismPhysicsNormalization& normalization = (type == CubismPhysicsSource_Angle)
+            ? currentSetting->NormalizationAngle
+            : currentSetting->NormalizationPosition;
+
+        for (csmInt32 i = 0; i < currentSetting->InputCount; ++i)
+        {
+            if (currentInputs[i].Type != type)
+            {
+                continue;
+            }
+
+            const csmFloat32 weight = currentInputs[i].Weight / Physics::MaximumWeight;
+
+            CubismPhysicsCompiledInput compiledInput;
+            compiledInput.InputIndex = currentSetting->BaseInputIndex + i;
+            compiledInput.SourceCacheIndex = -1;
+            compiledInput.Weight = (currentInputs[i].Reflect) ? weight : -weight;
+            compiledInput.NormalizedMinimum = CubismMath::Min(normalization.Minimum, normalization.Maximum);
+            compiledInput.NormalizedMaximum = CubismMath::Max(normalization.Minimum, normalization.Maximum);
+            compiledInput.NormalizedMiddle = normalization.Default;
+            BindInputParameterRange(&compiledInput, 0.0f, 0.0f);
+            compiledInputs.PushBack(compiledInput);
+        }
+
+        currentSetting->CompiledInputCount[type] = compiledInputs.GetSize() - currentSetting->BaseCompiledInputIndex[type];
+
+        csmVector<CubismPhysicsCompiledOutput>& compiledOutputs = _physicsRig->CompiledOutputs[type];
+        currentSetting->BaseCompiledOutputIndex[type] = compiledOutputs.GetSize();
+
+        for (csmInt32 i = 0; i < currentSetting->OutputCount; ++i)
+        {
+            // 範囲外の振り子を参照する出力は評価されない
+            if (currentOutputs[i].Type != type
+                || currentOutputs[i].VertexIndex < 1
+                || currentOutputs[i].VertexIndex >= currentSetting->ParticleCount)
+            {
+                continue;
+            }
+
+            CubismPhysicsCompiledOutput compiledOutput;
+            compiledOutput.OutputIndex = i;
+            compiledOutput.VertexIndex = currentOutputs[i].VertexIndex;
+            compiledOutput.ReflectSign = (currentOutputs[i].Reflect) ? -1.0f : 1.0f;
+            compiledOutputs.PushBack(compiledOutput);
+        }
+
+        currentSetting->CompiledOutputCount[type] = compiledOutputs.GetSize() - currentSetting->BaseCompiledOutputIndex[type];
+    }
+}
+
+void CubismPhysics::ResolveRigParameterIndices(CubismPhysicsRig* rig, CubismModel* model)
+{
+    const csmFloat32* parameterMaximumValues = Core::csmGetParameterMaximumValues(model->GetModel());
+    const csmFloat32* parameterMinimumValues = Core::csmGetParameterMinimumValues(model->GetModel());
+    const csmInt32 parameterCount = model->GetParameterCount();
+    csmInt32 parameterSlotCount = 0;
+
+    for (csmUint32 i = 0; i < rig->Inputs.GetSize(); ++i)
+    {
+        rig->Inputs[i].SourceParameterIndex = model->GetParameterIndex(rig->Inputs[i].Source.Id);
+        parameterSlotCount = CubismMath::Max(parameterSlotCount, rig->Inputs[i].SourceParameterIndex + 1);
+    }
+
+    for (csmUint32 i = 0; i < rig->Outputs.GetSize(); ++i)
+    {
+        rig->Outputs[i].DestinationParameterIndex = model->GetParameterIndex(rig->Outputs[i].Destination.Id);
+        parameterSlotCount = CubismMath::Max(parameterSlotCount, rig->Outputs[i].DestinationParameterIndex + 1);
+    }
+
+    // 入力元と出力先のパラメータだけをキャッシュする。
+    // 出力先はグループ間での値の伝搬と出力の合成に利用されるため含める必要がある。
+    // Only the source and destination parameters are cached.
+    // Destinations are needed because they propagate values between groups and are blended by the outputs.
+    csmVector<csmInt32> cacheIndexOfParameter;
+    cacheIndexOfParameter.Resize(parameterSlotCount, -1);
+
+    for (csmUint32 i = 0; i < rig->Inputs.GetSize(); ++i)
+    {
+        cacheIndexOfParameter[rig->Inputs[i].SourceParameterIndex] = 0;
+    }
+
+    for (csmUint32 i = 0; i < rig->Outputs.GetSize(); ++i)
+    {
+        cacheIndexOfParameter[rig->Outputs[i].DestinationParameterIndex] = 0;
+    }
+
+    rig->CachedParameterIndices.Clear();
+    for (csmInt32 i = 0; i < parameterSlotCount; ++i)
+    {
+        if (cacheIndexOfParameter[i] == -1)
+        {
+            continue;
+        }
+
+        cacheIndexOfParameter[i] = rig->CachedParameterIndices.GetSize();
+        rig->CachedParameterIndices.PushBack(i);
+    }
+
+    for (csmUint32 i = 0; i < rig->Outputs.GetSize(); ++i)
+    {
+        rig->Outputs[i].DestinationCacheIndex = cacheIndexOfParameter[rig->Outputs[i].DestinationParameterIndex];
+    }
+
+    for (csmInt32 type = 0; type < CubismPhysicsSource_Count; ++type)
+    {
+        csmVector<CubismPhysicsCompiledInput>& compiledInputs = rig->CompiledInputs[type];
+
+        for (csmUint32 i = 0; i < compiledInputs.GetSize(); ++i)
+        {
+            const csmInt32 parameterIndex = rig->Inputs[compiledInputs[i].InputIndex].SourceParameterIndex;
+
+            compiledInputs[i].SourceCacheIndex = cacheIndexOfParameter[parameterIndex];
+
+            // モデルに存在しないパラメータは範囲を持たないため、読み込み時と同じ空の範囲にする
+            if (parameterIndex >= parameterCount)
+            {
+                BindInputParameterRange(&compiledInputs[i], 0.0f, 0.0f);
+                continue;
+            }
+
+            BindInputParameterRange(
+                &compiledInputs[i],
+                parameterMinimumValues[parameterIndex],
+                parameterMaximumValues[parameterIndex]
+            );
+        }
+    }
+
+    BuildEvaluationStages(rig, rig->CachedParameterIndices.GetSize());
+}
+
+csmBool CubismPhysics::IsRigResolvedFor(const CubismPhysicsRig* rig, CubismModel* model)
+{
+    const csmFloat32* parameterMaximumValues = Core::csmGetParameterMaximumValues(model->GetModel());
+    const csmFloat32* parameterMinimumValues = Core::csmGetParameterMinimumValues(model->GetModel());
+    const csmInt32 parameterCount = model->GetParameterCount();
+
+    for (csmUint32 i = 0; i < rig->Inputs.GetSize(); ++i)
+    {
+        if (model->GetParameterIndex(rig->Inputs[i].Source.Id) != rig->Inputs[i].SourceParameterIndex)
+        {
+            return false;
+        }
+    }
+
+    for (csmUint32 i = 0; i < rig->Outputs.GetSize(); ++i)
+    {
+        if (model->GetParameterIndex(rig->Outputs[i].Destination.Id) != rig->Outputs[i].DestinationParameterIndex)
+        {
+            return false;
+        }
+    }
+
+    for (csmInt32 type = 0; type < CubismPhysicsSource_Count; ++type)
+    {
+        const csmVector<CubismPhysicsCompiledInput>& compiledInputs = rig->CompiledInputs[type];
+
+        for (csmUint32 i = 0; i < compiledInputs.GetSize(); ++i)
+        {
+            const csmInt32 parameterIndex = rig->Inputs[compiledInputs[i].InputIndex].SourceParameterIndex;
+
+            // モデルに存在しないパラメータは範囲を持たない
+            if (parameterIndex >= parameterCount)
+            {
+                continue;
+            }
+
+            const csmFloat32 maxValue = CubismMath::Max(parameterMaximumValues[parameterIndex], parameterMinimumValues[parameterIndex]);
+            const csmFloat32 minValue = CubismMath::Min(parameterMaximumValues[parameterIndex], parameterMinimumValues[parameterIndex]);
+
+            if (compiledInputs[i].ParameterMinimum != minValue || compiledInputs[i].ParameterMaximum != maxValue)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+CubismPhysicsRig* CubismPhysics::AcquireResolvedRig(CubismPhysicsRig* rig, CubismModel* model)
+{
+    // 解決済みのデータは変更されないため、ロックは未解決の間だけ取る
+    if (!rig->IsParameterIndexResolved.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(rig->ResolveMutex);
+
+        if (!rig->IsParameterIndexResolved.load(std::memory_order_relaxed))
+        {
+            ResolveRigParameterIndices(rig, model);
+            rig->IsParameterIndexResolved.store(true, std::memory_order_release);
+        }
+    }
+
+    if (IsRigResolvedFor(rig, model))
+    {
+        return rig;
+    }
+
+    // 別のmocのモデルで解決されたデータは使えないため、呼び出し元専用の複製を解決する
+    CubismPhysicsRig* privateRig = CloneRig(rig);
+    ReleaseRig(rig);
+
+    ResolveRigParameterIndices(privateRig, model);
+    privateRig->IsParameterIndexResolved.store(true, std::memory_order_release);
+
+    return privateRig;
+}
+
+void CubismPhysics::ReleaseRig(CubismPhysicsRig* rig)
+{
+    // 物理演算のデータは共有している最後のインスタンスが破棄する
+    if (--rig->ReferenceCount == 0)
+    {
+        CSM_DELETE(rig);
+    }
+}
+
+void CubismPhysics::ResolveParameterIndices(CubismModel* model)
+{
+    const csmFloat32* parameterValues = Core::csmGetParameterValues(model->GetModel());
+
+    _physicsRig = AcquireResolvedRig(_physicsRig, model);
+
+    const csmInt32 cacheCount = _physicsRig->CachedParameterIndices.GetSize();
+
+    _parameterCaches.Resize(cacheCount);
+    _parameterInputCaches.Resize(cacheCount);
+    for (csmInt32 i = 0; i < cacheCount; ++i)
+    {
+        _parameterInputCaches[i] = parameterValues[_physicsRig->CachedParameterIndices[i]];
+    }
+
+    _isParameterCacheInitialized = true;
+}
 
 void CubismPhysics::Stabilization(CubismModel* model)
 {
     csmFloat32 totalAngle;
-    csmFloat32 weight;
-    csmFloat32 radAngle;
-    csmFloat32 outputValue;
     CubismVector2 totalTranslation;
     csmInt32 i, settingIndex, particleIndex;
     CubismPhysicsSubRig* currentSetting;
-    CubismPhysicsInput* currentInputs;
-    CubismPhysicsOutput* currentOutputs;
-    CubismPhysicsParticle* currentParticles;
+    const CubismPhysicsOutput* currentOutputs;
+    const CubismPhysicsParticle* currentParticles;
+    CubismPhysicsParticleState* currentStates;
 
     csmFloat32* parameterValues;
     const csmFloat32* parameterMaximumValues;
     const csmFloat32* parameterMinimumValues;
-    const csmFloat32* parameterDefaultValues;
 
     parameterValues = Core::csmGetParameterValues(model->GetModel());
     parameterMaximumValues = Core::csmGetParameterMaximumValues(model->GetModel());
     parameterMinimumValues = Core::csmGetParameterMinimumValues(model->GetModel());
-    parameterDefaultValues = Core::csmGetParameterDefaultValues(model->GetModel());
 
-    if (_parameterCaches.GetSize() < model->GetParameterCount())
-    {
-        _parameterCaches.Resize(model->GetParameterCount());
-    }
-    if (_parameterInputCaches.GetSize() < model->GetParameterCount())
+    if (!_isParameterCacheInitialized)
     {
-        _parameterInputCaches.Resize(model->GetParameterCount());
+        ResolveParameterIndices(model);
     }
 
-    for (int j = 0; j < model->GetParameterCount(); ++j)
+    for (csmUint32 j = 0; j < _physicsRig->CachedParameterIndices.GetSize(); ++j)
     {
-        _parameterCaches[j] = parameterValues[j];
-        _parameterInputCaches[j] = parameterValues[j];
+        _parameterCaches[j] = parameterValues[_physicsRig->CachedParameterIndices[j]];
+        _parameterInputCaches[j] = _parameterCaches[j];
     }
 
     for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
     {
-        totalAngle = 0.0f;
-        totalTranslation.X = 0.0f;
-        totalTranslation.Y = 0.0f;
         currentSetting = &_physicsRig->Settings[settingIndex];
-        currentInputs = &_physicsRig->Inputs[currentSetting->BaseInputIndex];
         currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
         currentParticles = &_physicsRig->Particles[currentSetting->BaseParticleIndex];
+        currentStates = &_particleStates[currentSetting->BaseParticleIndex];
 
         // Load input parameters
-        for (i = 0; i < currentSetting->InputCount; ++i)
-        {
-            weight = currentInputs[i].Weight / MaximumWeight;
-
-            if (currentInputs[i].SourceParameterIndex == -1)
-            {
-                currentInputs[i].SourceParameterIndex = model->GetParameterIndex(currentInputs[i].Source.Id);
-            }
-
-            currentInputs[i].GetNormalizedParameterValue(
-                &totalTranslation,
-                &totalAngle,
-                parameterValues[currentInputs[i].SourceParameterIndex],
-                parameterMinimumValues[currentInputs[i].SourceParameterIndex],
-                parameterMaximumValues[currentInputs[i].SourceParameterIndex],
-                parameterDefaultValues[currentInputs[i].SourceParameterIndex],
-                &currentSetting->NormalizationPosition,
-                &currentSetting->NormalizationAngle,
-                currentInputs[i].Reflect,
-                weight
-            );
-
-            _parameterCaches[currentInputs[i].SourceParameterIndex] =
-                parameterValues[currentInputs[i].SourceParameterIndex];
-        }
-
-        radAngle = CubismMath::DegreesToRadian(-totalAngle);
+        LoadInputs(_physicsRig, currentSetting, _parameterCaches.GetPtr(), &totalTranslation, &totalAngle);
 
-        totalTranslation.X = (totalTranslation.X * CubismMath::CosF(radAngle) - totalTranslation.Y * CubismMath::SinF(radAngle));
-        totalTranslation.Y = (totalTranslation.X * CubismMath::SinF(radAngle) + totalTranslation.Y * CubismMath::CosF(radAngle));
+        Physics::RotateTranslation(&totalTranslation, totalAngle);
 
         // Calculate particles position.
         UpdateParticlesForStabilization(
             currentParticles,
+            currentStates,
             currentSetting->ParticleCount,
             totalTranslation,
             totalAngle,
             _options.Wind,
-            MovementThreshold * currentSetting->NormalizationPosition.Maximum
+            Physics::MovementThreshold * currentSetting->NormalizationPosition.Maximum
         );
 
         // Update output parameters.
+        EvaluateSubRigOutputs(
+            _physicsRig,
+            currentSetting,
+            currentStates,
+            _options.Gravity,
+            _currentRigOutputs[settingIndex].outputs.GetPtr()
+        );
+
         for (i = 0; i < currentSetting->OutputCount; ++i)
         {
             particleIndex = currentOutputs[i].VertexIndex;
 
-            if (currentOutputs[i].DestinationParameterIndex == -1)
-            {
-                currentOutputs[i].DestinationParameterIndex = model->GetParameterIndex(
-                    currentOutputs[i].Destination.Id);
-            }
-
             if (particleIndex < 1 || particleIndex >= currentSetting->ParticleCount)
             {
                 continue;
             }
 
-            CubismVector2 translation;
-            translation.X = currentParticles[particleIndex].Position.X - currentParticles[particleIndex - 1].Position.X;
-            translation.Y = currentParticles[particleIndex].Position.Y - currentParticles[particleIndex - 1].Position.Y;
-
-            outputValue = currentOutputs[i].GetValue(
-                translation,
-                currentParticles,
-                particleIndex,
-                currentOutputs[i].Reflect,
-                _options.Gravity
-            );
-
-            _currentRigOutputs[settingIndex].outputs[i] = outputValue;
-            _previousRigOutputs[settingIndex].outputs[i] = outputValue;
+            _previousRigOutputs[settingIndex].outputs[i] = _currentRigOutputs[settingIndex].outputs[i];
 
-            UpdateOutputParameterValue(
+            Physics::UpdateOutputParameterValue(
                 &parameterValues[currentOutputs[i].DestinationParameterIndex],
                 parameterMinimumValues[currentOutputs[i].DestinationParameterIndex],
                 parameterMaximumValues[currentOutputs[i].DestinationParameterIndex],
-                outputValue,
+                _currentRigOutputs[settingIndex].outputs[i],
                 &currentOutputs[i]);
 
-            _parameterCaches[currentOutputs[i].DestinationParameterIndex] = parameterValues[currentOutputs[i].DestinationParameterIndex];
+            _parameterCaches[currentOutputs[i].DestinationCacheIndex] = parameterValues[currentOutputs[i].DestinationParameterIndex];
         }
     }
+
+    _hasRigOutputs = true;
 }
 
 /// Pendulum interpolation weights
@@ -842,49 +1020,57 @@ void CubismPhysics::Stabilization(CubismModel* model)
 /// @param deltaTimeSeconds  rendering delta time.
 void CubismPhysics::Evaluate(CubismModel* model, csmFloat32 deltaTimeSeconds)
 {
-    csmFloat32 totalAngle;
-    csmFloat32 weight;
-    csmFloat32 radAngle;
-    csmFloat32 outputValue;
-    CubismVector2 totalTranslation;
-    csmInt32 i, settingIndex, particleIndex;
-    CubismPhysicsSubRig* currentSetting;
-    CubismPhysicsInput* currentInputs;
-    CubismPhysicsOutput* currentOutputs;
-    CubismPhysicsParticle* currentParticles;
-
-    if (0.0f >= deltaTimeSeconds)
-    {
-        return;
-    }
-
     csmFloat32* parameterValues;
     const csmFloat32* parameterMaximumValues;
     const csmFloat32* parameterMinimumValues;
-    const csmFloat32* parameterDefaultValues;
 
-    csmFloat32 physicsDeltaTime;
-    _currentRemainTime += deltaTimeSeconds;
-    if (_currentRemainTime > MaxDeltaTime)
+    // 通常の評価ではデルタ時間が0以下なら何もしない。決定論モードでは溜まった時間で進め、前回の結果を適用する
+    if (0.0f >= deltaTimeSeconds && _fixedTimeStep <= 0.0f)
     {
-        _currentRemainTime = 0.0f;
+        return;
     }
 
     parameterValues = Core::csmGetParameterValues(model->GetModel());
     parameterMaximumValues = Core::csmGetParameterMaximumValues(model->GetModel());
     parameterMinimumValues = Core::csmGetParameterMinimumValues(model->GetModel());
-    parameterDefaultValues = Core::csmGetParameterDefaultValues(model->GetModel());
 
-    if (_parameterCaches.GetSize() < model->GetParameterCount())
+    if (!_isParameterCacheInitialized)
     {
-        _parameterCaches.Resize(model->GetParameterCount());
+        ResolveParameterIndices(model);
     }
-    if (_parameterInputCaches.GetSize() < model->GetParameterCount())
+
+    // 決定論モードでは溜まった時間に収まる回数だけ固定時間で進め、現在のパラメータをそのまま入力にし、補間せずに適用する。
+    // In deterministic mode, run as many fixed steps as fit in the accumulated time, with the current parameters as inputs, and apply the result without interpolation.
+    if (_fixedTimeStep > 0.0f)
     {
-        _parameterInputCaches.Resize(model->GetParameterCount());
-        for (int j = 0; j < model->GetParameterCount(); ++j) {
-            _parameterInputCaches[j] = parameterValues[j];
+        if (deltaTimeSeconds > 0.0f)
+        {
+            _currentRemainTime += deltaTimeSeconds;
+        }
+
+        csmInt32 stepCount = 0;
+        while (_currentRemainTime >= _fixedTimeStep && stepCount < MaxFixedTimeStepCount)
+        {
+            StepRig(parameterValues, parameterMinimumValues, parameterMaximumValues, 1.0f, _fixedTimeStep);
+            _currentRemainTime -= _fixedTimeStep;
+            ++stepCount;
+        }
+
+        // 上限を超えた分は追いつこうとせずに捨てる
+        if (_currentRemainTime >= _fixedTimeStep)
+        {
+            _currentRemainTime = 0.0f;
         }
+
+        Interpolate(model, 1.0f);
+        return;
+    }
+
+    csmFloat32 physicsDeltaTime;
+    _currentRemainTime += deltaTimeSeconds;
+    if (_currentRemainTime > Physics::MaxDeltaTime)
+    {
+        _currentRemainTime = 0.0f;
     }
 
     if (_physicsRig->Fps > 0.0f)
@@ -898,133 +1084,177 @@ void CubismPhysics::Evaluate(CubismModel* model, csmFloat32 deltaTimeSeconds)
 
     while (_currentRemainTime >= physicsDeltaTime)
     {
-        // copyRigOutputs _currentRigOutputs to _previousRigOutputs
-        for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+        StepRig(parameterValues, parameterMinimumValues, parameterMaximumValues, physicsDeltaTime / _currentRemainTime, physicsDeltaTime);
+
+        _currentRemainTime -= physicsDeltaTime;
+    }
+
+    const float alpha = _currentRemainTime / physicsDeltaTime;
+    Interpolate(model, alpha);
+}
+
+void CubismPhysics::StepRig(const csmFloat32* parameterValues, const csmFloat32* parameterMinimumValues,
+    const csmFloat32* parameterMaximumValues, csmFloat32 inputWeight, csmFloat32 physicsDeltaTime)
+{
+    csmInt32 i, settingIndex;
+    CubismPhysicsSubRig* currentSetting;
+
+    _hasRigOutputs = true;
+
+    // copyRigOutputs _currentRigOutputs to _previousRigOutputs
+    for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+    {
+        currentSetting = &_physicsRig->Settings[settingIndex];
+        for (i = 0; i < currentSetting->OutputCount; ++i)
         {
-            currentSetting = &_physicsRig->Settings[settingIndex];
-            currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
-            for (i = 0; i < currentSetting->OutputCount; ++i)
-            {
-                _previousRigOutputs[settingIndex].outputs[i] = _currentRigOutputs[settingIndex].outputs[i];
-            }
+            _previousRigOutputs[settingIndex].outputs[i] = _currentRigOutputs[settingIndex].outputs[i];
         }
+    }
+
+    // 入力キャッシュとパラメータで線形補間してUpdateParticlesするタイミングでの入力を計算する。
+    // Calculate the input at the timing to UpdateParticles by linear interpolation with the _parameterInputCaches and parameterValues.
+    // _parameterCachesはグループ間での値の伝搬の役割があるので_parameterInputCachesとの分離が必要。
+    // _parameterCaches needs to be separated from _parameterInputCaches because of its role in propagating values between groups.
+    // 補間は物理演算が入出力するパラメータに対してのみ行う。
+    // Only the parameters the rig reads or writes are interpolated.
+    const csmInt32* cachedParameterIndices = _physicsRig->CachedParameterIndices.GetPtr();
+    for (csmUint32 j = 0; j < _physicsRig->CachedParameterIndices.GetSize(); ++j)
+    {
+        _parameterCaches[j] = _parameterInputCaches[j] * (1.0f - inputWeight) + parameterValues[cachedParameterIndices[j]] * inputWeight;
+        _parameterInputCaches[j] = _parameterCaches[j];
+    }
 
-        // 入力キャッシュとパラメータで線形補間してUpdateParticlesするタイミングでの入力を計算する。
-        // Calculate the input at the timing to UpdateParticles by linear interpolation with the _parameterInputCaches and parameterValues.
-        // _parameterCachesはグループ間での値の伝搬の役割があるので_parameterInputCachesとの分離が必要。
-        // _parameterCaches needs to be separated from _parameterInputCaches because of its role in propagating values between groups.
-        float inputWeight =  physicsDeltaTime / _currentRemainTime;
-        for (csmInt32 j = 0; j < model->GetParameterCount(); ++j)
+    if (_isSerialEvaluationForced || CubismFramework::GetJobSystem() == NULL)
+    {
+        for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
         {
-            _parameterCaches[j] = _parameterInputCaches[j] * (1.0f - inputWeight) + parameterValues[j] * inputWeight;
-            _parameterInputCaches[j] = _parameterCaches[j];
+            EvaluateSubRig(settingIndex, physicsDeltaTime, parameterMinimumValues, parameterMaximumValues);
         }
+    }
+    else
+    {
+        EvaluateSubRigStages(physicsDeltaTime, parameterMinimumValues, parameterMaximumValues);
+    }
+}
 
-        for (settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+void CubismPhysics::EvaluateSubRig(csmInt32 settingIndex, csmFloat32 physicsDeltaTime,
+    const csmFloat32* parameterMinimumValues, const csmFloat32* parameterMaximumValues)
+{
+    csmFloat32 totalAngle;
+    CubismVector2 totalTranslation;
+    csmInt32 i, particleIndex;
+
+    CubismPhysicsSubRig* currentSetting = &_physicsRig->Settings[settingIndex];
+    const CubismPhysicsOutput* currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
+    const CubismPhysicsParticle* currentParticles = &_physicsRig->Particles[currentSetting->BaseParticleIndex];
+    CubismPhysicsParticleState* currentStates = &_particleStates[currentSetting->BaseParticleIndex];
+
+    // Load input parameters.
+    LoadInputs(_physicsRig, currentSetting, _parameterCaches.GetPtr(), &totalTranslation, &totalAngle);
+
+    Physics::RotateTranslation(&totalTranslation, totalAngle);
+
+    // Calculate particles position.
+    UpdateParticles(
+        currentParticles,
+        currentStates,
+        currentSetting->ParticleCount,
+        totalTranslation,
+        totalAngle,
+        _options.Wind,
+        Physics::MovementThreshold * currentSetting->NormalizationPosition.Maximum,
+        physicsDeltaTime,
+        Physics::AirResistance
+    );
+
+    // Update output parameters.
+    EvaluateSubRigOutputs(
+        _physicsRig,
+        currentSetting,
+        currentStates,
+        _options.Gravity,
+        _currentRigOutputs[settingIndex].outputs.GetPtr()
+    );
+
+    // 同じパラメータへの出力があるため、適用は元の出力順で行う。
+    // Outputs are applied in their original order because several outputs may share a destination parameter.
+    for (i = 0; i < currentSetting->OutputCount; ++i)
+    {
+        particleIndex = currentOutputs[i].VertexIndex;
+
+        if (particleIndex < 1 || particleIndex >= currentSetting->ParticleCount)
         {
-            totalAngle = 0.0f;
-            totalTranslation.X = 0.0f;
-            totalTranslation.Y = 0.0f;
-            currentSetting = &_physicsRig->Settings[settingIndex];
-            currentInputs = &_physicsRig->Inputs[currentSetting->BaseInputIndex];
-            currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
-            currentParticles = &_physicsRig->Particles[currentSetting->BaseParticleIndex];
-
-            // Load input parameters.
-            for (i = 0; i < currentSetting->InputCount; ++i)
-            {
-                weight = currentInputs[i].Weight / MaximumWeight;
-
-                if (currentInputs[i].SourceParameterIndex == -1)
-                {
-                    currentInputs[i].SourceParameterIndex = model->GetParameterIndex(currentInputs[i].Source.Id);
-                }
-
-                currentInputs[i].GetNormalizedParameterValue(
-                    &totalTranslation,
-                    &totalAngle,
-                    _parameterCaches[currentInputs[i].SourceParameterIndex],
-                    parameterMinimumValues[currentInputs[i].SourceParameterIndex],
-                    parameterMaximumValues[currentInputs[i].SourceParameterIndex],
-                    parameterDefaultValues[currentInputs[i].SourceParameterIndex],
-                    &currentSetting->NormalizationPosition,
-                    &currentSetting->NormalizationAngle,
-                    currentInputs[i].Reflect,
-                    weight
-                );
-            }
+            continue;
+        }
 
-            radAngle = CubismMath::DegreesToRadian(-totalAngle);
-
-            totalTranslation.X = (totalTranslation.X * CubismMath::CosF(radAngle) - totalTranslation.Y * CubismMath::SinF(radAngle));
-            totalTranslation.Y = (totalTranslation.X * CubismMath::SinF(radAngle) + totalTranslation.Y * CubismMath::CosF(radAngle));
-
-            // Calculate particles position.
-            UpdateParticles(
-                currentParticles,
-                currentSetting->ParticleCount,
-                totalTranslation,
-                totalAngle,
-                _options.Wind,
-                MovementThreshold * currentSetting->NormalizationPosition.Maximum,
-                physicsDeltaTime,
-                AirResistance
-            );
+        Physics::UpdateOutputParameterValue(
+                &_parameterCaches[currentOutputs[i].DestinationCacheIndex],
+                parameterMinimumValues[currentOutputs[i].DestinationParameterIndex],
+                parameterMaximumValues[currentOutputs[i].DestinationParameterIndex],
+                _currentRigOutputs[settingIndex].outputs[i],
+                &currentOutputs[i]);
+    }
+}
 
-            // Update output parameters.
-            for (i = 0; i < currentSetting->OutputCount; ++i)
+void CubismPhysics::EvaluateSubRigStages(csmFloat32 physicsDeltaTime,
+    const csmFloat32* parameterMinimumValues, const csmFloat32* parameterMaximumValues)
+{
+    SubRigJobContext context;
+    context.Physics = this;
+    context.PhysicsDeltaTime = physicsDeltaTime;
+    context.ParameterMinimumValues = parameterMinimumValues;
+    context.ParameterMaximumValues = parameterMaximumValues;
+
+    const csmInt32* stageOffsets = _physicsRig->EvaluationStageOffsets.GetPtr();
+    const csmInt32 stageCount = static_cast<csmInt32>(_physicsRig->EvaluationStageOffsets.GetSize()) - 1;
+
+    // 同じ段のサブリグは互いに読み書きするパラメータが重ならないため、評価順によらず結果は同じになる。
+    // Sub-rigs in the same stage never share a parameter, so the result does not depend on the evaluation order.
+    for (csmInt32 stage = 0; stage < stageCount; ++stage)
+    {
+        const csmInt32 stageSize = stageOffsets[stage + 1] - stageOffsets[stage];
+        context.SettingIndices = _physicsRig->EvaluationOrder.GetPtr() + stageOffsets[stage];
+
+        if (stageSize < 2 || _physicsRig->EvaluationStageParticleCounts[stage] < ParallelEvaluationMinimumParticleCount)
+        {
+            for (csmInt32 i = 0; i < stageSize; ++i)
             {
-                particleIndex = currentOutputs[i].VertexIndex;
-
-                if (currentOutputs[i].DestinationParameterIndex == -1)
-                {
-                    currentOutputs[i].DestinationParameterIndex = model->GetParameterIndex(currentOutputs[i].Destination.Id);
-                }
-
-                if (particleIndex < 1 || particleIndex >= currentSetting->ParticleCount)
-                {
-                    continue;
-                }
-
-                CubismVector2 translation;
-                translation.X = currentParticles[particleIndex].Position.X - currentParticles[particleIndex - 1].Position.X;
-                translation.Y = currentParticles[particleIndex].Position.Y - currentParticles[particleIndex - 1].Position.Y;
-
-                outputValue = currentOutputs[i].GetValue(
-                    translation,
-                    currentParticles,
-                    particleIndex,
-                    currentOutputs[i].Reflect,
-                    _options.Gravity
-                );
-
-                _currentRigOutputs[settingIndex].outputs[i] = outputValue;
-
-                UpdateOutputParameterValue(
-                        &_parameterCaches[currentOutputs[i].DestinationParameterIndex],
-                        parameterMinimumValues[currentOutputs[i].DestinationParameterIndex],
-                        parameterMaximumValues[currentOutputs[i].DestinationParameterIndex],
-                        outputValue,
-                        &currentOutputs[i]);
+                EvaluateSubRigJob(&context, i);
             }
+            continue;
         }
 
-        _currentRemainTime -= physicsDeltaTime;
+        CubismFramework::GetJobSystem()->Dispatch(EvaluateSubRigJob, &context, stageSize);
     }
+}
 
-    const float alpha = _currentRemainTime / physicsDeltaTime;
-    Interpolate(model, alpha);
+void CubismPhysics::EvaluateSubRigJob(void* context, csmInt32 jobIndex)
+{
+    SubRigJobContext* jobContext = static_cast<SubRigJobContext*>(context);
+
+    jobContext->Physics->EvaluateSubRig(
+        jobContext->SettingIndices[jobIndex],
+        jobContext->PhysicsDeltaTime,
+        jobContext->ParameterMinimumValues,
+        jobContext->ParameterMaximumValues
+    );
 }
 
 void CubismPhysics::Interpolate(CubismModel* model, csmFloat32 weight)
 {
     csmInt32 i, settingIndex;
-    CubismPhysicsOutput* currentOutputs;
+    const CubismPhysicsOutput* currentOutputs;
     CubismPhysicsSubRig* currentSetting;
     csmFloat32* parameterValues;
     const csmFloat32* parameterMaximumValues;
     const csmFloat32* parameterMinimumValues;
 
+    // 振り子計算が一度も行われていない場合は適用する結果が存在しない
+    if (!_hasRigOutputs)
+    {
+        return;
+    }
+
     parameterValues = Core::csmGetParameterValues(model->GetModel());
     parameterMaximumValues = Core::csmGetParameterMaximumValues(model->GetModel());
     parameterMinimumValues = Core::csmGetParameterMinimumValues(model->GetModel());
@@ -1037,12 +1267,7 @@ void CubismPhysics::Interpolate(CubismModel* model, csmFloat32 weight)
         // Load input parameters.
         for (i = 0; i < currentSetting->OutputCount; ++i)
         {
-            if (currentOutputs[i].DestinationParameterIndex == -1)
-            {
-                continue;
-            }
-
-            UpdateOutputParameterValue(
+            Physics::UpdateOutputParameterValue(
                 &parameterValues[currentOutputs[i].DestinationParameterIndex],
                 parameterMinimumValues[currentOutputs[i].DestinationParameterIndex],
                 parameterMaximumValues[currentOutputs[i].DestinationParameterIndex],
@@ -1063,4 +1288,181 @@ const CubismPhysics::Options& CubismPhysics::GetOptions() const
     return _options;
 }
 
+void CubismPhysics::SetFixedTimeStep(csmFloat32 timeStepSeconds)
+{
+    _fixedTimeStep = (timeStepSeconds > 0.0f) ? timeStepSeconds : 0.0f;
+}
+
+csmFloat32 CubismPhysics::GetFixedTimeStep() const
+{
+    return _fixedTimeStep;
+}
+
+csmSizeInt CubismPhysics::GetSnapshotSize() const
+{
+    const csmSizeInt cacheCount = (_isParameterCacheInitialized) ? _parameterInputCaches.GetSize() : 0;
+
+    return sizeof(csmUint32) * 5                                        // version, flags and counts
+        + sizeof(csmFloat32)                                            // _currentRemainTime
+        + sizeof(csmFloat32) * 8 * _particleStates.GetSize()            // particle states
+        + sizeof(csmFloat32) * 2 * _physicsRig->Outputs.GetSize()       // current and previous rig outputs
+        + sizeof(csmFloat32) * cacheCount;                              // input caches
+}
+
+csmBool CubismPhysics::SaveSnapshot(csmByte* buffer, csmSizeInt size) const
+{
+    if (buffer == NULL || size < GetSnapshotSize())
+    {
+        return false;
+    }
+
+    // _parameterCachesは振り子演算のたびに入力キャッシュから作り直されるため含めない。
+    // _parameterCaches is rebuilt from the input caches on every step, so it is not saved.
+    const csmUint32 cacheCount = (_isParameterCacheInitialized) ? _parameterInputCaches.GetSize() : 0;
+    csmUint32 flags = 0;
+
+    if (_hasRigOutputs)
+    {
+        flags |= SnapshotFlag_HasRigOutputs;
+    }
+
+    if (_isParameterCacheInitialized)
+    {
+        flags |= SnapshotFlag_IsParameterCacheInitialized;
+    }
+
+    csmByte* cursor = buffer;
+    WriteSnapshotValue(cursor, SnapshotVersion);
+    WriteSnapshotValue(cursor, flags);
+    WriteSnapshotValue(cursor, static_cast<csmUint32>(_particleStates.GetSize()));
+    WriteSnapshotValue(cursor, static_cast<csmUint32>(_physicsRig->Outputs.GetSize()));
+    WriteSnapshotValue(cursor, cacheCount);
+    WriteSnapshotValue(cursor, _currentRemainTime);
+
+    for (csmUint32 i = 0; i < _particleStates.GetSize(); ++i)
+    {
+        const CubismPhysicsParticleState& state = _particleStates[i];
+
+        WriteSnapshotValue(cursor, state.Position.X);
+        WriteSnapshotValue(cursor, state.Position.Y);
+        WriteSnapshotValue(cursor, state.LastPosition.X);
+        WriteSnapshotValue(cursor, state.LastPosition.Y);
+        WriteSnapshotValue(cursor, state.LastGravity.X);
+        WriteSnapshotValue(cursor, state.LastGravity.Y);
+        WriteSnapshotValue(cursor, state.Velocity.X);
+        WriteSnapshotValue(cursor, state.Velocity.Y);
+    }
+
+    for (csmInt32 settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+    {
+        for (csmUint32 i = 0; i < _currentRigOutputs[settingIndex].outputs.GetSize(); ++i)
+        {
+            WriteSnapshotValue(cursor, _currentRigOutputs[settingIndex].outputs[i]);
+            WriteSnapshotValue(cursor, _previousRigOutputs[settingIndex].outputs[i]);
+        }
+    }
+
+    for (csmUint32 i = 0; i < cacheCount; ++i)
+    {
+        WriteSnapshotValue(cursor, _parameterInputCaches[i]);
+    }
+
+    return true;
+}
+
+csmBool CubismPhysics::LoadSnapshot(CubismModel* model, const csmByte* buffer, csmSizeInt size)
+{
+    csmUint32 version, flags, particleCount, outputCount, cacheCount;
+
+    if (model == NULL || buffer == NULL || size < sizeof(csmUint32) * 5)
+    {
+        return false;
+    }
+
+    const csmByte* cursor = buffer;
+    ReadSnapshotValue(cursor, &version);
+    ReadSnapshotValue(cursor, &flags);
+    ReadSnapshotValue(cursor, &particleCount);
+    ReadSnapshotValue(cursor, &outputCount);
+    ReadSnapshotValue(cursor, &cacheCount);
+
+    if (version != SnapshotVersion
+        || particleCount != _physicsRig->Particles.GetSize()
+        || outputCount != _physicsRig->Outputs.GetSize())
+    {
+        return false;
+    }
+
+    // 入力キャッシュはパラメータのインデックスの解決結果に対応するため、評価するモデルで解決してから構成を比べる。
+    // 共有データが別のmocのモデルで解決済みの場合は、Evaluateと同じくこのインスタンス専用の複製に切り替わる
+    const csmBool isParameterCacheInitialized = (flags & SnapshotFlag_IsParameterCacheInitialized) != 0;
+    if (isParameterCacheInitialized)
+    {
+        _physicsRig = AcquireResolvedRig(_physicsRig, model);
+
+        if (cacheCount != _physicsRig->CachedParameterIndices.GetSize())
+        {
+            return false;
+        }
+    }
+
+    const csmSizeInt expectedSize = sizeof(csmUint32) * 5
+        + sizeof(csmFloat32) * (1 + 8 * particleCount + 2 * outputCount + cacheCount);
+    if (size < expectedSize)
+    {
+        return false;
+    }
+
+    ReadSnapshotValue(cursor, &_currentRemainTime);
+
+    for (csmUint32 i = 0; i < particleCount; ++i)
+    {
+        CubismPhysicsParticleState& state = _particleStates[i];
+
+        ReadSnapshotValue(cursor, &state.Position.X);
+        ReadSnapshotValue(cursor, &state.Position.Y);
+        ReadSnapshotValue(cursor, &state.LastPosition.X);
+        ReadSnapshotValue(cursor, &state.LastPosition.Y);
+        ReadSnapshotValue(cursor, &state.LastGravity.X);
+        ReadSnapshotValue(cursor, &state.LastGravity.Y);
+        ReadSnapshotValue(cursor, &state.Velocity.X);
+        ReadSnapshotValue(cursor, &state.Velocity.Y);
+    }
+
+    for (csmInt32 settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+    {
+        for (csmUint32 i = 0; i < _currentRigOutputs[settingIndex].outputs.GetSize(); ++i)
+        {
+            ReadSnapshotValue(cursor, &_currentRigOutputs[settingIndex].outputs[i]);
+            ReadSnapshotValue(cursor, &_previousRigOutputs[settingIndex].outputs[i]);
+        }
+    }
+
+    if (isParameterCacheInitialized)
+    {
+        _parameterCaches.Resize(cacheCount);
+        _parameterInputCaches.Resize(cacheCount);
+
+        for (csmUint32 i = 0; i < cacheCount; ++i)
+        {
+            ReadSnapshotValue(cursor, &_parameterInputCaches[i]);
+        }
+    }
+
+    _isParameterCacheInitialized = isParameterCacheInitialized;
+    _hasRigOutputs = (flags & SnapshotFlag_HasRigOutputs) != 0;
+
+    return true;
+}
+
+void CubismPhysics::SetSerialEvaluationForced(csmBool isForced)
+{
+    _isSerialEvaluationForced = isForced;
+}
+
+csmBool CubismPhysics::IsSerialEvaluationForced() const
+{
+    return _isSerialEvaluationForced;
+}
+
 }}}
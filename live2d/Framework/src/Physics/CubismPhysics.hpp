@@ -13,6 +13,7 @@
 namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismModel;
+class CubismPhysicsBatch;
 struct CubismPhysicsRig;
 
 /**
@@ -22,6 +23,8 @@ struct CubismPhysicsRig;
  */
 class CubismPhysics
 {
+    friend class CubismPhysicsBatch;
+
 public:
     /**
      * @brief オプション
@@ -55,6 +58,19 @@ public:
      */
     static CubismPhysics* Create(const csmByte* buffer, csmSizeInt size);
 
+    /**
+     * @brief 物理演算のデータを共有するインスタンスの作成
+     *
+     * physics3.jsonを再度パースせずに、sourceと物理演算のデータを共有するインスタンスを作成する。
+     * 作成したインスタンスは物理点などの状態だけを持ち、状態は初期化されている。
+     * 共有するインスタンスは同じmocから作成したモデルに適用すること。
+     * また、最初のEvaluateまたはStabilizationは共有するインスタンス間で同時に呼ばないこと。
+     *
+     * @param[in]   source      物理演算のデータを共有するインスタンス
+     * @return  作成されたインスタンス
+     */
+    static CubismPhysics* Create(const CubismPhysics* source);
+
     /**
      * @brief インスタンスの破棄
      *
@@ -105,7 +121,91 @@ public:
      */
     const Options& GetOptions() const;
 
+    /**
+     * @brief 固定時間ステップの設定
+     *
+     * 0より大きい値を設定すると決定論モードになる。Evaluateは渡されたデルタ時間を溜め、
+     * 溜まった時間に収まる回数だけ指定した時間で振り子演算を進め、補間せずに結果を適用する。
+     * 1回のEvaluateで進める回数は8回までで、それを超えて溜まった時間は捨てる。
+     * 振り子演算の刻みがフレームレートによらず一定になるため、同じデルタ時間と入力の列を与えれば同じ結果が得られる。
+     * 0以下を設定すると通常のデルタ時間による評価に戻る。
+     *
+     * @param[in]   timeStepSeconds     振り子演算1回で進める時間[秒]
+     */
+    void SetFixedTimeStep(csmFloat32 timeStepSeconds);
+
+    /**
+     * @brief 固定時間ステップの取得
+     *
+     * @return 振り子演算1回で進める時間[秒]。決定論モードでない場合は0
+     */
+    csmFloat32 GetFixedTimeStep() const;
+
+    /**
+     * @brief スナップショットのサイズの取得
+     *
+     * SaveSnapshotで書き出すバイト数を取得する。
+     *
+     * @return スナップショットのサイズ
+     */
+    csmSizeInt GetSnapshotSize() const;
+
+    /**
+     * @brief スナップショットの保存
+     *
+     * 物理点の状態、物理演算が処理していない時間、入力のキャッシュ、振り子計算の結果をバッファに書き出す。
+     * オプションと固定時間ステップは含まない。
+     *
+     * @param[out]  buffer      書き出し先のバッファ
+     * @param[in]   size        バッファのサイズ
+     * @return  書き出せた場合はtrue。バッファが足りない場合はfalse
+     */
+    csmBool SaveSnapshot(csmByte* buffer, csmSizeInt size) const;
+
+    /**
+     * @brief スナップショットの復元
+     *
+     * SaveSnapshotで書き出した状態を復元する。
+     * 同じphysics3.jsonから作成したインスタンスで保存したスナップショットのみ復元できる。
+     * バイト列は実行環境に依存するため、別の環境で保存したものは復元できない。
+     * 入力のキャッシュを含むスナップショットは、物理演算のデータを復元後に評価するモデルで解決してから受け入れる。
+     *
+     * @param[in]   model       復元後に評価するモデル
+     * @param[in]   buffer      スナップショットが書き出されたバッファ
+     * @param[in]   size        バッファのサイズ
+     * @return  復元できた場合はtrue。形式が一致しない場合はfalseを返し、状態は変更しない
+     */
+    csmBool LoadSnapshot(CubismModel* model, const csmByte* buffer, csmSizeInt size);
+
+    /**
+     * @brief 直列評価の強制の設定
+     *
+     * CubismFrameworkにジョブシステムが設定されている場合でも、サブリグを元の順番で直列に評価する。デバッグ用。
+     *
+     * @param[in]   isForced    trueなら直列に評価する
+     */
+    void SetSerialEvaluationForced(csmBool isForced);
+
+    /**
+     * @brief 直列評価の強制の取得
+     *
+     * @return trueなら直列に評価する
+     */
+    csmBool IsSerialEvaluationForced() const;
+
 private:
+    /**
+     * @brief サブリグの並列評価に渡すコンテキスト
+     */
+    struct SubRigJobContext
+    {
+        CubismPhysics* Physics;                         ///< 評価するインスタンス
+        const csmInt32* SettingIndices;                 ///< 評価する段のサブリグのインデックスのリスト
+        csmFloat32 PhysicsDeltaTime;                    ///< 物理演算のデルタ時間
+        const csmFloat32* ParameterMinimumValues;       ///< パラメータの最小値のリスト
+        const csmFloat32* ParameterMaximumValues;       ///< パラメータの最大値のリスト
+    };
+
     /**
      * @brief コンストラクタ
      *
@@ -134,6 +234,76 @@ private:
      */
     void Parse(const csmByte* physicsJson, csmSizeInt size);
 
+    /**
+     * @brief サブリグのコンパイル
+     *
+     * 入力と出力を種類ごとに分類し、評価に必要な値を事前に計算する。
+     *
+     * @param[in]   settingIndex    コンパイルするサブリグのインデックス
+     */
+    void Compile(csmInt32 settingIndex);
+
+    /**
+     * @brief 物理演算のデータのパラメータのインデックスの解決
+     *
+     * 入力と出力のパラメータのインデックスを解決し、パラメータの範囲に依存する値を計算する。
+     * また、物理演算が入出力するパラメータの一覧とサブリグの評価の段を構築する。
+     *
+     * @param[in]   rig         解決する物理演算のデータ
+     * @param[in]   model       物理演算の結果を適用するモデル
+     */
+    static void ResolveRigParameterIndices(CubismPhysicsRig* rig, CubismModel* model);
+
+    /**
+     * @brief 物理演算のデータがモデルに対して解決済みかの確認
+     *
+     * 解決済みの入力と出力のパラメータのインデックスと入力元のパラメータの範囲が、モデルのものと一致するかを確認する。
+     *
+     * @param[in]   rig         確認する解決済みの物理演算のデータ
+     * @param[in]   model       物理演算の結果を適用するモデル
+     * @return  true    ->  モデルに対して解決済み
+     *          false   ->  パラメータの構成が異なるモデルで解決されている
+     */
+    static csmBool IsRigResolvedFor(const CubismPhysicsRig* rig, CubismModel* model);
+
+    /**
+     * @brief モデルに対して解決済みの物理演算のデータの取得
+     *
+     * 物理演算のデータが未解決であれば、ロックを取ってモデルで一度だけ解決する。
+     * 他のモデルで解決済みでパラメータの構成が異なる場合は、参照を手放して呼び出し元専用の複製を解決して返す。
+     *
+     * @param[in]   rig         共有している物理演算のデータ
+     * @param[in]   model       物理演算の結果を適用するモデル
+     * @return  モデルに対して解決済みの物理演算のデータ
+     */
+    static CubismPhysicsRig* AcquireResolvedRig(CubismPhysicsRig* rig, CubismModel* model);
+
+    /**
+     * @brief 物理演算のデータの参照の解放
+     *
+     * 参照カウントを減らし、最後の参照であれば破棄する。
+     *
+     * @param[in]   rig         参照を手放す物理演算のデータ
+     */
+    static void ReleaseRig(CubismPhysicsRig* rig);
+
+    /**
+     * @brief パラメータのインデックスの解決
+     *
+     * モデルに対して解決済みの物理演算のデータを取得し、
+     * 物理演算が入出力するパラメータだけを保持するようにキャッシュを構築する。
+     *
+     * @param[in]   model       物理演算の結果を適用するモデル
+     */
+    void ResolveParameterIndices(CubismModel* model);
+
+    /**
+     * @brief 状態の確保
+     *
+     * 物理演算のデータに合わせてインスタンスごとの状態を確保し、初期化する。
+     */
+    void InitializeState();
+
     /**
      * @brief 初期化
      *
@@ -151,16 +321,69 @@ private:
      */
     void Interpolate(CubismModel* model, csmFloat32 weight);
 
-    CubismPhysicsRig* _physicsRig; ///< 物理演算のデータ
+    /**
+     * @brief 振り子演算を一回進める
+     *
+     * 入力のキャッシュとパラメータを線形補間した値を入力として、全サブリグの振り子演算を一回進める。
+     *
+     * @param[in]   parameterValues         パラメータの値のリスト
+     * @param[in]   parameterMinimumValues  パラメータの最小値のリスト
+     * @param[in]   parameterMaximumValues  パラメータの最大値のリスト
+     * @param[in]   inputWeight             パラメータの値の重み
+     * @param[in]   physicsDeltaTime        物理演算のデルタ時間
+     */
+    void StepRig(const csmFloat32* parameterValues, const csmFloat32* parameterMinimumValues,
+        const csmFloat32* parameterMaximumValues, csmFloat32 inputWeight, csmFloat32 physicsDeltaTime);
+
+    /**
+     * @brief サブリグの評価
+     *
+     * 振り子演算を一回分進め、結果をパラメータのキャッシュに適用する。
+     *
+     * @param[in]   settingIndex            評価するサブリグのインデックス
+     * @param[in]   physicsDeltaTime        物理演算のデルタ時間
+     * @param[in]   parameterMinimumValues  パラメータの最小値のリスト
+     * @param[in]   parameterMaximumValues  パラメータの最大値のリスト
+     */
+    void EvaluateSubRig(csmInt32 settingIndex, csmFloat32 physicsDeltaTime,
+        const csmFloat32* parameterMinimumValues, const csmFloat32* parameterMaximumValues);
+
+    /**
+     * @brief サブリグの段ごとの評価
+     *
+     * 依存関係のないサブリグをまとめた段ごとに、ジョブシステムで並列に評価する。
+     *
+     * @param[in]   physicsDeltaTime        物理演算のデルタ時間
+     * @param[in]   parameterMinimumValues  パラメータの最小値のリスト
+     * @param[in]   parameterMaximumValues  パラメータの最大値のリスト
+     */
+    void EvaluateSubRigStages(csmFloat32 physicsDeltaTime,
+        const csmFloat32* parameterMinimumValues, const csmFloat32* parameterMaximumValues);
+
+    /**
+     * @brief サブリグの評価のジョブ
+     *
+     * @param[in]   context     SubRigJobContext
+     * @param[in]   jobIndex    段内のサブリグのインデックス
+     */
+    static void EvaluateSubRigJob(void* context, csmInt32 jobIndex);
+
+    CubismPhysicsRig* _physicsRig; ///< 物理演算のデータ(インスタンス間で共有)
     Options _options; ///< オプション
 
+    csmVector<CubismPhysicsParticleState> _particleStates; ///< 物理点の状態
+
     csmVector<PhysicsOutput> _currentRigOutputs; ///< 最新の振り子計算の結果
     csmVector<PhysicsOutput> _previousRigOutputs; ///< 一つ前の振り子計算の結果
 
     csmFloat32 _currentRemainTime; ///< 物理演算が処理していない時間
+    csmFloat32 _fixedTimeStep; ///< 決定論モードの振り子演算1回で進める時間。0以下なら無効
 
     csmVector<csmFloat32> _parameterCaches;      ///< Evaluateで利用するパラメータのキャッシュ
     csmVector<csmFloat32> _parameterInputCaches; ///< UpdateParticlesが動くときの入力をキャッシュ
+    csmBool _isParameterCacheInitialized;        ///< パラメータのキャッシュを構築済みか
+    csmBool _hasRigOutputs;                      ///< 振り子計算の結果が存在するか
+    csmBool _isSerialEvaluationForced;           ///< サブリグを直列に評価するか
 
     csmBool _isJsonValid; ///< 正しくJsonデータが取得出来たか
 };
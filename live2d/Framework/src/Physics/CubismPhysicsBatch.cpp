@@ -0,0 +1,1046 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismPhysicsBatch.hpp"
+#include "CubismPhysicsKernel.hpp"
+#include "CubismFramework.hpp"
+#include "Model/CubismModel.hpp"
+#include "Math/CubismMath.hpp"
+#include <math.h>
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CSM_PHYSICS_BATCH_NEON
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define CSM_PHYSICS_BATCH_SSE
+#endif
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+
+/*
+ * 1つのブロックの4インスタンスを1レジスタの4レーンに載せて計算する。
+ * 各レーンの演算はPhysics::の関数と同じ順序の単精度の四則演算で行い、三角関数とpowfだけをレーンごとに呼び出す。
+ * 除算がIEEE準拠のAArch64に限ってNEONを使用し、それ以外のARMは汎用の実装で計算する。
+ */
+#if defined(CSM_PHYSICS_BATCH_NEON)
+typedef float32x4_t LaneVec;
+typedef uint32x4_t LaneMask;
+
+inline LaneVec LaneLoad(const csmFloat32* values) { return vld1q_f32(values); }
+inline void LaneStore(csmFloat32* out, LaneVec a) { vst1q_f32(out, a); }
+inline LaneVec LaneSplat(csmFloat32 value) { return vdupq_n_f32(value); }
+inline LaneVec LaneAdd(LaneVec a, LaneVec b) { return vaddq_f32(a, b); }
+inline LaneVec LaneSub(LaneVec a, LaneVec b) { return vsubq_f32(a, b); }
+inline LaneVec LaneMul(LaneVec a, LaneVec b) { return vmulq_f32(a, b); }
+inline LaneVec LaneDiv(LaneVec a, LaneVec b) { return vdivq_f32(a, b); }
+inline LaneVec LaneAbs(LaneVec a) { return vabsq_f32(a); }
+inline LaneMask LaneLess(LaneVec a, LaneVec b) { return vcltq_f32(a, b); }
+inline LaneMask LaneGreater(LaneVec a, LaneVec b) { return vcgtq_f32(a, b); }
+inline LaneVec LaneSelect(LaneMask mask, LaneVec a, LaneVec b) { return vbslq_f32(mask, a, b); }
+#elif defined(CSM_PHYSICS_BATCH_SSE)
+typedef __m128 LaneVec;
+typedef __m128 LaneMask;
+
+inline LaneVec LaneLoad(const csmFloat32* values) { return _mm_loadu_ps(values); }
+inline void LaneStore(csmFloat32* out, LaneVec a) { _mm_storeu_ps(out, a); }
+inline LaneVec LaneSplat(csmFloat32 value) { return _mm_set1_ps(value); }
+inline LaneVec LaneAdd(LaneVec a, LaneVec b) { return _mm_add_ps(a, b); }
+inline LaneVec LaneSub(LaneVec a, LaneVec b) { return _mm_sub_ps(a, b); }
+inline LaneVec LaneMul(LaneVec a, LaneVec b) { return _mm_mul_ps(a, b); }
+inline LaneVec LaneDiv(LaneVec a, LaneVec b) { return _mm_div_ps(a, b); }
+inline LaneVec LaneAbs(LaneVec a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline LaneMask LaneLess(LaneVec a, LaneVec b) { return _mm_cmplt_ps(a, b); }
+inline LaneMask LaneGreater(LaneVec a, LaneVec b) { return _mm_cmpgt_ps(a, b); }
+inline LaneVec LaneSelect(LaneMask mask, LaneVec a, LaneVec b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+#else
+struct LaneVec
+{
+    csmFloat32 V[CubismPhysicsLaneCount];
+};
+
+struct LaneMask
+{
+    csmBool V[CubismPhysicsLaneCount];
+};
+
+inline LaneVec LaneLoad(const csmFloat32* values)
+{
+    LaneVec result;
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        result.V[lane] = values[lane];
+    }
+    return result;
+}
+
+inline void LaneStore(csmFloat32* out, LaneVec a)
+{
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        out[lane] = a.V[lane];
+    }
+}
+
+inline LaneVec LaneSplat(csmFloat32 value)
+{
+    LaneVec result;
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        result.V[lane] = value;
+    }
+    return result;
+}
+
+inline LaneVec LaneAdd(LaneVec a, LaneVec b) { for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane) { a.V[lane] = a.V[lane] + b.V[lane]; } return a; }
+inline LaneVec LaneSub(LaneVec a, LaneVec b) { for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane) { a.V[lane] = a.V[lane] - b.V[lane]; } return a; }
+inline LaneVec LaneMul(LaneVec a, LaneVec b) { for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane) { a.V[lane] = a.V[lane] * b.V[lane]; } return a; }
+inline LaneVec LaneDiv(LaneVec a, LaneVec b) { for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane) { a.V[lane] = a.V[lane] / b.V[lane]; } return a; }
+inline LaneVec LaneAbs(LaneVec a) { for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane) { a.V[lane] = CubismMath::AbsF(a.V[lane]); } return a; }
+
+inline LaneMask LaneLess(LaneVec a, LaneVec b)
+{
+    LaneMask result;
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        result.V[lane] = a.V[lane] < b.V[lane];
+    }
+    return result;
+}
+
+inline LaneMask LaneGreater(LaneVec a, LaneVec b)
+{
+    LaneMask result;
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        result.V[lane] = a.V[lane] > b.V[lane];
+    }
+    return result;
+}
+
+inline LaneVec LaneSelect(LaneMask mask, LaneVec a, LaneVec b)
+{
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        b.V[lane] = mask.V[lane] ? a.V[lane] : b.V[lane];
+    }
+    return b;
+}
+#endif
+
+/// Gathers a parameter value of every lane.
+///
+/// @param  parameterValues  Parameter values of every lane. NULL for lanes without an instance.
+/// @param  parameterIndex   Index of the parameter.
+/// @return Values of the lanes. 0 for lanes without an instance.
+LaneVec GatherParameterLanes(csmFloat32* const* parameterValues, csmInt32 parameterIndex)
+{
+    csmFloat32 values[CubismPhysicsLaneCount];
+
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        values[lane] = (parameterValues[lane] != NULL) ? parameterValues[lane][parameterIndex] : 0.0f;
+    }
+
+    return LaneLoad(values);
+}
+
+/// Scatters a parameter value of every lane to the lanes with an instance.
+///
+/// @param  parameterValues  Parameter values of every lane. NULL for lanes without an instance.
+/// @param  parameterIndex   Index of the parameter.
+/// @param  lanes            Values of the lanes.
+void ScatterParameterLanes(csmFloat32* const* parameterValues, csmInt32 parameterIndex, LaneVec lanes)
+{
+    csmFloat32 values[CubismPhysicsLaneCount];
+
+    LaneStore(values, lanes);
+
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        if (parameterValues[lane] != NULL)
+        {
+            parameterValues[lane][parameterIndex] = values[lane];
+        }
+    }
+}
+
+/// Normalizes the vector of every lane as CubismVector2::Normalize does.
+///
+/// The length is taken with powf for every lane, so that the results match the single instance bit for bit.
+///
+/// @param  x  X of the vector for every lane.
+/// @param  y  Y of the vector for every lane.
+void NormalizeLanes(LaneVec* x, LaneVec* y)
+{
+    csmFloat32 length[CubismPhysicsLaneCount];
+
+    LaneStore(length, LaneAdd(LaneMul(*x, *x), LaneMul(*y, *y)));
+
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        length[lane] = powf(length[lane], 0.5f);
+    }
+
+    const LaneVec lengthLanes = LaneLoad(length);
+    *x = LaneDiv(*x, lengthLanes);
+    *y = LaneDiv(*y, lengthLanes);
+}
+
+/// Sums the normalized values of inputs of the same type for every lane.
+///
+/// Same as Physics::GetWeightedNormalizedInput, with the branches on the value replaced by selects.
+///
+/// @param  inputs           Compiled inputs of the same type.
+/// @param  inputCount       Count of inputs.
+/// @param  parameterCaches  Cached parameter values of the block.
+/// @return Weighted sum of normalized values for every lane.
+LaneVec SumNormalizedInputLanes(const CubismPhysicsCompiledInput* inputs, csmInt32 inputCount,
+    const CubismPhysicsLaneValues* parameterCaches)
+{
+    const LaneVec zero = LaneSplat(0.0f);
+    LaneVec total = zero;
+
+    for (csmInt32 i = 0; i < inputCount; ++i)
+    {
+        const CubismPhysicsCompiledInput& input = inputs[i];
+        const LaneVec parameterMaximum = LaneSplat(input.ParameterMaximum);
+        const LaneVec parameterMinimum = LaneSplat(input.ParameterMinimum);
+        const LaneVec normalizedMiddle = LaneSplat(input.NormalizedMiddle);
+
+        LaneVec value = LaneLoad(parameterCaches[input.SourceCacheIndex].Values);
+        value = LaneSelect(LaneLess(parameterMaximum, value), parameterMaximum, value);
+        value = LaneSelect(LaneGreater(parameterMinimum, value), parameterMinimum, value);
+
+        const LaneVec paramValue = LaneSub(value, LaneSplat(input.ParameterMiddle));
+
+        // 範囲の有無は入力ごとに決まるため、範囲が存在しない側は全レーンで0になる
+        const LaneVec positive = input.HasPositiveRange
+            ? LaneAdd(LaneMul(paramValue, LaneSplat(input.PositiveScale)), normalizedMiddle)
+            : zero;
+        const LaneVec negative = input.HasNegativeRange
+            ? LaneAdd(LaneMul(paramValue, LaneSplat(input.NegativeScale)), normalizedMiddle)
+            : zero;
+
+        const LaneVec result = LaneSelect(
+            LaneGreater(paramValue, zero),
+            positive,
+            LaneSelect(LaneLess(paramValue, zero), negative, normalizedMiddle)
+        );
+
+        total = LaneAdd(total, LaneMul(result, LaneSplat(input.Weight)));
+    }
+
+    return total;
+}
+
+/// Loads input parameters of the sub-rig for every lane and rotates the translation by the angle.
+///
+/// @param  rig               Target rig.
+/// @param  setting           Target sub-rig.
+/// @param  parameterCaches   Cached parameter values of the block.
+/// @param  translationX      X of total translation for every lane.
+/// @param  translationY      Y of total translation for every lane.
+/// @param  totalAngle        Total angle for every lane.
+void LoadInputLanes(CubismPhysicsRig* rig, const CubismPhysicsSubRig* setting, const CubismPhysicsLaneValues* parameterCaches,
+    csmFloat32* translationX, csmFloat32* translationY, csmFloat32* totalAngle)
+{
+    csmFloat32 cosAngle[CubismPhysicsLaneCount];
+    csmFloat32 sinAngle[CubismPhysicsLaneCount];
+
+    const LaneVec x = SumNormalizedInputLanes(
+        rig->CompiledInputs[CubismPhysicsSource_X].GetPtr() + setting->BaseCompiledInputIndex[CubismPhysicsSource_X],
+        setting->CompiledInputCount[CubismPhysicsSource_X],
+        parameterCaches
+    );
+    const LaneVec y = SumNormalizedInputLanes(
+        rig->CompiledInputs[CubismPhysicsSource_Y].GetPtr() + setting->BaseCompiledInputIndex[CubismPhysicsSource_Y],
+        setting->CompiledInputCount[CubismPhysicsSource_Y],
+        parameterCaches
+    );
+    LaneStore(totalAngle, SumNormalizedInputLanes(
+        rig->CompiledInputs[CubismPhysicsSource_Angle].GetPtr() + setting->BaseCompiledInputIndex[CubismPhysicsSource_Angle],
+        setting->CompiledInputCount[CubismPhysicsSource_Angle],
+        parameterCaches
+    ));
+
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        const csmFloat32 radAngle = CubismMath::DegreesToRadian(-totalAngle[lane]);
+
+        cosAngle[lane] = CubismMath::CosF(radAngle);
+        sinAngle[lane] = CubismMath::SinF(radAngle);
+    }
+
+    // Physics::RotateTranslationと同じく、Yの計算には回転後のXを使う
+    const LaneVec cosLanes = LaneLoad(cosAngle);
+    const LaneVec sinLanes = LaneLoad(sinAngle);
+    const LaneVec rotatedX = LaneSub(LaneMul(x, cosLanes), LaneMul(y, sinLanes));
+
+    LaneStore(translationX, rotatedX);
+    LaneStore(translationY, LaneAdd(LaneMul(rotatedX, sinLanes), LaneMul(y, cosLanes)));
+}
+
+/// Gets the normalized gravity direction of every lane from the total angle.
+///
+/// @param  totalAngle  Total angle for every lane.
+/// @param  gravityX    X of gravity direction for every lane.
+/// @param  gravityY    Y of gravity direction for every lane.
+void GetGravityLanes(const csmFloat32* totalAngle, csmFloat32* gravityX, csmFloat32* gravityY)
+{
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        const CubismVector2 currentGravity = Physics::GetGravityDirection(totalAngle[lane]);
+
+        gravityX[lane] = currentGravity.X;
+        gravityY[lane] = currentGravity.Y;
+    }
+}
+
+/// Updates particles of every lane.
+///
+/// Same as Physics::UpdateParticle. Only the rotation of each particle is computed lane by lane,
+/// the rest of the steps run on all lanes at once.
+///
+/// @param  strand            Target array of particle.
+/// @param  lanes             States of the particles.
+/// @param  strandCount       Count of particle.
+/// @param  translationX      X of total translation for every lane.
+/// @param  translationY      Y of total translation for every lane.
+/// @param  totalAngle        Total angle for every lane.
+/// @param  windDirection     Direction of wind.
+/// @param  thresholdValue    Threshold of movement.
+/// @param  deltaTimeSeconds  Delta time.
+/// @param  airResistance     Air resistance.
+void UpdateParticleLanes(const CubismPhysicsParticle* strand, CubismPhysicsParticleLanes* lanes, csmInt32 strandCount,
+    const csmFloat32* translationX, const csmFloat32* translationY, const csmFloat32* totalAngle,
+    CubismVector2 windDirection, csmFloat32 thresholdValue, csmFloat32 deltaTimeSeconds, csmFloat32 airResistance)
+{
+    csmFloat32 gravityX[CubismPhysicsLaneCount];
+    csmFloat32 gravityY[CubismPhysicsLaneCount];
+    csmFloat32 cosRadian[CubismPhysicsLaneCount];
+    csmFloat32 sinRadian[CubismPhysicsLaneCount];
+
+    LaneStore(lanes[0].PositionX, LaneLoad(translationX));
+    LaneStore(lanes[0].PositionY, LaneLoad(translationY));
+
+    GetGravityLanes(totalAngle, gravityX, gravityY);
+
+    const LaneVec zero = LaneSplat(0.0f);
+    const LaneVec threshold = LaneSplat(thresholdValue);
+    const LaneVec windX = LaneSplat(windDirection.X);
+    const LaneVec windY = LaneSplat(windDirection.Y);
+    const LaneVec currentGravityX = LaneLoad(gravityX);
+    const LaneVec currentGravityY = LaneLoad(gravityY);
+
+    for (csmInt32 i = 1; i < strandCount; ++i)
+    {
+        const CubismPhysicsParticle& particle = strand[i];
+        const CubismPhysicsParticleLanes& previous = lanes[i - 1];
+        CubismPhysicsParticleLanes& current = lanes[i];
+
+        const csmFloat32 delay = particle.Delay * deltaTimeSeconds * 30.0f;
+
+        for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+        {
+            const csmFloat32 radian = Physics::GetParticleRotation(
+                CubismVector2(current.LastGravityX[lane], current.LastGravityY[lane]),
+                CubismVector2(gravityX[lane], gravityY[lane]),
+                airResistance
+            );
+
+            cosRadian[lane] = CubismMath::CosF(radian);
+            sinRadian[lane] = CubismMath::SinF(radian);
+        }
+
+        const LaneVec delayLanes = LaneSplat(delay);
+        const LaneVec acceleration = LaneSplat(particle.Acceleration);
+        const LaneVec radius = LaneSplat(particle.Radius);
+        const LaneVec cosLanes = LaneLoad(cosRadian);
+        const LaneVec sinLanes = LaneLoad(sinRadian);
+        const LaneVec parentX = LaneLoad(previous.PositionX);
+        const LaneVec parentY = LaneLoad(previous.PositionY);
+        const LaneVec lastPositionX = LaneLoad(current.PositionX);
+        const LaneVec lastPositionY = LaneLoad(current.PositionY);
+
+        LaneStore(current.LastPositionX, lastPositionX);
+        LaneStore(current.LastPositionY, lastPositionY);
+
+        // Physics::GetParticleMoveDirection
+        const LaneVec forceX = LaneAdd(LaneMul(currentGravityX, acceleration), windX);
+        const LaneVec forceY = LaneAdd(LaneMul(currentGravityY, acceleration), windY);
+
+        LaneVec x = LaneSub(lastPositionX, parentX);
+        LaneVec y = LaneSub(lastPositionY, parentY);
+
+        x = LaneSub(LaneMul(cosLanes, x), LaneMul(y, sinLanes));
+        y = LaneAdd(LaneMul(sinLanes, x), LaneMul(y, cosLanes));
+
+        x = LaneAdd(parentX, x);
+        y = LaneAdd(parentY, y);
+
+        x = LaneAdd(LaneAdd(x, LaneMul(LaneLoad(current.VelocityX), delayLanes)), LaneMul(LaneMul(forceX, delayLanes), delayLanes));
+        y = LaneAdd(LaneAdd(y, LaneMul(LaneLoad(current.VelocityY), delayLanes)), LaneMul(LaneMul(forceY, delayLanes), delayLanes));
+
+        LaneVec directionX = LaneSub(x, parentX);
+        LaneVec directionY = LaneSub(y, parentY);
+
+        NormalizeLanes(&directionX, &directionY);
+
+        // Physics::SettleParticle
+        LaneVec positionX = LaneAdd(parentX, LaneMul(directionX, radius));
+        const LaneVec positionY = LaneAdd(parentY, LaneMul(directionY, radius));
+
+        positionX = LaneSelect(LaneLess(LaneAbs(positionX), threshold), zero, positionX);
+
+        LaneStore(current.PositionX, positionX);
+        LaneStore(current.PositionY, positionY);
+
+        if (delay != 0.0f)
+        {
+            const LaneVec mobility = LaneSplat(particle.Mobility);
+
+            LaneStore(current.VelocityX, LaneMul(LaneDiv(LaneSub(positionX, lastPositionX), delayLanes), mobility));
+            LaneStore(current.VelocityY, LaneMul(LaneDiv(LaneSub(positionY, lastPositionY), delayLanes), mobility));
+        }
+
+        LaneStore(current.LastGravityX, currentGravityX);
+        LaneStore(current.LastGravityY, currentGravityY);
+    }
+}
+
+/// Updates particles of every lane for stabilization.
+///
+/// Same as Physics::StabilizeParticle.
+///
+/// @param  strand            Target array of particle.
+/// @param  lanes             States of the particles.
+/// @param  strandCount       Count of particle.
+/// @param  translationX      X of total translation for every lane.
+/// @param  translationY      Y of total translation for every lane.
+/// @param  totalAngle        Total angle for every lane.
+/// @param  windDirection     Direction of wind.
+/// @param  thresholdValue    Threshold of movement.
+void UpdateParticleLanesForStabilization(const CubismPhysicsParticle* strand, CubismPhysicsParticleLanes* lanes, csmInt32 strandCount,
+    const csmFloat32* translationX, const csmFloat32* translationY, const csmFloat32* totalAngle,
+    CubismVector2 windDirection, csmFloat32 thresholdValue)
+{
+    csmFloat32 gravityX[CubismPhysicsLaneCount];
+    csmFloat32 gravityY[CubismPhysicsLaneCount];
+
+    LaneStore(lanes[0].PositionX, LaneLoad(translationX));
+    LaneStore(lanes[0].PositionY, LaneLoad(translationY));
+
+    GetGravityLanes(totalAngle, gravityX, gravityY);
+
+    const LaneVec zero = LaneSplat(0.0f);
+    const LaneVec threshold = LaneSplat(thresholdValue);
+    const LaneVec windX = LaneSplat(windDirection.X);
+    const LaneVec windY = LaneSplat(windDirection.Y);
+    const LaneVec currentGravityX = LaneLoad(gravityX);
+    const LaneVec currentGravityY = LaneLoad(gravityY);
+
+    for (csmInt32 i = 1; i < strandCount; ++i)
+    {
+        const CubismPhysicsParticle& particle = strand[i];
+        const CubismPhysicsParticleLanes& previous = lanes[i - 1];
+        CubismPhysicsParticleLanes& current = lanes[i];
+
+        const LaneVec acceleration = LaneSplat(particle.Acceleration);
+        const LaneVec radius = LaneSplat(particle.Radius);
+
+        LaneVec forceX = LaneAdd(LaneMul(currentGravityX, acceleration), windX);
+        LaneVec forceY = LaneAdd(LaneMul(currentGravityY, acceleration), windY);
+
+        LaneStore(current.LastPositionX, LaneLoad(current.PositionX));
+        LaneStore(current.LastPositionY, LaneLoad(current.PositionY));
+        LaneStore(current.VelocityX, zero);
+        LaneStore(current.VelocityY, zero);
+
+        NormalizeLanes(&forceX, &forceY);
+
+        LaneVec positionX = LaneAdd(LaneLoad(previous.PositionX), LaneMul(forceX, radius));
+        const LaneVec positionY = LaneAdd(LaneLoad(previous.PositionY), LaneMul(forceY, radius));
+
+        positionX = LaneSelect(LaneLess(LaneAbs(positionX), threshold), zero, positionX);
+
+        LaneStore(current.PositionX, positionX);
+        LaneStore(current.PositionY, positionY);
+        LaneStore(current.LastGravityX, currentGravityX);
+        LaneStore(current.LastGravityY, currentGravityY);
+    }
+}
+
+/// Evaluates outputs of the same type for every lane.
+///
+/// @param  outputs        Compiled outputs of the same type.
+/// @param  outputCount    Count of outputs.
+/// @param  particles      Particle states of the sub-rig.
+/// @param  parentGravity  Gravity.
+/// @param  rigOutputs     Output values of the sub-rig indexed by output index.
+template <CubismPhysicsSource Type>
+void EvaluateOutputLanes(const CubismPhysicsCompiledOutput* outputs, csmInt32 outputCount, const CubismPhysicsParticleLanes* particles,
+    CubismVector2 parentGravity, CubismPhysicsLaneValues* rigOutputs)
+{
+    for (csmInt32 i = 0; i < outputCount; ++i)
+    {
+        const CubismPhysicsCompiledOutput& output = outputs[i];
+        const csmInt32 particleIndex = output.VertexIndex;
+        const CubismPhysicsParticleLanes& current = particles[particleIndex];
+        const CubismPhysicsParticleLanes& previous = particles[particleIndex - 1];
+
+        if (Type != CubismPhysicsSource_Angle)
+        {
+            // 移動量の出力はPhysics::GetOutputValueが成分をそのまま返すため、全レーンをまとめて計算する
+            const LaneVec translation = (Type == CubismPhysicsSource_X)
+                ? LaneSub(LaneLoad(current.PositionX), LaneLoad(previous.PositionX))
+                : LaneSub(LaneLoad(current.PositionY), LaneLoad(previous.PositionY));
+
+            LaneStore(rigOutputs[output.OutputIndex].Values, LaneMul(translation, LaneSplat(output.ReflectSign)));
+            continue;
+        }
+
+        for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+        {
+            CubismVector2 translation;
+            translation.X = current.PositionX[lane] - previous.PositionX[lane];
+            translation.Y = current.PositionY[lane] - previous.PositionY[lane];
+
+            // 角度の出力は1つ前の物理点の向きを基準にする。根元の物理点では重力の逆向きを使う
+            const CubismVector2 parentDirection = (particleIndex >= 2)
+                ? CubismVector2(previous.PositionX[lane] - particles[particleIndex - 2].PositionX[lane],
+                                previous.PositionY[lane] - particles[particleIndex - 2].PositionY[lane])
+                : CubismVector2(parentGravity.X * -1.0f, parentGravity.Y * -1.0f);
+
+            rigOutputs[output.OutputIndex].Values[lane] =
+                Physics::GetOutputValue<Type>(translation, parentDirection) * output.ReflectSign;
+        }
+    }
+}
+
+/// Evaluates outputs of the sub-rig for every lane.
+///
+/// @param  rig            Target rig.
+/// @param  setting        Target sub-rig.
+/// @param  particles      Particle states of the sub-rig.
+/// @param  parentGravity  Gravity.
+/// @param  rigOutputs     Output values of the sub-rig indexed by output index.
+void EvaluateSubRigOutputLanes(CubismPhysicsRig* rig, const CubismPhysicsSubRig* setting, const CubismPhysicsParticleLanes* particles,
+    CubismVector2 parentGravity, CubismPhysicsLaneValues* rigOutputs)
+{
+    EvaluateOutputLanes<CubismPhysicsSource_X>(
+        rig->CompiledOutputs[CubismPhysicsSource_X].GetPtr() + setting->BaseCompiledOutputIndex[CubismPhysicsSource_X],
+        setting->CompiledOutputCount[CubismPhysicsSource_X],
+        particles, parentGravity, rigOutputs
+    );
+    EvaluateOutputLanes<CubismPhysicsSource_Y>(
+        rig->CompiledOutputs[CubismPhysicsSource_Y].GetPtr() + setting->BaseCompiledOutputIndex[CubismPhysicsSource_Y],
+        setting->CompiledOutputCount[CubismPhysicsSource_Y],
+        particles, parentGravity, rigOutputs
+    );
+    EvaluateOutputLanes<CubismPhysicsSource_Angle>(
+        rig->CompiledOutputs[CubismPhysicsSource_Angle].GetPtr() + setting->BaseCompiledOutputIndex[CubismPhysicsSource_Angle],
+        setting->CompiledOutputCount[CubismPhysicsSource_Angle],
+        particles, parentGravity, rigOutputs
+    );
+}
+
+/// Applies output values to parameter values of every lane.
+///
+/// Same as Physics::UpdateOutputParameterValue, with the clamp replaced by selects.
+///
+/// @param  parameterValue         Parameter values for every lane.
+/// @param  parameterValueMinimum  Minimum of the parameter.
+/// @param  parameterValueMaximum  Maximum of the parameter.
+/// @param  translation            Output values for every lane.
+/// @param  output                 Output.
+/// @return Updated parameter values for every lane.
+LaneVec UpdateOutputParameterLanes(LaneVec parameterValue, csmFloat32 parameterValueMinimum, csmFloat32 parameterValueMaximum,
+    LaneVec translation, const CubismPhysicsOutput* output)
+{
+    const LaneVec minimum = LaneSplat(parameterValueMinimum);
+    const LaneVec maximum = LaneSplat(parameterValueMaximum);
+
+    LaneVec value = LaneMul(translation, LaneSplat(output->Scale));
+    value = LaneSelect(LaneLess(value, minimum), minimum, LaneSelect(LaneGreater(value, maximum), maximum, value));
+
+    const csmFloat32 weight = (output->Weight / Physics::MaximumWeight);
+
+    if (weight >= 1.0f)
+    {
+        return value;
+    }
+
+    return LaneAdd(LaneMul(parameterValue, LaneSplat(1.0f - weight)), LaneMul(value, LaneSplat(weight)));
+}
+
+}
+
+CubismPhysicsBatch::CubismPhysicsBatch()
+    : _physicsRig(NULL)
+    , _instanceCount(0)
+    , _blockCount(0)
+    , _currentRemainTime(0.0f)
+    , _isParameterCacheInitialized(false)
+    , _hasRigOutputs(false)
+{
+    // set default options.
+    _options.Gravity.Y = -1.0f;
+    _options.Gravity.X = 0.0f;
+    _options.Wind.X = 0.0f;
+    _options.Wind.Y = 0.0f;
+}
+
+CubismPhysicsBatch::~CubismPhysicsBatch()
+{
+    if (_physicsRig != NULL)
+    {
+        CubismPhysics::ReleaseRig(_physicsRig);
+    }
+}
+
+CubismPhysicsBatch* CubismPhysicsBatch::Create(const CubismPhysics* source, csmInt32 instanceCount)
+{
+    if (source == NULL || instanceCount <= 0)
+    {
+        return NULL;
+    }
+
+    CubismPhysicsBatch* ret = CSM_NEW CubismPhysicsBatch();
+
+    ret->_physicsRig = source->_physicsRig;
+    ret->_physicsRig->ReferenceCount++;
+
+    ret->_instanceCount = instanceCount;
+    ret->_blockCount = (instanceCount + CubismPhysicsLaneCount - 1) / CubismPhysicsLaneCount;
+
+    ret->_particleLanes.Resize(ret->_blockCount * ret->_physicsRig->Particles.GetSize());
+    ret->_currentRigOutputs.Resize(ret->_blockCount * ret->_physicsRig->Outputs.GetSize());
+    ret->_previousRigOutputs.Resize(ret->_blockCount * ret->_physicsRig->Outputs.GetSize());
+
+    ret->Initialize();
+
+    return ret;
+}
+
+void CubismPhysicsBatch::Delete(CubismPhysicsBatch* batch)
+{
+    CSM_DELETE_SELF(CubismPhysicsBatch, batch);
+}
+
+csmInt32 CubismPhysicsBatch::GetInstanceCount() const
+{
+    return _instanceCount;
+}
+
+void CubismPhysicsBatch::Initialize()
+{
+    const csmInt32 particleCount = _physicsRig->Particles.GetSize();
+
+    for (csmInt32 blockIndex = 0; blockIndex < _blockCount; ++blockIndex)
+    {
+        CubismPhysicsParticleLanes* lanes = _particleLanes.GetPtr() + blockIndex * particleCount;
+
+        for (csmInt32 i = 0; i < particleCount; ++i)
+        {
+            const CubismVector2& initialPosition = _physicsRig->Particles[i].InitialPosition;
+
+            for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+            {
+                lanes[i].PositionX[lane] = initialPosition.X;
+                lanes[i].PositionY[lane] = initialPosition.Y;
+                lanes[i].LastPositionX[lane] = initialPosition.X;
+                lanes[i].LastPositionY[lane] = initialPosition.Y;
+                lanes[i].LastGravityX[lane] = 0.0f;
+                lanes[i].LastGravityY[lane] = 1.0f;
+                lanes[i].VelocityX[lane] = 0.0f;
+                lanes[i].VelocityY[lane] = 0.0f;
+            }
+        }
+    }
+}
+
+void CubismPhysicsBatch::Reset()
+{
+    // set default options.
+    _options.Gravity.Y = -1.0f;
+    _options.Gravity.X = 0.0f;
+    _options.Wind.X = 0.0f;
+    _options.Wind.Y = 0.0f;
+
+    Initialize();
+}
+
+void CubismPhysicsBatch::ResolveParameterIndices(CubismModel* const* models)
+{
+    const csmFloat32* parameterMaximumValues = Core::csmGetParameterMaximumValues(models[0]->GetModel());
+    const csmFloat32* parameterMinimumValues = Core::csmGetParameterMinimumValues(models[0]->GetModel());
+
+    _physicsRig = CubismPhysics::AcquireResolvedRig(_physicsRig, models[0]);
+
+    // 全レーンが同じ物理演算のデータで評価されるため、パラメータの構成が異なるモデルは混在できない
+    for (csmInt32 i = 1; i < _instanceCount; ++i)
+    {
+        if (!CubismPhysics::IsRigResolvedFor(_physicsRig, models[i]))
+        {
+            CubismLogError("CubismPhysicsBatch: the model at index %d has a different parameter layout from the first model.", i);
+        }
+    }
+
+    // 同じmocのモデルではパラメータの範囲が等しいため、出力先の範囲は最初のモデルから取得する
+    const csmInt32 outputCount = _physicsRig->Outputs.GetSize();
+    _outputParameterMinimumValues.Resize(outputCount);
+    _outputParameterMaximumValues.Resize(outputCount);
+    for (csmInt32 i = 0; i < outputCount; ++i)
+    {
+        _outputParameterMinimumValues[i] = parameterMinimumValues[_physicsRig->Outputs[i].DestinationParameterIndex];
+        _outputParameterMaximumValues[i] = parameterMaximumValues[_physicsRig->Outputs[i].DestinationParameterIndex];
+    }
+
+    const csmInt32 cacheCount = _physicsRig->CachedParameterIndices.GetSize();
+    _parameterCaches.Resize(_blockCount * cacheCount);
+    _parameterInputCaches.Resize(_blockCount * cacheCount);
+
+    for (csmInt32 blockIndex = 0; blockIndex < _blockCount; ++blockIndex)
+    {
+        csmFloat32* parameterValues[CubismPhysicsLaneCount];
+        CubismPhysicsLaneValues* inputCaches = _parameterInputCaches.GetPtr() + blockIndex * cacheCount;
+
+        GetBlockParameterValues(models, blockIndex, parameterValues);
+
+        for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+        {
+            if (parameterValues[lane] == NULL)
+            {
+                continue;
+            }
+
+            for (csmInt32 i = 0; i < cacheCount; ++i)
+            {
+                inputCaches[i].Values[lane] = parameterValues[lane][_physicsRig->CachedParameterIndices[i]];
+            }
+        }
+    }
+
+    _isParameterCacheInitialized = true;
+}
+
+void CubismPhysicsBatch::GetBlockParameterValues(CubismModel* const* models, csmInt32 blockIndex, csmFloat32** parameterValues) const
+{
+    for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+    {
+        const csmInt32 instanceIndex = blockIndex * CubismPhysicsLaneCount + lane;
+
+        parameterValues[lane] = (instanceIndex < _instanceCount)
+            ? Core::csmGetParameterValues(models[instanceIndex]->GetModel())
+            : NULL;
+    }
+}
+
+void CubismPhysicsBatch::Stabilization(CubismModel* const* models)
+{
+    csmFloat32 translationX[CubismPhysicsLaneCount];
+    csmFloat32 translationY[CubismPhysicsLaneCount];
+    csmFloat32 totalAngle[CubismPhysicsLaneCount];
+    csmFloat32* parameterValues[CubismPhysicsLaneCount];
+
+    if (!_isParameterCacheInitialized)
+    {
+        ResolveParameterIndices(models);
+    }
+
+    const csmInt32 particleCount = _physicsRig->Particles.GetSize();
+    const csmInt32 outputCount = _physicsRig->Outputs.GetSize();
+    const csmInt32 cacheCount = _physicsRig->CachedParameterIndices.GetSize();
+
+    for (csmInt32 blockIndex = 0; blockIndex < _blockCount; ++blockIndex)
+    {
+        CubismPhysicsParticleLanes* particleLanes = _particleLanes.GetPtr() + blockIndex * particleCount;
+        CubismPhysicsLaneValues* currentRigOutputs = _currentRigOutputs.GetPtr() + blockIndex * outputCount;
+        CubismPhysicsLaneValues* previousRigOutputs = _previousRigOutputs.GetPtr() + blockIndex * outputCount;
+        CubismPhysicsLaneValues* parameterCaches = _parameterCaches.GetPtr() + blockIndex * cacheCount;
+        CubismPhysicsLaneValues* parameterInputCaches = _parameterInputCaches.GetPtr() + blockIndex * cacheCount;
+
+        GetBlockParameterValues(models, blockIndex, parameterValues);
+
+        for (csmInt32 lane = 0; lane < CubismPhysicsLaneCount; ++lane)
+        {
+            if (parameterValues[lane] == NULL)
+            {
+                continue;
+            }
+
+            for (csmInt32 i = 0; i < cacheCount; ++i)
+            {
+                parameterCaches[i].Values[lane] = parameterValues[lane][_physicsRig->CachedParameterIndices[i]];
+                parameterInputCaches[i].Values[lane] = parameterCaches[i].Values[lane];
+            }
+        }
+
+        for (csmInt32 settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+        {
+            const CubismPhysicsSubRig* currentSetting = &_physicsRig->Settings[settingIndex];
+            const CubismPhysicsOutput* currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
+
+            LoadInputLanes(_physicsRig, currentSetting, parameterCaches, translationX, translationY, totalAngle);
+
+            UpdateParticleLanesForStabilization(
+                &_physicsRig->Particles[currentSetting->BaseParticleIndex],
+                particleLanes + currentSetting->BaseParticleIndex,
+                currentSetting->ParticleCount,
+                translationX,
+                translationY,
+                totalAngle,
+                _options.Wind,
+                Physics::MovementThreshold * currentSetting->NormalizationPosition.Maximum
+            );
+
+            EvaluateSubRigOutputLanes(
+                _physicsRig,
+                currentSetting,
+                particleLanes + currentSetting->BaseParticleIndex,
+                _options.Gravity,
+                currentRigOutputs + currentSetting->BaseOutputIndex
+            );
+
+            for (csmInt32 i = 0; i < currentSetting->OutputCount; ++i)
+            {
+                const csmInt32 outputIndex = currentSetting->BaseOutputIndex + i;
+                const csmInt32 particleIndex = currentOutputs[i].VertexIndex;
+
+                if (particleIndex < 1 || particleIndex >= currentSetting->ParticleCount)
+                {
+                    continue;
+                }
+
+                previousRigOutputs[outputIndex] = currentRigOutputs[outputIndex];
+
+                const LaneVec parameterValue = UpdateOutputParameterLanes(
+                    GatherParameterLanes(parameterValues, currentOutputs[i].DestinationParameterIndex),
+                    _outputParameterMinimumValues[outputIndex],
+                    _outputParameterMaximumValues[outputIndex],
+                    LaneLoad(currentRigOutputs[outputIndex].Values),
+                    &currentOutputs[i]
+                );
+
+                ScatterParameterLanes(parameterValues, currentOutputs[i].DestinationParameterIndex, parameterValue);
+                LaneStore(parameterCaches[currentOutputs[i].DestinationCacheIndex].Values, parameterValue);
+            }
+        }
+    }
+
+    _hasRigOutputs = true;
+}
+
+void CubismPhysicsBatch::Evaluate(CubismModel* const* models, csmFloat32 deltaTimeSeconds)
+{
+    if (0.0f >= deltaTimeSeconds)
+    {
+        return;
+    }
+
+    _currentRemainTime += deltaTimeSeconds;
+    if (_currentRemainTime > Physics::MaxDeltaTime)
+    {
+        _currentRemainTime = 0.0f;
+    }
+
+    if (!_isParameterCacheInitialized)
+    {
+        ResolveParameterIndices(models);
+    }
+
+    BlockJobContext context;
+    context.Batch = this;
+    context.Models = models;
+    context.RemainTime = _currentRemainTime;
+    context.PhysicsDeltaTime = (_physicsRig->Fps > 0.0f) ? 1.0f / _physicsRig->Fps : deltaTimeSeconds;
+
+    // 各ブロックは同じ残り時間から同じ回数だけ振り子演算を進める
+    while (_currentRemainTime >= context.PhysicsDeltaTime)
+    {
+        _hasRigOutputs = true;
+        _currentRemainTime -= context.PhysicsDeltaTime;
+    }
+
+    // ブロック間で共有する状態はないため、ブロックごとに並列に評価できる
+    ICubismJobSystem* jobSystem = CubismFramework::GetJobSystem();
+
+    if (jobSystem == NULL || _blockCount < 2)
+    {
+        for (csmInt32 blockIndex = 0; blockIndex < _blockCount; ++blockIndex)
+        {
+            EvaluateBlockJob(&context, blockIndex);
+        }
+    }
+    else
+    {
+        jobSystem->Dispatch(EvaluateBlockJob, &context, _blockCount);
+    }
+}
+
+void CubismPhysicsBatch::EvaluateBlockJob(void* context, csmInt32 jobIndex)
+{
+    BlockJobContext* jobContext = static_cast<BlockJobContext*>(context);
+
+    jobContext->Batch->EvaluateBlock(jobIndex, jobContext->Models, jobContext->RemainTime, jobContext->PhysicsDeltaTime);
+}
+
+void CubismPhysicsBatch::EvaluateBlock(csmInt32 blockIndex, CubismModel* const* models, csmFloat32 remainTime, csmFloat32 physicsDeltaTime)
+{
+    csmFloat32* parameterValues[CubismPhysicsLaneCount];
+
+    const csmInt32 outputCount = _physicsRig->Outputs.GetSize();
+    const csmInt32 cacheCount = _physicsRig->CachedParameterIndices.GetSize();
+    const csmInt32* cachedParameterIndices = _physicsRig->CachedParameterIndices.GetPtr();
+
+    CubismPhysicsLaneValues* currentRigOutputs = _currentRigOutputs.GetPtr() + blockIndex * outputCount;
+    CubismPhysicsLaneValues* previousRigOutputs = _previousRigOutputs.GetPtr() + blockIndex * outputCount;
+    CubismPhysicsLaneValues* parameterCaches = _parameterCaches.GetPtr() + blockIndex * cacheCount;
+    CubismPhysicsLaneValues* parameterInputCaches = _parameterInputCaches.GetPtr() + blockIndex * cacheCount;
+
+    GetBlockParameterValues(models, blockIndex, parameterValues);
+
+    while (remainTime >= physicsDeltaTime)
+    {
+        for (csmInt32 i = 0; i < outputCount; ++i)
+        {
+            previousRigOutputs[i] = currentRigOutputs[i];
+        }
+
+        // 入力キャッシュとパラメータで線形補間してUpdateParticlesするタイミングでの入力を計算する。
+        // インスタンスのないレーンは0を入力として計算し、結果は使用しない
+        const csmFloat32 inputWeight = physicsDeltaTime / remainTime;
+        const LaneVec inputWeightLanes = LaneSplat(inputWeight);
+        const LaneVec cacheWeightLanes = LaneSplat(1.0f - inputWeight);
+        for (csmInt32 j = 0; j < cacheCount; ++j)
+        {
+            const LaneVec value = LaneAdd(
+                LaneMul(LaneLoad(parameterInputCaches[j].Values), cacheWeightLanes),
+                LaneMul(GatherParameterLanes(parameterValues, cachedParameterIndices[j]), inputWeightLanes)
+            );
+
+            LaneStore(parameterCaches[j].Values, value);
+            LaneStore(parameterInputCaches[j].Values, value);
+        }
+
+        for (csmInt32 settingIndex = 0; settingIndex < _physicsRig->SubRigCount; ++settingIndex)
+        {
+            EvaluateSubRig(blockIndex, settingIndex, physicsDeltaTime);
+        }
+
+        remainTime -= physicsDeltaTime;
+    }
+
+    Interpolate(blockIndex, models, remainTime / physicsDeltaTime);
+}
+
+void CubismPhysicsBatch::EvaluateSubRig(csmInt32 blockIndex, csmInt32 settingIndex, csmFloat32 physicsDeltaTime)
+{
+    csmFloat32 translationX[CubismPhysicsLaneCount];
+    csmFloat32 translationY[CubismPhysicsLaneCount];
+    csmFloat32 totalAngle[CubismPhysicsLaneCount];
+
+    const CubismPhysicsSubRig* currentSetting = &_physicsRig->Settings[settingIndex];
+    const CubismPhysicsOutput* currentOutputs = &_physicsRig->Outputs[currentSetting->BaseOutputIndex];
+    const csmInt32 outputCount = _physicsRig->Outputs.GetSize();
+    const csmInt32 cacheCount = _physicsRig->CachedParameterIndices.GetSize();
+
+    CubismPhysicsParticleLanes* particleLanes = _particleLanes.GetPtr()
+        + blockIndex * _physicsRig->Particles.GetSize() + currentSetting->BaseParticleIndex;
+    CubismPhysicsLaneValues* rigOutputs = _currentRigOutputs.GetPtr() + blockIndex * outputCount + currentSetting->BaseOutputIndex;
+    CubismPhysicsLaneValues* parameterCaches = _parameterCaches.GetPtr() + blockIndex * cacheCount;
+
+    LoadInputLanes(_physicsRig, currentSetting, parameterCaches, translationX, translationY, totalAngle);
+
+    UpdateParticleLanes(
+        &_physicsRig->Particles[currentSetting->BaseParticleIndex],
+        particleLanes,
+        currentSetting->ParticleCount,
+        translationX,
+        translationY,
+        totalAngle,
+        _options.Wind,
+        Physics::MovementThreshold * currentSetting->NormalizationPosition.Maximum,
+        physicsDeltaTime,
+        Physics::AirResistance
+    );
+
+    EvaluateSubRigOutputLanes(_physicsRig, currentSetting, particleLanes, _options.Gravity, rigOutputs);
+
+    // 同じパラメータへの出力があるため、適用は元の出力順で行う。
+    for (csmInt32 i = 0; i < currentSetting->OutputCount; ++i)
+    {
+        const csmInt32 particleIndex = currentOutputs[i].VertexIndex;
+
+        if (particleIndex < 1 || particleIndex >= currentSetting->ParticleCount)
+        {
+            continue;
+        }
+
+        csmFloat32* parameterCache = parameterCaches[currentOutputs[i].DestinationCacheIndex].Values;
+
+        LaneStore(parameterCache, UpdateOutputParameterLanes(
+            LaneLoad(parameterCache),
+            _outputParameterMinimumValues[currentSetting->BaseOutputIndex + i],
+            _outputParameterMaximumValues[currentSetting->BaseOutputIndex + i],
+            LaneLoad(rigOutputs[i].Values),
+            &currentOutputs[i]
+        ));
+    }
+}
+
+void CubismPhysicsBatch::Interpolate(csmInt32 blockIndex, CubismModel* const* models, csmFloat32 weight)
+{
+    csmFloat32* parameterValues[CubismPhysicsLaneCount];
+
+    // 振り子計算が一度も行われていない場合は適用する結果が存在しない
+    if (!_hasRigOutputs)
+    {
+        return;
+    }
+
+    const csmInt32 outputCount = _physicsRig->Outputs.GetSize();
+    const CubismPhysicsLaneValues* currentRigOutputs = _currentRigOutputs.GetPtr() + blockIndex * outputCount;
+    const CubismPhysicsLaneValues* previousRigOutputs = _previousRigOutputs.GetPtr() + blockIndex * outputCount;
+
+    GetBlockParameterValues(models, blockIndex, parameterValues);
+
+    const LaneVec previousWeight = LaneSplat(1 - weight);
+    const LaneVec currentWeight = LaneSplat(weight);
+
+    for (csmInt32 i = 0; i < outputCount; ++i)
+    {
+        const CubismPhysicsOutput* output = &_physicsRig->Outputs[i];
+        const LaneVec translation = LaneAdd(
+            LaneMul(LaneLoad(previousRigOutputs[i].Values), previousWeight),
+            LaneMul(LaneLoad(currentRigOutputs[i].Values), currentWeight)
+        );
+
+        ScatterParameterLanes(parameterValues, output->DestinationParameterIndex, UpdateOutputParameterLanes(
+            GatherParameterLanes(parameterValues, output->DestinationParameterIndex),
+            _outputParameterMinimumValues[i],
+            _outputParameterMaximumValues[i],
+            translation,
+            output
+        ));
+    }
+}
+
+void CubismPhysicsBatch::SetOptions(const CubismPhysics::Options& options)
+{
+    _options = options;
+}
+
+const CubismPhysics::Options& CubismPhysicsBatch::GetOptions() const
+{
+    return _options;
+}
+
+}}}
@@ -0,0 +1,211 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismPhysics.hpp"
+#include "CubismPhysicsInternal.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+class CubismModel;
+struct CubismPhysicsRig;
+
+/**
+ * @brief 物理演算の一括評価クラス
+ *
+ * 同じ物理演算のデータを共有する複数のインスタンスをまとめて評価するクラス。
+ * インスタンスはCubismPhysicsLaneCount個ずつのブロックに分けられ、ブロック内の各インスタンスの状態は
+ * 同じ値をレーン方向に並べて保持する。各レーンはCubismPhysicsと同じ演算で評価されるため、結果は個別の評価と一致する。
+ * 三角関数はレーンごとに呼び出すため、演算時間はレーン数に比例しては減らない。
+ * 短縮されるのはパラメータの読み書きやサブリグの走査など、ブロック内で共有できる処理の分である。
+ * 全インスタンスは同じデルタ時間とオプションで評価される。
+ */
+class CubismPhysicsBatch
+{
+public:
+    /**
+     * @brief インスタンスの作成
+     *
+     * sourceと物理演算のデータを共有する、指定した数のインスタンスをまとめて評価するインスタンスを作成する。
+     * 共有するインスタンスは同じmocから作成したモデルに適用すること。
+     *
+     * @param[in]   source          物理演算のデータを共有するインスタンス
+     * @param[in]   instanceCount   まとめて評価するインスタンスの数
+     * @return  作成されたインスタンス
+     */
+    static CubismPhysicsBatch* Create(const CubismPhysics* source, csmInt32 instanceCount);
+
+    /**
+     * @brief インスタンスの破棄
+     *
+     * インスタンスを破棄する。
+     *
+     * @param[in]   batch       破棄するインスタンス
+     */
+    static void Delete(CubismPhysicsBatch* batch);
+
+    /**
+     * @brief まとめて評価するインスタンスの数の取得
+     *
+     * @return インスタンスの数
+     */
+    csmInt32 GetInstanceCount() const;
+
+    /**
+     * @brief パラメータのリセット
+     *
+     * 全インスタンスのパラメータをリセットする。
+     */
+    void Reset();
+
+    /**
+     * @brief 現在のパラメータ値で物理演算が安定化する状態を演算する。
+     *
+     * @param[in]   models      物理演算の結果を適用するモデルのリスト。インスタンスの数だけ異なるモデルを渡す。
+     */
+    void Stabilization(CubismModel* const* models);
+
+    /**
+     * @brief 物理演算の評価
+     *
+     * 全インスタンスの物理演算を評価する。
+     * CubismFrameworkにジョブシステムが設定されている場合は、ブロックごとに並列に評価する。
+     *
+     * @param[in]   models              物理演算の結果を適用するモデルのリスト。インスタンスの数だけ異なるモデルを渡す。
+     * @param[in]   deltaTimeSeconds    デルタ時間[秒]
+     */
+    void Evaluate(CubismModel* const* models, csmFloat32 deltaTimeSeconds);
+
+    /**
+     * @brief オプションの設定
+     *
+     * 全インスタンスに共通のオプションを設定する。
+     *
+     * @param[in]   options     オプション
+     */
+    void SetOptions(const CubismPhysics::Options& options);
+
+    /**
+     * @brief オプションの取得
+     *
+     * @return オプション
+     */
+    const CubismPhysics::Options& GetOptions() const;
+
+private:
+    /**
+     * @brief ブロックの並列評価に渡すコンテキスト
+     */
+    struct BlockJobContext
+    {
+        CubismPhysicsBatch* Batch;                      ///< 評価するインスタンス
+        CubismModel* const* Models;                     ///< 物理演算の結果を適用するモデルのリスト
+        csmFloat32 RemainTime;                          ///< 評価前の物理演算が処理していない時間
+        csmFloat32 PhysicsDeltaTime;                    ///< 物理演算のデルタ時間
+    };
+
+    /**
+     * @brief コンストラクタ
+     */
+    CubismPhysicsBatch();
+
+    /**
+     * @brief デストラクタ
+     */
+    virtual ~CubismPhysicsBatch();
+
+    // Prevention of copy Constructor
+    CubismPhysicsBatch(const CubismPhysicsBatch&);
+    CubismPhysicsBatch& operator=(const CubismPhysicsBatch&);
+
+    /**
+     * @brief 初期化
+     *
+     * 全インスタンスの物理点を初期位置に戻す。
+     */
+    void Initialize();
+
+    /**
+     * @brief パラメータのインデックスの解決
+     *
+     * 物理演算のデータが未解決であれば最初のモデルで解決し、パラメータのキャッシュを構築する。
+     *
+     * @param[in]   models      物理演算の結果を適用するモデルのリスト
+     */
+    void ResolveParameterIndices(CubismModel* const* models);
+
+    /**
+     * @brief ブロック内のインスタンスのパラメータの取得
+     *
+     * @param[in]   models              物理演算の結果を適用するモデルのリスト
+     * @param[in]   blockIndex          ブロックのインデックス
+     * @param[out]  parameterValues     レーンごとのパラメータのリスト。インスタンスが存在しないレーンはNULL
+     */
+    void GetBlockParameterValues(CubismModel* const* models, csmInt32 blockIndex, csmFloat32** parameterValues) const;
+
+    /**
+     * @brief ブロックの評価
+     *
+     * 1ブロック分のインスタンスの振り子演算を進め、結果をモデルに適用する。
+     *
+     * @param[in]   blockIndex          ブロックのインデックス
+     * @param[in]   models              物理演算の結果を適用するモデルのリスト
+     * @param[in]   remainTime          評価前の物理演算が処理していない時間
+     * @param[in]   physicsDeltaTime    物理演算のデルタ時間
+     */
+    void EvaluateBlock(csmInt32 blockIndex, CubismModel* const* models, csmFloat32 remainTime, csmFloat32 physicsDeltaTime);
+
+    /**
+     * @brief ブロック内のサブリグの評価
+     *
+     * 1ブロック分のインスタンスのサブリグの振り子演算を一回分進め、結果をパラメータのキャッシュに適用する。
+     *
+     * @param[in]   blockIndex          ブロックのインデックス
+     * @param[in]   settingIndex        評価するサブリグのインデックス
+     * @param[in]   physicsDeltaTime    物理演算のデルタ時間
+     */
+    void EvaluateSubRig(csmInt32 blockIndex, csmInt32 settingIndex, csmFloat32 physicsDeltaTime);
+
+    /**
+     * @brief ブロックの物理演算結果の適用
+     *
+     * 振り子演算の最新の結果と一つ前の結果から指定した重みで適用する。
+     *
+     * @param[in]   blockIndex      ブロックのインデックス
+     * @param[in]   models          物理演算の結果を適用するモデルのリスト
+     * @param[in]   weight          最新結果の重み
+     */
+    void Interpolate(csmInt32 blockIndex, CubismModel* const* models, csmFloat32 weight);
+
+    /**
+     * @brief ブロックの評価のジョブ
+     *
+     * @param[in]   context     BlockJobContext
+     * @param[in]   jobIndex    ブロックのインデックス
+     */
+    static void EvaluateBlockJob(void* context, csmInt32 jobIndex);
+
+    CubismPhysicsRig* _physicsRig;              ///< 物理演算のデータ(インスタンス間で共有)
+    CubismPhysics::Options _options;            ///< オプション
+    csmInt32 _instanceCount;                    ///< まとめて評価するインスタンスの数
+    csmInt32 _blockCount;                       ///< ブロックの数
+
+    csmVector<CubismPhysicsParticleLanes> _particleLanes;   ///< ブロックごとの物理点の状態
+    csmVector<CubismPhysicsLaneValues> _currentRigOutputs;  ///< ブロックごとの最新の振り子計算の結果
+    csmVector<CubismPhysicsLaneValues> _previousRigOutputs; ///< ブロックごとの一つ前の振り子計算の結果
+    csmVector<CubismPhysicsLaneValues> _parameterCaches;    ///< ブロックごとのパラメータのキャッシュ
+    csmVector<CubismPhysicsLaneValues> _parameterInputCaches; ///< ブロックごとのUpdateParticlesが動くときの入力のキャッシュ
+    csmVector<csmFloat32> _outputParameterMinimumValues;    ///< 出力先のパラメータの最小値のリスト
+    csmVector<csmFloat32> _outputParameterMaximumValues;    ///< 出力先のパラメータの最大値のリスト
+
+    csmFloat32 _currentRemainTime;              ///< 物理演算が処理していない時間
+    csmBool _isParameterCacheInitialized;       ///< パラメータのキャッシュを構築済みか
+    csmBool _hasRigOutputs;                     ///< 振り子計算の結果が存在するか
+};
+
+}}}
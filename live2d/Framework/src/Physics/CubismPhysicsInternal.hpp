@@ -11,6 +11,8 @@
 #include "Model/CubismModel.hpp"
 #include "Math/CubismVector2.hpp"
 #include "Id/CubismId.hpp"
+#include <atomic>
+#include <mutex>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -34,6 +36,7 @@ enum CubismPhysicsSource
     CubismPhysicsSource_X,          ///< X軸の位置から
     CubismPhysicsSource_Y,          ///< Y軸の位置から
     CubismPhysicsSource_Angle,      ///< 角度から
+    CubismPhysicsSource_Count,      ///< 入力の種類の個数
 };
 
 /**
@@ -74,6 +77,7 @@ struct CubismPhysicsNormalization
  * @brief 物理演算の演算に使用する物理点の情報
  *
  * 物理演算の演算に使用する物理点の情報。
+ * インスタンス間で共有される不変の値のみを持ち、演算中に変化する値はCubismPhysicsParticleStateが持つ。
  */
 struct CubismPhysicsParticle
 {
@@ -82,13 +86,53 @@ struct CubismPhysicsParticle
     csmFloat32 Delay;                       ///< 遅れ
     csmFloat32 Acceleration;                ///< 加速度
     csmFloat32 Radius;                      ///< 距離
+};
+
+/**
+ * @brief 物理点の状態
+ *
+ * インスタンスごとに保持する、物理演算で変化する物理点の値。
+ */
+struct CubismPhysicsParticleState
+{
     CubismVector2 Position;                 ///< 現在の位置
     CubismVector2 LastPosition;             ///< 最後の位置
     CubismVector2 LastGravity;              ///< 最後の重力
-    CubismVector2 Force;                    ///< 現在かかっている力
     CubismVector2 Velocity;                 ///< 現在の速度
 };
 
+/**
+ * @brief 一括評価で1ブロックにまとめるインスタンスの数
+ */
+const csmInt32 CubismPhysicsLaneCount = 4;
+
+/**
+ * @brief レーンごとの値
+ *
+ * 一括評価で、1ブロック内の各インスタンスの同じ値を並べたもの。
+ */
+struct CubismPhysicsLaneValues
+{
+    csmFloat32 Values[CubismPhysicsLaneCount];          ///< インスタンスごとの値
+};
+
+/**
+ * @brief レーンごとの物理点の状態
+ *
+ * 一括評価で、1ブロック内の各インスタンスの物理点の状態を成分ごとに並べたもの。
+ */
+struct CubismPhysicsParticleLanes
+{
+    csmFloat32 PositionX[CubismPhysicsLaneCount];       ///< 現在の位置のX成分
+    csmFloat32 PositionY[CubismPhysicsLaneCount];       ///< 現在の位置のY成分
+    csmFloat32 LastPositionX[CubismPhysicsLaneCount];   ///< 最後の位置のX成分
+    csmFloat32 LastPositionY[CubismPhysicsLaneCount];   ///< 最後の位置のY成分
+    csmFloat32 LastGravityX[CubismPhysicsLaneCount];    ///< 最後の重力のX成分
+    csmFloat32 LastGravityY[CubismPhysicsLaneCount];    ///< 最後の重力のY成分
+    csmFloat32 VelocityX[CubismPhysicsLaneCount];       ///< 現在の速度のX成分
+    csmFloat32 VelocityY[CubismPhysicsLaneCount];       ///< 現在の速度のY成分
+};
+
 /**
  * @brief 物理演算の物理点の管理
  *
@@ -104,67 +148,12 @@ struct CubismPhysicsSubRig
     csmInt32 BaseParticleIndex;                                 ///< 物理点の最初のインデックス
     CubismPhysicsNormalization NormalizationPosition;           ///< 正規化された位置
     CubismPhysicsNormalization NormalizationAngle;              ///< 正規化された角度
+    csmInt32 BaseCompiledInputIndex[CubismPhysicsSource_Count];     ///< 種類ごとの入力の最初のインデックス
+    csmInt32 CompiledInputCount[CubismPhysicsSource_Count];         ///< 種類ごとの入力の個数
+    csmInt32 BaseCompiledOutputIndex[CubismPhysicsSource_Count];    ///< 種類ごとの出力の最初のインデックス
+    csmInt32 CompiledOutputCount[CubismPhysicsSource_Count];        ///< 種類ごとの出力の個数
 };
 
-/**
- * @brief 正規化されたパラメータの取得関数の宣言
- *
- * 正規化されたパラメータの取得関数の宣言。
- *
- * @param[out]      targetTranslation       演算結果の移動値
- * @param[out]      targetAngle             演算結果の角度
- * @param[in]       value                   パラメータの値
- * @param[in]       parameterMinimumValue   パラメータの最小値
- * @param[in]       parameterMaximumValue   パラメータの最大値
- * @param[in]       parameterDefaultValue   パラメータのデフォルト値
- * @param[in]       normalizationPosition   正規化された位置
- * @param[in]       normalizationAngle      正規化された角度
- * @param[in]       isInverted              値が反転されているか？
- * @param[in]       weight                  重み
- */
-typedef void (*NormalizedPhysicsParameterValueGetter)(
-    CubismVector2* targetTranslation,
-    csmFloat32* targetAngle,
-    csmFloat32 value,
-    csmFloat32 parameterMinimumValue,
-    csmFloat32 parameterMaximumValue,
-    csmFloat32 parameterDefaultValue,
-    CubismPhysicsNormalization* normalizationPosition,
-    CubismPhysicsNormalization* normalizationAngle,
-    csmInt32 isInverted,
-    csmFloat32 weight
-);
-
-/**
- * @brief 物理演算の値の取得関数の宣言
- *
- * 物理演算の値の取得関数の宣言。
- *
- * @param[in]       translation     移動値
- * @param[in]       particles       物理点のリスト
- * @param[in]       isInverted      値が反転されているか？
- * @param[in]       parentGravity   重力
- * @return  値
- */
-typedef csmFloat32 (*PhysicsValueGetter)(
-    CubismVector2 translation,
-    CubismPhysicsParticle* particles,
-    csmInt32 particleIndex,
-    csmInt32 isInverted,
-    CubismVector2 parentGravity
-);
-
-/**
- * @brief 物理演算のスケールの取得関数の宣言
- *
- * 物理演算のスケールの取得関数の宣言。
- *
- * @param[in]   translationScale    移動値のスケール
- * @param[in]   angleScale          角度のスケール
- * @return  スケール値
- */
-typedef csmFloat32 (*PhysicsScaleGetter)(CubismVector2 translationScale, csmFloat32 angleScale);
-
 /**
  * @brief 物理演算の入力情報
  *
@@ -177,7 +166,6 @@ struct CubismPhysicsInput
     csmFloat32 Weight;                              ///< 重み
     csmInt16 Type;                                  ///< 入力の種類
     csmInt16 Reflect;                               ///< 値が反転されているかどうか
-    NormalizedPhysicsParameterValueGetter GetNormalizedParameterValue;          ///< 正規化されたパラメータ値の取得関数
 };
 
 /**
@@ -189,22 +177,58 @@ struct CubismPhysicsOutput
 {
     CubismPhysicsParameter Destination;         ///< 出力先のパラメータ
     csmInt32 DestinationParameterIndex;         ///< 出力先のパラメータのインデックス
+    csmInt32 DestinationCacheIndex;             ///< 出力先のパラメータキャッシュ内のインデックス
     csmInt32 VertexIndex;                       ///< 振り子のインデックス
     CubismVector2 TranslationScale;             ///< 移動値のスケール
     csmFloat32 AngleScale;                      ///< 角度のスケール
     csmFloat32 Weight;                          /// 重み
     CubismPhysicsSource Type;                   ///< 出力の種類
     csmInt16 Reflect;                           ///< 値が反転されているかどうか
-    csmFloat32 ValueBelowMinimum;               ///< 最小値を下回った時の値
-    csmFloat32 ValueExceededMaximum;            ///< 最大値をこえた時の値
-    PhysicsValueGetter GetValue;                ///< 物理演算の値の取得関数
-    PhysicsScaleGetter GetScale;                ///< 物理演算のスケール値の取得関数
+    csmFloat32 Scale;                           ///< 出力の種類に応じたスケール
+};
+
+/**
+ * @brief 種類ごとにまとめた物理演算の入力情報
+ *
+ * Parse時に入力の種類ごとに分類し、正規化に必要な値を事前に計算した入力情報。
+ * パラメータの範囲に依存する値はモデルのパラメータインデックスの解決時に計算する。
+ */
+struct CubismPhysicsCompiledInput
+{
+    csmInt32 InputIndex;                        ///< 元の入力のインデックス
+    csmInt32 SourceCacheIndex;                  ///< 入力元のパラメータキャッシュ内のインデックス
+    csmFloat32 Weight;                          ///< 反転を反映した重み
+    csmFloat32 NormalizedMinimum;               ///< 正規化後の最小値
+    csmFloat32 NormalizedMaximum;               ///< 正規化後の最大値
+    csmFloat32 NormalizedMiddle;                ///< 正規化後の中間値
+    csmFloat32 ParameterMinimum;                ///< パラメータの最小値
+    csmFloat32 ParameterMaximum;                ///< パラメータの最大値
+    csmFloat32 ParameterMiddle;                 ///< パラメータの中間値
+    csmFloat32 PositiveScale;                   ///< 中間値より大きい値の変換倍率
+    csmFloat32 NegativeScale;                   ///< 中間値より小さい値の変換倍率
+    csmBool HasPositiveRange;                   ///< 中間値より大きい範囲が存在するか
+    csmBool HasNegativeRange;                   ///< 中間値より小さい範囲が存在するか
+};
+
+/**
+ * @brief 種類ごとにまとめた物理演算の出力情報
+ *
+ * Parse時に出力の種類ごとに分類した出力情報。振り子のインデックスが範囲外の出力は含まない。
+ */
+struct CubismPhysicsCompiledOutput
+{
+    csmInt32 OutputIndex;                       ///< サブリグ内の出力のインデックス
+    csmInt32 VertexIndex;                       ///< 振り子のインデックス
+    csmFloat32 ReflectSign;                     ///< 反転の係数
 };
 
 /**
  * @brief 物理演算のデータ
  *
  * 物理演算のデータ。
+ * 同じphysics3.jsonから作られたインスタンス間で共有され、参照カウントで破棄される。
+ * パラメータのインデックスは最初に評価したモデルでロックを取って一度だけ解決し、解決後は変更しない。
+ * 解決済みのデータとパラメータの構成が異なるモデルに適用したインスタンスは、自身専用の複製を解決して使用する。
  */
 struct CubismPhysicsRig
 {
@@ -213,6 +237,15 @@ struct CubismPhysicsRig
     csmVector<CubismPhysicsInput> Inputs;           ///< 物理演算の入力のリスト
     csmVector<CubismPhysicsOutput> Outputs;         ///< 物理演算の出力のリスト
     csmVector<CubismPhysicsParticle> Particles;     ///< 物理演算の物理点のリスト
+    csmVector<CubismPhysicsCompiledInput> CompiledInputs[CubismPhysicsSource_Count];    ///< 種類ごとの入力のリスト
+    csmVector<CubismPhysicsCompiledOutput> CompiledOutputs[CubismPhysicsSource_Count];  ///< 種類ごとの出力のリスト
+    csmVector<csmInt32> CachedParameterIndices;     ///< 物理演算が入出力するパラメータのインデックスのリスト
+    csmVector<csmInt32> EvaluationOrder;            ///< 依存関係の段ごとに並べたサブリグのインデックスのリスト
+    csmVector<csmInt32> EvaluationStageOffsets;     ///< 各段のEvaluationOrder内の開始位置(末尾は総数)
+    csmVector<csmInt32> EvaluationStageParticleCounts; ///< 各段の物理点の個数
+    std::atomic<csmBool> IsParameterIndexResolved;  ///< パラメータのインデックスを解決済みか
+    std::atomic<csmInt32> ReferenceCount;           ///< このデータを参照しているインスタンスの数
+    std::mutex ResolveMutex;                        ///< パラメータのインデックスの解決を排他するためのミューテックス
     CubismVector2 Gravity;                          ///< 重力
     CubismVector2 Wind;                             ///< 風
     csmFloat32 Fps;                                 ///< 物理演算動作FPS
@@ -0,0 +1,337 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismPhysicsInternal.hpp"
+#include "Math/CubismMath.hpp"
+#include "Math/CubismVector2.hpp"
+
+// CubismPhysicsBatchのSIMDの演算と結果をビット単位で一致させるため、乗算と加算を融合しない
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+/**
+ * @brief 物理演算の共通の演算
+ *
+ * CubismPhysicsとCubismPhysicsBatchが共有する定数と、1つのインスタンスの値に対する演算。
+ * 一括評価はレーンごとに同じ関数を呼び出すため、両者の結果はビット単位で一致する。
+ */
+namespace Live2D { namespace Cubism { namespace Framework { namespace Physics {
+
+const csmFloat32 AirResistance = 5.0f;          ///< 空気抵抗
+const csmFloat32 MaximumWeight = 100.0f;        ///< 入出力の重みの最大値
+const csmFloat32 MovementThreshold = 0.001f;    ///< 移動とみなさない値の割合
+const csmFloat32 MaxDeltaTime = 5.0f;           ///< 許容するデルタ時間の最大値
+
+/**
+ * @brief 入力の正規化
+ *
+ * パラメータの値を入力の正規化の範囲に変換し、重みを掛ける。
+ *
+ * @param[in]   input   種類ごとにまとめた入力
+ * @param[in]   value   入力元のパラメータの値
+ * @return  重みを掛けた正規化後の値
+ */
+inline csmFloat32 GetWeightedNormalizedInput(const CubismPhysicsCompiledInput& input, csmFloat32 value)
+{
+    if (input.ParameterMaximum < value)
+    {
+        value = input.ParameterMaximum;
+    }
+
+    if (input.ParameterMinimum > value)
+    {
+        value = input.ParameterMinimum;
+    }
+
+    const csmFloat32 paramValue = value - input.ParameterMiddle;
+    csmFloat32 result = 0.0f;
+
+    if (paramValue > 0.0f)
+    {
+        if (input.HasPositiveRange)
+        {
+            result = paramValue * input.PositiveScale;
+            result += input.NormalizedMiddle;
+        }
+    }
+    else if (paramValue < 0.0f)
+    {
+        if (input.HasNegativeRange)
+        {
+            result = paramValue * input.NegativeScale;
+            result += input.NormalizedMiddle;
+        }
+    }
+    else
+    {
+        result = input.NormalizedMiddle;
+    }
+
+    return result * input.Weight;
+}
+
+/**
+ * @brief 移動量の回転
+ *
+ * 入力の移動量を入力の角度の逆方向に回転する。
+ *
+ * @param[in,out]   translation     入力の移動量
+ * @param[in]       totalAngle      入力の角度
+ */
+inline void RotateTranslation(CubismVector2* translation, csmFloat32 totalAngle)
+{
+    const csmFloat32 radAngle = CubismMath::DegreesToRadian(-totalAngle);
+    const csmFloat32 cosAngle = CubismMath::CosF(radAngle);
+    const csmFloat32 sinAngle = CubismMath::SinF(radAngle);
+
+    translation->X = (translation->X * cosAngle - translation->Y * sinAngle);
+    translation->Y = (translation->X * sinAngle + translation->Y * cosAngle);
+}
+
+/**
+ * @brief 重力の方向の取得
+ *
+ * @param[in]   totalAngle  入力の角度
+ * @return  正規化した重力の方向
+ */
+inline CubismVector2 GetGravityDirection(csmFloat32 totalAngle)
+{
+    CubismVector2 gravity = CubismMath::RadianToDirection(CubismMath::DegreesToRadian(totalAngle));
+    gravity.Normalize();
+
+    return gravity;
+}
+
+/**
+ * @brief 物理点の回転量の取得
+ *
+ * 前回からの重力の方向の変化を空気抵抗で減衰させた、物理点の回転量を取得する。
+ *
+ * @param[in]   lastGravity     前回の重力の方向
+ * @param[in]   gravity         重力の方向
+ * @param[in]   airResistance   空気抵抗
+ * @return  回転量のラジアン値
+ */
+inline csmFloat32 GetParticleRotation(const CubismVector2& lastGravity, const CubismVector2& gravity, csmFloat32 airResistance)
+{
+    return CubismMath::DirectionToRadian(lastGravity, gravity) / airResistance;
+}
+
+/**
+ * @brief 物理点の移動方向の取得
+ *
+ * 回転、速度、重力と風による力を反映した移動先を、1つ前の物理点からの方向として取得する。
+ *
+ * @param[in]   particle            物理点
+ * @param[in]   parentPosition      1つ前の物理点の位置
+ * @param[in]   position            物理点の位置
+ * @param[in]   velocity            物理点の速度
+ * @param[in]   gravity             重力の方向
+ * @param[in]   windDirection       風の方向
+ * @param[in]   cosRadian           回転量の余弦
+ * @param[in]   sinRadian           回転量の正弦
+ * @param[in]   delay               デルタ時間を反映した物理点の遅れ
+ * @return  正規化していない移動方向
+ */
+inline CubismVector2 GetParticleMoveDirection(const CubismPhysicsParticle& particle, const CubismVector2& parentPosition,
+    const CubismVector2& position, const CubismVector2& velocity, const CubismVector2& gravity, const CubismVector2& windDirection,
+    csmFloat32 cosRadian, csmFloat32 sinRadian, csmFloat32 delay)
+{
+    const csmFloat32 forceX = (gravity.X * particle.Acceleration) + windDirection.X;
+    const csmFloat32 forceY = (gravity.Y * particle.Acceleration) + windDirection.Y;
+
+    csmFloat32 x = position.X - parentPosition.X;
+    csmFloat32 y = position.Y - parentPosition.Y;
+
+    x = ((cosRadian * x) - (y * sinRadian));
+    y = ((sinRadian * x) + (y * cosRadian));
+
+    x = parentPosition.X + x;
+    y = parentPosition.Y + y;
+
+    x = x + (velocity.X * delay) + (forceX * delay * delay);
+    y = y + (velocity.Y * delay) + (forceY * delay * delay);
+
+    return CubismVector2(x - parentPosition.X, y - parentPosition.Y);
+}
+
+/**
+ * @brief 物理点の位置の確定
+ *
+ * 1つ前の物理点から正規化した移動方向に物理点の半径だけ離れた位置に置き、移動量から速度を求める。
+ *
+ * @param[in]       particle            物理点
+ * @param[in]       parentPosition      1つ前の物理点の位置
+ * @param[in]       direction           正規化した移動方向
+ * @param[out]      position            物理点の位置
+ * @param[in]       lastPosition        更新前の位置
+ * @param[in,out]   velocity            物理点の速度
+ * @param[in]       thresholdValue      移動とみなさない値
+ * @param[in]       delay               デルタ時間を反映した物理点の遅れ
+ */
+inline void SettleParticle(const CubismPhysicsParticle& particle, const CubismVector2& parentPosition, const CubismVector2& direction,
+    CubismVector2* position, const CubismVector2& lastPosition, CubismVector2* velocity, csmFloat32 thresholdValue, csmFloat32 delay)
+{
+    position->X = parentPosition.X + (direction.X * particle.Radius);
+    position->Y = parentPosition.Y + (direction.Y * particle.Radius);
+
+    if (CubismMath::AbsF(position->X) < thresholdValue)
+    {
+        position->X = 0.0f;
+    }
+
+    if (delay != 0.0f)
+    {
+        velocity->X = ((position->X - lastPosition.X) / delay) * particle.Mobility;
+        velocity->Y = ((position->Y - lastPosition.Y) / delay) * particle.Mobility;
+    }
+}
+
+/**
+ * @brief 物理点の更新
+ *
+ * 1つ前の物理点に追従するように物理点の状態を更新する。
+ *
+ * @param[in]       particle            物理点
+ * @param[in]       parentPosition      1つ前の物理点の位置
+ * @param[in,out]   position            物理点の位置
+ * @param[out]      lastPosition        更新前の位置
+ * @param[in,out]   velocity            物理点の速度
+ * @param[in,out]   lastGravity         前回の重力の方向
+ * @param[in]       gravity             重力の方向
+ * @param[in]       windDirection       風の方向
+ * @param[in]       thresholdValue      移動とみなさない値
+ * @param[in]       delay               デルタ時間を反映した物理点の遅れ
+ * @param[in]       airResistance       空気抵抗
+ */
+inline void UpdateParticle(const CubismPhysicsParticle& particle, const CubismVector2& parentPosition,
+    CubismVector2* position, CubismVector2* lastPosition, CubismVector2* velocity, CubismVector2* lastGravity,
+    const CubismVector2& gravity, const CubismVector2& windDirection, csmFloat32 thresholdValue,
+    csmFloat32 delay, csmFloat32 airResistance)
+{
+    const csmFloat32 radian = GetParticleRotation(*lastGravity, gravity, airResistance);
+
+    *lastPosition = *position;
+
+    CubismVector2 direction = GetParticleMoveDirection(
+        particle, parentPosition, *position, *velocity, gravity, windDirection,
+        CubismMath::CosF(radian), CubismMath::SinF(radian), delay
+    );
+    direction.Normalize();
+
+    SettleParticle(particle, parentPosition, direction, position, *lastPosition, velocity, thresholdValue, delay);
+
+    *lastGravity = gravity;
+}
+
+/**
+ * @brief 安定化のための物理点の更新
+ *
+ * 重力と風の方向に伸びきった位置に物理点を置き、速度をなくす。
+ *
+ * @param[in]       particle            物理点
+ * @param[in]       parentPosition      1つ前の物理点の位置
+ * @param[in,out]   position            物理点の位置
+ * @param[out]      lastPosition        更新前の位置
+ * @param[out]      velocity            物理点の速度
+ * @param[out]      lastGravity         前回の重力の方向
+ * @param[in]       gravity             重力の方向
+ * @param[in]       windDirection       風の方向
+ * @param[in]       thresholdValue      移動とみなさない値
+ */
+inline void StabilizeParticle(const CubismPhysicsParticle& particle, const CubismVector2& parentPosition,
+    CubismVector2* position, CubismVector2* lastPosition, CubismVector2* velocity, CubismVector2* lastGravity,
+    const CubismVector2& gravity, const CubismVector2& windDirection, csmFloat32 thresholdValue)
+{
+    CubismVector2 force((gravity.X * particle.Acceleration) + windDirection.X,
+                        (gravity.Y * particle.Acceleration) + windDirection.Y);
+
+    *lastPosition = *position;
+    *velocity = CubismVector2(0.0f, 0.0f);
+
+    force.Normalize();
+
+    position->X = parentPosition.X + (force.X * particle.Radius);
+    position->Y = parentPosition.Y + (force.Y * particle.Radius);
+
+    if (CubismMath::AbsF(position->X) < thresholdValue)
+    {
+        position->X = 0.0f;
+    }
+
+    *lastGravity = gravity;
+}
+
+/**
+ * @brief 出力の値の取得
+ *
+ * @param[in]   translation         出力する物理点の1つ前の物理点からの移動量
+ * @param[in]   parentDirection     1つ前の物理点の向き。角度の出力でのみ使用する
+ * @return  出力の値
+ */
+template <CubismPhysicsSource Type>
+csmFloat32 GetOutputValue(const CubismVector2& translation, const CubismVector2& parentDirection);
+
+template <>
+inline csmFloat32 GetOutputValue<CubismPhysicsSource_X>(const CubismVector2& translation, const CubismVector2& /*parentDirection*/)
+{
+    return translation.X;
+}
+
+template <>
+inline csmFloat32 GetOutputValue<CubismPhysicsSource_Y>(const CubismVector2& translation, const CubismVector2& /*parentDirection*/)
+{
+    return translation.Y;
+}
+
+template <>
+inline csmFloat32 GetOutputValue<CubismPhysicsSource_Angle>(const CubismVector2& translation, const CubismVector2& parentDirection)
+{
+    return CubismMath::DirectionToRadian(parentDirection, translation);
+}
+
+/**
+ * @brief 出力先のパラメータの値の更新
+ *
+ * 出力の値をパラメータの範囲に収め、出力の重みでパラメータの値と合成する。
+ *
+ * @param[in,out]   parameterValue          出力先のパラメータの値
+ * @param[in]       parameterValueMinimum   パラメータの最小値
+ * @param[in]       parameterValueMaximum   パラメータの最大値
+ * @param[in]       translation             出力の値
+ * @param[in]       output                  出力
+ */
+inline void UpdateOutputParameterValue(csmFloat32* parameterValue, csmFloat32 parameterValueMinimum, csmFloat32 parameterValueMaximum,
+    csmFloat32 translation, const CubismPhysicsOutput* output)
+{
+    csmFloat32 value = translation * output->Scale;
+
+    if (value < parameterValueMinimum)
+    {
+        value = parameterValueMinimum;
+    }
+    else if (value > parameterValueMaximum)
+    {
+        value = parameterValueMaximum;
+    }
+
+    const csmFloat32 weight = (output->Weight / MaximumWeight);
+
+    if (weight >= 1.0f)
+    {
+        *parameterValue = value;
+    }
+    else
+    {
+        *parameterValue = (*parameterValue * (1.0f - weight)) + (value * weight);
+    }
+}
+
+}}}}
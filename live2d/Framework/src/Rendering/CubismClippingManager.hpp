@@ -14,6 +14,9 @@
 #include "Math/CubismVector2.hpp"
 #include "Math/CubismMatrix44.hpp"
 #include "Model/CubismModel.hpp"
+#include "Utils/CubismTrace.hpp"
+#include "CubismClippingMaskPacker.hpp"
+#include "CubismRenderCommandList.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
@@ -25,6 +28,7 @@ namespace {
 const csmInt32 ColorChannelCount = 4;   // 実験時に1チャンネルの場合は1、RGBだけの場合は3、アルファも含める場合は4
 const csmInt32 ClippingMaskMaxCountOnDefault = 36;  // 通常のフレームバッファ1枚あたりのマスク最大数
 const csmInt32 ClippingMaskMaxCountOnMultiRenderTexture = 32;   // フレームバッファが2枚以上ある場合のフレームバッファ1枚あたりのマスク最大数
+const csmFloat32 PackedLayoutSizeTolerance = 0.15f;  // 詰めて配置する場合に、前回の配置を使い続けるマスクの大きさの変化の割合
 }
 #endif
 
@@ -70,6 +74,16 @@ public:
      */
     void SetupMatrixForHighPrecision(CubismModel& model, csmBool isRightHanded);
 
+    /**
+     * @brief   マスクのレイアウトと行列を更新し、作り直すマスクを描く命令をcommandListに記録する<br>
+     *          グラフィックスAPIは呼ばないため、各バックエンドは記録された命令を再生してマスクを作る
+     *
+     * @param[in]   model         ->  モデルのインスタンス
+     * @param[out]  commandList   ->  命令の記録先
+     * @param[in]   isRightHanded ->  処理が右手系であるか
+     */
+    void RecordMaskCommands(CubismModel& model, CubismRenderCommandList& commandList, csmBool isRightHanded);
+
     /**
      * @brief   マスク作成・描画用の行列を作成する。
      *
@@ -104,6 +118,13 @@ public:
      */
     csmVector<T_ClippingContext*>* GetClippingContextListForDraw();
 
+    /**
+     * @brief   マスクの作成に使用するクリッピングマスクのリストを取得する
+     *
+     * @return  マスクの作成に使用するクリッピングマスクのリスト
+     */
+    csmVector<T_ClippingContext*>* GetClippingContextListForMask();
+
     /**
      *@brief  クリッピングマスクバッファのサイズを取得する
      *
@@ -133,7 +154,75 @@ public:
      */
     void SetClippingMaskBufferSize(csmFloat32 width, csmFloat32 height);
 
+    /**
+     * @brief   保持しているレイアウトとマスクの描画結果を無効にする<br>
+     *          次のフレームで全てのマスクを作り直す。マスク用のバッファを作り直した場合などに呼ぶ
+     */
+    void InvalidateMasks();
+
+    /**
+     * @brief   直前のフレームで、前回の行列とマスクをそのまま使ったクリッピングコンテキストの数を取得する
+     *
+     * @return  再計算を省略したクリッピングコンテキストの数
+     */
+    csmInt32 GetSkippedContextCount() const;
+
+    /**
+     * @brief   直前のフレームで、行列の再計算かマスクの再描画を行ったクリッピングコンテキストの数を取得する
+     *
+     * @return  作り直したクリッピングコンテキストの数
+     */
+    csmInt32 GetRedrawnContextCount() const;
+
+    /**
+     * @brief   マスクの配置方法を設定する<br>
+     *          trueの場合、固定の分割ではなく、マスクされる描画オブジェクトの大きさに合わせた領域をRGBAの各チャンネルとレンダーテクスチャに詰めて配置する
+     *
+     * @param[in]   enable  ->  詰めて配置する場合はtrue
+     */
+    void SetUsingPackedLayout(csmBool enable);
+
+    /**
+     * @brief   マスクを詰めて配置しているかを取得する
+     *
+     * @return  詰めて配置している場合はtrue
+     */
+    csmBool IsUsingPackedLayout() const;
+
 protected:
+    /**
+     * @brief   マスクのレイアウトが前回から変わる場合だけSetupLayoutBoundsを呼ぶ
+     *
+     * @param[in]   usingClipCount  ->  SetupLayoutBoundsに渡す配置するクリッピングコンテキストの数
+     * @return  レイアウトを作り直した場合はtrue
+     */
+    csmBool UpdateLayoutBounds(csmInt32 usingClipCount);
+
+    /**
+     * @brief   クリッピングコンテキストごとに、行列の再計算とマスクの再描画が必要かを判定する<br>
+     *          結果は各コンテキストの_isMatrixDirty、_isMaskDirtyに入る
+     *
+     * @param[in]   model               ->  モデルのインスタンス
+     * @param[in]   isLayoutChanged     ->  レイアウトを作り直した場合はtrue。全てのコンテキストを作り直す
+     * @param[in]   checkMaskDrawables  ->  マスク用の描画オブジェクトの頂点の変化も調べる場合はtrue
+     */
+    void UpdateDirtyContexts(CubismModel& model, csmBool isLayoutChanged, csmBool checkMaskDrawables);
+
+    /**
+     * @brief   使用中のクリッピングコンテキストを、囲み矩形の大きさに合わせて詰めて配置する<br>
+     *          未使用のコンテキストには大きさ0の領域を割り当てる
+     *
+     * @return  全て配置できた場合はtrue
+     */
+    csmBool SetupPackedLayoutBounds();
+
+    /**
+     * @brief   前回詰めて配置したときから囲み矩形の大きさがほとんど変わっていないかを確認する
+     *
+     * @return  前回の配置を使い続けられる場合はtrue
+     */
+    csmBool IsPackedLayoutReusable() const;
+
     T_OffscreenSurface* _currentMaskBuffer; /// オフスクリーンサーフェイスのアドレス
     csmVector<csmBool> _clearedMaskBufferFlags; /// マスクのクリアフラグの配列
 
@@ -147,6 +236,21 @@ protected:
     CubismMatrix44 _tmpMatrixForMask;       ///< マスク計算用の行列
     CubismMatrix44 _tmpMatrixForDraw;       ///< マスク計算用の行列
     csmRectF _tmpBoundsOnModel;       ///< マスク配置計算用の矩形
+
+    csmInt32 _layoutClipCount;              ///< 現在のレイアウトを作ったときのSetupLayoutBoundsの引数。-1なら未作成
+    csmBool _isRightHandedMatrix;           ///< 高精細マスク用の行列を計算したときの座標系
+    csmVector<csmInt32> _maskDrawableIndices;   ///< マスクに使われる描画オブジェクトのインデックス（重複なし）
+    csmVector<csmUint32> _maskVertexRevisions;  ///< 前回調べたときのマスク用描画オブジェクトの頂点の更新番号
+    csmVector<csmInt32> _maskCullingCache;      ///< 前回調べたときのマスク用描画オブジェクトのカリング設定。-1なら未確定
+    csmVector<csmBool> _isMaskDrawableChanged;  ///< 描画オブジェクトのインデックスごとの、今回のフレームで頂点が変化したか
+    csmInt32 _skippedContextCount;          ///< 直前のフレームで作り直しを省略したクリッピングコンテキストの数
+    csmInt32 _redrawnContextCount;          ///< 直前のフレームで作り直したクリッピングコンテキストの数
+
+    csmBool _isUsingPackedLayout;           ///< trueならマスクを大きさに合わせて詰めて配置する
+    csmFloat32 _packedLayoutScale;          ///< 詰めて配置したときのモデル座標1あたりのピクセル数。0なら配置できなかった
+    CubismClippingMaskPacker _maskPacker;   ///< マスクを詰めて配置する処理
+    csmVector<csmFloat32> _packedSizes;     ///< 詰める矩形の幅と高さ(モデル座標系)
+    csmVector<CubismClippingMaskPacker::Cell> _packedCells; ///< 詰めた結果
 };
 
 #include "CubismClippingManager.tpp"
@@ -11,6 +11,12 @@
 template <class T_ClippingContext, class T_OffscreenSurface>
 CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::CubismClippingManager() :
                                                                     _clippingMaskBufferSize(256, 256)
+                                                                    , _layoutClipCount(-1)
+                                                                    , _isRightHandedMatrix(false)
+                                                                    , _skippedContextCount(0)
+                                                                    , _redrawnContextCount(0)
+                                                                    , _isUsingPackedLayout(false)
+                                                                    , _packedLayoutScale(0.0f)
 {
     CubismRenderer::CubismTextureColor* tmp = NULL;
     tmp = CSM_NEW CubismRenderer::CubismTextureColor();
@@ -102,6 +108,35 @@ void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::Initialize(Cu
 
         _clippingContextListForDraw.PushBack(cc);
     }
+
+    // マスクに使われる描画オブジェクトを重複なく集める
+    // 初回は全て変化したものとして扱う
+    _isMaskDrawableChanged.Resize(model.GetDrawableCount(), false);
+
+    for (csmUint32 i = 0; i < _clippingContextListForMask.GetSize(); i++)
+    {
+        const T_ClippingContext* cc = _clippingContextListForMask[i];
+        for (csmInt32 j = 0; j < cc->_clippingIdCount; j++)
+        {
+            const csmInt32 drawableIndex = cc->_clippingIdList[j];
+            if (_isMaskDrawableChanged[drawableIndex])
+            {
+                continue;
+            }
+
+            _isMaskDrawableChanged[drawableIndex] = true;
+            _maskDrawableIndices.PushBack(drawableIndex);
+        }
+    }
+
+    _maskVertexRevisions.Resize(_maskDrawableIndices.GetSize(), 0);
+    _maskCullingCache.Resize(_maskDrawableIndices.GetSize(), -1);
+
+    // マスクを詰めて配置するときの作業領域
+    const csmInt32 contextCount = _clippingContextListForMask.GetSize();
+    _maskPacker.Initialize(_renderTextureCount * ColorChannelCount, contextCount);
+    _packedSizes.Resize(contextCount * 2, 0.0f);
+    _packedCells.Resize(contextCount);
 }
 
 template <class T_ClippingContext, class T_OffscreenSurface>
@@ -139,6 +174,8 @@ T_ClippingContext* CubismClippingManager<T_ClippingContext, T_OffscreenSurface>:
 template <class T_ClippingContext, class T_OffscreenSurface>
 void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::SetupMatrixForHighPrecision(CubismModel& model, csmBool isRightHanded)
 {
+    CSM_TRACE_SCOPE("CubismClippingManager::SetupMatrixForHighPrecision");
+
     // 全てのクリッピングを用意する
     // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
     csmInt32 usingClipCount = 0;
@@ -160,7 +197,15 @@ void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::SetupMatrixFo
         return;
     }
     // マスク行列作成処理
-    SetupLayoutBounds(0);
+    csmBool isLayoutChanged = UpdateLayoutBounds(0);
+    if (_isRightHandedMatrix != isRightHanded)
+    {
+        _isRightHandedMatrix = isRightHanded;
+        isLayoutChanged = true;
+    }
+
+    // マスクは描画ごとに作り直すため、ここでは行列の再計算だけを省略する
+    UpdateDirtyContexts(model, isLayoutChanged, false);
 
     // サイズがレンダーテクスチャの枚数と合わない場合は合わせる
     if (_clearedMaskBufferFlags.GetSize() != _renderTextureCount)
@@ -187,6 +232,13 @@ void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::SetupMatrixFo
     {
         // --- 実際に１つのマスクを描く ---
         T_ClippingContext* clipContext = _clippingContextListForMask[clipIndex];
+
+        // 囲み矩形もレイアウトも前回と同じなら行列はそのまま使える
+        if (!clipContext->_isMatrixDirty)
+        {
+            continue;
+        }
+
         csmRectF* allClippedDrawRect = clipContext->_allClippedDrawRect; //このマスクを使う、全ての描画オブジェクトの論理座標上の囲み矩形
         csmRectF* layoutBoundsOnTex01 = clipContext->_layoutBounds; //この中にマスクを収める
         const csmFloat32 MARGIN = 0.05f;
@@ -228,6 +280,134 @@ void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::SetupMatrixFo
     }
 }
 
+template <class T_ClippingContext, class T_OffscreenSurface>
+void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::RecordMaskCommands(CubismModel& model, CubismRenderCommandList& commandList, csmBool isRightHanded)
+{
+    CSM_TRACE_SCOPE("CubismClippingManager::RecordMaskCommands");
+
+    // 全てのクリッピングを用意する
+    // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
+    csmInt32 usingClipCount = 0;
+    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+    {
+        // １つのクリッピングマスクに関して
+        T_ClippingContext* cc = _clippingContextListForMask[clipIndex];
+
+        // このクリップを利用する描画オブジェクト群全体を囲む矩形を計算
+        CalcClippedDrawTotalBounds(model, cc);
+
+        if (cc->_isUsing)
+        {
+            usingClipCount++; //使用中としてカウント
+        }
+    }
+
+    if (usingClipCount <= 0)
+    {
+        return;
+    }
+
+    // 各マスクのレイアウトを決定していく
+    // レイアウトが前回と同じなら作り直さず、変化のあったマスクだけを描き直す
+    csmBool isLayoutChanged = UpdateLayoutBounds(usingClipCount);
+    if (_isRightHandedMatrix != isRightHanded)
+    {
+        _isRightHandedMatrix = isRightHanded;
+        isLayoutChanged = true;
+    }
+
+    UpdateDirtyContexts(model, isLayoutChanged, true);
+
+    if (_redrawnContextCount <= 0)
+    {
+        // 全てのマスクが前回の描画結果のまま使える
+        return;
+    }
+
+    // サイズがレンダーテクスチャの枚数と合わない場合は合わせる
+    if (static_cast<csmInt32>(_clearedMaskBufferFlags.GetSize()) != _renderTextureCount)
+    {
+        _clearedMaskBufferFlags.Clear();
+
+        for (csmInt32 i = 0; i < _renderTextureCount; ++i)
+        {
+            _clearedMaskBufferFlags.PushBack(false);
+        }
+    }
+    else
+    {
+        // マスクのクリアフラグを毎フレーム開始時に初期化
+        for (csmInt32 i = 0; i < _renderTextureCount; ++i)
+        {
+            _clearedMaskBufferFlags[i] = false;
+        }
+    }
+
+    // 全てのマスクをどの様にレイアウトして描くかを決定し、ClipContext , ClippedDrawContext に記憶する
+    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+    {
+        T_ClippingContext* clipContext = _clippingContextListForMask[clipIndex];
+
+        // 前回から変化がなければ、前回描いたマスクと行列をそのまま使う
+        if (!clipContext->_isMaskDirty)
+        {
+            continue;
+        }
+
+        if (clipContext->_isMatrixDirty)
+        {
+            csmRectF* allClippedDrawRect = clipContext->_allClippedDrawRect; //このマスクを使う、全ての描画オブジェクトの論理座標上の囲み矩形
+            csmRectF* layoutBoundsOnTex01 = clipContext->_layoutBounds; //この中にマスクを収める
+            const csmFloat32 MARGIN = 0.05f;
+
+            // モデル座標上の矩形を、適宜マージンを付けて使う
+            _tmpBoundsOnModel.SetRect(allClippedDrawRect);
+            _tmpBoundsOnModel.Expand(allClippedDrawRect->Width * MARGIN, allClippedDrawRect->Height * MARGIN);
+            //########## 本来は割り当てられた領域の全体を使わず必要最低限のサイズがよい
+            // シェーダ用の計算式を求める。回転を考慮しない場合は以下のとおり
+            // movePeriod' = movePeriod * scaleX + offX     [[ movePeriod' = (movePeriod - tmpBoundsOnModel.movePeriod)*scale + layoutBoundsOnTex01.movePeriod ]]
+            const csmFloat32 scaleX = layoutBoundsOnTex01->Width / _tmpBoundsOnModel.Width;
+            const csmFloat32 scaleY = layoutBoundsOnTex01->Height / _tmpBoundsOnModel.Height;
+
+            // マスク生成時に使う行列を求める
+            createMatrixForMask(isRightHanded, layoutBoundsOnTex01, scaleX, scaleY);
+
+            clipContext->_matrixForMask.SetMatrix(_tmpMatrixForMask.GetArray());
+            clipContext->_matrixForDraw.SetMatrix(_tmpMatrixForDraw.GetArray());
+        }
+
+        // マスクをクリアする
+        if (isLayoutChanged)
+        {
+            // レイアウトが変わった場合はバッファ全体をクリアする
+            if (!_clearedMaskBufferFlags[clipContext->_bufferIndex])
+            {
+                commandList.AddClearMaskBuffer(CubismRenderCommandList::PrePassRenderOrder, clipContext->_bufferIndex);
+                _clearedMaskBufferFlags[clipContext->_bufferIndex] = true;
+            }
+        }
+        else
+        {
+            // このマスクのチャンネルの、割り当てられた領域だけをクリアする
+            commandList.AddClearMask(CubismRenderCommandList::PrePassRenderOrder, clipIndex, clipContext);
+        }
+
+        const csmInt32 clipDrawCount = clipContext->_clippingIdCount;
+        for (csmInt32 i = 0; i < clipDrawCount; i++)
+        {
+            const csmInt32 clipDrawIndex = clipContext->_clippingIdList[i];
+
+            // 頂点情報が更新されておらず、信頼性がない場合は描画をパスする
+            if (!model.GetDrawableDynamicFlagVertexPositionsDidChange(clipDrawIndex))
+            {
+                continue;
+            }
+
+            commandList.AddDrawMask(model, CubismRenderCommandList::PrePassRenderOrder, clipIndex, clipContext, clipDrawIndex);
+        }
+    }
+}
+
 template <class T_ClippingContext, class T_OffscreenSurface>
 void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::createMatrixForMask(csmBool isRightHanded, csmRectF* layoutBoundsOnTex01, csmFloat32 scaleX, csmFloat32 scaleY)
 {
@@ -435,31 +615,17 @@ void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::CalcClippedDr
         // マスクを使用する描画オブジェクトの描画される矩形を求める
         const csmInt32 drawableIndex = (*clippingContext->_clippedDrawableIndexList)[clippedDrawableIndex];
 
-        csmInt32 drawableVertexCount = model.GetDrawableVertexCount(drawableIndex);
-        csmFloat32* drawableVertexes = const_cast<csmFloat32*>(model.GetDrawableVertices(drawableIndex));
-
-        csmFloat32 minX = FLT_MAX, minY = FLT_MAX;
-        csmFloat32 maxX = -FLT_MAX, maxY = -FLT_MAX;
-
-        csmInt32 loop = drawableVertexCount * Constant::VertexStep;
-        for (csmInt32 pi = Constant::VertexOffset; pi < loop; pi += Constant::VertexStep)
-        {
-            csmFloat32 x = drawableVertexes[pi];
-            csmFloat32 y = drawableVertexes[pi + 1];
-            if (x < minX) minX = x;
-            if (x > maxX) maxX = x;
-            if (y < minY) minY = y;
-            if (y > maxY) maxY = y;
-        }
+        // 頂点を囲む矩形はモデルがキャッシュしている
+        const CubismModel::DrawableBounds& bounds = model.GetDrawableBounds(drawableIndex);
 
         //
-        if (minX == FLT_MAX) continue; //有効な点がひとつも取れなかったのでスキップする
+        if (bounds.MinX == FLT_MAX) continue; //有効な点がひとつも取れなかったのでスキップする
 
         // 全体の矩形に反映
-        if (minX < clippedDrawTotalMinX) clippedDrawTotalMinX = minX;
-        if (minY < clippedDrawTotalMinY) clippedDrawTotalMinY = minY;
-        if (maxX > clippedDrawTotalMaxX) clippedDrawTotalMaxX = maxX;
-        if (maxY > clippedDrawTotalMaxY) clippedDrawTotalMaxY = maxY;
+        if (bounds.MinX < clippedDrawTotalMinX) clippedDrawTotalMinX = bounds.MinX;
+        if (bounds.MinY < clippedDrawTotalMinY) clippedDrawTotalMinY = bounds.MinY;
+        if (bounds.MaxX > clippedDrawTotalMaxX) clippedDrawTotalMaxX = bounds.MaxX;
+        if (bounds.MaxY > clippedDrawTotalMaxY) clippedDrawTotalMaxY = bounds.MaxY;
     }
     if (clippedDrawTotalMinX == FLT_MAX)
     {
@@ -487,6 +653,12 @@ csmVector<T_ClippingContext*>* CubismClippingManager<T_ClippingContext, T_Offscr
     return &_clippingContextListForDraw;
 }
 
+template <class T_ClippingContext, class T_OffscreenSurface>
+csmVector<T_ClippingContext*>* CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::GetClippingContextListForMask()
+{
+    return &_clippingContextListForMask;
+}
+
 template <class T_ClippingContext, class T_OffscreenSurface>
 CubismVector2 CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::GetClippingMaskBufferSize() const
 {
@@ -510,3 +682,240 @@ void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::SetClippingMa
 {
     _clippingMaskBufferSize = CubismVector2(width, height);
 }
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::InvalidateMasks()
+{
+    _layoutClipCount = -1;
+}
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+csmInt32 CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::GetSkippedContextCount() const
+{
+    return _skippedContextCount;
+}
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+csmInt32 CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::GetRedrawnContextCount() const
+{
+    return _redrawnContextCount;
+}
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+csmBool CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::UpdateLayoutBounds(csmInt32 usingClipCount)
+{
+    const csmInt32 useClippingMaskMaxCount = _renderTextureCount <= 1
+        ? ClippingMaskMaxCountOnDefault
+        : ClippingMaskMaxCountOnMultiRenderTexture * _renderTextureCount;
+
+    if (_isUsingPackedLayout && usingClipCount > 0)
+    {
+        // 囲み矩形の大きさがほとんど変わらなければ前回の配置を使い続ける
+        // 前回詰めきれなかった場合は、使用中の数が変わるまで固定の分割のままにする
+        if (usingClipCount == _layoutClipCount && (_packedLayoutScale <= 0.0f || IsPackedLayoutReusable()))
+        {
+            return false;
+        }
+
+        if (SetupPackedLayoutBounds())
+        {
+            _layoutClipCount = usingClipCount;
+            return true;
+        }
+    }
+
+    // 上限を超えた場合は全てのマスクが同じ領域を使うため、毎回作り直す
+    if (usingClipCount == _layoutClipCount && usingClipCount <= useClippingMaskMaxCount)
+    {
+        return false;
+    }
+
+    SetupLayoutBounds(usingClipCount);
+    _layoutClipCount = usingClipCount;
+
+    return true;
+}
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::UpdateDirtyContexts(CubismModel& model, csmBool isLayoutChanged, csmBool checkMaskDrawables)
+{
+    if (checkMaskDrawables)
+    {
+        // マスク用の描画オブジェクトが前回から変化したかを調べる
+        for (csmUint32 i = 0; i < _maskDrawableIndices.GetSize(); i++)
+        {
+            const csmInt32 drawableIndex = _maskDrawableIndices[i];
+            csmBool isChanged = false;
+
+            if (!model.GetDrawableDynamicFlagVertexPositionsDidChange(drawableIndex))
+            {
+                // 今回のマスクには描かれないので、次にフラグが立ったときに必ず描き直す
+                _maskCullingCache[i] = -1;
+                _isMaskDrawableChanged[drawableIndex] = false;
+                continue;
+            }
+
+            const csmInt32 culling = model.GetDrawableCulling(drawableIndex);
+            if (_maskCullingCache[i] != culling)
+            {
+                _maskCullingCache[i] = culling;
+                isChanged = true;
+            }
+
+            const csmUint32 vertexRevision = model.GetDrawableVertexRevision(drawableIndex);
+            if (_maskVertexRevisions[i] != vertexRevision)
+            {
+                _maskVertexRevisions[i] = vertexRevision;
+                isChanged = true;
+            }
+
+            _isMaskDrawableChanged[drawableIndex] = isChanged;
+        }
+    }
+
+    _skippedContextCount = 0;
+    _redrawnContextCount = 0;
+
+    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
+    {
+        T_ClippingContext* cc = _clippingContextListForMask[clipIndex];
+        const csmRectF* rect = cc->_allClippedDrawRect;
+
+        // 囲み矩形かレイアウトが変わった場合は行列を計算し直す
+        const csmBool isRectChanged = rect->X != cc->_lastClippedDrawRect.X
+            || rect->Y != cc->_lastClippedDrawRect.Y
+            || rect->Width != cc->_lastClippedDrawRect.Width
+            || rect->Height != cc->_lastClippedDrawRect.Height;
+
+        if (isRectChanged)
+        {
+            cc->_lastClippedDrawRect.SetRect(cc->_allClippedDrawRect);
+        }
+
+        cc->_isMatrixDirty = isLayoutChanged || isRectChanged;
+        cc->_isMaskDirty = cc->_isMatrixDirty;
+
+        // 行列が同じでも、マスク用の描画オブジェクトが変化していれば描き直す
+        for (csmInt32 i = 0; checkMaskDrawables && !cc->_isMaskDirty && i < cc->_clippingIdCount; i++)
+        {
+            cc->_isMaskDirty = _isMaskDrawableChanged[cc->_clippingIdList[i]];
+        }
+
+        if (cc->_isMaskDirty)
+        {
+            _redrawnContextCount++;
+        }
+        else
+        {
+            _skippedContextCount++;
+        }
+    }
+}
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+void CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::SetUsingPackedLayout(csmBool enable)
+{
+    if (_isUsingPackedLayout == enable)
+    {
+        return;
+    }
+
+    _isUsingPackedLayout = enable;
+    InvalidateMasks();
+}
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+csmBool CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::IsUsingPackedLayout() const
+{
+    return _isUsingPackedLayout;
+}
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+csmBool CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::SetupPackedLayoutBounds()
+{
+    const csmInt32 bufferWidth = static_cast<csmInt32>(_clippingMaskBufferSize.X);
+    const csmInt32 bufferHeight = static_cast<csmInt32>(_clippingMaskBufferSize.Y);
+
+    csmInt32 count = 0;
+    for (csmUint32 index = 0; index < _clippingContextListForMask.GetSize(); index++)
+    {
+        const T_ClippingContext* cc = _clippingContextListForMask[index];
+        if (!cc->_isUsing)
+        {
+            continue;
+        }
+
+        _packedSizes[count * 2] = cc->_allClippedDrawRect->Width;
+        _packedSizes[count * 2 + 1] = cc->_allClippedDrawRect->Height;
+        count++;
+    }
+
+    _packedLayoutScale = _maskPacker.PackScaled(bufferWidth, bufferHeight, _packedSizes.GetPtr(), count, _packedCells.GetPtr());
+    if (_packedLayoutScale <= 0.0f)
+    {
+        CubismLogWarning("mask packing failed, falling back to the fixed layout. mask count : %d", count);
+        return false;
+    }
+
+    csmInt32 cellIndex = 0;
+    for (csmUint32 index = 0; index < _clippingContextListForMask.GetSize(); index++)
+    {
+        T_ClippingContext* cc = _clippingContextListForMask[index];
+        if (!cc->_isUsing)
+        {
+            cc->_layoutChannelIndex = 0;
+            cc->_layoutBounds->X = 0.0f;
+            cc->_layoutBounds->Y = 0.0f;
+            cc->_layoutBounds->Width = 0.0f;
+            cc->_layoutBounds->Height = 0.0f;
+            cc->_bufferIndex = 0;
+            continue;
+        }
+
+        const CubismClippingMaskPacker::Cell& cell = _packedCells[cellIndex++];
+        cc->_layoutChannelIndex = cell.BinIndex % ColorChannelCount;
+        cc->_bufferIndex = cell.BinIndex / ColorChannelCount;
+        cc->_layoutBounds->X = static_cast<csmFloat32>(cell.X) / bufferWidth;
+        cc->_layoutBounds->Y = static_cast<csmFloat32>(cell.Y) / bufferHeight;
+        cc->_layoutBounds->Width = static_cast<csmFloat32>(cell.Width) / bufferWidth;
+        cc->_layoutBounds->Height = static_cast<csmFloat32>(cell.Height) / bufferHeight;
+    }
+
+    return true;
+}
+
+template <class T_ClippingContext, class T_OffscreenSurface>
+csmBool CubismClippingManager<T_ClippingContext, T_OffscreenSurface>::IsPackedLayoutReusable() const
+{
+    for (csmUint32 index = 0; index < _clippingContextListForMask.GetSize(); index++)
+    {
+        const T_ClippingContext* cc = _clippingContextListForMask[index];
+
+        // 使用中かどうかが変わったコンテキストがあれば配置し直す
+        if (cc->_isUsing != (cc->_layoutBounds->Width > 0.0f))
+        {
+            return false;
+        }
+
+        if (!cc->_isUsing)
+        {
+            continue;
+        }
+
+        // 今の大きさで詰めた場合の領域と、割り当て済みの領域を比べる
+        const csmFloat32 cellWidth = cc->_layoutBounds->Width * _clippingMaskBufferSize.X;
+        const csmFloat32 cellHeight = cc->_layoutBounds->Height * _clippingMaskBufferSize.Y;
+        csmInt32 width = 0;
+        csmInt32 height = 0;
+        CubismClippingMaskPacker::CalculateCellSize(static_cast<csmInt32>(_clippingMaskBufferSize.X), static_cast<csmInt32>(_clippingMaskBufferSize.Y),
+            cc->_allClippedDrawRect->Width, cc->_allClippedDrawRect->Height, _packedLayoutScale, width, height);
+
+        if (width > cellWidth * (1.0f + PackedLayoutSizeTolerance) || width < cellWidth * (1.0f - PackedLayoutSizeTolerance) ||
+            height > cellHeight * (1.0f + PackedLayoutSizeTolerance) || height < cellHeight * (1.0f - PackedLayoutSizeTolerance))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,293 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismClippingMaskPacker.hpp"
+#include <float.h>
+#include <math.h>
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+namespace {
+const csmInt32 ScaleSearchSteps = 20;    // 倍率を二分探索する回数
+}
+
+CubismClippingMaskPacker::CubismClippingMaskPacker()
+    : _binCount(0)
+    , _maxNodeCount(0)
+{
+}
+
+void CubismClippingMaskPacker::Initialize(csmInt32 binCount, csmInt32 maxItemCount)
+{
+    // 矩形を1つ置くごとに区間は高々1つしか増えない。挿入中に一時的に1つ多くなる分も確保する
+    _binCount = binCount;
+    _maxNodeCount = maxItemCount + 2;
+
+    _nodes.Resize(_binCount * _maxNodeCount);
+    _nodeCounts.Resize(_binCount, 0);
+    _order.Resize(maxItemCount, 0);
+}
+
+csmFloat32 CubismClippingMaskPacker::PackScaled(csmInt32 binWidth, csmInt32 binHeight, const csmFloat32* sizes, csmInt32 count, Cell* cells)
+{
+    if (count <= 0)
+    {
+        return 0.0f;
+    }
+
+    // 箱より大きくなる矩形は縦横比を保って箱に収まる大きさで止めるので、
+    // 倍率の上限は全ての矩形が止まる倍率になる
+    csmFloat32 upperScale = 0.0f;
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        const csmFloat32 itemScale = GetMaxItemScale(binWidth, binHeight, sizes[i * 2], sizes[i * 2 + 1]);
+        if (itemScale > upperScale)
+        {
+            upperScale = itemScale;
+        }
+    }
+
+    if (upperScale <= 0.0f)
+    {
+        // 全ての矩形の大きさが0
+        upperScale = 1.0f;
+    }
+
+    // 収まる倍率と収まらない倍率の間を二分探索する
+    csmFloat32 lowerScale = 0.0f;
+    if (!PackWithScale(binWidth, binHeight, sizes, count, cells, upperScale))
+    {
+        for (csmInt32 step = 0; step < ScaleSearchSteps; ++step)
+        {
+            const csmFloat32 scale = (lowerScale + upperScale) * 0.5f;
+            if (PackWithScale(binWidth, binHeight, sizes, count, cells, scale))
+            {
+                lowerScale = scale;
+            }
+            else
+            {
+                upperScale = scale;
+            }
+        }
+
+        // 最後に収まった倍率で詰め直す
+        if (lowerScale <= 0.0f || !PackWithScale(binWidth, binHeight, sizes, count, cells, lowerScale))
+        {
+            return 0.0f;
+        }
+
+        return lowerScale;
+    }
+
+    return upperScale;
+}
+
+csmBool CubismClippingMaskPacker::PackWithScale(csmInt32 binWidth, csmInt32 binHeight, const csmFloat32* sizes, csmInt32 count, Cell* cells, csmFloat32 scale)
+{
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        CalculateCellSize(binWidth, binHeight, sizes[i * 2], sizes[i * 2 + 1], scale, cells[i].Width, cells[i].Height);
+    }
+
+    return Pack(binWidth, binHeight, cells, count);
+}
+
+void CubismClippingMaskPacker::CalculateCellSize(csmInt32 binWidth, csmInt32 binHeight, csmFloat32 width, csmFloat32 height, csmFloat32 scale, csmInt32& cellWidth, csmInt32& cellHeight)
+{
+    const csmFloat32 itemScale = GetMaxItemScale(binWidth, binHeight, width, height);
+    const csmFloat32 cellScale = (itemScale > 0.0f && itemScale < scale) ? itemScale : scale;
+
+    // 1ピクセル未満の矩形も1ピクセルは確保する
+    cellWidth = static_cast<csmInt32>(ceilf(width * cellScale));
+    cellHeight = static_cast<csmInt32>(ceilf(height * cellScale));
+    if (cellWidth < 1) cellWidth = 1;
+    if (cellHeight < 1) cellHeight = 1;
+    if (cellWidth > binWidth) cellWidth = binWidth;
+    if (cellHeight > binHeight) cellHeight = binHeight;
+}
+
+csmFloat32 CubismClippingMaskPacker::GetMaxItemScale(csmInt32 binWidth, csmInt32 binHeight, csmFloat32 width, csmFloat32 height)
+{
+    csmFloat32 scale = FLT_MAX;
+    if (width > 0.0f)
+    {
+        scale = static_cast<csmFloat32>(binWidth) / width;
+    }
+    if (height > 0.0f && static_cast<csmFloat32>(binHeight) / height < scale)
+    {
+        scale = static_cast<csmFloat32>(binHeight) / height;
+    }
+
+    // 大きさが0の矩形は倍率によらず1ピクセルになる
+    return (scale == FLT_MAX) ? 0.0f : scale;
+}
+
+csmBool CubismClippingMaskPacker::Pack(csmInt32 binWidth, csmInt32 binHeight, Cell* cells, csmInt32 count)
+{
+    if (count > static_cast<csmInt32>(_order.GetSize()) || _binCount <= 0)
+    {
+        return false;
+    }
+
+    // 高さ、幅の順に大きいものから置く。同じ大きさなら元の順番を保つ
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        csmInt32 j = i;
+        while (j > 0)
+        {
+            const Cell& previous = cells[_order[j - 1]];
+            if (previous.Height > cells[i].Height ||
+                (previous.Height == cells[i].Height && previous.Width >= cells[i].Width))
+            {
+                break;
+            }
+            _order[j] = _order[j - 1];
+            --j;
+        }
+        _order[j] = i;
+    }
+
+    for (csmInt32 bin = 0; bin < _binCount; ++bin)
+    {
+        SkylineNode& node = _nodes[bin * _maxNodeCount];
+        node.X = 0;
+        node.Y = 0;
+        node.Width = binWidth;
+        _nodeCounts[bin] = 1;
+    }
+
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        Cell& cell = cells[_order[i]];
+
+        // 全ての箱の中で、置いたときの上端が一番低くなる位置を選ぶ
+        csmInt32 bestBin = -1;
+        csmInt32 bestIndex = -1;
+        csmInt32 bestTop = binHeight + 1;
+        csmInt32 bestX = 0;
+        for (csmInt32 bin = 0; bin < _binCount; ++bin)
+        {
+            for (csmInt32 index = 0; index < _nodeCounts[bin]; ++index)
+            {
+                const csmInt32 y = FindPosition(bin, index, cell.Width, cell.Height, binWidth, binHeight);
+                if (y < 0)
+                {
+                    continue;
+                }
+
+                const csmInt32 x = _nodes[bin * _maxNodeCount + index].X;
+                const csmInt32 top = y + cell.Height;
+                if (top < bestTop || (top == bestTop && bin == bestBin && x < bestX))
+                {
+                    bestBin = bin;
+                    bestIndex = index;
+                    bestTop = top;
+                    bestX = x;
+                }
+            }
+        }
+
+        if (bestBin < 0)
+        {
+            return false;
+        }
+
+        cell.X = bestX;
+        cell.Y = bestTop - cell.Height;
+        cell.BinIndex = bestBin;
+        Place(bestBin, bestIndex, cell.Width, bestTop);
+    }
+
+    return true;
+}
+
+csmInt32 CubismClippingMaskPacker::FindPosition(csmInt32 bin, csmInt32 index, csmInt32 width, csmInt32 height, csmInt32 binWidth, csmInt32 binHeight) const
+{
+    const SkylineNode* nodes = &_nodes[bin * _maxNodeCount];
+    const csmInt32 nodeCount = _nodeCounts[bin];
+
+    if (nodes[index].X + width > binWidth)
+    {
+        return -1;
+    }
+
+    // 矩形の幅にかかる区間の中で一番高いところに置く
+    csmInt32 y = 0;
+    csmInt32 remainingWidth = width;
+    for (csmInt32 i = index; remainingWidth > 0 && i < nodeCount; ++i)
+    {
+        if (nodes[i].Y > y)
+        {
+            y = nodes[i].Y;
+        }
+        if (y + height > binHeight)
+        {
+            return -1;
+        }
+        remainingWidth -= nodes[i].Width;
+    }
+
+    return y;
+}
+
+void CubismClippingMaskPacker::Place(csmInt32 bin, csmInt32 index, csmInt32 width, csmInt32 top)
+{
+    SkylineNode* nodes = &_nodes[bin * _maxNodeCount];
+    csmInt32& nodeCount = _nodeCounts[bin];
+
+    // 置いた矩形の上端を新しい区間として挿入する
+    const csmInt32 left = nodes[index].X;
+    for (csmInt32 i = nodeCount; i > index; --i)
+    {
+        nodes[i] = nodes[i - 1];
+    }
+    nodes[index].X = left;
+    nodes[index].Y = top;
+    nodes[index].Width = width;
+    ++nodeCount;
+
+    // 新しい区間に隠れた区間を縮めるか取り除く
+    const csmInt32 right = left + width;
+    csmInt32 next = index + 1;
+    while (next < nodeCount && nodes[next].X < right)
+    {
+        const csmInt32 nodeRight = nodes[next].X + nodes[next].Width;
+        if (nodeRight <= right)
+        {
+            for (csmInt32 i = next; i < nodeCount - 1; ++i)
+            {
+                nodes[i] = nodes[i + 1];
+            }
+            --nodeCount;
+            continue;
+        }
+
+        nodes[next].Width = nodeRight - right;
+        nodes[next].X = right;
+        break;
+    }
+
+    // 同じ高さで隣り合う区間をまとめる
+    for (csmInt32 i = 0; i < nodeCount - 1;)
+    {
+        if (nodes[i].Y == nodes[i + 1].Y)
+        {
+            nodes[i].Width += nodes[i + 1].Width;
+            for (csmInt32 j = i + 1; j < nodeCount - 1; ++j)
+            {
+                nodes[j] = nodes[j + 1];
+            }
+            --nodeCount;
+            continue;
+        }
+        ++i;
+    }
+}
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
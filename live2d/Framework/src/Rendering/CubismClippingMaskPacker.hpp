@@ -0,0 +1,132 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+/**
+ * @brief   クリッピングマスクをマスク用テクスチャに詰めて配置する<br>
+ *           マスク用テクスチャのRGBAの各チャンネルを1つの箱として扱い、スカイライン法(Bottom-Left)で矩形を詰める
+ */
+class CubismClippingMaskPacker
+{
+public:
+    /**
+     * @brief   矩形の配置先
+     */
+    struct Cell
+    {
+        csmInt32 X;         ///< 左端のピクセル位置
+        csmInt32 Y;         ///< 下端のピクセル位置
+        csmInt32 Width;     ///< 幅(ピクセル)
+        csmInt32 Height;    ///< 高さ(ピクセル)
+        csmInt32 BinIndex;  ///< 配置先の箱。レンダーテクスチャのインデックス * 4 + チャンネル
+    };
+
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismClippingMaskPacker();
+
+    /**
+     * @brief   作業領域を確保する<br>
+     *           詰める処理の中では確保しない
+     *
+     * @param[in]   binCount        ->  箱の数(レンダーテクスチャの枚数 * チャンネル数)
+     * @param[in]   maxItemCount    ->  一度に詰める矩形の最大数
+     */
+    void Initialize(csmInt32 binCount, csmInt32 maxItemCount);
+
+    /**
+     * @brief   モデル座標系の大きさを同じ倍率で拡大し、全てが収まるできるだけ大きな倍率で詰める<br>
+     *           箱より大きくなる矩形は、縦横比を保って箱に収まる大きさで止める
+     *
+     * @param[in]   binWidth    ->  箱の幅(ピクセル)
+     * @param[in]   binHeight   ->  箱の高さ(ピクセル)
+     * @param[in]   sizes       ->  矩形の幅と高さを交互に並べた配列(モデル座標系)
+     * @param[in]   count       ->  矩形の数
+     * @param[out]  cells       ->  矩形ごとの配置先。count個の領域が必要
+     * @return  詰めたときの倍率(モデル座標1あたりのピクセル数)。収まらない場合は0
+     */
+    csmFloat32 PackScaled(csmInt32 binWidth, csmInt32 binHeight, const csmFloat32* sizes, csmInt32 count, Cell* cells);
+
+    /**
+     * @brief   ピクセル単位の大きさが決まった矩形を詰める<br>
+     *           cellsのWidthとHeightに大きさを入れて呼ぶ
+     *
+     * @param[in]       binWidth    ->  箱の幅(ピクセル)
+     * @param[in]       binHeight   ->  箱の高さ(ピクセル)
+     * @param[in,out]   cells       ->  矩形の大きさと、配置先
+     * @param[in]       count       ->  矩形の数
+     * @return  全て収まった場合はtrue
+     */
+    csmBool Pack(csmInt32 binWidth, csmInt32 binHeight, Cell* cells, csmInt32 count);
+
+    /**
+     * @brief   PackScaledが倍率scaleのときに割り当てる領域の大きさを求める
+     *
+     * @param[in]   binWidth    ->  箱の幅(ピクセル)
+     * @param[in]   binHeight   ->  箱の高さ(ピクセル)
+     * @param[in]   width       ->  矩形の幅(モデル座標系)
+     * @param[in]   height      ->  矩形の高さ(モデル座標系)
+     * @param[in]   scale       ->  倍率
+     * @param[out]  cellWidth   ->  領域の幅(ピクセル)
+     * @param[out]  cellHeight  ->  領域の高さ(ピクセル)
+     */
+    static void CalculateCellSize(csmInt32 binWidth, csmInt32 binHeight, csmFloat32 width, csmFloat32 height, csmFloat32 scale, csmInt32& cellWidth, csmInt32& cellHeight);
+
+private:
+    /**
+     * @brief   倍率scaleで大きさを決めて詰める
+     *
+     * @return  全て収まった場合はtrue
+     */
+    csmBool PackWithScale(csmInt32 binWidth, csmInt32 binHeight, const csmFloat32* sizes, csmInt32 count, Cell* cells, csmFloat32 scale);
+
+    /**
+     * @brief   矩形が1つの箱に収まる最大の倍率を求める
+     *
+     * @return  倍率。大きさが0の場合は0
+     */
+    static csmFloat32 GetMaxItemScale(csmInt32 binWidth, csmInt32 binHeight, csmFloat32 width, csmFloat32 height);
+
+    /**
+     * @brief   スカイラインの1区間
+     */
+    struct SkylineNode
+    {
+        csmInt32 X;         ///< 区間の左端
+        csmInt32 Y;         ///< 区間の高さ
+        csmInt32 Width;     ///< 区間の幅
+    };
+
+    /**
+     * @brief   箱の区間indexから幅widthの矩形を置いたときの下端を求める
+     *
+     * @return  置ける場合は下端の位置、置けない場合は-1
+     */
+    csmInt32 FindPosition(csmInt32 bin, csmInt32 index, csmInt32 width, csmInt32 height, csmInt32 binWidth, csmInt32 binHeight) const;
+
+    /**
+     * @brief   箱の区間indexの位置に矩形を置いてスカイラインを更新する
+     */
+    void Place(csmInt32 bin, csmInt32 index, csmInt32 width, csmInt32 y);
+
+    csmInt32 _binCount;                 ///< 箱の数
+    csmInt32 _maxNodeCount;             ///< 箱1つあたりのスカイラインの区間の最大数
+    csmVector<SkylineNode> _nodes;      ///< 箱ごとのスカイライン。箱ごとに_maxNodeCount個ずつ使う
+    csmVector<csmInt32> _nodeCounts;    ///< 箱ごとのスカイラインの区間の数
+    csmVector<csmInt32> _order;         ///< 詰める順番(大きい順)
+};
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
@@ -0,0 +1,226 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismDrawBatcher.hpp"
+#include "Utils/CubismTrace.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+CubismDrawBatcher::CubismDrawBatcher()
+{
+}
+
+CubismDrawBatcher::~CubismDrawBatcher()
+{
+}
+
+void CubismDrawBatcher::Build(const CubismModel& model, const CubismRenderer& renderer, const CubismRenderCommandList& commandList)
+{
+    CSM_TRACE_SCOPE("CubismDrawBatcher::Build");
+
+    // 要素数だけを0にし、確保済みの領域は使い回す
+    _batches.Resize(0);
+    _positions.Resize(0);
+    _uvs.Resize(0);
+    _baseColors.Resize(0);
+    _multiplyColors.Resize(0);
+    _screenColors.Resize(0);
+    _indices.Resize(0);
+
+    const csmInt32 commandCount = commandList.GetCommandCount();
+    csmInt32 commandIndex = 0;
+
+    while (commandIndex < commandCount)
+    {
+        const CubismRenderCommandList::Command& first = commandList.GetCommand(commandIndex);
+
+        Batch batch;
+        batch.FirstCommand = commandIndex;
+        batch.CommandCount = 1;
+        batch.VertexOffset = 0;
+        batch.VertexCount = 0;
+        batch.IndexOffset = 0;
+        batch.IndexCount = 0;
+        batch.HasVertexColors = false;
+
+        if (first.Type == CubismRenderCommandList::CommandType_Draw || first.Type == CubismRenderCommandList::CommandType_DrawMask)
+        {
+            // 続けてまとめられる範囲を探す
+            csmInt32 vertexCount = model.GetDrawableVertexCount(first.DrawableIndex);
+            csmInt32 end = commandIndex + 1;
+
+            for (; end < commandCount; ++end)
+            {
+                const CubismRenderCommandList::Command& next = commandList.GetCommand(end);
+
+                if (!CanMerge(first, next))
+                {
+                    break;
+                }
+
+                const csmInt32 nextVertexCount = model.GetDrawableVertexCount(next.DrawableIndex);
+                if (vertexCount + nextVertexCount > MaxVertexCount)
+                {
+                    break;
+                }
+
+                // マスクの作成では色を使わない
+                if (first.Type == CubismRenderCommandList::CommandType_Draw && !batch.HasVertexColors
+                    && !IsSameColor(model, first.DrawableIndex, next.DrawableIndex))
+                {
+                    batch.HasVertexColors = true;
+                }
+
+                vertexCount += nextVertexCount;
+            }
+
+            batch.CommandCount = end - commandIndex;
+
+            if (batch.CommandCount > 1)
+            {
+                batch.VertexOffset = _positions.GetSize() / 2;
+                batch.IndexOffset = _indices.GetSize();
+
+                for (csmInt32 i = commandIndex; i < end; ++i)
+                {
+                    const csmInt32 baseVertex = _positions.GetSize() / 2 - batch.VertexOffset;
+                    AppendDrawable(model, renderer, commandList.GetCommand(i).DrawableIndex, baseVertex, batch.HasVertexColors);
+                }
+
+                batch.VertexCount = _positions.GetSize() / 2 - batch.VertexOffset;
+                batch.IndexCount = _indices.GetSize() - batch.IndexOffset;
+            }
+            else
+            {
+                batch.HasVertexColors = false;
+            }
+        }
+
+        _batches.PushBack(batch);
+        commandIndex += batch.CommandCount;
+    }
+}
+
+csmInt32 CubismDrawBatcher::GetBatchCount() const
+{
+    return _batches.GetSize();
+}
+
+const CubismDrawBatcher::Batch& CubismDrawBatcher::GetBatch(csmInt32 index) const
+{
+    return _batches[index];
+}
+
+const csmFloat32* CubismDrawBatcher::GetVertexPositions() const
+{
+    return _positions.GetPtr();
+}
+
+const csmFloat32* CubismDrawBatcher::GetVertexUvs() const
+{
+    return _uvs.GetPtr();
+}
+
+const csmFloat32* CubismDrawBatcher::GetVertexBaseColors() const
+{
+    return _baseColors.GetPtr();
+}
+
+const csmFloat32* CubismDrawBatcher::GetVertexMultiplyColors() const
+{
+    return _multiplyColors.GetPtr();
+}
+
+const csmFloat32* CubismDrawBatcher::GetVertexScreenColors() const
+{
+    return _screenColors.GetPtr();
+}
+
+const csmUint16* CubismDrawBatcher::GetIndices() const
+{
+    return _indices.GetPtr();
+}
+
+csmBool CubismDrawBatcher::CanMerge(const CubismRenderCommandList::Command& first, const CubismRenderCommandList::Command& next)
+{
+    return next.Type == first.Type
+        && next.ClipContext == first.ClipContext
+        && next.BufferIndex == first.BufferIndex
+        && next.ShaderVariant == first.ShaderVariant
+        && next.BlendMode == first.BlendMode
+        && next.TextureIndex == first.TextureIndex
+        && next.IsCulling == first.IsCulling;
+}
+
+csmBool CubismDrawBatcher::IsSameColor(const CubismModel& model, csmInt32 first, csmInt32 next) const
+{
+    if (model.GetDrawableOpacity(first) != model.GetDrawableOpacity(next))
+    {
+        return false;
+    }
+
+    const CubismRenderer::CubismTextureColor firstMultiply = model.GetMultiplyColor(first);
+    const CubismRenderer::CubismTextureColor nextMultiply = model.GetMultiplyColor(next);
+    const CubismRenderer::CubismTextureColor firstScreen = model.GetScreenColor(first);
+    const CubismRenderer::CubismTextureColor nextScreen = model.GetScreenColor(next);
+
+    return firstMultiply.R == nextMultiply.R && firstMultiply.G == nextMultiply.G
+        && firstMultiply.B == nextMultiply.B && firstMultiply.A == nextMultiply.A
+        && firstScreen.R == nextScreen.R && firstScreen.G == nextScreen.G
+        && firstScreen.B == nextScreen.B && firstScreen.A == nextScreen.A;
+}
+
+void CubismDrawBatcher::AppendDrawable(const CubismModel& model, const CubismRenderer& renderer, csmInt32 drawableIndex, csmInt32 baseVertex, csmBool hasVertexColors)
+{
+    const csmInt32 vertexCount = model.GetDrawableVertexCount(drawableIndex);
+    const csmFloat32* positions = model.GetDrawableVertices(drawableIndex);
+    const csmFloat32* uvs = reinterpret_cast<const csmFloat32*>(model.GetDrawableVertexUvs(drawableIndex));
+
+    for (csmInt32 i = 0; i < vertexCount * 2; ++i)
+    {
+        _positions.PushBack(positions[i]);
+        _uvs.PushBack(uvs[i]);
+    }
+
+    const csmInt32 indexCount = model.GetDrawableVertexIndexCount(drawableIndex);
+    const csmUint16* indices = model.GetDrawableVertexIndices(drawableIndex);
+
+    for (csmInt32 i = 0; i < indexCount; ++i)
+    {
+        _indices.PushBack(static_cast<csmUint16>(indices[i] + baseVertex));
+    }
+
+    if (hasVertexColors)
+    {
+        AppendColor(_baseColors, renderer.GetModelColorWithOpacity(model.GetDrawableOpacity(drawableIndex)), vertexCount);
+        AppendColor(_multiplyColors, model.GetMultiplyColor(drawableIndex), vertexCount);
+        AppendColor(_screenColors, model.GetScreenColor(drawableIndex), vertexCount);
+    }
+    else
+    {
+        // 頂点ごとの色を使わない描画でも、頂点の番号が色の列とずれないように埋める
+        _baseColors.Resize(_positions.GetSize() * 2);
+        _multiplyColors.Resize(_positions.GetSize() * 2);
+        _screenColors.Resize(_positions.GetSize() * 2);
+    }
+}
+
+void CubismDrawBatcher::AppendColor(csmVector<csmFloat32>& colors, const CubismRenderer::CubismTextureColor& color, csmInt32 vertexCount)
+{
+    for (csmInt32 i = 0; i < vertexCount; ++i)
+    {
+        colors.PushBack(color.R);
+        colors.PushBack(color.G);
+        colors.PushBack(color.B);
+        colors.PushBack(color.A);
+    }
+}
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
@@ -0,0 +1,140 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "CubismRenderer.hpp"
+#include "CubismRenderCommandList.hpp"
+#include "Type/csmVector.hpp"
+#include "Model/CubismModel.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+/**
+ * @brief   描画命令を並べ替えた後のリストから、まとめて描ける描画オブジェクトを探し、1つの頂点列とインデックス列に結合する<br>
+ *           命令の種類・マスク・シェーダ・ブレンドモード・テクスチャ・カリングが同じで連続している描画オブジェクトをまとめる。
+ *           1回の描画命令の中でもポリゴンは順に合成されるため、描画順は変わらない。<br>
+ *           不透明度・乗算色・スクリーン色がまとめた中で異なる場合は、頂点ごとの色として出力する
+ */
+class CubismDrawBatcher
+{
+public:
+    /**
+     * @brief   まとめた描画
+     */
+    struct Batch
+    {
+        csmInt32 FirstCommand;      ///< 先頭の命令の番号
+        csmInt32 CommandCount;      ///< まとめた命令の数。1ならまとめておらず、頂点列は作らない
+        csmInt32 VertexOffset;      ///< 結合した頂点列での先頭の頂点
+        csmInt32 VertexCount;       ///< 頂点の数
+        csmInt32 IndexOffset;       ///< 結合したインデックス列での先頭の位置
+        csmInt32 IndexCount;        ///< インデックスの数
+        csmBool HasVertexColors;    ///< trueなら色を頂点ごとに使う。falseなら先頭の描画オブジェクトの色をそのまま使える
+    };
+
+    static const csmInt32 MaxVertexCount = 65536;   ///< 1つにまとめる頂点の上限。インデックスを16bitで表せる数
+
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismDrawBatcher();
+
+    /**
+     * @brief   デストラクタ
+     */
+    virtual ~CubismDrawBatcher();
+
+    /**
+     * @brief   命令のリストからまとめた描画を作る。確保したメモリは次のフレームで使い回す
+     *
+     * @param[in]   model       ->  モデルのインスタンス
+     * @param[in]   renderer    ->  モデルの色と乗算済みアルファの設定を取得するレンダラ
+     * @param[in]   commandList ->  並べ替え済みの命令のリスト
+     */
+    void Build(const CubismModel& model, const CubismRenderer& renderer, const CubismRenderCommandList& commandList);
+
+    /**
+     * @brief   まとめた描画の数を取得する
+     *
+     * @return  まとめた描画の数
+     */
+    csmInt32 GetBatchCount() const;
+
+    /**
+     * @brief   まとめた描画を取得する。命令の順に並び、全ての命令がいずれか1つに含まれる
+     *
+     * @param[in]   index   ->  まとめた描画の番号
+     * @return  まとめた描画
+     */
+    const Batch& GetBatch(csmInt32 index) const;
+
+    /**
+     * @brief   結合した頂点座標(x, y)を取得する
+     */
+    const csmFloat32* GetVertexPositions() const;
+
+    /**
+     * @brief   結合したUV(u, v)を取得する
+     */
+    const csmFloat32* GetVertexUvs() const;
+
+    /**
+     * @brief   結合した頂点ごとのベースカラー(r, g, b, a)を取得する。HasVertexColorsの描画だけ有効
+     */
+    const csmFloat32* GetVertexBaseColors() const;
+
+    /**
+     * @brief   結合した頂点ごとの乗算色(r, g, b, a)を取得する。HasVertexColorsの描画だけ有効
+     */
+    const csmFloat32* GetVertexMultiplyColors() const;
+
+    /**
+     * @brief   結合した頂点ごとのスクリーン色(r, g, b, a)を取得する。HasVertexColorsの描画だけ有効
+     */
+    const csmFloat32* GetVertexScreenColors() const;
+
+    /**
+     * @brief   結合したインデックスを取得する。値はまとめた描画の先頭の頂点からの番号
+     */
+    const csmUint16* GetIndices() const;
+
+private:
+    /**
+     * @brief   2つの命令をまとめて描けるかを判定する
+     */
+    static csmBool CanMerge(const CubismRenderCommandList::Command& first, const CubismRenderCommandList::Command& next);
+
+    /**
+     * @brief   2つの描画オブジェクトの色が同じかを判定する
+     */
+    csmBool IsSameColor(const CubismModel& model, csmInt32 first, csmInt32 next) const;
+
+    /**
+     * @brief   描画オブジェクトの頂点とインデックスを結合した列の末尾に追加する
+     */
+    void AppendDrawable(const CubismModel& model, const CubismRenderer& renderer, csmInt32 drawableIndex, csmInt32 baseVertex, csmBool hasVertexColors);
+
+    /**
+     * @brief   色を頂点の数だけ追加する
+     */
+    static void AppendColor(csmVector<csmFloat32>& colors, const CubismRenderer::CubismTextureColor& color, csmInt32 vertexCount);
+
+    csmVector<Batch> _batches;                  ///< まとめた描画
+    csmVector<csmFloat32> _positions;           ///< 結合した頂点座標
+    csmVector<csmFloat32> _uvs;                 ///< 結合したUV
+    csmVector<csmFloat32> _baseColors;          ///< 結合した頂点ごとのベースカラー
+    csmVector<csmFloat32> _multiplyColors;      ///< 結合した頂点ごとの乗算色
+    csmVector<csmFloat32> _screenColors;        ///< 結合した頂点ごとのスクリーン色
+    csmVector<csmUint16> _indices;              ///< 結合したインデックス
+};
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
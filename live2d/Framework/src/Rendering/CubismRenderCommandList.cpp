@@ -0,0 +1,238 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismRenderCommandList.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+namespace {
+
+// ソートキーの各フィールドのビット位置と幅
+const csmUint32 GroupShift = 48;
+const csmUint64 GroupMask = 0xFFFF;
+const csmUint32 PhaseShift = 47;
+const csmUint32 BufferShift = 40;
+const csmUint64 BufferMask = 0x7F;
+const csmUint32 ContextShift = 24;
+const csmUint64 ContextMask = 0xFFFF;
+const csmUint32 TypeShift = 22;
+const csmUint64 TypeMask = 0x3;
+const csmUint32 ShaderShift = 16;
+const csmUint64 ShaderMask = 0x3F;
+const csmUint32 BlendShift = 12;
+const csmUint64 BlendMask = 0xF;
+const csmUint32 TextureShift = 1;
+const csmUint64 TextureMask = 0x7FF;
+
+int CompareCommand(const void* a, const void* b)
+{
+    const CubismRenderCommandList::Command* lhs = static_cast<const CubismRenderCommandList::Command*>(a);
+    const CubismRenderCommandList::Command* rhs = static_cast<const CubismRenderCommandList::Command*>(b);
+
+    if (lhs->SortKey != rhs->SortKey)
+    {
+        return (lhs->SortKey < rhs->SortKey) ? -1 : 1;
+    }
+
+    // qsortは安定ではないため、キーが同じなら記録した順にする
+    if (lhs->Sequence != rhs->Sequence)
+    {
+        return (lhs->Sequence < rhs->Sequence) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+}
+
+CubismRenderCommandList::CubismRenderCommandList()
+{
+}
+
+CubismRenderCommandList::~CubismRenderCommandList()
+{
+}
+
+void CubismRenderCommandList::Clear()
+{
+    // 要素数だけを0にし、確保済みの領域は使い回す
+    _commands.Resize(0);
+}
+
+void CubismRenderCommandList::AddClearMaskBuffer(csmInt32 renderOrder, csmInt32 bufferIndex)
+{
+    AddCommand(renderOrder, CommandType_ClearMaskBuffer, bufferIndex, -1, NULL,
+               -1, ShaderVariant_SetupMask, CubismRenderer::CubismBlendMode_Mask, -1, false);
+}
+
+void CubismRenderCommandList::AddClearMask(csmInt32 renderOrder, csmInt32 contextIndex, CubismClippingContext* clipContext)
+{
+    AddCommand(renderOrder, CommandType_ClearMask, clipContext->_bufferIndex, contextIndex, clipContext,
+               -1, ShaderVariant_SetupMask, CubismRenderer::CubismBlendMode_Mask, -1, false);
+}
+
+void CubismRenderCommandList::AddDrawMask(const CubismModel& model, csmInt32 renderOrder, csmInt32 contextIndex, CubismClippingContext* clipContext, csmInt32 drawableIndex)
+{
+    AddCommand(renderOrder, CommandType_DrawMask, clipContext->_bufferIndex, contextIndex, clipContext,
+               drawableIndex, ShaderVariant_SetupMask, CubismRenderer::CubismBlendMode_Mask,
+               model.GetDrawableTextureIndex(drawableIndex), model.GetDrawableCulling(drawableIndex) != 0);
+}
+
+void CubismRenderCommandList::AddDraw(const CubismModel& model, csmInt32 renderOrder, CubismClippingContext* clipContext, csmInt32 drawableIndex)
+{
+    csmInt32 shaderVariant = ShaderVariant_Normal;
+    if (clipContext != NULL)
+    {
+        shaderVariant = model.GetDrawableInvertedMask(drawableIndex) ? ShaderVariant_MaskedInverted : ShaderVariant_Masked;
+    }
+
+    AddCommand(renderOrder, CommandType_Draw, -1, -1, clipContext,
+               drawableIndex, shaderVariant, model.GetDrawableBlendMode(drawableIndex),
+               model.GetDrawableTextureIndex(drawableIndex), model.GetDrawableCulling(drawableIndex) != 0);
+}
+
+void CubismRenderCommandList::Sort()
+{
+    CSM_TRACE_SCOPE("CubismRenderCommandList::Sort");
+
+    if (_commands.GetSize() > 1)
+    {
+        qsort(_commands.GetPtr(), _commands.GetSize(), sizeof(Command), CompareCommand);
+    }
+}
+
+csmInt32 CubismRenderCommandList::GetCommandCount() const
+{
+    return _commands.GetSize();
+}
+
+const CubismRenderCommandList::Command& CubismRenderCommandList::GetCommand(csmInt32 index) const
+{
+    return _commands[index];
+}
+
+void CubismRenderCommandList::CountStateChanges(Statistics& statistics) const
+{
+    memset(&statistics, 0, sizeof(Statistics));
+
+    // -2は未設定、-1はメインのバッファ
+    csmInt32 target = -2;
+    const CubismClippingContext* clipContext = NULL;
+    csmInt32 shaderVariant = -1;
+    csmInt32 blendMode = -1;
+    csmInt32 textureIndex = -1;
+    csmInt32 isCulling = -1;
+
+    statistics.CommandCount = _commands.GetSize();
+
+    for (csmUint32 i = 0; i < _commands.GetSize(); ++i)
+    {
+        const Command& command = _commands[i];
+
+        const csmInt32 commandTarget = (command.Type == CommandType_Draw) ? -1 : command.BufferIndex;
+        if (commandTarget != target)
+        {
+            statistics.TargetChangeCount++;
+            target = commandTarget;
+            clipContext = NULL;
+        }
+
+        if (command.Type == CommandType_ClearMaskBuffer || command.Type == CommandType_ClearMask)
+        {
+            statistics.ClearCount++;
+            if (command.Type == CommandType_ClearMask && command.ClipContext != clipContext)
+            {
+                statistics.ClipContextChangeCount++;
+                clipContext = command.ClipContext;
+            }
+            continue;
+        }
+
+        if (command.Type == CommandType_Draw)
+        {
+            statistics.DrawCount++;
+        }
+        else
+        {
+            statistics.MaskDrawCount++;
+        }
+
+        if (command.ClipContext != clipContext)
+        {
+            statistics.ClipContextChangeCount++;
+            clipContext = command.ClipContext;
+        }
+
+        if (command.ShaderVariant != shaderVariant)
+        {
+            statistics.ShaderChangeCount++;
+            shaderVariant = command.ShaderVariant;
+        }
+
+        if (command.BlendMode != blendMode)
+        {
+            statistics.BlendChangeCount++;
+            blendMode = command.BlendMode;
+        }
+
+        if (command.TextureIndex != textureIndex)
+        {
+            statistics.TextureChangeCount++;
+            textureIndex = command.TextureIndex;
+        }
+
+        if (static_cast<csmInt32>(command.IsCulling) != isCulling)
+        {
+            statistics.CullingChangeCount++;
+            isCulling = command.IsCulling;
+        }
+    }
+}
+
+csmUint64 CubismRenderCommandList::MakeSortKey(csmInt32 renderOrder, CommandType type, csmInt32 bufferIndex, csmInt32 contextIndex,
+                                               csmInt32 shaderVariant, csmInt32 blendMode, csmInt32 textureIndex, csmBool isCulling)
+{
+    const csmUint64 group = static_cast<csmUint64>(renderOrder + 1) & GroupMask;
+    const csmUint64 phase = (type == CommandType_Draw) ? 1 : 0;
+    const csmUint64 buffer = static_cast<csmUint64>(bufferIndex < 0 ? 0 : bufferIndex) & BufferMask;
+    const csmUint64 context = static_cast<csmUint64>(contextIndex + 1) & ContextMask;
+
+    return (group << GroupShift)
+        | (phase << PhaseShift)
+        | (buffer << BufferShift)
+        | (context << ContextShift)
+        | ((static_cast<csmUint64>(type) & TypeMask) << TypeShift)
+        | ((static_cast<csmUint64>(shaderVariant) & ShaderMask) << ShaderShift)
+        | ((static_cast<csmUint64>(blendMode) & BlendMask) << BlendShift)
+        | ((static_cast<csmUint64>(textureIndex < 0 ? 0 : textureIndex) & TextureMask) << TextureShift)
+        | (isCulling ? 1 : 0);
+}
+
+void CubismRenderCommandList::AddCommand(csmInt32 renderOrder, CommandType type, csmInt32 bufferIndex, csmInt32 contextIndex, CubismClippingContext* clipContext,
+                                         csmInt32 drawableIndex, csmInt32 shaderVariant, csmInt32 blendMode, csmInt32 textureIndex, csmBool isCulling)
+{
+    Command command;
+    command.SortKey = MakeSortKey(renderOrder, type, bufferIndex, contextIndex, shaderVariant, blendMode, textureIndex, isCulling);
+    command.Sequence = static_cast<csmUint32>(_commands.GetSize());
+    command.Type = type;
+    command.DrawableIndex = drawableIndex;
+    command.BufferIndex = bufferIndex;
+    command.ClipContext = clipContext;
+    command.ShaderVariant = shaderVariant;
+    command.BlendMode = blendMode;
+    command.TextureIndex = textureIndex;
+    command.IsCulling = isCulling;
+
+    _commands.PushBack(command);
+}
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
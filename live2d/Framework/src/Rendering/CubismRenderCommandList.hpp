@@ -0,0 +1,260 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "CubismRenderer.hpp"
+#include "Type/csmVector.hpp"
+#include "Model/CubismModel.hpp"
+#include "Utils/CubismTrace.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+/**
+ * @brief   1フレーム分の描画をグラフィックスAPIに依存しない命令として記録するリスト<br>
+ *           マスクの作成と描画オブジェクトの描画を記録し、ソートキーで並べ替えてから各バックエンドが再生する。<br>
+ *           ソートキーは上位ビットから次のとおり。描画順が変わる並べ替えは行わない
+ *
+ *           | ビット | 内容 |
+ *           |--------|------|
+ *           | 63-48  | グループ。0はまとめて作るマスク、1以降は描画順+1 |
+ *           | 47     | 0ならマスクの作成、1なら描画 |
+ *           | 46-40  | マスク用バッファのインデックス |
+ *           | 39-24  | クリッピングコンテキストの番号+1。0はバッファ全体 |
+ *           | 23-22  | 命令の種類 |
+ *           | 21-16  | シェーダの種類 |
+ *           | 15-12  | ブレンドモード |
+ *           | 11-1   | テクスチャのインデックス |
+ *           | 0      | カリング |
+ *
+ *           1つのマスクの中ではマスク用の描画オブジェクトをテクスチャとカリングでまとめる。
+ *           マスクは乗算で重ねるため、順序を入れ替えても結果は変わらない(丸めによる1階調以内の差を除く)
+ */
+class CubismRenderCommandList
+{
+public:
+    /**
+     * @brief   命令の種類
+     */
+    enum CommandType
+    {
+        CommandType_ClearMaskBuffer = 0,    ///< マスク用バッファ全体をクリアする
+        CommandType_ClearMask = 1,          ///< クリッピングコンテキストに割り当てられた領域とチャンネルだけをクリアする
+        CommandType_DrawMask = 2,           ///< マスク用の描画オブジェクトをマスク用バッファに描く
+        CommandType_Draw = 3,               ///< 描画オブジェクトを描く
+    };
+
+    /**
+     * @brief   シェーダの種類
+     */
+    enum ShaderVariant
+    {
+        ShaderVariant_SetupMask = 0,        ///< マスクの作成
+        ShaderVariant_Normal = 1,           ///< マスクなし
+        ShaderVariant_Masked = 2,           ///< マスクあり
+        ShaderVariant_MaskedInverted = 3,   ///< 反転したマスクあり
+    };
+
+    /**
+     * @brief   描画命令
+     */
+    struct Command
+    {
+        csmUint64 SortKey;                  ///< ソートキー
+        csmUint32 Sequence;                 ///< 記録した順番。ソートキーが同じ場合に使う
+        CommandType Type;                   ///< 命令の種類
+        csmInt32 DrawableIndex;             ///< 描く描画オブジェクトのインデックス。クリアでは-1
+        csmInt32 BufferIndex;               ///< マスク用バッファのインデックス。描画では-1
+        CubismClippingContext* ClipContext; ///< マスクの作成では書き込むマスク、描画では使うマスク。なければNULL
+        csmInt32 ShaderVariant;             ///< シェーダの種類
+        csmInt32 BlendMode;                 ///< ブレンドモード
+        csmInt32 TextureIndex;              ///< テクスチャのインデックス。クリアでは-1
+        csmBool IsCulling;                  ///< カリングが有効ならtrue
+    };
+
+    /**
+     * @brief   命令を順に実行したときの描画ステートの切り替え回数
+     */
+    struct Statistics
+    {
+        csmInt32 CommandCount;              ///< 命令の数
+        csmInt32 DrawCount;                 ///< 描画オブジェクトの描画回数
+        csmInt32 MaskDrawCount;             ///< マスク用の描画回数
+        csmInt32 ClearCount;                ///< クリアの回数
+        csmInt32 TargetChangeCount;         ///< 描画先(メインのバッファとマスク用バッファ)の切り替え回数
+        csmInt32 ClipContextChangeCount;    ///< 書き込む、または使うマスクの切り替え回数
+        csmInt32 ShaderChangeCount;         ///< シェーダの切り替え回数
+        csmInt32 BlendChangeCount;          ///< ブレンドモードの切り替え回数
+        csmInt32 TextureChangeCount;        ///< テクスチャの切り替え回数
+        csmInt32 CullingChangeCount;        ///< カリングの切り替え回数
+    };
+
+    static const csmInt32 PrePassRenderOrder = -1;  ///< 描画オブジェクトより前にまとめて作るマスクに指定する描画順
+
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismRenderCommandList();
+
+    /**
+     * @brief   デストラクタ
+     */
+    virtual ~CubismRenderCommandList();
+
+    /**
+     * @brief   記録した命令を破棄する。確保したメモリは次のフレームで使い回す
+     */
+    void Clear();
+
+    /**
+     * @brief   マスク用バッファ全体をクリアする命令を記録する
+     *
+     * @param[in]   renderOrder ->  このマスクを使う描画オブジェクトの描画順。まとめて作る場合はPrePassRenderOrder
+     * @param[in]   bufferIndex ->  マスク用バッファのインデックス
+     */
+    void AddClearMaskBuffer(csmInt32 renderOrder, csmInt32 bufferIndex);
+
+    /**
+     * @brief   クリッピングコンテキストに割り当てられた領域をクリアする命令を記録する
+     *
+     * @param[in]   renderOrder     ->  このマスクを使う描画オブジェクトの描画順。まとめて作る場合はPrePassRenderOrder
+     * @param[in]   contextIndex    ->  マスク用クリッピングコンテキストのリスト内での番号
+     * @param[in]   clipContext     ->  クリアするクリッピングコンテキスト
+     */
+    void AddClearMask(csmInt32 renderOrder, csmInt32 contextIndex, CubismClippingContext* clipContext);
+
+    /**
+     * @brief   マスク用の描画オブジェクトを描く命令を記録する
+     *
+     * @param[in]   model           ->  モデルのインスタンス
+     * @param[in]   renderOrder     ->  このマスクを使う描画オブジェクトの描画順。まとめて作る場合はPrePassRenderOrder
+     * @param[in]   contextIndex    ->  マスク用クリッピングコンテキストのリスト内での番号
+     * @param[in]   clipContext     ->  書き込むクリッピングコンテキスト
+     * @param[in]   drawableIndex   ->  マスク用の描画オブジェクトのインデックス
+     */
+    void AddDrawMask(const CubismModel& model, csmInt32 renderOrder, csmInt32 contextIndex, CubismClippingContext* clipContext, csmInt32 drawableIndex);
+
+    /**
+     * @brief   描画オブジェクトを描く命令を記録する
+     *
+     * @param[in]   model           ->  モデルのインスタンス
+     * @param[in]   renderOrder     ->  描画オブジェクトの描画順
+     * @param[in]   clipContext     ->  描画に使うクリッピングコンテキスト。なければNULL
+     * @param[in]   drawableIndex   ->  描画オブジェクトのインデックス
+     */
+    void AddDraw(const CubismModel& model, csmInt32 renderOrder, CubismClippingContext* clipContext, csmInt32 drawableIndex);
+
+    /**
+     * @brief   表示されている描画オブジェクトを描画順に記録する<br>
+     *           高精細マスクの場合は、描画オブジェクトごとにマスクを作る命令も記録する
+     *
+     * @param[in]   model                       ->  モデルのインスタンス
+     * @param[in]   clipContextsForDraw         ->  描画オブジェクトのインデックスごとのクリッピングコンテキスト。マスクを使わない場合はNULL
+     * @param[in]   isUsingHighPrecisionMask    ->  高精細マスクを使う場合はtrue
+     */
+    template <class T_ClippingContext>
+    void RecordDrawables(const CubismModel& model, T_ClippingContext* const* clipContextsForDraw, csmBool isUsingHighPrecisionMask);
+
+    /**
+     * @brief   ソートキーで命令を並べ替える。キーが同じ命令は記録した順のままにする
+     */
+    void Sort();
+
+    /**
+     * @brief   記録した命令の数を取得する
+     *
+     * @return  命令の数
+     */
+    csmInt32 GetCommandCount() const;
+
+    /**
+     * @brief   命令を取得する
+     *
+     * @param[in]   index   ->  命令の番号
+     * @return  命令
+     */
+    const Command& GetCommand(csmInt32 index) const;
+
+    /**
+     * @brief   現在の並び順で命令を実行したときの描画ステートの切り替え回数を数える
+     *
+     * @param[out]  statistics  ->  切り替え回数
+     */
+    void CountStateChanges(Statistics& statistics) const;
+
+private:
+    /**
+     * @brief   ソートキーを作る
+     */
+    static csmUint64 MakeSortKey(csmInt32 renderOrder, CommandType type, csmInt32 bufferIndex, csmInt32 contextIndex,
+                                 csmInt32 shaderVariant, csmInt32 blendMode, csmInt32 textureIndex, csmBool isCulling);
+
+    /**
+     * @brief   命令を追加する
+     */
+    void AddCommand(csmInt32 renderOrder, CommandType type, csmInt32 bufferIndex, csmInt32 contextIndex, CubismClippingContext* clipContext,
+                    csmInt32 drawableIndex, csmInt32 shaderVariant, csmInt32 blendMode, csmInt32 textureIndex, csmBool isCulling);
+
+    csmVector<Command> _commands;                   ///< 記録した命令
+    csmVector<csmInt32> _sortedDrawableIndexList;   ///< 描画順に並べた描画オブジェクトのインデックス
+};
+
+template <class T_ClippingContext>
+void CubismRenderCommandList::RecordDrawables(const CubismModel& model, T_ClippingContext* const* clipContextsForDraw, csmBool isUsingHighPrecisionMask)
+{
+    CSM_TRACE_SCOPE("CubismRenderCommandList::RecordDrawables");
+
+    const csmInt32 drawableCount = model.GetDrawableCount();
+    const csmInt32* renderOrder = model.GetDrawableRenderOrders();
+
+    // インデックスを描画順でソート
+    _sortedDrawableIndexList.Resize(drawableCount, 0);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        _sortedDrawableIndexList[renderOrder[i]] = i;
+    }
+
+    for (csmInt32 order = 0; order < drawableCount; ++order)
+    {
+        const csmInt32 drawableIndex = _sortedDrawableIndexList[order];
+
+        // Drawableが表示状態でなければ処理をパスする
+        if (!model.GetDrawableDynamicFlagIsVisible(drawableIndex))
+        {
+            continue;
+        }
+
+        T_ClippingContext* clipContext = (clipContextsForDraw != NULL) ? clipContextsForDraw[drawableIndex] : NULL;
+
+        // 高精細マスクはこの描画オブジェクトの直前にマスクを作る
+        if (clipContext != NULL && isUsingHighPrecisionMask && clipContext->_isUsing)
+        {
+            AddClearMaskBuffer(order, clipContext->_bufferIndex);
+
+            for (csmInt32 i = 0; i < clipContext->_clippingIdCount; ++i)
+            {
+                const csmInt32 clipDrawIndex = clipContext->_clippingIdList[i];
+
+                // 頂点情報が更新されておらず、信頼性がない場合は描画をパスする
+                if (!model.GetDrawableDynamicFlagVertexPositionsDidChange(clipDrawIndex))
+                {
+                    continue;
+                }
+
+                AddDrawMask(model, order, 0, clipContext, clipDrawIndex);
+            }
+        }
+
+        AddDraw(model, order, clipContext, drawableIndex);
+    }
+}
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
@@ -8,6 +8,7 @@
 #include "CubismRenderer.hpp"
 #include "CubismFramework.hpp"
 #include "Model/CubismModel.hpp"
+#include "Utils/CubismTrace.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
@@ -23,6 +24,8 @@ CubismRenderer::CubismRenderer()
     , _anisotropy(0.0f)
     , _model(NULL)
     , _useHighPrecisionMask(false)
+    , _usePackedMaskLayout(false)
+    , _useDrawBatching(false)
 {
     //単位行列に初期化
     _mvpMatrix4x4.LoadIdentity();
@@ -45,6 +48,8 @@ void CubismRenderer::DrawModel()
 {
     if (GetModel() == NULL) return;
 
+    CSM_TRACE_SCOPE("CubismRenderer::DrawModel");
+
     /**
      * DoDrawModelの描画前と描画後に以下の関数を呼んでください。
      * ・SaveProfile();
@@ -153,6 +158,26 @@ csmBool CubismRenderer::IsUsingHighPrecisionMask()
     return _useHighPrecisionMask;
 }
 
+void CubismRenderer::UsePackedMaskLayout(csmBool packed)
+{
+    _usePackedMaskLayout = packed;
+}
+
+csmBool CubismRenderer::IsUsingPackedMaskLayout() const
+{
+    return _usePackedMaskLayout;
+}
+
+void CubismRenderer::UseDrawBatching(csmBool batching)
+{
+    _useDrawBatching = batching;
+}
+
+csmBool CubismRenderer::IsUsingDrawBatching() const
+{
+    return _useDrawBatching;
+}
+
 /*********************************************************************************************************************
 *                                      CubismClippingContext
 ********************************************************************************************************************/
@@ -166,6 +191,9 @@ CubismClippingContext::CubismClippingContext(const csmInt32* clippingDrawableInd
 
     _layoutChannelIndex = 0;
 
+    _isMatrixDirty = true;
+    _isMaskDirty = true;
+
     _allClippedDrawRect = CSM_NEW csmRectF();
     _layoutBounds = CSM_NEW csmRectF();
 
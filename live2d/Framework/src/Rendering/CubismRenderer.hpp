@@ -224,6 +224,32 @@ public:
      */
     csmBool IsUsingHighPrecisionMask();
 
+    /**
+     * @brief   マスクの配置方法を変更する。
+     *           falseの場合、マスク用テクスチャの各チャンネルをマスクの数に応じて固定で分割する（デフォルトはこちら）。
+     *           trueの場合、マスクされる描画オブジェクトの大きさに合わせた領域をチャンネルとテクスチャに詰めて配置する。
+     *           小さなマスクに無駄な解像度を割かず、大きなマスクを高い解像度で描ける。
+     */
+    void UsePackedMaskLayout(csmBool packed);
+
+    /**
+     * @brief   マスクの配置方法を取得する。
+     */
+    csmBool IsUsingPackedMaskLayout() const;
+
+    /**
+     * @brief   描画オブジェクトをまとめて描くかを設定する。
+     *           trueの場合、描画順で連続し、テクスチャ・ブレンドモード・マスク・カリングが同じ描画オブジェクトを1回の描画命令にまとめる。
+     *           不透明度や乗算色・スクリーン色が異なる場合は頂点ごとの色として渡す。
+     *           現在はOpenGLES2のレンダラだけが対応し、他のレンダラでは無視される。
+     */
+    void UseDrawBatching(csmBool batching);
+
+    /**
+     * @brief   描画オブジェクトをまとめて描くかを取得する。
+     */
+    csmBool IsUsingDrawBatching() const;
+
 protected:
     /**
      * @brief   コンストラクタ
@@ -265,6 +291,8 @@ private:
     CubismModel*        _model;                 ///< レンダリング対象のモデル
 
     csmBool             _useHighPrecisionMask;  ///< falseの場合、マスクを纏めて描画する trueの場合、マスクはパーツ描画ごとに書き直す
+    csmBool             _usePackedMaskLayout;   ///< trueの場合、マスクを大きさに合わせて詰めて配置する
+    csmBool             _useDrawBatching;       ///< trueの場合、描画オブジェクトをまとめて描く
 };
 
 
@@ -303,6 +331,9 @@ public:
     CubismMatrix44 _matrixForDraw;                   ///< 描画オブジェクトの位置計算結果を保持する行列
     csmVector<csmInt32>* _clippedDrawableIndexList;  ///< このマスクにクリップされる描画オブジェクトのリスト
     csmInt32 _bufferIndex;                           ///< このマスクが割り当てられるレンダーテクスチャ（フレームバッファ）やカラーバッファのインデックス
+    csmRectF _lastClippedDrawRect;                   ///< 前回行列を計算したときの_allClippedDrawRect
+    csmBool _isMatrixDirty;                          ///< 今回のフレームで行列の再計算が必要ならtrue
+    csmBool _isMaskDirty;                            ///< 今回のフレームでマスクの再描画が必要ならtrue
 };
 
 }}}}
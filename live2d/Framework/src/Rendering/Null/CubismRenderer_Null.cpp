@@ -0,0 +1,154 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismRenderer_Null.hpp"
+#include "Model/CubismModel.hpp"
+#include "Utils/CubismTrace.hpp"
+#include <string.h>
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+/*********************************************************************************************************************
+*                                      CubismClippingContext_Null
+********************************************************************************************************************/
+CubismClippingContext_Null::CubismClippingContext_Null(CubismClippingManager<CubismClippingContext_Null, CubismOffscreenSurface_Null>* manager, CubismModel& /*model*/, const csmInt32* clippingDrawableIndices, csmInt32 clipCount)
+    : CubismClippingContext(clippingDrawableIndices, clipCount)
+{
+    _owner = manager;
+}
+
+CubismClippingContext_Null::~CubismClippingContext_Null()
+{
+}
+
+CubismClippingManager<CubismClippingContext_Null, CubismOffscreenSurface_Null>* CubismClippingContext_Null::GetClippingManager()
+{
+    return _owner;
+}
+
+/*********************************************************************************************************************
+ *                                      CubismRenderer_Null
+ ********************************************************************************************************************/
+
+CubismRenderer* CubismRenderer::Create()
+{
+    return CSM_NEW CubismRenderer_Null();
+}
+
+void CubismRenderer::StaticRelease()
+{
+}
+
+CubismRenderer_Null::CubismRenderer_Null() : _clippingManager(NULL)
+{
+    memset(&_recordedStatistics, 0, sizeof(_recordedStatistics));
+    memset(&_sortedStatistics, 0, sizeof(_sortedStatistics));
+}
+
+CubismRenderer_Null::~CubismRenderer_Null()
+{
+    CSM_DELETE_SELF(CubismClippingManager_Null, _clippingManager);
+}
+
+void CubismRenderer_Null::Initialize(CubismModel* model)
+{
+    Initialize(model, 1);
+}
+
+void CubismRenderer_Null::Initialize(CubismModel* model, csmInt32 maskBufferCount)
+{
+    // 1未満は1に補正する
+    if (maskBufferCount < 1)
+    {
+        maskBufferCount = 1;
+        CubismLogWarning("The number of render textures must be an integer greater than or equal to 1. Set the number of render textures to 1.");
+    }
+
+    if (model->IsUsingMasking())
+    {
+        _clippingManager = CSM_NEW CubismClippingManager_Null();  //クリッピングマスク・バッファ前処理方式を初期化
+        _clippingManager->Initialize(
+            *model,
+            maskBufferCount
+        );
+    }
+
+    CubismRenderer::Initialize(model, maskBufferCount);  //親クラスの処理を呼ぶ
+}
+
+void CubismRenderer_Null::DoDrawModel()
+{
+    CSM_TRACE_SCOPE("CubismRenderer_Null::DoDrawModel");
+
+    // OpenGLES2と同じ手順で描画命令を記録する
+    _commandList.Clear();
+
+    if (_clippingManager != NULL)
+    {
+        if (IsUsingHighPrecisionMask())
+        {
+            _clippingManager->SetupMatrixForHighPrecision(*GetModel(), false);
+        }
+        else
+        {
+            _clippingManager->SetUsingPackedLayout(IsUsingPackedMaskLayout());
+            _clippingManager->RecordMaskCommands(*GetModel(), _commandList, false);
+        }
+    }
+
+    _commandList.RecordDrawables(*GetModel(),
+        (_clippingManager != NULL) ? _clippingManager->GetClippingContextListForDraw()->GetPtr() : NULL,
+        IsUsingHighPrecisionMask());
+
+    // 並べ替える前と後で、実行した場合の切り替え回数を数える
+    _commandList.CountStateChanges(_recordedStatistics);
+    _commandList.Sort();
+    _commandList.CountStateChanges(_sortedStatistics);
+
+    if (IsUsingDrawBatching())
+    {
+        _drawBatcher.Build(*GetModel(), *this, _commandList);
+    }
+}
+
+void CubismRenderer_Null::SaveProfile()
+{
+}
+
+void CubismRenderer_Null::RestoreProfile()
+{
+}
+
+const CubismRenderCommandList& CubismRenderer_Null::GetCommandList() const
+{
+    return _commandList;
+}
+
+const CubismRenderCommandList::Statistics& CubismRenderer_Null::GetRecordedStatistics() const
+{
+    return _recordedStatistics;
+}
+
+const CubismRenderCommandList::Statistics& CubismRenderer_Null::GetSortedStatistics() const
+{
+    return _sortedStatistics;
+}
+
+const CubismDrawBatcher& CubismRenderer_Null::GetDrawBatcher() const
+{
+    return _drawBatcher;
+}
+
+csmInt32 CubismRenderer_Null::GetRedrawnClippingContextCount() const
+{
+    return (_clippingManager != NULL) ? _clippingManager->GetRedrawnContextCount() : 0;
+}
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
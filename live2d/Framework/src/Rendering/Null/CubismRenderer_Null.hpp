@@ -0,0 +1,165 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "../CubismRenderer.hpp"
+#include "../CubismClippingManager.hpp"
+#include "../CubismRenderCommandList.hpp"
+#include "../CubismDrawBatcher.hpp"
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+//  前方宣言
+class CubismRenderer_Null;
+class CubismClippingContext_Null;
+
+/**
+ * @brief   マスク用バッファの代わり<br>
+ *           グラフィックスAPIを使わないため、中身は持たない
+ */
+class CubismOffscreenSurface_Null
+{
+};
+
+/**
+ * @brief  クリッピングマスクの処理を実行するクラス
+ *
+ */
+class CubismClippingManager_Null : public CubismClippingManager<CubismClippingContext_Null, CubismOffscreenSurface_Null>
+{
+};
+
+/**
+ * @brief   クリッピングマスクのコンテキスト
+ */
+class CubismClippingContext_Null : public CubismClippingContext
+{
+    friend class CubismClippingManager_Null;
+    friend class CubismRenderer_Null;
+
+public:
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     */
+    CubismClippingContext_Null(CubismClippingManager<CubismClippingContext_Null, CubismOffscreenSurface_Null>* manager, CubismModel& model, const csmInt32* clippingDrawableIndices, csmInt32 clipCount);
+
+    /**
+     * @brief   デストラクタ
+     */
+    virtual ~CubismClippingContext_Null();
+
+    /**
+     * @brief   このマスクを管理するマネージャのインスタンスを取得する。
+     *
+     * @return  クリッピングマネージャのインスタンス
+     */
+    CubismClippingManager<CubismClippingContext_Null, CubismOffscreenSurface_Null>* GetClippingManager();
+
+    CubismClippingManager<CubismClippingContext_Null, CubismOffscreenSurface_Null>* _owner;        ///< このマスクを管理しているマネージャのインスタンス
+};
+
+/**
+ * @brief   描画を行わないレンダラ<br>
+ *           OpenGLES2と同じ手順で描画命令を記録して並べ替え、実行した場合の描画ステートの切り替え回数だけを数える。
+ *           GPUのない環境で、描画命令の並べ替えの効果を測るために使う
+ */
+class CubismRenderer_Null : public CubismRenderer
+{
+    friend class CubismRenderer;
+
+public:
+    /**
+     * @brief    レンダラの初期化処理を実行する<br>
+     *           引数に渡したモデルからレンダラの初期化処理に必要な情報を取り出すことができる
+     *
+     * @param[in]  model -> モデルのインスタンス
+     */
+    void Initialize(Framework::CubismModel* model);
+
+    void Initialize(Framework::CubismModel* model, csmInt32 maskBufferCount);
+
+    /**
+     * @brief  直前の描画で記録した描画命令を取得する
+     *
+     * @return 並べ替えた後の描画命令
+     */
+    const CubismRenderCommandList& GetCommandList() const;
+
+    /**
+     * @brief  直前の描画の命令を、記録した順(並べ替えずに描く場合の順)で実行したときの描画ステートの切り替え回数を取得する
+     *
+     * @return 切り替え回数
+     */
+    const CubismRenderCommandList::Statistics& GetRecordedStatistics() const;
+
+    /**
+     * @brief  直前の描画の命令を、並べ替えた順で実行したときの描画ステートの切り替え回数を取得する
+     *
+     * @return 切り替え回数
+     */
+    const CubismRenderCommandList::Statistics& GetSortedStatistics() const;
+
+    /**
+     * @brief  直前の描画で、並べ替えた命令からまとめた描画を取得する。UseDrawBatching(true)の場合だけ作る
+     *
+     * @return まとめた描画
+     */
+    const CubismDrawBatcher& GetDrawBatcher() const;
+
+    /**
+     * @brief  直前の描画で、マスクを作り直したクリッピングコンテキストの数を取得する
+     *
+     * @return 作り直したクリッピングコンテキストの数
+     */
+    csmInt32 GetRedrawnClippingContextCount() const;
+
+protected:
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismRenderer_Null();
+
+    /**
+     * @brief   デストラクタ
+     */
+    virtual ~CubismRenderer_Null();
+
+    /**
+     * @brief   モデルを描画する実際の処理
+     *
+     */
+    virtual void DoDrawModel() override;
+
+private:
+    // Prevention of copy Constructor
+    CubismRenderer_Null(const CubismRenderer_Null&);
+    CubismRenderer_Null& operator=(const CubismRenderer_Null&);
+
+    /**
+     * @brief   モデル描画直前のステートを保持する。保持するステートはない
+     */
+    virtual void SaveProfile();
+
+    /**
+     * @brief   モデル描画直前のステートを復帰させる。復帰させるステートはない
+     */
+    virtual void RestoreProfile();
+
+    CubismClippingManager_Null* _clippingManager;                   ///< クリッピングマスク管理オブジェクト
+    CubismRenderCommandList _commandList;                           ///< 1フレーム分の描画命令
+    CubismRenderCommandList::Statistics _recordedStatistics;        ///< 記録した順で実行したときの切り替え回数
+    CubismRenderCommandList::Statistics _sortedStatistics;          ///< 並べ替えた順で実行したときの切り替え回数
+    CubismDrawBatcher _drawBatcher;                                 ///< 並べ替えた命令からまとめた描画
+};
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
@@ -60,6 +60,24 @@ void CubismOffscreenSurface_OpenGLES2::Clear(float r, float g, float b, float a)
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
+csmBool CubismOffscreenSurface_OpenGLES2::ReadPixels(csmUint8* buffer) const
+{
+    if (_renderTexture == 0 || buffer == NULL)
+    {
+        return false;
+    }
+
+    // 現在のフレームバッファを記憶し、読み出し後に戻す
+    GLint currentFBO;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &currentFBO);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _renderTexture);
+    glReadPixels(0, 0, static_cast<GLsizei>(_bufferWidth), static_cast<GLsizei>(_bufferHeight), GL_RGBA, GL_UNSIGNED_BYTE, buffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, currentFBO);
+
+    return true;
+}
+
 csmBool CubismOffscreenSurface_OpenGLES2::CreateOffscreenSurface(csmUint32 displayBufferWidth, csmUint32 displayBufferHeight, GLuint colorBuffer)
 {
     // 一旦削除
@@ -73,6 +73,14 @@ public:
      */
     void Clear(float r, float g, float b, float a);
 
+    /**
+     * @brief   レンダリングターゲットの内容を読み出す
+     *           RGBA各8bitで、下の行から順に格納する。描画中でも呼べる
+     * @param   buffer  読み出し先。幅×高さ×4バイト以上の領域
+     * @return  読み出せたらtrue
+     */
+    csmBool ReadPixels(csmUint8* buffer) const;
+
     /**
      *  @brief  CubismOffscreenSurface作成
      *  @param  displayBufferWidth     作成するバッファ幅
@@ -9,6 +9,7 @@
 #include "Math/CubismMatrix44.hpp"
 #include "Type/csmVector.hpp"
 #include "Model/CubismModel.hpp"
+#include "Utils/CubismTrace.hpp"
 #include <float.h>
 
 #ifdef CSM_TARGET_WIN_GL
@@ -24,144 +25,6 @@
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
 
-/*********************************************************************************************************************
-*                                      CubismClippingManager_OpenGLES2
-********************************************************************************************************************/
-void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, CubismRenderer_OpenGLES2* renderer, GLint lastFBO, GLint lastViewport[4])
-{
-    // 全てのクリッピングを用意する
-    // 同じクリップ（複数の場合はまとめて１つのクリップ）を使う場合は１度だけ設定する
-    csmInt32 usingClipCount = 0;
-    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
-    {
-        // １つのクリッピングマスクに関して
-        CubismClippingContext_OpenGLES2* cc = _clippingContextListForMask[clipIndex];
-
-        // このクリップを利用する描画オブジェクト群全体を囲む矩形を計算
-        CalcClippedDrawTotalBounds(model, cc);
-
-        if (cc->_isUsing)
-        {
-            usingClipCount++; //使用中としてカウント
-        }
-    }
-
-    if (usingClipCount <= 0)
-    {
-        return;
-    }
-
-    // マスク作成処理
-    // 生成したOffscreenSurfaceと同じサイズでビューポートを設定
-    glViewport(0, 0, _clippingMaskBufferSize.X, _clippingMaskBufferSize.Y);
-
-    // 後の計算のためにインデックスの最初をセット
-    _currentMaskBuffer = renderer->GetMaskBuffer(0);
-    // ----- マスク描画処理 -----
-    _currentMaskBuffer->BeginDraw(lastFBO);
-
-    renderer->PreDraw(); // バッファをクリアする
-
-    // 各マスクのレイアウトを決定していく
-    SetupLayoutBounds(usingClipCount);
-
-    // サイズがレンダーテクスチャの枚数と合わない場合は合わせる
-    if (_clearedMaskBufferFlags.GetSize() != _renderTextureCount)
-    {
-        _clearedMaskBufferFlags.Clear();
-
-        for (csmInt32 i = 0; i < _renderTextureCount; ++i)
-        {
-            _clearedMaskBufferFlags.PushBack(false);
-        }
-    }
-    else
-    {
-        // マスクのクリアフラグを毎フレーム開始時に初期化
-        for (csmInt32 i = 0; i < _renderTextureCount; ++i)
-        {
-            _clearedMaskBufferFlags[i] = false;
-        }
-    }
-
-    // 実際にマスクを生成する
-    // 全てのマスクをどの様にレイアウトして描くかを決定し、ClipContext , ClippedDrawContext に記憶する
-    for (csmUint32 clipIndex = 0; clipIndex < _clippingContextListForMask.GetSize(); clipIndex++)
-    {
-        // --- 実際に１つのマスクを描く ---
-        CubismClippingContext_OpenGLES2* clipContext = _clippingContextListForMask[clipIndex];
-        csmRectF* allClippedDrawRect = clipContext->_allClippedDrawRect; //このマスクを使う、全ての描画オブジェクトの論理座標上の囲み矩形
-        csmRectF* layoutBoundsOnTex01 = clipContext->_layoutBounds; //この中にマスクを収める
-        const csmFloat32 MARGIN = 0.05f;
-
-        // clipContextに設定したオフスクリーンサーフェイスをインデックスで取得
-        CubismOffscreenSurface_OpenGLES2* clipContextOffscreenSurface = renderer->GetMaskBuffer(clipContext->_bufferIndex);
-
-        // 現在のオフスクリーンサーフェイスがclipContextのものと異なる場合
-        if (_currentMaskBuffer != clipContextOffscreenSurface)
-        {
-            _currentMaskBuffer->EndDraw();
-            _currentMaskBuffer = clipContextOffscreenSurface;
-            // マスク用RenderTextureをactiveにセット
-            _currentMaskBuffer->BeginDraw(lastFBO);
-
-            // バッファをクリアする。
-            renderer->PreDraw();
-        }
-
-        // モデル座標上の矩形を、適宜マージンを付けて使う
-        _tmpBoundsOnModel.SetRect(allClippedDrawRect);
-        _tmpBoundsOnModel.Expand(allClippedDrawRect->Width * MARGIN, allClippedDrawRect->Height * MARGIN);
-        //########## 本来は割り当てられた領域の全体を使わず必要最低限のサイズがよい
-        // シェーダ用の計算式を求める。回転を考慮しない場合は以下のとおり
-        // movePeriod' = movePeriod * scaleX + offX     [[ movePeriod' = (movePeriod - tmpBoundsOnModel.movePeriod)*scale + layoutBoundsOnTex01.movePeriod ]]
-        csmFloat32 scaleX = layoutBoundsOnTex01->Width / _tmpBoundsOnModel.Width;
-        csmFloat32 scaleY = layoutBoundsOnTex01->Height / _tmpBoundsOnModel.Height;
-
-        // マスク生成時に使う行列を求める
-        createMatrixForMask(false, layoutBoundsOnTex01, scaleX, scaleY);
-
-        clipContext->_matrixForMask.SetMatrix(_tmpMatrixForMask.GetArray());
-        clipContext->_matrixForDraw.SetMatrix(_tmpMatrixForDraw.GetArray());
-
-        // 実際の描画を行う
-        const csmInt32 clipDrawCount = clipContext->_clippingIdCount;
-        for (csmInt32 i = 0; i < clipDrawCount; i++)
-        {
-            const csmInt32 clipDrawIndex = clipContext->_clippingIdList[i];
-
-            // 頂点情報が更新されておらず、信頼性がない場合は描画をパスする
-            if (!model.GetDrawableDynamicFlagVertexPositionsDidChange(clipDrawIndex))
-            {
-                continue;
-            }
-
-            renderer->IsCulling(model.GetDrawableCulling(clipDrawIndex) != 0);
-
-            // マスクがクリアされていないなら処理する
-            if (!_clearedMaskBufferFlags[clipContext->_bufferIndex])
-            {
-                // マスクをクリアする
-                // 1が無効（描かれない）領域、0が有効（描かれる）領域。（シェーダーCd*Csで0に近い値をかけてマスクを作る。1をかけると何も起こらない）
-                glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-                glClear(GL_COLOR_BUFFER_BIT);
-                _clearedMaskBufferFlags[clipContext->_bufferIndex] = true;
-            }
-
-            // 今回専用の変換を適用して描く
-            // チャンネルも切り替える必要がある(A,R,G,B)
-            renderer->SetClippingContextBufferForMask(clipContext);
-
-            renderer->DrawMeshOpenGL(model, clipDrawIndex);
-        }
-    }
-
-    // --- 後処理 ---
-    _currentMaskBuffer->EndDraw();
-    renderer->SetClippingContextBufferForMask(NULL);
-    glViewport(lastViewport[0], lastViewport[1], lastViewport[2], lastViewport[3]);
-}
-
 /*********************************************************************************************************************
 *                                      CubismClippingContext_OpenGLES2
 ********************************************************************************************************************/
@@ -183,18 +46,6 @@ CubismClippingManager<CubismClippingContext_OpenGLES2, CubismOffscreenSurface_Op
 /*********************************************************************************************************************
 *                                      CubismDrawProfile_OpenGL
 ********************************************************************************************************************/
-void CubismRendererProfile_OpenGLES2::SetGlEnable(GLenum index, GLboolean enabled)
-{
-    if (enabled == GL_TRUE) glEnable(index);
-    else glDisable(index);
-}
-
-void CubismRendererProfile_OpenGLES2::SetGlEnableVertexAttribArray(GLuint index, GLint enabled)
-{
-    if (enabled) glEnableVertexAttribArray(index);
-    else glDisableVertexAttribArray(index);
-}
-
 void CubismRendererProfile_OpenGLES2::Save()
 {
     //-- push state --
@@ -236,38 +87,36 @@ void CubismRendererProfile_OpenGLES2::Save()
 
 }
 
-void CubismRendererProfile_OpenGLES2::Restore()
+void CubismRendererProfile_OpenGLES2::Restore(CubismStateCache_OpenGLES2& stateCache)
 {
-    glUseProgram(_lastProgram);
+    // 描画中に設定した値と同じものはステートキャッシュが省略する
+    stateCache.UseProgram(_lastProgram);
 
-    SetGlEnableVertexAttribArray(0, _lastVertexAttribArrayEnabled[0]);
-    SetGlEnableVertexAttribArray(1, _lastVertexAttribArrayEnabled[1]);
-    SetGlEnableVertexAttribArray(2, _lastVertexAttribArrayEnabled[2]);
-    SetGlEnableVertexAttribArray(3, _lastVertexAttribArrayEnabled[3]);
+    stateCache.SetVertexAttribArrayEnabled(0, _lastVertexAttribArrayEnabled[0] != 0);
+    stateCache.SetVertexAttribArrayEnabled(1, _lastVertexAttribArrayEnabled[1] != 0);
+    stateCache.SetVertexAttribArrayEnabled(2, _lastVertexAttribArrayEnabled[2] != 0);
+    stateCache.SetVertexAttribArrayEnabled(3, _lastVertexAttribArrayEnabled[3] != 0);
 
-    SetGlEnable(GL_SCISSOR_TEST, _lastScissorTest);
-    SetGlEnable(GL_STENCIL_TEST, _lastStencilTest);
-    SetGlEnable(GL_DEPTH_TEST, _lastDepthTest);
-    SetGlEnable(GL_CULL_FACE, _lastCullFace);
-    SetGlEnable(GL_BLEND, _lastBlend);
+    stateCache.SetEnabled(GL_SCISSOR_TEST, _lastScissorTest == GL_TRUE);
+    stateCache.SetEnabled(GL_STENCIL_TEST, _lastStencilTest == GL_TRUE);
+    stateCache.SetEnabled(GL_DEPTH_TEST, _lastDepthTest == GL_TRUE);
+    stateCache.SetEnabled(GL_CULL_FACE, _lastCullFace == GL_TRUE);
+    stateCache.SetEnabled(GL_BLEND, _lastBlend == GL_TRUE);
 
-    glFrontFace(_lastFrontFace);
+    stateCache.FrontFace(_lastFrontFace);
 
-    glColorMask(_lastColorMask[0], _lastColorMask[1], _lastColorMask[2], _lastColorMask[3]);
+    stateCache.ColorMask(_lastColorMask[0], _lastColorMask[1], _lastColorMask[2], _lastColorMask[3]);
 
-    glBindBuffer(GL_ARRAY_BUFFER, _lastArrayBufferBinding); //前にバッファがバインドされていたら破棄する必要がある
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _lastElementArrayBufferBinding);
+    stateCache.BindBuffer(GL_ARRAY_BUFFER, _lastArrayBufferBinding); //前にバッファがバインドされていたら破棄する必要がある
+    stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, _lastElementArrayBufferBinding);
 
-    glActiveTexture(GL_TEXTURE1); //テクスチャユニット1を復元
-    glBindTexture(GL_TEXTURE_2D, _lastTexture1Binding2D);
+    stateCache.BindTexture2D(1, _lastTexture1Binding2D); //テクスチャユニット1を復元
+    stateCache.BindTexture2D(0, _lastTexture0Binding2D); //テクスチャユニット0を復元
 
-    glActiveTexture(GL_TEXTURE0); //テクスチャユニット0を復元
-    glBindTexture(GL_TEXTURE_2D, _lastTexture0Binding2D);
-
-    glActiveTexture(_lastActiveTexture);
+    stateCache.ActiveTexture(_lastActiveTexture);
 
     // restore blending
-    glBlendFuncSeparate(_lastBlending[0], _lastBlending[1], _lastBlending[2], _lastBlending[3]);
+    stateCache.BlendFuncSeparate(_lastBlending[0], _lastBlending[1], _lastBlending[2], _lastBlending[3]);
 }
 
 /*********************************************************************************************************************
@@ -429,7 +278,9 @@ void CubismRenderer::StaticRelease()
     CubismRenderer_OpenGLES2::DoStaticRelease();
 }
 
-CubismRenderer_OpenGLES2::CubismRenderer_OpenGLES2() : _clippingManager(NULL)
+CubismRenderer_OpenGLES2::CubismRenderer_OpenGLES2() : _useVertexBufferObjects(false)
+                                                     , _useCooperativeStateMode(false)
+                                                     , _clippingManager(NULL)
                                                      , _clippingContextBufferForMask(NULL)
                                                      , _clippingContextBufferForDraw(NULL)
 {
@@ -492,8 +343,6 @@ void CubismRenderer_OpenGLES2::Initialize(CubismModel* model, csmInt32 maskBuffe
 
     }
 
-    _sortedDrawableIndexList.Resize(model->GetDrawableCount(), 0);
-
     CubismRenderer::Initialize(model, maskBufferCount);  //親クラスの処理を呼ぶ
 }
 
@@ -504,26 +353,26 @@ void CubismRenderer_OpenGLES2::PreDraw()
     if (!s_isInitializeGlFunctionsSuccess) return;
 #endif
 
-    glDisable(GL_SCISSOR_TEST);
-    glDisable(GL_STENCIL_TEST);
-    glDisable(GL_DEPTH_TEST);
+    _stateCache.SetEnabled(GL_SCISSOR_TEST, false);
+    _stateCache.SetEnabled(GL_STENCIL_TEST, false);
+    _stateCache.SetEnabled(GL_DEPTH_TEST, false);
 
-    glEnable(GL_BLEND);
-    glColorMask(1, 1, 1, 1);
+    _stateCache.SetEnabled(GL_BLEND, true);
+    _stateCache.ColorMask(1, 1, 1, 1);
 
 #ifdef CSM_TARGET_IPHONE_ES2
     glBindVertexArrayOES(0);
 #endif
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0); //前にバッファがバインドされていたら破棄する必要がある
+    _stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    _stateCache.BindBuffer(GL_ARRAY_BUFFER, 0); //前にバッファがバインドされていたら破棄する必要がある
 
     //異方性フィルタリング。プラットフォームのOpenGLによっては未対応の場合があるので、未設定のときは設定しない
     if (GetAnisotropy() > 0.0f)
     {
         for (csmInt32 i = 0; i < _textures.GetSize(); i++)
         {
-            glBindTexture(GL_TEXTURE_2D, _textures[i]);
+            _stateCache.BindTexture2D(0, _textures[i]);
             glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, GetAnisotropy());
         }
     }
@@ -532,11 +381,11 @@ void CubismRenderer_OpenGLES2::PreDraw()
 
 void CubismRenderer_OpenGLES2::DoDrawModel()
 {
+    PreDraw();
+
     //------------ クリッピングマスク・バッファ前処理方式の場合 ------------
     if (_clippingManager != NULL)
     {
-        PreDraw();
-
         // サイズが違う場合はここで作成しなおし
         for (csmInt32 i = 0; i < _clippingManager->GetRenderTextureCount(); ++i)
         {
@@ -545,112 +394,215 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
             {
                 _offscreenSurfaces[i].CreateOffscreenSurface(
                     static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().X), static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y));
+
+                // 作り直したバッファには前回のマスクが残っていない
+                _clippingManager->InvalidateMasks();
+
+                // 作成時にテクスチャのバインドが変わる
+                _stateCache.Invalidate();
             }
         }
+    }
+
+    // 1フレーム分の描画命令を記録する
+    _commandList.Clear();
 
+    if (_clippingManager != NULL)
+    {
         if (IsUsingHighPrecisionMask())
         {
            _clippingManager->SetupMatrixForHighPrecision(*GetModel(), false);
         }
         else
         {
-           _clippingManager->SetupClippingContext(*GetModel(), this, _rendererProfile._lastFBO, _rendererProfile._lastViewport);
+           _clippingManager->SetUsingPackedLayout(IsUsingPackedMaskLayout());
+           _clippingManager->RecordMaskCommands(*GetModel(), _commandList, false);
         }
     }
 
-    // 上記クリッピング処理内でも一度PreDrawを呼ぶので注意!!
-    PreDraw();
+    _commandList.RecordDrawables(*GetModel(),
+        (_clippingManager != NULL) ? _clippingManager->GetClippingContextListForDraw()->GetPtr() : NULL,
+        IsUsingHighPrecisionMask());
+
+    // 描画順を保ったまま、ステートの切り替えが少なくなるように並べ替える
+    _commandList.Sort();
+
+    // 並べ替えで隣り合った同じステートの描画オブジェクトをまとめる
+    if (IsUsingDrawBatching())
+    {
+        _drawBatcher.Build(*GetModel(), *this, _commandList);
+    }
+
+    // 頂点をGPUのバッファに保持する場合は、変化した頂点位置だけを転送する
+    if (IsUsingVertexBufferObjects())
+    {
+        if (!_vertexBuffer.IsValid())
+        {
+            _vertexBuffer.CreateBuffers(*GetModel());
 
-    const csmInt32 drawableCount = GetModel()->GetDrawableCount();
-    const csmInt32* renderOrder = GetModel()->GetDrawableRenderOrders();
+            // 作成時にバッファのバインドが変わる
+            _stateCache.Invalidate();
+        }
 
-    // インデックスを描画順でソート
-    for (csmInt32 i = 0; i < drawableCount; ++i)
+        _vertexBuffer.UpdatePositions(*GetModel(), _stateCache);
+        _stateCache.BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else if (_vertexBuffer.IsValid())
     {
-        const csmInt32 order = renderOrder[i];
-        _sortedDrawableIndexList[order] = i;
+        _vertexBuffer.DestroyBuffers();
+
+        // 破棄したバッファがバインドされていた場合は0に戻る
+        _stateCache.Invalidate();
     }
 
-    // 描画
-    for (csmInt32 i = 0; i < drawableCount; ++i)
+    // 描画命令を再生する
+    CubismOffscreenSurface_OpenGLES2* currentMaskBuffer = NULL;
+    const CubismClippingContext_OpenGLES2* scissorContext = NULL;
+    csmInt32 batchIndex = 0;
+
+    for (csmInt32 i = 0; i < _commandList.GetCommandCount(); ++i)
     {
-        const csmInt32 drawableIndex = _sortedDrawableIndexList[i];
+        const CubismRenderCommandList::Command& command = _commandList.GetCommand(i);
+        CubismClippingContext_OpenGLES2* clipContext = static_cast<CubismClippingContext_OpenGLES2*>(command.ClipContext);
 
-        // Drawableが表示状態でなければ処理をパスする
-        if (!GetModel()->GetDrawableDynamicFlagIsVisible(drawableIndex))
+        // まとめた描画は先頭の命令で描き、残りの命令は飛ばす
+        const CubismDrawBatcher::Batch* batch = NULL;
+        if (IsUsingDrawBatching())
         {
-            continue;
+            batch = &_drawBatcher.GetBatch(batchIndex++);
+            i += batch->CommandCount - 1;
+
+            if (batch->CommandCount == 1)
+            {
+                batch = NULL;
+            }
         }
 
-        // クリッピングマスク
-        CubismClippingContext_OpenGLES2* clipContext = (_clippingManager != NULL)
-            ? (*_clippingManager->GetClippingContextListForDraw())[drawableIndex]
-            : NULL;
+        if (command.Type == CubismRenderCommandList::CommandType_Draw)
+        {
+            if (currentMaskBuffer != NULL)
+            {
+                EndMaskBuffer(currentMaskBuffer);
+                currentMaskBuffer = NULL;
+            }
+
+            // クリッピングマスクをセットする
+            SetClippingContextBufferForDraw(clipContext);
+
+            IsCulling(command.IsCulling);
+
+            DrawMeshOpenGL(*GetModel(), command.DrawableIndex, batch);
+            continue;
+        }
 
-        if (clipContext != NULL && IsUsingHighPrecisionMask()) // マスクを書く必要がある
+        // 現在のマスク用バッファが命令のものと異なる場合は切り替える
+        CubismOffscreenSurface_OpenGLES2* maskBuffer = GetMaskBuffer(command.BufferIndex);
+        if (currentMaskBuffer != maskBuffer)
         {
-            if(clipContext->_isUsing) // 書くことになっていた
+            if (currentMaskBuffer != NULL)
+            {
+                currentMaskBuffer->EndDraw();
+            }
+            else
             {
                 // 生成したOffscreenSurfaceと同じサイズでビューポートを設定
                 glViewport(0, 0, _clippingManager->GetClippingMaskBufferSize().X, _clippingManager->GetClippingMaskBufferSize().Y);
+            }
+
+            // マスク用RenderTextureをactiveにセット
+            currentMaskBuffer = maskBuffer;
+            currentMaskBuffer->BeginDraw(_rendererProfile._lastFBO);
 
-                PreDraw(); // バッファをクリアする
+            PreDraw(); // バッファをクリアする
+            scissorContext = NULL;
+        }
 
-                // ---------- マスク描画処理 ----------
-                // マスク用RenderTextureをactiveにセット
-                GetMaskBuffer(clipContext->_bufferIndex)->BeginDraw(_rendererProfile._lastFBO);
+        // 1が無効（描かれない）領域、0が有効（描かれる）領域。（シェーダーCd*Csで0に近い値をかけてマスクを作る。1をかけると何も起こらない）
+        switch (command.Type)
+        {
+        case CubismRenderCommandList::CommandType_ClearMaskBuffer:
+            _stateCache.SetEnabled(GL_SCISSOR_TEST, false);
+            scissorContext = NULL;
+            glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            break;
+
+        case CubismRenderCommandList::CommandType_ClearMask:
+            {
+                // このマスクのチャンネルの、割り当てられた領域だけをクリアする
+                if (scissorContext != clipContext)
+                {
+                    SetScissorForMask(clipContext);
+                    scissorContext = clipContext;
+                }
 
-                // マスクをクリアする
-                // 1が無効（描かれない）領域、0が有効（描かれる）領域。（シェーダで Cd*Csで0に近い値をかけてマスクを作る。1をかけると何も起こらない）
+                const csmInt32 channelIndex = clipContext->_layoutChannelIndex;
                 glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+                _stateCache.ColorMask(channelIndex == 0, channelIndex == 1, channelIndex == 2, channelIndex == 3);
                 glClear(GL_COLOR_BUFFER_BIT);
+                _stateCache.ColorMask(1, 1, 1, 1);
             }
+            break;
 
+        case CubismRenderCommandList::CommandType_DrawMask:
+            // 高精細マスクはバッファ全体を1つのマスクが使う
+            if (!IsUsingHighPrecisionMask() && scissorContext != clipContext)
             {
-                const csmInt32 clipDrawCount = clipContext->_clippingIdCount;
-                for (csmInt32 index = 0; index < clipDrawCount; index++)
-                {
-                    const csmInt32 clipDrawIndex = clipContext->_clippingIdList[index];
+                SetScissorForMask(clipContext);
+                scissorContext = clipContext;
+            }
 
-                    // 頂点情報が更新されておらず、信頼性がない場合は描画をパスする
-                    if (!GetModel()->GetDrawableDynamicFlagVertexPositionsDidChange(clipDrawIndex))
-                    {
-                        continue;
-                    }
+            IsCulling(command.IsCulling);
 
-                    IsCulling(GetModel()->GetDrawableCulling(clipDrawIndex) != 0);
+            // 今回専用の変換を適用して描く
+            // チャンネルも切り替える必要がある(A,R,G,B)
+            SetClippingContextBufferForMask(clipContext);
 
-                    // 今回専用の変換を適用して描く
-                    // チャンネルも切り替える必要がある(A,R,G,B)
-                    SetClippingContextBufferForMask(clipContext);
+            DrawMeshOpenGL(*GetModel(), command.DrawableIndex, batch);
+            break;
 
-                    DrawMeshOpenGL(*GetModel(), clipDrawIndex);
-                }
-            }
+        default:
+            break;
+        }
+    }
 
-            {
-                // --- 後処理 ---
-                GetMaskBuffer(clipContext->_bufferIndex)->EndDraw();
-                SetClippingContextBufferForMask(NULL);
-                glViewport(_rendererProfile._lastViewport[0], _rendererProfile._lastViewport[1], _rendererProfile._lastViewport[2], _rendererProfile._lastViewport[3]);
+    if (currentMaskBuffer != NULL)
+    {
+        EndMaskBuffer(currentMaskBuffer);
+    }
 
-                PreDraw(); // バッファをクリアする
-            }
-        }
+    PostDraw();
+
+}
 
-        // クリッピングマスクをセットする
-        SetClippingContextBufferForDraw(clipContext);
+void CubismRenderer_OpenGLES2::SetScissorForMask(const CubismClippingContext_OpenGLES2* clipContext)
+{
+    // 割り当てられた領域をピクセル単位に直し、描画をその中に限定する
+    // 描き直すマスクが、割り当てられた領域の外にある他のマスクを壊さないようにする
+    const csmRectF* layoutBoundsOnTex01 = clipContext->_layoutBounds;
+    const CubismVector2 maskBufferSize = _clippingManager->GetClippingMaskBufferSize();
+    const GLint left = static_cast<GLint>(layoutBoundsOnTex01->X * maskBufferSize.X + 0.5f);
+    const GLint bottom = static_cast<GLint>(layoutBoundsOnTex01->Y * maskBufferSize.Y + 0.5f);
+    const GLint right = static_cast<GLint>((layoutBoundsOnTex01->X + layoutBoundsOnTex01->Width) * maskBufferSize.X + 0.5f);
+    const GLint top = static_cast<GLint>((layoutBoundsOnTex01->Y + layoutBoundsOnTex01->Height) * maskBufferSize.Y + 0.5f);
 
-        IsCulling(GetModel()->GetDrawableCulling(drawableIndex) != 0);
+    _stateCache.SetEnabled(GL_SCISSOR_TEST, true);
+    glScissor(left, bottom, right - left, top - bottom);
+}
 
-        DrawMeshOpenGL(*GetModel(), drawableIndex);
-    }
+void CubismRenderer_OpenGLES2::EndMaskBuffer(CubismOffscreenSurface_OpenGLES2* maskBuffer)
+{
+    _stateCache.SetEnabled(GL_SCISSOR_TEST, false);
 
-    PostDraw();
+    // --- 後処理 ---
+    maskBuffer->EndDraw();
+    SetClippingContextBufferForMask(NULL);
+    glViewport(_rendererProfile._lastViewport[0], _rendererProfile._lastViewport[1], _rendererProfile._lastViewport[2], _rendererProfile._lastViewport[3]);
 
+    PreDraw(); // バッファをクリアする
 }
 
-void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const csmInt32 index)
+void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const csmInt32 index, const CubismDrawBatcher::Batch* batch)
 {
 
 #ifdef CSM_TARGET_WIN_GL
@@ -662,26 +614,38 @@ void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const cs
 #endif
 
     // 裏面描画の有効・無効
-    if (IsCulling())
-    {
-        glEnable(GL_CULL_FACE);
-    }
-    else
-    {
-        glDisable(GL_CULL_FACE);
-    }
+    _stateCache.SetEnabled(GL_CULL_FACE, IsCulling());
 
-    glFrontFace(GL_CCW);    // Cubism SDK OpenGLはマスク・アートメッシュ共にCCWが表面
+    _stateCache.FrontFace(GL_CCW);    // Cubism SDK OpenGLはマスク・アートメッシュ共にCCWが表面
 
     if (IsGeneratingMask())  // マスク生成時
     {
-        CubismShader_OpenGLES2::GetInstance()->SetupShaderProgramForMask(this, model, index);
+        CubismShader_OpenGLES2::GetInstance()->SetupShaderProgramForMask(this, model, index, batch);
     }
     else{
-        CubismShader_OpenGLES2::GetInstance()->SetupShaderProgramForDraw(this, model, index);
+        CubismShader_OpenGLES2::GetInstance()->SetupShaderProgramForDraw(this, model, index, batch);
     }
 
     // ポリゴンメッシュを描画する
+    if (batch != NULL)
+    {
+        // まとめた描画オブジェクトを1回で描く
+        // まとめた頂点列は毎フレーム作り直すため、CPUのメモリから渡す
+        const csmUint16* indexArray = _drawBatcher.GetIndices() + batch->IndexOffset;
+        if (IsUsingVertexBufferObjects())
+        {
+            _stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        }
+        glDrawElements(GL_TRIANGLES, batch->IndexCount, GL_UNSIGNED_SHORT, indexArray);
+        CubismShader_OpenGLES2::GetInstance()->DisableVertexColorAttributes(this);
+    }
+    else if (IsUsingVertexBufferObjects())
+    {
+        csmInt32 indexCount = model.GetDrawableVertexIndexCount(index);
+        _vertexBuffer.BindIndexBuffer(_stateCache);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, _vertexBuffer.GetIndexOffset(index));
+    }
+    else
     {
         csmInt32 indexCount = model.GetDrawableVertexIndexCount(index);
         csmUint16* indexArray = const_cast<csmUint16*>(model.GetDrawableVertexIndices(index));
@@ -689,19 +653,46 @@ void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const cs
     }
 
     // 後処理
-    glUseProgram(0);
+    // プログラムは次の描画で同じものを使うことが多いため、外さずに残す
     SetClippingContextBufferForDraw(NULL);
     SetClippingContextBufferForMask(NULL);
 }
 
+const CubismDrawBatcher& CubismRenderer_OpenGLES2::GetDrawBatcher() const
+{
+    return _drawBatcher;
+}
+
+CubismStateCache_OpenGLES2& CubismRenderer_OpenGLES2::GetStateCache()
+{
+    return _stateCache;
+}
+
 void CubismRenderer_OpenGLES2::SaveProfile()
 {
+    // 描画の間にアプリケーションがステートを変更している可能性があるため、覚えているステートは使わない
+    _stateCache.ResetCallCounts();
+    _stateCache.Invalidate();
+
+    if (IsUsingCooperativeStateMode())
+    {
+        // 描画先はSetCooperativeRenderTarget()で受け取っている
+        _stateCache.AddAvoidedCallCount(CubismRendererProfile_OpenGLES2::SaveCallCount);
+        return;
+    }
+
     _rendererProfile.Save();
 }
 
 void CubismRenderer_OpenGLES2::RestoreProfile()
 {
-    _rendererProfile.Restore();
+    if (IsUsingCooperativeStateMode())
+    {
+        _stateCache.AddAvoidedCallCount(CubismRendererProfile_OpenGLES2::RestoreCallCount);
+        return;
+    }
+
+    _rendererProfile.Restore(_stateCache);
 }
 
 void CubismRenderer_OpenGLES2::BindTexture(csmUint32 modelTextureIndex, GLuint glTextureIndex)
@@ -747,11 +738,65 @@ CubismVector2 CubismRenderer_OpenGLES2::GetClippingMaskBufferSize() const
     return _clippingManager->GetClippingMaskBufferSize();
 }
 
+csmInt32 CubismRenderer_OpenGLES2::GetSkippedClippingContextCount() const
+{
+    return (_clippingManager != NULL) ? _clippingManager->GetSkippedContextCount() : 0;
+}
+
+csmInt32 CubismRenderer_OpenGLES2::GetRedrawnClippingContextCount() const
+{
+    return (_clippingManager != NULL) ? _clippingManager->GetRedrawnContextCount() : 0;
+}
+
 CubismOffscreenSurface_OpenGLES2* CubismRenderer_OpenGLES2::GetMaskBuffer(csmInt32 index)
 {
     return &_offscreenSurfaces[index];
 }
 
+void CubismRenderer_OpenGLES2::UseVertexBufferObjects(csmBool enable)
+{
+    _useVertexBufferObjects = enable;
+}
+
+csmBool CubismRenderer_OpenGLES2::IsUsingVertexBufferObjects() const
+{
+    return _useVertexBufferObjects;
+}
+
+const CubismVertexBuffer_OpenGLES2& CubismRenderer_OpenGLES2::GetVertexBuffer() const
+{
+    return _vertexBuffer;
+}
+
+void CubismRenderer_OpenGLES2::UseCooperativeStateMode(csmBool enable)
+{
+    _useCooperativeStateMode = enable;
+}
+
+csmBool CubismRenderer_OpenGLES2::IsUsingCooperativeStateMode() const
+{
+    return _useCooperativeStateMode;
+}
+
+void CubismRenderer_OpenGLES2::SetCooperativeRenderTarget(GLint framebuffer, GLint x, GLint y, GLint width, GLint height)
+{
+    _rendererProfile._lastFBO = framebuffer;
+    _rendererProfile._lastViewport[0] = x;
+    _rendererProfile._lastViewport[1] = y;
+    _rendererProfile._lastViewport[2] = width;
+    _rendererProfile._lastViewport[3] = height;
+}
+
+csmInt32 CubismRenderer_OpenGLES2::GetAvoidedGlCallCount() const
+{
+    return _stateCache.GetAvoidedCallCount();
+}
+
+csmInt32 CubismRenderer_OpenGLES2::GetIssuedGlCallCount() const
+{
+    return _stateCache.GetIssuedCallCount();
+}
+
 void CubismRenderer_OpenGLES2::SetClippingContextBufferForMask(CubismClippingContext_OpenGLES2* clip)
 {
     _clippingContextBufferForMask = clip;
@@ -9,9 +9,13 @@
 
 #include "../CubismRenderer.hpp"
 #include "../CubismClippingManager.hpp"
+#include "../CubismRenderCommandList.hpp"
+#include "../CubismDrawBatcher.hpp"
 #include "CubismFramework.hpp"
 #include "CubismOffscreenSurface_OpenGLES2.hpp"
 #include "CubismShader_OpenGLES2.hpp"
+#include "CubismStateCache_OpenGLES2.hpp"
+#include "CubismVertexBuffer_OpenGLES2.hpp"
 #include "Type/csmVector.hpp"
 #include "Type/csmRectF.hpp"
 #include "Math/CubismVector2.hpp"
@@ -55,17 +59,7 @@ class CubismShader_OpenGLES2;
  */
 class CubismClippingManager_OpenGLES2 : public CubismClippingManager<CubismClippingContext_OpenGLES2, CubismOffscreenSurface_OpenGLES2>
 {
-public:
-
-    /**
-     * @brief   クリッピングコンテキストを作成する。モデル描画時に実行する。
-     *
-     * @param[in]   model        ->  モデルのインスタンス
-     * @param[in]   renderer     ->  レンダラのインスタンス
-     * @param[in]   lastFBO      ->  フレームバッファ
-     * @param[in]   lastViewport ->  ビューポート
-     */
-    void SetupClippingContext(CubismModel& model, CubismRenderer_OpenGLES2* renderer, GLint lastFBO, GLint lastViewport[4]);
+    // マスクの作成は CubismClippingManager::RecordMaskCommands で記録し、CubismRenderer_OpenGLES2::DoDrawModel で再生する
 };
 
 /**
@@ -110,39 +104,31 @@ private:
     /**
      * @biref   privateなコンストラクタ
      */
-    CubismRendererProfile_OpenGLES2() {};
+    CubismRendererProfile_OpenGLES2() : _lastFBO(0)
+    {
+        _lastViewport[0] = _lastViewport[1] = _lastViewport[2] = _lastViewport[3] = 0;
+    };
 
     /**
      * @biref   privateなデストラクタ
      */
     virtual ~CubismRendererProfile_OpenGLES2() {};
 
+    static const csmInt32 SaveCallCount = 25;       ///< Save()で発行するOpenGLES2の呼び出しの数
+    static const csmInt32 RestoreCallCount = 20;    ///< Restore()で発行するOpenGLES2の呼び出しの数
+
     /**
      * @brief   OpenGLES2のステートを保持する
      */
     void Save();
 
     /**
-     * @brief   保持したOpenGLES2のステートを復帰させる
-     *
-     */
-    void Restore();
-
-    /**
-     * @brief   OpenGLES2の機能の有効・無効をセットする
+     * @brief   保持したOpenGLES2のステートを復帰させる<br>
+     *           ステートキャッシュを通して設定し、描画後の値と同じものは省略する
      *
-     * @param[in]   index   ->  有効・無効にする機能
-     * @param[in]   enabled ->  trueなら有効にする
+     * @param[in]   stateCache  ->  レンダラのステートキャッシュ
      */
-    void SetGlEnable(GLenum index, GLboolean enabled);
-
-    /**
-     * @brief   OpenGLES2のVertex Attribute Array機能の有効・無効をセットする
-     *
-     * @param[in]   index   ->  有効・無効にする機能
-     * @param[in]   enabled ->  trueなら有効にする
-     */
-    void SetGlEnableVertexAttribArray(GLuint index, GLint enabled);
+    void Restore(CubismStateCache_OpenGLES2& stateCache);
 
     GLint _lastArrayBufferBinding;          ///< モデル描画直前の頂点バッファ
     GLint _lastElementArrayBufferBinding;   ///< モデル描画直前のElementバッファ
@@ -226,6 +212,22 @@ public:
      */
     CubismVector2 GetClippingMaskBufferSize() const;
 
+    /**
+     * @brief  直前の描画で、前回のマスクをそのまま使ったクリッピングコンテキストの数を取得する
+     *
+     * @return 作り直しを省略したクリッピングコンテキストの数
+     *
+     */
+    csmInt32 GetSkippedClippingContextCount() const;
+
+    /**
+     * @brief  直前の描画で、マスクを作り直したクリッピングコンテキストの数を取得する
+     *
+     * @return 作り直したクリッピングコンテキストの数
+     *
+     */
+    csmInt32 GetRedrawnClippingContextCount() const;
+
     /**
      * @brief  クリッピングマスクのバッファを取得する
      *
@@ -234,6 +236,81 @@ public:
      */
     CubismOffscreenSurface_OpenGLES2* GetMaskBuffer(csmInt32 index);
 
+    /**
+     * @brief  頂点をGPUのバッファに保持して描画するかを設定する<br>
+     *         有効にすると、UVとインデックスは最初の描画で1度だけ転送し、頂点位置は変化したDrawableの範囲だけを転送する。
+     *         無効にすると、描画ごとにCPUのメモリ上の頂点を渡す。バッファの作成・破棄は次の描画で行う。
+     *
+     * @param[in]  enable -> trueなら頂点をGPUのバッファに保持する
+     *
+     */
+    void UseVertexBufferObjects(csmBool enable);
+
+    /**
+     * @brief  頂点をGPUのバッファに保持して描画するかを取得する
+     *
+     * @return trueなら頂点をGPUのバッファに保持する
+     *
+     */
+    csmBool IsUsingVertexBufferObjects() const;
+
+    /**
+     * @brief  頂点を保持するGPUのバッファを取得する
+     *
+     * @return 頂点を保持するバッファ
+     *
+     */
+    const CubismVertexBuffer_OpenGLES2& GetVertexBuffer() const;
+
+    /**
+     * @brief  アプリケーションがOpenGLのステートを管理する協調モードを設定する<br>
+     *         有効にすると、描画前のステートの問い合わせと描画後の復帰を行わない。
+     *         描画後のステートは不定になるため、アプリケーションは次の描画の前に必要なステートを自分で設定すること。
+     *         描画先のフレームバッファとビューポートはSetCooperativeRenderTarget()で渡す
+     *
+     * @param[in]  enable -> trueなら協調モードにする
+     *
+     */
+    void UseCooperativeStateMode(csmBool enable);
+
+    /**
+     * @brief  協調モードかを取得する
+     *
+     * @return trueなら協調モード
+     *
+     */
+    csmBool IsUsingCooperativeStateMode() const;
+
+    /**
+     * @brief  協調モードで、モデルを描画するフレームバッファとビューポートを設定する<br>
+     *         マスクを描いた後に描画先を戻すために使う
+     *
+     * @param[in]  framebuffer -> 描画先のフレームバッファ
+     * @param[in]  x           -> ビューポートの左端
+     * @param[in]  y           -> ビューポートの下端
+     * @param[in]  width       -> ビューポートの幅
+     * @param[in]  height      -> ビューポートの高さ
+     *
+     */
+    void SetCooperativeRenderTarget(GLint framebuffer, GLint x, GLint y, GLint width, GLint height);
+
+    /**
+     * @brief  直前のモデルの描画で、ステートキャッシュが省略したOpenGLの呼び出しの数を取得する<br>
+     *         協調モードで省略したステートの問い合わせと復帰の呼び出しも含む
+     *
+     * @return 省略した呼び出しの数
+     *
+     */
+    csmInt32 GetAvoidedGlCallCount() const;
+
+    /**
+     * @brief  直前のモデルの描画で、ステートキャッシュを通して発行したOpenGLの呼び出しの数を取得する
+     *
+     * @return 発行した呼び出しの数
+     *
+     */
+    csmInt32 GetIssuedGlCallCount() const;
+
 protected:
     /**
      * @brief   コンストラクタ
@@ -256,9 +333,10 @@ protected:
      *
      * @param[in]   model       ->  描画対象のモデル
      * @param[in]   index       ->  描画対象のメッシュのインデックス
+     * @param[in]   batch       ->  まとめて描く場合はまとめた描画。NULLならindexの描画オブジェクトだけを描く
      *
      */
-    void DrawMeshOpenGL(const CubismModel& model, const csmInt32 index);
+    void DrawMeshOpenGL(const CubismModel& model, const csmInt32 index, const CubismDrawBatcher::Batch* batch = NULL);
 
 #ifdef CSM_TARGET_ANDROID_ES2
 public:
@@ -340,6 +418,20 @@ private:
      */
     const csmBool inline IsGeneratingMask() const;
 
+    /**
+     * @brief   マスクの描画をクリッピングコンテキストに割り当てられた領域に限定する
+     *
+     * @param[in]   clipContext ->  描き込むクリッピングコンテキスト
+     */
+    void SetScissorForMask(const CubismClippingContext_OpenGLES2* clipContext);
+
+    /**
+     * @brief   マスク用バッファへの描画を終え、モデル描画直前のフレームバッファとビューポートに戻す
+     *
+     * @param[in]   maskBuffer  ->  描画中のマスク用バッファ
+     */
+    void EndMaskBuffer(CubismOffscreenSurface_OpenGLES2* maskBuffer);
+
     /**
      * @brief   テクスチャマップにバインドされたテクスチャIDを取得する。<br>
      *          バインドされていなければダミーとして-1が返される。
@@ -348,6 +440,20 @@ private:
      */
     GLuint GetBindedTextureId(csmInt32 textureId);
 
+    /**
+     * @brief   描画オブジェクトをまとめた頂点列を取得する
+     *
+     * @return  描画オブジェクトをまとめた頂点列
+     */
+    const CubismDrawBatcher& GetDrawBatcher() const;
+
+    /**
+     * @brief   OpenGLのステートを設定するためのステートキャッシュを取得する
+     *
+     * @return  ステートキャッシュ
+     */
+    CubismStateCache_OpenGLES2& GetStateCache();
+
 #ifdef CSM_TARGET_WIN_GL
     /**
      * @brief   Windows対応。OpenGL命令のバインドを行う。
@@ -366,7 +472,12 @@ private:
 #endif
 
     csmMap<csmInt32, GLuint> _textures;                      ///< モデルが参照するテクスチャとレンダラでバインドしているテクスチャとのマップ
-    csmVector<csmInt32> _sortedDrawableIndexList;       ///< 描画オブジェクトのインデックスを描画順に並べたリスト
+    CubismRenderCommandList _commandList;                    ///< 1フレーム分の描画命令
+    CubismDrawBatcher _drawBatcher;                          ///< まとめて描く描画オブジェクトの頂点列
+    CubismVertexBuffer_OpenGLES2 _vertexBuffer;              ///< 頂点を保持するGPUのバッファ
+    csmBool _useVertexBufferObjects;                         ///< 頂点をGPUのバッファに保持して描画するか
+    CubismStateCache_OpenGLES2 _stateCache;                  ///< 設定したOpenGLのステートを覚え、同じ設定を省略するオブジェクト
+    csmBool _useCooperativeStateMode;                        ///< アプリケーションがOpenGLのステートを管理するか
     CubismRendererProfile_OpenGLES2 _rendererProfile;               ///< OpenGLのステートを保持するオブジェクト
     CubismClippingManager_OpenGLES2* _clippingManager;               ///< クリッピングマスク管理オブジェクト
     CubismClippingContext_OpenGLES2* _clippingContextBufferForMask;  ///< マスクテクスチャに描画するためのクリッピングコンテキスト
@@ -26,7 +26,7 @@ namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering
 *                                       CubismShader_OpenGLES2
 ********************************************************************************************************************/
 namespace {
-    const csmInt32 ShaderCount = 19; ///< シェーダの数 = マスク生成用 + (通常 + 加算 + 乗算) * (マスク無 + マスク有 + マスク有反転 + マスク無の乗算済アルファ対応版 + マスク有の乗算済アルファ対応版 + マスク有反転の乗算済アルファ対応版)
+    const csmInt32 ShaderCount = 25; ///< シェーダの数 = マスク生成用 + (通常 + 加算 + 乗算 + 頂点カラー) * (マスク無 + マスク有 + マスク有反転 + マスク無の乗算済アルファ対応版 + マスク有の乗算済アルファ対応版 + マスク有反転の乗算済アルファ対応版)
     CubismShader_OpenGLES2* s_instance;
 }
 
@@ -58,6 +58,14 @@ enum ShaderNames
     ShaderNames_MultPremultipliedAlpha,
     ShaderNames_MultMaskedPremultipliedAlpha,
     ShaderNames_MultMaskedPremultipliedAlphaInverted,
+
+    //VertexColor
+    ShaderNames_VertexColor,
+    ShaderNames_VertexColorMasked,
+    ShaderNames_VertexColorMaskedInverted,
+    ShaderNames_VertexColorPremultipliedAlpha,
+    ShaderNames_VertexColorMaskedPremultipliedAlpha,
+    ShaderNames_VertexColorMaskedInvertedPremultipliedAlpha,
 };
 
 // SetupMask
@@ -460,6 +468,224 @@ static const csmChar* FragShaderSrcMaskInvertedPremultipliedAlphaTegra =
         "}";
 #endif
 
+//----- 頂点カラー対応版 -----
+// 色の異なる描画オブジェクトをまとめて描くときに、ベースカラー・乗算色・スクリーン色を頂点属性で受け取る
+// 拡張方式(Tegra)でもフレームバッファフェッチは使わないため、同じソースを使う
+
+// Normal & Add & Mult 共通（頂点カラー）
+static const csmChar* VertShaderSrcVertexColor =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2)
+        "#version 100\n"
+#else
+        "#version 120\n"
+#endif
+        "attribute vec4 a_position;"
+        "attribute vec2 a_texCoord;"
+        "attribute vec4 a_baseColor;"
+        "attribute vec4 a_multiplyColor;"
+        "attribute vec4 a_screenColor;"
+        "varying vec2 v_texCoord;"
+        "varying vec4 v_baseColor;"
+        "varying vec4 v_multiplyColor;"
+        "varying vec4 v_screenColor;"
+        "uniform mat4 u_matrix;"
+        "void main()"
+        "{"
+        "gl_Position = u_matrix * a_position;"
+        "v_texCoord = a_texCoord;"
+        "v_texCoord.y = 1.0 - v_texCoord.y;"
+        "v_baseColor = a_baseColor;"
+        "v_multiplyColor = a_multiplyColor;"
+        "v_screenColor = a_screenColor;"
+        "}";
+
+// Normal & Add & Mult 共通（頂点カラー、クリッピングされたものの描画用）
+static const csmChar* VertShaderSrcVertexColorMasked =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2)
+        "#version 100\n"
+#else
+        "#version 120\n"
+#endif
+        "attribute vec4 a_position;"
+        "attribute vec2 a_texCoord;"
+        "attribute vec4 a_baseColor;"
+        "attribute vec4 a_multiplyColor;"
+        "attribute vec4 a_screenColor;"
+        "varying vec2 v_texCoord;"
+        "varying vec4 v_clipPos;"
+        "varying vec4 v_baseColor;"
+        "varying vec4 v_multiplyColor;"
+        "varying vec4 v_screenColor;"
+        "uniform mat4 u_matrix;"
+        "uniform mat4 u_clipMatrix;"
+        "void main()"
+        "{"
+        "gl_Position = u_matrix * a_position;"
+        "v_clipPos = u_clipMatrix * a_position;"
+        "v_texCoord = a_texCoord;"
+        "v_texCoord.y = 1.0 - v_texCoord.y;"
+        "v_baseColor = a_baseColor;"
+        "v_multiplyColor = a_multiplyColor;"
+        "v_screenColor = a_screenColor;"
+        "}";
+
+// Normal & Add & Mult 共通（頂点カラー）
+static const csmChar* FragShaderSrcVertexColor =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2)
+        "#version 100\n"
+        "precision " CSM_FRAGMENT_SHADER_FP_PRECISION " float;"
+#else
+        "#version 120\n"
+#endif
+        "varying vec2 v_texCoord;"
+        "varying vec4 v_baseColor;"
+        "varying vec4 v_multiplyColor;"
+        "varying vec4 v_screenColor;"
+        "uniform sampler2D s_texture0;"
+        "void main()"
+        "{"
+        "vec4 texColor = texture2D(s_texture0 , v_texCoord);"
+        "texColor.rgb = texColor.rgb * v_multiplyColor.rgb;"
+        "texColor.rgb = texColor.rgb + v_screenColor.rgb - (texColor.rgb * v_screenColor.rgb);"
+        "vec4 color = texColor * v_baseColor;"
+        "gl_FragColor = vec4(color.rgb * color.a,  color.a);"
+        "}";
+
+// Normal & Add & Mult 共通（頂点カラー、PremultipliedAlpha）
+static const csmChar* FragShaderSrcVertexColorPremultipliedAlpha =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2)
+        "#version 100\n"
+        "precision " CSM_FRAGMENT_SHADER_FP_PRECISION " float;"
+#else
+        "#version 120\n"
+#endif
+        "varying vec2 v_texCoord;"
+        "varying vec4 v_baseColor;"
+        "varying vec4 v_multiplyColor;"
+        "varying vec4 v_screenColor;"
+        "uniform sampler2D s_texture0;"
+        "void main()"
+        "{"
+        "vec4 texColor = texture2D(s_texture0 , v_texCoord);"
+        "texColor.rgb = texColor.rgb * v_multiplyColor.rgb;"
+        "texColor.rgb = (texColor.rgb + v_screenColor.rgb * texColor.a) - (texColor.rgb * v_screenColor.rgb);"
+        "gl_FragColor = texColor * v_baseColor;"
+        "}";
+
+// Normal & Add & Mult 共通（頂点カラー、クリッピングされたものの描画用）
+static const csmChar* FragShaderSrcVertexColorMask =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2)
+        "#version 100\n"
+        "precision " CSM_FRAGMENT_SHADER_FP_PRECISION " float;"
+#else
+        "#version 120\n"
+#endif
+        "varying vec2 v_texCoord;"
+        "varying vec4 v_clipPos;"
+        "varying vec4 v_baseColor;"
+        "varying vec4 v_multiplyColor;"
+        "varying vec4 v_screenColor;"
+        "uniform sampler2D s_texture0;"
+        "uniform sampler2D s_texture1;"
+        "uniform vec4 u_channelFlag;"
+        "void main()"
+        "{"
+        "vec4 texColor = texture2D(s_texture0 , v_texCoord);"
+        "texColor.rgb = texColor.rgb * v_multiplyColor.rgb;"
+        "texColor.rgb = texColor.rgb + v_screenColor.rgb - (texColor.rgb * v_screenColor.rgb);"
+        "vec4 col_formask = texColor * v_baseColor;"
+        "col_formask.rgb = col_formask.rgb  * col_formask.a ;"
+        "vec4 clipMask = (1.0 - texture2D(s_texture1, v_clipPos.xy / v_clipPos.w)) * u_channelFlag;"
+        "float maskVal = clipMask.r + clipMask.g + clipMask.b + clipMask.a;"
+        "col_formask = col_formask * maskVal;"
+        "gl_FragColor = col_formask;"
+        "}";
+
+// Normal & Add & Mult 共通（頂点カラー、クリッピングされて反転使用の描画用）
+static const csmChar* FragShaderSrcVertexColorMaskInverted =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2)
+        "#version 100\n"
+        "precision " CSM_FRAGMENT_SHADER_FP_PRECISION " float;"
+#else
+        "#version 120\n"
+#endif
+        "varying vec2 v_texCoord;"
+        "varying vec4 v_clipPos;"
+        "varying vec4 v_baseColor;"
+        "varying vec4 v_multiplyColor;"
+        "varying vec4 v_screenColor;"
+        "uniform sampler2D s_texture0;"
+        "uniform sampler2D s_texture1;"
+        "uniform vec4 u_channelFlag;"
+        "void main()"
+        "{"
+        "vec4 texColor = texture2D(s_texture0 , v_texCoord);"
+        "texColor.rgb = texColor.rgb * v_multiplyColor.rgb;"
+        "texColor.rgb = texColor.rgb + v_screenColor.rgb - (texColor.rgb * v_screenColor.rgb);"
+        "vec4 col_formask = texColor * v_baseColor;"
+        "col_formask.rgb = col_formask.rgb  * col_formask.a ;"
+        "vec4 clipMask = (1.0 - texture2D(s_texture1, v_clipPos.xy / v_clipPos.w)) * u_channelFlag;"
+        "float maskVal = clipMask.r + clipMask.g + clipMask.b + clipMask.a;"
+        "col_formask = col_formask * (1.0 - maskVal);"
+        "gl_FragColor = col_formask;"
+        "}";
+
+// Normal & Add & Mult 共通（頂点カラー、クリッピングされたものの描画用、PremultipliedAlphaの場合）
+static const csmChar* FragShaderSrcVertexColorMaskPremultipliedAlpha =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2)
+        "#version 100\n"
+        "precision " CSM_FRAGMENT_SHADER_FP_PRECISION " float;"
+#else
+        "#version 120\n"
+#endif
+        "varying vec2 v_texCoord;"
+        "varying vec4 v_clipPos;"
+        "varying vec4 v_baseColor;"
+        "varying vec4 v_multiplyColor;"
+        "varying vec4 v_screenColor;"
+        "uniform sampler2D s_texture0;"
+        "uniform sampler2D s_texture1;"
+        "uniform vec4 u_channelFlag;"
+        "void main()"
+        "{"
+        "vec4 texColor = texture2D(s_texture0 , v_texCoord);"
+        "texColor.rgb = texColor.rgb * v_multiplyColor.rgb;"
+        "texColor.rgb = (texColor.rgb + v_screenColor.rgb * texColor.a) - (texColor.rgb * v_screenColor.rgb);"
+        "vec4 col_formask = texColor * v_baseColor;"
+        "vec4 clipMask = (1.0 - texture2D(s_texture1, v_clipPos.xy / v_clipPos.w)) * u_channelFlag;"
+        "float maskVal = clipMask.r + clipMask.g + clipMask.b + clipMask.a;"
+        "col_formask = col_formask * maskVal;"
+        "gl_FragColor = col_formask;"
+        "}";
+
+// Normal & Add & Mult 共通（頂点カラー、クリッピングされて反転使用の描画用、PremultipliedAlphaの場合）
+static const csmChar* FragShaderSrcVertexColorMaskInvertedPremultipliedAlpha =
+#if defined(CSM_TARGET_IPHONE_ES2) || defined(CSM_TARGET_ANDROID_ES2)
+        "#version 100\n"
+        "precision " CSM_FRAGMENT_SHADER_FP_PRECISION " float;"
+#else
+        "#version 120\n"
+#endif
+        "varying vec2 v_texCoord;"
+        "varying vec4 v_clipPos;"
+        "varying vec4 v_baseColor;"
+        "varying vec4 v_multiplyColor;"
+        "varying vec4 v_screenColor;"
+        "uniform sampler2D s_texture0;"
+        "uniform sampler2D s_texture1;"
+        "uniform vec4 u_channelFlag;"
+        "void main()"
+        "{"
+        "vec4 texColor = texture2D(s_texture0 , v_texCoord);"
+        "texColor.rgb = texColor.rgb * v_multiplyColor.rgb;"
+        "texColor.rgb = (texColor.rgb + v_screenColor.rgb * texColor.a) - (texColor.rgb * v_screenColor.rgb);"
+        "vec4 col_formask = texColor * v_baseColor;"
+        "vec4 clipMask = (1.0 - texture2D(s_texture1, v_clipPos.xy / v_clipPos.w)) * u_channelFlag;"
+        "float maskVal = clipMask.r + clipMask.g + clipMask.b + clipMask.a;"
+        "col_formask = col_formask * (1.0 - maskVal);"
+        "gl_FragColor = col_formask;"
+        "}";
+
 void CubismShader_OpenGLES2::ReleaseShaderProgram()
 {
     for (csmUint32 i = 0; i < _shaderSets.GetSize(); i++)
@@ -474,6 +700,7 @@ void CubismShader_OpenGLES2::ReleaseShaderProgram()
 }
 
 CubismShader_OpenGLES2::CubismShader_OpenGLES2()
+    : _vertexColorShaderSet(NULL)
 { }
 
 CubismShader_OpenGLES2::~CubismShader_OpenGLES2()
@@ -583,6 +810,14 @@ void CubismShader_OpenGLES2::GenerateShaders()
     _shaderSets[18]->ShaderProgram = _shaderSets[6]->ShaderProgram;
 #endif
 
+    // 頂点カラー。ブレンドモードは描画時に設定するため、通常・加算・乗算で共通
+    _shaderSets[19]->ShaderProgram = LoadShaderProgram(VertShaderSrcVertexColor, FragShaderSrcVertexColor);
+    _shaderSets[20]->ShaderProgram = LoadShaderProgram(VertShaderSrcVertexColorMasked, FragShaderSrcVertexColorMask);
+    _shaderSets[21]->ShaderProgram = LoadShaderProgram(VertShaderSrcVertexColorMasked, FragShaderSrcVertexColorMaskInverted);
+    _shaderSets[22]->ShaderProgram = LoadShaderProgram(VertShaderSrcVertexColor, FragShaderSrcVertexColorPremultipliedAlpha);
+    _shaderSets[23]->ShaderProgram = LoadShaderProgram(VertShaderSrcVertexColorMasked, FragShaderSrcVertexColorMaskPremultipliedAlpha);
+    _shaderSets[24]->ShaderProgram = LoadShaderProgram(VertShaderSrcVertexColorMasked, FragShaderSrcVertexColorMaskInvertedPremultipliedAlpha);
+
     // SetupMask
     _shaderSets[0]->AttributePositionLocation = glGetAttribLocation(_shaderSets[0]->ShaderProgram, "a_position");
     _shaderSets[0]->AttributeTexCoordLocation = glGetAttribLocation(_shaderSets[0]->ShaderProgram, "a_texCoord");
@@ -790,9 +1025,40 @@ void CubismShader_OpenGLES2::GenerateShaders()
     _shaderSets[18]->UniformBaseColorLocation = glGetUniformLocation(_shaderSets[18]->ShaderProgram, "u_baseColor");
     _shaderSets[18]->UniformMultiplyColorLocation = glGetUniformLocation(_shaderSets[18]->ShaderProgram, "u_multiplyColor");
     _shaderSets[18]->UniformScreenColorLocation = glGetUniformLocation(_shaderSets[18]->ShaderProgram, "u_screenColor");
+
+    // 頂点カラー（マスク無・マスク有・マスク有反転、それぞれの乗算済アルファ対応版）
+    for (csmInt32 i = ShaderNames_VertexColor; i <= ShaderNames_VertexColorMaskedInvertedPremultipliedAlpha; ++i)
+    {
+        _shaderSets[i]->AttributePositionLocation = glGetAttribLocation(_shaderSets[i]->ShaderProgram, "a_position");
+        _shaderSets[i]->AttributeTexCoordLocation = glGetAttribLocation(_shaderSets[i]->ShaderProgram, "a_texCoord");
+        _shaderSets[i]->AttributeBaseColorLocation = glGetAttribLocation(_shaderSets[i]->ShaderProgram, "a_baseColor");
+        _shaderSets[i]->AttributeMultiplyColorLocation = glGetAttribLocation(_shaderSets[i]->ShaderProgram, "a_multiplyColor");
+        _shaderSets[i]->AttributeScreenColorLocation = glGetAttribLocation(_shaderSets[i]->ShaderProgram, "a_screenColor");
+        _shaderSets[i]->SamplerTexture0Location = glGetUniformLocation(_shaderSets[i]->ShaderProgram, "s_texture0");
+        _shaderSets[i]->SamplerTexture1Location = glGetUniformLocation(_shaderSets[i]->ShaderProgram, "s_texture1");
+        _shaderSets[i]->UniformMatrixLocation = glGetUniformLocation(_shaderSets[i]->ShaderProgram, "u_matrix");
+        _shaderSets[i]->UniformClipMatrixLocation = glGetUniformLocation(_shaderSets[i]->ShaderProgram, "u_clipMatrix");
+        _shaderSets[i]->UnifromChannelFlagLocation = glGetUniformLocation(_shaderSets[i]->ShaderProgram, "u_channelFlag");
+        _shaderSets[i]->UniformBaseColorLocation = -1;
+        _shaderSets[i]->UniformMultiplyColorLocation = -1;
+        _shaderSets[i]->UniformScreenColorLocation = -1;
+    }
+
+    // ユニフォーム変数はプログラムごとに値を保持するため、最後に設定した値もプログラムごとに覚える
+    for (csmInt32 i = 0; i < ShaderCount; ++i)
+    {
+        CubismStateCache_OpenGLES2::ResetUniformCache(_shaderSets[i]->CachedMatrix, 16);
+        CubismStateCache_OpenGLES2::ResetUniformCache(_shaderSets[i]->CachedClipMatrix, 16);
+        CubismStateCache_OpenGLES2::ResetUniformCache(_shaderSets[i]->CachedBaseColor, 4);
+        CubismStateCache_OpenGLES2::ResetUniformCache(_shaderSets[i]->CachedMultiplyColor, 4);
+        CubismStateCache_OpenGLES2::ResetUniformCache(_shaderSets[i]->CachedScreenColor, 4);
+        CubismStateCache_OpenGLES2::ResetUniformCache(_shaderSets[i]->CachedChannelFlag, 4);
+        _shaderSets[i]->CachedTexture0 = -1;
+        _shaderSets[i]->CachedTexture1 = -1;
+    }
 }
 
-void CubismShader_OpenGLES2::SetupShaderProgramForDraw(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index)
+void CubismShader_OpenGLES2::SetupShaderProgramForDraw(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index, const CubismDrawBatcher::Batch* batch)
 {
     if (_shaderSets.GetSize() == 0)
     {
@@ -841,44 +1107,60 @@ void CubismShader_OpenGLES2::SetupShaderProgramForDraw(CubismRenderer_OpenGLES2*
         break;
     }
 
-    glUseProgram(shaderSet->ShaderProgram);
+    // 色の異なる描画オブジェクトをまとめた場合は、色を頂点属性で渡す
+    const csmBool useVertexColors = (batch != NULL && batch->HasVertexColors);
+    if (useVertexColors)
+    {
+        shaderSet = _shaderSets[ShaderNames_VertexColor + offset];
+    }
+
+    CubismStateCache_OpenGLES2& stateCache = renderer->GetStateCache();
+    stateCache.UseProgram(shaderSet->ShaderProgram);
 
     //テクスチャ設定
     SetupTexture(renderer, model, index, shaderSet);
 
     // 頂点属性設定
-    SetVertexAttributes(model, index, shaderSet);
+    if (batch != NULL)
+    {
+        SetBatchVertexAttributes(renderer, *batch, shaderSet);
+    }
+    else
+    {
+        SetVertexAttributes(renderer, model, index, shaderSet);
+    }
 
     if (masked)
     {
-        glActiveTexture(GL_TEXTURE1);
-
         // frameBufferに書かれたテクスチャ
         GLuint tex = renderer->GetMaskBuffer(renderer->GetClippingContextBufferForDraw()->_bufferIndex)->GetColorBuffer();
 
-        glBindTexture(GL_TEXTURE_2D, tex);
-        glUniform1i(shaderSet->SamplerTexture1Location, 1);
+        stateCache.BindTexture2D(1, tex);
+        stateCache.Uniform1i(shaderSet->SamplerTexture1Location, &shaderSet->CachedTexture1, 1);
 
         // View座標をClippingContextの座標に変換するための行列を設定
-        glUniformMatrix4fv(shaderSet->UniformClipMatrixLocation, 1, 0, renderer->GetClippingContextBufferForDraw()->_matrixForDraw.GetArray());
+        stateCache.UniformMatrix4fv(shaderSet->UniformClipMatrixLocation, shaderSet->CachedClipMatrix, renderer->GetClippingContextBufferForDraw()->_matrixForDraw.GetArray());
 
         // 使用するカラーチャンネルを設定
-        SetColorChannelUniformVariables(shaderSet, renderer->GetClippingContextBufferForDraw());
+        SetColorChannelUniformVariables(renderer, shaderSet, renderer->GetClippingContextBufferForDraw());
     }
 
     //座標変換
-    glUniformMatrix4fv(shaderSet->UniformMatrixLocation, 1, 0, renderer->GetMvpMatrix().GetArray()); //
+    stateCache.UniformMatrix4fv(shaderSet->UniformMatrixLocation, shaderSet->CachedMatrix, renderer->GetMvpMatrix().GetArray());
 
     // ユニフォーム変数設定
-    CubismRenderer::CubismTextureColor baseColor = renderer->GetModelColorWithOpacity(model.GetDrawableOpacity(index));
-    CubismRenderer::CubismTextureColor multiplyColor = model.GetMultiplyColor(index);
-    CubismRenderer::CubismTextureColor screenColor = model.GetScreenColor(index);
-    SetColorUniformVariables(renderer, model, index, shaderSet, baseColor, multiplyColor, screenColor);
+    if (!useVertexColors)
+    {
+        CubismRenderer::CubismTextureColor baseColor = renderer->GetModelColorWithOpacity(model.GetDrawableOpacity(index));
+        CubismRenderer::CubismTextureColor multiplyColor = model.GetMultiplyColor(index);
+        CubismRenderer::CubismTextureColor screenColor = model.GetScreenColor(index);
+        SetColorUniformVariables(renderer, model, index, shaderSet, baseColor, multiplyColor, screenColor);
+    }
 
-    glBlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
+    stateCache.BlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
 }
 
-void CubismShader_OpenGLES2::SetupShaderProgramForMask(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index)
+void CubismShader_OpenGLES2::SetupShaderProgramForMask(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index, const CubismDrawBatcher::Batch* batch)
 {
     if (_shaderSets.GetSize() == 0)
     {
@@ -892,18 +1174,26 @@ void CubismShader_OpenGLES2::SetupShaderProgramForMask(CubismRenderer_OpenGLES2*
     csmInt32 DST_ALPHA = GL_ONE_MINUS_SRC_ALPHA;
 
     CubismShaderSet* shaderSet = _shaderSets[ShaderNames_SetupMask];
-    glUseProgram(shaderSet->ShaderProgram);
+    CubismStateCache_OpenGLES2& stateCache = renderer->GetStateCache();
+    stateCache.UseProgram(shaderSet->ShaderProgram);
 
     //テクスチャ設定
     SetupTexture(renderer, model, index, shaderSet);
 
     // 頂点属性設定
-    SetVertexAttributes(model, index, shaderSet);
+    if (batch != NULL)
+    {
+        SetBatchVertexAttributes(renderer, *batch, shaderSet);
+    }
+    else
+    {
+        SetVertexAttributes(renderer, model, index, shaderSet);
+    }
 
     // 使用するカラーチャンネルを設定
-    SetColorChannelUniformVariables(shaderSet, renderer->GetClippingContextBufferForMask());
+    SetColorChannelUniformVariables(renderer, shaderSet, renderer->GetClippingContextBufferForMask());
 
-    glUniformMatrix4fv(shaderSet->UniformClipMatrixLocation, 1, GL_FALSE, renderer->GetClippingContextBufferForMask()->_matrixForMask.GetArray());
+    stateCache.UniformMatrix4fv(shaderSet->UniformClipMatrixLocation, shaderSet->CachedClipMatrix, renderer->GetClippingContextBufferForMask()->_matrixForMask.GetArray());
 
     // ユニフォーム変数設定
     csmRectF* rect = renderer->GetClippingContextBufferForMask()->_layoutBounds;
@@ -912,7 +1202,7 @@ void CubismShader_OpenGLES2::SetupShaderProgramForMask(CubismRenderer_OpenGLES2*
     CubismRenderer::CubismTextureColor screenColor = model.GetScreenColor(index);
     SetColorUniformVariables(renderer, model, index, shaderSet, baseColor, multiplyColor, screenColor);
 
-    glBlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
+    stateCache.BlendFuncSeparate(SRC_COLOR, DST_COLOR, SRC_ALPHA, DST_ALPHA);
 }
 
 csmBool CubismShader_OpenGLES2::CompileShaderSource(GLuint* outShader, GLenum shaderType, const csmChar* shaderSource)
@@ -1057,41 +1347,108 @@ GLuint CubismShader_OpenGLES2::LoadShaderProgram(const csmChar* vertShaderSrc, c
     return shaderProgram;
 }
 
-void CubismShader_OpenGLES2::SetVertexAttributes(const CubismModel& model, const csmInt32 index, CubismShaderSet* shaderSet)
+void CubismShader_OpenGLES2::SetVertexAttributes(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index, CubismShaderSet* shaderSet)
 {
+    CubismStateCache_OpenGLES2& stateCache = renderer->GetStateCache();
+
+    // GPUのバッファに保持した頂点を使う
+    if (renderer->IsUsingVertexBufferObjects())
+    {
+        renderer->GetVertexBuffer().SetVertexAttributes(index, shaderSet->AttributePositionLocation, shaderSet->AttributeTexCoordLocation, stateCache);
+        return;
+    }
+
     // 頂点位置属性の設定
     const csmFloat32* vertexArray = model.GetDrawableVertices(index);
-    glEnableVertexAttribArray(shaderSet->AttributePositionLocation);
+    stateCache.SetVertexAttribArrayEnabled(shaderSet->AttributePositionLocation, true);
     glVertexAttribPointer(shaderSet->AttributePositionLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, vertexArray);
 
     // テクスチャ座標属性の設定
     const csmFloat32* uvArray = reinterpret_cast<const csmFloat32*>(model.GetDrawableVertexUvs(index));
-    glEnableVertexAttribArray(shaderSet->AttributeTexCoordLocation);
+    stateCache.SetVertexAttribArrayEnabled(shaderSet->AttributeTexCoordLocation, true);
     glVertexAttribPointer(shaderSet->AttributeTexCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, uvArray);
 }
 
+void CubismShader_OpenGLES2::SetBatchVertexAttributes(CubismRenderer_OpenGLES2* renderer, const CubismDrawBatcher::Batch& batch, CubismShaderSet* shaderSet)
+{
+    const CubismDrawBatcher& batcher = renderer->GetDrawBatcher();
+    CubismStateCache_OpenGLES2& stateCache = renderer->GetStateCache();
+
+    // まとめた頂点列はCPUのメモリから渡すため、GPUのバッファを外す
+    if (renderer->IsUsingVertexBufferObjects())
+    {
+        stateCache.BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // 頂点位置属性の設定
+    const csmFloat32* vertexArray = batcher.GetVertexPositions() + batch.VertexOffset * 2;
+    stateCache.SetVertexAttribArrayEnabled(shaderSet->AttributePositionLocation, true);
+    glVertexAttribPointer(shaderSet->AttributePositionLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, vertexArray);
+
+    // テクスチャ座標属性の設定
+    const csmFloat32* uvArray = batcher.GetVertexUvs() + batch.VertexOffset * 2;
+    stateCache.SetVertexAttribArrayEnabled(shaderSet->AttributeTexCoordLocation, true);
+    glVertexAttribPointer(shaderSet->AttributeTexCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, uvArray);
+
+    if (!batch.HasVertexColors)
+    {
+        return;
+    }
+
+    // 色属性の設定
+    const csmFloat32* baseColorArray = batcher.GetVertexBaseColors() + batch.VertexOffset * 4;
+    stateCache.SetVertexAttribArrayEnabled(shaderSet->AttributeBaseColorLocation, true);
+    glVertexAttribPointer(shaderSet->AttributeBaseColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 4, baseColorArray);
+
+    const csmFloat32* multiplyColorArray = batcher.GetVertexMultiplyColors() + batch.VertexOffset * 4;
+    stateCache.SetVertexAttribArrayEnabled(shaderSet->AttributeMultiplyColorLocation, true);
+    glVertexAttribPointer(shaderSet->AttributeMultiplyColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 4, multiplyColorArray);
+
+    const csmFloat32* screenColorArray = batcher.GetVertexScreenColors() + batch.VertexOffset * 4;
+    stateCache.SetVertexAttribArrayEnabled(shaderSet->AttributeScreenColorLocation, true);
+    glVertexAttribPointer(shaderSet->AttributeScreenColorLocation, 4, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 4, screenColorArray);
+
+    _vertexColorShaderSet = shaderSet;
+}
+
+void CubismShader_OpenGLES2::DisableVertexColorAttributes(CubismRenderer_OpenGLES2* renderer)
+{
+    if (_vertexColorShaderSet == NULL)
+    {
+        return;
+    }
+
+    // 頂点カラーを使わない描画で、まとめた描画用の配列を読まないようにする
+    CubismStateCache_OpenGLES2& stateCache = renderer->GetStateCache();
+    stateCache.SetVertexAttribArrayEnabled(_vertexColorShaderSet->AttributeBaseColorLocation, false);
+    stateCache.SetVertexAttribArrayEnabled(_vertexColorShaderSet->AttributeMultiplyColorLocation, false);
+    stateCache.SetVertexAttribArrayEnabled(_vertexColorShaderSet->AttributeScreenColorLocation, false);
+    _vertexColorShaderSet = NULL;
+}
+
 void CubismShader_OpenGLES2::SetupTexture(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index, CubismShaderSet* shaderSet)
 {
     const csmInt32 textureIndex = model.GetDrawableTextureIndex(index);
     const GLuint textureId = renderer->GetBindedTextureId(textureIndex);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureId);
-    glUniform1i(shaderSet->SamplerTexture0Location, 0);
+    CubismStateCache_OpenGLES2& stateCache = renderer->GetStateCache();
+    stateCache.BindTexture2D(0, textureId);
+    stateCache.Uniform1i(shaderSet->SamplerTexture0Location, &shaderSet->CachedTexture0, 0);
 }
 
 void CubismShader_OpenGLES2::SetColorUniformVariables(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index, CubismShaderSet* shaderSet,
                                                       CubismRenderer::CubismTextureColor& baseColor, CubismRenderer::CubismTextureColor& multiplyColor, CubismRenderer::CubismTextureColor& screenColor)
 {
-    glUniform4f(shaderSet->UniformBaseColorLocation, baseColor.R, baseColor.G, baseColor.B, baseColor.A);
-    glUniform4f(shaderSet->UniformMultiplyColorLocation, multiplyColor.R, multiplyColor.G, multiplyColor.B, multiplyColor.A);
-    glUniform4f(shaderSet->UniformScreenColorLocation, screenColor.R, screenColor.G, screenColor.B, screenColor.A);
+    CubismStateCache_OpenGLES2& stateCache = renderer->GetStateCache();
+    stateCache.Uniform4f(shaderSet->UniformBaseColorLocation, shaderSet->CachedBaseColor, baseColor.R, baseColor.G, baseColor.B, baseColor.A);
+    stateCache.Uniform4f(shaderSet->UniformMultiplyColorLocation, shaderSet->CachedMultiplyColor, multiplyColor.R, multiplyColor.G, multiplyColor.B, multiplyColor.A);
+    stateCache.Uniform4f(shaderSet->UniformScreenColorLocation, shaderSet->CachedScreenColor, screenColor.R, screenColor.G, screenColor.B, screenColor.A);
 }
 
-void CubismShader_OpenGLES2::SetColorChannelUniformVariables(CubismShaderSet* shaderSet, CubismClippingContext_OpenGLES2* contextBuffer)
+void CubismShader_OpenGLES2::SetColorChannelUniformVariables(CubismRenderer_OpenGLES2* renderer, CubismShaderSet* shaderSet, CubismClippingContext_OpenGLES2* contextBuffer)
 {
     const csmInt32 channelIndex = contextBuffer->_layoutChannelIndex;
     CubismRenderer::CubismTextureColor* colorChannel = contextBuffer->GetClippingManager()->GetChannelFlagAsColor(channelIndex);
-    glUniform4f(shaderSet->UnifromChannelFlagLocation, colorChannel->R, colorChannel->G, colorChannel->B, colorChannel->A);
+    renderer->GetStateCache().Uniform4f(shaderSet->UnifromChannelFlagLocation, shaderSet->CachedChannelFlag, colorChannel->R, colorChannel->G, colorChannel->B, colorChannel->A);
 }
 
 }}}}
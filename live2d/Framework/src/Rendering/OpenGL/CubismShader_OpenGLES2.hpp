@@ -9,6 +9,7 @@
 
 #include "CubismFramework.hpp"
 #include "CubismRenderer_OpenGLES2.hpp"
+#include "../CubismDrawBatcher.hpp"
 
 #ifdef CSM_TARGET_ANDROID_ES2
 #include <jni.h>
@@ -66,8 +67,9 @@ public:
      * @param[in]   renderer              ->  レンダラー
      * @param[in]   model                 ->  描画対象のモデル
      * @param[in]   index                 ->  描画対象のメッシュのインデックス
+     * @param[in]   batch                 ->  まとめて描く場合はまとめた描画。NULLならindexの描画オブジェクトだけを描く
      */
-    void SetupShaderProgramForDraw(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index);
+    void SetupShaderProgramForDraw(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index, const CubismDrawBatcher::Batch* batch = NULL);
 
     /**
      * @brief   マスク用のシェーダプログラムの一連のセットアップを実行する
@@ -75,8 +77,16 @@ public:
      * @param[in]   renderer              ->  レンダラー
      * @param[in]   model                 ->  描画対象のモデル
      * @param[in]   index                 ->  描画対象のメッシュのインデックス
+     * @param[in]   batch                 ->  まとめて描く場合はまとめた描画。NULLならindexの描画オブジェクトだけを描く
      */
-    void SetupShaderProgramForMask(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index);
+    void SetupShaderProgramForMask(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index, const CubismDrawBatcher::Batch* batch = NULL);
+
+    /**
+     * @brief   まとめた描画で有効にした頂点カラーの属性を無効にする
+     *
+     * @param[in]   renderer              ->  レンダラー
+     */
+    void DisableVertexColorAttributes(CubismRenderer_OpenGLES2* renderer);
 
 private:
     /**
@@ -88,6 +98,9 @@ private:
         GLuint ShaderProgram;               ///< シェーダプログラムのアドレス
         GLuint AttributePositionLocation;   ///< シェーダプログラムに渡す変数のアドレス(Position)
         GLuint AttributeTexCoordLocation;   ///< シェーダプログラムに渡す変数のアドレス(TexCoord)
+        GLuint AttributeBaseColorLocation;      ///< シェーダプログラムに渡す変数のアドレス(BaseColor、頂点カラー)
+        GLuint AttributeMultiplyColorLocation;  ///< シェーダプログラムに渡す変数のアドレス(MultiplyColor、頂点カラー)
+        GLuint AttributeScreenColorLocation;    ///< シェーダプログラムに渡す変数のアドレス(ScreenColor、頂点カラー)
         GLint UniformMatrixLocation;        ///< シェーダプログラムに渡す変数のアドレス(Matrix)
         GLint UniformClipMatrixLocation;    ///< シェーダプログラムに渡す変数のアドレス(ClipMatrix)
         GLint SamplerTexture0Location;      ///< シェーダプログラムに渡す変数のアドレス(Texture0)
@@ -96,6 +109,14 @@ private:
         GLint UniformMultiplyColorLocation; ///< シェーダプログラムに渡す変数のアドレス(MultiplyColor)
         GLint UniformScreenColorLocation;   ///< シェーダプログラムに渡す変数のアドレス(ScreenColor)
         GLint UnifromChannelFlagLocation;   ///< シェーダプログラムに渡す変数のアドレス(ChannelFlag)
+        csmFloat32 CachedMatrix[16];        ///< 最後に設定した値(Matrix)
+        csmFloat32 CachedClipMatrix[16];    ///< 最後に設定した値(ClipMatrix)
+        csmFloat32 CachedBaseColor[4];      ///< 最後に設定した値(BaseColor)
+        csmFloat32 CachedMultiplyColor[4];  ///< 最後に設定した値(MultiplyColor)
+        csmFloat32 CachedScreenColor[4];    ///< 最後に設定した値(ScreenColor)
+        csmFloat32 CachedChannelFlag[4];    ///< 最後に設定した値(ChannelFlag)
+        GLint CachedTexture0;               ///< 最後に設定した値(Texture0)
+        GLint CachedTexture1;               ///< 最後に設定した値(Texture1)
     };
 
     /**
@@ -163,11 +184,21 @@ private:
     /**
      * @brief   必要な頂点属性を設定する
      *
+     * @param[in]   renderer              ->  レンダラのインスタンス
      * @param[in]   model                 ->  描画対象のモデル
      * @param[in]   index                 ->  描画対象のメッシュのインデックス
      * @param[in]   shaderSet             ->  シェーダープログラムのセット
      */
-    void SetVertexAttributes(const CubismModel& model, const csmInt32 index, CubismShaderSet* shaderSet);
+    void SetVertexAttributes(CubismRenderer_OpenGLES2* renderer, const CubismModel& model, const csmInt32 index, CubismShaderSet* shaderSet);
+
+    /**
+     * @brief   まとめた描画の頂点属性を設定する
+     *
+     * @param[in]   renderer              ->  レンダラのインスタンス
+     * @param[in]   batch                 ->  まとめた描画
+     * @param[in]   shaderSet             ->  シェーダープログラムのセット
+     */
+    void SetBatchVertexAttributes(CubismRenderer_OpenGLES2* renderer, const CubismDrawBatcher::Batch& batch, CubismShaderSet* shaderSet);
 
     /**
      * @brief   テクスチャの設定を行う
@@ -196,10 +227,11 @@ private:
     /**
      * @brief   カラーチャンネル関連のユニフォーム変数の設定を行う
      *
+     * @param[in]   renderer              ->  レンダラー
      * @param[in]   shaderSet             ->  シェーダープログラムのセット
      * @param[in]   contextBuffer         ->  描画コンテクスト
      */
-    void SetColorChannelUniformVariables(CubismShaderSet* shaderSet, CubismClippingContext_OpenGLES2* contextBuffer);
+    void SetColorChannelUniformVariables(CubismRenderer_OpenGLES2* renderer, CubismShaderSet* shaderSet, CubismClippingContext_OpenGLES2* contextBuffer);
 
 #ifdef CSM_TARGET_ANDROID_ES2
 public:
@@ -217,6 +249,7 @@ private:
 #endif
 
     csmVector<CubismShaderSet*> _shaderSets;   ///< ロードしたシェーダプログラムを保持する変数
+    CubismShaderSet* _vertexColorShaderSet;   ///< 頂点カラーの属性を有効にしているシェーダプログラム。無ければNULL
 
 };
 
@@ -0,0 +1,322 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismStateCache_OpenGLES2.hpp"
+#include <float.h>
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+namespace {
+const GLint UnknownState = -1;  ///< 値が不明なステート
+
+// ユニフォーム変数の未設定を表す値。どの値と比べても一致しない
+const csmFloat32 UnsetUniformValue = FLT_MAX;
+}
+
+CubismStateCache_OpenGLES2::CubismStateCache_OpenGLES2()
+    : _issuedCallCount(0)
+    , _avoidedCallCount(0)
+{
+    Invalidate();
+}
+
+void CubismStateCache_OpenGLES2::Invalidate()
+{
+    _program = UnknownState;
+    _activeTexture = UnknownState;
+    _frontFace = UnknownState;
+    _arrayBuffer = UnknownState;
+    _elementArrayBuffer = UnknownState;
+
+    for (csmInt32 i = 0; i < TextureUnitCount; ++i)
+    {
+        _textures[i] = UnknownState;
+    }
+
+    for (csmInt32 i = 0; i < 4; ++i)
+    {
+        _blendFunc[i] = UnknownState;
+        _colorMask[i] = UnknownState;
+    }
+
+    for (csmInt32 i = 0; i < CapabilityCount; ++i)
+    {
+        _capabilities[i] = UnknownState;
+    }
+
+    for (csmInt32 i = 0; i < VertexAttribCount; ++i)
+    {
+        _vertexAttribArrays[i] = UnknownState;
+    }
+}
+
+void CubismStateCache_OpenGLES2::ResetCallCounts()
+{
+    _issuedCallCount = 0;
+    _avoidedCallCount = 0;
+}
+
+csmInt32 CubismStateCache_OpenGLES2::GetIssuedCallCount() const
+{
+    return _issuedCallCount;
+}
+
+csmInt32 CubismStateCache_OpenGLES2::GetAvoidedCallCount() const
+{
+    return _avoidedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::AddAvoidedCallCount(csmInt32 count)
+{
+    _avoidedCallCount += count;
+}
+
+void CubismStateCache_OpenGLES2::UseProgram(GLuint program)
+{
+    if (_program == static_cast<GLint>(program))
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glUseProgram(program);
+    _program = static_cast<GLint>(program);
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::ActiveTexture(GLenum texture)
+{
+    if (_activeTexture == static_cast<GLint>(texture))
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glActiveTexture(texture);
+    _activeTexture = static_cast<GLint>(texture);
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::BindTexture2D(csmInt32 unit, GLuint texture)
+{
+    if (_textures[unit] == static_cast<GLint>(texture))
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    ActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    _textures[unit] = static_cast<GLint>(texture);
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    if (_blendFunc[0] == static_cast<GLint>(srcRGB) && _blendFunc[1] == static_cast<GLint>(dstRGB) &&
+        _blendFunc[2] == static_cast<GLint>(srcAlpha) && _blendFunc[3] == static_cast<GLint>(dstAlpha))
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+    _blendFunc[0] = static_cast<GLint>(srcRGB);
+    _blendFunc[1] = static_cast<GLint>(dstRGB);
+    _blendFunc[2] = static_cast<GLint>(srcAlpha);
+    _blendFunc[3] = static_cast<GLint>(dstAlpha);
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::SetEnabled(GLenum capability, csmBool enabled)
+{
+    const csmInt32 index = GetCapabilityIndex(capability);
+    const GLint value = enabled ? 1 : 0;
+
+    if (index >= 0 && _capabilities[index] == value)
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    if (enabled)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+
+    if (index >= 0)
+    {
+        _capabilities[index] = value;
+    }
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::FrontFace(GLenum mode)
+{
+    if (_frontFace == static_cast<GLint>(mode))
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glFrontFace(mode);
+    _frontFace = static_cast<GLint>(mode);
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    if (_colorMask[0] == red && _colorMask[1] == green && _colorMask[2] == blue && _colorMask[3] == alpha)
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glColorMask(red, green, blue, alpha);
+    _colorMask[0] = red;
+    _colorMask[1] = green;
+    _colorMask[2] = blue;
+    _colorMask[3] = alpha;
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::BindBuffer(GLenum target, GLuint buffer)
+{
+    GLint* binding = (target == GL_ARRAY_BUFFER) ? &_arrayBuffer : ((target == GL_ELEMENT_ARRAY_BUFFER) ? &_elementArrayBuffer : NULL);
+
+    if (binding != NULL && *binding == static_cast<GLint>(buffer))
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glBindBuffer(target, buffer);
+    if (binding != NULL)
+    {
+        *binding = static_cast<GLint>(buffer);
+    }
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::SetVertexAttribArrayEnabled(GLuint index, csmBool enabled)
+{
+    const GLint value = enabled ? 1 : 0;
+    const csmBool isTracked = index < static_cast<GLuint>(VertexAttribCount);
+
+    if (isTracked && _vertexAttribArrays[index] == value)
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    if (enabled)
+    {
+        glEnableVertexAttribArray(index);
+    }
+    else
+    {
+        glDisableVertexAttribArray(index);
+    }
+
+    if (isTracked)
+    {
+        _vertexAttribArrays[index] = value;
+    }
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::Uniform1i(GLint location, GLint* cachedValue, GLint value)
+{
+    // 位置が-1の変数への設定はOpenGLでも無視される
+    if (location < 0 || *cachedValue == value)
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glUniform1i(location, value);
+    *cachedValue = value;
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::Uniform4f(GLint location, csmFloat32* cachedValue, csmFloat32 x, csmFloat32 y, csmFloat32 z, csmFloat32 w)
+{
+    if (location < 0 || (cachedValue[0] == x && cachedValue[1] == y && cachedValue[2] == z && cachedValue[3] == w))
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glUniform4f(location, x, y, z, w);
+    cachedValue[0] = x;
+    cachedValue[1] = y;
+    cachedValue[2] = z;
+    cachedValue[3] = w;
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::UniformMatrix4fv(GLint location, csmFloat32* cachedValue, const csmFloat32* value)
+{
+    csmBool isSame = true;
+    for (csmInt32 i = 0; i < 16; ++i)
+    {
+        if (cachedValue[i] != value[i])
+        {
+            isSame = false;
+            break;
+        }
+    }
+
+    if (location < 0 || isSame)
+    {
+        ++_avoidedCallCount;
+        return;
+    }
+
+    glUniformMatrix4fv(location, 1, GL_FALSE, value);
+    for (csmInt32 i = 0; i < 16; ++i)
+    {
+        cachedValue[i] = value[i];
+    }
+    ++_issuedCallCount;
+}
+
+void CubismStateCache_OpenGLES2::ResetUniformCache(csmFloat32* cachedValue, csmInt32 count)
+{
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        cachedValue[i] = UnsetUniformValue;
+    }
+}
+
+csmInt32 CubismStateCache_OpenGLES2::GetCapabilityIndex(GLenum capability)
+{
+    switch (capability)
+    {
+    case GL_BLEND:
+        return 0;
+    case GL_CULL_FACE:
+        return 1;
+    case GL_DEPTH_TEST:
+        return 2;
+    case GL_SCISSOR_TEST:
+        return 3;
+    case GL_STENCIL_TEST:
+        return 4;
+    default:
+        return -1;
+    }
+}
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
@@ -0,0 +1,197 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+
+#ifdef CSM_TARGET_ANDROID_ES2
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#endif
+
+#ifdef CSM_TARGET_IPHONE_ES2
+#include <OpenGLES/ES2/gl.h>
+#include <OpenGLES/ES2/glext.h>
+#endif
+
+#if defined(CSM_TARGET_WIN_GL) || defined(CSM_TARGET_LINUX_GL)
+#include <GL/glew.h>
+#include <GL/gl.h>
+#endif
+
+#ifdef CSM_TARGET_MAC_GL
+#ifndef CSM_TARGET_COCOS
+#include <GL/glew.h>
+#endif
+#include <OpenGL/gl.h>
+#endif
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+/**
+ * @brief   レンダラが設定したOpenGLES2のステートを覚えておき、同じ値の設定を省略するクラス<br>
+ *           ステートを問い合わせずに済むよう、値はこのクラスを通して設定したものだけを覚える。
+ *           他のコードがステートを変更した可能性がある場合はInvalidate()で全て不明に戻す。
+ *           ユニフォーム変数はプログラムごとの値のため、値の置き場所は呼び出し側が持つ
+ */
+class CubismStateCache_OpenGLES2
+{
+public:
+    static const csmInt32 TextureUnitCount = 2;     ///< 覚えておくテクスチャユニットの数
+    static const csmInt32 VertexAttribCount = 8;    ///< 覚えておく頂点属性の数
+
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismStateCache_OpenGLES2();
+
+    /**
+     * @brief   覚えているステートを全て不明に戻す。次の設定は必ずOpenGLに発行する
+     */
+    void Invalidate();
+
+    /**
+     * @brief   発行・省略した呼び出しの数を0に戻す
+     */
+    void ResetCallCounts();
+
+    /**
+     * @brief   発行した呼び出しの数を取得する
+     */
+    csmInt32 GetIssuedCallCount() const;
+
+    /**
+     * @brief   省略した呼び出しの数を取得する
+     */
+    csmInt32 GetAvoidedCallCount() const;
+
+    /**
+     * @brief   このクラスを通さずに省略した呼び出しの数を加える
+     *
+     * @param[in]   count   ->  省略した呼び出しの数
+     */
+    void AddAvoidedCallCount(csmInt32 count);
+
+    /**
+     * @brief   glUseProgram
+     */
+    void UseProgram(GLuint program);
+
+    /**
+     * @brief   glActiveTexture
+     *
+     * @param[in]   texture ->  GL_TEXTURE0 から始まるテクスチャユニット
+     */
+    void ActiveTexture(GLenum texture);
+
+    /**
+     * @brief   テクスチャユニットを切り替えてglBindTexture(GL_TEXTURE_2D)する
+     *
+     * @param[in]   unit    ->  テクスチャユニットの番号(0始まり)
+     * @param[in]   texture ->  テクスチャ
+     */
+    void BindTexture2D(csmInt32 unit, GLuint texture);
+
+    /**
+     * @brief   glBlendFuncSeparate
+     */
+    void BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+
+    /**
+     * @brief   glEnable / glDisable。GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_SCISSOR_TEST, GL_STENCIL_TESTを覚える
+     *
+     * @param[in]   capability  ->  機能
+     * @param[in]   enabled     ->  trueなら有効にする
+     */
+    void SetEnabled(GLenum capability, csmBool enabled);
+
+    /**
+     * @brief   glFrontFace
+     */
+    void FrontFace(GLenum mode);
+
+    /**
+     * @brief   glColorMask
+     */
+    void ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+
+    /**
+     * @brief   glBindBuffer。GL_ARRAY_BUFFERとGL_ELEMENT_ARRAY_BUFFERを覚える
+     */
+    void BindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * @brief   glEnableVertexAttribArray / glDisableVertexAttribArray
+     *
+     * @param[in]   index   ->  頂点属性の番号
+     * @param[in]   enabled ->  trueなら有効にする
+     */
+    void SetVertexAttribArrayEnabled(GLuint index, csmBool enabled);
+
+    /**
+     * @brief   glUniform1i。現在のプログラムに設定する
+     *
+     * @param[in]       location    ->  ユニフォーム変数の位置
+     * @param[in,out]   cachedValue ->  このプログラムで最後に設定した値
+     * @param[in]       value       ->  設定する値
+     */
+    void Uniform1i(GLint location, GLint* cachedValue, GLint value);
+
+    /**
+     * @brief   glUniform4f。現在のプログラムに設定する
+     *
+     * @param[in]       location    ->  ユニフォーム変数の位置
+     * @param[in,out]   cachedValue ->  このプログラムで最後に設定した値(4要素)
+     */
+    void Uniform4f(GLint location, csmFloat32* cachedValue, csmFloat32 x, csmFloat32 y, csmFloat32 z, csmFloat32 w);
+
+    /**
+     * @brief   glUniformMatrix4fv。現在のプログラムに設定する
+     *
+     * @param[in]       location    ->  ユニフォーム変数の位置
+     * @param[in,out]   cachedValue ->  このプログラムで最後に設定した値(16要素)
+     * @param[in]       value       ->  設定する行列
+     */
+    void UniformMatrix4fv(GLint location, csmFloat32* cachedValue, const csmFloat32* value);
+
+    /**
+     * @brief   ユニフォーム変数の値の置き場所を、未設定の状態にする
+     *
+     * @param[out]  cachedValue ->  値の置き場所
+     * @param[in]   count       ->  要素の数
+     */
+    static void ResetUniformCache(csmFloat32* cachedValue, csmInt32 count);
+
+private:
+    /**
+     * @brief   覚える機能の番号を取得する
+     *
+     * @return  覚えない機能なら-1
+     */
+    static csmInt32 GetCapabilityIndex(GLenum capability);
+
+    static const csmInt32 CapabilityCount = 5;  ///< 覚える機能の数
+
+    GLint _program;                             ///< 現在のプログラム。-1なら不明
+    GLint _activeTexture;                       ///< 現在のテクスチャユニット。-1なら不明
+    GLint _textures[TextureUnitCount];          ///< テクスチャユニットごとのテクスチャ。-1なら不明
+    GLint _blendFunc[4];                        ///< ブレンド関数。-1なら不明
+    GLint _capabilities[CapabilityCount];       ///< 機能の有効・無効。-1なら不明
+    GLint _frontFace;                           ///< 表面の向き。-1なら不明
+    GLint _colorMask[4];                        ///< カラーマスク。-1なら不明
+    GLint _arrayBuffer;                         ///< GL_ARRAY_BUFFER。-1なら不明
+    GLint _elementArrayBuffer;                  ///< GL_ELEMENT_ARRAY_BUFFER。-1なら不明
+    GLint _vertexAttribArrays[VertexAttribCount];   ///< 頂点属性の有効・無効。-1なら不明
+    csmInt32 _issuedCallCount;                  ///< 発行した呼び出しの数
+    csmInt32 _avoidedCallCount;                 ///< 省略した呼び出しの数
+};
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
@@ -0,0 +1,257 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismVertexBuffer_OpenGLES2.hpp"
+#include "CubismStateCache_OpenGLES2.hpp"
+#include "Model/CubismModel.hpp"
+#include <string.h>
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+CubismVertexBuffer_OpenGLES2::CubismVertexBuffer_OpenGLES2()
+    : _uvBuffer(0)
+    , _indexBuffer(0)
+    , _currentPositionBuffer(0)
+    , _vertexCount(0)
+    , _uploadedVertexCount(0)
+    , _uploadCount(0)
+{
+    for (csmInt32 i = 0; i < PositionBufferCount; ++i)
+    {
+        _positionBuffers[i] = 0;
+        _isPositionBufferFilled[i] = false;
+    }
+}
+
+CubismVertexBuffer_OpenGLES2::~CubismVertexBuffer_OpenGLES2()
+{
+    DestroyBuffers();
+}
+
+void CubismVertexBuffer_OpenGLES2::CreateBuffers(const CubismModel& model)
+{
+    // 一旦削除
+    DestroyBuffers();
+
+    const csmInt32 drawableCount = model.GetDrawableCount();
+    csmInt32 indexCount = 0;
+
+    // 全Drawableの頂点とインデックスを1つのバッファに並べる
+    _vertexOffsets.Resize(drawableCount);
+    _indexOffsets.Resize(drawableCount);
+    _vertexCount = 0;
+
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        _vertexOffsets[i] = _vertexCount;
+        _indexOffsets[i] = indexCount;
+        _vertexCount += model.GetDrawableVertexCount(i);
+        indexCount += model.GetDrawableVertexIndexCount(i);
+    }
+
+    // UVとインデックスはモデルの生存中に変化しない
+    // インデックスはDrawableごとに0から始まるため、そのまま並べてglDrawElementsの位置で区別する
+    csmVector<csmFloat32> uvs(_vertexCount * 2);
+    csmVector<csmUint16> indices(indexCount);
+    uvs.Resize(_vertexCount * 2);
+    indices.Resize(indexCount);
+
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        memcpy(uvs.GetPtr() + _vertexOffsets[i] * 2, model.GetDrawableVertexUvs(i), sizeof(csmFloat32) * 2 * model.GetDrawableVertexCount(i));
+        memcpy(indices.GetPtr() + _indexOffsets[i], model.GetDrawableVertexIndices(i), sizeof(csmUint16) * model.GetDrawableVertexIndexCount(i));
+    }
+
+    glGenBuffers(1, &_uvBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _uvBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(csmFloat32) * 2 * _vertexCount, uvs.GetPtr(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &_indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(csmUint16) * indexCount, indices.GetPtr(), GL_STATIC_DRAW);
+
+    // 頂点位置は描画ごとに転送するため、ここでは領域だけ作る
+    glGenBuffers(PositionBufferCount, _positionBuffers);
+    for (csmInt32 i = 0; i < PositionBufferCount; ++i)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, _positionBuffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(csmFloat32) * 2 * _vertexCount, NULL, GL_DYNAMIC_DRAW);
+        _uploadedVersions[i].Resize(drawableCount, 0);
+        _isPositionBufferFilled[i] = false;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    _positions.Resize(_vertexCount * 2);
+    _positionRevisions.Resize(drawableCount, 0);
+    _currentPositionBuffer = PositionBufferCount - 1;
+
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        memcpy(_positions.GetPtr() + _vertexOffsets[i] * 2, model.GetDrawableVertices(i), sizeof(csmFloat32) * 2 * model.GetDrawableVertexCount(i));
+        _positionRevisions[i] = model.GetDrawableVertexRevision(i);
+    }
+}
+
+void CubismVertexBuffer_OpenGLES2::DestroyBuffers()
+{
+    if (_uvBuffer == 0)
+    {
+        return;
+    }
+
+    glDeleteBuffers(PositionBufferCount, _positionBuffers);
+    glDeleteBuffers(1, &_uvBuffer);
+    glDeleteBuffers(1, &_indexBuffer);
+
+    for (csmInt32 i = 0; i < PositionBufferCount; ++i)
+    {
+        _positionBuffers[i] = 0;
+        _isPositionBufferFilled[i] = false;
+    }
+
+    _uvBuffer = 0;
+    _indexBuffer = 0;
+}
+
+void CubismVertexBuffer_OpenGLES2::UpdatePositions(const CubismModel& model, CubismStateCache_OpenGLES2& stateCache)
+{
+    _uploadedVertexCount = 0;
+    _uploadCount = 0;
+
+    if (_uvBuffer == 0)
+    {
+        return;
+    }
+
+    // 頂点の更新番号が進んだDrawableだけ写しを更新する
+    const csmInt32 drawableCount = _vertexOffsets.GetSize();
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        const csmUint32 vertexRevision = model.GetDrawableVertexRevision(i);
+        if (_positionRevisions[i] != vertexRevision)
+        {
+            memcpy(_positions.GetPtr() + _vertexOffsets[i] * 2, model.GetDrawableVertices(i), sizeof(csmFloat32) * 2 * model.GetDrawableVertexCount(i));
+            _positionRevisions[i] = vertexRevision;
+        }
+    }
+
+    // 前のフレームでGPUが読んでいる可能性のあるバッファを避けて、次のバッファに書き込む
+    _currentPositionBuffer = (_currentPositionBuffer + 1) % PositionBufferCount;
+    stateCache.BindBuffer(GL_ARRAY_BUFFER, _positionBuffers[_currentPositionBuffer]);
+
+    csmVector<csmUint32>& uploadedVersions = _uploadedVersions[_currentPositionBuffer];
+
+    // 初めて使うバッファは中身を捨てて全体を転送する
+    if (!_isPositionBufferFilled[_currentPositionBuffer])
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(csmFloat32) * 2 * _vertexCount, _positions.GetPtr(), GL_DYNAMIC_DRAW);
+
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            uploadedVersions[i] = _positionRevisions[i];
+        }
+
+        _isPositionBufferFilled[_currentPositionBuffer] = true;
+        _uploadedVertexCount = _vertexCount;
+        _uploadCount = 1;
+        return;
+    }
+
+    // このバッファに前回転送してから変化したDrawableを、連続する範囲ごとにまとめて転送する
+    csmInt32 rangeBegin = -1;
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        if (uploadedVersions[i] != _positionRevisions[i])
+        {
+            uploadedVersions[i] = _positionRevisions[i];
+
+            if (rangeBegin < 0)
+            {
+                rangeBegin = i;
+            }
+        }
+        else if (rangeBegin >= 0)
+        {
+            UploadPositionRange(rangeBegin, i);
+            rangeBegin = -1;
+        }
+    }
+
+    if (rangeBegin == 0)
+    {
+        // 全体が変化した場合は古い中身を捨てて作り直す。書き込みで描画の完了を待たないようにする
+        glBufferData(GL_ARRAY_BUFFER, sizeof(csmFloat32) * 2 * _vertexCount, _positions.GetPtr(), GL_DYNAMIC_DRAW);
+        _uploadedVertexCount = _vertexCount;
+        ++_uploadCount;
+    }
+    else if (rangeBegin > 0)
+    {
+        UploadPositionRange(rangeBegin, drawableCount);
+    }
+}
+
+void CubismVertexBuffer_OpenGLES2::UploadPositionRange(csmInt32 firstDrawable, csmInt32 endDrawable)
+{
+    const csmInt32 firstVertex = _vertexOffsets[firstDrawable];
+    const csmInt32 endVertex = (endDrawable < static_cast<csmInt32>(_vertexOffsets.GetSize())) ? _vertexOffsets[endDrawable] : _vertexCount;
+
+    if (endVertex <= firstVertex)
+    {
+        return;
+    }
+
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(csmFloat32) * 2 * firstVertex, sizeof(csmFloat32) * 2 * (endVertex - firstVertex), _positions.GetPtr() + firstVertex * 2);
+    _uploadedVertexCount += endVertex - firstVertex;
+    ++_uploadCount;
+}
+
+void CubismVertexBuffer_OpenGLES2::SetVertexAttributes(csmInt32 drawableIndex, GLuint positionLocation, GLuint texCoordLocation, CubismStateCache_OpenGLES2& stateCache) const
+{
+    const csmInt32 vertexOffset = _vertexOffsets[drawableIndex];
+
+    // 頂点位置属性の設定
+    stateCache.BindBuffer(GL_ARRAY_BUFFER, _positionBuffers[_currentPositionBuffer]);
+    stateCache.SetVertexAttribArrayEnabled(positionLocation, true);
+    glVertexAttribPointer(positionLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, reinterpret_cast<const GLvoid*>(sizeof(csmFloat32) * 2 * vertexOffset));
+
+    // テクスチャ座標属性の設定
+    stateCache.BindBuffer(GL_ARRAY_BUFFER, _uvBuffer);
+    stateCache.SetVertexAttribArrayEnabled(texCoordLocation, true);
+    glVertexAttribPointer(texCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(csmFloat32) * 2, reinterpret_cast<const GLvoid*>(sizeof(csmFloat32) * 2 * vertexOffset));
+}
+
+void CubismVertexBuffer_OpenGLES2::BindIndexBuffer(CubismStateCache_OpenGLES2& stateCache) const
+{
+    stateCache.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+}
+
+const GLvoid* CubismVertexBuffer_OpenGLES2::GetIndexOffset(csmInt32 drawableIndex) const
+{
+    return reinterpret_cast<const GLvoid*>(sizeof(csmUint16) * _indexOffsets[drawableIndex]);
+}
+
+csmInt32 CubismVertexBuffer_OpenGLES2::GetUploadedVertexCount() const
+{
+    return _uploadedVertexCount;
+}
+
+csmInt32 CubismVertexBuffer_OpenGLES2::GetUploadCount() const
+{
+    return _uploadCount;
+}
+
+csmBool CubismVertexBuffer_OpenGLES2::IsValid() const
+{
+    return _uvBuffer != 0;
+}
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
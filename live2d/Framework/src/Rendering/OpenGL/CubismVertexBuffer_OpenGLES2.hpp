@@ -0,0 +1,161 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+
+#ifdef CSM_TARGET_ANDROID_ES2
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#endif
+
+#ifdef CSM_TARGET_IPHONE_ES2
+#include <OpenGLES/ES2/gl.h>
+#include <OpenGLES/ES2/glext.h>
+#endif
+
+#if defined(CSM_TARGET_WIN_GL) || defined(CSM_TARGET_LINUX_GL)
+#include <GL/glew.h>
+#include <GL/gl.h>
+#endif
+
+#ifdef CSM_TARGET_MAC_GL
+#ifndef CSM_TARGET_COCOS
+#include <GL/glew.h>
+#endif
+#include <OpenGL/gl.h>
+#endif
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+class CubismModel;
+}}}
+
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+class CubismStateCache_OpenGLES2;
+
+/**
+ * @brief   モデルの頂点をGPUのバッファに保持するクラス<br>
+ *           UVとインデックスは変化しないため作成時に1度だけ転送する。
+ *           頂点位置は複数のバッファを順に使い回し、前回そのバッファに転送してから変化したDrawableの範囲だけを転送する。
+ *           GPUが前のフレームで読んでいるバッファには書き込まないため、転送で描画の完了を待たない
+ */
+class CubismVertexBuffer_OpenGLES2
+{
+public:
+    static const csmInt32 PositionBufferCount = 3;  ///< 順に使い回す頂点位置バッファの数
+
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismVertexBuffer_OpenGLES2();
+
+    /**
+     * @brief   デストラクタ
+     */
+    ~CubismVertexBuffer_OpenGLES2();
+
+    /**
+     * @brief   モデルの頂点用のバッファを作成し、UVとインデックスを転送する<br>
+     *           バッファのバインドを変更するため、呼び出し後はステートキャッシュを無効にすること
+     *
+     * @param[in]   model   ->  モデル
+     */
+    void CreateBuffers(const CubismModel& model);
+
+    /**
+     * @brief   バッファを破棄する
+     */
+    void DestroyBuffers();
+
+    /**
+     * @brief   次の頂点位置バッファに切り替え、頂点の更新番号が進んだDrawableの範囲を転送する<br>
+     *           モデルの描画ごとに、描画命令を再生する前に1回呼ぶ
+     *
+     * @param[in]   model       ->  モデル
+     * @param[in]   stateCache  ->  バッファのバインドに使うステートキャッシュ
+     */
+    void UpdatePositions(const CubismModel& model, CubismStateCache_OpenGLES2& stateCache);
+
+    /**
+     * @brief   Drawableの頂点位置とUVを頂点属性に設定する
+     *
+     * @param[in]   drawableIndex       ->  Drawableの番号
+     * @param[in]   positionLocation    ->  頂点位置の属性の番号
+     * @param[in]   texCoordLocation    ->  UVの属性の番号
+     * @param[in]   stateCache          ->  バッファのバインドに使うステートキャッシュ
+     */
+    void SetVertexAttributes(csmInt32 drawableIndex, GLuint positionLocation, GLuint texCoordLocation, CubismStateCache_OpenGLES2& stateCache) const;
+
+    /**
+     * @brief   インデックスバッファをバインドする
+     *
+     * @param[in]   stateCache  ->  バッファのバインドに使うステートキャッシュ
+     */
+    void BindIndexBuffer(CubismStateCache_OpenGLES2& stateCache) const;
+
+    /**
+     * @brief   インデックスバッファ上のDrawableのインデックスの位置を取得する。glDrawElementsに渡す
+     *
+     * @param[in]   drawableIndex   ->  Drawableの番号
+     * @return  先頭からのバイト数
+     */
+    const GLvoid* GetIndexOffset(csmInt32 drawableIndex) const;
+
+    /**
+     * @brief   直前のUpdatePositionsで転送した頂点の数を取得する
+     *
+     * @return  転送した頂点の数
+     */
+    csmInt32 GetUploadedVertexCount() const;
+
+    /**
+     * @brief   直前のUpdatePositionsで転送した回数を取得する
+     *
+     * @return  転送した回数
+     */
+    csmInt32 GetUploadCount() const;
+
+    /**
+     * @brief   バッファが作成されているか
+     */
+    csmBool IsValid() const;
+
+private:
+    // Prevention of copy Constructor
+    CubismVertexBuffer_OpenGLES2(const CubismVertexBuffer_OpenGLES2&);
+    CubismVertexBuffer_OpenGLES2& operator=(const CubismVertexBuffer_OpenGLES2&);
+
+    /**
+     * @brief   頂点位置の写しの連続した範囲を、現在の頂点位置バッファに転送する
+     *
+     * @param[in]   firstDrawable   ->  範囲の先頭のDrawableの番号
+     * @param[in]   endDrawable     ->  範囲の最後のDrawableの次の番号
+     */
+    void UploadPositionRange(csmInt32 firstDrawable, csmInt32 endDrawable);
+
+    GLuint _positionBuffers[PositionBufferCount];           ///< 順に使い回す頂点位置バッファ
+    GLuint _uvBuffer;                                       ///< UVのバッファ
+    GLuint _indexBuffer;                                    ///< インデックスのバッファ
+    csmInt32 _currentPositionBuffer;                        ///< このフレームで使う頂点位置バッファの番号
+    csmInt32 _vertexCount;                                  ///< モデル全体の頂点の数
+    csmVector<csmInt32> _vertexOffsets;                     ///< Drawableごとの、バッファ上の先頭の頂点の番号
+    csmVector<csmInt32> _indexOffsets;                      ///< Drawableごとの、バッファ上の先頭のインデックスの番号
+    csmVector<csmFloat32> _positions;                       ///< 頂点位置の写し。転送する範囲を連続したメモリにする
+    csmVector<csmUint32> _positionRevisions;                ///< Drawableごとの、写しに反映したモデルの頂点の更新番号
+    csmVector<csmUint32> _uploadedVersions[PositionBufferCount];    ///< 頂点位置バッファごとの、転送したときの頂点の更新番号
+    csmBool _isPositionBufferFilled[PositionBufferCount];   ///< 頂点位置バッファに全Drawableを転送済みか
+    csmInt32 _uploadedVertexCount;                          ///< 直前に転送した頂点の数
+    csmInt32 _uploadCount;                                  ///< 直前に転送した回数
+};
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
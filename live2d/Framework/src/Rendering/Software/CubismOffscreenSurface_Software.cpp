@@ -0,0 +1,91 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismOffscreenSurface_Software.hpp"
+#include <string.h>
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+CubismOffscreenSurface_Software::CubismOffscreenSurface_Software()
+    : _pixels(NULL)
+    , _bufferWidth(0)
+    , _bufferHeight(0)
+{
+}
+
+CubismOffscreenSurface_Software::~CubismOffscreenSurface_Software()
+{
+    DestroyOffscreenSurface();
+}
+
+csmBool CubismOffscreenSurface_Software::CreateOffscreenSurface(csmUint32 displayBufferWidth, csmUint32 displayBufferHeight)
+{
+    // 一旦削除
+    DestroyOffscreenSurface();
+
+    if (displayBufferWidth == 0 || displayBufferHeight == 0)
+    {
+        return false;
+    }
+
+    const csmSizeType size = static_cast<csmSizeType>(displayBufferWidth) * displayBufferHeight * 4;
+    _pixels = static_cast<csmUint8*>(CSM_MALLOC(size));
+
+    if (_pixels == NULL)
+    {
+        return false;
+    }
+
+    // マスクが描かれていない状態(全ての領域が無効)で始める
+    memset(_pixels, 0xff, size);
+    _bufferWidth = displayBufferWidth;
+    _bufferHeight = displayBufferHeight;
+
+    return true;
+}
+
+void CubismOffscreenSurface_Software::DestroyOffscreenSurface()
+{
+    if (_pixels != NULL)
+    {
+        CSM_FREE(_pixels);
+        _pixels = NULL;
+    }
+
+    _bufferWidth = 0;
+    _bufferHeight = 0;
+}
+
+csmUint8* CubismOffscreenSurface_Software::GetPixels()
+{
+    return _pixels;
+}
+
+const csmUint8* CubismOffscreenSurface_Software::GetPixels() const
+{
+    return _pixels;
+}
+
+csmUint32 CubismOffscreenSurface_Software::GetBufferWidth() const
+{
+    return _bufferWidth;
+}
+
+csmUint32 CubismOffscreenSurface_Software::GetBufferHeight() const
+{
+    return _bufferHeight;
+}
+
+csmBool CubismOffscreenSurface_Software::IsValid() const
+{
+    return _pixels != NULL;
+}
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
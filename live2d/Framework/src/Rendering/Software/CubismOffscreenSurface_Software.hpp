@@ -0,0 +1,95 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+/**
+ * @brief   CPUのメモリ上に確保するマスク用バッファ<br>
+ *           1画素をRGBA各8bitで持ち、OpenGLのフレームバッファと同じく先頭の行を画面の下端とする
+ */
+class CubismOffscreenSurface_Software
+{
+public:
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismOffscreenSurface_Software();
+
+    /**
+     * @brief   デストラクタ
+     */
+    ~CubismOffscreenSurface_Software();
+
+    /**
+     * @brief   バッファを作成する。作成済みの場合は作り直す
+     *
+     * @param[in]   displayBufferWidth     ->  作成するバッファの幅
+     * @param[in]   displayBufferHeight    ->  作成するバッファの高さ
+     *
+     * @retval  true    ->  作成できた
+     * @retval  false   ->  作成できなかった
+     */
+    csmBool CreateOffscreenSurface(csmUint32 displayBufferWidth, csmUint32 displayBufferHeight);
+
+    /**
+     * @brief   バッファを解放する
+     */
+    void DestroyOffscreenSurface();
+
+    /**
+     * @brief   画素の先頭アドレスを取得する
+     *
+     * @return  画素の先頭アドレス
+     */
+    csmUint8* GetPixels();
+
+    /**
+     * @brief   画素の先頭アドレスを取得する
+     *
+     * @return  画素の先頭アドレス
+     */
+    const csmUint8* GetPixels() const;
+
+    /**
+     * @brief   バッファの幅を取得する
+     *
+     * @return  バッファの幅
+     */
+    csmUint32 GetBufferWidth() const;
+
+    /**
+     * @brief   バッファの高さを取得する
+     *
+     * @return  バッファの高さ
+     */
+    csmUint32 GetBufferHeight() const;
+
+    /**
+     * @brief   バッファが作成されているかを取得する
+     *
+     * @return  作成されていればtrue
+     */
+    csmBool IsValid() const;
+
+private:
+    // Prevention of copy Constructor
+    CubismOffscreenSurface_Software(const CubismOffscreenSurface_Software&);
+    CubismOffscreenSurface_Software& operator=(const CubismOffscreenSurface_Software&);
+
+    csmUint8* _pixels;          ///< RGBAの画素
+    csmUint32 _bufferWidth;     ///< バッファの幅
+    csmUint32 _bufferHeight;    ///< バッファの高さ
+};
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
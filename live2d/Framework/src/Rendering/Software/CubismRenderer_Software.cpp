@@ -0,0 +1,897 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismRenderer_Software.hpp"
+#include "Model/CubismModel.hpp"
+#include "Utils/CubismTrace.hpp"
+#include "ICubismJobSystem.hpp"
+#include <math.h>
+#include <string.h>
+
+// CubismModel.cppと同じ判定。使う命令はARMv7のNEONとSSE1の範囲に限る
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CSM_SOFTWARE_RENDERER_NEON
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define CSM_SOFTWARE_RENDERER_SSE
+#endif
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+namespace {
+
+/*
+ * 1画素のRGBAを1レジスタの4レーンに載せて計算する。
+ * シェーダの色の計算とブレンドはRGBAの各チャンネルに同じ演算を行うため、レーンごとの演算がそのまま使える。
+ */
+#if defined(CSM_SOFTWARE_RENDERER_NEON)
+typedef float32x4_t Vec4;
+
+inline Vec4 Vec4Set(csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a)
+{
+    const csmFloat32 lanes[4] = { r, g, b, a };
+    return vld1q_f32(lanes);
+}
+
+inline Vec4 Vec4Splat(csmFloat32 value) { return vdupq_n_f32(value); }
+inline Vec4 Vec4Add(Vec4 a, Vec4 b) { return vaddq_f32(a, b); }
+inline Vec4 Vec4Sub(Vec4 a, Vec4 b) { return vsubq_f32(a, b); }
+inline Vec4 Vec4Mul(Vec4 a, Vec4 b) { return vmulq_f32(a, b); }
+inline Vec4 Vec4Clamp01(Vec4 a) { return vminq_f32(vmaxq_f32(a, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f)); }
+inline csmFloat32 Vec4Alpha(Vec4 a) { return vgetq_lane_f32(a, 3); }
+inline void Vec4Store(csmFloat32* out, Vec4 a) { vst1q_f32(out, a); }
+#elif defined(CSM_SOFTWARE_RENDERER_SSE)
+typedef __m128 Vec4;
+
+inline Vec4 Vec4Set(csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a) { return _mm_setr_ps(r, g, b, a); }
+inline Vec4 Vec4Splat(csmFloat32 value) { return _mm_set1_ps(value); }
+inline Vec4 Vec4Add(Vec4 a, Vec4 b) { return _mm_add_ps(a, b); }
+inline Vec4 Vec4Sub(Vec4 a, Vec4 b) { return _mm_sub_ps(a, b); }
+inline Vec4 Vec4Mul(Vec4 a, Vec4 b) { return _mm_mul_ps(a, b); }
+inline Vec4 Vec4Clamp01(Vec4 a) { return _mm_min_ps(_mm_max_ps(a, _mm_setzero_ps()), _mm_set1_ps(1.0f)); }
+inline csmFloat32 Vec4Alpha(Vec4 a) { return _mm_cvtss_f32(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3))); }
+inline void Vec4Store(csmFloat32* out, Vec4 a) { _mm_storeu_ps(out, a); }
+#else
+struct Vec4
+{
+    csmFloat32 V[4];
+};
+
+inline Vec4 Vec4Set(csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a)
+{
+    Vec4 result;
+    result.V[0] = r;
+    result.V[1] = g;
+    result.V[2] = b;
+    result.V[3] = a;
+    return result;
+}
+
+inline Vec4 Vec4Splat(csmFloat32 value) { return Vec4Set(value, value, value, value); }
+inline Vec4 Vec4Add(Vec4 a, Vec4 b) { return Vec4Set(a.V[0] + b.V[0], a.V[1] + b.V[1], a.V[2] + b.V[2], a.V[3] + b.V[3]); }
+inline Vec4 Vec4Sub(Vec4 a, Vec4 b) { return Vec4Set(a.V[0] - b.V[0], a.V[1] - b.V[1], a.V[2] - b.V[2], a.V[3] - b.V[3]); }
+inline Vec4 Vec4Mul(Vec4 a, Vec4 b) { return Vec4Set(a.V[0] * b.V[0], a.V[1] * b.V[1], a.V[2] * b.V[2], a.V[3] * b.V[3]); }
+
+inline csmFloat32 Clamp01(csmFloat32 value) { return (value < 0.0f) ? 0.0f : ((value > 1.0f) ? 1.0f : value); }
+inline Vec4 Vec4Clamp01(Vec4 a) { return Vec4Set(Clamp01(a.V[0]), Clamp01(a.V[1]), Clamp01(a.V[2]), Clamp01(a.V[3])); }
+inline csmFloat32 Vec4Alpha(Vec4 a) { return a.V[3]; }
+inline void Vec4Store(csmFloat32* out, Vec4 a) { memcpy(out, a.V, sizeof(a.V)); }
+#endif
+
+const csmInt32 SubPixelBits = 8;                                ///< 頂点座標を固定小数点にするときの小数部のビット数
+const csmInt64 SubPixelOne = 1 << SubPixelBits;                 ///< 固定小数点での1画素
+const csmFloat32 SubPixelScale = static_cast<csmFloat32>(SubPixelOne);
+const csmFloat32 InverseColorScale = 1.0f / 255.0f;
+
+/**
+ * @brief   RGBA各8bitの画素を0..1の色にする
+ */
+inline Vec4 LoadPixel(const csmUint8* pixel)
+{
+    return Vec4Mul(Vec4Set(pixel[0], pixel[1], pixel[2], pixel[3]), Vec4Splat(InverseColorScale));
+}
+
+/**
+ * @brief   0..1の色を丸めてRGBA各8bitの画素に書き込む
+ */
+inline void StorePixel(csmUint8* pixel, Vec4 color)
+{
+    csmFloat32 lanes[4];
+    Vec4Store(lanes, Vec4Add(Vec4Mul(Vec4Clamp01(color), Vec4Splat(255.0f)), Vec4Splat(0.5f)));
+    pixel[0] = static_cast<csmUint8>(lanes[0]);
+    pixel[1] = static_cast<csmUint8>(lanes[1]);
+    pixel[2] = static_cast<csmUint8>(lanes[2]);
+    pixel[3] = static_cast<csmUint8>(lanes[3]);
+}
+
+/**
+ * @brief   テクスチャの範囲外の座標を折り返す(GL_REPEAT)
+ */
+inline csmInt32 WrapRepeat(csmInt32 value, csmInt32 size)
+{
+    value %= size;
+    return (value < 0) ? value + size : value;
+}
+
+/**
+ * @brief   テクスチャの範囲外の座標を端に寄せる(GL_CLAMP_TO_EDGE)
+ */
+inline csmInt32 WrapClamp(csmInt32 value, csmInt32 size)
+{
+    return (value < 0) ? 0 : ((value >= size) ? size - 1 : value);
+}
+
+/**
+ * @brief   バイリニア補間でテクスチャを読む(GL_LINEAR)
+ *
+ * @param[in]   pixels  ->  RGBA各8bitの画素
+ * @param[in]   width   ->  テクスチャの幅
+ * @param[in]   height  ->  テクスチャの高さ
+ * @param[in]   x       ->  テクセルの中心を整数とする横の座標
+ * @param[in]   y       ->  テクセルの中心を整数とする縦の座標(行の番号の向き)
+ * @param[in]   repeat  ->  trueなら範囲外を折り返し、falseなら端に寄せる
+ *
+ * @return  0..1の色
+ */
+Vec4 SampleBilinear(const csmUint8* pixels, csmInt32 width, csmInt32 height, csmFloat32 x, csmFloat32 y, csmBool repeat)
+{
+    const csmFloat32 floorX = floorf(x);
+    const csmFloat32 floorY = floorf(y);
+    const Vec4 weightX = Vec4Splat(x - floorX);
+    const Vec4 weightY = Vec4Splat(y - floorY);
+
+    csmInt32 x0 = static_cast<csmInt32>(floorX);
+    csmInt32 y0 = static_cast<csmInt32>(floorY);
+    csmInt32 x1 = x0 + 1;
+    csmInt32 y1 = y0 + 1;
+
+    if (repeat)
+    {
+        x0 = WrapRepeat(x0, width);
+        x1 = WrapRepeat(x1, width);
+        y0 = WrapRepeat(y0, height);
+        y1 = WrapRepeat(y1, height);
+    }
+    else
+    {
+        x0 = WrapClamp(x0, width);
+        x1 = WrapClamp(x1, width);
+        y0 = WrapClamp(y0, height);
+        y1 = WrapClamp(y1, height);
+    }
+
+    const Vec4 c00 = LoadPixel(pixels + (y0 * width + x0) * 4);
+    const Vec4 c10 = LoadPixel(pixels + (y0 * width + x1) * 4);
+    const Vec4 c01 = LoadPixel(pixels + (y1 * width + x0) * 4);
+    const Vec4 c11 = LoadPixel(pixels + (y1 * width + x1) * 4);
+
+    const Vec4 top = Vec4Add(c00, Vec4Mul(Vec4Sub(c10, c00), weightX));
+    const Vec4 bottom = Vec4Add(c01, Vec4Mul(Vec4Sub(c11, c01), weightX));
+    return Vec4Add(top, Vec4Mul(Vec4Sub(bottom, top), weightY));
+}
+
+/**
+ * @brief   乗算済みアルファの色をブレンドする。OpenGLES2のglBlendFuncSeparateの設定と同じ式
+ *
+ * @param[in]   source      ->  シェーダが出力する色
+ * @param[in]   destination ->  描画先の色
+ * @param[in]   blendMode   ->  ブレンドモード
+ *
+ * @return  ブレンドした色
+ */
+inline Vec4 Blend(Vec4 source, Vec4 destination, csmInt32 blendMode)
+{
+    const Vec4 one = Vec4Splat(1.0f);
+    const Vec4 colorOnly = Vec4Set(1.0f, 1.0f, 1.0f, 0.0f);
+
+    switch (blendMode)
+    {
+    case CubismRenderer::CubismBlendMode_Additive:
+        // (ONE, ONE), (ZERO, ONE)
+        return Vec4Add(destination, Vec4Mul(source, colorOnly));
+
+    case CubismRenderer::CubismBlendMode_Multiplicative:
+        // (DST_COLOR, ONE_MINUS_SRC_ALPHA), (ZERO, ONE)
+        return Vec4Add(Vec4Mul(destination, Vec4Sub(one, Vec4Mul(Vec4Splat(Vec4Alpha(source)), colorOnly))),
+                       Vec4Mul(Vec4Mul(source, destination), colorOnly));
+
+    case CubismRenderer::CubismBlendMode_Mask:
+        // マスクの作成 (ZERO, ONE_MINUS_SRC_COLOR), (ZERO, ONE_MINUS_SRC_ALPHA)
+        return Vec4Mul(destination, Vec4Sub(one, source));
+
+    case CubismRenderer::CubismBlendMode_Normal:
+    default:
+        // (ONE, ONE_MINUS_SRC_ALPHA), (ONE, ONE_MINUS_SRC_ALPHA)
+        return Vec4Add(source, Vec4Mul(destination, Vec4Splat(1.0f - Vec4Alpha(source))));
+    }
+}
+
+/**
+ * @brief   辺がトップレフトルールで含める側の辺かを判定する。y軸が上向きで反時計回りの三角形とする
+ */
+inline csmBool IsTopLeftEdge(csmInt64 ax, csmInt64 ay, csmInt64 bx, csmInt64 by)
+{
+    const csmInt64 dx = bx - ax;
+    const csmInt64 dy = by - ay;
+    return (dy < 0) || (dy == 0 && dx < 0);
+}
+
+}
+
+/*********************************************************************************************************************
+*                                      CubismClippingContext_Software
+********************************************************************************************************************/
+CubismClippingContext_Software::CubismClippingContext_Software(CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* manager, CubismModel& /*model*/, const csmInt32* clippingDrawableIndices, csmInt32 clipCount)
+    : CubismClippingContext(clippingDrawableIndices, clipCount)
+{
+    _owner = manager;
+}
+
+CubismClippingContext_Software::~CubismClippingContext_Software()
+{
+}
+
+CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* CubismClippingContext_Software::GetClippingManager()
+{
+    return _owner;
+}
+
+/*********************************************************************************************************************
+ *                                      CubismRenderer_Software
+ ********************************************************************************************************************/
+
+CubismRenderer* CubismRenderer::Create()
+{
+    return CSM_NEW CubismRenderer_Software();
+}
+
+void CubismRenderer::StaticRelease()
+{
+}
+
+CubismRenderer_Software::CubismRenderer_Software()
+    : _clippingManager(NULL)
+    , _renderTarget(NULL)
+    , _renderTargetWidth(0)
+    , _renderTargetHeight(0)
+{
+}
+
+CubismRenderer_Software::~CubismRenderer_Software()
+{
+    CSM_DELETE_SELF(CubismClippingManager_Software, _clippingManager);
+
+    for (csmUint32 i = 0; i < _offscreenSurfaces.GetSize(); ++i)
+    {
+        CSM_DELETE(_offscreenSurfaces[i]);
+    }
+    _offscreenSurfaces.Clear();
+}
+
+void CubismRenderer_Software::Initialize(CubismModel* model)
+{
+    Initialize(model, 1);
+}
+
+void CubismRenderer_Software::Initialize(CubismModel* model, csmInt32 maskBufferCount)
+{
+    // 1未満は1に補正する
+    if (maskBufferCount < 1)
+    {
+        maskBufferCount = 1;
+        CubismLogWarning("The number of render textures must be an integer greater than or equal to 1. Set the number of render textures to 1.");
+    }
+
+    if (model->IsUsingMasking())
+    {
+        _clippingManager = CSM_NEW CubismClippingManager_Software();  //クリッピングマスク・バッファ前処理方式を初期化
+        _clippingManager->Initialize(
+            *model,
+            maskBufferCount
+        );
+
+        for (csmInt32 i = 0; i < maskBufferCount; ++i)
+        {
+            CubismOffscreenSurface_Software* offscreenSurface = CSM_NEW CubismOffscreenSurface_Software();
+            offscreenSurface->CreateOffscreenSurface(static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().X), static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y));
+            _offscreenSurfaces.PushBack(offscreenSurface);
+        }
+    }
+
+    CubismRenderer::Initialize(model, maskBufferCount);  //親クラスの処理を呼ぶ
+}
+
+void CubismRenderer_Software::BindTexture(csmUint32 modelTextureIndex, const csmUint8* pixels, csmInt32 width, csmInt32 height)
+{
+    while (_textures.GetSize() <= modelTextureIndex)
+    {
+        Texture empty;
+        empty.Pixels = NULL;
+        empty.Width = 0;
+        empty.Height = 0;
+        _textures.PushBack(empty);
+    }
+
+    _textures[modelTextureIndex].Pixels = pixels;
+    _textures[modelTextureIndex].Width = width;
+    _textures[modelTextureIndex].Height = height;
+}
+
+void CubismRenderer_Software::SetRenderTarget(csmUint8* pixels, csmInt32 width, csmInt32 height)
+{
+    _renderTarget = pixels;
+    _renderTargetWidth = width;
+    _renderTargetHeight = height;
+}
+
+void CubismRenderer_Software::DoDrawModel()
+{
+    CSM_TRACE_SCOPE("CubismRenderer_Software::DoDrawModel");
+
+    if (_renderTarget == NULL || _renderTargetWidth <= 0 || _renderTargetHeight <= 0)
+    {
+        CubismLogWarning("The render target of the software renderer is not set.");
+        return;
+    }
+
+    //------------ クリッピングマスク・バッファ前処理方式の場合 ------------
+    if (_clippingManager != NULL)
+    {
+        // サイズが違う場合はここで作成しなおし
+        for (csmInt32 i = 0; i < _clippingManager->GetRenderTextureCount(); ++i)
+        {
+            if (_offscreenSurfaces[i]->GetBufferWidth() != static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().X) ||
+                _offscreenSurfaces[i]->GetBufferHeight() != static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y))
+            {
+                _offscreenSurfaces[i]->CreateOffscreenSurface(
+                    static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().X), static_cast<csmUint32>(_clippingManager->GetClippingMaskBufferSize().Y));
+
+                // 作り直したバッファには前回のマスクが残っていない
+                _clippingManager->InvalidateMasks();
+            }
+        }
+    }
+
+    // OpenGLES2と同じ手順で描画命令を記録する
+    _commandList.Clear();
+
+    if (_clippingManager != NULL)
+    {
+        if (IsUsingHighPrecisionMask())
+        {
+            _clippingManager->SetupMatrixForHighPrecision(*GetModel(), false);
+        }
+        else
+        {
+            _clippingManager->SetUsingPackedLayout(IsUsingPackedMaskLayout());
+            _clippingManager->RecordMaskCommands(*GetModel(), _commandList, false);
+        }
+    }
+
+    _commandList.RecordDrawables(*GetModel(),
+        (_clippingManager != NULL) ? _clippingManager->GetClippingContextListForDraw()->GetPtr() : NULL,
+        IsUsingHighPrecisionMask());
+
+    _commandList.Sort();
+
+    _vertexOffsets.Resize(_commandList.GetCommandCount());
+
+    // 描画先が同じ命令をまとめて実行する。マスクを使う描画は、そのマスクを描き終えた後に実行される
+    const csmInt32 commandCount = _commandList.GetCommandCount();
+    csmInt32 commandIndex = 0;
+
+    while (commandIndex < commandCount)
+    {
+        const CubismRenderCommandList::Command& first = _commandList.GetCommand(commandIndex);
+        const csmBool isMaskPass = (first.Type != CubismRenderCommandList::CommandType_Draw);
+
+        csmInt32 end = commandIndex + 1;
+        for (; end < commandCount; ++end)
+        {
+            const CubismRenderCommandList::Command& next = _commandList.GetCommand(end);
+
+            if ((next.Type != CubismRenderCommandList::CommandType_Draw) != isMaskPass)
+            {
+                break;
+            }
+
+            if (isMaskPass && next.BufferIndex != first.BufferIndex)
+            {
+                break;
+            }
+        }
+
+        PassContext pass;
+        pass.Renderer = this;
+        pass.FirstCommand = commandIndex;
+        pass.EndCommand = end;
+
+        if (isMaskPass)
+        {
+            CubismOffscreenSurface_Software* maskBuffer = GetMaskBuffer(first.BufferIndex);
+            pass.Pixels = maskBuffer->GetPixels();
+            pass.Width = static_cast<csmInt32>(maskBuffer->GetBufferWidth());
+            pass.Height = static_cast<csmInt32>(maskBuffer->GetBufferHeight());
+        }
+        else
+        {
+            pass.Pixels = _renderTarget;
+            pass.Width = _renderTargetWidth;
+            pass.Height = _renderTargetHeight;
+        }
+
+        if (pass.Pixels != NULL)
+        {
+            DrawPass(pass);
+        }
+
+        commandIndex = end;
+    }
+}
+
+void CubismRenderer_Software::DrawPass(PassContext& pass)
+{
+    CSM_TRACE_SCOPE("CubismRenderer_Software::DrawPass");
+
+    TransformVertices(pass);
+
+    // タイルごとに書き込む行が分かれているため、並列に塗っても結果は変わらない
+    const csmInt32 tileCount = (pass.Height + TileRowCount - 1) / TileRowCount;
+    ICubismJobSystem* jobSystem = CubismFramework::GetJobSystem();
+
+    if (jobSystem == NULL || tileCount < 2)
+    {
+        for (csmInt32 tileIndex = 0; tileIndex < tileCount; ++tileIndex)
+        {
+            DrawTileJob(&pass, tileIndex);
+        }
+    }
+    else
+    {
+        jobSystem->Dispatch(DrawTileJob, &pass, tileCount);
+    }
+}
+
+void CubismRenderer_Software::DrawTileJob(void* context, csmInt32 jobIndex)
+{
+    const PassContext* pass = static_cast<const PassContext*>(context);
+    const csmInt32 rowBegin = jobIndex * TileRowCount;
+    const csmInt32 rowEnd = (rowBegin + TileRowCount < pass->Height) ? rowBegin + TileRowCount : pass->Height;
+
+    pass->Renderer->DrawTile(*pass, rowBegin, rowEnd);
+}
+
+void CubismRenderer_Software::DrawTile(const PassContext& pass, csmInt32 rowBegin, csmInt32 rowEnd)
+{
+    const csmInt32 fullScissor[4] = { 0, 0, pass.Width, pass.Height };
+    csmInt32 maskScissor[4];
+
+    for (csmInt32 i = pass.FirstCommand; i < pass.EndCommand; ++i)
+    {
+        const CubismRenderCommandList::Command& command = _commandList.GetCommand(i);
+
+        // 1が無効（描かれない）領域、0が有効（描かれる）領域
+        switch (command.Type)
+        {
+        case CubismRenderCommandList::CommandType_ClearMaskBuffer:
+            memset(pass.Pixels + rowBegin * pass.Width * 4, 0xff, static_cast<csmSizeType>(rowEnd - rowBegin) * pass.Width * 4);
+            break;
+
+        case CubismRenderCommandList::CommandType_ClearMask:
+            {
+                // このマスクのチャンネルの、割り当てられた領域だけをクリアする
+                GetScissorForMask(command.ClipContext, maskScissor);
+                const csmInt32 channelIndex = command.ClipContext->_layoutChannelIndex;
+                const csmInt32 top = (maskScissor[3] < rowEnd) ? maskScissor[3] : rowEnd;
+
+                for (csmInt32 y = (maskScissor[1] > rowBegin) ? maskScissor[1] : rowBegin; y < top; ++y)
+                {
+                    csmUint8* row = pass.Pixels + y * pass.Width * 4;
+                    for (csmInt32 x = maskScissor[0]; x < maskScissor[2]; ++x)
+                    {
+                        row[x * 4 + channelIndex] = 0xff;
+                    }
+                }
+            }
+            break;
+
+        case CubismRenderCommandList::CommandType_DrawMask:
+            // 高精細マスクはバッファ全体を1つのマスクが使う
+            if (IsUsingHighPrecisionMask())
+            {
+                RasterizeCommand(pass, i, rowBegin, rowEnd, fullScissor);
+            }
+            else
+            {
+                GetScissorForMask(command.ClipContext, maskScissor);
+                RasterizeCommand(pass, i, rowBegin, rowEnd, maskScissor);
+            }
+            break;
+
+        case CubismRenderCommandList::CommandType_Draw:
+            RasterizeCommand(pass, i, rowBegin, rowEnd, fullScissor);
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+void CubismRenderer_Software::TransformVertices(const PassContext& pass)
+{
+    const CubismModel& model = *GetModel();
+    csmInt32 vertexCount = 0;
+
+    for (csmInt32 i = pass.FirstCommand; i < pass.EndCommand; ++i)
+    {
+        const CubismRenderCommandList::Command& command = _commandList.GetCommand(i);
+        _vertexOffsets[i] = vertexCount;
+
+        if (command.Type == CubismRenderCommandList::CommandType_Draw || command.Type == CubismRenderCommandList::CommandType_DrawMask)
+        {
+            vertexCount += model.GetDrawableVertexCount(command.DrawableIndex);
+        }
+    }
+
+    _screenPositions.Resize(vertexCount * 2);
+    _clipPositions.Resize(vertexCount * 2);
+
+    CubismMatrix44 mvp = GetMvpMatrix();
+    const csmFloat32 halfWidth = static_cast<csmFloat32>(pass.Width) * 0.5f;
+    const csmFloat32 halfHeight = static_cast<csmFloat32>(pass.Height) * 0.5f;
+
+    for (csmInt32 i = pass.FirstCommand; i < pass.EndCommand; ++i)
+    {
+        const CubismRenderCommandList::Command& command = _commandList.GetCommand(i);
+        const csmBool isDraw = (command.Type == CubismRenderCommandList::CommandType_Draw);
+
+        if (!isDraw && command.Type != CubismRenderCommandList::CommandType_DrawMask)
+        {
+            continue;
+        }
+
+        // マスクの作成はマスク用の行列、描画はMVP行列で変換する
+        CubismClippingContext* clipContext = command.ClipContext;
+        const csmFloat32* matrix = isDraw ? mvp.GetArray() : clipContext->_matrixForMask.GetArray();
+        const csmFloat32* clipMatrix = (isDraw && clipContext != NULL) ? clipContext->_matrixForDraw.GetArray() : NULL;
+
+        const csmInt32 count = model.GetDrawableVertexCount(command.DrawableIndex);
+        const csmFloat32* vertices = model.GetDrawableVertices(command.DrawableIndex);
+        csmFloat32* screenPositions = _screenPositions.GetPtr() + _vertexOffsets[i] * 2;
+        csmFloat32* clipPositions = _clipPositions.GetPtr() + _vertexOffsets[i] * 2;
+
+        for (csmInt32 v = 0; v < count; ++v)
+        {
+            const csmFloat32 x = vertices[v * 2];
+            const csmFloat32 y = vertices[v * 2 + 1];
+
+            // ビューポート変換。画素(0, 0)の左下の角を原点とする
+            const csmFloat32 w = matrix[3] * x + matrix[7] * y + matrix[15];
+            screenPositions[v * 2] = ((matrix[0] * x + matrix[4] * y + matrix[12]) / w + 1.0f) * halfWidth;
+            screenPositions[v * 2 + 1] = ((matrix[1] * x + matrix[5] * y + matrix[13]) / w + 1.0f) * halfHeight;
+
+            if (clipMatrix != NULL)
+            {
+                const csmFloat32 clipW = clipMatrix[3] * x + clipMatrix[7] * y + clipMatrix[15];
+                clipPositions[v * 2] = (clipMatrix[0] * x + clipMatrix[4] * y + clipMatrix[12]) / clipW;
+                clipPositions[v * 2 + 1] = (clipMatrix[1] * x + clipMatrix[5] * y + clipMatrix[13]) / clipW;
+            }
+        }
+    }
+}
+
+void CubismRenderer_Software::RasterizeCommand(const PassContext& pass, csmInt32 commandIndex, csmInt32 rowBegin, csmInt32 rowEnd, const csmInt32* scissor) const
+{
+    const CubismRenderCommandList::Command& command = _commandList.GetCommand(commandIndex);
+    const CubismModel& model = *GetModel();
+    const csmInt32 drawableIndex = command.DrawableIndex;
+
+    // モデルが参照するテクスチャが設定されていない場合は描画をスキップする
+    const csmInt32 textureIndex = model.GetDrawableTextureIndex(drawableIndex);
+    if (textureIndex < 0 || textureIndex >= static_cast<csmInt32>(_textures.GetSize()) || _textures[textureIndex].Pixels == NULL)
+    {
+        return;
+    }
+
+    const Texture& texture = _textures[textureIndex];
+    const csmFloat32 textureWidth = static_cast<csmFloat32>(texture.Width);
+    const csmFloat32 textureHeight = static_cast<csmFloat32>(texture.Height);
+
+    // 描画オブジェクトで共通の値。OpenGLES2のシェーダのユニフォーム変数に当たる
+    const csmBool isGeneratingMask = (command.Type == CubismRenderCommandList::CommandType_DrawMask);
+    const CubismClippingContext* clipContext = command.ClipContext;
+    const CubismOffscreenSurface_Software* maskBuffer = NULL;
+    csmFloat32 channelFlag[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    csmFloat32 layoutBounds[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    Vec4 baseColor = Vec4Splat(1.0f);
+    Vec4 multiplyColor = Vec4Splat(1.0f);
+    Vec4 screenColor = Vec4Splat(0.0f);
+    csmInt32 blendMode = CubismRenderer::CubismBlendMode_Mask;
+    const csmBool isPremultipliedAlpha = IsPremultipliedAlpha();
+    const csmBool isInvertedMask = model.GetDrawableInvertedMask(drawableIndex);
+
+    if (clipContext != NULL)
+    {
+        const CubismTextureColor* colorChannel = _clippingManager->GetChannelFlagAsColor(clipContext->_layoutChannelIndex);
+        channelFlag[0] = colorChannel->R;
+        channelFlag[1] = colorChannel->G;
+        channelFlag[2] = colorChannel->B;
+        channelFlag[3] = colorChannel->A;
+    }
+
+    if (isGeneratingMask)
+    {
+        // マスクを割り当てられた領域の外には描かない
+        const csmRectF* rect = clipContext->_layoutBounds;
+        layoutBounds[0] = rect->X * 2.0f - 1.0f;
+        layoutBounds[1] = rect->Y * 2.0f - 1.0f;
+        layoutBounds[2] = rect->GetRight() * 2.0f - 1.0f;
+        layoutBounds[3] = rect->GetBottom() * 2.0f - 1.0f;
+    }
+    else
+    {
+        const CubismTextureColor base = GetModelColorWithOpacity(model.GetDrawableOpacity(drawableIndex));
+        const CubismTextureColor multiply = model.GetMultiplyColor(drawableIndex);
+        const CubismTextureColor screen = model.GetScreenColor(drawableIndex);
+        baseColor = Vec4Set(base.R, base.G, base.B, base.A);
+        multiplyColor = Vec4Set(multiply.R, multiply.G, multiply.B, 1.0f);
+        screenColor = Vec4Set(screen.R, screen.G, screen.B, 0.0f);
+        blendMode = model.GetDrawableBlendMode(drawableIndex);
+
+        if (clipContext != NULL)
+        {
+            maskBuffer = _offscreenSurfaces[clipContext->_bufferIndex];
+        }
+    }
+
+    const Vec4 channelFlagVector = Vec4Set(channelFlag[0], channelFlag[1], channelFlag[2], channelFlag[3]);
+    const csmFloat32 pixelToNdcX = 2.0f / static_cast<csmFloat32>(pass.Width);
+    const csmFloat32 pixelToNdcY = 2.0f / static_cast<csmFloat32>(pass.Height);
+
+    // 塗る範囲
+    const csmInt32 clipLeft = scissor[0];
+    const csmInt32 clipRight = scissor[2];
+    const csmInt32 clipBottom = (scissor[1] > rowBegin) ? scissor[1] : rowBegin;
+    const csmInt32 clipTop = (scissor[3] < rowEnd) ? scissor[3] : rowEnd;
+
+    if (clipLeft >= clipRight || clipBottom >= clipTop)
+    {
+        return;
+    }
+
+    const csmFloat32* screenPositions = _screenPositions.GetPtr() + _vertexOffsets[commandIndex] * 2;
+    const csmFloat32* clipPositions = _clipPositions.GetPtr() + _vertexOffsets[commandIndex] * 2;
+    const csmFloat32* uvs = reinterpret_cast<const csmFloat32*>(model.GetDrawableVertexUvs(drawableIndex));
+    const csmUint16* indices = model.GetDrawableVertexIndices(drawableIndex);
+    const csmInt32 indexCount = model.GetDrawableVertexIndexCount(drawableIndex);
+
+    for (csmInt32 t = 0; t + 2 < indexCount; t += 3)
+    {
+        csmInt32 v0 = indices[t];
+        csmInt32 v1 = indices[t + 1];
+        csmInt32 v2 = indices[t + 2];
+
+        // 隣り合う三角形で辺の判定が一致するよう、頂点を固定小数点の格子に揃える
+        csmInt64 x0 = static_cast<csmInt64>(floorf(screenPositions[v0 * 2] * SubPixelScale + 0.5f));
+        csmInt64 y0 = static_cast<csmInt64>(floorf(screenPositions[v0 * 2 + 1] * SubPixelScale + 0.5f));
+        csmInt64 x1 = static_cast<csmInt64>(floorf(screenPositions[v1 * 2] * SubPixelScale + 0.5f));
+        csmInt64 y1 = static_cast<csmInt64>(floorf(screenPositions[v1 * 2 + 1] * SubPixelScale + 0.5f));
+        csmInt64 x2 = static_cast<csmInt64>(floorf(screenPositions[v2 * 2] * SubPixelScale + 0.5f));
+        csmInt64 y2 = static_cast<csmInt64>(floorf(screenPositions[v2 * 2 + 1] * SubPixelScale + 0.5f));
+
+        csmInt64 area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+        if (area == 0)
+        {
+            continue;
+        }
+
+        // 反時計回りが表面。裏面描画が無効なら時計回りの三角形は描かない
+        if (area < 0)
+        {
+            if (command.IsCulling)
+            {
+                continue;
+            }
+
+            csmInt32 swapIndex = v1;
+            v1 = v2;
+            v2 = swapIndex;
+            csmInt64 swapValue = x1;
+            x1 = x2;
+            x2 = swapValue;
+            swapValue = y1;
+            y1 = y2;
+            y2 = swapValue;
+            area = -area;
+        }
+
+        // 三角形を囲む画素の範囲
+        csmInt64 minX = x0 < x1 ? (x0 < x2 ? x0 : x2) : (x1 < x2 ? x1 : x2);
+        csmInt64 maxX = x0 > x1 ? (x0 > x2 ? x0 : x2) : (x1 > x2 ? x1 : x2);
+        csmInt64 minY = y0 < y1 ? (y0 < y2 ? y0 : y2) : (y1 < y2 ? y1 : y2);
+        csmInt64 maxY = y0 > y1 ? (y0 > y2 ? y0 : y2) : (y1 > y2 ? y1 : y2);
+
+        const csmInt32 left = static_cast<csmInt32>((minX >> SubPixelBits) > clipLeft ? (minX >> SubPixelBits) : clipLeft);
+        const csmInt32 right = static_cast<csmInt32>(((maxX >> SubPixelBits) + 1) < clipRight ? ((maxX >> SubPixelBits) + 1) : clipRight);
+        const csmInt32 bottom = static_cast<csmInt32>((minY >> SubPixelBits) > clipBottom ? (minY >> SubPixelBits) : clipBottom);
+        const csmInt32 top = static_cast<csmInt32>(((maxY >> SubPixelBits) + 1) < clipTop ? ((maxY >> SubPixelBits) + 1) : clipTop);
+
+        if (left >= right || bottom >= top)
+        {
+            continue;
+        }
+
+        // 辺関数。w0は頂点0の重みになる(頂点1から2への辺に対する値)
+        const csmInt64 bias0 = IsTopLeftEdge(x1, y1, x2, y2) ? 0 : -1;
+        const csmInt64 bias1 = IsTopLeftEdge(x2, y2, x0, y0) ? 0 : -1;
+        const csmInt64 bias2 = IsTopLeftEdge(x0, y0, x1, y1) ? 0 : -1;
+        const csmInt64 stepX0 = -(y2 - y1) * SubPixelOne;
+        const csmInt64 stepX1 = -(y0 - y2) * SubPixelOne;
+        const csmInt64 stepX2 = -(y1 - y0) * SubPixelOne;
+
+        const csmFloat32 inverseArea = 1.0f / static_cast<csmFloat32>(area);
+        const csmFloat32 u0 = uvs[v0 * 2], u1 = uvs[v1 * 2], u2 = uvs[v2 * 2];
+        const csmFloat32 t0 = uvs[v0 * 2 + 1], t1 = uvs[v1 * 2 + 1], t2 = uvs[v2 * 2 + 1];
+        const csmFloat32 cx0 = clipPositions[v0 * 2], cx1 = clipPositions[v1 * 2], cx2 = clipPositions[v2 * 2];
+        const csmFloat32 cy0 = clipPositions[v0 * 2 + 1], cy1 = clipPositions[v1 * 2 + 1], cy2 = clipPositions[v2 * 2 + 1];
+
+        for (csmInt32 y = bottom; y < top; ++y)
+        {
+            // 画素の中心で判定する
+            const csmInt64 py = (static_cast<csmInt64>(y) << SubPixelBits) + SubPixelOne / 2;
+            const csmInt64 px = (static_cast<csmInt64>(left) << SubPixelBits) + SubPixelOne / 2;
+            csmInt64 w0 = (x2 - x1) * (py - y1) - (y2 - y1) * (px - x1);
+            csmInt64 w1 = (x0 - x2) * (py - y2) - (y0 - y2) * (px - x2);
+            csmInt64 w2 = (x1 - x0) * (py - y0) - (y1 - y0) * (px - x0);
+
+            csmUint8* pixel = pass.Pixels + (y * pass.Width + left) * 4;
+            const csmFloat32 ndcY = (static_cast<csmFloat32>(y) + 0.5f) * pixelToNdcY - 1.0f;
+
+            for (csmInt32 x = left; x < right; ++x, pixel += 4, w0 += stepX0, w1 += stepX1, w2 += stepX2)
+            {
+                if ((w0 + bias0) < 0 || (w1 + bias1) < 0 || (w2 + bias2) < 0)
+                {
+                    continue;
+                }
+
+                const csmFloat32 b1 = static_cast<csmFloat32>(w1) * inverseArea;
+                const csmFloat32 b2 = static_cast<csmFloat32>(w2) * inverseArea;
+                const csmFloat32 b0 = 1.0f - b1 - b2;
+                const csmFloat32 u = u0 * b0 + u1 * b1 + u2 * b2;
+                const csmFloat32 v = t0 * b0 + t1 * b1 + t2 * b2;
+
+                // テクスチャの先頭の行が画像の上端のため、OpenGLES2のシェーダと同じくVを反転して読む
+                const csmFloat32 texelX = u * textureWidth - 0.5f;
+                const csmFloat32 texelY = (1.0f - v) * textureHeight - 0.5f;
+
+                if (isGeneratingMask)
+                {
+                    const csmFloat32 ndcX = (static_cast<csmFloat32>(x) + 0.5f) * pixelToNdcX - 1.0f;
+                    if (ndcX < layoutBounds[0] || ndcY < layoutBounds[1] || ndcX > layoutBounds[2] || ndcY > layoutBounds[3])
+                    {
+                        continue;
+                    }
+
+                    const csmFloat32 alpha = Vec4Alpha(SampleBilinear(texture.Pixels, texture.Width, texture.Height, texelX, texelY, true));
+                    StorePixel(pixel, Blend(Vec4Mul(channelFlagVector, Vec4Splat(alpha)), LoadPixel(pixel), blendMode));
+                    continue;
+                }
+
+                Vec4 texColor = SampleBilinear(texture.Pixels, texture.Width, texture.Height, texelX, texelY, true);
+                texColor = Vec4Mul(texColor, multiplyColor);
+
+                Vec4 color;
+                if (isPremultipliedAlpha)
+                {
+                    texColor = Vec4Sub(Vec4Add(texColor, Vec4Mul(screenColor, Vec4Splat(Vec4Alpha(texColor)))), Vec4Mul(texColor, screenColor));
+                    color = Vec4Mul(texColor, baseColor);
+                }
+                else
+                {
+                    texColor = Vec4Sub(Vec4Add(texColor, screenColor), Vec4Mul(texColor, screenColor));
+                    color = Vec4Mul(texColor, baseColor);
+                    const csmFloat32 alpha = Vec4Alpha(color);
+                    color = Vec4Mul(color, Vec4Set(alpha, alpha, alpha, 1.0f));
+                }
+
+                if (maskBuffer != NULL)
+                {
+                    const csmFloat32 clipX = cx0 * b0 + cx1 * b1 + cx2 * b2;
+                    const csmFloat32 clipY = cy0 * b0 + cy1 * b1 + cy2 * b2;
+                    const Vec4 maskColor = SampleBilinear(maskBuffer->GetPixels(), static_cast<csmInt32>(maskBuffer->GetBufferWidth()), static_cast<csmInt32>(maskBuffer->GetBufferHeight()),
+                                                          clipX * static_cast<csmFloat32>(maskBuffer->GetBufferWidth()) - 0.5f, clipY * static_cast<csmFloat32>(maskBuffer->GetBufferHeight()) - 0.5f, false);
+
+                    csmFloat32 clipMask[4];
+                    Vec4Store(clipMask, Vec4Mul(Vec4Sub(Vec4Splat(1.0f), maskColor), channelFlagVector));
+                    csmFloat32 maskValue = clipMask[0] + clipMask[1] + clipMask[2] + clipMask[3];
+                    if (isInvertedMask)
+                    {
+                        maskValue = 1.0f - maskValue;
+                    }
+
+                    color = Vec4Mul(color, Vec4Splat(maskValue));
+                }
+
+                StorePixel(pixel, Blend(color, LoadPixel(pixel), blendMode));
+            }
+        }
+    }
+}
+
+void CubismRenderer_Software::GetScissorForMask(const CubismClippingContext* clipContext, csmInt32* scissor) const
+{
+    // 割り当てられた領域を画素単位に直す。OpenGLES2のシザー矩形と同じ丸め方にする
+    const csmRectF* layoutBoundsOnTex01 = clipContext->_layoutBounds;
+    const CubismVector2 maskBufferSize = _clippingManager->GetClippingMaskBufferSize();
+    scissor[0] = static_cast<csmInt32>(layoutBoundsOnTex01->X * maskBufferSize.X + 0.5f);
+    scissor[1] = static_cast<csmInt32>(layoutBoundsOnTex01->Y * maskBufferSize.Y + 0.5f);
+    scissor[2] = static_cast<csmInt32>((layoutBoundsOnTex01->X + layoutBoundsOnTex01->Width) * maskBufferSize.X + 0.5f);
+    scissor[3] = static_cast<csmInt32>((layoutBoundsOnTex01->Y + layoutBoundsOnTex01->Height) * maskBufferSize.Y + 0.5f);
+}
+
+void CubismRenderer_Software::SaveProfile()
+{
+}
+
+void CubismRenderer_Software::RestoreProfile()
+{
+}
+
+void CubismRenderer_Software::SetClippingMaskBufferSize(csmFloat32 width, csmFloat32 height)
+{
+    if (_clippingManager == NULL)
+    {
+        return;
+    }
+
+    // インスタンス破棄前にマスク用バッファの数を保存
+    const csmInt32 renderTextureCount = _clippingManager->GetRenderTextureCount();
+
+    // マスク用バッファは次の描画でサイズを合わせて作り直される
+    CSM_DELETE_SELF(CubismClippingManager_Software, _clippingManager);
+
+    _clippingManager = CSM_NEW CubismClippingManager_Software();
+
+    _clippingManager->SetClippingMaskBufferSize(width, height);
+
+    _clippingManager->Initialize(
+        *GetModel(),
+        renderTextureCount
+    );
+}
+
+csmInt32 CubismRenderer_Software::GetRenderTextureCount() const
+{
+    return _clippingManager->GetRenderTextureCount();
+}
+
+CubismVector2 CubismRenderer_Software::GetClippingMaskBufferSize() const
+{
+    return _clippingManager->GetClippingMaskBufferSize();
+}
+
+csmInt32 CubismRenderer_Software::GetSkippedClippingContextCount() const
+{
+    return (_clippingManager != NULL) ? _clippingManager->GetSkippedContextCount() : 0;
+}
+
+csmInt32 CubismRenderer_Software::GetRedrawnClippingContextCount() const
+{
+    return (_clippingManager != NULL) ? _clippingManager->GetRedrawnContextCount() : 0;
+}
+
+CubismOffscreenSurface_Software* CubismRenderer_Software::GetMaskBuffer(csmInt32 index)
+{
+    return _offscreenSurfaces[index];
+}
+
+}}}}
+
+//------------ LIVE2D NAMESPACE ------------
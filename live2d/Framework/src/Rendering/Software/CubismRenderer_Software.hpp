@@ -0,0 +1,269 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "../CubismRenderer.hpp"
+#include "../CubismClippingManager.hpp"
+#include "../CubismRenderCommandList.hpp"
+#include "CubismFramework.hpp"
+#include "CubismOffscreenSurface_Software.hpp"
+#include "Type/csmVector.hpp"
+#include "Math/CubismVector2.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Rendering {
+
+//  前方宣言
+class CubismRenderer_Software;
+class CubismClippingContext_Software;
+
+/**
+ * @brief  クリッピングマスクの処理を実行するクラス
+ *
+ */
+class CubismClippingManager_Software : public CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>
+{
+};
+
+/**
+ * @brief   クリッピングマスクのコンテキスト
+ */
+class CubismClippingContext_Software : public CubismClippingContext
+{
+    friend class CubismClippingManager_Software;
+    friend class CubismRenderer_Software;
+
+public:
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     */
+    CubismClippingContext_Software(CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* manager, CubismModel& model, const csmInt32* clippingDrawableIndices, csmInt32 clipCount);
+
+    /**
+     * @brief   デストラクタ
+     */
+    virtual ~CubismClippingContext_Software();
+
+    /**
+     * @brief   このマスクを管理するマネージャのインスタンスを取得する。
+     *
+     * @return  クリッピングマネージャのインスタンス
+     */
+    CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* GetClippingManager();
+
+    CubismClippingManager<CubismClippingContext_Software, CubismOffscreenSurface_Software>* _owner;        ///< このマスクを管理しているマネージャのインスタンス
+};
+
+/**
+ * @brief   CPUでモデルを描画するレンダラ<br>
+ *           OpenGLES2と同じ描画命令を、CPUのメモリ上のRGBAのバッファにラスタライズする。
+ *           ブレンドモード・乗算色・スクリーン色・カリング・クリッピングマスク(反転を含む)はOpenGLES2のシェーダと同じ計算をする。
+ *           描画先は横長の帯(タイル)に分け、CubismFramework::SetJobSystem()で設定したジョブシステムで並列に塗る。
+ *           GPUのない環境でのサムネイル作成や画像の比較に使う
+ */
+class CubismRenderer_Software : public CubismRenderer
+{
+    friend class CubismRenderer;
+
+public:
+    static const csmInt32 TileRowCount = 32;    ///< 1つのジョブで塗る行数
+
+    /**
+     * @brief    レンダラの初期化処理を実行する<br>
+     *           引数に渡したモデルからレンダラの初期化処理に必要な情報を取り出すことができる
+     *
+     * @param[in]  model -> モデルのインスタンス
+     */
+    void Initialize(Framework::CubismModel* model);
+
+    void Initialize(Framework::CubismModel* model, csmInt32 maskBufferCount);
+
+    /**
+     * @brief   モデルが参照するテクスチャの画素を設定する。画素はコピーせず、描画が終わるまで呼び出し側が保持する
+     *
+     * @param[in]   modelTextureIndex   ->  モデルのテクスチャ番号
+     * @param[in]   pixels              ->  RGBA各8bitの画素。stb_imageで読み込んだときと同じく先頭の行を画像の上端とする
+     * @param[in]   width               ->  テクスチャの幅
+     * @param[in]   height              ->  テクスチャの高さ
+     */
+    void BindTexture(csmUint32 modelTextureIndex, const csmUint8* pixels, csmInt32 width, csmInt32 height);
+
+    /**
+     * @brief   描画先を設定する。描画先のクリアは呼び出し側で行う
+     *
+     * @param[in]   pixels  ->  RGBA各8bit(乗算済みアルファ)の画素。OpenGLのフレームバッファと同じく先頭の行を画面の下端とする
+     * @param[in]   width   ->  描画先の幅
+     * @param[in]   height  ->  描画先の高さ
+     */
+    void SetRenderTarget(csmUint8* pixels, csmInt32 width, csmInt32 height);
+
+    /**
+     * @brief  クリッピングマスクバッファのサイズを設定する<br>
+     *         マスク用のバッファを破棄・再作成するため処理コストは高い。
+     *
+     * @param[in]  width -> クリッピングマスクバッファの幅
+     * @param[in]  height -> クリッピングマスクバッファの高さ
+     */
+    void SetClippingMaskBufferSize(csmFloat32 width, csmFloat32 height);
+
+    /**
+     * @brief  マスク用のバッファの数を取得する
+     *
+     * @return  マスク用のバッファの数
+     */
+    csmInt32 GetRenderTextureCount() const;
+
+    /**
+     * @brief  クリッピングマスクバッファのサイズを取得する
+     *
+     * @return クリッピングマスクバッファのサイズ
+     */
+    CubismVector2 GetClippingMaskBufferSize() const;
+
+    /**
+     * @brief  直前の描画で、マスクの描き直しを省略したクリッピングコンテキストの数を取得する
+     *
+     * @return 省略したクリッピングコンテキストの数
+     */
+    csmInt32 GetSkippedClippingContextCount() const;
+
+    /**
+     * @brief  直前の描画で、マスクを作り直したクリッピングコンテキストの数を取得する
+     *
+     * @return 作り直したクリッピングコンテキストの数
+     */
+    csmInt32 GetRedrawnClippingContextCount() const;
+
+    /**
+     * @brief  マスク用のバッファを取得する
+     *
+     * @param[in]   index   ->  マスク用のバッファの番号
+     * @return マスク用のバッファ
+     */
+    CubismOffscreenSurface_Software* GetMaskBuffer(csmInt32 index);
+
+protected:
+    /**
+     * @brief   コンストラクタ
+     */
+    CubismRenderer_Software();
+
+    /**
+     * @brief   デストラクタ
+     */
+    virtual ~CubismRenderer_Software();
+
+    /**
+     * @brief   モデルを描画する実際の処理
+     *
+     */
+    virtual void DoDrawModel() override;
+
+private:
+    /**
+     * @brief   モデルが参照するテクスチャ
+     */
+    struct Texture
+    {
+        const csmUint8* Pixels;     ///< RGBAの画素。NULLなら設定されていない
+        csmInt32 Width;             ///< 幅
+        csmInt32 Height;            ///< 高さ
+    };
+
+    /**
+     * @brief   同じ描画先に続けて実行する描画命令の範囲。ジョブに渡す
+     */
+    struct PassContext
+    {
+        CubismRenderer_Software* Renderer;  ///< レンダラ
+        csmInt32 FirstCommand;              ///< 先頭の命令の番号
+        csmInt32 EndCommand;                ///< 最後の命令の次の番号
+        csmUint8* Pixels;                   ///< 描画先の画素
+        csmInt32 Width;                     ///< 描画先の幅
+        csmInt32 Height;                    ///< 描画先の高さ
+    };
+
+    // Prevention of copy Constructor
+    CubismRenderer_Software(const CubismRenderer_Software&);
+    CubismRenderer_Software& operator=(const CubismRenderer_Software&);
+
+    /**
+     * @brief   モデル描画直前のステートを保持する。保持するステートはない
+     */
+    virtual void SaveProfile();
+
+    /**
+     * @brief   モデル描画直前のステートを復帰させる。復帰させるステートはない
+     */
+    virtual void RestoreProfile();
+
+    /**
+     * @brief   同じ描画先への描画命令をまとめて実行する。描画先をタイルに分け、ジョブシステムがあれば並列に塗る
+     *
+     * @param[in]   pass    ->  実行する命令の範囲と描画先
+     */
+    void DrawPass(PassContext& pass);
+
+    /**
+     * @brief   1つのタイルを塗るジョブ
+     *
+     * @param[in]   context     ->  PassContext
+     * @param[in]   jobIndex    ->  タイルの番号
+     */
+    static void DrawTileJob(void* context, csmInt32 jobIndex);
+
+    /**
+     * @brief   描画命令のうち、指定した行の範囲だけを塗る。他のタイルとは書き込む画素が重ならない
+     *
+     * @param[in]   pass        ->  実行する命令の範囲と描画先
+     * @param[in]   rowBegin    ->  塗る最初の行
+     * @param[in]   rowEnd      ->  塗る最後の行の次
+     */
+    void DrawTile(const PassContext& pass, csmInt32 rowBegin, csmInt32 rowEnd);
+
+    /**
+     * @brief   描画命令の頂点を描画先の画素の座標に変換する。マスクを使う描画はマスク用バッファ上の座標も求める
+     *
+     * @param[in]   pass    ->  変換する命令の範囲と描画先
+     */
+    void TransformVertices(const PassContext& pass);
+
+    /**
+     * @brief   1つの描画命令の三角形を、指定した行と矩形の範囲でラスタライズする
+     *
+     * @param[in]   pass            ->  描画先
+     * @param[in]   commandIndex    ->  描画命令の番号
+     * @param[in]   rowBegin        ->  塗る最初の行
+     * @param[in]   rowEnd          ->  塗る最後の行の次
+     * @param[in]   scissor         ->  塗る矩形(left, bottom, right, top)。画素単位
+     */
+    void RasterizeCommand(const PassContext& pass, csmInt32 commandIndex, csmInt32 rowBegin, csmInt32 rowEnd, const csmInt32* scissor) const;
+
+    /**
+     * @brief   クリッピングコンテキストに割り当てられたマスク用バッファ上の矩形を画素単位で求める
+     *
+     * @param[in]   clipContext ->  クリッピングコンテキスト
+     * @param[out]  scissor     ->  矩形(left, bottom, right, top)
+     */
+    void GetScissorForMask(const CubismClippingContext* clipContext, csmInt32* scissor) const;
+
+    CubismClippingManager_Software* _clippingManager;               ///< クリッピングマスク管理オブジェクト
+    CubismRenderCommandList _commandList;                           ///< 1フレーム分の描画命令
+    csmVector<Texture> _textures;                                   ///< モデルが参照するテクスチャ
+    csmVector<CubismOffscreenSurface_Software*> _offscreenSurfaces; ///< マスク用のバッファ
+    csmUint8* _renderTarget;                                        ///< 描画先の画素
+    csmInt32 _renderTargetWidth;                                    ///< 描画先の幅
+    csmInt32 _renderTargetHeight;                                   ///< 描画先の高さ
+    csmVector<csmInt32> _vertexOffsets;                             ///< 命令ごとの、変換した頂点の先頭の番号
+    csmVector<csmFloat32> _screenPositions;                         ///< 描画先の画素の座標に変換した頂点
+    csmVector<csmFloat32> _clipPositions;                           ///< マスク用バッファ上の座標に変換した頂点
+};
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
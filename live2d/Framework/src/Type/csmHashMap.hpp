@@ -0,0 +1,740 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "csmMap.hpp"
+#include "csmString.hpp"
+#include "csmStringView.hpp"
+#include "Utils/CubismDebug.hpp"
+
+#ifndef NULL
+#   define  NULL 0
+#endif
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+//========================テンプレートの宣言==============================
+
+/**
+ * @brief   ハッシュ値の攪拌
+ *
+ * 下位ビットに偏りのある値を、索引に使えるように全ビットへ拡散する。
+ *
+ * @param[in]   value   ->  攪拌する値
+ * @return  攪拌したハッシュ値
+ */
+inline csmUint32 csmHashMix(csmUint64 value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return static_cast<csmUint32>(value);
+}
+
+/**
+ * @brief   csmHashMapのキーのハッシュ値を計算するクラス。<br>
+ *          整数型と列挙型に対応する。その他の型は特殊化して定義する。
+ */
+template<class _KeyT>
+struct csmHash
+{
+    static csmUint32 Calculate(const _KeyT& key) { return csmHashMix(static_cast<csmUint64>(key)); }
+};
+
+/**
+ * @brief   ポインタ型のキーのハッシュ値を計算するクラス。<br>
+ *          CubismIdHandleなど、アドレスで同一性を判定するキーに用いる。
+ */
+template<class _T>
+struct csmHash<_T*>
+{
+    static csmUint32 Calculate(_T* key) { return csmHashMix(static_cast<csmUint64>(reinterpret_cast<csmSizeType>(key))); }
+};
+
+/**
+ * @brief   csmString型のキーのハッシュ値を計算するクラス。<br>
+ *          csmStringが保持しているハッシュコードを用いるため、文字列を走査しない。
+ */
+template<>
+struct csmHash<csmString>
+{
+    static csmUint32 Calculate(const csmString& key) { return csmHashMix(static_cast<csmUint32>(key.GetHashcode())); }
+
+    /**
+     * @brief   csmStringViewで検索する場合のハッシュ値。csmStringと同じ値になる
+     */
+    static csmUint32 Calculate(const csmStringView& key) { return csmHashMix(static_cast<csmUint32>(key.GetHashcode())); }
+
+    /**
+     * @brief   文字列で検索する場合のハッシュ値。csmStringと同じ値になる
+     */
+    static csmUint32 Calculate(const csmChar* key) { return Calculate(csmStringView(key)); }
+};
+
+/**
+ * @brief   ハッシュマップ型<br>
+ *           csmMapと同じインターフェースで、キーの検索をハッシュ表で行う。<br>
+ *           要素は追加した順に連続した配列に格納し、イテレータは追加した順に要素を返す。<br>
+ *           索引はオープンアドレス法で、各スロットにキーのハッシュ値と要素のインデックスを持つ。
+ */
+template<class _KeyT, class _ValT, class _HashT = csmHash<_KeyT> >
+class csmHashMap
+{
+public:
+
+    /**
+     * @brief    コンストラクタ
+     */
+    csmHashMap();
+
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   capacity    ->  初期化時点で確保する要素数
+     */
+    csmHashMap(csmInt32 capacity);
+
+    /**
+     * @brief   デストラクタ
+     *
+     */
+    virtual ~csmHashMap();
+
+    /**
+     * @brief   キーを追加する
+     *
+     * すでに存在するキーの場合は何もしない。
+     *
+     * @param[in]   key ->  新たに追加するキー
+     */
+    void AppendKey(const _KeyT& key)
+    {
+        const csmUint32 hash = _HashT::Calculate(key);
+        if (FindIndex(key, hash) < 0)
+        {
+            InsertKey(key, hash);
+        }
+    }
+
+    /**
+     * @brief   添字演算子[key]のオーバーロード
+     *
+     * キーが存在しない場合は追加する。
+     *
+     * @return  添字から特定されるValue値
+     */
+    _ValT& operator[](const _KeyT& key)
+    {
+        const csmUint32 hash = _HashT::Calculate(key);
+        csmInt32 found = FindIndex(key, hash);
+        if (found < 0)
+        {
+            found = InsertKey(key, hash); // 新規キーを追加
+        }
+        return _keyValues[found].Second;
+    }
+
+    /**
+     * @brief   添字演算子[key]のオーバーロード(const)
+     *
+     * @return  添字から特定されるValue値
+     */
+    const _ValT& operator[](const _KeyT& key) const
+    {
+        const csmInt32 found = FindIndex(key, _HashT::Calculate(key));
+        if (found >= 0)
+        {
+            return _keyValues[found].Second;
+        }
+        else
+        {
+            if (!_dummyValuePtr) _dummyValuePtr = CSM_NEW _ValT();
+            return *_dummyValuePtr;
+        }
+    }
+
+    /**
+     * @brief   引数で渡したKeyを持つ要素の値を取得する
+     *
+     * IsExistと添字演算子を続けて呼ぶ代わりに、一度の検索で値を取得する。
+     *
+     * @return  Valueのポインタ。Keyを持つ要素が存在しなければNULL
+     */
+    _ValT* Find(const _KeyT& key)
+    {
+        const csmInt32 found = FindIndex(key, _HashT::Calculate(key));
+        return (found >= 0) ? &_keyValues[found].Second : NULL;
+    }
+
+    /**
+     * @brief   引数で渡したKeyを持つ要素の値を取得する(const)
+     *
+     * @return  Valueのポインタ。Keyを持つ要素が存在しなければNULL
+     */
+    const _ValT* Find(const _KeyT& key) const
+    {
+        const csmInt32 found = FindIndex(key, _HashT::Calculate(key));
+        return (found >= 0) ? &_keyValues[found].Second : NULL;
+    }
+
+    /**
+     * @brief   引数で渡したKeyを持つ要素が存在するか
+     *
+     * @retval  true    ->  引数で渡したKeyを持つ要素が存在する
+     * @retval  false   ->  引数で渡したKeyを持つ要素が存在しない
+     */
+    csmBool IsExist(const _KeyT& key) const
+    {
+        return FindIndex(key, _HashT::Calculate(key)) >= 0;
+    }
+
+    /**
+     * @brief   キーと比較できる別の型で要素の値を取得する
+     *
+     * csmStringをキーとするマップをcsmStringViewや文字列で検索するなど、キーを作らずに検索する。<br>
+     * _HashTは検索に使う型からキーと同じハッシュ値を計算できなければならない。
+     *
+     * @return  Valueのポインタ。Keyを持つ要素が存在しなければNULL
+     */
+    template<class _LookupT>
+    _ValT* Find(const _LookupT& key)
+    {
+        const csmInt32 found = FindIndex(key, _HashT::Calculate(key));
+        return (found >= 0) ? &_keyValues[found].Second : NULL;
+    }
+
+    /**
+     * @brief   キーと比較できる別の型で要素の値を取得する(const)
+     *
+     * @return  Valueのポインタ。Keyを持つ要素が存在しなければNULL
+     */
+    template<class _LookupT>
+    const _ValT* Find(const _LookupT& key) const
+    {
+        const csmInt32 found = FindIndex(key, _HashT::Calculate(key));
+        return (found >= 0) ? &_keyValues[found].Second : NULL;
+    }
+
+    /**
+     * @brief   キーと比較できる別の型で要素が存在するか調べる
+     *
+     * @retval  true    ->  引数で渡したKeyを持つ要素が存在する
+     * @retval  false   ->  引数で渡したKeyを持つ要素が存在しない
+     */
+    template<class _LookupT>
+    csmBool IsExist(const _LookupT& key) const
+    {
+        return FindIndex(key, _HashT::Calculate(key)) >= 0;
+    }
+
+    /**
+     * @brief   Key-Valueのポインタを全て解放する
+     */
+    void Clear();
+
+    /**
+     * @brief   コンテナのサイズを取得する
+     *
+     * @return  コンテナのサイズ
+     */
+    csmInt32 GetSize() const { return _size; }
+
+    /**
+     * @brief   コンテナのキャパシティを確保する
+     *
+     * @param[in]   newSize     -> 新たなキャパシティ。引数の値が現在のサイズ未満の場合は何もしない。
+     * @param[in]   fitToSize   ->  trueなら指定したサイズに合わせる。falseならサイズを2倍確保しておく。
+     */
+    void PrepareCapacity(csmInt32 newSize, csmBool fitToSize);
+
+    /**
+     * @brief   csmHashMap<T>のイテレータ
+     */
+    class iterator
+    {
+        // csmHashMap<T>をフレンドクラスとする
+        friend class csmHashMap;
+
+    public:
+        /**
+         * @brief   コンストラクタ
+         *
+         */
+        iterator() : _index(0)
+                   , _map(NULL) {}
+
+        /**
+         * @brief   引数付きコンストラクタ
+         *
+         * @param[in]   v   ->  csmHashMap<T>のオブジェクト
+         * @param[in]   idx ->  コンテナから参照するインデックス値
+         */
+        iterator(csmHashMap* v, csmInt32 idx = 0) : _index(idx)
+                                                  , _map(v) {}
+
+        /**
+         * @brief   前置++演算子のオーバーロード
+         *
+         */
+        iterator& operator++()
+        {
+            ++this->_index;
+            return *this;
+        }
+
+        /**
+         * @brief   前置--演算子のオーバーロード
+         *
+         */
+        iterator& operator--()
+        {
+            --this->_index;
+            return *this;
+        }
+
+        /**
+         * @brief   後置++演算子のオーバーロード(intは後置用のダミー引数)
+         *
+         */
+        iterator operator++(csmInt32)
+        {
+            iterator iteold(this->_map, this->_index++); // 古い値を保存
+            return iteold; // 古い値を返す
+        }
+
+        /**
+         * @brief   後置--演算子のオーバーロード(intは後置用のダミー引数)
+         *
+         */
+        iterator operator--(csmInt32)
+        {
+            iterator iteold(this->_map, this->_index--); // 古い値を保存
+            return iteold;
+        }
+
+        /**
+         * @brief   ->演算子のオーバーロード
+         *
+         */
+        csmPair<_KeyT, _ValT>* operator->() const
+        {
+            return &this->_map->_keyValues[this->_index];
+        }
+
+        /**
+         * @brief    *演算子のオーバーロード
+         *
+         */
+        csmPair<_KeyT, _ValT>& operator*() const
+        {
+            return this->_map->_keyValues[this->_index];
+        }
+
+        /**
+         * @brief   !=演算子のオーバーロード
+         *
+         */
+        csmBool operator!=(const iterator& ite) const
+        {
+            return (this->_index != ite._index) || (this->_map != ite._map);
+        }
+
+    private:
+        csmInt32 _index;        ///< コンテナのインデックス値
+        csmHashMap* _map;       ///< コンテナのポインタ
+    };
+
+    /**
+     * @brief   csmHashMap<T>のイテレータ(const)
+     */
+    class const_iterator
+    {
+        // csmHashMap<T>をフレンドクラスとする
+        friend class csmHashMap;
+
+    public:
+        /**
+         * @brief   コンストラクタ
+         *
+         */
+        const_iterator() : _index(0)
+                         , _map(NULL) {}
+
+        /**
+         * @brief   引数付きコンストラクタ
+         *
+         * @param[in]   v   ->  csmHashMap<T>のオブジェクト
+         * @param[in]   idx ->  コンテナから参照するインデックス値
+         */
+        const_iterator(const csmHashMap* v, csmInt32 idx = 0) : _index(idx)
+                                                              , _map(v) {}
+
+        /**
+         * @brief   前置++演算子のオーバーロード
+         *
+         */
+        const_iterator& operator++()
+        {
+            ++this->_index;
+            return *this;
+        }
+
+        /**
+         * @brief   前置--演算子のオーバーロード
+         *
+         */
+        const_iterator& operator--()
+        {
+            --this->_index;
+            return *this;
+        }
+
+        /**
+         * @brief   後置++演算子のオーバーロード(intは後置用のダミー引数)
+         *
+         */
+        const_iterator operator++(csmInt32)
+        {
+            const_iterator iteold(this->_map, this->_index++); // 古い値を保存
+            return iteold; // 古い値を返す
+        }
+
+        /**
+         * @brief   後置--演算子のオーバーロード(intは後置用のダミー引数)
+         *
+         */
+        const_iterator operator--(csmInt32)
+        {
+            const_iterator iteold(this->_map, this->_index--); // 古い値を保存
+            return iteold;
+        }
+
+        /**
+         * @brief   ->演算子のオーバーロード
+         *
+         */
+        csmPair<_KeyT, _ValT>* operator->() const
+        {
+            return &this->_map->_keyValues[this->_index];
+        }
+
+        /**
+         * @brief    *演算子のオーバーロード
+         *
+         */
+        csmPair<_KeyT, _ValT>& operator*() const
+        {
+            return this->_map->_keyValues[this->_index];
+        }
+
+        /**
+         * @brief   !=演算子のオーバーロード
+         *
+         */
+        csmBool operator!=(const const_iterator& ite) const
+        {
+            return (this->_index != ite._index) || (this->_map != ite._map);
+        }
+
+    private:
+        csmInt32 _index;            ///< コンテナのインデックス値
+        const csmHashMap* _map;     ///< コンテナのポインタ(const)
+    };
+
+    /**
+     * @brief   コンテナの先頭要素を返す
+     *
+     */
+    const const_iterator Begin() const
+    {
+        const_iterator ite(this, 0);
+        return ite;
+    }
+
+    /**
+     * @bief    コンテナの終端要素を返す
+     *
+     */
+    const const_iterator End() const
+    {
+        const_iterator ite(this, _size); // 終了
+        return ite;
+    }
+
+    /**
+     * @brief   コンテナから要素を削除する
+     *
+     * 後ろの要素を詰めて追加した順番を保つため、索引を作り直す。
+     *
+     * @param[in]   ite ->  削除する要素
+     *
+     */
+    const iterator Erase(const iterator& ite)
+    {
+        EraseAt(ite._index);
+        iterator ite2(this, ite._index);
+        return ite2;
+    }
+
+    /**
+     * @brief   コンテナから要素を削除する
+     *
+     * 後ろの要素を詰めて追加した順番を保つため、索引を作り直す。
+     *
+     * @param[in]   ite ->  削除する要素
+     *
+     */
+    const const_iterator Erase(const const_iterator& ite)
+    {
+        EraseAt(ite._index);
+        const_iterator ite2(this, ite._index);
+        return ite2;
+    }
+
+private:
+    /**
+     * @brief   索引のスロット
+     */
+    struct Slot
+    {
+        csmUint32 Hash;     ///< キーのハッシュ値
+        csmInt32 Index;     ///< 要素のインデックス。空なら-1
+    };
+
+    static const csmInt32 DefaultSize = 8;  ///< コンテナ初期化のデフォルトサイズ
+
+    /**
+     * @brief   キーから要素のインデックスを検索する
+     *
+     * @param[in]   key     ->  検索するキー
+     * @param[in]   hash    ->  キーのハッシュ値
+     * @return  要素のインデックス。存在しなければ-1
+     */
+    template<class _LookupT>
+    csmInt32 FindIndex(const _LookupT& key, csmUint32 hash) const
+    {
+        if (_slots == NULL)
+        {
+            return -1;
+        }
+
+        for (csmUint32 i = hash & _slotMask; ; i = (i + 1) & _slotMask)
+        {
+            const Slot& slot = _slots[i];
+            if (slot.Index < 0)
+            {
+                return -1;
+            }
+            if (slot.Hash == hash && _keyValues[slot.Index].First == key)
+            {
+                return slot.Index;
+            }
+        }
+    }
+
+    /**
+     * @brief   存在しないキーを末尾に追加する
+     *
+     * @param[in]   key     ->  追加するキー
+     * @param[in]   hash    ->  キーのハッシュ値
+     * @return  追加した要素のインデックス
+     */
+    csmInt32 InsertKey(const _KeyT& key, csmUint32 hash)
+    {
+        PrepareCapacity(_size + 1, false); //１つ以上入る隙間を作る
+
+        void* addr = &_keyValues[_size];
+        CSM_PLACEMENT_NEW(addr) csmPair<_KeyT, _ValT>(key); //placement new
+
+        InsertSlot(hash, _size);
+
+        return _size++;
+    }
+
+    /**
+     * @brief   索引にスロットを追加する
+     *
+     * @param[in]   hash    ->  キーのハッシュ値
+     * @param[in]   index   ->  要素のインデックス
+     */
+    void InsertSlot(csmUint32 hash, csmInt32 index)
+    {
+        csmUint32 i = hash & _slotMask;
+        while (_slots[i].Index >= 0)
+        {
+            i = (i + 1) & _slotMask;
+        }
+        _slots[i].Hash = hash;
+        _slots[i].Index = index;
+    }
+
+    /**
+     * @brief   索引を作り直す
+     *
+     * @param[in]   slotCount   ->  スロットの数。2のべき乗
+     */
+    void RebuildSlots(csmUint32 slotCount);
+
+    /**
+     * @brief   指定したインデックスの要素を削除する
+     *
+     * @param[in]   index   ->  削除する要素のインデックス
+     */
+    void EraseAt(csmInt32 index);
+
+    csmPair<_KeyT, _ValT>* _keyValues;      ///< Key-Valueペアの配列。追加した順に並ぶ
+    mutable _ValT* _dummyValuePtr;          ///< 空の値を返すためのダミー(staticのtemplteを回避するためメンバとする）
+    csmInt32 _size;                         ///< コンテナの要素数（サイズ）
+    csmInt32 _capacity;                     ///< コンテナのキャパシティ
+    Slot* _slots;                           ///< 索引。スロットの数は2のべき乗
+    csmUint32 _slotMask;                    ///< スロットの数から1を引いた値
+};
+
+
+//========================テンプレートの定義==============================
+
+template<class _KeyT, class _ValT, class _HashT>
+csmHashMap<_KeyT, _ValT, _HashT>::csmHashMap()
+    : _keyValues(NULL)
+    , _dummyValuePtr(NULL)
+    , _size(0)
+    , _capacity(0)
+    , _slots(NULL)
+    , _slotMask(0)
+{ }
+
+template<class _KeyT, class _ValT, class _HashT>
+csmHashMap<_KeyT, _ValT, _HashT>::csmHashMap(csmInt32 capacity)
+    : _keyValues(NULL)
+    , _dummyValuePtr(NULL)
+    , _size(0)
+    , _capacity(0)
+    , _slots(NULL)
+    , _slotMask(0)
+{
+    if (capacity > 0)
+    {
+        PrepareCapacity(capacity, true);
+    }
+}
+
+template<class _KeyT, class _ValT, class _HashT>
+csmHashMap<_KeyT, _ValT, _HashT>::~csmHashMap()
+{
+    Clear();
+}
+
+template<class _KeyT, class _ValT, class _HashT>
+void csmHashMap<_KeyT, _ValT, _HashT>::PrepareCapacity(csmInt32 newSize, csmBool fitToSize)
+{
+    if (newSize <= _capacity)
+    {
+        return;
+    }
+
+    if (!fitToSize)
+    {
+        if (newSize < DefaultSize) newSize = DefaultSize;
+        if (newSize < _capacity * 2) newSize = _capacity * 2; // 指定サイズに合わせる必要がない場合は、２倍に広げる
+    }
+
+    csmPair<_KeyT, _ValT>* tmp = static_cast<csmPair<_KeyT, _ValT> *>(CSM_MALLOC(sizeof(csmPair<_KeyT, _ValT>) * newSize));
+
+    CSM_ASSERT(tmp != NULL);
+
+    if (_keyValues != NULL)
+    {
+        // csmMapと同様に要素はメモリのコピーで移動する
+        memcpy(static_cast<void*>(tmp), static_cast<void*>(_keyValues), sizeof(csmPair<_KeyT, _ValT>) * _size);
+        CSM_FREE(_keyValues);
+    }
+
+    _keyValues = tmp;
+    _capacity = newSize;
+
+    // 負荷率が1/2以下になるようにスロットを確保する
+    csmUint32 slotCount = 16;
+    while (slotCount < static_cast<csmUint32>(_capacity) * 2)
+    {
+        slotCount *= 2;
+    }
+
+    if (_slots == NULL || slotCount > _slotMask + 1)
+    {
+        RebuildSlots(slotCount);
+    }
+}
+
+template<class _KeyT, class _ValT, class _HashT>
+void csmHashMap<_KeyT, _ValT, _HashT>::RebuildSlots(csmUint32 slotCount)
+{
+    if (_slots == NULL || slotCount != _slotMask + 1)
+    {
+        if (_slots != NULL) CSM_FREE(_slots);
+
+        _slots = static_cast<Slot*>(CSM_MALLOC(sizeof(Slot) * slotCount));
+
+        CSM_ASSERT(_slots != NULL);
+
+        _slotMask = slotCount - 1;
+    }
+
+    for (csmUint32 i = 0; i < slotCount; ++i)
+    {
+        _slots[i].Index = -1;
+    }
+
+    for (csmInt32 i = 0; i < _size; ++i)
+    {
+        InsertSlot(_HashT::Calculate(_keyValues[i].First), i);
+    }
+}
+
+template<class _KeyT, class _ValT, class _HashT>
+void csmHashMap<_KeyT, _ValT, _HashT>::EraseAt(csmInt32 index)
+{
+    if (index < 0 || _size <= index) return; // 削除範囲外
+
+    _keyValues[index].~csmPair<_KeyT, _ValT>();
+
+    // 削除(メモリをシフトする)、最後の一つを削除する場合はmove不要
+    if (index < _size - 1)
+        memmove(static_cast<void*>(&_keyValues[index]), static_cast<void*>(&_keyValues[index + 1]), sizeof(csmPair<_KeyT, _ValT>) * (_size - index - 1));
+    --_size;
+
+    RebuildSlots(_slotMask + 1);
+}
+
+template<class _KeyT, class _ValT, class _HashT>
+void csmHashMap<_KeyT, _ValT, _HashT>::Clear()
+{
+    if (_dummyValuePtr) CSM_DELETE(_dummyValuePtr);
+    _dummyValuePtr = NULL;
+
+    for (csmInt32 i = 0; i < _size; i++)
+    {
+        _keyValues[i].~csmPair<_KeyT, _ValT>();
+    }
+
+    CSM_FREE(_keyValues);
+    CSM_FREE(_slots);
+
+    _keyValues = NULL;
+    _slots = NULL;
+    _slotMask = 0;
+
+    _size = 0;
+    _capacity = 0;
+}
+}}}
+
+//------------------------- LIVE2D NAMESPACE ------------
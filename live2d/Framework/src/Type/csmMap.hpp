@@ -93,7 +93,7 @@ public:
      *
      * @param[in]   key ->  新たに追加するキー
      */
-    void AppendKey(_KeyT& key)
+    void AppendKey(const _KeyT& key)
     {
         // 新しくKey/Valueのペアを作る
         PrepareCapacity(_size + 1, false); //１つ以上入る隙間を作る
@@ -110,7 +110,7 @@ public:
      *
      * @return  添字から特定されるValue値
      */
-    _ValT& operator[](_KeyT key)
+    _ValT& operator[](const _KeyT& key)
     {
         csmInt32 found = -1;
         for (csmInt32 i = 0; i < _size; i++)
@@ -137,7 +137,7 @@ public:
      *
      * @return  添字から特定されるValue値
      */
-    const _ValT& operator[](_KeyT key) const
+    const _ValT& operator[](const _KeyT& key) const
     {
         csmInt32 found = -1;
         for (csmInt32 i = 0; i < _size; i++)
@@ -165,7 +165,7 @@ public:
      * @retval  true    ->  引数で渡したKeyを持つ要素が存在する
      * @retval  false   ->  引数で渡したKeyを持つ要素が存在しない
      */
-    csmBool IsExist(_KeyT key)
+    csmBool IsExist(const _KeyT& key)
     {
         for (csmInt32 i = 0; i < _size; i++)
         {
@@ -6,6 +6,7 @@
  */
 
 #include "csmString.hpp"
+#include "csmStringView.hpp"
 #include <stdarg.h>
 #include "CubismFramework.hpp"
 #include "Utils/CubismDebug.hpp"
@@ -65,6 +66,12 @@ csmString::csmString(const csmString& s)
     _instanceNo = s_totalInstanceNo++;
 }
 
+csmString::csmString(csmString&& s)
+{
+    Take(s);
+    _instanceNo = s_totalInstanceNo++;
+}
+
 csmString::csmString(const csmChar* s, csmInt32 length)
 {
     if (length)
@@ -86,6 +93,12 @@ csmString::csmString(const csmChar* c, csmInt32 length, csmBool useptr)
     _instanceNo = s_totalInstanceNo++;
 }
 
+csmString::csmString(const csmStringView& v)
+{
+    Initialize(v.GetData(), v.GetLength(), false);
+    _instanceNo = s_totalInstanceNo++;
+}
+
 void csmString::Initialize(const csmChar* c, csmInt32 length, csmBool usePtr)
 {
     if (!length)
@@ -152,6 +165,17 @@ csmString& csmString::operator=(const csmString& s)
     return *this;
 }
 
+csmString& csmString::operator=(csmString&& s)
+{
+    if (this != &s)
+    {
+        Clear(); //現在のポインタを開放してから処理する
+
+        Take(s);
+    }
+    return *this;
+}
+
 csmString csmString::operator+(const csmString& s) const
 {
     csmSizeType len1 = static_cast<csmSizeType>(this->_length);
@@ -325,6 +349,25 @@ csmBool csmString::operator==(const csmChar* rc) const
     return true;
 }
 
+csmBool csmString::operator==(const csmStringView& v) const
+{
+    //サイズ違い
+    if (v.GetLength() != this->_length) return false;
+
+    //hashcode比較
+    if (v.GetHashcode() != this->_hashcode) return false;
+
+    const csmChar* lc = this->GetRawString();
+    const csmChar* rc = v.GetData();
+
+    //文字違い（逆順なのはPARAMの比較の特性）
+    for (csmInt32 i = this->_length - 1; i >= 0; --i)
+    {
+        if (lc[i] != rc[i]) return false;
+    }
+    return true;
+}
+
 csmBool csmString::operator<(const csmString& s) const
 {
     return strcmp(this->GetRawString(), s.GetRawString()) < 0;
@@ -431,14 +474,39 @@ void csmString::Copy(const csmChar* c, csmInt32 length)
     }
 }
 
+void csmString::Take(csmString& s)
+{
+    this->_ptr = s._ptr;
+    this->_length = s._length;
+    this->_hashcode = s._hashcode;
+
+    if (this->_length < SmallLength - 1)
+    {
+        memcpy(this->_small, s._small, this->_length + 1);
+    }
+
+    // ヒープの文字列の所有権を移したため、解放せずに空にする
+    s.SetEmpty();
+}
+
 csmInt32 csmString::CalcHashcode(const csmChar* c, csmInt32 length)
 {
+    if (c == GetEmptyString())
+    {
+        return -2;
+    }
+    return CalculateHashcode(c, length);
+}
+
+csmInt32 csmString::CalculateHashcode(const csmChar* c, csmInt32 length)
+{
+    // 終端の'\0'を含めて後ろから計算していた値と同じになる
     csmInt32 hash = 0;
-    for (csmInt32 i = length; i >= 0; --i)
+    for (csmInt32 i = length - 1; i >= 0; --i)
     {
         hash = hash * 31 + c[i];
     }
-    if ((hash == -1) || (c == GetEmptyString()))
+    if (hash == -1)
     {
         hash = -2; //-1だけ特別な意味をもたせる
     }
@@ -457,9 +525,10 @@ const csmChar* csmString::GetRawString() const
     }
 }
 
-csmInt32 csmString::GetHashcode()
+csmInt32 csmString::GetHashcode() const
 {
-    if (_hashcode == -1) _hashcode = CalcHashcode(WritePointer(), this->_length);
+    // 全てのコンストラクタと代入でCalcHashcodeを呼んでいるため、常に計算済み
+    CSM_ASSERT(_hashcode != -1);
     return _hashcode;
 }
 
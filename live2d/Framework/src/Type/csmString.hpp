@@ -13,6 +13,8 @@
 //--------- LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework {
 
+class csmStringView;
+
 /**
  * @brief   文字列クラス<br>
  *           コンシューマゲーム機等でSTLの組み込みを避けるための実装。<br>
@@ -49,6 +51,15 @@ public:
      */
     csmString(const csmString& s);
 
+    /**
+     * @brief   ムーブコンストラクタ
+     *
+     * ヒープに確保した文字列はコピーせずに引き継ぐ。
+     *
+     * @param[in]   s   ->  文字列。空になる
+     */
+    csmString(csmString&& s);
+
     /**
      * @brief   引数付きコンストラクタ
      *
@@ -58,6 +69,13 @@ public:
      */
     csmString(const csmChar* c, csmInt32 length, csmBool usePtr);
 
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   v   ->  コピーする文字列の参照
+     */
+    explicit csmString(const csmStringView& v);
+
     /**
      * @brief   デストラクタ
      *
@@ -69,6 +87,11 @@ public:
      */
     csmString& operator=(const csmString& s);
 
+    /**
+     * @brief =演算子のオーバーロード(csmString型のムーブ)
+     */
+    csmString& operator=(csmString&& s);
+
     /**
      * @brief =演算子のオーバーロード(csmChar型)
      */
@@ -84,6 +107,13 @@ public:
      */
     csmBool operator==(const csmChar* c) const;
 
+    /**
+     * @brief ==演算子のオーバーロード(csmStringView型)
+     *
+     * 長さとハッシュコードが一致した場合だけ文字を比較する。
+     */
+    csmBool operator==(const csmStringView& v) const;
+
     /**
      * @brief <演算子のオーバーロード(csmString型)
      */
@@ -164,10 +194,22 @@ public:
     /**
      * @brief   ハッシュコードを取得する
      *
+     * ハッシュコードは文字列を設定した時点で計算済みのため、文字列を走査しない。
+     *
      * @return  ハッシュコード
      */
-    csmInt32 GetHashcode();
+    csmInt32 GetHashcode() const;
 
+    /**
+     * @brief   文字列のハッシュコードを計算する
+     *
+     * csmStringが保持するハッシュコードと同じ値を返す。文字列は'\0'で終端されていなくてもよい。
+     *
+     * @param[in]   c       ->  文字列
+     * @param[in]   length  ->  文字列の長さ
+     * @return  ハッシュコード。-1にはならない
+     */
+    static csmInt32 CalculateHashcode(const csmChar* c, csmInt32 length);
 
 protected:
 
@@ -188,6 +230,13 @@ protected:
      */
     void Initialize(const csmChar* c, csmInt32 length, csmBool usePtr);
 
+    /**
+     * @brief   文字列を引き継ぐ。引き継いだ文字列は空になる
+     *
+     * @param[in]   s   ->  文字列
+     */
+    void Take(csmString& s);
+
     /**
      * @brief   文字列からハッシュ値を生成して返す
      *
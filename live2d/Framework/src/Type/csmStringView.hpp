@@ -0,0 +1,134 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "csmString.hpp"
+#include <string.h>
+
+//--------- LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework {
+
+/**
+ * @brief   文字列を所有しない参照<br>
+ *           文字列のポインタと長さだけを持ち、メモリを確保しない。<br>
+ *           ハッシュコードはcsmStringと同じ値になるため、csmStringをキーとするcsmHashMapの検索に使える。<br>
+ *           参照先の文字列はビューより長く生存していなければならない。
+ */
+class csmStringView
+{
+public:
+    /**
+     * @brief   コンストラクタ。空の文字列を参照する
+     */
+    csmStringView()
+        : _ptr("")
+        , _length(0)
+        , _hashcode(csmString::CalculateHashcode("", 0))
+    { }
+
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   c   ->  '\0'で終端された文字列
+     */
+    csmStringView(const csmChar* c)
+        : _ptr(c)
+        , _length(static_cast<csmInt32>(strlen(c)))
+        , _hashcode(UnknownHashcode)
+    { }
+
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   c       ->  文字列。'\0'で終端されていなくてもよい
+     * @param[in]   length  ->  文字列の長さ
+     */
+    csmStringView(const csmChar* c, csmInt32 length)
+        : _ptr(c)
+        , _length(length)
+        , _hashcode(UnknownHashcode)
+    { }
+
+    /**
+     * @brief   引数付きコンストラクタ。csmStringが計算済みのハッシュコードを引き継ぐ
+     *
+     * @param[in]   s   ->  文字列
+     */
+    csmStringView(const csmString& s)
+        : _ptr(s.GetRawString())
+        , _length(s.GetLength())
+        , _hashcode(s.GetHashcode())
+    { }
+
+    /**
+     * @brief   文字列の先頭のポインタを取得する。'\0'で終端されているとは限らない
+     */
+    const csmChar* GetData() const { return _ptr; }
+
+    /**
+     * @brief   文字列の長さを取得する
+     */
+    csmInt32 GetLength() const { return _length; }
+
+    /**
+     * @brief   空の文字列かどうか
+     */
+    csmBool IsEmpty() const { return _length == 0; }
+
+    /**
+     * @brief   ハッシュコードを取得する
+     *
+     * 最初の呼び出しで計算し、以降は計算済みの値を返す。
+     *
+     * @return  csmStringと同じハッシュコード
+     */
+    csmInt32 GetHashcode() const
+    {
+        if (_hashcode == UnknownHashcode)
+        {
+            _hashcode = csmString::CalculateHashcode(_ptr, _length);
+        }
+        return _hashcode;
+    }
+
+    /**
+     * @brief   ==演算子のオーバーロード(csmStringView型)
+     */
+    csmBool operator==(const csmStringView& v) const
+    {
+        if (_length != v._length)
+        {
+            return false;
+        }
+
+        // 両方のハッシュコードが計算済みの場合だけ比較する
+        if (_hashcode != UnknownHashcode && v._hashcode != UnknownHashcode && _hashcode != v._hashcode)
+        {
+            return false;
+        }
+
+        return memcmp(_ptr, v._ptr, _length) == 0;
+    }
+
+    /**
+     * @brief   !=演算子のオーバーロード(csmStringView型)
+     */
+    csmBool operator!=(const csmStringView& v) const { return !(*this == v); }
+
+private:
+    static const csmInt32 UnknownHashcode = -1;     ///< ハッシュコードが未計算であることを示す値。csmStringのハッシュコードは-1にならない
+
+    const csmChar* _ptr;                            ///< 文字列のポインタ
+    csmInt32 _length;                               ///< 文字列の長さ
+    mutable csmInt32 _hashcode;                     ///< ハッシュコード
+};
+
+}}}
+
+//------------------------- LIVE2D NAMESPACE -----------
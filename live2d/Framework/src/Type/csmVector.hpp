@@ -10,6 +10,8 @@
 #include "csmString.hpp"
 #include "CubismFramework.hpp"
 #include "Utils/CubismDebug.hpp"
+#include <type_traits>
+#include <utility>
 
 #ifndef NULL
 #   define  NULL    0
@@ -20,6 +22,20 @@ namespace Live2D { namespace Cubism { namespace Framework {
 
 //========================テンプレートの宣言==============================
 
+/**
+ * @brief   メモリのコピーで複製できる型か判定する<br>
+ *           std::is_trivially_copyableを持たない古いGCCでは、コンパイラ組み込みの判定を用いる。
+ */
+template<class T>
+struct csmIsTriviallyCopyable
+{
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ < 5)
+    static const csmBool Value = __has_trivial_copy(T) && __has_trivial_destructor(T);
+#else
+    static const csmBool Value = std::is_trivially_copyable<T>::value;
+#endif
+};
+
 /**
  * @brief   ベクター型（可変配列型）<br>
  *           コンシューマゲーム機等でSTLの組み込みを避けるための実装。std::vector の簡易版
@@ -58,6 +74,15 @@ public:
         return _ptr;
     }
 
+    /**
+     * @brief   コンテナの先頭アドレスを返す(const)
+     *
+     */
+    const T* GetPtr() const
+    {
+        return _ptr;
+    }
+
     /**
      * @brief   []演算子のオーバーロード
      *
@@ -94,9 +119,19 @@ public:
      */
     void PushBack(const T& value, csmBool callPlacementNew = true);
 
+    /**
+     * @brief   PushBack処理.コンテナに新たな要素をムーブして追加する。
+     *
+     * @param[in]   value            -> PushBack処理で追加する値。ムーブ後の状態は型に依存する
+     * @param[in]   callPlacementNew -> PushBack時に配置newを呼び出す場合はtrue（クラスインスタンス）
+     *                                   PushBack時に値を単純に代入する場合はfalse（プリミティブ、ポインタ）
+     */
+    void PushBack(T&& value, csmBool callPlacementNew = true);
+
     /**
      * @brief   コンテナの全要素を解放する
      *
+     * 内部バッファを持つ場合は、内部バッファを使う状態に戻る。
      */
     void Clear();
 
@@ -494,10 +529,32 @@ public:
      * @param[in]   c   ->  csmVector<T>のインスタンス
      */
     csmVector(const csmVector& c)
+        : _ptr(NULL)
+        , _size(0)
+        , _capacity(0)
+        , _inlineBuffer(NULL)
+        , _inlineCapacity(0)
     {
         Copy(c);
     }
 
+    /**
+     * @brief   ムーブコンストラクタ
+     *
+     * cの領域を引き継ぐ。cが内部バッファを使っている場合は要素をムーブする。
+     *
+     * @param[in]   c   ->  csmVector<T>のインスタンス。空になる
+     */
+    csmVector(csmVector&& c)
+        : _ptr(NULL)
+        , _size(0)
+        , _capacity(0)
+        , _inlineBuffer(NULL)
+        , _inlineCapacity(0)
+    {
+        Move(c);
+    }
+
     /**
      * @brief   コピーコンストラクタ
      *
@@ -514,36 +571,232 @@ public:
         return *this;
     }
 
+    /**
+     * @brief   ムーブ代入演算子
+     *
+     * @param[in]   c   ->  csmVector<T>のインスタンス。空になる
+     */
+    csmVector& operator=(csmVector&& c)
+    {
+        if (this != &c)
+        {
+            Clear();
+            Move(c);
+        }
+
+        return *this;
+    }
+
+protected:
+    /**
+     * @brief   内部バッファを使うコンストラクタ
+     *
+     * 派生クラスが持つ内部バッファを最初の領域として使う。
+     * 内部バッファに収まらなくなった場合はヒープに確保し直す。
+     *
+     * @param[in]   inlineBuffer    ->  内部バッファ
+     * @param[in]   inlineCapacity  ->  内部バッファに格納できる要素数
+     */
+    csmVector(T* inlineBuffer, csmInt32 inlineCapacity)
+        : _ptr(inlineBuffer)
+        , _size(0)
+        , _capacity(inlineCapacity)
+        , _inlineBuffer(inlineBuffer)
+        , _inlineCapacity(inlineCapacity)
+    { }
+
 private:
     static const csmInt32 s_defaultSize = 10;   ///< コンテナ初期化のデフォルトサイズ
 
     /**
      * @brief   csmVector<T>のコピー関数
      *
+     * 空のコンテナに対して呼ぶ。
+     *
      * @param[in]   c   ->  csmVector<T>のインスタンス
      */
     void Copy(const csmVector& c)
     {
+        // 内部バッファに収まる場合はヒープを確保しない
+        if (c._capacity > _capacity && (_inlineBuffer == NULL || c._size > _inlineCapacity))
+        {
+            _ptr = static_cast<T*>(CSM_MALLOC(c._capacity * sizeof(T)));
+            _capacity = c._capacity;
+        }
+
         _size = c._size;
-        _capacity = c._capacity;
 
-        if (c._capacity == 0)
+        if (csmIsTriviallyCopyable<T>::Value)
         {
-            _ptr = NULL;
+            if (_size > 0) memcpy(static_cast<void*>(_ptr), static_cast<const void*>(c._ptr), sizeof(T) * _size);
             return;
         }
 
-        _ptr = (T*)CSM_MALLOC(_capacity * sizeof(T));
-
         for (csmInt32 i = 0; i < _size; ++i)
         {
             CSM_PLACEMENT_NEW(&_ptr[i]) T(c._ptr[i]);
         }
     }
 
-    T* _ptr;                ///< コンテナの先頭アドレス（ポインタ）
-    csmInt32 _size;         ///< コンテナの要素数（サイズ）
-    csmInt32 _capacity;     ///< コンテナのキャパシティ
+    /**
+     * @brief   csmVector<T>のムーブ関数
+     *
+     * 空のコンテナに対して呼ぶ。
+     *
+     * @param[in]   c   ->  csmVector<T>のインスタンス。空になる
+     */
+    void Move(csmVector& c)
+    {
+        if (c._ptr == c._inlineBuffer)
+        {
+            // 内部バッファは引き継げないため、要素を移す
+            if (c._size > _capacity)
+            {
+                _ptr = static_cast<T*>(CSM_MALLOC(c._size * sizeof(T)));
+                _capacity = c._size;
+            }
+            Relocate(_ptr, c._ptr, c._size);
+            _size = c._size;
+            c._size = 0;
+            return;
+        }
+
+        _ptr = c._ptr;
+        _size = c._size;
+        _capacity = c._capacity;
+
+        c._ptr = c._inlineBuffer;
+        c._size = 0;
+        c._capacity = c._inlineCapacity;
+    }
+
+    /**
+     * @brief   要素を初期化されていない領域へ移す
+     *
+     * メモリのコピーで複製できる型はまとめてコピーし、それ以外はムーブして元の要素を破棄する。
+     *
+     * @param[in]   dst     ->  移動先の領域
+     * @param[in]   src     ->  移動元の要素
+     * @param[in]   count   ->  要素数
+     */
+    static void Relocate(T* dst, T* src, csmInt32 count)
+    {
+        if (csmIsTriviallyCopyable<T>::Value)
+        {
+            if (count > 0) memcpy(static_cast<void*>(dst), static_cast<void*>(src), sizeof(T) * count);
+            return;
+        }
+
+        for (csmInt32 i = 0; i < count; ++i)
+        {
+            CSM_PLACEMENT_NEW(&dst[i]) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+
+    /**
+     * @brief   領域を確保し直して要素を移す
+     *
+     * @param[in]   newCapacity ->  新たなキャパシティ
+     */
+    void Reallocate(csmInt32 newCapacity);
+
+    T* _ptr;                    ///< コンテナの先頭アドレス（ポインタ）
+    csmInt32 _size;             ///< コンテナの要素数（サイズ）
+    csmInt32 _capacity;         ///< コンテナのキャパシティ
+    T* _inlineBuffer;           ///< 派生クラスが持つ内部バッファ。持たない場合はNULL
+    csmInt32 _inlineCapacity;   ///< 内部バッファに格納できる要素数
+};
+
+/**
+ * @brief   内部バッファを持つベクター型<br>
+ *           N個までの要素はインスタンス内に格納し、ヒープを確保しない。
+ *           要素数が少ないことが分かっているコンテナに用いる。csmVector<T>として受け渡しできる。
+ */
+template<class T, csmInt32 N>
+class csmSmallVector : public csmVector<T>
+{
+public:
+    /**
+     * @brief   コンストラクタ
+     */
+    csmSmallVector() : csmVector<T>(reinterpret_cast<T*>(_inlineStorage), N) {}
+
+    /**
+     * @brief   コピーコンストラクタ
+     *
+     * @param[in]   c   ->  コピーするコンテナ
+     */
+    csmSmallVector(const csmSmallVector& c) : csmVector<T>(reinterpret_cast<T*>(_inlineStorage), N)
+    {
+        csmVector<T>::operator=(c);
+    }
+
+    /**
+     * @brief   引数付きコンストラクタ
+     *
+     * @param[in]   c   ->  コピーするコンテナ
+     */
+    csmSmallVector(const csmVector<T>& c) : csmVector<T>(reinterpret_cast<T*>(_inlineStorage), N)
+    {
+        csmVector<T>::operator=(c);
+    }
+
+    /**
+     * @brief   ムーブコンストラクタ
+     *
+     * @param[in]   c   ->  ムーブするコンテナ。空になる
+     */
+    csmSmallVector(csmSmallVector&& c) : csmVector<T>(reinterpret_cast<T*>(_inlineStorage), N)
+    {
+        csmVector<T>::operator=(std::move(c));
+    }
+
+    /**
+     * @brief   デストラクタ
+     *
+     * 内部バッファの要素は基底クラスのデストラクタより前に破棄する。
+     */
+    virtual ~csmSmallVector()
+    {
+        this->Clear();
+    }
+
+    /**
+     * @brief   代入演算子
+     *
+     * @param[in]   c   ->  コピーするコンテナ
+     */
+    csmSmallVector& operator=(const csmSmallVector& c)
+    {
+        csmVector<T>::operator=(c);
+        return *this;
+    }
+
+    /**
+     * @brief   代入演算子
+     *
+     * @param[in]   c   ->  コピーするコンテナ
+     */
+    csmSmallVector& operator=(const csmVector<T>& c)
+    {
+        csmVector<T>::operator=(c);
+        return *this;
+    }
+
+    /**
+     * @brief   ムーブ代入演算子
+     *
+     * @param[in]   c   ->  ムーブするコンテナ。空になる
+     */
+    csmSmallVector& operator=(csmSmallVector&& c)
+    {
+        csmVector<T>::operator=(std::move(c));
+        return *this;
+    }
+
+private:
+    alignas(T) csmByte _inlineStorage[sizeof(T) * N];   ///< 内部バッファ
 };
 
 //========================テンプレートの定義==============================
@@ -553,10 +806,14 @@ csmVector<T>::csmVector()
     : _ptr(NULL)
     , _size(0)
     , _capacity(0)
+    , _inlineBuffer(NULL)
+    , _inlineCapacity(0)
 { }
 
 template<class T>
 csmVector<T>::csmVector(csmInt32 initialCapacity, csmBool zeroClear)
+    : _inlineBuffer(NULL)
+    , _inlineCapacity(0)
 {
     if (initialCapacity < 1)
     {
@@ -605,38 +862,51 @@ void csmVector<T>::PushBack(const T& value, csmBool callPlacementNew)
     }
 }
 
+template<class T>
+void csmVector<T>::PushBack(T&& value, csmBool callPlacementNew)
+{
+    if (_size >= _capacity)
+    {
+        PrepareCapacity(_capacity == 0 ? s_defaultSize : _capacity * 2);
+    }
+
+    // placement new 指定のアドレスに、実体を生成する
+    if (callPlacementNew)
+    {
+        CSM_PLACEMENT_NEW(&_ptr[_size++]) T(std::move(value));
+    }
+    else
+    {
+        _ptr[_size++] = std::move(value);
+    }
+}
+
 template<class T>
 void csmVector<T>::PrepareCapacity(csmInt32 newSize)
 {
     if (newSize > _capacity)
     {
-        if (_capacity == 0)
-        {
-            _ptr = static_cast<T *>(CSM_MALLOC(sizeof(T) * newSize));
-
-            CSM_ASSERT(_ptr != NULL);
+        Reallocate(newSize);
+    }
+}
 
-            _capacity = newSize;
-        }
-        else
-        {
-            csmInt32 tmp_capacity = newSize;
-            T* tmp = static_cast<T *>(CSM_MALLOC(sizeof(T) * tmp_capacity));
-            csmInt32 tmp_size = _size;
+template<class T>
+void csmVector<T>::Reallocate(csmInt32 newCapacity)
+{
+    T* tmp = static_cast<T *>(CSM_MALLOC(sizeof(T) * newCapacity));
 
-            CSM_ASSERT(tmp != NULL);
+    CSM_ASSERT(tmp != NULL);
 
-            for (csmInt32 i = 0; i < _size; i++)
-            {
-                CSM_PLACEMENT_NEW(&tmp[i]) T(_ptr[i]);
-            }
-            Clear();
+    // 要素をコピーせずに移す
+    Relocate(tmp, _ptr, _size);
 
-            _ptr = tmp;
-            _capacity = newSize;
-            _size = tmp_size;
-        }
+    if (_ptr != _inlineBuffer)
+    {
+        CSM_FREE(_ptr);
     }
+
+    _ptr = tmp;
+    _capacity = newCapacity;
 }
 
 template<class T>
@@ -649,12 +919,15 @@ void csmVector<T>::Clear()
             _ptr[i].~T();
         }
 
-        CSM_FREE(_ptr);
+        if (_ptr != _inlineBuffer)
+        {
+            CSM_FREE(_ptr);
+        }
     }
 
-    _ptr = NULL;
+    _ptr = _inlineBuffer;
     _size = 0;
-    _capacity = 0;
+    _capacity = _inlineCapacity;
 }
 
 template<class T>
@@ -750,7 +1023,7 @@ void csmVector<T>::Insert(iterator position, iterator begin, iterator end, csmBo
     {
         for (csmInt32 i = src_si; i < src_ei; i++, dst_si++)
         {
-            CSM_PLACEMENT_NEW(&_ptr[i]) T(begin._vector->_ptr[i]);
+            CSM_PLACEMENT_NEW(&_ptr[dst_si]) T(begin._vector->_ptr[i]);
         }
     }
     else
@@ -0,0 +1,110 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismArena.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
+
+namespace {
+
+const csmSizeInt MaximumGrowthChunkSize = 1024 * 1024;
+
+/// Rounds the size up to the arena alignment.
+csmSizeInt AlignSize(csmSizeInt size)
+{
+    return (size + CubismArena::Alignment - 1) & ~(CubismArena::Alignment - 1);
+}
+
+}
+
+CubismArena::CubismArena(csmSizeInt chunkSize)
+    : _chunks(NULL)
+    , _finalizers(NULL)
+    , _nextChunkSize(AlignSize(chunkSize > 0 ? chunkSize : DefaultChunkSize))
+    , _reservedSize(0)
+{ }
+
+CubismArena::~CubismArena()
+{
+    Clear();
+}
+
+void* CubismArena::Allocate(csmSizeInt size)
+{
+    size = AlignSize(size);
+
+    if (_chunks == NULL || _chunks->Capacity - _chunks->Used < size)
+    {
+        AddChunk(size);
+    }
+
+    csmByte* data = reinterpret_cast<csmByte*>(_chunks) + AlignSize(sizeof(Chunk));
+    void* ret = data + _chunks->Used;
+    _chunks->Used += size;
+
+    return ret;
+}
+
+void* CubismArena::Allocate(csmSizeInt size, Finalizer finalizer)
+{
+    csmByte* record = static_cast<csmByte*>(Allocate(AlignSize(sizeof(FinalizerRecord)) + size));
+
+    FinalizerRecord* finalizerRecord = reinterpret_cast<FinalizerRecord*>(record);
+    finalizerRecord->Next = _finalizers;
+    finalizerRecord->Finalize = finalizer;
+    _finalizers = finalizerRecord;
+
+    return record + AlignSize(sizeof(FinalizerRecord));
+}
+
+void CubismArena::Clear()
+{
+    // 登録と逆の順番で終了処理を呼ぶ
+    // Finalize in reverse order of registration.
+    while (_finalizers != NULL)
+    {
+        FinalizerRecord* record = _finalizers;
+        _finalizers = record->Next;
+        record->Finalize(reinterpret_cast<csmByte*>(record) + AlignSize(sizeof(FinalizerRecord)));
+    }
+
+    while (_chunks != NULL)
+    {
+        Chunk* chunk = _chunks;
+        _chunks = chunk->Next;
+        CSM_FREE(chunk);
+    }
+
+    _reservedSize = 0;
+}
+
+void CubismArena::AddChunk(csmSizeInt minimumCapacity)
+{
+    csmSizeInt capacity = _nextChunkSize;
+    if (capacity < minimumCapacity)
+    {
+        capacity = minimumCapacity;
+    }
+
+    Chunk* chunk = static_cast<Chunk*>(CSM_MALLOC(AlignSize(sizeof(Chunk)) + capacity));
+    chunk->Next = _chunks;
+    chunk->Capacity = capacity;
+    chunk->Used = 0;
+    _chunks = chunk;
+    _reservedSize += capacity;
+
+    // チャンクの数が増えすぎないように、次に確保するサイズを倍にする
+    // Double the next chunk so that large documents need few chunks.
+    if (_nextChunkSize < MaximumGrowthChunkSize)
+    {
+        _nextChunkSize *= 2;
+    }
+}
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
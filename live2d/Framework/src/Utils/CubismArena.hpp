@@ -0,0 +1,121 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
+
+/**
+ * @brief   まとめて解放するメモリ領域
+ *
+ * チャンク単位で確保したメモリから順に切り出して割り当てる。
+ * 個別の解放はできず、Clear()またはデストラクタで全ての領域をまとめて解放する。
+ * 終了処理を登録した領域は、解放の前に登録と逆の順番で終了処理を呼ぶ。
+ */
+class CubismArena
+{
+public:
+    /**
+     * @brief   終了処理
+     *
+     * @param[in]   object  ->  終了処理を行う領域
+     */
+    typedef void (*Finalizer)(void* object);
+
+    static const csmSizeInt DefaultChunkSize = 4096;   ///< チャンクの既定のサイズ
+    static const csmSizeInt Alignment = 16;            ///< 割り当てる領域のアライメント
+
+    /**
+     * @brief   コンストラクタ
+     *
+     * @param[in]   chunkSize   ->  最初に確保するチャンクのサイズ
+     */
+    CubismArena(csmSizeInt chunkSize = DefaultChunkSize);
+
+    /**
+     * @brief   デストラクタ
+     *
+     * 全ての領域を解放する。
+     */
+    ~CubismArena();
+
+    /**
+     * @brief   領域の割り当て
+     *
+     * @param[in]   size    ->  割り当てるサイズ
+     * @return      割り当てた領域。初期化されていない
+     */
+    void* Allocate(csmSizeInt size);
+
+    /**
+     * @brief   終了処理付きの領域の割り当て
+     *
+     * 解放時にfinalizerを呼ぶ領域を割り当てる。
+     * 領域にオブジェクトをplacement newで生成し、デストラクタを呼ぶ関数を渡す用途を想定している。
+     *
+     * @param[in]   size        ->  割り当てるサイズ
+     * @param[in]   finalizer   ->  解放時に呼ぶ終了処理
+     * @return      割り当てた領域。初期化されていない
+     */
+    void* Allocate(csmSizeInt size, Finalizer finalizer);
+
+    /**
+     * @brief   全ての領域の解放
+     *
+     * 登録された終了処理を呼び、確保した全てのチャンクを解放する。
+     */
+    void Clear();
+
+    /**
+     * @brief   確保しているチャンクのサイズの合計の取得
+     *
+     * @return  確保しているチャンクのサイズの合計
+     */
+    csmSizeInt GetReservedSize() const { return _reservedSize; }
+
+private:
+    /**
+     * @brief   チャンクのヘッダ。直後にデータ領域が続く
+     */
+    struct Chunk
+    {
+        Chunk* Next;            ///< 前に確保したチャンク
+        csmSizeInt Capacity;    ///< データ領域のサイズ
+        csmSizeInt Used;        ///< 割り当て済みのサイズ
+    };
+
+    /**
+     * @brief   終了処理の記録。直後に終了処理を行う領域が続く
+     */
+    struct FinalizerRecord
+    {
+        FinalizerRecord* Next;  ///< 前に登録した終了処理
+        Finalizer Finalize;     ///< 終了処理
+    };
+
+    // Prevention of copy Constructor
+    CubismArena(const CubismArena&);
+    CubismArena& operator=(const CubismArena&);
+
+    /**
+     * @brief   チャンクの追加
+     *
+     * @param[in]   minimumCapacity ->  データ領域の最小のサイズ
+     */
+    void AddChunk(csmSizeInt minimumCapacity);
+
+    Chunk* _chunks;                     ///< 最後に確保したチャンク
+    FinalizerRecord* _finalizers;       ///< 最後に登録した終了処理
+    csmSizeInt _nextChunkSize;          ///< 次に確保するチャンクのサイズ
+    csmSizeInt _reservedSize;           ///< 確保しているチャンクのサイズの合計
+};
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
@@ -7,14 +7,130 @@
 
 #include "CubismJson.hpp"
 #include <stdlib.h>
+#include <string.h>
 #include "Type/csmString.hpp"
 #include "CubismDebug.hpp"
-
-using namespace std; // for strtof
+#include "CubismString.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
 
+namespace {
+
+typedef csmUint64 ScanWord;
+
+const csmInt32 ScanWordSize = sizeof(ScanWord);
+const ScanWord ScanLowBits = 0x0101010101010101ULL;
+const ScanWord ScanHighBits = 0x8080808080808080ULL;
+
+/// Returns true when the first byte in memory is the least significant byte of a word.
+csmBool IsLittleEndian()
+{
+    const csmUint16 probe = 1;
+    csmUint8 firstByte;
+    memcpy(&firstByte, &probe, sizeof(firstByte));
+    return firstByte == 1;
+}
+
+const csmBool IsScanWordLittleEndian = IsLittleEndian();
+
+/// Loads a word of bytes without alignment requirements.
+ScanWord LoadScanWord(const csmChar* p)
+{
+    ScanWord word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+/// Sets the high bit of each byte that equals the character and clears every other bit.
+ScanWord MatchBytes(ScanWord word, csmChar c)
+{
+    const ScanWord x = word ^ (ScanLowBits * static_cast<csmUint8>(c));
+    return ~(((x & ~ScanHighBits) + ~ScanHighBits) | x) & ScanHighBits;
+}
+
+/// Counts the bytes whose high bit is set in a result of MatchBytes.
+csmInt32 CountMatchedBytes(ScanWord matches)
+{
+    return static_cast<csmInt32>(((matches >> 7) * ScanLowBits) >> 56);
+}
+
+/// Returns the high bits of the bytes in memory before the first matched byte.
+ScanWord BytesBeforeFirstMatch(ScanWord matches)
+{
+    return ((matches & (0 - matches)) - 1) & ScanHighBits;
+}
+
+/// Skips spaces, tabs, CR and LF a word at a time and counts the line feeds.
+csmInt32 SkipWhitespace(const csmChar* buffer, csmInt32 length, csmInt32 i, csmInt32* lineCount)
+{
+    if (i < length && buffer[i] != ' ' && buffer[i] != '\t' && buffer[i] != '\r' && buffer[i] != '\n')
+    {
+        return i;
+    }
+
+    if (IsScanWordLittleEndian)
+    {
+        while (i + ScanWordSize <= length)
+        {
+            const ScanWord word = LoadScanWord(buffer + i);
+            const ScanWord lineFeeds = MatchBytes(word, '\n');
+            const ScanWord others = ~(MatchBytes(word, ' ') | MatchBytes(word, '\t') | MatchBytes(word, '\r') | lineFeeds) & ScanHighBits;
+
+            if (others != 0)
+            {
+                const ScanWord skipped = BytesBeforeFirstMatch(others);
+                *lineCount += CountMatchedBytes(lineFeeds & skipped);
+                return i + CountMatchedBytes(skipped);
+            }
+
+            *lineCount += CountMatchedBytes(lineFeeds);
+            i += ScanWordSize;
+        }
+    }
+
+    for (; i < length; i++)
+    {
+        const csmChar c = buffer[i];
+        if (c == '\n')
+        {
+            ++*lineCount;
+        }
+        else if (c != ' ' && c != '\t' && c != '\r')
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+/// Finds the first quote or backslash a word at a time.
+csmInt32 FindStringDelimiter(const csmChar* buffer, csmInt32 length, csmInt32 i)
+{
+    if (IsScanWordLittleEndian)
+    {
+        while (i + ScanWordSize <= length)
+        {
+            const ScanWord word = LoadScanWord(buffer + i);
+            const ScanWord delimiters = MatchBytes(word, '\"') | MatchBytes(word, '\\');
+
+            if (delimiters != 0)
+            {
+                return i + CountMatchedBytes(BytesBeforeFirstMatch(delimiters));
+            }
+
+            i += ScanWordSize;
+        }
+    }
+
+    for (; i < length && buffer[i] != '\"' && buffer[i] != '\\'; i++)
+    {
+    }
+    return i;
+}
+
+}
+
 //StaticInitializeNotForClientCall()で初期化する
 Boolean* Boolean::TrueValue = NULL;
 Boolean* Boolean::FalseValue = NULL;
@@ -64,11 +180,7 @@ CubismJson::CubismJson(const csmByte* buffer, csmInt32 length)
 
 CubismJson::~CubismJson()
 {
-    if (_root && !_root->IsStatic())
-    {
-        CSM_DELETE(_root);
-    }
-
+    // 要素はアリーナと共に解放される
     _root = NULL;
 }
 
@@ -103,33 +215,42 @@ Value& CubismJson::GetRoot() const
 
 csmBool CubismJson::ParseBytes(const csmByte* buffer, csmInt32 size)
 {
+    // 文字列をその場で終端して参照するため、ソースをアリーナにコピーしてパースする
+    // Parse a copy in the arena so that strings can be terminated in place and referenced.
+    csmChar* source = static_cast<csmChar*>(_arena.Allocate(size + 1));
+    memcpy(source, buffer, size);
+    source[size] = '\0';
+
     csmInt32 endPos;
-    _root = ParseValue(reinterpret_cast<const csmChar*>(buffer), size, 0, &endPos);
+    _root = ParseValue(source, size, 0, &endPos);
+
+    _valueStack.Clear();
+    _entryStack.Clear();
 
     if (_error)
     {
 #if defined(CSM_TARGET_WIN_GL) || defined(_MSC_VER)
         csmChar strbuf[256] = {'\0'};
         _snprintf_s(strbuf, 256, 256, "Json parse error : @line %d\n", (_lineCount + 1));
-        _root = CSM_NEW String(strbuf);
+        _root = CSM_PLACEMENT_NEW(AllocateValue<String>()) String(strbuf);
 #else
         csmChar strbuf[256] = { '\0' };
         snprintf(strbuf, 256, "Json parse error : @line %d\n", (_lineCount + 1));
-        _root = CSM_NEW String(strbuf);
+        _root = CSM_PLACEMENT_NEW(AllocateValue<String>()) String(strbuf);
 #endif
         CubismLogInfo("%s", _root->GetRawString());
         return false;
     }
     else if (_root == NULL)
     {
-        _root = CSM_NEW Error(_error, false); //rootは開放されるのでエラーオブジェクトを別途作る
+        _root = CSM_PLACEMENT_NEW(AllocateValue<Error>()) Error(_error, false); //rootは開放されるのでエラーオブジェクトを別途作る
         return false;
     }
     return true;
 }
 
 
-csmString CubismJson::ParseString(const csmChar* string, csmInt32 length, csmInt32 begin, csmInt32* outEndPos)
+csmChar* CubismJson::ParseString(csmChar* string, csmInt32 length, csmInt32 begin, csmInt32* outEndPos, csmInt32* outLength)
 {
     if (_error)
     {
@@ -144,50 +265,58 @@ csmString CubismJson::ParseString(const csmChar* string, csmInt32 length, csmInt
 
     csmInt32 i = begin;
     csmChar c, c2;
-    csmString ret;
-    csmInt32 buf_start = begin; //sbufに登録されていない文字の開始位置
+    csmInt32 written = begin; //展開した文字の書き込み位置。常に読み込み位置以前になる
 
     for (; i < length; i++)
     {
+        // 終端かエスケープまでをまとめて読み進める
+        const csmInt32 delimiter = FindStringDelimiter(string, length, i);
+        if (written != i)
+        {
+            memmove(string + written, string + i, delimiter - i);
+        }
+        written += delimiter - i;
+        i = delimiter;
+
+        if (i >= length)
+        {
+            break;
+        }
+
         c = static_cast<csmChar>(string[i] & 0xFF);
 
         switch (c)
         {
         case '\"': {//終端の”, エスケープ文字は別に処理されるのでここにはこない
             *outEndPos = i + 1; // ”の次の文字
-            ret.Append(static_cast<const csmChar*>(string + buf_start), (i - buf_start));
-            return ret;
+            *outLength = written - begin;
+            string[written] = '\0';
+            return string + begin;
         }
         case '\\': {//エスケープの場合
             i++; //２文字をセットで扱う
 
-            if (i - 1 > buf_start)
-            {
-                ret.Append(static_cast<const csmChar*>(string + buf_start), (i - buf_start - 1)); //前の文字までを登録する
-            }
-            buf_start = i + 1; //エスケープ（２文字）の次の文字から
-
             if (i < length)
             {
                 c2 = static_cast<csmChar>(string[i] & 0xFF);
                 switch (c2)
                 {
-                case '\\': ret.Append(1, '\\');
+                case '\\': string[written++] = '\\';
                     break;
-                case '\"': ret.Append(1, '\"');
+                case '\"': string[written++] = '\"';
                     break;
-                case '/': ret.Append(1, '/');
+                case '/': string[written++] = '/';
                     break;
 
-                case 'b': ret.Append(1, '\b');
+                case 'b': string[written++] = '\b';
                     break;
-                case 'f': ret.Append(1, '\f');
+                case 'f': string[written++] = '\f';
                     break;
-                case 'n': ret.Append(1, '\n');
+                case 'n': string[written++] = '\n';
                     break;
-                case 'r': ret.Append(1, '\r');
+                case 'r': string[written++] = '\r';
                     break;
-                case 't': ret.Append(1, '\t');
+                case 't': string[written++] = '\t';
                     break;
                 case 'u':
                     _error = "parse string/unicode escape not supported";
@@ -211,7 +340,7 @@ csmString CubismJson::ParseString(const csmChar* string, csmInt32 length, csmInt
 }
 
 
-Value* CubismJson::ParseObject(const csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos)
+Value* CubismJson::ParseObject(csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos)
 {
     if (_error)
     {
@@ -224,10 +353,11 @@ Value* CubismJson::ParseObject(const csmChar* buffer, csmInt32 length, csmInt32
         return NULL;
     }
 
-    Map* ret = CSM_NEW Map();
+    // 要素は_entryStackに積み、閉じカッコでマップにまとめる
+    const csmInt32 entryBegin = static_cast<csmInt32>(_entryStack.GetSize());
 
     //key : value ,
-    csmString key;
+    MapEntry entry;
     csmInt32 i = begin;
     csmChar c;
     csmInt32 local_ret_endpos2[1];
@@ -238,23 +368,26 @@ Value* CubismJson::ParseObject(const csmChar* buffer, csmInt32 length, csmInt32
     {
         for (; i < length; i++)
         {
+            i = SkipWhitespace(buffer, length, i, &_lineCount);
+            if (i >= length) break;
+
             c = static_cast<csmChar>(buffer[i] & 0xFF);
 
             switch (c)
             {
             case '\"':
-                key = ParseString(buffer, length, i + 1, local_ret_endpos2);
+                entry.Key = ParseString(buffer, length, i + 1, local_ret_endpos2, &entry.KeyLength);
                 if (_error) return NULL;
+                entry.KeyHash = Map::HashKey(entry.Key, entry.KeyLength);
                 i = local_ret_endpos2[0];
                 ok = true;
                 goto BREAK_LOOP1; //-- loopから出る
             case '}': //閉じカッコ
                 *outEndPos = i + 1;
-                return ret; //空
+                return CreateMap(entryBegin); //空
             case ':':
                 _error = "illegal ':' position";
                 break;
-            case '\n': _lineCount++;
             default: break; //スキップする文字
             }
         }
@@ -270,6 +403,9 @@ Value* CubismJson::ParseObject(const csmChar* buffer, csmInt32 length, csmInt32
         // : をチェック
         for (; i < length; i++)
         {
+            i = SkipWhitespace(buffer, length, i, &_lineCount);
+            if (i >= length) break;
+
             c = static_cast<csmChar>(buffer[i] & 0xFF);
 
             switch (c)
@@ -281,7 +417,6 @@ Value* CubismJson::ParseObject(const csmChar* buffer, csmInt32 length, csmInt32
             case '}':
                 _error = "illegal '}' position";
                 break;
-            case '\n': _lineCount++;
                 //case ' ': case '\t': case '\r':
             default: break; //スキップする文字
             }
@@ -301,11 +436,14 @@ Value* CubismJson::ParseObject(const csmChar* buffer, csmInt32 length, csmInt32
             return NULL;
         }
         i = local_ret_endpos2[0];
-        // ret.put( key , value ) ;
-        ret->Put(key, value);
+        entry.Element = value;
+        _entryStack.PushBack(entry, false);
 
         for (; i < length; i++)
         {
+            i = SkipWhitespace(buffer, length, i, &_lineCount);
+            if (i >= length) break;
+
             c = static_cast<csmChar>(buffer[i] & 0xFF);
 
             switch (c)
@@ -314,8 +452,7 @@ Value* CubismJson::ParseObject(const csmChar* buffer, csmInt32 length, csmInt32
                 goto BREAK_LOOP3;
             case '}':
                 *outEndPos = i + 1;
-                return ret; // << [] 正常終了 >>
-            case '\n': _lineCount++;
+                return CreateMap(entryBegin); // << [] 正常終了 >>
                 //case ' ': case '\t': case '\r':
             default: break; //スキップ
             }
@@ -329,7 +466,7 @@ Value* CubismJson::ParseObject(const csmChar* buffer, csmInt32 length, csmInt32
 }
 
 
-Value* CubismJson::ParseArray(const csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos)
+Value* CubismJson::ParseArray(csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos)
 {
     if (_error)
     {
@@ -342,7 +479,8 @@ Value* CubismJson::ParseArray(const csmChar* buffer, csmInt32 length, csmInt32 b
         return NULL;
     }
 
-    Array* ret = CSM_NEW Array();
+    // 要素は_valueStackに積み、閉じカッコで配列にまとめる
+    const csmInt32 valueBegin = static_cast<csmInt32>(_valueStack.GetSize());
 
     //key : value ,
     csmInt32 i = begin;
@@ -361,13 +499,16 @@ Value* CubismJson::ParseArray(const csmChar* buffer, csmInt32 length, csmInt32 b
         i = local_ret_endpos2[0];
         if (value)
         {
-            ret->Add(value);
+            _valueStack.PushBack(value, false);
         }
 
         //FOR_LOOP3:
         //bool breakflag = false;
         for (; i < length; i++)
         {
+            i = SkipWhitespace(buffer, length, i, &_lineCount);
+            if (i >= length) break;
+
             c = static_cast<csmChar>(buffer[i] & 0xFF);
 
             switch (c)
@@ -378,8 +519,7 @@ Value* CubismJson::ParseArray(const csmChar* buffer, csmInt32 length, csmInt32 b
                 goto BREAK_LOOP3;
             case ']':
                 *outEndPos = i + 1;
-                return ret; //終了
-            case '\n': ++_lineCount;
+                return CreateArray(valueBegin); //終了
                 //case ' ': case '\t': case '\r':
             default: break; //スキップ
             }
@@ -388,13 +528,12 @@ Value* CubismJson::ParseArray(const csmChar* buffer, csmInt32 length, csmInt32 b
         ; //dummy
     }
 
-    CSM_DELETE(ret);
     _error = "illegal end of parseObject";
     return NULL;
 }
 
 
-Value* CubismJson::ParseValue(const csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos)
+Value* CubismJson::ParseValue(csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos)
 {
     if (_error)
     {
@@ -410,10 +549,12 @@ Value* CubismJson::ParseValue(const csmChar* buffer, csmInt32 length, csmInt32 b
     Value* o = NULL;
     csmInt32 i = begin;
     csmFloat32 f;
-    csmString s1; //デバッグ用に使っている
 
     for (; i < length; i++)
     {
+        i = SkipWhitespace(buffer, length, i, &_lineCount);
+        if (i >= length) break;
+
         csmChar c = static_cast<csmChar>(buffer[i] & 0xFF);
 
         switch (c)
@@ -422,13 +563,16 @@ Value* CubismJson::ParseValue(const csmChar* buffer, csmInt32 length, csmInt32 b
         case '0': case '1': case '2': case '3': case '4':
         case '5': case '6': case '7': case '8': case '9':
             {
-                char* ret_ptr;
-                f = strtof(const_cast<csmChar*>(buffer + i), &ret_ptr);
-                *outEndPos = static_cast<csmInt32>(ret_ptr - buffer);
-                return CSM_NEW Float(f);
+                f = CubismString::ParseFloat(buffer, length, i, outEndPos);
+                return CSM_PLACEMENT_NEW(AllocateValue<Float>()) Float(f);
             }
         case '\"':
-            return CSM_NEW String(ParseString(buffer, length, i + 1, outEndPos)); //\"の次の文字から
+            {
+                csmInt32 stringLength;
+                const csmChar* string = ParseString(buffer, length, i + 1, outEndPos, &stringLength); //\"の次の文字から
+                if (_error) return NULL;
+                return CSM_PLACEMENT_NEW(AllocateValue<String>()) String(string, stringLength);
+            }
         case '[':
             o = ParseArray(buffer, length, i + 1, outEndPos);
             return o;
@@ -438,7 +582,7 @@ Value* CubismJson::ParseValue(const csmChar* buffer, csmInt32 length, csmInt32 b
         case 'n': //null以外にない
             if (i + 3 < length)
             {
-                o = CSM_NEW NullValue(); //開放できるようにする
+                o = Value::NullValue;
                 *outEndPos = i + 4;
             }
             else _error = "parse null";
@@ -465,7 +609,6 @@ Value* CubismJson::ParseValue(const csmChar* buffer, csmInt32 length, csmInt32 b
         case ']': //不正な}だがスキップする。配列の最後に不要な , があると思われる
             *outEndPos = i; //同じ文字を再処理
             return NULL;
-        case '\n': _lineCount++;
         case ' ': case '\t': case '\r':
         default: //スキップ
             break;
@@ -477,17 +620,286 @@ Value* CubismJson::ParseValue(const csmChar* buffer, csmInt32 length, csmInt32 b
 }
 
 
+Map* CubismJson::CreateMap(csmInt32 entryBegin)
+{
+    const csmInt32 entryEnd = static_cast<csmInt32>(_entryStack.GetSize());
+    const csmInt32 count = entryEnd - entryBegin;
+
+    // 索引の使用率が半分以下になるように2のべき乗で確保する
+    csmInt32 slotCount = 2;
+    while (slotCount < count * 2)
+    {
+        slotCount *= 2;
+    }
+    const csmUint32 slotMask = static_cast<csmUint32>(slotCount - 1);
+
+    MapEntry* entries = static_cast<MapEntry*>(_arena.Allocate(sizeof(MapEntry) * count));
+    csmInt32* slots = static_cast<csmInt32*>(_arena.Allocate(sizeof(csmInt32) * slotCount));
+    for (csmInt32 i = 0; i < slotCount; ++i)
+    {
+        slots[i] = -1;
+    }
+
+    csmInt32 entryCount = 0;
+    for (csmInt32 i = entryBegin; i < entryEnd; ++i)
+    {
+        const MapEntry& entry = _entryStack[i];
+
+        for (csmUint32 slot = entry.KeyHash & slotMask; ; slot = (slot + 1) & slotMask)
+        {
+            const csmInt32 index = slots[slot];
+
+            if (index < 0)
+            {
+                slots[slot] = entryCount;
+                entries[entryCount++] = entry;
+                break;
+            }
+
+            MapEntry& found = entries[index];
+            if (found.KeyHash == entry.KeyHash && found.KeyLength == entry.KeyLength
+                && memcmp(found.Key, entry.Key, entry.KeyLength) == 0)
+            {
+                // 同じキーは最初の位置のまま値を上書きする
+                found.Element = entry.Element;
+                break;
+            }
+        }
+    }
+
+    _entryStack.UpdateSize(entryBegin);
+
+    return CSM_PLACEMENT_NEW(AllocateValue<Map>()) Map(&_arena, entries, entryCount, slots, slotMask);
+}
+
+
+Array* CubismJson::CreateArray(csmInt32 valueBegin)
+{
+    const csmInt32 valueEnd = static_cast<csmInt32>(_valueStack.GetSize());
+    const csmInt32 size = valueEnd - valueBegin;
+
+    Value** elements = static_cast<Value**>(_arena.Allocate(sizeof(Value*) * size));
+    for (csmInt32 i = 0; i < size; ++i)
+    {
+        elements[i] = _valueStack[valueBegin + i];
+    }
+
+    _valueStack.UpdateSize(valueBegin);
+
+    return CSM_PLACEMENT_NEW(AllocateValue<Array>()) Array(&_arena, elements, size);
+}
+
+
+csmUint32 Map::HashKey(const csmChar* key, csmInt32 length)
+{
+    // FNV-1a
+    csmUint32 hash = 2166136261u;
+    for (csmInt32 i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<csmUint8>(key[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+Value& Map::Find(const csmChar* key, csmInt32 length) const
+{
+    const csmUint32 hash = HashKey(key, length);
+
+    // 索引には必ず空きがあるので、見つからなければ空きで止まる
+    for (csmUint32 slot = hash & _slotMask; ; slot = (slot + 1) & _slotMask)
+    {
+        const csmInt32 index = _slots[slot];
+
+        if (index < 0)
+        {
+            return *Value::NullValue;
+        }
+
+        const MapEntry& entry = _entries[index];
+        if (entry.KeyHash == hash && entry.KeyLength == length && memcmp(entry.Key, key, length) == 0)
+        {
+            if (entry.Element == NULL)
+            {
+                return *Value::NullValue;
+            }
+            return *entry.Element;
+        }
+    }
+}
+
+
+csmMap<csmString, Value*>* Map::GetMap(csmMap<csmString, Value*>* /*defaultValue*/)
+{
+    if (!_map)
+    {
+        _map = CSM_NEW csmMap<csmString, Value*>();
+        for (csmInt32 i = 0; i < _entryCount; ++i)
+        {
+            (*_map)[csmString(_entries[i].Key, _entries[i].KeyLength)] = _entries[i].Element;
+        }
+    }
+    return _map;
+}
+
+
+csmVector<csmString>& Map::GetKeys()
+{
+    if (!_keys)
+    {
+        _keys = CSM_NEW csmVector<csmString>();
+        for (csmInt32 i = 0; i < _entryCount; ++i)
+        {
+            _keys->PushBack(csmString(_entries[i].Key, _entries[i].KeyLength), true);
+        }
+    }
+    return *_keys;
+}
+
+
+/**
+ * @brief   PutやAddで追加された要素を、コンテナと共に削除するリストに加える
+ *
+ * @param[in,out]   ownedValues ->  削除する要素のリスト。NULLなら作成する
+ * @param[in]       v           ->  追加された要素
+ */
+static void AddOwnedValue(csmVector<Value*>*& ownedValues, Value* v)
+{
+    if (v == NULL || v->IsStatic())
+    {
+        return;
+    }
+
+    if (!ownedValues)
+    {
+        ownedValues = CSM_NEW csmVector<Value*>();
+    }
+    ownedValues->PushBack(v, false);
+}
+
+
+void Map::Put(const csmString& key, Value* v)
+{
+    const csmChar* keyString = key.GetRawString();
+    const csmInt32 length = key.GetLength();
+    const csmUint32 hash = HashKey(keyString, length);
+
+    if (_map)
+    {
+        (*_map)[key] = v;
+    }
+
+    // 同じキーがあれば値を置き換える
+    for (csmUint32 slot = hash & _slotMask; ; slot = (slot + 1) & _slotMask)
+    {
+        const csmInt32 index = _slots[slot];
+
+        if (index < 0)
+        {
+            break;
+        }
+
+        MapEntry& entry = _entries[index];
+        if (entry.KeyHash == hash && entry.KeyLength == length && memcmp(entry.Key, keyString, length) == 0)
+        {
+            if (entry.Element != v)
+            {
+                AddOwnedValue(_addedValues, v);
+                entry.Element = v;
+            }
+            return;
+        }
+    }
+
+    AddOwnedValue(_addedValues, v);
+
+    if (_entryCount >= _entryCapacity)
+    {
+        const csmInt32 capacity = (_entryCapacity > 0) ? _entryCapacity * 2 : 4;
+        MapEntry* entries = static_cast<MapEntry*>(_arena->Allocate(sizeof(MapEntry) * capacity));
+        for (csmInt32 i = 0; i < _entryCount; ++i)
+        {
+            entries[i] = _entries[i];
+        }
+        _entries = entries;
+        _entryCapacity = capacity;
+    }
+
+    // 索引の使用率が半分を超える場合は広げる
+    const csmInt32 slotCount = static_cast<csmInt32>(_slotMask + 1);
+    if ((_entryCount + 1) * 2 > slotCount)
+    {
+        Rehash(slotCount * 2);
+    }
+
+    csmChar* keyCopy = static_cast<csmChar*>(_arena->Allocate(length + 1));
+    memcpy(keyCopy, keyString, length);
+    keyCopy[length] = '\0';
+
+    MapEntry& entry = _entries[_entryCount];
+    entry.Key = keyCopy;
+    entry.KeyLength = length;
+    entry.KeyHash = hash;
+    entry.Element = v;
+
+    for (csmUint32 slot = hash & _slotMask; ; slot = (slot + 1) & _slotMask)
+    {
+        if (_slots[slot] < 0)
+        {
+            _slots[slot] = _entryCount;
+            break;
+        }
+    }
+
+    ++_entryCount;
+
+    if (_keys)
+    {
+        _keys->PushBack(key, true);
+    }
+}
+
+
+void Map::Rehash(csmInt32 slotCount)
+{
+    _slots = static_cast<csmInt32*>(_arena->Allocate(sizeof(csmInt32) * slotCount));
+    _slotMask = static_cast<csmUint32>(slotCount - 1);
+
+    for (csmInt32 i = 0; i < slotCount; ++i)
+    {
+        _slots[i] = -1;
+    }
+
+    for (csmInt32 i = 0; i < _entryCount; ++i)
+    {
+        for (csmUint32 slot = _entries[i].KeyHash & _slotMask; ; slot = (slot + 1) & _slotMask)
+        {
+            if (_slots[slot] < 0)
+            {
+                _slots[slot] = i;
+                break;
+            }
+        }
+    }
+}
+
+
 Map::~Map()
 {
-    csmMap<csmString, Value*>::const_iterator ite = _map.Begin();
-    while (ite != _map.End())
+    // パースした要素はCubismJsonのアリーナと共に解放される
+    if (_addedValues)
     {
-        Value* v = (*ite).Second;
-        if (v && !v->IsStatic())
+        for (csmUint32 i = 0; i < _addedValues->GetSize(); ++i)
         {
-            CSM_DELETE(v);
+            CSM_DELETE((*_addedValues)[i]);
         }
-        ++ite;
+        CSM_DELETE(_addedValues);
+    }
+
+    if (_map)
+    {
+        CSM_DELETE(_map);
     }
 
     if (_keys)
@@ -497,16 +909,60 @@ Map::~Map()
 }
 
 
+csmVector<Value*>* Array::GetVector(csmVector<Value*>* /*defaultValue*/)
+{
+    if (!_vector)
+    {
+        _vector = CSM_NEW csmVector<Value*>(_size > 0 ? _size : 1);
+        for (csmInt32 i = 0; i < _size; ++i)
+        {
+            _vector->PushBack(_elements[i], false);
+        }
+    }
+    return _vector;
+}
+
+
+void Array::Add(Value* v)
+{
+    if (_size >= _capacity)
+    {
+        const csmInt32 capacity = (_capacity > 0) ? _capacity * 2 : 4;
+        Value** elements = static_cast<Value**>(_arena->Allocate(sizeof(Value*) * capacity));
+        for (csmInt32 i = 0; i < _size; ++i)
+        {
+            elements[i] = _elements[i];
+        }
+        _elements = elements;
+        _capacity = capacity;
+    }
+
+    _elements[_size++] = v;
+
+    if (_vector)
+    {
+        _vector->PushBack(v, false);
+    }
+
+    AddOwnedValue(_addedValues, v);
+}
+
+
 Array::~Array()
 {
-    csmVector<Value*>::iterator ite = _array.Begin();
-    for (; ite != _array.End(); ++ite)
+    // パースした要素はCubismJsonのアリーナと共に解放される
+    if (_addedValues)
     {
-        Value* v = (*ite);
-        if (v && !v->IsStatic())
+        for (csmUint32 i = 0; i < _addedValues->GetSize(); ++i)
         {
-            CSM_DELETE(v);
+            CSM_DELETE((*_addedValues)[i]);
         }
+        CSM_DELETE(_addedValues);
+    }
+
+    if (_vector)
+    {
+        CSM_DELETE(_vector);
     }
 }
 }}}}
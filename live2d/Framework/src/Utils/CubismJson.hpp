@@ -11,12 +11,15 @@
 #include "Type/csmVector.hpp"
 #include "Type/csmMap.hpp"
 #include "Type/csmString.hpp"
+#include "CubismArena.hpp"
 
 //------------ LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
 class Value;
 class Error;
 class NullValue;
+class Array;
+class Map;
 
 #define CSM_JSON_ERROR_TYPE_MISMATCH            "Error:type mismatch"
 #define CSM_JSON_ERROR_INDEX_OUT_OF_BOUNDS      "Error:index out of bounds"
@@ -233,11 +236,27 @@ private:
 
 };
 
+/**
+ * @brief   マップの要素
+ *
+ * キーはパースしたJSONのバッファ内の文字列を参照する。
+ */
+struct MapEntry
+{
+    const csmChar* Key;     ///< キー。'\0'で終端されている
+    csmInt32 KeyLength;     ///< キーの長さ
+    csmUint32 KeyHash;      ///< キーのハッシュ値
+    Value* Element;         ///< 値
+};
+
 /**
  * @brief   Ascii文字のみ対応した最小限の軽量JSONパーサ。<br>
  *           仕様はJSONのサブセットとなる。<br>
  *           設定ファイル(model3.json)などのロード用<br>
  *           <br>
+ *           パースした要素とソースのコピーはインスタンスごとのアリーナに確保し、インスタンスと共にまとめて解放する。<br>
+ *           文字列の要素とマップのキーはソースのコピーを参照する。<br>
+ *           <br>
  *           [未対応項目]<br>
  *           ・日本語などの非ASCII文字<br>
  *           ・e による指数表現
@@ -293,15 +312,17 @@ protected:
     csmBool ParseBytes(const csmByte* buffer, csmInt32 size);
 
     /**
-     * @brief   次の「"」までの文字列をパースする。文字列は外部で解放する必要がある。
+     * @brief   次の「"」までの文字列をパースする。<br>
+     *           エスケープをその場で展開し、終端の「"」の位置までに'\0'を書き込む。
      *
      * @param[in]   string  ->  パース対象の文字列
      * @param[in]   length  ->  パースする長さ
      * @param[in]   begin   ->  パースを開始する位置
      * @param[out]  outEndPos   ->  パース終了時の位置
-     * @return      パースした文字列要素
+     * @param[out]  outLength   ->  パースした文字列の長さ
+     * @return      パースした文字列の先頭。string内を指す
      */
-    csmString ParseString(const csmChar* string, csmInt32 length, csmInt32 begin, csmInt32* outEndPos);
+    csmChar* ParseString(csmChar* string, csmInt32 length, csmInt32 begin, csmInt32* outEndPos, csmInt32* outLength);
 
 
     /**
@@ -313,7 +334,7 @@ protected:
      * @param[out]  outEndPos   ->  パース終了時の位置
      * @return      パースから取得したValueオブジェクト
      */
-    Value* ParseObject(const csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos);
+    Value* ParseObject(csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos);
 
     /**
      * @brief   JSONの配列エレメントをパースしてValueオブジェクトを返す
@@ -324,7 +345,7 @@ protected:
      * @param[out]  outEndPos   ->  パース終了時の位置
      * @return      パースから取得したValueオブジェクト
      */
-    Value* ParseArray(const csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos);
+    Value* ParseArray(csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos);
 
     /**
      * @brief   JSONエレメントからValue(float,String,Value*,Array,null,true,false)をパースする<br>
@@ -336,7 +357,7 @@ protected:
      * @param[out]  outEndPos   ->  パース終了時の位置
      * @return      パースから取得したValueオブジェクト
      */
-    Value* ParseValue(const csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos);
+    Value* ParseValue(csmChar* buffer, csmInt32 length, csmInt32 begin, csmInt32* outEndPos);
 
 private:
     /**
@@ -358,9 +379,58 @@ private:
     */
     virtual ~CubismJson();
 
+    // Prevention of copy Constructor
+    CubismJson(const CubismJson&);
+    CubismJson& operator=(const CubismJson&);
+
+    /**
+     * @brief   要素の領域をアリーナに確保する
+     *
+     * 確保した領域にはplacement newで型Tの要素を生成すること。
+     *
+     * @return  確保した領域
+     */
+    template <class T>
+    void* AllocateValue()
+    {
+        return _arena.Allocate(sizeof(T), &CubismJson::FinalizeValue<T>);
+    }
+
+    /**
+     * @brief   アリーナに確保した要素の終了処理
+     *
+     * @param[in]   value   ->  終了処理を行う要素
+     */
+    template <class T>
+    static void FinalizeValue(void* value)
+    {
+        static_cast<T*>(value)->~T();
+    }
+
+    /**
+     * @brief   パース中のマップの要素からマップを作成する
+     *
+     * 同じキーが複数ある場合は最初の位置に後の値を設定する。
+     *
+     * @param[in]   entryBegin  ->  作成するマップの最初の要素の_entryStack内の位置
+     * @return      作成したマップ
+     */
+    Map* CreateMap(csmInt32 entryBegin);
+
+    /**
+     * @brief   パース中の配列の要素から配列を作成する
+     *
+     * @param[in]   valueBegin  ->  作成する配列の最初の要素の_valueStack内の位置
+     * @return      作成した配列
+     */
+    Array* CreateArray(csmInt32 valueBegin);
+
     const csmChar*  _error;         ///< パース時のエラー
     csmInt32        _lineCount;     ///< エラー報告に用いる行数カウント
     Value*          _root;          ///< パースされたルート要素
+    CubismArena     _arena;         ///< 要素とソースのコピーを確保するアリーナ
+    csmVector<Value*>   _valueStack;    ///< パース中の配列の要素
+    csmVector<MapEntry> _entryStack;    ///< パース中のマップの要素
 };
 
 
@@ -534,12 +604,28 @@ public:
     /**
      * @brief   引数付きコンストラクタ
      */
-    String(const csmString& s) : Value() { this->_stringBuffer = s; }
+    String(const csmString& s) : Value()
+                               , _view(NULL)
+                               , _viewLength(0)
+                               , _isViewCopied(false) { this->_stringBuffer = s; }
 
     /**
      * @brief   引数付きコンストラクタ
      */
-    String(const csmChar* s) : Value() { this->_stringBuffer = s; }
+    String(const csmChar* s) : Value()
+                             , _view(NULL)
+                             , _viewLength(0)
+                             , _isViewCopied(false) { this->_stringBuffer = s; }
+
+    /**
+     * @brief   文字列を参照する引数付きコンストラクタ
+     *
+     * 文字列をコピーせずに参照する。sはインスタンスより長く保持し、s[length]は'\0'であること。
+     */
+    String(const csmChar* s, csmInt32 length) : Value()
+                                              , _view(s)
+                                              , _viewLength(length)
+                                              , _isViewCopied(false) {}
 
     /**
      * @brief   デストラクタ
@@ -553,21 +639,51 @@ public:
 
     /**
      * @brief   要素を文字列で返す(csmString型)
+     *
+     * 文字列を参照している場合は最初の呼び出しでコピーする。
      */
     virtual const csmString& GetString(const csmString& defaultValue = "", const csmString& indent = "")
     {
+        if (_view && !_isViewCopied)
+        {
+            _stringBuffer = csmString(_view, _viewLength);
+            _isViewCopied = true;
+        }
         return _stringBuffer;
     }
 
+    /**
+     * @brief   要素を文字列で返す(csmChar*)
+     *
+     */
+    virtual const csmChar* GetRawString(const csmString& defaultValue = "", const csmString& indent = "")
+    {
+        return _view ? _view : _stringBuffer.GetRawString();
+    }
+
     /**
      *@brief 引数の値と等しければtrue。
      */
-    virtual csmBool Equals(const csmString& v) { return (_stringBuffer == v); }
+    virtual csmBool Equals(const csmString& v)
+    {
+        if (_view)
+        {
+            return v.GetLength() == _viewLength && memcmp(_view, v.GetRawString(), _viewLength) == 0;
+        }
+        return (_stringBuffer == v);
+    }
 
     /**
      *@brief 引数の値と等しければtrue。
      */
-    virtual csmBool Equals(const csmChar* v) { return (_stringBuffer == v); }
+    virtual csmBool Equals(const csmChar* v)
+    {
+        if (_view)
+        {
+            return strcmp(_view, v) == 0;
+        }
+        return (_stringBuffer == v);
+    }
 
     /**
      *@brief 引数の値と等しければtrue。
@@ -583,6 +699,11 @@ public:
      *@brief 引数の値と等しければtrue。
      */
     virtual csmBool Equals(csmBool v) { return false; }
+
+private:
+    const csmChar* _view;       ///< 参照している文字列。コピーを持つ場合はNULL
+    csmInt32 _viewLength;       ///< 参照している文字列の長さ
+    csmBool _isViewCopied;      ///< 参照している文字列を_stringBufferにコピー済みか
 };
 
 
@@ -675,16 +796,13 @@ private:
 /**
  * @brief   パースしたJSONの要素を配列として持つ
  *
+ * 要素のリストはCubismJsonのアリーナに確保される。
  */
 class Array : public Value
 {
-public:
-    /**
-     * @brief    コンストラクタ
-     */
-    Array() : Value()
-            , _array() {}
+    friend class CubismJson;
 
+public:
     /**
      * @brief   デストラクタ
      */
@@ -701,9 +819,9 @@ public:
      */
     virtual Value& operator[](csmInt32 index)
     {
-        if (index < 0 || (static_cast<csmInt32>(_array.GetSize()) <= index))
+        if (index < 0 || _size <= index)
             return *(ErrorValue->SetErrorNotForClientCall(CSM_JSON_ERROR_INDEX_OUT_OF_BOUNDS));
-        Value* v = _array[index];
+        Value* v = _elements[index];
 
         if (v == NULL) return *Value::NullValue;
         return *v;
@@ -734,10 +852,9 @@ public:
     virtual const csmString& GetString(const csmString& defaultValue = "", const csmString& indent = "")
     {
         _stringBuffer = indent + "[\n";
-        csmVector<Value*>::iterator ite = _array.Begin();
-        for (; ite != _array.End(); ite++)
+        for (csmInt32 i = 0; i < _size; i++)
         {
-            Value* v = (*ite);
+            Value* v = _elements[i];
             _stringBuffer += indent + "	" + v->GetString(indent + "	") + "\n";
         }
         _stringBuffer += indent + "]\n";
@@ -746,40 +863,64 @@ public:
     }
 
     /**
-     * @brief   配列要素を追加する
+     * @brief   要素をコンテナで返す(csmVector<Value*>)
+     *
+     * コンテナは最初の呼び出しで作成する。
      */
-    void Add(Value* v) { _array.PushBack(v, false); }
+    virtual csmVector<Value*>* GetVector(csmVector<Value*>* defaultValue = NULL);
 
     /**
-     * @brief   要素をコンテナで返す(csmVector<Value*>)
+     * @brief   配列要素を追加する
      *
+     * 要素のリストが足りなければCubismJsonのアリーナに確保し直す。
+     * 追加した要素は配列と共に削除されるため、CSM_NEWで確保したものを渡すこと。
+     *
+     * @param[in]   v   ->  追加する要素
      */
-    virtual csmVector<Value*>* GetVector(csmVector<Value*>* defaultValue = NULL) { return &_array; }
+    void Add(Value* v);
 
     /**
      * @brief   要素の数を返す
      *
      */
-    virtual csmInt32 GetSize() { return static_cast<csmInt32>(_array.GetSize()); }
+    virtual csmInt32 GetSize() { return _size; }
 
 private:
-    csmVector<Value*> _array; ///< JSON要素の値
+    /**
+     * @brief    コンストラクタ
+     *
+     * @param[in]   arena       ->  要素のリストを確保したアリーナ
+     * @param[in]   elements    ->  要素のリスト
+     * @param[in]   size        ->  要素の数
+     */
+    Array(CubismArena* arena, Value** elements, csmInt32 size) : Value()
+                                                                , _arena(arena)
+                                                                , _elements(elements)
+                                                                , _size(size)
+                                                                , _capacity(size)
+                                                                , _vector(NULL)
+                                                                , _addedValues(NULL) {}
+
+    CubismArena* _arena;            ///< 要素のリストを確保するアリーナ
+    Value** _elements;              ///< JSON要素の値
+    csmInt32 _size;                 ///< JSON要素の数
+    csmInt32 _capacity;             ///< 要素のリストに入る要素の数
+    csmVector<Value*>* _vector;     ///< GetVectorで返すコンテナ
+    csmVector<Value*>* _addedValues;    ///< Addで追加され、配列と共に削除する要素
 };
 
 
 /**
  * @brief   パースしたJSONの要素をマップとして持つ
  *
+ * 要素はパースした順に並べ、キーのハッシュ値によるオープンアドレス法の索引で検索する。
+ * 要素と索引はCubismJsonのアリーナに確保される。
  */
 class Map : public Value
 {
-public:
-    /**
-     * @brief    コンストラクタ
-     */
-    Map() : Value()
-          , _keys(NULL) {}
+    friend class CubismJson;
 
+public:
     /**
      * @brief    デストラクタ
      */
@@ -795,12 +936,7 @@ public:
      */
     virtual Value& operator[](const csmString& s)
     {
-        Value* ret = _map[s];
-        if (ret == NULL)
-        {
-            return *Value::NullValue;
-        }
-        return *ret;
+        return Find(s.GetRawString(), s.GetLength());
     }
 
     /**
@@ -809,19 +945,7 @@ public:
      */
     virtual Value& operator[](const csmChar* s)
     {
-        for (csmMap<csmString, Value*>::const_iterator iter = _map.Begin(); iter != _map.End(); ++iter)
-        {
-            if( strcmp(iter->First.GetRawString(), s) == 0 )
-            {
-                if(iter->Second==NULL)
-                {
-                    return *Value::NullValue;
-                }
-                return *iter->Second;
-            }
-        }
-
-        return *Value::NullValue;
+        return Find(s, static_cast<csmInt32>(strlen(s)));
     }
 
     /**
@@ -835,14 +959,12 @@ public:
     virtual const csmString& GetString(const csmString& defaultValue = "", const csmString& indent = "")
     {
         _stringBuffer = indent + "{\n";
-        csmMap<csmString, Value*>::const_iterator ite = _map.Begin();
-        while (ite != _map.End())
+        for (csmInt32 i = 0; i < _entryCount; i++)
         {
-            const csmString& key = (*ite).First;
-            Value* v = (*ite).Second;
+            const csmString key(_entries[i].Key, _entries[i].KeyLength);
+            Value* v = _entries[i].Element;
 
             _stringBuffer += indent + "	" + key + " : " + v->GetString(indent + "	") + "\n";
-            ++ite;
         }
         _stringBuffer += indent + "}\n";
         return _stringBuffer;
@@ -850,47 +972,87 @@ public:
 
     /**
      * @brief    要素をMap型で返す
+     *
+     * マップは最初の呼び出しで作成する。
      */
-    virtual csmMap<csmString, Value*>* GetMap(csmMap<csmString, Value*>* defaultValue = NULL)
-    {
-        return &_map;
-    }
+    virtual csmMap<csmString, Value*>* GetMap(csmMap<csmString, Value*>* defaultValue = NULL);
 
     /**
-     * @brief    Mapに要素を追加する
+     * @brief    Mapからキーのリストを取得する
      */
-    void Put(csmString& key, Value* v)
-    {
-        _map[key] = v;
-    }
+    virtual csmVector<csmString>& GetKeys();
 
     /**
-     * @brief    Mapからキーのリストを取得する
+     * @brief    Mapに要素を追加する
+     *
+     * 同じキーがあれば値を置き換え、なければ最後に追加する。キーと要素のリストはCubismJsonのアリーナに確保する。
+     * 追加した要素はマップと共に削除されるため、CSM_NEWで確保したものを渡すこと。
+     *
+     * @param[in]   key ->  キー
+     * @param[in]   v   ->  追加する要素
      */
-    virtual csmVector<csmString>& GetKeys()
-    {
-        if (!_keys)
-        {
-            _keys = CSM_NEW csmVector<csmString>();
-            csmMap<csmString, Value*>::const_iterator ite = _map.Begin();
-            while (ite != _map.End())
-            {
-                const csmString& key = (*ite).First;
-                _keys->PushBack(key, true);
-                ++ite;
-            }
-        }
-        return *_keys;
-    }
+    void Put(const csmString& key, Value* v);
 
     /**
      * @brief    Mapの要素数を取得する
      */
-    virtual csmInt32 GetSize() { return static_cast<csmInt32>(_keys->GetSize()); }
+    virtual csmInt32 GetSize() { return _entryCount; }
+
+    /**
+     * @brief    キーのハッシュ値を計算する
+     *
+     * @param[in]   key     ->  キー
+     * @param[in]   length  ->  キーの長さ
+     * @return      ハッシュ値
+     */
+    static csmUint32 HashKey(const csmChar* key, csmInt32 length);
 
 private:
-    csmMap<csmString, Value*> _map;     ///< JSON要素の値
-    csmVector<csmString>* _keys;        ///< JSON要素の値
+    /**
+     * @brief    コンストラクタ
+     *
+     * @param[in]   arena       ->  要素のリストと索引を確保したアリーナ
+     * @param[in]   entries     ->  キーが重複しない要素のリスト
+     * @param[in]   entryCount  ->  要素の数
+     * @param[in]   slots       ->  索引。要素のインデックスか、空なら-1
+     * @param[in]   slotMask    ->  索引の数から1を引いた値。索引の数は2のべき乗
+     */
+    Map(CubismArena* arena, MapEntry* entries, csmInt32 entryCount, csmInt32* slots, csmUint32 slotMask) : Value()
+                                                                                                         , _arena(arena)
+                                                                                                         , _entries(entries)
+                                                                                                         , _entryCount(entryCount)
+                                                                                                         , _entryCapacity(entryCount)
+                                                                                                         , _slots(slots)
+                                                                                                         , _slotMask(slotMask)
+                                                                                                         , _map(NULL)
+                                                                                                         , _keys(NULL)
+                                                                                                         , _addedValues(NULL) {}
+
+    /**
+     * @brief    索引を作り直す
+     *
+     * @param[in]   slotCount   ->  索引の数。2のべき乗で、要素の数の2倍以上
+     */
+    void Rehash(csmInt32 slotCount);
+
+    /**
+     * @brief    キーで要素を検索する
+     *
+     * @param[in]   key     ->  キー
+     * @param[in]   length  ->  キーの長さ
+     * @return      要素。存在しない場合はNullValue
+     */
+    Value& Find(const csmChar* key, csmInt32 length) const;
+
+    CubismArena* _arena;                ///< 要素のリストと索引を確保するアリーナ
+    MapEntry* _entries;                 ///< JSON要素の値
+    csmInt32 _entryCount;               ///< JSON要素の数
+    csmInt32 _entryCapacity;            ///< 要素のリストに入る要素の数
+    csmInt32* _slots;                   ///< キーのハッシュ値による索引
+    csmUint32 _slotMask;                ///< 索引の数から1を引いた値
+    csmMap<csmString, Value*>* _map;    ///< GetMapで返すマップ
+    csmVector<csmString>* _keys;        ///< GetKeysで返すキーのリスト
+    csmVector<Value*>* _addedValues;    ///< Putで追加され、マップと共に削除する要素
 };
 }}}}
 
@@ -7,43 +7,169 @@
 
 #include "CubismString.hpp"
 #include "Type/csmVector.hpp"
+#include <locale.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
 
 //--------- LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
 
+namespace {
+
+/// Powers of ten that are exactly representable as a double.
+const double ExactPowersOfTen[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+    1e21, 1e22,
+};
+
+const csmInt32 MaximumExactPowerOfTen = 22;
+const csmInt32 MaximumMantissaDigits = 19;
+const csmUint64 MaximumExactMantissa = 1ULL << 53;
+
+/// Size of the stack buffer used to rewrite the decimal point of a number.
+const csmInt32 LocalizedNumberBufferSize = 64;
+
+/// Returns whether the character can be a part of a number strtof accepts.
+///
+/// @param  c  Character.
+/// @return true if the character can be a part of a decimal or hexadecimal number, an infinity or a NaN.
+csmBool IsNumberCharacter(csmChar c)
+{
+    return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z')
+        || c == '.' || c == '+' || c == '-' || c == '_' || c == '(' || c == ')';
+}
+
+/// Parses with strtof for the inputs the fast path does not handle.
+///
+/// strtof reads the decimal point of the current locale, so the number is copied
+/// with '.' replaced by that decimal point when the locale does not use '.'.
+///
+/// @param  string      String terminated with '\0'.
+/// @param  position    Position of the number.
+/// @param  outEndPos   Position after the number.
+/// @return Parsed value.
+csmFloat32 ParseFloatSlow(const csmChar* string, csmInt32 position, csmInt32* outEndPos)
+{
+    const csmChar* decimalPoint = localeconv()->decimal_point;
+    const csmChar* number = string + position;
+    csmChar* end;
+
+    if (decimalPoint[0] == '.' && decimalPoint[1] == '\0')
+    {
+        const csmFloat32 ret = strtof(number, &end);
+        *outEndPos = static_cast<csmInt32>(end - string);
+        return ret;
+    }
+
+    const csmInt32 decimalPointLength = static_cast<csmInt32>(strlen(decimalPoint));
+    csmInt32 numberLength = 0;
+    csmInt32 periodPosition = -1;
+
+    while (IsNumberCharacter(number[numberLength]))
+    {
+        if (number[numberLength] == '.' && periodPosition < 0)
+        {
+            periodPosition = numberLength;
+        }
+        ++numberLength;
+    }
+
+    if (periodPosition < 0)
+    {
+        const csmFloat32 ret = strtof(number, &end);
+        *outEndPos = static_cast<csmInt32>(end - string);
+        return ret;
+    }
+
+    // 小数点をロケールの表記に置き換えた写しを解析し、終了位置を元の文字列の位置に戻す
+    csmChar stackBuffer[LocalizedNumberBufferSize];
+    const csmInt32 bufferSize = numberLength + decimalPointLength;
+    csmChar* buffer = (bufferSize <= LocalizedNumberBufferSize)
+        ? stackBuffer
+        : static_cast<csmChar*>(CSM_MALLOC(sizeof(csmChar) * bufferSize));
+
+    memcpy(buffer, number, periodPosition);
+    memcpy(buffer + periodPosition, decimalPoint, decimalPointLength);
+    memcpy(buffer + periodPosition + decimalPointLength, number + periodPosition + 1, numberLength - periodPosition - 1);
+    buffer[bufferSize - 1] = '\0';
+
+    const csmFloat32 ret = strtof(buffer, &end);
+    csmInt32 endPosition = static_cast<csmInt32>(end - buffer);
+    if (endPosition > periodPosition)
+    {
+        endPosition = (endPosition < periodPosition + decimalPointLength)
+            ? periodPosition
+            : endPosition - decimalPointLength + 1;
+    }
+    *outEndPos = position + endPosition;
+
+    if (buffer != stackBuffer)
+    {
+        CSM_FREE(buffer);
+    }
+
+    return ret;
+}
+
+}
+
 //標準出力の戻り値が複製されるのでオーバーヘッドは大きい。
+//ホットパスではFormatToで呼び出し側のバッファに書き込むこと。
 csmString CubismString::GetFormatedString(const csmChar* format, ...)
 {
-    csmInt32 bufferSize = 256;
-    csmChar* buffer = static_cast<csmChar*>(CSM_MALLOC(sizeof(csmChar)* bufferSize));
+    csmChar stackBuffer[256];
 
     va_list args;
     va_start(args, format);
 
-    for (;;) {
-#ifdef _WINDOWS
-        if (vsnprintf_s(buffer, bufferSize, _TRUNCATE, format, args) < bufferSize) {
-#else
-        if (vsnprintf(buffer, bufferSize, format, args) < bufferSize) {
-#endif
-            break;
-        } else {
-            // メモリが足りない為、拡張して確保しなおす。
-            CSM_FREE(buffer);
-            bufferSize *= 2;
-            buffer = static_cast<csmChar*>(CSM_MALLOC(sizeof(csmChar)* bufferSize));
-        }
-    }
+    va_list retryArgs;
+    va_copy(retryArgs, args);
+
+    const csmInt32 length = FormatToV(stackBuffer, sizeof(stackBuffer), format, args);
     va_end(args);
 
-    csmString ret = buffer;
+    if (length < 0)
+    {
+        va_end(retryArgs);
+        return csmString();
+    }
+
+    if (length < static_cast<csmInt32>(sizeof(stackBuffer)))
+    {
+        va_end(retryArgs);
+        return csmString(stackBuffer, length);
+    }
+
+    // スタックのバッファに収まらない場合だけ、必要な長さを確保して書き直す
+    csmChar* buffer = static_cast<csmChar*>(CSM_MALLOC(sizeof(csmChar) * (length + 1)));
+    FormatToV(buffer, length + 1, format, retryArgs);
+    va_end(retryArgs);
+
+    csmString ret(buffer, length);
     CSM_FREE(buffer);
 
     return ret; // CubismString型にされて返されるためアドレスを返すので良い。
 }
 
+csmInt32 CubismString::FormatTo(csmChar* buffer, csmInt32 bufferSize, const csmChar* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const csmInt32 length = FormatToV(buffer, bufferSize, format, args);
+    va_end(args);
+    return length;
+}
+
+csmInt32 CubismString::FormatToV(csmChar* buffer, csmInt32 bufferSize, const csmChar* format, va_list args)
+{
+    // vsnprintfは切り詰める前の長さを返す
+    return vsnprintf(buffer, (bufferSize > 0) ? static_cast<size_t>(bufferSize) : 0, format, args);
+}
+
 csmBool CubismString::IsStartsWith(const csmChar* text, const csmChar* startWord)
 {
     while (*startWord != '\0')
@@ -124,6 +250,122 @@ csmFloat32 CubismString::StringToFloat(const csmChar* string, csmInt32 length, c
     return v1;
 }
 
+csmFloat32 CubismString::ParseFloat(const csmChar* string, csmInt32 length, csmInt32 position, csmInt32* outEndPos)
+{
+    csmInt32 i = position;
+    csmBool minus = false;
+
+    if (i < length && string[i] == '-')
+    {
+        minus = true;
+        i++;
+    }
+
+    // 仮数部を整数として読み込み、小数点以下の桁数を指数から引く
+    // Read the mantissa as an integer and subtract the fraction digits from the exponent.
+    csmUint64 mantissa = 0;
+    csmInt32 mantissaDigits = 0;
+    csmInt32 exponent = 0;
+    csmBool hasDigits = false;
+
+    for (; i < length && '0' <= string[i] && string[i] <= '9'; i++)
+    {
+        hasDigits = true;
+        if (mantissa != 0 || string[i] != '0')
+        {
+            mantissa = mantissa * 10 + (string[i] - '0');
+            mantissaDigits++;
+        }
+    }
+
+    if (i < length && string[i] == '.')
+    {
+        i++;
+        for (; i < length && '0' <= string[i] && string[i] <= '9'; i++)
+        {
+            hasDigits = true;
+            if (mantissa != 0 || string[i] != '0')
+            {
+                mantissa = mantissa * 10 + (string[i] - '0');
+                mantissaDigits++;
+            }
+            exponent--;
+        }
+    }
+
+    if (!hasDigits || mantissaDigits > MaximumMantissaDigits)
+    {
+        // 16進数、無限大、非数と桁数の多い数値
+        return ParseFloatSlow(string, position, outEndPos);
+    }
+
+    if (i < length && (string[i] == 'e' || string[i] == 'E'))
+    {
+        csmInt32 j = i + 1;
+        csmBool exponentMinus = false;
+
+        if (j < length && (string[j] == '+' || string[j] == '-'))
+        {
+            exponentMinus = (string[j] == '-');
+            j++;
+        }
+
+        if (j < length && '0' <= string[j] && string[j] <= '9')
+        {
+            csmInt32 explicitExponent = 0;
+            for (; j < length && '0' <= string[j] && string[j] <= '9'; j++)
+            {
+                if (explicitExponent < 10000)
+                {
+                    explicitExponent = explicitExponent * 10 + (string[j] - '0');
+                }
+            }
+            exponent += exponentMinus ? -explicitExponent : explicitExponent;
+            i = j;
+        }
+    }
+
+    if (i < length && (string[i] == 'x' || string[i] == 'X'))
+    {
+        return ParseFloatSlow(string, position, outEndPos);
+    }
+
+    if (mantissa == 0)
+    {
+        *outEndPos = i;
+        return minus ? -0.0f : 0.0f;
+    }
+
+    if (mantissa > MaximumExactMantissa || exponent < -MaximumExactPowerOfTen || MaximumExactPowerOfTen < exponent)
+    {
+        return ParseFloatSlow(string, position, outEndPos);
+    }
+
+    // 仮数と10のべき乗が倍精度で正確に表せるため、1回の乗除算で正しく丸めた倍精度の値が得られる
+    // Both operands are exact doubles, so a single multiplication or division is correctly rounded.
+    double value = static_cast<double>(mantissa);
+    if (exponent < 0)
+    {
+        value /= ExactPowersOfTen[-exponent];
+    }
+    else
+    {
+        value *= ExactPowersOfTen[exponent];
+    }
+
+    // 倍精度の値が単精度の2つの値のちょうど中間にある場合は二重丸めになりうる
+    // A double that lies exactly halfway between two floats may be double-rounded.
+    csmUint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x1FFFFFFFULL) == 0x10000000ULL)
+    {
+        return ParseFloatSlow(string, position, outEndPos);
+    }
+
+    *outEndPos = i;
+    return static_cast<csmFloat32>(minus ? -value : value);
+}
+
 }}}}
 
 //------------------------- LIVE2D NAMESPACE ------------
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "Type/csmString.hpp"
+#include <stdarg.h>
 
 //--------- LIVE2D NAMESPACE ------------
 namespace Live2D { namespace Cubism { namespace Framework { namespace Utils{
@@ -23,6 +24,48 @@ public:
      */
     static csmString GetFormatedString(const csmChar* format, ...);
 
+    /**
+     * @brief   標準出力の書式を適用した文字列を呼び出し側のバッファに書き込む。メモリを確保しない。
+     *
+     * 結果がバッファに収まらない場合は切り詰め、bufferSizeが1以上なら常に'\0'で終端する。
+     *
+     * @param[out]  buffer      ->  書き込み先のバッファ
+     * @param[in]   bufferSize  ->  バッファのサイズ('\0'を含む)
+     * @param[in]   format      ->  標準出力の書式指定文字列
+     * @param[in]   ...         ->  書式指定文字列に渡す文字列
+     * @return  切り詰める前の文字列の長さ。bufferSize以上なら切り詰められている。書式のエラーなら負の値
+     */
+    static csmInt32 FormatTo(csmChar* buffer, csmInt32 bufferSize, const csmChar* format, ...);
+
+    /**
+     * @brief   標準出力の書式を適用した文字列を固定長の配列に書き込む。メモリを確保しない。
+     *
+     * @param[out]  buffer  ->  書き込み先の配列
+     * @param[in]   format  ->  標準出力の書式指定文字列
+     * @param[in]   ...     ->  書式指定文字列に渡す文字列
+     * @return  切り詰める前の文字列の長さ。配列の要素数以上なら切り詰められている。書式のエラーなら負の値
+     */
+    template<csmInt32 Size>
+    static csmInt32 FormatTo(csmChar (&buffer)[Size], const csmChar* format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+        const csmInt32 length = FormatToV(buffer, Size, format, args);
+        va_end(args);
+        return length;
+    }
+
+    /**
+     * @brief   FormatToのva_list版
+     *
+     * @param[out]  buffer      ->  書き込み先のバッファ
+     * @param[in]   bufferSize  ->  バッファのサイズ('\0'を含む)
+     * @param[in]   format      ->  標準出力の書式指定文字列
+     * @param[in]   args        ->  書式指定文字列に渡す引数
+     * @return  切り詰める前の文字列の長さ。bufferSize以上なら切り詰められている。書式のエラーなら負の値
+     */
+    static csmInt32 FormatToV(csmChar* buffer, csmInt32 bufferSize, const csmChar* format, va_list args);
+
     /**
      * @brief   textがstartWordで始まっているかどうかを返す
      * @param[in]   text        ->  検査対象の文字列
@@ -44,6 +87,22 @@ public:
      */
     static csmFloat32 StringToFloat(const csmChar* string, csmInt32 length, csmInt32 position, csmInt32* outEndPos);
 
+    /**
+     * @brief   position位置の文字から数値を解析する。
+     *
+     * Cロケールのstrtofと同じ書式を受け付け、同じ値を返す。ロケールには依存しない。
+     * 仮数部が19桁以下で指数が±22以内の数値は倍精度の1回の乗除算で正しく丸めて求め、
+     * それ以外の数値と16進数、無限大、非数はstrtofで解析する。
+     * その際は'.'を現在のロケールの小数点に置き換えて渡すため、LC_NUMERICの設定によらず'.'を小数点として読む。
+     *
+     * @param[in]   string -> 文字列。'\0'で終端されていること
+     * @param[in]   length -> 文字列の長さ
+     * @param[in]   position  -> 解析したい文字の位置
+     * @param[out]  outEndPos   ->  解析を終えた位置。一文字も読み込まなかった場合はposition
+     * @return      解析結果の数値
+     */
+    static csmFloat32 ParseFloat(const csmChar* string, csmInt32 length, csmInt32 position, csmInt32* outEndPos);
+
 private:
     // コンストラクタ・デストラクタ呼び出し不可な静的クラスにする
     CubismString();
@@ -0,0 +1,288 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismTrace.hpp"
+#include "CubismDebug.hpp"
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
+
+namespace {
+
+/**
+ * @brief   記録した区間
+ */
+struct TraceEvent
+{
+    const csmChar* Name;        ///< 区間の名前
+    csmUint64 Start;            ///< 開始時刻（GetTimestamp()の単位）
+    csmUint64 Duration;         ///< 経過時間（GetTimestamp()の単位）
+    csmUint32 ThreadId;         ///< 記録したスレッドのID
+};
+
+/**
+ * @brief   スレッドごとの記録
+ */
+struct ThreadBuffer
+{
+    TraceEvent Events[CubismTrace::EventCapacity];      ///< 終了した区間のリングバッファ
+    TraceEvent Open[CubismTrace::MaxDepth];             ///< 開始して終了していない区間
+    std::atomic<csmUint64> Head;                        ///< これまでに記録した区間の数。バッファを再利用しても戻さない
+    csmUint32 Depth;                                    ///< 開始して終了していない区間の数
+    csmUint32 ThreadId;                                 ///< 書き出すJSONでのスレッドID
+    const csmChar* ThreadName;                          ///< スレッドの名前。未設定ならNULL
+    std::atomic<csmBool> InUse;                         ///< スレッドが使用中か
+    ThreadBuffer* Next;                                 ///< 次のバッファ
+};
+
+std::atomic<ThreadBuffer*> s_buffers(NULL);     // 確保した全てのバッファ。解放はしない
+std::atomic<csmUint32> s_nextThreadId(1);
+
+/**
+ * @brief   スレッドの終了時にバッファを手放す
+ */
+struct ThreadBufferHolder
+{
+    ThreadBuffer* Buffer;
+
+    ~ThreadBufferHolder()
+    {
+        if (Buffer != NULL)
+        {
+            Buffer->InUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadBufferHolder s_threadBuffer = { NULL };
+
+/**
+ * @brief   現在時刻の取得
+ *
+ * AArch64ではclock_gettimeを経由せずに仮想カウンタを直接読む。
+ */
+inline csmUint64 GetTimestamp()
+{
+#if defined(__aarch64__)
+    csmUint64 ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<csmUint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief   GetTimestamp()の1秒あたりのカウント数の取得
+ */
+csmUint64 GetTimestampFrequency()
+{
+#if defined(__aarch64__)
+    csmUint64 frequency;
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return frequency;
+#else
+    return 1000000000ull;
+#endif
+}
+
+ThreadBuffer* AcquireThreadBuffer()
+{
+    ThreadBuffer* buffer;
+
+    // 終了したスレッドのバッファがあれば再利用する
+    for (buffer = s_buffers.load(std::memory_order_acquire); buffer != NULL; buffer = buffer->Next)
+    {
+        csmBool inUse = false;
+        if (buffer->InUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+        {
+            // 前のスレッドの区間はスレッドIDごと残す
+            buffer->Depth = 0;
+            buffer->ThreadId = s_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+            buffer->ThreadName = NULL;
+            return buffer;
+        }
+    }
+
+    // CubismFrameworkの初期化前後にも記録できるように、アロケータを通さずに確保する
+    buffer = static_cast<ThreadBuffer*>(calloc(1, sizeof(ThreadBuffer)));
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+
+    buffer->ThreadId = s_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    buffer->InUse.store(true, std::memory_order_relaxed);
+
+    ThreadBuffer* head = s_buffers.load(std::memory_order_relaxed);
+    do
+    {
+        buffer->Next = head;
+    } while (!s_buffers.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+
+    return buffer;
+}
+
+inline ThreadBuffer* GetThreadBuffer()
+{
+    if (s_threadBuffer.Buffer == NULL)
+    {
+        s_threadBuffer.Buffer = AcquireThreadBuffer();
+    }
+
+    return s_threadBuffer.Buffer;
+}
+
+void WriteJsonString(FILE* file, const csmChar* string)
+{
+    fputc('"', file);
+    for (const csmChar* c = string; *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fputc('\\', file);
+            fputc(*c, file);
+        }
+        else if (static_cast<csmUint8>(*c) < 0x20)
+        {
+            fprintf(file, "\\u%04x", static_cast<csmUint32>(static_cast<csmUint8>(*c)));
+        }
+        else
+        {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+}
+
+void CubismTrace::Begin(const csmChar* name)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer == NULL)
+    {
+        return;
+    }
+
+    // 深すぎる区間は記録しないが、End()との対応を保つために数える
+    if (buffer->Depth < MaxDepth)
+    {
+        TraceEvent& event = buffer->Open[buffer->Depth];
+        event.Name = name;
+        event.Start = GetTimestamp();
+    }
+    buffer->Depth++;
+}
+
+void CubismTrace::End()
+{
+    const csmUint64 now = GetTimestamp();
+    ThreadBuffer* buffer = s_threadBuffer.Buffer;
+    if (buffer == NULL || buffer->Depth == 0)
+    {
+        return;
+    }
+
+    buffer->Depth--;
+    if (buffer->Depth >= MaxDepth)
+    {
+        return;
+    }
+
+    const TraceEvent& open = buffer->Open[buffer->Depth];
+    const csmUint64 head = buffer->Head.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->Events[head & (EventCapacity - 1)];
+    event.Name = open.Name;
+    event.Start = open.Start;
+    event.Duration = now - open.Start;
+    event.ThreadId = buffer->ThreadId;
+    buffer->Head.store(head + 1, std::memory_order_release);
+}
+
+void CubismTrace::SetThreadName(const csmChar* name)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer != NULL)
+    {
+        buffer->ThreadName = name;
+    }
+}
+
+csmBool CubismTrace::WriteChromeTrace(const csmChar* filePath)
+{
+    FILE* file = fopen(filePath, "w");
+    if (file == NULL)
+    {
+        CubismLogError("Failed to open the trace file. path: %s", filePath);
+        return false;
+    }
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+
+    // タイムスタンプはマイクロ秒で書き出す
+    const double microsecondsPerTick = 1000000.0 / static_cast<double>(GetTimestampFrequency());
+
+    csmBool isFirst = true;
+    for (ThreadBuffer* buffer = s_buffers.load(std::memory_order_acquire); buffer != NULL; buffer = buffer->Next)
+    {
+        if (buffer->ThreadName != NULL)
+        {
+            fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", isFirst ? "" : ",", buffer->ThreadId);
+            WriteJsonString(file, buffer->ThreadName);
+            fputs("}}", file);
+            isFirst = false;
+        }
+
+        const csmUint64 head = buffer->Head.load(std::memory_order_acquire);
+        const csmUint64 count = (head < EventCapacity) ? head : EventCapacity;
+        for (csmUint64 i = head - count; i < head; ++i)
+        {
+            const TraceEvent& event = buffer->Events[i & (EventCapacity - 1)];
+
+            fprintf(file, "%s\n{\"name\":", isFirst ? "" : ",");
+            WriteJsonString(file, event.Name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.ThreadId,
+                    static_cast<double>(event.Start) * microsecondsPerTick,
+                    static_cast<double>(event.Duration) * microsecondsPerTick);
+            isFirst = false;
+        }
+    }
+
+    fputs("\n]}\n", file);
+
+    const csmBool succeeded = !ferror(file);
+    fclose(file);
+
+    return succeeded;
+}
+
+void CubismTrace::Clear()
+{
+    for (ThreadBuffer* buffer = s_buffers.load(std::memory_order_acquire); buffer != NULL; buffer = buffer->Next)
+    {
+        buffer->Head.store(0, std::memory_order_relaxed);
+    }
+}
+
+csmBool CubismTrace::IsAvailable()
+{
+#ifdef CSM_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
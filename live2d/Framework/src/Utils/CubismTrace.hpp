@@ -0,0 +1,127 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+
+#ifdef CSM_TRACE
+#define CSM_TRACE_CONCAT_INNER(a, b)    a ## b
+#define CSM_TRACE_CONCAT(a, b)          CSM_TRACE_CONCAT_INNER(a, b)
+#define CSM_TRACE_SCOPE(name)           Live2D::Cubism::Framework::Utils::CubismTraceScope CSM_TRACE_CONCAT(csmTraceScope, __LINE__)(name)
+#define CSM_TRACE_BEGIN(name)           Live2D::Cubism::Framework::Utils::CubismTrace::Begin(name)
+#define CSM_TRACE_END()                 Live2D::Cubism::Framework::Utils::CubismTrace::End()
+#define CSM_TRACE_THREAD_NAME(name)     Live2D::Cubism::Framework::Utils::CubismTrace::SetThreadName(name)
+#else
+#define CSM_TRACE_SCOPE(name)
+#define CSM_TRACE_BEGIN(name)
+#define CSM_TRACE_END()
+#define CSM_TRACE_THREAD_NAME(name)
+#endif
+
+//------------ LIVE2D NAMESPACE ------------
+namespace Live2D { namespace Cubism { namespace Framework { namespace Utils {
+
+/**
+ * @brief   区間の計測
+ *
+ * CSM_TRACE_SCOPE / CSM_TRACE_BEGIN / CSM_TRACE_END で囲んだ区間の開始時刻と経過時間を
+ * スレッドごとのリングバッファに記録し、Chrome trace-event形式のJSONに書き出す。
+ * CSM_TRACEが定義されていない場合、マクロは空になり記録は行われない。
+ *
+ * 区間の名前は文字列リテラルなど、書き出しが終わるまで有効な文字列を渡すこと。
+ * リングバッファが一杯になると古い区間から上書きする。
+ * バッファはスレッドの初回の記録時に確保し、スレッドの終了後は次に記録を始めたスレッドが再利用する。
+ * 再利用する前の区間は、前のスレッドのIDのまま残る。
+ */
+class CubismTrace
+{
+public:
+    static const csmUint32 EventCapacity = 8192;       ///< スレッドごとに保持する区間の数。2の累乗
+    static const csmUint32 MaxDepth = 64;              ///< 記録できる区間の入れ子の深さ
+
+    /**
+     * @brief   区間の開始
+     *
+     * @param[in]   name    ->  区間の名前
+     */
+    static void Begin(const csmChar* name);
+
+    /**
+     * @brief   区間の終了
+     *
+     * 最後に開始した区間を終了し、リングバッファに記録する。
+     */
+    static void End();
+
+    /**
+     * @brief   呼び出したスレッドの名前の設定
+     *
+     * @param[in]   name    ->  書き出すJSONでスレッドに付ける名前
+     */
+    static void SetThreadName(const csmChar* name);
+
+    /**
+     * @brief   記録した区間の書き出し
+     *
+     * 全スレッドのリングバッファに残っている区間をChrome trace-event形式のJSONで書き出す。
+     * chrome://tracing や Perfetto で開くことができる。
+     * 他のスレッドが区間を記録していない時に呼ぶこと。
+     *
+     * @param[in]   filePath    ->  書き出すファイルのパス
+     * @return      true    ->  書き出しに成功した
+     *              false   ->  ファイルを開けなかった
+     */
+    static csmBool WriteChromeTrace(const csmChar* filePath);
+
+    /**
+     * @brief   記録した区間の破棄
+     *
+     * 他のスレッドが区間を記録していない時に呼ぶこと。
+     */
+    static void Clear();
+
+    /**
+     * @brief   記録が有効か
+     *
+     * @return  CSM_TRACEが定義されていればtrue
+     */
+    static csmBool IsAvailable();
+};
+
+/**
+ * @brief   スコープの間を区間として記録する
+ */
+class CubismTraceScope
+{
+public:
+    /**
+     * @brief   コンストラクタ
+     *
+     * @param[in]   name    ->  区間の名前
+     */
+    explicit CubismTraceScope(const csmChar* name)
+    {
+        CubismTrace::Begin(name);
+    }
+
+    /**
+     * @brief   デストラクタ
+     */
+    ~CubismTraceScope()
+    {
+        CubismTrace::End();
+    }
+
+private:
+    // Prevention of copy Constructor
+    CubismTraceScope(const CubismTraceScope&);
+    CubismTraceScope& operator=(const CubismTraceScope&);
+};
+
+}}}}
+//------------ LIVE2D NAMESPACE ------------
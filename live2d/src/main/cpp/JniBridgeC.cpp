@@ -18,6 +18,7 @@ static jclass  g_JniBridgeJavaClass;
 static jmethodID g_GetAssetsMethodId;
 static jmethodID g_LoadFileMethodId;
 static jmethodID g_MoveTaskToBackMethodId;
+static jmethodID g_GetFilesDirMethodId;
 
 JNIEnv* GetEnv()
 {
@@ -42,6 +43,7 @@ jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved)
     g_GetAssetsMethodId = env->GetStaticMethodID(g_JniBridgeJavaClass, "GetAssetList", "(Ljava/lang/String;)[Ljava/lang/String;");
     g_LoadFileMethodId = env->GetStaticMethodID(g_JniBridgeJavaClass, "LoadFile", "(Ljava/lang/String;)[B");
     g_MoveTaskToBackMethodId = env->GetStaticMethodID(g_JniBridgeJavaClass, "MoveTaskToBack", "()V");
+    g_GetFilesDirMethodId = env->GetStaticMethodID(g_JniBridgeJavaClass, "GetFilesDir", "()Ljava/lang/String;");
 
     return JNI_VERSION_1_6;
 }
@@ -90,6 +92,25 @@ char* JniBridgeC::LoadFileAsBytesFromJava(const char* filePath, unsigned int* ou
     return buffer;
 }
 
+Csm::csmString JniBridgeC::GetFilesDir()
+{
+    JNIEnv *env = GetEnv();
+
+    // アプリ専用の書き込み可能なディレクトリ
+    jstring jstr = reinterpret_cast<jstring>(env->CallStaticObjectMethod(g_JniBridgeJavaClass, g_GetFilesDirMethodId));
+    if (!jstr)
+    {
+        return Csm::csmString();
+    }
+
+    const char* chars = env->GetStringUTFChars(jstr, nullptr);
+    Csm::csmString path(chars);
+    env->ReleaseStringUTFChars(jstr, chars);
+    env->DeleteLocalRef(jstr);
+
+    return path;
+}
+
 void JniBridgeC::MoveTaskToBack()
 {
     JNIEnv *env = GetEnv();
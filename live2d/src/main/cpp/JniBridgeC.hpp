@@ -25,6 +25,11 @@ public:
     */
     static char* LoadFileAsBytesFromJava(const char* filePath, unsigned int* outSize);
 
+    /**
+    * @brief 앱 전용 파일 디렉터리 경로 가져오기
+    */
+    static Csm::csmString GetFilesDir();
+
     /**
     * @brief 앱을 백그라운드로 이동
     */
@@ -0,0 +1,328 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppAllocationTracker.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unwind.h>
+#include <dlfcn.h>
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+namespace {
+    const csmUint32 SiteCapacity = 4096;        // 呼び出し位置のハッシュテーブルのサイズ。2の累乗
+    const csmUint32 BacktraceDepth = 24;        // ログに出力するバックトレースの段数
+
+    struct BacktraceState
+    {
+        void** Current;
+        void** End;
+    };
+
+    _Unwind_Reason_Code UnwindCallback(struct _Unwind_Context* context, void* argument)
+    {
+        BacktraceState* state = static_cast<BacktraceState*>(argument);
+        const uintptr_t pc = _Unwind_GetIP(context);
+
+        if (pc != 0)
+        {
+            if (state->Current == state->End)
+            {
+                return _URC_END_OF_STACK;
+            }
+            *state->Current++ = reinterpret_cast<void*>(pc);
+        }
+
+        return _URC_NO_REASON;
+    }
+
+    void PrintBacktrace()
+    {
+        void* frames[BacktraceDepth];
+        BacktraceState state = { frames, frames + BacktraceDepth };
+        _Unwind_Backtrace(UnwindCallback, &state);
+
+        const csmUint32 count = static_cast<csmUint32>(state.Current - frames);
+        for (csmUint32 i = 0; i < count; ++i)
+        {
+            Dl_info info;
+            if (dladdr(frames[i], &info) && info.dli_sname != NULL)
+            {
+                LAppPal::PrintLogLn("[APP]  #%02u %p %s+%lu", i, frames[i], info.dli_sname,
+                    static_cast<unsigned long>(reinterpret_cast<uintptr_t>(frames[i]) - reinterpret_cast<uintptr_t>(info.dli_saddr)));
+            }
+            else
+            {
+                LAppPal::PrintLogLn("[APP]  #%02u %p %s", i, frames[i], (info.dli_fname != NULL) ? info.dli_fname : "?");
+            }
+        }
+    }
+
+    csmUint32 HashLocation(const csmChar* fileName, csmInt32 lineNumber)
+    {
+        // __FILE__は翻訳単位ごとに別のアドレスになることがあるため、文字列の内容からハッシュを作る
+        csmUint32 hash = 2166136261u ^ static_cast<csmUint32>(lineNumber);
+
+        if (fileName != NULL)
+        {
+            for (const csmChar* c = fileName; *c != '\0'; ++c)
+            {
+                hash = (hash ^ static_cast<csmUint8>(*c)) * 16777619u;
+            }
+        }
+
+        return hash;
+    }
+
+    csmBool IsSameLocation(const csmChar* fileName, const csmChar* otherFileName)
+    {
+        if (fileName == otherFileName)
+        {
+            return true;
+        }
+
+        return fileName != NULL && otherFileName != NULL && strcmp(fileName, otherFileName) == 0;
+    }
+
+    int CompareSites(const void* a, const void* b)
+    {
+        const LAppAllocationTracker::SiteStatistics* lhs = static_cast<const LAppAllocationTracker::SiteStatistics*>(a);
+        const LAppAllocationTracker::SiteStatistics* rhs = static_cast<const LAppAllocationTracker::SiteStatistics*>(b);
+
+        if (lhs->AllocationCount != rhs->AllocationCount)
+        {
+            return (lhs->AllocationCount > rhs->AllocationCount) ? -1 : 1;
+        }
+        if (lhs->ByteCount != rhs->ByteCount)
+        {
+            return (lhs->ByteCount > rhs->ByteCount) ? -1 : 1;
+        }
+        return 0;
+    }
+}
+
+LAppAllocationTracker::LAppAllocationTracker(ICubismAllocator& allocator)
+    : _allocator(allocator)
+    , _siteCount(0)
+    , _frameCount(0)
+    , _warmUpFrameCount(0)
+    , _abortOnViolation(false)
+{
+    // 集計用のテーブルはFrameworkのアロケータを通さずに確保する
+    _sites = static_cast<SiteStatistics*>(calloc(SiteCapacity, sizeof(SiteStatistics)));
+
+    _frameAllocationCount.store(0);
+    _violationCount.store(0);
+    _guardDepth.store(0);
+    _guardName.store(NULL);
+    _isArmed.store(false);
+}
+
+LAppAllocationTracker::~LAppAllocationTracker()
+{
+    free(_sites);
+}
+
+void* LAppAllocationTracker::Allocate(const csmSizeType size)
+{
+    Record(size, NULL, 0);
+    return _allocator.Allocate(size);
+}
+
+void LAppAllocationTracker::Deallocate(void* memory)
+{
+    _allocator.Deallocate(memory);
+}
+
+void* LAppAllocationTracker::AllocateAligned(const csmSizeType size, const csmUint32 alignment)
+{
+    Record(size, NULL, 0);
+    return _allocator.AllocateAligned(size, alignment);
+}
+
+void LAppAllocationTracker::DeallocateAligned(void* alignedMemory)
+{
+    _allocator.DeallocateAligned(alignedMemory);
+}
+
+void* LAppAllocationTracker::AllocateWithLocation(const csmSizeType size, const csmChar* fileName, csmInt32 lineNumber)
+{
+    Record(size, fileName, lineNumber);
+    return _allocator.AllocateWithLocation(size, fileName, lineNumber);
+}
+
+void* LAppAllocationTracker::AllocateAlignedWithLocation(const csmSizeType size, const csmUint32 alignment, const csmChar* fileName, csmInt32 lineNumber)
+{
+    Record(size, fileName, lineNumber);
+    return _allocator.AllocateAlignedWithLocation(size, alignment, fileName, lineNumber);
+}
+
+void LAppAllocationTracker::BeginFrame()
+{
+    _frameAllocationCount.store(0, std::memory_order_relaxed);
+
+    if (_frameCount < _warmUpFrameCount)
+    {
+        _frameCount++;
+        return;
+    }
+
+    _isArmed.store(true, std::memory_order_relaxed);
+}
+
+void LAppAllocationTracker::ResetWarmUp()
+{
+    _frameCount = 0;
+    _isArmed.store(false, std::memory_order_relaxed);
+}
+
+void LAppAllocationTracker::Record(csmSizeType size, const csmChar* fileName, csmInt32 lineNumber)
+{
+    _frameAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    const csmBool isViolation = _guardDepth.load(std::memory_order_relaxed) > 0 && _isArmed.load(std::memory_order_relaxed);
+    csmBool isFirstViolation = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        SiteStatistics* site = FindSite(fileName, lineNumber);
+        site->AllocationCount++;
+        site->ByteCount += size;
+
+        if (isViolation)
+        {
+            isFirstViolation = (site->ViolationCount == 0);
+            site->ViolationCount++;
+        }
+    }
+
+    if (!isViolation)
+    {
+        return;
+    }
+
+    _violationCount.fetch_add(1, std::memory_order_relaxed);
+
+    // ログはロックの外で出力する。バックトレースは呼び出し位置ごとに最初の1回だけ出す
+    const csmChar* scopeName = _guardName.load(std::memory_order_relaxed);
+    LAppPal::PrintLogLn("[APP]allocation in %s: %lu bytes at %s(%d)",
+        (scopeName != NULL) ? scopeName : "guarded scope",
+        static_cast<unsigned long>(size),
+        (fileName != NULL) ? fileName : "(unknown)", lineNumber);
+
+    if (isFirstViolation || _abortOnViolation)
+    {
+        PrintBacktrace();
+    }
+
+    if (_abortOnViolation)
+    {
+        abort();
+    }
+}
+
+LAppAllocationTracker::SiteStatistics* LAppAllocationTracker::FindSite(const csmChar* fileName, csmInt32 lineNumber)
+{
+    const csmUint32 mask = SiteCapacity - 1;
+    csmUint32 index = HashLocation(fileName, lineNumber) & mask;
+
+    while (true)
+    {
+        SiteStatistics& site = _sites[index];
+
+        if (site.AllocationCount == 0)
+        {
+            // 空きスロットを残すため、テーブルの半分を超えた新しい呼び出し位置は(unknown)にまとめる
+            if (_siteCount >= SiteCapacity / 2 && (fileName != NULL || lineNumber != 0))
+            {
+                return FindSite(NULL, 0);
+            }
+
+            site.FileName = fileName;
+            site.LineNumber = lineNumber;
+            _siteCount++;
+            return &site;
+        }
+
+        if (site.LineNumber == lineNumber && IsSameLocation(site.FileName, fileName))
+        {
+            return &site;
+        }
+
+        index = (index + 1) & mask;
+    }
+}
+
+void LAppAllocationTracker::EnterGuard(const csmChar* scopeName)
+{
+    if (_guardDepth.fetch_add(1, std::memory_order_relaxed) == 0)
+    {
+        _guardName.store(scopeName, std::memory_order_relaxed);
+    }
+}
+
+void LAppAllocationTracker::LeaveGuard()
+{
+    _guardDepth.fetch_sub(1, std::memory_order_relaxed);
+}
+
+csmUint32 LAppAllocationTracker::GetSiteCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _siteCount;
+}
+
+csmUint32 LAppAllocationTracker::GetTopSites(SiteStatistics* sites, csmUint32 maxCount) const
+{
+    SiteStatistics* sorted = static_cast<SiteStatistics*>(malloc(sizeof(SiteStatistics) * SiteCapacity));
+    csmUint32 count = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (csmUint32 i = 0; i < SiteCapacity; ++i)
+        {
+            if (_sites[i].AllocationCount != 0)
+            {
+                sorted[count++] = _sites[i];
+            }
+        }
+    }
+
+    qsort(sorted, count, sizeof(SiteStatistics), CompareSites);
+
+    if (count > maxCount)
+    {
+        count = maxCount;
+    }
+    memcpy(sites, sorted, sizeof(SiteStatistics) * count);
+    free(sorted);
+
+    return count;
+}
+
+void LAppAllocationTracker::PrintReport(csmUint32 topCount) const
+{
+    SiteStatistics* sites = static_cast<SiteStatistics*>(malloc(sizeof(SiteStatistics) * topCount));
+    const csmUint32 count = GetTopSites(sites, topCount);
+
+    LAppPal::PrintLogLn("[APP]allocation report: %u sites, %lu violations",
+        GetSiteCount(), static_cast<unsigned long>(GetViolationCount()));
+
+    for (csmUint32 i = 0; i < count; ++i)
+    {
+        LAppPal::PrintLogLn("[APP]%3u: %8lu allocs %10lu bytes %6lu in guard  %s(%d)", i + 1,
+            static_cast<unsigned long>(sites[i].AllocationCount),
+            static_cast<unsigned long>(sites[i].ByteCount),
+            static_cast<unsigned long>(sites[i].ViolationCount),
+            (sites[i].FileName != NULL) ? sites[i].FileName : "(unknown)", sites[i].LineNumber);
+    }
+
+    free(sites);
+}
@@ -0,0 +1,216 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * 이 소스 코드의 사용은 Live2D 오픈 소프트웨어 라이선스에 의해 관리됩니다.
+ * 라이선스는 https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html 에서 확인할 수 있습니다.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <ICubismAllocator.hpp>
+#include <atomic>
+#include <mutex>
+
+/**
+* @brief 할당을 호출 위치별로 집계하는 할당자 래퍼.
+*
+* 실제 할당은 생성자에 전달한 할당자에 위임합니다.
+* 호출 위치(파일 이름과 줄 번호)는 CSM_DEBUG_MEMORY_LEAKING이 정의된 경우에만 전달되며,
+* 정의되지 않은 경우 모든 할당은 "(unknown)" 위치로 집계됩니다.
+*
+* GuardScope로 지정한 범위 안에서 워밍업 이후에 할당이 발생하면 위반으로 기록하고,
+* 호출 위치와 백트레이스를 로그에 출력합니다. 범위는 모든 스레드에 적용되므로
+* 잡 시스템의 워커에서 발생한 할당도 검출됩니다.
+*
+*/
+class LAppAllocationTracker : public Csm::ICubismAllocator
+{
+public:
+    /**
+    * @brief 호출 위치별 통계.
+    */
+    struct SiteStatistics
+    {
+        const Csm::csmChar* FileName;           ///< 파일 이름. 알 수 없으면 NULL
+        Csm::csmInt32 LineNumber;               ///< 줄 번호
+        Csm::csmSizeType AllocationCount;       ///< 누적 할당 횟수
+        Csm::csmSizeType ByteCount;             ///< 누적 할당 바이트 수
+        Csm::csmSizeType ViolationCount;        ///< GuardScope 안에서 할당한 횟수
+    };
+
+    /**
+    * @brief 범위 안에서의 할당을 위반으로 기록하는 클래스.
+    */
+    class GuardScope
+    {
+    public:
+        /**
+        * @brief 생성자.
+        *
+        * @param[in]   tracker      할당 추적기. NULL이면 아무것도 하지 않습니다.
+        * @param[in]   scopeName    로그에 출력할 범위 이름
+        */
+        GuardScope(LAppAllocationTracker* tracker, const Csm::csmChar* scopeName)
+            : _tracker(tracker)
+        {
+            if (_tracker != NULL)
+            {
+                _tracker->EnterGuard(scopeName);
+            }
+        }
+
+        /**
+        * @brief 소멸자.
+        */
+        ~GuardScope()
+        {
+            if (_tracker != NULL)
+            {
+                _tracker->LeaveGuard();
+            }
+        }
+
+    private:
+        GuardScope(const GuardScope&);
+        GuardScope& operator=(const GuardScope&);
+
+        LAppAllocationTracker* _tracker;        ///< 할당 추적기
+    };
+
+    /**
+    * @brief 생성자.
+    *
+    * @param[in]   allocator    할당을 위임할 할당자
+    */
+    explicit LAppAllocationTracker(Csm::ICubismAllocator& allocator);
+
+    /**
+    * @brief 소멸자.
+    */
+    virtual ~LAppAllocationTracker();
+
+    /**
+    * @brief 메모리 영역을 할당합니다.
+    */
+    void* Allocate(const Csm::csmSizeType size);
+
+    /**
+    * @brief 메모리 영역을 해제합니다.
+    */
+    void Deallocate(void* memory);
+
+    /**
+    * @brief 정렬된 메모리 영역을 할당합니다.
+    */
+    void* AllocateAligned(const Csm::csmSizeType size, const Csm::csmUint32 alignment);
+
+    /**
+    * @brief 정렬된 메모리 영역을 해제합니다.
+    */
+    void DeallocateAligned(void* alignedMemory);
+
+    /**
+    * @brief 호출 위치와 함께 메모리 영역을 할당합니다.
+    */
+    void* AllocateWithLocation(const Csm::csmSizeType size, const Csm::csmChar* fileName, Csm::csmInt32 lineNumber);
+
+    /**
+    * @brief 호출 위치와 함께 정렬된 메모리 영역을 할당합니다.
+    */
+    void* AllocateAlignedWithLocation(const Csm::csmSizeType size, const Csm::csmUint32 alignment, const Csm::csmChar* fileName, Csm::csmInt32 lineNumber);
+
+    /**
+    * @brief 프레임의 시작을 알립니다. 워밍업 프레임 수를 지나면 GuardScope가 유효해집니다.
+    */
+    void BeginFrame();
+
+    /**
+    * @brief 워밍업을 처음부터 다시 시작합니다. 모델을 교체한 후 등에 호출합니다.
+    */
+    void ResetWarmUp();
+
+    /**
+    * @brief 워밍업 프레임 수를 설정합니다.
+    *
+    * @param[in]   frameCount    GuardScope를 유효화할 때까지의 프레임 수
+    */
+    void SetWarmUpFrameCount(Csm::csmUint32 frameCount) { _warmUpFrameCount = frameCount; }
+
+    /**
+    * @brief 위반 시 프로세스를 중단할지 설정합니다.
+    *
+    * @param[in]   abortOnViolation    true이면 위반을 로그에 출력한 후 abort()합니다.
+    */
+    void SetAbortOnViolation(Csm::csmBool abortOnViolation) { _abortOnViolation = abortOnViolation; }
+
+    /**
+    * @brief 누적 위반 횟수를 가져옵니다.
+    */
+    Csm::csmSizeType GetViolationCount() const { return _violationCount.load(std::memory_order_relaxed); }
+
+    /**
+    * @brief 마지막 BeginFrame 이후의 할당 횟수를 가져옵니다.
+    */
+    Csm::csmSizeType GetFrameAllocationCount() const { return _frameAllocationCount.load(std::memory_order_relaxed); }
+
+    /**
+    * @brief 집계한 호출 위치 수를 가져옵니다.
+    */
+    Csm::csmUint32 GetSiteCount() const;
+
+    /**
+    * @brief 할당 횟수가 많은 순으로 호출 위치의 통계를 가져옵니다.
+    *
+    * @param[out]  sites        통계를 쓸 배열
+    * @param[in]   maxCount     배열의 요소 수
+    * @return  쓴 요소 수
+    */
+    Csm::csmUint32 GetTopSites(SiteStatistics* sites, Csm::csmUint32 maxCount) const;
+
+    /**
+    * @brief 할당 횟수가 많은 순으로 상위 호출 위치를 로그에 출력합니다.
+    *
+    * @param[in]   topCount    출력할 호출 위치 수
+    */
+    void PrintReport(Csm::csmUint32 topCount) const;
+
+private:
+    LAppAllocationTracker(const LAppAllocationTracker&);
+    LAppAllocationTracker& operator=(const LAppAllocationTracker&);
+
+    /**
+    * @brief 할당을 집계하고, GuardScope 안이면 위반으로 기록합니다.
+    */
+    void Record(Csm::csmSizeType size, const Csm::csmChar* fileName, Csm::csmInt32 lineNumber);
+
+    /**
+    * @brief 호출 위치의 통계를 찾습니다. 없으면 추가합니다. _mutex를 잠근 상태에서 호출합니다.
+    */
+    SiteStatistics* FindSite(const Csm::csmChar* fileName, Csm::csmInt32 lineNumber);
+
+    /**
+    * @brief GuardScope에 들어갑니다.
+    */
+    void EnterGuard(const Csm::csmChar* scopeName);
+
+    /**
+    * @brief GuardScope에서 나옵니다.
+    */
+    void LeaveGuard();
+
+    Csm::ICubismAllocator& _allocator;                      ///< 할당을 위임할 할당자
+
+    mutable std::mutex _mutex;                              ///< _sites를 보호하는 뮤텍스
+    SiteStatistics* _sites;                                 ///< 호출 위치별 통계의 해시 테이블
+    Csm::csmUint32 _siteCount;                              ///< 집계한 호출 위치 수
+
+    std::atomic<Csm::csmSizeType> _frameAllocationCount;    ///< 마지막 BeginFrame 이후의 할당 횟수
+    std::atomic<Csm::csmSizeType> _violationCount;          ///< 누적 위반 횟수
+    std::atomic<Csm::csmInt32> _guardDepth;                 ///< 들어가 있는 GuardScope 수
+    std::atomic<const Csm::csmChar*> _guardName;            ///< 가장 바깥쪽 GuardScope의 이름
+    Csm::csmUint32 _frameCount;                             ///< 워밍업 시작 이후의 프레임 수
+    Csm::csmUint32 _warmUpFrameCount;                       ///< 워밍업 프레임 수
+    std::atomic<Csm::csmBool> _isArmed;                     ///< 워밍업이 끝났는지
+    Csm::csmBool _abortOnViolation;                         ///< 위반 시 abort()할지
+};
@@ -6,49 +6,743 @@
  */
 
 #include "LAppAllocator.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include "LAppPal.hpp"
 
 using namespace Csm;
 
-void* LAppAllocator::Allocate(const csmSizeType  size)
+namespace {
+    const csmSizeType HeaderSize = 16;                  // ブロック先頭のヘッダ領域。ユーザー領域の16バイト境界を保つ
+    const csmSizeType SpanSize = 64 * 1024;             // プールがシステムから確保する単位
+    const csmSizeType FrameChunkSize = 64 * 1024;       // フレームアリーナのチャンクの最小サイズ
+    const csmSizeType FrameChunkHeaderSize = 32;        // チャンク先頭の管理領域
+    const csmUint32 CacheCapacity = 32;                 // スレッドキャッシュが保持するクラス毎のブロック数
+    const csmUint32 CacheBatchCount = 16;               // キャッシュとプールの間で一度に移すブロック数
+    const csmUint32 LargeSizeClass = 0xFFFFFFFFu;       // 専用領域のブロックを表すサイズクラス
+
+    const csmUint32 BlockSizes[LAppAllocator::SizeClassCount] =
+    {
+        16, 32, 48, 64, 80, 96, 112, 128,
+        160, 192, 224, 256,
+        320, 384, 448, 512,
+    };
+
+    // ユーザー領域の直前に置くヘッダ
+    struct BlockHeader
+    {
+        void* Origin;           // プールのブロックは所属するスパン、専用領域のブロックは確保した先頭アドレス
+        csmUint32 SizeClass;    // サイズクラス。専用領域ならLargeSizeClass
+        csmUint32 Size;         // ブロックのサイズ
+    };
+
+    BlockHeader* GetHeader(void* memory)
+    {
+        return reinterpret_cast<BlockHeader*>(memory) - 1;
+    }
+
+    csmSizeType RoundUp(csmSizeType value, csmSizeType alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void* AllocateSystem(csmSizeType size, csmSizeType alignment)
+    {
+        void* memory = NULL;
+
+        if (posix_memalign(&memory, alignment, size) != 0)
+        {
+            return NULL;
+        }
+
+        return memory;
+    }
+
+    void UpdatePeak(std::atomic<csmSizeType>& peak, csmSizeType value)
+    {
+        csmSizeType current = peak.load(std::memory_order_relaxed);
+
+        while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // スレッドキャッシュの登録を保護する
+    std::mutex s_cacheRegistryMutex;
+}
+
+struct LAppAllocator::Span
+{
+    Span* Next;                 // プールの全スパンのリスト
+    Span* Prev;
+    Span* NextPartial;          // 空きブロックのあるスパンのリスト
+    Span* PrevPartial;
+    void* FreeList;             // 返却されたブロックのリスト
+    csmUint32 SizeClass;        // サイズクラス
+    csmUint32 UsedCount;        // プール外に出ているブロック数
+    csmUint32 CarvedCount;      // 切り出し済みのブロック数
+    csmBool IsPartial;          // 空きブロックのあるスパンのリストに入っているか
+};
+
+struct LAppAllocator::ThreadCache
+{
+    ~ThreadCache()
+    {
+        // スレッド終了時にキャッシュのブロックを所有者のプールへ返す
+        std::lock_guard<std::mutex> lock(s_cacheRegistryMutex);
+
+        if (Owner != NULL)
+        {
+            Owner->FlushThreadCache(this);
+            Owner = NULL;
+        }
+        Unlink();
+    }
+
+    void Unlink()
+    {
+        if (Prev != NULL)
+        {
+            Prev->Next = Next;
+        }
+        else if (s_head == this)
+        {
+            s_head = Next;
+        }
+
+        if (Next != NULL)
+        {
+            Next->Prev = Prev;
+        }
+
+        Next = NULL;
+        Prev = NULL;
+    }
+
+    void Link()
+    {
+        Prev = NULL;
+        Next = s_head;
+        if (s_head != NULL)
+        {
+            s_head->Prev = this;
+        }
+        s_head = this;
+    }
+
+    static ThreadCache* s_head;                     // 登録されたキャッシュのリスト
+
+    LAppAllocator* Owner;                           // キャッシュのブロックを確保したアロケータ
+    ThreadCache* Next;
+    ThreadCache* Prev;
+    csmUint32 Counts[SizeClassCount];               // クラス毎の保持数
+    void* Blocks[SizeClassCount][CacheCapacity];    // クラス毎の保持ブロック
+};
+
+LAppAllocator::ThreadCache* LAppAllocator::ThreadCache::s_head = NULL;
+
+struct LAppAllocator::FrameChunk
+{
+    FrameChunk* Next;
+    csmSizeType Capacity;       // データ領域のバイト数
+    csmSizeType Used;           // データ領域の使用バイト数
+};
+
+LAppAllocator::LAppAllocator()
+    : _frameChunks(NULL)
+    , _frameCurrent(NULL)
+    , _frameTotalUsed(0)
+    , _frameReserved(0)
+    , _framePeak(0)
 {
-    return malloc(size);
+    for (csmUint32 i = 0; i < SizeClassCount; ++i)
+    {
+        Pool& pool = _pools[i];
+        pool.Spans = NULL;
+        pool.PartialSpans = NULL;
+        pool.EmptySpan = NULL;
+        pool.BlockSize = BlockSizes[i];
+        pool.BlocksPerSpan = static_cast<csmUint32>((SpanSize - RoundUp(sizeof(Span), HeaderSize)) / (HeaderSize + BlockSizes[i]));
+        pool.SpanCount.store(0);
+        pool.UsedBlockCount.store(0);
+        pool.PeakUsedBlockCount.store(0);
+        pool.AllocationCount.store(0);
+        pool.ReleasedSpanCount.store(0);
+    }
+
+    _largeBlockCount.store(0);
+    _largeByteCount.store(0);
+    _largePeakByteCount.store(0);
+    _largeAllocationCount.store(0);
+}
+
+LAppAllocator::~LAppAllocator()
+{
+    {
+        // 他スレッドのキャッシュが指すスパンはこの後解放するため、所有者を外して中身を捨てる
+        std::lock_guard<std::mutex> lock(s_cacheRegistryMutex);
+
+        ThreadCache* cache = ThreadCache::s_head;
+        while (cache != NULL)
+        {
+            ThreadCache* next = cache->Next;
+            if (cache->Owner == this)
+            {
+                cache->Owner = NULL;
+                memset(cache->Counts, 0, sizeof(cache->Counts));
+                cache->Unlink();
+            }
+            cache = next;
+        }
+    }
+
+    for (csmUint32 i = 0; i < SizeClassCount; ++i)
+    {
+        Span* span = _pools[i].Spans;
+        while (span != NULL)
+        {
+            Span* next = span->Next;
+            free(span);
+            span = next;
+        }
+    }
+
+    FrameChunk* chunk = _frameChunks;
+    while (chunk != NULL)
+    {
+        FrameChunk* next = chunk->Next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+csmUint32 LAppAllocator::GetSizeClass(csmSizeType size)
+{
+    if (size <= 128)
+    {
+        return (size == 0) ? 0 : static_cast<csmUint32>((size - 1) / 16);
+    }
+
+    if (size <= 256)
+    {
+        return 8 + static_cast<csmUint32>((size - 129) / 32);
+    }
+
+    return 12 + static_cast<csmUint32>((size - 257) / 64);
+}
+
+void* LAppAllocator::Allocate(const csmSizeType size)
+{
+    if (size > SmallBlockMaxSize)
+    {
+        return AllocateLarge(size, HeaderSize);
+    }
+
+    return AllocateSmall(GetSizeClass(size));
 }
 
 void LAppAllocator::Deallocate(void* memory)
 {
-    free(memory);
+    if (memory == NULL)
+    {
+        return;
+    }
+
+    BlockHeader* header = GetHeader(memory);
+
+    if (header->SizeClass == LargeSizeClass)
+    {
+        _largeBlockCount.fetch_sub(1, std::memory_order_relaxed);
+        _largeByteCount.fetch_sub(header->Size, std::memory_order_relaxed);
+        free(header->Origin);
+        return;
+    }
+
+    const csmUint32 sizeClass = header->SizeClass;
+    ThreadCache* cache = GetThreadCache();
+    csmUint32& count = cache->Counts[sizeClass];
+    void** blocks = cache->Blocks[sizeClass];
+
+    if (count == CacheCapacity)
+    {
+        // 古い方からまとめてプールに返し、最近使ったブロックをキャッシュに残す
+        Pool& pool = _pools[sizeClass];
+        {
+            std::lock_guard<std::mutex> lock(pool.Mutex);
+            for (csmUint32 i = 0; i < CacheBatchCount; ++i)
+            {
+                ReturnBlock(pool, blocks[i]);
+            }
+        }
+        pool.UsedBlockCount.fetch_sub(CacheBatchCount, std::memory_order_relaxed);
+
+        memmove(blocks, blocks + CacheBatchCount, sizeof(void*) * (CacheCapacity - CacheBatchCount));
+        count -= CacheBatchCount;
+    }
+
+    blocks[count++] = memory;
 }
 
 void* LAppAllocator::AllocateAligned(const csmSizeType size, const csmUint32 alignment)
 {
-    size_t offset, shift, alignedAddress;
-    void* allocation;
-    void** preamble;
+    if (alignment <= HeaderSize && size <= SmallBlockMaxSize)
+    {
+        return AllocateSmall(GetSizeClass(size));
+    }
 
-    offset = alignment - 1 + sizeof(void*);
+    return AllocateLarge(size, alignment);
+}
 
-    allocation = Allocate(size + static_cast<csmUint32>(offset));
+void LAppAllocator::DeallocateAligned(void* alignedMemory)
+{
+    Deallocate(alignedMemory);
+}
 
-    alignedAddress = reinterpret_cast<size_t>(allocation) + sizeof(void*);
+void* LAppAllocator::AllocateSmall(csmUint32 sizeClass)
+{
+    Pool& pool = _pools[sizeClass];
+    ThreadCache* cache = GetThreadCache();
+    csmUint32& count = cache->Counts[sizeClass];
 
-    shift = alignedAddress % alignment;
+    if (count == 0)
+    {
+        std::lock_guard<std::mutex> lock(pool.Mutex);
+        RefillCache(pool, sizeClass, cache->Blocks[sizeClass], count, CacheBatchCount);
+
+        if (count == 0)
+        {
+            return NULL;
+        }
+    }
+
+    pool.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    return cache->Blocks[sizeClass][--count];
+}
 
-    if (shift)
+void* LAppAllocator::AllocateLarge(csmSizeType size, csmSizeType alignment)
+{
+    // ヘッダを置くため、ユーザー領域の前にアライメント分の余白を取る
+    const csmSizeType prefix = (alignment > HeaderSize) ? alignment : HeaderSize;
+    csmByte* base = static_cast<csmByte*>(AllocateSystem(prefix + size, prefix));
+
+    if (base == NULL)
     {
-        alignedAddress += (alignment - shift);
+        return NULL;
     }
 
-    preamble = reinterpret_cast<void**>(alignedAddress);
-    preamble[-1] = allocation;
+    void* memory = base + prefix;
+    BlockHeader* header = GetHeader(memory);
+    header->Origin = base;
+    header->SizeClass = LargeSizeClass;
+    header->Size = static_cast<csmUint32>(size);
+
+    _largeAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    _largeBlockCount.fetch_add(1, std::memory_order_relaxed);
+    UpdatePeak(_largePeakByteCount, _largeByteCount.fetch_add(size, std::memory_order_relaxed) + size);
 
-    return reinterpret_cast<void*>(alignedAddress);
+    return memory;
 }
 
-void LAppAllocator::DeallocateAligned(void* alignedMemory)
+LAppAllocator::ThreadCache* LAppAllocator::GetThreadCache()
+{
+    static thread_local ThreadCache cache;
+
+    if (cache.Owner != this)
+    {
+        std::lock_guard<std::mutex> lock(s_cacheRegistryMutex);
+
+        if (cache.Owner != NULL)
+        {
+            cache.Owner->FlushThreadCache(&cache);
+        }
+        else
+        {
+            cache.Link();
+        }
+        cache.Owner = this;
+    }
+
+    return &cache;
+}
+
+void LAppAllocator::RefillCache(Pool& pool, csmUint32 sizeClass, void** blocks, csmUint32& count, csmUint32 refillCount)
+{
+    const csmSizeType stride = HeaderSize + pool.BlockSize;
+    csmUint32 taken = 0;
+
+    while (taken < refillCount)
+    {
+        Span* span = pool.PartialSpans;
+
+        if (span == NULL)
+        {
+            if (pool.EmptySpan != NULL)
+            {
+                span = pool.EmptySpan;
+                pool.EmptySpan = NULL;
+            }
+            else
+            {
+                span = static_cast<Span*>(AllocateSystem(SpanSize, HeaderSize));
+                if (span == NULL)
+                {
+                    break;
+                }
+
+                span->SizeClass = sizeClass;
+                span->UsedCount = 0;
+                span->CarvedCount = 0;
+                span->FreeList = NULL;
+                span->Prev = NULL;
+                span->Next = pool.Spans;
+                if (pool.Spans != NULL)
+                {
+                    pool.Spans->Prev = span;
+                }
+                pool.Spans = span;
+                pool.SpanCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            span->PrevPartial = NULL;
+            span->NextPartial = NULL;
+            span->IsPartial = true;
+            pool.PartialSpans = span;
+        }
+
+        while (taken < refillCount && span->UsedCount < pool.BlocksPerSpan)
+        {
+            void* block;
+
+            if (span->FreeList != NULL)
+            {
+                block = span->FreeList;
+                span->FreeList = *static_cast<void**>(block);
+            }
+            else
+            {
+                // まだ使っていない領域から切り出す
+                csmByte* slot = reinterpret_cast<csmByte*>(span) + RoundUp(sizeof(Span), HeaderSize) + stride * span->CarvedCount;
+                block = slot + HeaderSize;
+
+                BlockHeader* header = GetHeader(block);
+                header->Origin = span;
+                header->SizeClass = sizeClass;
+                header->Size = pool.BlockSize;
+
+                span->CarvedCount++;
+            }
+
+            span->UsedCount++;
+            blocks[count++] = block;
+            taken++;
+        }
+
+        if (span->UsedCount == pool.BlocksPerSpan)
+        {
+            // 使い切ったスパンはリストから外す
+            pool.PartialSpans = span->NextPartial;
+            if (pool.PartialSpans != NULL)
+            {
+                pool.PartialSpans->PrevPartial = NULL;
+            }
+            span->IsPartial = false;
+        }
+    }
+
+    AddUsedBlocks(pool, taken);
+}
+
+void LAppAllocator::ReturnBlock(Pool& pool, void* block)
+{
+    Span* span = static_cast<Span*>(GetHeader(block)->Origin);
+
+    *static_cast<void**>(block) = span->FreeList;
+    span->FreeList = block;
+    span->UsedCount--;
+
+    if (span->UsedCount > 0)
+    {
+        if (!span->IsPartial)
+        {
+            span->PrevPartial = NULL;
+            span->NextPartial = pool.PartialSpans;
+            if (pool.PartialSpans != NULL)
+            {
+                pool.PartialSpans->PrevPartial = span;
+            }
+            pool.PartialSpans = span;
+            span->IsPartial = true;
+        }
+        return;
+    }
+
+    // 空になったスパンはリストから外し、1つだけ再利用のために残して残りはシステムに返す
+    if (span->IsPartial)
+    {
+        if (span->PrevPartial != NULL)
+        {
+            span->PrevPartial->NextPartial = span->NextPartial;
+        }
+        else
+        {
+            pool.PartialSpans = span->NextPartial;
+        }
+        if (span->NextPartial != NULL)
+        {
+            span->NextPartial->PrevPartial = span->PrevPartial;
+        }
+        span->IsPartial = false;
+    }
+
+    if (pool.EmptySpan == NULL)
+    {
+        span->FreeList = NULL;
+        span->CarvedCount = 0;
+        pool.EmptySpan = span;
+        return;
+    }
+
+    if (span->Prev != NULL)
+    {
+        span->Prev->Next = span->Next;
+    }
+    else
+    {
+        pool.Spans = span->Next;
+    }
+    if (span->Next != NULL)
+    {
+        span->Next->Prev = span->Prev;
+    }
+
+    free(span);
+    pool.SpanCount.fetch_sub(1, std::memory_order_relaxed);
+    pool.ReleasedSpanCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LAppAllocator::FlushThreadCache(ThreadCache* cache)
 {
-    void** preamble;
+    for (csmUint32 i = 0; i < SizeClassCount; ++i)
+    {
+        const csmUint32 count = cache->Counts[i];
+
+        if (count == 0)
+        {
+            continue;
+        }
+
+        Pool& pool = _pools[i];
+        {
+            std::lock_guard<std::mutex> lock(pool.Mutex);
+            for (csmUint32 j = 0; j < count; ++j)
+            {
+                ReturnBlock(pool, cache->Blocks[i][j]);
+            }
+        }
+        pool.UsedBlockCount.fetch_sub(count, std::memory_order_relaxed);
+        cache->Counts[i] = 0;
+    }
+}
+
+void LAppAllocator::AddUsedBlocks(Pool& pool, csmSizeType count)
+{
+    UpdatePeak(pool.PeakUsedBlockCount, pool.UsedBlockCount.fetch_add(count, std::memory_order_relaxed) + count);
+}
+
+void* LAppAllocator::AllocateFrame(csmSizeType size, csmUint32 alignment)
+{
+    if (alignment < sizeof(void*))
+    {
+        alignment = sizeof(void*);
+    }
+
+    FrameChunk* chunk = _frameCurrent;
+
+    while (true)
+    {
+        if (chunk != NULL)
+        {
+            csmByte* data = reinterpret_cast<csmByte*>(chunk) + FrameChunkHeaderSize;
+            const csmSizeType address = reinterpret_cast<csmSizeType>(data + chunk->Used);
+            const csmSizeType padding = RoundUp(address, alignment) - address;
+
+            if (chunk->Used + padding + size <= chunk->Capacity)
+            {
+                void* memory = data + chunk->Used + padding;
+
+                chunk->Used += padding + size;
+                _frameCurrent = chunk;
+                _frameTotalUsed += padding + size;
+                if (_framePeak < _frameTotalUsed)
+                {
+                    _framePeak = _frameTotalUsed;
+                }
+
+                return memory;
+            }
+        }
+
+        // 次のチャンクへ進む。足りなければ新しいチャンクを現在のチャンクの後ろに挿入する
+        FrameChunk* next = (chunk != NULL) ? chunk->Next : _frameChunks;
+
+        if (next == NULL || next->Capacity < size + alignment)
+        {
+            csmSizeType capacity = RoundUp(size + alignment, HeaderSize);
+            if (capacity < FrameChunkSize - FrameChunkHeaderSize)
+            {
+                capacity = FrameChunkSize - FrameChunkHeaderSize;
+            }
+
+            FrameChunk* inserted = static_cast<FrameChunk*>(AllocateSystem(FrameChunkHeaderSize + capacity, HeaderSize));
+            if (inserted == NULL)
+            {
+                return NULL;
+            }
+
+            inserted->Capacity = capacity;
+            inserted->Next = next;
+            if (chunk != NULL)
+            {
+                chunk->Next = inserted;
+            }
+            else
+            {
+                _frameChunks = inserted;
+            }
+            _frameReserved += capacity;
+            next = inserted;
+        }
+
+        next->Used = 0;
+        chunk = next;
+    }
+}
+
+LAppAllocator::FrameMarker LAppAllocator::GetFrameMarker() const
+{
+    FrameMarker marker;
+    marker.Chunk = _frameCurrent;
+    marker.Used = (_frameCurrent != NULL) ? _frameCurrent->Used : 0;
+    marker.TotalUsed = _frameTotalUsed;
+    return marker;
+}
+
+void LAppAllocator::RewindFrame(const FrameMarker& marker)
+{
+    _frameCurrent = static_cast<FrameChunk*>(marker.Chunk);
+    if (_frameCurrent != NULL)
+    {
+        _frameCurrent->Used = marker.Used;
+    }
+    _frameTotalUsed = marker.TotalUsed;
+}
+
+void LAppAllocator::Trim()
+{
+    FlushThreadCache(GetThreadCache());
+
+    for (csmUint32 i = 0; i < SizeClassCount; ++i)
+    {
+        Pool& pool = _pools[i];
+        std::lock_guard<std::mutex> lock(pool.Mutex);
+
+        Span* span = pool.EmptySpan;
+        if (span == NULL)
+        {
+            continue;
+        }
+
+        pool.EmptySpan = NULL;
+        if (span->Prev != NULL)
+        {
+            span->Prev->Next = span->Next;
+        }
+        else
+        {
+            pool.Spans = span->Next;
+        }
+        if (span->Next != NULL)
+        {
+            span->Next->Prev = span->Prev;
+        }
+
+        free(span);
+        pool.SpanCount.fetch_sub(1, std::memory_order_relaxed);
+        pool.ReleasedSpanCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 使用中の位置より後ろのチャンクを解放する
+    FrameChunk** link = (_frameCurrent != NULL) ? &_frameCurrent->Next : &_frameChunks;
+    while (*link != NULL)
+    {
+        FrameChunk* chunk = *link;
+        *link = chunk->Next;
+        _frameReserved -= chunk->Capacity;
+        free(chunk);
+    }
+}
+
+LAppAllocator::PoolStatistics LAppAllocator::GetPoolStatistics(csmUint32 sizeClass) const
+{
+    const Pool& pool = _pools[sizeClass];
+    PoolStatistics statistics;
+    statistics.BlockSize = pool.BlockSize;
+    statistics.SpanCount = pool.SpanCount.load(std::memory_order_relaxed);
+    statistics.UsedBlockCount = pool.UsedBlockCount.load(std::memory_order_relaxed);
+    statistics.PeakUsedBlockCount = pool.PeakUsedBlockCount.load(std::memory_order_relaxed);
+    statistics.AllocationCount = pool.AllocationCount.load(std::memory_order_relaxed);
+    statistics.ReleasedSpanCount = pool.ReleasedSpanCount.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+LAppAllocator::LargeStatistics LAppAllocator::GetLargeStatistics() const
+{
+    LargeStatistics statistics;
+    statistics.BlockCount = _largeBlockCount.load(std::memory_order_relaxed);
+    statistics.ByteCount = _largeByteCount.load(std::memory_order_relaxed);
+    statistics.PeakByteCount = _largePeakByteCount.load(std::memory_order_relaxed);
+    statistics.AllocationCount = _largeAllocationCount.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+LAppAllocator::FrameStatistics LAppAllocator::GetFrameStatistics() const
+{
+    FrameStatistics statistics;
+    statistics.ReservedByteCount = _frameReserved;
+    statistics.PeakByteCount = _framePeak;
+    return statistics;
+}
+
+void LAppAllocator::PrintStatistics() const
+{
+    for (csmUint32 i = 0; i < SizeClassCount; ++i)
+    {
+        const PoolStatistics pool = GetPoolStatistics(i);
+
+        if (pool.AllocationCount == 0)
+        {
+            continue;
+        }
+
+        LAppPal::PrintLogLn("[APP]pool %3lu: spans %lu used %lu peak %lu allocs %lu released %lu",
+            static_cast<unsigned long>(pool.BlockSize),
+            static_cast<unsigned long>(pool.SpanCount),
+            static_cast<unsigned long>(pool.UsedBlockCount),
+            static_cast<unsigned long>(pool.PeakUsedBlockCount),
+            static_cast<unsigned long>(pool.AllocationCount),
+            static_cast<unsigned long>(pool.ReleasedSpanCount));
+    }
 
-    preamble = static_cast<void**>(alignedMemory);
+    const LargeStatistics large = GetLargeStatistics();
+    LAppPal::PrintLogLn("[APP]large: blocks %lu bytes %lu peak %lu allocs %lu",
+        static_cast<unsigned long>(large.BlockCount),
+        static_cast<unsigned long>(large.ByteCount),
+        static_cast<unsigned long>(large.PeakByteCount),
+        static_cast<unsigned long>(large.AllocationCount));
 
-    Deallocate(preamble[-1]);
+    const FrameStatistics frame = GetFrameStatistics();
+    LAppPal::PrintLogLn("[APP]frame: reserved %lu peak %lu",
+        static_cast<unsigned long>(frame.ReservedByteCount),
+        static_cast<unsigned long>(frame.PeakByteCount));
 }
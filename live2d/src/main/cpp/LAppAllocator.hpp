@@ -9,6 +9,8 @@
 
 #include <CubismFramework.hpp>
 #include <ICubismAllocator.hpp>
+#include <atomic>
+#include <mutex>
 
 /**
 * @brief 메모리 할당을 구현하는 클래스.
@@ -16,9 +18,109 @@
 * 메모리 할당 및 해제 처리의 인터페이스 구현.
 * 프레임워크에서 호출됩니다.
 *
+* 작은 할당(SmallBlockMaxSize 이하)은 크기 클래스별 풀에서 할당합니다.
+* 풀은 스팬 단위로 메모리를 확보하고, 비어 있는 스팬은 시스템에 반환하므로
+* 모델 전환을 반복해도 단편화로 메모리 사용량이 계속 늘어나지 않습니다.
+* 각 스레드는 크기 클래스별로 작은 캐시를 가지며, 캐시에서 할당할 때는 잠금을 사용하지 않습니다.
+*
+* 큰 할당과 16바이트를 넘는 정렬이 필요한 할당(moc, 모델 등)은 풀과 분리된 전용 영역에서
+* 블록마다 시스템에서 확보하고, 해제 시 바로 시스템에 반환합니다.
+*
+* 프레임 아레나는 한 프레임 안에서만 사용하는 임시 메모리를 위한 것입니다.
+* FrameScope로 범위를 지정하면 범위를 벗어날 때 한꺼번에 되돌립니다. 메인 스레드에서만 사용합니다.
+*
 */
 class LAppAllocator : public Csm::ICubismAllocator
 {
+public:
+    static const Csm::csmSizeType SmallBlockMaxSize = 512;     ///< 풀에서 할당하는 최대 크기
+    static const Csm::csmUint32 SizeClassCount = 16;           ///< 크기 클래스 수
+
+    /**
+    * @brief 풀의 통계.
+    */
+    struct PoolStatistics
+    {
+        Csm::csmSizeType BlockSize;             ///< 블록 크기
+        Csm::csmSizeType SpanCount;             ///< 확보 중인 스팬 수
+        Csm::csmSizeType UsedBlockCount;        ///< 사용 중인 블록 수(스레드 캐시에 있는 블록 포함)
+        Csm::csmSizeType PeakUsedBlockCount;    ///< 사용 중인 블록 수의 최댓값
+        Csm::csmSizeType AllocationCount;       ///< 누적 할당 횟수
+        Csm::csmSizeType ReleasedSpanCount;     ///< 시스템에 반환한 스팬의 누적 수
+    };
+
+    /**
+    * @brief 전용 영역(큰 블록)의 통계.
+    */
+    struct LargeStatistics
+    {
+        Csm::csmSizeType BlockCount;            ///< 사용 중인 블록 수
+        Csm::csmSizeType ByteCount;             ///< 사용 중인 바이트 수
+        Csm::csmSizeType PeakByteCount;         ///< 사용 중인 바이트 수의 최댓값
+        Csm::csmSizeType AllocationCount;       ///< 누적 할당 횟수
+    };
+
+    /**
+    * @brief 프레임 아레나의 통계.
+    */
+    struct FrameStatistics
+    {
+        Csm::csmSizeType ReservedByteCount;     ///< 확보 중인 청크의 합계 바이트 수
+        Csm::csmSizeType PeakByteCount;         ///< 한 번에 사용한 바이트 수의 최댓값
+    };
+
+    /**
+    * @brief 프레임 아레나의 위치. RewindFrame으로 이 위치까지 되돌립니다.
+    */
+    struct FrameMarker
+    {
+        void* Chunk;                            ///< 사용 중이던 청크
+        Csm::csmSizeType Used;                  ///< 청크 안에서 사용한 바이트 수
+        Csm::csmSizeType TotalUsed;             ///< 아레나 전체에서 사용한 바이트 수
+    };
+
+    /**
+    * @brief 범위를 벗어날 때 프레임 아레나를 되돌리는 클래스.
+    */
+    class FrameScope
+    {
+    public:
+        /**
+        * @brief 생성자. 현재 위치를 기록합니다.
+        *
+        * @param[in]   allocator    프레임 아레나를 가진 할당자
+        */
+        explicit FrameScope(LAppAllocator& allocator)
+            : _allocator(allocator)
+            , _marker(allocator.GetFrameMarker())
+        { }
+
+        /**
+        * @brief 소멸자. 기록한 위치까지 되돌립니다.
+        */
+        ~FrameScope()
+        {
+            _allocator.RewindFrame(_marker);
+        }
+
+    private:
+        FrameScope(const FrameScope&);
+        FrameScope& operator=(const FrameScope&);
+
+        LAppAllocator& _allocator;      ///< 프레임 아레나를 가진 할당자
+        FrameMarker _marker;            ///< 되돌릴 위치
+    };
+
+    /**
+    * @brief 생성자.
+    */
+    LAppAllocator();
+
+    /**
+    * @brief 소멸자. 확보한 모든 메모리를 시스템에 반환합니다.
+    */
+    virtual ~LAppAllocator();
+
     /**
     * @brief 메모리 영역을 할당합니다.
     *
@@ -35,19 +137,149 @@ class LAppAllocator : public Csm::ICubismAllocator
     void Deallocate(void* memory);
 
     /**
-    * @brief
+    * @brief 정렬된 메모리 영역을 할당합니다.
     *
     * @param[in]   size         할당하려는 크기.
-    * @param[in]   alignment    할당하려는 크기.
+    * @param[in]   alignment    정렬 바이트 수.
     * @return  alignedAddress
     */
     void* AllocateAligned(const Csm::csmSizeType size, const Csm::csmUint32 alignment);
 
     /**
-    * @brief
+    * @brief 정렬된 메모리 영역을 해제합니다.
     *
     * @param[in]   alignedMemory    해제할 메모리.
     */
     void DeallocateAligned(void* alignedMemory);
-};
 
+    /**
+    * @brief 프레임 아레나에서 메모리를 할당합니다. 해제는 RewindFrame으로 합니다.
+    *
+    * @param[in]   size         할당하려는 크기.
+    * @param[in]   alignment    정렬 바이트 수. 2의 거듭제곱
+    * @return  지정된 메모리 영역
+    */
+    void* AllocateFrame(Csm::csmSizeType size, Csm::csmUint32 alignment = 16);
+
+    /**
+    * @brief 프레임 아레나의 현재 위치를 가져옵니다.
+    */
+    FrameMarker GetFrameMarker() const;
+
+    /**
+    * @brief 프레임 아레나를 지정한 위치까지 되돌립니다. 확보한 청크는 다음 프레임에서 재사용합니다.
+    *
+    * @param[in]   marker    되돌릴 위치
+    */
+    void RewindFrame(const FrameMarker& marker);
+
+    /**
+    * @brief 사용하지 않는 메모리를 시스템에 반환합니다.
+    *
+    * 호출한 스레드의 캐시를 풀에 되돌리고, 풀이 보관 중인 빈 스팬과 프레임 아레나의 여분 청크를 해제합니다.
+    * 모델 전환 후 등 메모리 사용량이 줄어든 시점에 호출합니다.
+    */
+    void Trim();
+
+    /**
+    * @brief 풀의 통계를 가져옵니다.
+    *
+    * @param[in]   sizeClass    크기 클래스. 0 이상 SizeClassCount 미만
+    * @return  통계
+    */
+    PoolStatistics GetPoolStatistics(Csm::csmUint32 sizeClass) const;
+
+    /**
+    * @brief 전용 영역의 통계를 가져옵니다.
+    */
+    LargeStatistics GetLargeStatistics() const;
+
+    /**
+    * @brief 프레임 아레나의 통계를 가져옵니다.
+    */
+    FrameStatistics GetFrameStatistics() const;
+
+    /**
+    * @brief 모든 통계를 로그에 출력합니다.
+    */
+    void PrintStatistics() const;
+
+private:
+    struct Span;
+    struct ThreadCache;
+    struct FrameChunk;
+
+    /**
+    * @brief 크기 클래스별 풀.
+    */
+    struct Pool
+    {
+        std::mutex Mutex;                                   ///< 스팬 목록을 보호하는 뮤텍스
+        Span* Spans;                                        ///< 확보 중인 모든 스팬
+        Span* PartialSpans;                                 ///< 빈 블록이 있는 스팬
+        Span* EmptySpan;                                    ///< 재사용을 위해 보관하는 빈 스팬
+        Csm::csmUint32 BlockSize;                           ///< 블록 크기(헤더 제외)
+        Csm::csmUint32 BlocksPerSpan;                       ///< 스팬당 블록 수
+        std::atomic<Csm::csmSizeType> SpanCount;            ///< 확보 중인 스팬 수
+        std::atomic<Csm::csmSizeType> UsedBlockCount;       ///< 사용 중인 블록 수
+        std::atomic<Csm::csmSizeType> PeakUsedBlockCount;   ///< 사용 중인 블록 수의 최댓값
+        std::atomic<Csm::csmSizeType> AllocationCount;      ///< 누적 할당 횟수
+        std::atomic<Csm::csmSizeType> ReleasedSpanCount;    ///< 시스템에 반환한 스팬의 누적 수
+    };
+
+    LAppAllocator(const LAppAllocator&);
+    LAppAllocator& operator=(const LAppAllocator&);
+
+    /**
+    * @brief 크기에 맞는 크기 클래스를 가져옵니다.
+    */
+    static Csm::csmUint32 GetSizeClass(Csm::csmSizeType size);
+
+    /**
+    * @brief 풀에서 블록을 할당합니다.
+    */
+    void* AllocateSmall(Csm::csmUint32 sizeClass);
+
+    /**
+    * @brief 전용 영역에서 블록을 할당합니다.
+    */
+    void* AllocateLarge(Csm::csmSizeType size, Csm::csmSizeType alignment);
+
+    /**
+    * @brief 호출한 스레드의 캐시를 가져옵니다. 다른 할당자의 캐시였다면 비우고 등록합니다.
+    */
+    ThreadCache* GetThreadCache();
+
+    /**
+    * @brief 캐시를 채웁니다. 풀의 뮤텍스를 잠근 상태에서 호출합니다.
+    */
+    void RefillCache(Pool& pool, Csm::csmUint32 sizeClass, void** blocks, Csm::csmUint32& count, Csm::csmUint32 refillCount);
+
+    /**
+    * @brief 블록을 스팬에 되돌립니다. 풀의 뮤텍스를 잠근 상태에서 호출합니다.
+    */
+    void ReturnBlock(Pool& pool, void* block);
+
+    /**
+    * @brief 캐시의 블록을 모두 풀에 되돌립니다.
+    */
+    void FlushThreadCache(ThreadCache* cache);
+
+    /**
+    * @brief 사용 중인 블록 수를 갱신합니다.
+    */
+    static void AddUsedBlocks(Pool& pool, Csm::csmSizeType count);
+
+    Pool _pools[SizeClassCount];                        ///< 크기 클래스별 풀
+
+    std::atomic<Csm::csmSizeType> _largeBlockCount;     ///< 전용 영역의 사용 중인 블록 수
+    std::atomic<Csm::csmSizeType> _largeByteCount;      ///< 전용 영역의 사용 중인 바이트 수
+    std::atomic<Csm::csmSizeType> _largePeakByteCount;  ///< 전용 영역의 사용 중인 바이트 수의 최댓값
+    std::atomic<Csm::csmSizeType> _largeAllocationCount;///< 전용 영역의 누적 할당 횟수
+
+    FrameChunk* _frameChunks;                           ///< 프레임 아레나의 첫 번째 청크
+    FrameChunk* _frameCurrent;                          ///< 프레임 아레나의 사용 중인 청크
+    Csm::csmSizeType _frameTotalUsed;                   ///< 프레임 아레나 전체에서 사용한 바이트 수
+    Csm::csmSizeType _frameReserved;                    ///< 프레임 아레나가 확보한 바이트 수
+    Csm::csmSizeType _framePeak;                        ///< 프레임 아레나 사용량의 최댓값
+};
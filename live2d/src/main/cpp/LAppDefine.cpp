@@ -56,6 +56,20 @@ namespace LAppDefine {
     const csmBool DebugLogEnable = true;
     const csmBool DebugTouchLogEnable = false;
 
+    // 当たり判定の設定
+    // 有効にするとDrawableを囲む矩形の代わりにDrawableの三角形で判定し、透明な隙間や隣の部位を誤って判定しない
+    const csmBool PreciseHitTestEnable = true;
+
+    // アロケーション追跡の設定
+    // 有効にすると呼び出し位置ごとのアロケーションを集計し、ウォームアップ後のUpdate/Draw中のアロケーションをログに出力する
+    const csmBool AllocationTrackingEnable = false;
+    const csmUint32 AllocationGuardWarmUpFrames = 120;
+    const csmBool AllocationGuardAbort = false;
+    const csmUint32 AllocationReportCount = 20;
+
+    // CSM_TRACEを定義すると、シーンを切り替える時にそれまでの区間をアプリのfilesディレクトリに書き出す
+    const csmChar* TraceFileName = "live2d_trace.json";
+
     // Frameworkから出力するログのレベル設定
     const CubismFramework::Option::LogLevel CubismLoggingLevel = CubismFramework::Option::LogLevel_Verbose;
 }
@@ -55,6 +55,18 @@ namespace LAppDefine {
     extern const csmBool DebugLogEnable;            ///< 디버그용 로그 표시 활성화 여부
     extern const csmBool DebugTouchLogEnable;       ///< 터치 처리의 디버그용 로그 표시 활성화 여부
 
+    // 충돌 판정
+    extern const csmBool PreciseHitTestEnable;      ///< 충돌 판정을 Drawable의 사각형 대신 삼각형으로 수행할지 여부
+
+    // 할당 추적
+    extern const csmBool AllocationTrackingEnable;      ///< 할당 추적 활성화 여부
+    extern const csmUint32 AllocationGuardWarmUpFrames; ///< 프레임 중 할당 검사를 시작할 때까지의 프레임 수
+    extern const csmBool AllocationGuardAbort;          ///< 프레임 중 할당을 검출했을 때 중단할지 여부
+    extern const csmUint32 AllocationReportCount;       ///< 할당 보고서에 출력할 호출 위치 수
+
+    // 구간 계측
+    extern const csmChar* TraceFileName;            ///< 장면 전환 시 구간을 기록할 파일 이름. CSM_TRACE가 정의된 경우에만 기록
+
     // Framework에서 출력하는 로그의 레벨 설정
     extern const CubismFramework::Option::LogLevel CubismLoggingLevel;
 }
@@ -14,6 +14,7 @@
 #include "LAppLive2DManager.hpp"
 #include "LAppTextureManager.hpp"
 #include "JniBridgeC.hpp"
+#include <Utils/CubismTrace.hpp>
 
 using namespace Csm;
 using namespace std;
@@ -82,6 +83,13 @@ void LAppDelegate::OnDestroy()
 
 void LAppDelegate::Run()
 {
+    CSM_TRACE_SCOPE("LAppDelegate::Run");
+
+    if (_allocationTracker != NULL)
+    {
+        _allocationTracker->BeginFrame();
+    }
+
     // 時間更新
     LAppPal::UpdateTime();
 
@@ -104,6 +112,8 @@ void LAppDelegate::Run()
 
 void LAppDelegate::OnSurfaceCreate()
 {
+    CSM_TRACE_THREAD_NAME("GLThread");
+
     //テクスチャサンプリング設定
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -138,6 +148,7 @@ void LAppDelegate::OnSurfaceChanged(float width, float height)
 }
 
 LAppDelegate::LAppDelegate():
+    _allocationTracker(NULL),
     _cubismOption(),
     _captured(false),
     _SceneIndex(0),
@@ -151,11 +162,29 @@ LAppDelegate::LAppDelegate():
     _cubismOption.LogFunction = LAppPal::PrintMessageLn;
     _cubismOption.LoggingLevel = LAppDefine::CubismLoggingLevel;
     CubismFramework::CleanUp();
-    CubismFramework::StartUp(&_cubismAllocator, &_cubismOption);
+    if (LAppDefine::AllocationTrackingEnable)
+    {
+        _allocationTracker = new LAppAllocationTracker(_cubismAllocator);
+        _allocationTracker->SetWarmUpFrameCount(LAppDefine::AllocationGuardWarmUpFrames);
+        _allocationTracker->SetAbortOnViolation(LAppDefine::AllocationGuardAbort);
+        CubismFramework::StartUp(_allocationTracker, &_cubismOption);
+    }
+    else
+    {
+        CubismFramework::StartUp(&_cubismAllocator, &_cubismOption);
+    }
+    CubismFramework::SetJobSystem(&_cubismJobSystem);
 }
 
 LAppDelegate::~LAppDelegate()
 {
+    CubismFramework::SetJobSystem(NULL);
+
+    if (_allocationTracker != NULL)
+    {
+        delete _allocationTracker;
+        _allocationTracker = NULL;
+    }
 }
 
 void LAppDelegate::OnTouchBegan(double x, double y)
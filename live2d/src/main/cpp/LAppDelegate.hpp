@@ -10,6 +10,8 @@
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 #include "LAppAllocator.hpp"
+#include "LAppAllocationTracker.hpp"
+#include "LAppJobSystem.hpp"
 
 class LAppView;
 class LAppTextureManager;
@@ -126,6 +128,16 @@ public:
     */
     LAppView* GetView() { return _view; }
 
+    /**
+    * @brief   Cubism SDK에 등록한 할당자를 가져옵니다.
+    */
+    LAppAllocator& GetAllocator() { return _cubismAllocator; }
+
+    /**
+    * @brief   할당 추적기를 가져옵니다. 추적이 비활성화되어 있으면 NULL을 반환합니다.
+    */
+    LAppAllocationTracker* GetAllocationTracker() { return _allocationTracker; }
+
 private:
     /**
     * @brief   생성자
@@ -143,6 +155,8 @@ private:
     void InitializeCubism();
 
     LAppAllocator _cubismAllocator;              ///< Cubism SDK Allocator
+    LAppAllocationTracker* _allocationTracker;   ///< 할당 추적기
+    LAppJobSystem _cubismJobSystem;              ///< Cubism SDK JobSystem
     Csm::CubismFramework::Option _cubismOption;  ///< Cubism SDK Option
     LAppTextureManager* _textureManager;         ///< 텍스처 매니저
     LAppView* _view;                             ///< View 정보
@@ -0,0 +1,141 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppJobSystem.hpp"
+#include <Utils/CubismTrace.hpp>
+
+using namespace Csm;
+
+namespace {
+    // 워커 스레드 수의 상한
+    const csmUint32 MaxWorkerCount = 3;
+}
+
+LAppJobSystem::LAppJobSystem(csmUint32 workerCount)
+    : _function(NULL)
+    , _context(NULL)
+    , _jobCount(0)
+    , _nextJobIndex(0)
+    , _activeWorkerCount(0)
+    , _generation(0)
+    , _isStopping(false)
+{
+    if (workerCount == 0)
+    {
+        // 호출 스레드도 작업을 실행하므로 하드웨어 스레드 수에서 하나를 뺀다
+        const csmUint32 hardwareThreadCount = std::thread::hardware_concurrency();
+        workerCount = (hardwareThreadCount > 1) ? hardwareThreadCount - 1 : 0;
+        workerCount = (workerCount < MaxWorkerCount) ? workerCount : MaxWorkerCount;
+    }
+
+    for (csmUint32 i = 0; i < workerCount; ++i)
+    {
+        _workers.push_back(std::thread(&LAppJobSystem::WorkerMain, this));
+    }
+}
+
+LAppJobSystem::~LAppJobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _jobCondition.notify_all();
+
+    for (csmUint32 i = 0; i < _workers.size(); ++i)
+    {
+        _workers[i].join();
+    }
+}
+
+void LAppJobSystem::Dispatch(JobFunction function, void* context, csmInt32 jobCount)
+{
+    // 워커가 없거나 다른 Dispatch가 실행 중(중첩 호출 포함)이면 호출 스레드에서 실행한다
+    std::unique_lock<std::mutex> dispatchLock(_dispatchMutex, std::try_to_lock);
+    if (_workers.empty() || jobCount < 2 || !dispatchLock.owns_lock())
+    {
+        for (csmInt32 i = 0; i < jobCount; ++i)
+        {
+            function(context, i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _function = function;
+        _context = context;
+        _jobCount = jobCount;
+        _nextJobIndex.store(0);
+        ++_generation;
+    }
+    _jobCondition.notify_all();
+
+    RunJobs(function, context, jobCount);
+
+    // 호출 스레드의 루프가 끝난 시점에 모든 작업은 이미 가져갔으므로, 작업을 가져간 워커의 종료를 기다린다
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this] { return _activeWorkerCount == 0; });
+    _function = NULL;
+    _context = NULL;
+    _jobCount = 0;
+}
+
+void LAppJobSystem::WorkerMain()
+{
+    CSM_TRACE_THREAD_NAME("LAppJobSystem");
+
+    csmUint32 generation = 0;
+
+    for (;;)
+    {
+        JobFunction function;
+        void* context;
+        csmInt32 jobCount;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobCondition.wait(lock, [this, generation] { return _isStopping || _generation != generation; });
+
+            if (_isStopping)
+            {
+                return;
+            }
+
+            generation = _generation;
+
+            // 이미 완료된 Dispatch이면 다음 작업을 기다린다
+            if (_function == NULL)
+            {
+                continue;
+            }
+
+            function = _function;
+            context = _context;
+            jobCount = _jobCount;
+            ++_activeWorkerCount;
+        }
+
+        RunJobs(function, context, jobCount);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_activeWorkerCount;
+            if (_activeWorkerCount == 0)
+            {
+                _doneCondition.notify_all();
+            }
+        }
+    }
+}
+
+void LAppJobSystem::RunJobs(JobFunction function, void* context, csmInt32 jobCount)
+{
+    for (csmInt32 index = _nextJobIndex.fetch_add(1); index < jobCount; index = _nextJobIndex.fetch_add(1))
+    {
+        function(context, index);
+    }
+}
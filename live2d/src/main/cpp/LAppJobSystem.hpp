@@ -0,0 +1,76 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <ICubismJobSystem.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+* @brief 작업의 병렬 실행을 구현하는 클래스.
+*
+* 워커 스레드 풀로 작업을 실행하는 인터페이스 구현.
+* 프레임워크에서 호출됩니다.
+*
+*/
+class LAppJobSystem : public Csm::ICubismJobSystem
+{
+public:
+    /**
+    * @brief 생성자. 워커 스레드를 시작합니다.
+    *
+    * @param[in]   workerCount    워커 스레드 수. 0이면 하드웨어 스레드 수에서 결정합니다.
+    */
+    explicit LAppJobSystem(Csm::csmUint32 workerCount = 0);
+
+    /**
+    * @brief 소멸자. 워커 스레드를 종료합니다.
+    */
+    virtual ~LAppJobSystem();
+
+    /**
+    * @brief 작업을 실행하고 모두 완료될 때까지 기다립니다.
+    *
+    * @param[in]   function    각 작업에서 실행할 함수
+    * @param[in]   context     함수에 전달할 컨텍스트
+    * @param[in]   jobCount    작업 수
+    */
+    void Dispatch(JobFunction function, void* context, Csm::csmInt32 jobCount);
+
+private:
+    /**
+    * @brief 워커 스레드의 메인 루프.
+    */
+    void WorkerMain();
+
+    /**
+    * @brief 남은 작업을 가져와 실행합니다.
+    *
+    * @param[in]   function    각 작업에서 실행할 함수
+    * @param[in]   context     함수에 전달할 컨텍스트
+    * @param[in]   jobCount    작업 수
+    */
+    void RunJobs(JobFunction function, void* context, Csm::csmInt32 jobCount);
+
+    std::vector<std::thread> _workers;          ///< 워커 스레드
+    std::mutex _dispatchMutex;                  ///< 동시에 하나의 Dispatch만 실행하기 위한 뮤텍스
+    std::mutex _mutex;                          ///< 작업 상태를 보호하는 뮤텍스
+    std::condition_variable _jobCondition;      ///< 새 작업을 알리는 조건 변수
+    std::condition_variable _doneCondition;     ///< 작업 완료를 알리는 조건 변수
+    JobFunction _function;                      ///< 실행 중인 작업 함수
+    void* _context;                             ///< 실행 중인 작업의 컨텍스트
+    Csm::csmInt32 _jobCount;                    ///< 실행 중인 작업 수
+    std::atomic<Csm::csmInt32> _nextJobIndex;   ///< 다음에 실행할 작업의 인덱스
+    Csm::csmInt32 _activeWorkerCount;           ///< 작업을 실행 중인 워커 수
+    Csm::csmUint32 _generation;                 ///< Dispatch할 때마다 증가하는 세대 번호
+    bool _isStopping;                           ///< 워커 스레드를 종료 중인지 여부
+};
@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <GLES2/gl2.h>
 #include <Rendering/CubismRenderer.hpp>
+#include <Utils/CubismTrace.hpp>
 #include "LAppPal.hpp"
 #include "LAppDefine.hpp"
 #include "LAppDelegate.hpp"
@@ -130,25 +131,50 @@ void LAppLive2DManager::OnTap(csmFloat32 x, csmFloat32 y)
         LAppPal::PrintLogLn("[APP]tap point: {x:%.2f y:%.2f}", x, y);
     }
 
-    for (csmUint32 i = 0; i < _models.GetSize(); i++)
+    // 重なったモデルのうち、最も手前に描かれたモデルだけが反応する
+    const csmChar* hitAreaName = NULL;
+    LAppModel* model = FindHitModel(x, y, hitAreaName);
+    if (model == NULL)
+    {
+        return;
+    }
+
+    if (DebugLogEnable)
+    {
+        LAppPal::PrintLogLn("[APP]hit area: [%s]", hitAreaName);
+    }
+
+    if (hitAreaName == HitAreaNameHead)
+    {
+        model->SetRandomExpression();
+    }
+    else
+    {
+        model->StartRandomMotion(MotionGroupTapBody, PriorityNormal, FinishedMotion);
+    }
+}
+
+LAppModel* LAppLive2DManager::FindHitModel(csmFloat32 x, csmFloat32 y, const csmChar*& hitAreaName) const
+{
+    hitAreaName = NULL;
+
+    // 後に描くモデルほど手前に表示されるため、後ろから判定する
+    for (csmInt32 i = static_cast<csmInt32>(_models.GetSize()) - 1; i >= 0; --i)
     {
         if (_models[i]->HitTest(HitAreaNameHead, x, y))
         {
-            if (DebugLogEnable)
-            {
-                LAppPal::PrintLogLn("[APP]hit area: [%s]", HitAreaNameHead);
-            }
-            _models[i]->SetRandomExpression();
+            hitAreaName = HitAreaNameHead;
+            return _models[i];
         }
-        else if (_models[i]->HitTest(HitAreaNameBody, x, y))
+
+        if (_models[i]->HitTest(HitAreaNameBody, x, y))
         {
-            if (DebugLogEnable)
-            {
-                LAppPal::PrintLogLn("[APP]hit area: [%s]", HitAreaNameBody);
-            }
-            _models[i]->StartRandomMotion(MotionGroupTapBody, PriorityNormal, FinishedMotion);
+            hitAreaName = HitAreaNameBody;
+            return _models[i];
         }
     }
+
+    return NULL;
 }
 
 void LAppLive2DManager::OnUpdate() const
@@ -217,7 +243,38 @@ void LAppLive2DManager::ChangeScene(Csm::csmInt32 index)
     csmString modelJsonName(_modelDir[index]);
     modelJsonName += ".model3.json";
 
+    // 前のシーンで記録した区間を書き出す
+    if (Utils::CubismTrace::IsAvailable())
+    {
+        const csmString tracePath = JniBridgeC::GetFilesDir() + "/" + TraceFileName;
+        if (Utils::CubismTrace::WriteChromeTrace(tracePath.GetRawString()))
+        {
+            LAppPal::PrintLogLn("[APP]trace written: %s", tracePath.GetRawString());
+        }
+        Utils::CubismTrace::Clear();
+    }
+
     ReleaseAllModel();
+
+    // 前のモデルが使っていたメモリをシステムに返す
+    LAppAllocator& allocator = LAppDelegate::GetInstance()->GetAllocator();
+    allocator.Trim();
+    if (DebugLogEnable)
+    {
+        allocator.PrintStatistics();
+    }
+
+    // 新しいモデルの初回のUpdate/Drawで行われる確保を検出しないよう、ウォームアップをやり直す
+    LAppAllocationTracker* tracker = LAppDelegate::GetInstance()->GetAllocationTracker();
+    if (tracker != NULL)
+    {
+        if (DebugLogEnable)
+        {
+            tracker->PrintReport(AllocationReportCount);
+        }
+        tracker->ResetWarmUp();
+    }
+
     _models.PushBack(new LAppModel());
     _models[0]->LoadAssets(modelPath.GetRawString(), modelJsonName.GetRawString());
 
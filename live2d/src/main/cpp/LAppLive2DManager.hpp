@@ -73,6 +73,17 @@ public:
     */
     void OnTap(Csm::csmFloat32 x, Csm::csmFloat32 y);
 
+    /**
+    * @brief   지정한 좌표에서 가장 앞에 그려진 모델의 충돌 영역을 찾습니다.<br>
+    *           모델은 뒤에서부터 그려지므로 마지막 모델부터 판별하고, 모델마다 [Head], [Body] 순으로 판별합니다.
+    *
+    * @param[in]   x               화면의 X 좌표
+    * @param[in]   y               화면의 Y 좌표
+    * @param[out]  hitAreaName     충돌한 영역의 이름. 충돌하지 않은 경우 NULL
+    * @return      충돌한 모델의 인스턴스. 충돌하지 않은 경우 NULL을 반환합니다.
+    */
+    LAppModel* FindHitModel(Csm::csmFloat32 x, Csm::csmFloat32 y, const Csm::csmChar*& hitAreaName) const;
+
     /**
     * @brief   화면을 업데이트할 때의 처리
     *          모델의 업데이트 처리 및 렌더링 처리를 수행합니다.
@@ -14,6 +14,7 @@
 #include <CubismDefaultParameterId.hpp>
 #include <Rendering/OpenGL/CubismRenderer_OpenGLES2.hpp>
 #include <Utils/CubismString.hpp>
+#include <Utils/CubismTrace.hpp>
 #include <Id/CubismIdManager.hpp>
 #include <Motion/CubismMotionQueueEntry.hpp>
 #include "LAppDefine.hpp"
@@ -80,6 +81,8 @@ LAppModel::~LAppModel()
 
 void LAppModel::LoadAssets(const csmChar* dir, const csmChar* fileName)
 {
+    CSM_TRACE_SCOPE("LAppModel::LoadAssets");
+
     _modelHomeDir = dir;
 
     if (_debugMode)
@@ -110,6 +113,8 @@ void LAppModel::LoadAssets(const csmChar* dir, const csmChar* fileName)
 
 void LAppModel::SetupModel(ICubismModelSetting* setting)
 {
+    CSM_TRACE_SCOPE("LAppModel::SetupModel");
+
     _updating = true;
     _initialized = false;
 
@@ -121,6 +126,8 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
     //Cubism Model
     if (strcmp(_modelSetting->GetModelFileName(), "") != 0)
     {
+        CSM_TRACE_SCOPE("LoadModel");
+
         csmString path = _modelSetting->GetModelFileName();
         path = _modelHomeDir + path;
 
@@ -137,6 +144,8 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
     //Expression
     if (_modelSetting->GetExpressionCount() > 0)
     {
+        CSM_TRACE_SCOPE("LoadExpressions");
+
         const csmInt32 count = _modelSetting->GetExpressionCount();
         for (csmInt32 i = 0; i < count; i++)
         {
@@ -149,12 +158,12 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
 
             if (motion)
             {
-                if (_expressions[name] != NULL)
+                ACubismMotion*& expression = _expressions[name];
+                if (expression != NULL)
                 {
-                    ACubismMotion::Delete(_expressions[name]);
-                    _expressions[name] = NULL;
+                    ACubismMotion::Delete(expression);
                 }
-                _expressions[name] = motion;
+                expression = motion;
             }
 
             DeleteBuffer(buffer, path.GetRawString());
@@ -164,6 +173,8 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
     //Physics
     if (strcmp(_modelSetting->GetPhysicsFileName(), "") != 0)
     {
+        CSM_TRACE_SCOPE("LoadPhysics");
+
         csmString path = _modelSetting->GetPhysicsFileName();
         path = _modelHomeDir + path;
 
@@ -175,6 +186,8 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
     //Pose
     if (strcmp(_modelSetting->GetPoseFileName(), "") != 0)
     {
+        CSM_TRACE_SCOPE("LoadPose");
+
         csmString path = _modelSetting->GetPoseFileName();
         path = _modelHomeDir + path;
 
@@ -207,6 +220,8 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
     //UserData
     if (strcmp(_modelSetting->GetUserDataFile(), "") != 0)
     {
+        CSM_TRACE_SCOPE("LoadUserData");
+
         csmString path = _modelSetting->GetUserDataFile();
         path = _modelHomeDir + path;
         buffer = CreateBuffer(path.GetRawString(), &size);
@@ -238,6 +253,9 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
         return;
     }
 
+    // 当たり判定
+    UsePreciseHitTest(PreciseHitTestEnable);
+
     //Layout
     csmMap<csmString, csmFloat32> layout;
     _modelSetting->GetLayoutMap(layout);
@@ -259,6 +277,8 @@ void LAppModel::SetupModel(ICubismModelSetting* setting)
 
 void LAppModel::PreloadMotionGroup(const csmChar* group)
 {
+    CSM_TRACE_SCOPE("LAppModel::PreloadMotionGroup");
+
     const csmInt32 count = _modelSetting->GetMotionCount(group);
 
     for (csmInt32 i = 0; i < count; i++)
@@ -293,11 +313,12 @@ void LAppModel::PreloadMotionGroup(const csmChar* group)
             }
             tmpMotion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
 
-            if (_motions[name] != NULL)
+            ACubismMotion*& loadedMotion = _motions[name];
+            if (loadedMotion != NULL)
             {
-                ACubismMotion::Delete(_motions[name]);
+                ACubismMotion::Delete(loadedMotion);
             }
-            _motions[name] = tmpMotion;
+            loadedMotion = tmpMotion;
         }
 
         DeleteBuffer(buffer, path.GetRawString());
@@ -325,7 +346,7 @@ void LAppModel::ReleaseMotionGroup(const csmChar* group) const
 */
 void LAppModel::ReleaseMotions()
 {
-    for (csmMap<csmString, ACubismMotion*>::const_iterator iter = _motions.Begin(); iter != _motions.End(); ++iter)
+    for (csmHashMap<csmString, ACubismMotion*>::const_iterator iter = _motions.Begin(); iter != _motions.End(); ++iter)
     {
         ACubismMotion::Delete(iter->Second);
     }
@@ -340,7 +361,7 @@ void LAppModel::ReleaseMotions()
 */
 void LAppModel::ReleaseExpressions()
 {
-    for (csmMap<csmString, ACubismMotion*>::const_iterator iter = _expressions.Begin(); iter != _expressions.End(); ++iter)
+    for (csmHashMap<csmString, ACubismMotion*>::const_iterator iter = _expressions.Begin(); iter != _expressions.End(); ++iter)
     {
         ACubismMotion::Delete(iter->Second);
     }
@@ -350,6 +371,10 @@ void LAppModel::ReleaseExpressions()
 
 void LAppModel::Update()
 {
+    // ウォームアップ後はフレーム中にアロケーションしない
+    LAppAllocationTracker::GuardScope allocationGuard(LAppDelegate::GetInstance()->GetAllocationTracker(), "LAppModel::Update");
+    CSM_TRACE_SCOPE("LAppModel::Update");
+
     const csmFloat32 deltaTimeSeconds = LAppPal::GetDeltaTime();
     _userTimeSeconds += deltaTimeSeconds;
 
@@ -361,6 +386,7 @@ void LAppModel::Update()
     csmBool motionUpdated = false;
 
     //-----------------------------------------------------------------
+    CSM_TRACE_BEGIN("Motion");
     _model->LoadParameters(); // 前回セーブされた状態をロード
     if (_motionManager->IsFinished())
     {
@@ -372,6 +398,7 @@ void LAppModel::Update()
         motionUpdated = _motionManager->UpdateMotion(_model, deltaTimeSeconds); // モーションを更新
     }
     _model->SaveParameters(); // 状態を保存
+    CSM_TRACE_END();
     //-----------------------------------------------------------------
 
     // 不透明度
@@ -382,6 +409,7 @@ void LAppModel::Update()
     {
         if (_eyeBlink != NULL)
         {
+            CSM_TRACE_SCOPE("EyeBlink");
             // メインモーションの更新がないとき
             _eyeBlink->UpdateParameters(_model, deltaTimeSeconds); // 目パチ
         }
@@ -389,6 +417,7 @@ void LAppModel::Update()
 
     if (_expressionManager != NULL)
     {
+        CSM_TRACE_SCOPE("Expression");
         _expressionManager->UpdateMotion(_model, deltaTimeSeconds); // 表情でパラメータ更新（相対変化）
     }
 
@@ -408,12 +437,14 @@ void LAppModel::Update()
     // 呼吸など
     if (_breath != NULL)
     {
+        CSM_TRACE_SCOPE("Breath");
         _breath->UpdateParameters(_model, deltaTimeSeconds);
     }
 
     // 物理演算の設定
     if (_physics != NULL)
     {
+        CSM_TRACE_SCOPE("Physics");
         _physics->Evaluate(_model, deltaTimeSeconds);
     }
 
@@ -431,11 +462,14 @@ void LAppModel::Update()
     // ポーズの設定
     if (_pose != NULL)
     {
+        CSM_TRACE_SCOPE("Pose");
         _pose->UpdateParameters(_model, deltaTimeSeconds);
     }
 
-    _model->Update();
-
+    {
+        CSM_TRACE_SCOPE("CubismModel::Update");
+        _model->Update();
+    }
 }
 
 CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar* group, csmInt32 no, csmInt32 priority, ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
@@ -453,17 +487,17 @@ CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar* group, csmInt
         return InvalidMotionQueueEntryHandleValue;
     }
 
-    const csmString fileName = _modelSetting->GetMotionFileName(group, no);
-
+    // 読み込み済みのモーションを探す間は文字列を確保しない
     //ex) idle_0
-    csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
-    CubismMotion* motion = static_cast<CubismMotion*>(_motions[name.GetRawString()]);
+    csmChar name[128];
+    const csmInt32 nameLength = Utils::CubismString::FormatTo(name, "%s_%d", group, no);
+    ACubismMotion* const* loadedMotion = (nameLength >= 0 && nameLength < static_cast<csmInt32>(sizeof(name))) ? _motions.Find(csmStringView(name, nameLength)) : NULL;
+    CubismMotion* motion = (loadedMotion != NULL) ? static_cast<CubismMotion*>(*loadedMotion) : NULL;
     csmBool autoDelete = false;
 
     if (motion == NULL)
     {
-        csmString path = fileName;
-        path = _modelHomeDir + path;
+        const csmString path = _modelHomeDir + _modelSetting->GetMotionFileName(group, no);
 
         csmByte* buffer;
         csmSizeInt size;
@@ -494,14 +528,6 @@ CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar* group, csmInt
         motion->SetFinishedMotionHandler(onFinishedMotionHandler);
     }
 
-    //voice
-    csmString voice = _modelSetting->GetMotionSoundFileName(group, no);
-    if (strcmp(voice.GetRawString(), "") != 0)
-    {
-        csmString path = voice;
-        path = _modelHomeDir + path;
-    }
-
     if (_debugMode)
     {
         LAppPal::PrintLogLn("[APP]start motion: [%s_%d]", group, no);
@@ -538,6 +564,8 @@ void LAppModel::Draw(CubismMatrix44& matrix)
         return;
     }
 
+    LAppAllocationTracker::GuardScope allocationGuard(LAppDelegate::GetInstance()->GetAllocationTracker(), "LAppModel::Draw");
+
     matrix.MultiplyByMatrix(_modelMatrix);
 
     GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->SetMvpMatrix(&matrix);
@@ -566,7 +594,8 @@ csmBool LAppModel::HitTest(const csmChar* hitAreaName, csmFloat32 x, csmFloat32
 
 void LAppModel::SetExpression(const csmChar* expressionID)
 {
-    ACubismMotion* motion = _expressions[expressionID];
+    ACubismMotion* const* expression = _expressions.Find(csmStringView(expressionID));
+    ACubismMotion* motion = (expression != NULL) ? *expression : NULL;
     if (_debugMode)
     {
         LAppPal::PrintLogLn("[APP]expression: [%s]", expressionID);
@@ -590,14 +619,13 @@ void LAppModel::SetRandomExpression()
     }
 
     csmInt32 no = rand() % _expressions.GetSize();
-    csmMap<csmString, ACubismMotion*>::const_iterator map_ite;
+    csmHashMap<csmString, ACubismMotion*>::const_iterator map_ite;
     csmInt32 i = 0;
     for (map_ite = _expressions.Begin(); map_ite != _expressions.End(); map_ite++)
     {
         if (i == no)
         {
-            csmString name = (*map_ite).First;
-            SetExpression(name.GetRawString());
+            SetExpression((*map_ite).First.GetRawString());
             return;
         }
         i++;
@@ -615,6 +643,8 @@ void LAppModel::ReloadRenderer()
 
 void LAppModel::SetupTextures()
 {
+    CSM_TRACE_SCOPE("LAppModel::SetupTextures");
+
     for (csmInt32 modelTextureNumber = 0; modelTextureNumber < _modelSetting->GetTextureCount(); modelTextureNumber++)
     {
         // テクスチャ名が空文字だった場合はロード・バインド処理をスキップ
@@ -11,6 +11,7 @@
 #include <Model/CubismUserModel.hpp>
 #include <ICubismModelSetting.hpp>
 #include <Type/csmRectF.hpp>
+#include <Type/csmHashMap.hpp>
 #include <Rendering/OpenGL/CubismOffscreenSurface_OpenGLES2.hpp>
 
 /**
@@ -100,6 +101,7 @@ public:
     /**
      * @brief    충돌 감지 테스트.<br>
      *            지정된 ID의 정점 리스트로부터 사각형을 계산하여 좌표가 사각형 범위 내에 있는지 판별합니다.
+     *            PreciseHitTestEnable이 활성화된 경우 사각형 범위 내의 좌표를 Drawable의 삼각형으로 다시 판별합니다.
      *
      * @param[in]   hitAreaName     충돌 감지를 테스트할 대상의 ID
      * @param[in]   x               판별할 X 좌표
@@ -170,8 +172,8 @@ private:
     Csm::csmFloat32 _userTimeSeconds; ///< 델타 시간의 합계 값 [초]
     Csm::csmVector<Csm::CubismIdHandle> _eyeBlinkIds; ///< 모델에 설정된 눈 깜박임 기능용 파라미터 ID
     Csm::csmVector<Csm::CubismIdHandle> _lipSyncIds; ///< 모델에 설정된 립 싱크 기능용 파라미터 ID
-    Csm::csmMap<Csm::csmString, Csm::ACubismMotion*> _motions; ///< 로드된 모션 리스트
-    Csm::csmMap<Csm::csmString, Csm::ACubismMotion*> _expressions; ///< 로드된 표정 리스트
+    Csm::csmHashMap<Csm::csmString, Csm::ACubismMotion*> _motions; ///< 로드된 모션 리스트
+    Csm::csmHashMap<Csm::csmString, Csm::ACubismMotion*> _expressions; ///< 로드된 표정 리스트
     Csm::csmVector<Csm::csmRectF> _hitArea;
     Csm::csmVector<Csm::csmRectF> _userArea;
     const Csm::CubismId* _idParamAngleX; ///< 파라미터 ID: ParamAngleX
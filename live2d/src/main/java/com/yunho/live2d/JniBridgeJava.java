@@ -70,6 +70,10 @@ public class JniBridgeJava {
         }
     }
 
+    public static String GetFilesDir() {
+        return context.getFilesDir().getAbsolutePath();
+    }
+
     public static void MoveTaskToBack() {
         activityInstance.moveTaskToBack(true);
     }
@@ -0,0 +1,173 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <Type/csmHashMap.hpp>
+#include <Type/csmMap.hpp>
+#include <Type/csmString.hpp>
+
+using namespace Live2D::Cubism::Framework;
+
+namespace {
+
+const int MaxKeyCount = 10000;
+const int RepeatCount = 3;
+
+// csmMapと同じ操作を乱数で繰り返し、内容と順序が一致することを確かめる
+void TestRandomOperations()
+{
+    csmMap<int, int> reference;
+    csmHashMap<int, int> map;
+    std::srand(1);
+
+    int mismatches = 0;
+    for (int step = 0; step < 200000; ++step)
+    {
+        const int key = std::rand() % 500;
+        const int operation = std::rand() % 10;
+
+        if (operation < 6)
+        {
+            reference[key] = step;
+            map[key] = step;
+        }
+        else if (operation < 9)
+        {
+            if (reference.IsExist(key) != map.IsExist(key))
+            {
+                ++mismatches;
+            }
+            else if (reference.IsExist(key) && reference[key] != *map.Find(key))
+            {
+                ++mismatches;
+            }
+        }
+        else
+        {
+            for (csmHashMap<int, int>::const_iterator it = map.Begin(); it != map.End(); ++it)
+            {
+                if (it->First == key)
+                {
+                    map.Erase(it);
+                    break;
+                }
+            }
+
+            // csmMapには削除がないので作り直す
+            csmMap<int, int> rest;
+            for (csmMap<int, int>::const_iterator it = reference.Begin(); it != reference.End(); ++it)
+            {
+                if (it->First != key)
+                {
+                    rest[it->First] = it->Second;
+                }
+            }
+            reference.Clear();
+            for (csmMap<int, int>::const_iterator it = rest.Begin(); it != rest.End(); ++it)
+            {
+                reference[it->First] = it->Second;
+            }
+        }
+
+        if (reference.GetSize() != map.GetSize())
+        {
+            ++mismatches;
+            break;
+        }
+    }
+
+    csmMap<int, int>::const_iterator referenceIt = reference.Begin();
+    for (csmHashMap<int, int>::const_iterator it = map.Begin(); it != map.End(); ++it, ++referenceIt)
+    {
+        if (it->First != referenceIt->First || it->Second != referenceIt->Second)
+        {
+            ++mismatches;
+        }
+    }
+
+    LAPP_TEST_CHECK(mismatches == 0);
+}
+
+// 登録とlookupCount回の検索にかかる時間[ms]。RepeatCount回の最小値
+template <class Map, class Key>
+double MeasureMap(const std::vector<Key>& keys, int lookupCount, long long& checksum)
+{
+    double best = 0.0;
+    for (int repeat = 0; repeat < RepeatCount; ++repeat)
+    {
+        LAppTest::Timer timer;
+        Map map;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            map[keys[i]] = static_cast<int>(i);
+        }
+        for (int i = 0; i < lookupCount; ++i)
+        {
+            const Key& key = keys[(i * 7919u) % keys.size()];
+            if (map.IsExist(key))
+            {
+                checksum += map[key];
+            }
+        }
+        const double elapsed = timer.ElapsedMilliseconds();
+        if (repeat == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+// 10, 100, 10k個のキーでcsmMapとcsmHashMapを比べる
+template <class Key>
+void BenchmarkKeys(const char* name, const std::vector<Key>& allKeys)
+{
+    const int keyCounts[] = { 10, 100, MaxKeyCount };
+    for (size_t n = 0; n < sizeof(keyCounts) / sizeof(keyCounts[0]); ++n)
+    {
+        const int keyCount = keyCounts[n];
+        const int lookupCount = keyCount == MaxKeyCount ? 10000 : 100000;
+        const std::vector<Key> keys(allKeys.begin(), allKeys.begin() + keyCount);
+
+        long long mapChecksum = 0;
+        long long hashMapChecksum = 0;
+        const double mapTime = MeasureMap<csmMap<Key, int> >(keys, lookupCount, mapChecksum);
+        const double hashMapTime = MeasureMap<csmHashMap<Key, int> >(keys, lookupCount, hashMapChecksum);
+
+        std::printf("%-10s keys=%-6d lookups=%-7d csmMap %9.3f ms  csmHashMap %8.3f ms  x%.1f\n",
+                    name, keyCount, lookupCount, mapTime, hashMapTime, mapTime / hashMapTime);
+
+        LAPP_TEST_CHECK(mapChecksum == hashMapChecksum);
+    }
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestRandomOperations();
+
+    static int storage[MaxKeyCount];
+    std::vector<int> intKeys;
+    std::vector<const int*> pointerKeys;
+    std::vector<csmString> stringKeys;
+    for (int i = 0; i < MaxKeyCount; ++i)
+    {
+        intKeys.push_back(i * 3 + 1000);
+        pointerKeys.push_back(&storage[i]);
+        stringKeys.push_back(csmString(("Param" + std::to_string(i)).c_str()));
+    }
+
+    BenchmarkKeys("int", intKeys);
+    BenchmarkKeys("pointer", pointerKeys);
+    BenchmarkKeys("csmString", stringKeys);
+
+    return LAppTest::Finish("CsmHashMapTest");
+}
@@ -0,0 +1,277 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <CubismModelSettingJson.hpp>
+#include <Model/CubismUserModel.hpp>
+#include <Motion/ACubismMotion.hpp>
+#include <Type/csmString.hpp>
+#include <Type/csmVector.hpp>
+#include <utility>
+
+using namespace Live2D::Cubism::Framework;
+
+namespace {
+
+LAppTest::Allocator* s_allocator = NULL;
+
+// csmStringの内部バッファに収まらない長さの文字列
+const csmChar* LongText = "a string long enough to live on the heap of csmString, more than sixty four chars";
+
+const char* ModelDirectory = "Haru/";
+const char* ModelFileName = "Haru.model3.json";
+
+/**
+ * コピーとムーブの回数を数える要素型
+ */
+struct CopyCounter
+{
+    static int CopyCount;
+    static int MoveCount;
+
+    CopyCounter() : Value(0) {}
+    explicit CopyCounter(int value) : Value(value) {}
+    CopyCounter(const CopyCounter& other) : Value(other.Value) { ++CopyCount; }
+    CopyCounter(CopyCounter&& other) noexcept : Value(other.Value) { ++MoveCount; }
+    CopyCounter& operator=(const CopyCounter& other) { Value = other.Value; ++CopyCount; return *this; }
+    CopyCounter& operator=(CopyCounter&& other) noexcept { Value = other.Value; ++MoveCount; return *this; }
+
+    int Value;
+};
+
+int CopyCounter::CopyCount = 0;
+int CopyCounter::MoveCount = 0;
+
+Csm::csmUint64 AllocationCount()
+{
+    return s_allocator->GetAllocationCount();
+}
+
+// 内部バッファ付きベクターとムーブの動作を確かめる
+void TestSmallVector()
+{
+    csmUint64 allocations = AllocationCount();
+    csmSmallVector<csmString, 4> small;
+    for (int i = 0; i < 4; ++i)
+    {
+        small.PushBack(csmString("x"));
+    }
+    LAPP_TEST_CHECK(AllocationCount() == allocations);
+
+    small.PushBack(csmString(LongText));
+    LAPP_TEST_CHECK(small.GetSize() == 5);
+    LAPP_TEST_CHECK(small[4] == LongText);
+    LAPP_TEST_CHECK(small[0] == "x");
+
+    csmSmallVector<csmString, 4> copied(small);
+    LAPP_TEST_CHECK(copied.GetSize() == 5 && copied[4] == LongText);
+
+    csmSmallVector<csmString, 4> moved(std::move(copied));
+    LAPP_TEST_CHECK(moved.GetSize() == 5 && copied.GetSize() == 0 && moved[4] == LongText);
+
+    csmVector<csmString> plain;
+    plain = std::move(moved);
+    LAPP_TEST_CHECK(plain.GetSize() == 5 && moved.GetSize() == 0);
+
+    moved.PushBack(csmString(LongText));
+    LAPP_TEST_CHECK(moved.GetSize() == 1);
+
+    // Clear後は内部バッファに戻る
+    small.Clear();
+    allocations = AllocationCount();
+    small.PushBack(csmString("y"));
+    LAPP_TEST_CHECK(AllocationCount() == allocations);
+
+    csmSmallVector<csmString, 4> inlineSource;
+    inlineSource.PushBack(csmString(LongText));
+    csmSmallVector<csmString, 4> inlineMoved(std::move(inlineSource));
+    LAPP_TEST_CHECK(inlineMoved.GetSize() == 1 && inlineMoved[0] == LongText && inlineSource.GetSize() == 0);
+
+    csmVector<csmString> fromSmall(std::move(inlineMoved));
+    LAPP_TEST_CHECK(fromSmall.GetSize() == 1 && fromSmall[0] == LongText);
+
+    csmSmallVector<csmString, 4> fromPlain(plain);
+    LAPP_TEST_CHECK(fromPlain.GetSize() == 5 && fromPlain[4] == LongText);
+
+    csmSmallVector<csmString, 4> assigned;
+    assigned = fromSmall;
+    LAPP_TEST_CHECK(assigned.GetSize() == 1 && assigned[0] == LongText);
+}
+
+// 挿入と文字列のムーブを確かめる
+void TestInsertAndStringMove()
+{
+    csmVector<int> source;
+    for (int i = 0; i < 3; ++i)
+    {
+        source.PushBack(100 + i);
+    }
+    csmVector<int> destination;
+    for (int i = 0; i < 5; ++i)
+    {
+        destination.PushBack(i);
+    }
+    destination.Insert(destination.Begin(), source.Begin(), source.End(), true);
+    LAPP_TEST_CHECK(destination.GetSize() == 8 && destination[0] == 100 && destination[3] == 0);
+
+    csmVector<csmString> strings;
+    for (int i = 0; i < 3; ++i)
+    {
+        strings.PushBack(csmString("d"));
+    }
+    csmVector<csmString> stringSource;
+    stringSource.PushBack(csmString(LongText));
+    stringSource.PushBack(csmString("s"));
+    csmVector<csmString>::iterator position(&strings, 3);
+    csmVector<csmString>::iterator begin(&stringSource, 0);
+    csmVector<csmString>::iterator end(&stringSource, 2);
+    strings.Insert(position, begin, end, true);
+    LAPP_TEST_CHECK(strings.GetSize() == 5 && strings[3] == LongText && strings[4] == "s");
+
+    csmString text(LongText);
+    csmString movedText(std::move(text));
+    LAPP_TEST_CHECK(movedText == LongText && text.GetLength() == 0);
+    text = std::move(movedText);
+    LAPP_TEST_CHECK(text == LongText && movedText.GetLength() == 0);
+
+    csmString shortText("short");
+    csmString movedShortText(std::move(shortText));
+    LAPP_TEST_CHECK(movedShortText == "short");
+}
+
+// 拡張時に要素がコピーされず移動されることを確かめ、確保回数を表示する
+void BenchmarkGrowth()
+{
+    const int count = 10000;
+
+    CopyCounter::CopyCount = 0;
+    CopyCounter::MoveCount = 0;
+    {
+        csmVector<CopyCounter> counters;
+        for (int i = 0; i < count; ++i)
+        {
+            counters.PushBack(CopyCounter(i));
+        }
+        LAPP_TEST_CHECK(counters[count - 1].Value == count - 1);
+    }
+    std::printf("push %d elements: %d copies, %d moves\n", count, CopyCounter::CopyCount, CopyCounter::MoveCount);
+    LAPP_TEST_CHECK(CopyCounter::CopyCount == 0);
+
+    const csmString longName("ParamLongIdentifierThatDoesNotFitTheSmallStringBufferOfCsmString_0123456789");
+    const csmUint64 allocations = AllocationCount();
+    LAppTest::Timer timer;
+    {
+        csmVector<csmString> strings;
+        for (int i = 0; i < count; ++i)
+        {
+            strings.PushBack(longName);
+        }
+    }
+    const csmUint64 stringAllocations = AllocationCount() - allocations;
+    std::printf("push %d heap strings: %.3f ms, %llu allocations\n", count, timer.ElapsedMilliseconds(), stringAllocations);
+
+    // 文字列ごとに1回と、拡張の回数分だけ確保する
+    LAPP_TEST_CHECK(stringAllocations < static_cast<csmUint64>(count) + 64);
+}
+
+/**
+ * ファイルの読み込みだけを行うモデル
+ */
+class LoadOnlyModel : public CubismUserModel
+{
+};
+
+// Haruの読み込みにかかる時間と確保回数を表示する
+void BenchmarkModelLoad()
+{
+    const std::string directory = ModelDirectory;
+    const std::vector<csmByte> settingBuffer = LAppTest::ReadResource(directory + ModelFileName);
+    LAPP_TEST_CHECK(!settingBuffer.empty());
+    if (settingBuffer.empty())
+    {
+        return;
+    }
+
+    CubismModelSettingJson* setting = CSM_NEW CubismModelSettingJson(settingBuffer.data(), static_cast<csmSizeInt>(settingBuffer.size()));
+    const std::vector<csmByte> mocBuffer = LAppTest::ReadResource(directory + setting->GetModelFileName());
+    const std::vector<csmByte> physicsBuffer = LAppTest::ReadResource(directory + setting->GetPhysicsFileName());
+    const std::vector<csmByte> poseBuffer = LAppTest::ReadResource(directory + setting->GetPoseFileName());
+
+    std::vector<std::vector<csmByte> > motionBuffers;
+    for (csmInt32 group = 0; group < setting->GetMotionGroupCount(); ++group)
+    {
+        const csmChar* groupName = setting->GetMotionGroupName(group);
+        for (csmInt32 i = 0; i < setting->GetMotionCount(groupName); ++i)
+        {
+            motionBuffers.push_back(LAppTest::ReadResource(directory + setting->GetMotionFileName(groupName, i)));
+        }
+    }
+    std::vector<std::vector<csmByte> > expressionBuffers;
+    for (csmInt32 i = 0; i < setting->GetExpressionCount(); ++i)
+    {
+        expressionBuffers.push_back(LAppTest::ReadResource(directory + setting->GetExpressionFileName(i)));
+    }
+
+    const int repeatCount = 10;
+    double best = 0.0;
+    csmUint64 allocations = 0;
+    for (int repeat = 0; repeat < repeatCount; ++repeat)
+    {
+        const csmUint64 allocationStart = AllocationCount();
+        LAppTest::Timer timer;
+
+        LoadOnlyModel* model = CSM_NEW LoadOnlyModel();
+        model->LoadModel(mocBuffer.data(), static_cast<csmSizeInt>(mocBuffer.size()));
+        std::vector<ACubismMotion*> motions;
+        for (size_t i = 0; i < motionBuffers.size(); ++i)
+        {
+            motions.push_back(model->LoadMotion(motionBuffers[i].data(), static_cast<csmSizeInt>(motionBuffers[i].size()), "motion"));
+        }
+        for (size_t i = 0; i < expressionBuffers.size(); ++i)
+        {
+            motions.push_back(model->LoadExpression(expressionBuffers[i].data(), static_cast<csmSizeInt>(expressionBuffers[i].size()), "expression"));
+        }
+        model->LoadPhysics(physicsBuffer.data(), static_cast<csmSizeInt>(physicsBuffer.size()));
+        model->LoadPose(poseBuffer.data(), static_cast<csmSizeInt>(poseBuffer.size()));
+
+        const double elapsed = timer.ElapsedMilliseconds();
+        allocations = AllocationCount() - allocationStart;
+        if (repeat == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+
+        LAPP_TEST_CHECK(model->GetModel() != NULL);
+        for (size_t i = 0; i < motions.size(); ++i)
+        {
+            LAPP_TEST_CHECK(motions[i] != NULL);
+            ACubismMotion::Delete(motions[i]);
+        }
+        CSM_DELETE(model);
+    }
+
+    std::printf("load %s with %d motions and %d expressions: best %.3f ms, %llu allocations\n",
+                ModelFileName, static_cast<int>(motionBuffers.size()), static_cast<int>(expressionBuffers.size()), best, allocations);
+
+    CSM_DELETE(setting);
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    s_allocator = &allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestSmallVector();
+    TestInsertAndStringMove();
+    BenchmarkGrowth();
+    BenchmarkModelLoad();
+
+    return LAppTest::Finish("CsmVectorTest");
+}
@@ -0,0 +1,410 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <Model/CubismMoc.hpp>
+#include <Rendering/CubismClippingManager.hpp>
+#include <Rendering/CubismClippingMaskPacker.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace Live2D::Cubism::Framework;
+using namespace Live2D::Cubism::Framework::Rendering;
+
+namespace {
+
+typedef CubismClippingMaskPacker::Cell Cell;
+
+const int ChannelCount = 4;
+const int SetCount = 50;
+const char* MocPath = "Haru/Haru.moc3";
+const int OscillationFrameCount = 240;
+const csmInt32 ManyContextCount = 20;
+
+/**
+ * マスク用バッファの代わり。配置だけを調べるため中身は持たない
+ */
+class LayoutSurface
+{
+};
+
+/**
+ * 配置だけを調べるクリッピングコンテキスト
+ */
+class LayoutContext : public CubismClippingContext
+{
+public:
+    LayoutContext(CubismClippingManager<LayoutContext, LayoutSurface>* /*manager*/, CubismModel& /*model*/, const csmInt32* clippingDrawableIndices, csmInt32 clipCount)
+        : CubismClippingContext(clippingDrawableIndices, clipCount)
+    { }
+};
+
+/**
+ * レイアウトの更新を外から呼べるようにしたクリッピングマネージャ
+ */
+class LayoutManager : public CubismClippingManager<LayoutContext, LayoutSurface>
+{
+public:
+    using CubismClippingManager<LayoutContext, LayoutSurface>::UpdateLayoutBounds;
+
+    csmFloat32 GetPackedLayoutScale() const
+    {
+        return _packedLayoutScale;
+    }
+
+    // マスクの多いモデルの代わりに、コンテキストの数がcountになるまで、描画オブジェクトを持たないコンテキストを足す
+    void AddContexts(CubismModel& model, csmInt32 count)
+    {
+        while (static_cast<csmInt32>(_clippingContextListForMask.GetSize()) < count)
+        {
+            _clippingContextListForMask.PushBack(CSM_NEW LayoutContext(this, model, NULL, 0));
+        }
+
+        _maskPacker.Initialize(_renderTextureCount * ColorChannelCount, count);
+        _packedSizes.Resize(count * 2, 0.0f);
+        _packedCells.Resize(count);
+    }
+};
+
+LAppTest::Allocator* s_allocator = NULL;
+
+// 全てのセルが箱の中にあり、同じ箱のセル同士が重ならないことを確かめる
+bool IsValidLayout(const std::vector<Cell>& cells, int binWidth, int binHeight, int binCount)
+{
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        const Cell& a = cells[i];
+        if (a.X < 0 || a.Y < 0 || a.Width < 1 || a.Height < 1 ||
+            a.X + a.Width > binWidth || a.Y + a.Height > binHeight ||
+            a.BinIndex < 0 || a.BinIndex >= binCount)
+        {
+            return false;
+        }
+        for (size_t j = 0; j < i; ++j)
+        {
+            const Cell& b = cells[j];
+            if (a.BinIndex == b.BinIndex &&
+                a.X < b.X + b.Width && b.X < a.X + a.Width &&
+                a.Y < b.Y + b.Height && b.Y < a.Y + a.Height)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 箱をちょうど埋める数は収まり、1つ多いと収まらない
+void TestExactFit()
+{
+    const int binCount = ChannelCount;
+    const int cellCount = 16;
+
+    CubismClippingMaskPacker packer;
+    packer.Initialize(binCount, cellCount + 1);
+
+    std::vector<Cell> cells(cellCount + 1);
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        cells[i].Width = 128;
+        cells[i].Height = 128;
+    }
+
+    std::vector<Cell> fitting(cells.begin(), cells.begin() + cellCount);
+    LAPP_TEST_CHECK(packer.Pack(256, 256, fitting.data(), cellCount));
+    LAPP_TEST_CHECK(IsValidLayout(fitting, 256, 256, binCount));
+
+    LAPP_TEST_CHECK(!packer.Pack(256, 256, cells.data(), cellCount + 1));
+}
+
+// 箱より大きくなる矩形は縦横比を保って箱に収まる大きさで止まる
+void TestOversizedItem()
+{
+    CubismClippingMaskPacker packer;
+    packer.Initialize(ChannelCount, 2);
+
+    const csmFloat32 sizes[] = { 10.0f, 1.0f, 0.1f, 0.1f };
+    std::vector<Cell> cells(2);
+    const csmFloat32 scale = packer.PackScaled(256, 256, sizes, 2, cells.data());
+
+    LAPP_TEST_CHECK(scale > 0.0f);
+    LAPP_TEST_CHECK(cells[0].Width == 256);
+    LAPP_TEST_CHECK(cells[0].Height == 26);
+    LAPP_TEST_CHECK(IsValidLayout(cells, 256, 256, ChannelCount));
+}
+
+// 大きさが0の矩形も1ピクセルを確保する
+void TestEmptyItems()
+{
+    CubismClippingMaskPacker packer;
+    packer.Initialize(ChannelCount, 3);
+
+    const csmFloat32 sizes[] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    std::vector<Cell> cells(3);
+    LAPP_TEST_CHECK(packer.PackScaled(256, 256, sizes, 3, cells.data()) > 0.0f);
+    LAPP_TEST_CHECK(IsValidLayout(cells, 256, 256, ChannelCount));
+
+    LAPP_TEST_CHECK(packer.PackScaled(256, 256, sizes, 0, cells.data()) == 0.0f);
+}
+
+// ランダムな大きさの組を詰め、テクスチャ面積の使用率と処理時間を表示する
+void TestUtilization()
+{
+    std::mt19937 random(12345);
+    std::lognormal_distribution<float> sizeDistribution(-1.5f, 0.8f);
+    std::uniform_real_distribution<float> aspectDistribution(0.4f, 2.5f);
+
+    std::printf("utilization = packed cell area / texture area, %d random sets each\n", SetCount);
+    std::printf("%4s %5s %4s | %8s %8s | %9s\n", "tex", "size", "n", "util avg", "util min", "us/pack");
+
+    const int textureCounts[] = { 1, 2, 3 };
+    const int textureSizes[] = { 256, 512, 1024 };
+    const int maskCounts[] = { 1, 3, 4, 6, 9, 16, 24, 36 };
+
+    for (size_t t = 0; t < sizeof(textureCounts) / sizeof(textureCounts[0]); ++t)
+    {
+        for (size_t s = 0; s < sizeof(textureSizes) / sizeof(textureSizes[0]); ++s)
+        {
+            for (size_t m = 0; m < sizeof(maskCounts) / sizeof(maskCounts[0]); ++m)
+            {
+                const int textureCount = textureCounts[t];
+                const int textureSize = textureSizes[s];
+                const int maskCount = maskCounts[m];
+                const int binCount = textureCount * ChannelCount;
+
+                CubismClippingMaskPacker packer;
+                packer.Initialize(binCount, maskCount);
+                std::vector<csmFloat32> sizes(maskCount * 2);
+                std::vector<Cell> cells(maskCount);
+
+                double utilizationSum = 0.0;
+                double utilizationMin = 1.0;
+                double packTime = 0.0;
+                int invalidCount = 0;
+                csmUint64 allocations = 0;
+
+                for (int set = 0; set < SetCount; ++set)
+                {
+                    for (int i = 0; i < maskCount; ++i)
+                    {
+                        sizes[i * 2] = sizeDistribution(random);
+                        sizes[i * 2 + 1] = sizes[i * 2] * aspectDistribution(random);
+                    }
+
+                    const csmUint64 allocationStart = s_allocator->GetAllocationCount();
+                    LAppTest::Timer timer;
+                    const csmFloat32 scale = packer.PackScaled(textureSize, textureSize, sizes.data(), maskCount, cells.data());
+                    packTime += timer.ElapsedMilliseconds();
+                    allocations += s_allocator->GetAllocationCount() - allocationStart;
+
+                    if (scale <= 0.0f || !IsValidLayout(cells, textureSize, textureSize, binCount))
+                    {
+                        ++invalidCount;
+                        continue;
+                    }
+
+                    double area = 0.0;
+                    for (int i = 0; i < maskCount; ++i)
+                    {
+                        area += static_cast<double>(cells[i].Width) * cells[i].Height;
+                    }
+                    const double utilization = area / (static_cast<double>(binCount) * textureSize * textureSize);
+                    utilizationSum += utilization;
+                    utilizationMin = std::min(utilizationMin, utilization);
+                }
+
+                std::printf("%4d %5d %4d | %7.1f%% %7.1f%% | %9.2f\n", textureCount, textureSize, maskCount,
+                            100.0 * utilizationSum / SetCount, 100.0 * utilizationMin, 1000.0 * packTime / SetCount);
+
+                LAPP_TEST_CHECK(invalidCount == 0);
+                // 詰める処理の中では確保しない
+                LAPP_TEST_CHECK(allocations == 0);
+            }
+        }
+    }
+}
+
+// 全てのコンテキストの囲み矩形を、基準の大きさに倍率を掛けた大きさにする。倍率はコンテキストごとに位相をずらして揺らす
+void SetOscillatedRects(LayoutManager& manager, const std::vector<csmRectF>& baseRects, int frame, csmFloat32 amplitude)
+{
+    csmVector<LayoutContext*>& contexts = *manager.GetClippingContextListForMask();
+    for (csmUint32 i = 0; i < contexts.GetSize(); ++i)
+    {
+        const csmFloat32 scaleX = 1.0f + amplitude * sinf(frame * 0.21f + i * 0.7f);
+        const csmFloat32 scaleY = 1.0f + amplitude * cosf(frame * 0.17f + i * 1.3f);
+        contexts[i]->_isUsing = true;
+        contexts[i]->_allClippedDrawRect->X = baseRects[i].X;
+        contexts[i]->_allClippedDrawRect->Y = baseRects[i].Y;
+        contexts[i]->_allClippedDrawRect->Width = baseRects[i].Width * scaleX;
+        contexts[i]->_allClippedDrawRect->Height = baseRects[i].Height * scaleY;
+    }
+}
+
+// 全てのコンテキストの割り当て領域とチャンネルを取り出す
+std::vector<csmFloat32> GetLayout(LayoutManager& manager)
+{
+    std::vector<csmFloat32> layout;
+    csmVector<LayoutContext*>& contexts = *manager.GetClippingContextListForMask();
+    for (csmUint32 i = 0; i < contexts.GetSize(); ++i)
+    {
+        layout.push_back(contexts[i]->_layoutBounds->X);
+        layout.push_back(contexts[i]->_layoutBounds->Y);
+        layout.push_back(contexts[i]->_layoutBounds->Width);
+        layout.push_back(contexts[i]->_layoutBounds->Height);
+        layout.push_back(static_cast<csmFloat32>(contexts[i]->_layoutChannelIndex + ChannelCount * contexts[i]->_bufferIndex));
+    }
+    return layout;
+}
+
+// 全てのコンテキストの囲み矩形を求め、足したコンテキストにはHaruの矩形を順に使う
+std::vector<csmRectF> GetBaseRects(LayoutManager& manager, CubismModel& model, csmInt32 modelContextCount)
+{
+    std::vector<csmRectF> baseRects;
+    csmVector<LayoutContext*>& contexts = *manager.GetClippingContextListForMask();
+    for (csmUint32 i = 0; i < contexts.GetSize(); ++i)
+    {
+        if (static_cast<csmInt32>(i) < modelContextCount)
+        {
+            manager.CalcClippedDrawTotalBounds(model, contexts[i]);
+            baseRects.push_back(*contexts[i]->_allClippedDrawRect);
+        }
+        else
+        {
+            baseRects.push_back(baseRects[i % modelContextCount]);
+        }
+    }
+    return baseRects;
+}
+
+// マスクを詰めて配置し、大きさが15%以内で揺れる間は配置を使い続け、それを超えると配置し直すことを確かめる
+void TestPackedLayoutReuse(CubismModel& model, csmInt32 contextCount, csmFloat32 bufferSize)
+{
+    LayoutManager manager;
+    manager.Initialize(model, 1);
+    const csmInt32 modelContextCount = static_cast<csmInt32>(manager.GetClippingContextListForMask()->GetSize());
+    manager.AddContexts(model, std::max(modelContextCount, contextCount));
+    manager.SetClippingMaskBufferSize(bufferSize, bufferSize);
+    manager.SetUsingPackedLayout(true);
+
+    csmVector<LayoutContext*>& contexts = *manager.GetClippingContextListForMask();
+    contextCount = static_cast<csmInt32>(contexts.GetSize());
+    LAPP_TEST_CHECK(contextCount > 0);
+    const std::vector<csmRectF> baseRects = GetBaseRects(manager, model, modelContextCount);
+
+    SetOscillatedRects(manager, baseRects, 0, 0.0f);
+    LAPP_TEST_CHECK(manager.UpdateLayoutBounds(contextCount));
+    LAPP_TEST_CHECK(manager.GetPackedLayoutScale() > 0.0f);
+    const std::vector<csmFloat32> packedLayout = GetLayout(manager);
+
+    // 5%の揺れでは一度も配置し直さない
+    int relayoutCount = 0;
+    for (int frame = 1; frame <= OscillationFrameCount; ++frame)
+    {
+        SetOscillatedRects(manager, baseRects, frame, 0.05f);
+        relayoutCount += manager.UpdateLayoutBounds(contextCount) ? 1 : 0;
+    }
+    LAPP_TEST_CHECK(relayoutCount == 0);
+    LAPP_TEST_CHECK(GetLayout(manager) == packedLayout);
+
+    // 最も小さいマスクの幅が40%広がると配置し直し、その後は新しい配置を使い続ける
+    // 箱の大きさで止まっているマスクも縦横比が変わるため、領域の高さが変わる
+    csmInt32 smallest = 0;
+    for (csmInt32 i = 1; i < contextCount; ++i)
+    {
+        if (baseRects[i].Width * baseRects[i].Height < baseRects[smallest].Width * baseRects[smallest].Height)
+        {
+            smallest = i;
+        }
+    }
+    SetOscillatedRects(manager, baseRects, 0, 0.0f);
+    contexts[smallest]->_allClippedDrawRect->Width *= 1.4f;
+    LAPP_TEST_CHECK(manager.UpdateLayoutBounds(contextCount));
+    LAPP_TEST_CHECK(!manager.UpdateLayoutBounds(contextCount));
+    LAPP_TEST_CHECK(GetLayout(manager) != packedLayout);
+
+    std::printf("%d masks in %.0fx%.0f: packed layout reused for %d frames within %.0f%%\n",
+        contextCount, bufferSize, bufferSize, OscillationFrameCount, 100.0f * PackedLayoutSizeTolerance);
+}
+
+// 詰めきれない場合は固定の分割に戻り、大きさが変わっても使用中の数が変わるまでそのままになることを確かめる
+void TestPackedLayoutFallback(CubismModel& model)
+{
+    LayoutManager manager;
+    manager.Initialize(model, 1);
+    const csmInt32 modelContextCount = static_cast<csmInt32>(manager.GetClippingContextListForMask()->GetSize());
+    manager.AddContexts(model, ManyContextCount);
+    manager.SetUsingPackedLayout(true);
+    const std::vector<csmRectF> baseRects = GetBaseRects(manager, model, modelContextCount);
+
+    // 2x2のバッファの4チャンネルには1ピクセルずつでも16個しか入らない
+    manager.SetClippingMaskBufferSize(2.0f, 2.0f);
+    SetOscillatedRects(manager, baseRects, 0, 0.0f);
+    LAPP_TEST_CHECK(manager.UpdateLayoutBounds(ManyContextCount));
+    LAPP_TEST_CHECK(manager.GetPackedLayoutScale() <= 0.0f);
+    const std::vector<csmFloat32> fallbackLayout = GetLayout(manager);
+    manager.SetupLayoutBounds(ManyContextCount);
+    LAPP_TEST_CHECK(GetLayout(manager) == fallbackLayout);
+
+    int relayoutCount = 0;
+    for (int frame = 1; frame <= OscillationFrameCount; ++frame)
+    {
+        SetOscillatedRects(manager, baseRects, frame, 0.5f);
+        relayoutCount += manager.UpdateLayoutBounds(ManyContextCount) ? 1 : 0;
+    }
+    LAPP_TEST_CHECK(relayoutCount == 0);
+    LAPP_TEST_CHECK(GetLayout(manager) == fallbackLayout);
+
+    // 使用中の数が変わると、詰めて配置することを再び試みる
+    csmVector<LayoutContext*>& contexts = *manager.GetClippingContextListForMask();
+    for (csmInt32 i = 16; i < ManyContextCount; ++i)
+    {
+        contexts[i]->_isUsing = false;
+    }
+    LAPP_TEST_CHECK(manager.UpdateLayoutBounds(16));
+    LAPP_TEST_CHECK(manager.GetPackedLayoutScale() > 0.0f);
+    LAPP_TEST_CHECK(contexts[ManyContextCount - 1]->_layoutBounds->Width == 0.0f);
+}
+
+// Haruのモデルで配置の再利用と固定の分割への切り替えを調べる
+void TestPackedLayoutWithModel()
+{
+    const std::vector<csmByte> mocBuffer = LAppTest::ReadResource(MocPath);
+    CubismMoc* moc = CubismMoc::Create(mocBuffer.data(), static_cast<csmSizeInt>(mocBuffer.size()));
+    LAPP_TEST_CHECK(moc != NULL);
+    if (moc == NULL)
+    {
+        return;
+    }
+    CubismModel* model = moc->CreateModel();
+    model->Update();
+
+    // Haruのマスクだけの場合と、共通の倍率で詰める数のマスクがある場合
+    TestPackedLayoutReuse(*model, 0, 1024.0f);
+    TestPackedLayoutReuse(*model, ManyContextCount, 256.0f);
+    TestPackedLayoutFallback(*model);
+
+    moc->DeleteModel(model);
+    CubismMoc::Delete(moc);
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    s_allocator = &allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestExactFit();
+    TestOversizedItem();
+    TestEmptyItems();
+    TestUtilization();
+    TestPackedLayoutWithModel();
+
+    return LAppTest::Finish("CubismClippingMaskPackerTest");
+}
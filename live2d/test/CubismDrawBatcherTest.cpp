@@ -0,0 +1,303 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <CubismModelSettingJson.hpp>
+#include <Model/CubismUserModel.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <Rendering/Null/CubismRenderer_Null.hpp>
+
+using namespace Live2D::Cubism::Framework;
+using namespace Live2D::Cubism::Framework::Rendering;
+
+namespace {
+
+typedef CubismRenderCommandList::Command Command;
+
+const char* ModelDirectory = "Haru/";
+const char* ModelFileName = "Haru.model3.json";
+const int FrameCount = 600;
+const int CheckInterval = 30;
+const csmFloat32 DeltaTimeSeconds = 1.0f / 60.0f;
+
+/**
+ * 全モーションを順に再生し、Nullレンダラで描画命令を作るモデル
+ */
+class BatchModel : public CubismUserModel
+{
+public:
+    BatchModel() : _nextMotion(0) {}
+
+    virtual ~BatchModel()
+    {
+        for (size_t i = 0; i < _motions.size(); ++i)
+        {
+            ACubismMotion::Delete(_motions[i]);
+        }
+    }
+
+    csmBool Setup()
+    {
+        const std::string directory = ModelDirectory;
+        const std::vector<csmByte> settingBuffer = LAppTest::ReadResource(directory + ModelFileName);
+        if (settingBuffer.empty())
+        {
+            return false;
+        }
+        CubismModelSettingJson setting(settingBuffer.data(), static_cast<csmSizeInt>(settingBuffer.size()));
+
+        const std::vector<csmByte> mocBuffer = LAppTest::ReadResource(directory + setting.GetModelFileName());
+        LoadModel(mocBuffer.data(), static_cast<csmSizeInt>(mocBuffer.size()));
+        if (_model == NULL)
+        {
+            return false;
+        }
+
+        for (csmInt32 group = 0; group < setting.GetMotionGroupCount(); ++group)
+        {
+            const csmChar* groupName = setting.GetMotionGroupName(group);
+            for (csmInt32 i = 0; i < setting.GetMotionCount(groupName); ++i)
+            {
+                const std::vector<csmByte> buffer = LAppTest::ReadResource(directory + setting.GetMotionFileName(groupName, i));
+                _motions.push_back(LoadMotion(buffer.data(), static_cast<csmSizeInt>(buffer.size()), groupName));
+            }
+        }
+        const std::vector<csmByte> physicsBuffer = LAppTest::ReadResource(directory + setting.GetPhysicsFileName());
+        LoadPhysics(physicsBuffer.data(), static_cast<csmSizeInt>(physicsBuffer.size()));
+
+        CreateRenderer();
+        return !_motions.empty();
+    }
+
+    void Update(csmFloat32 deltaTimeSeconds)
+    {
+        _model->LoadParameters();
+        if (_motionManager->IsFinished())
+        {
+            _motionManager->StartMotionPriority(_motions[_nextMotion], false, 1);
+            _nextMotion = (_nextMotion + 1) % _motions.size();
+        }
+        else
+        {
+            _motionManager->UpdateMotion(_model, deltaTimeSeconds);
+        }
+        _model->SaveParameters();
+        _physics->Evaluate(_model, deltaTimeSeconds);
+        _model->Update();
+    }
+
+private:
+    std::vector<ACubismMotion*> _motions;
+    size_t _nextMotion;
+};
+
+void AppendColor(std::vector<csmFloat32>& stream, const CubismRenderer::CubismTextureColor& color)
+{
+    stream.push_back(color.R);
+    stream.push_back(color.G);
+    stream.push_back(color.B);
+    stream.push_back(color.A);
+}
+
+// 描画オブジェクトの三角形の頂点を、まとめずに描いた場合にシェーダへ渡る値として並べる
+void AppendDrawableVertices(std::vector<csmFloat32>& stream, const CubismModel& model, const CubismRenderer& renderer, const Command& command)
+{
+    const csmInt32 drawableIndex = command.DrawableIndex;
+    const csmFloat32* positions = model.GetDrawableVertices(drawableIndex);
+    const csmFloat32* uvs = reinterpret_cast<const csmFloat32*>(model.GetDrawableVertexUvs(drawableIndex));
+    const csmUint16* indices = model.GetDrawableVertexIndices(drawableIndex);
+    const csmInt32 indexCount = model.GetDrawableVertexIndexCount(drawableIndex);
+
+    for (csmInt32 i = 0; i < indexCount; ++i)
+    {
+        const csmInt32 vertex = indices[i];
+        stream.push_back(positions[vertex * 2]);
+        stream.push_back(positions[vertex * 2 + 1]);
+        stream.push_back(uvs[vertex * 2]);
+        stream.push_back(uvs[vertex * 2 + 1]);
+        if (command.Type == CubismRenderCommandList::CommandType_Draw)
+        {
+            AppendColor(stream, renderer.GetModelColorWithOpacity(model.GetDrawableOpacity(drawableIndex)));
+            AppendColor(stream, model.GetMultiplyColor(drawableIndex));
+            AppendColor(stream, model.GetScreenColor(drawableIndex));
+        }
+    }
+}
+
+// まとめた描画の三角形の頂点を同じ形式で並べる
+void AppendBatchVertices(std::vector<csmFloat32>& stream, const CubismModel& model, const CubismRenderer& renderer,
+                         const CubismDrawBatcher& batcher, const CubismDrawBatcher::Batch& batch, const Command& first)
+{
+    const csmFloat32* positions = batcher.GetVertexPositions();
+    const csmFloat32* uvs = batcher.GetVertexUvs();
+    const csmUint16* indices = batcher.GetIndices();
+
+    for (csmInt32 i = batch.IndexOffset; i < batch.IndexOffset + batch.IndexCount; ++i)
+    {
+        const csmInt32 vertex = batch.VertexOffset + indices[i];
+        stream.push_back(positions[vertex * 2]);
+        stream.push_back(positions[vertex * 2 + 1]);
+        stream.push_back(uvs[vertex * 2]);
+        stream.push_back(uvs[vertex * 2 + 1]);
+        if (first.Type != CubismRenderCommandList::CommandType_Draw)
+        {
+            continue;
+        }
+        if (batch.HasVertexColors)
+        {
+            stream.insert(stream.end(), batcher.GetVertexBaseColors() + vertex * 4, batcher.GetVertexBaseColors() + vertex * 4 + 4);
+            stream.insert(stream.end(), batcher.GetVertexMultiplyColors() + vertex * 4, batcher.GetVertexMultiplyColors() + vertex * 4 + 4);
+            stream.insert(stream.end(), batcher.GetVertexScreenColors() + vertex * 4, batcher.GetVertexScreenColors() + vertex * 4 + 4);
+        }
+        else
+        {
+            // 先頭の描画オブジェクトの色をそのまま使う
+            AppendColor(stream, renderer.GetModelColorWithOpacity(model.GetDrawableOpacity(first.DrawableIndex)));
+            AppendColor(stream, model.GetMultiplyColor(first.DrawableIndex));
+            AppendColor(stream, model.GetScreenColor(first.DrawableIndex));
+        }
+    }
+}
+
+bool IsSameState(const Command& a, const Command& b)
+{
+    return a.Type == b.Type && a.ClipContext == b.ClipContext && a.BufferIndex == b.BufferIndex
+        && a.ShaderVariant == b.ShaderVariant && a.BlendMode == b.BlendMode
+        && a.TextureIndex == b.TextureIndex && a.IsCulling == b.IsCulling;
+}
+
+bool IsDrawCommand(const Command& command)
+{
+    return command.Type == CubismRenderCommandList::CommandType_Draw
+        || command.Type == CubismRenderCommandList::CommandType_DrawMask;
+}
+
+/**
+ * 描画回数の集計
+ */
+struct DrawCounts
+{
+    DrawCounts() : DrawableDraws(0), BatchedDraws(0), ColoredBatches(0) {}
+
+    long DrawableDraws;     ///< 描画オブジェクトごとに描いた場合の描画回数
+    long BatchedDraws;      ///< まとめた場合の描画回数
+    long ColoredBatches;    ///< 頂点ごとの色を使ったまとめた描画の数
+};
+
+// まとめた描画が全ての命令を順に1回ずつ含み、描画オブジェクトごとに描いた場合と同じ頂点を出すことを確かめる
+void CheckBatches(const CubismModel& model, const CubismRenderer_Null& renderer, DrawCounts& counts)
+{
+    const CubismRenderCommandList& commandList = renderer.GetCommandList();
+    const CubismDrawBatcher& batcher = renderer.GetDrawBatcher();
+
+    std::vector<csmFloat32> expected;
+    std::vector<csmFloat32> actual;
+    csmInt32 nextCommand = 0;
+
+    for (csmInt32 b = 0; b < batcher.GetBatchCount(); ++b)
+    {
+        const CubismDrawBatcher::Batch& batch = batcher.GetBatch(b);
+        LAPP_TEST_CHECK(batch.FirstCommand == nextCommand);
+        LAPP_TEST_CHECK(batch.CommandCount >= 1);
+        nextCommand = batch.FirstCommand + batch.CommandCount;
+        if (nextCommand > commandList.GetCommandCount())
+        {
+            break;
+        }
+
+        const Command& first = commandList.GetCommand(batch.FirstCommand);
+        for (csmInt32 c = batch.FirstCommand; c < nextCommand; ++c)
+        {
+            const Command& command = commandList.GetCommand(c);
+            LAPP_TEST_CHECK(IsSameState(first, command));
+            if (IsDrawCommand(command))
+            {
+                AppendDrawableVertices(expected, model, renderer, command);
+                ++counts.DrawableDraws;
+            }
+        }
+
+        if (!IsDrawCommand(first))
+        {
+            continue;
+        }
+        ++counts.BatchedDraws;
+        if (batch.CommandCount == 1)
+        {
+            // まとめていない描画はモデルの頂点をそのまま描く
+            AppendDrawableVertices(actual, model, renderer, first);
+        }
+        else
+        {
+            AppendBatchVertices(actual, model, renderer, batcher, batch, first);
+            counts.ColoredBatches += batch.HasVertexColors ? 1 : 0;
+        }
+    }
+
+    LAPP_TEST_CHECK(nextCommand == commandList.GetCommandCount());
+    LAPP_TEST_CHECK(expected == actual);
+}
+
+// 通常のマスクと高精細マスクのそれぞれで、アニメーション中のフレームを確かめる
+void TestBatchesMatchDrawables(csmBool isUsingHighPrecisionMask)
+{
+    BatchModel* model = CSM_NEW BatchModel();
+    LAPP_TEST_CHECK(model->Setup());
+
+    CubismModel* cubismModel = model->GetModel();
+    CubismRenderer_Null* renderer = model->GetRenderer<CubismRenderer_Null>();
+    LAPP_TEST_CHECK(renderer != NULL);
+    if (cubismModel == NULL || renderer == NULL)
+    {
+        CSM_DELETE(model);
+        return;
+    }
+    renderer->UseDrawBatching(true);
+    renderer->UseHighPrecisionMask(isUsingHighPrecisionMask);
+
+    // 一部の描画オブジェクトに乗算色を設定し、まとめた中で色が異なる場合も確かめる
+    for (csmInt32 i = 0; i < cubismModel->GetDrawableCount(); i += 3)
+    {
+        cubismModel->SetOverwriteFlagForDrawableMultiplyColors(i, true);
+        cubismModel->SetMultiplyColor(i, 1.0f, 0.5f + 0.5f * (i % 2), 0.25f, 1.0f);
+    }
+
+    DrawCounts counts;
+    for (int frame = 0; frame < FrameCount; ++frame)
+    {
+        model->Update(DeltaTimeSeconds);
+        if (frame % CheckInterval != 0)
+        {
+            continue;
+        }
+        renderer->DrawModel();
+        CheckBatches(*cubismModel, *renderer, counts);
+    }
+
+    std::printf("%s masks: %ld draws per-drawable, %ld draws batched (%.2fx), %ld batches with vertex colors\n",
+                isUsingHighPrecisionMask ? "high precision" : "shared", counts.DrawableDraws, counts.BatchedDraws,
+                static_cast<double>(counts.DrawableDraws) / counts.BatchedDraws, counts.ColoredBatches);
+    LAPP_TEST_CHECK(counts.BatchedDraws < counts.DrawableDraws);
+    LAPP_TEST_CHECK(counts.ColoredBatches > 0);
+
+    CSM_DELETE(model);
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestBatchesMatchDrawables(false);
+    TestBatchesMatchDrawables(true);
+
+    return LAppTest::Finish("CubismDrawBatcherTest");
+}
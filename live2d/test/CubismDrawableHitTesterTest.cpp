@@ -0,0 +1,376 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <CubismModelSettingJson.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <Math/CubismModelMatrix.hpp>
+#include <Model/CubismDrawableHitTester.hpp>
+#include <Model/CubismUserModel.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace Live2D::Cubism::Framework;
+
+namespace {
+
+const csmFloat32 DeltaTimeSeconds = 1.0f / 60.0f;
+const int CheckFrameCount = 300;
+const int CheckInterval = 3;            ///< 総当たりと比べるフレームの間隔
+const int PointsPerDrawable = 8;        ///< 1フレームでDrawableごとに判定する点の数
+const int TapFrameCount = 120;
+const int SceneModelCounts[] = { 1, 2, 4, 8 };
+
+/**
+ * @brief Haruの全モーションを順に再生するモデル
+ */
+class HitModel : public CubismUserModel
+{
+public:
+    HitModel() : _nextMotion(0) {}
+
+    virtual ~HitModel()
+    {
+        for (size_t i = 0; i < _motions.size(); ++i)
+        {
+            ACubismMotion::Delete(_motions[i]);
+        }
+    }
+
+    // モデル、物理演算、全モーションとヒット領域を読み込む
+    bool Setup()
+    {
+        const std::string directory = "Haru/";
+        const std::vector<csmByte> settingBuffer = LAppTest::ReadResource(directory + "Haru.model3.json");
+        if (settingBuffer.empty())
+        {
+            return false;
+        }
+        CubismModelSettingJson setting(settingBuffer.data(), static_cast<csmSizeInt>(settingBuffer.size()));
+
+        const std::vector<csmByte> mocBuffer = LAppTest::ReadResource(directory + setting.GetModelFileName());
+        LoadModel(mocBuffer.data(), static_cast<csmSizeInt>(mocBuffer.size()));
+        if (_model == NULL)
+        {
+            return false;
+        }
+
+        for (csmInt32 group = 0; group < setting.GetMotionGroupCount(); ++group)
+        {
+            const csmChar* groupName = setting.GetMotionGroupName(group);
+            for (csmInt32 i = 0; i < setting.GetMotionCount(groupName); ++i)
+            {
+                const std::vector<csmByte> buffer = LAppTest::ReadResource(directory + setting.GetMotionFileName(groupName, i));
+                _motions.push_back(LoadMotion(buffer.data(), static_cast<csmSizeInt>(buffer.size()), groupName));
+            }
+        }
+        const std::vector<csmByte> physicsBuffer = LAppTest::ReadResource(directory + setting.GetPhysicsFileName());
+        LoadPhysics(physicsBuffer.data(), static_cast<csmSizeInt>(physicsBuffer.size()));
+
+        for (csmInt32 i = 0; i < setting.GetHitAreasCount(); ++i)
+        {
+            _hitAreaIds.push_back(setting.GetHitAreaId(i));
+        }
+        return !_motions.empty() && !_hitAreaIds.empty();
+    }
+
+    // 1フレーム分パラメータを更新する。再生が終わったら次のモーションに切り替える
+    void Update()
+    {
+        if (_motionManager->IsFinished())
+        {
+            _motionManager->StartMotionPriority(_motions[_nextMotion], false, 1);
+            _nextMotion = (_nextMotion + 1) % _motions.size();
+        }
+        _model->LoadParameters();
+        _motionManager->UpdateMotion(_model, DeltaTimeSeconds);
+        _model->SaveParameters();
+        _physics->Evaluate(_model, DeltaTimeSeconds);
+        _model->Update();
+    }
+
+    // ヒット領域を定義順に判定する
+    bool IsHitAnyArea(csmFloat32 x, csmFloat32 y)
+    {
+        for (size_t i = 0; i < _hitAreaIds.size(); ++i)
+        {
+            if (IsHit(_hitAreaIds[i], x, y))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::vector<ACubismMotion*> _motions;
+    std::vector<CubismIdHandle> _hitAreaIds;
+    size_t _nextMotion;
+};
+
+// 面積が0でない三角形を全て調べ、辺の上を含めて点を含むものがあるかを判定する
+bool IsHitBruteForce(const CubismModel& model, csmInt32 drawableIndex, csmFloat32 x, csmFloat32 y)
+{
+    const csmFloat32* vertices = model.GetDrawableVertices(drawableIndex);
+    const csmUint16* indices = model.GetDrawableVertexIndices(drawableIndex);
+    const csmInt32 indexCount = model.GetDrawableVertexIndexCount(drawableIndex);
+
+    for (csmInt32 i = 0; i + 2 < indexCount; i += 3)
+    {
+        const csmFloat32* a = vertices + indices[i] * 2;
+        const csmFloat32* b = vertices + indices[i + 1] * 2;
+        const csmFloat32* c = vertices + indices[i + 2] * 2;
+        if ((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]) == 0.0f)
+        {
+            continue;
+        }
+
+        const csmFloat32 d0 = (b[0] - a[0]) * (y - a[1]) - (b[1] - a[1]) * (x - a[0]);
+        const csmFloat32 d1 = (c[0] - b[0]) * (y - b[1]) - (c[1] - b[1]) * (x - b[0]);
+        const csmFloat32 d2 = (a[0] - c[0]) * (y - c[1]) - (a[1] - c[1]) * (x - c[0]);
+        const bool hasNegative = d0 < 0.0f || d1 < 0.0f || d2 < 0.0f;
+        const bool hasPositive = d0 > 0.0f || d1 > 0.0f || d2 > 0.0f;
+        if (!(hasNegative && hasPositive))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 動いているHaruの全Drawableで、頂点の上の点と矩形の周りの点を総当たりの判定と比べる
+void TestMatchesBruteForce()
+{
+    HitModel* model = CSM_NEW HitModel();
+    LAPP_TEST_CHECK(model->Setup());
+    const CubismModel& cubismModel = *model->GetModel();
+
+    CubismDrawableHitTester hitTester;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<csmFloat32> position(-0.1f, 1.1f);
+    long checkCount = 0;
+    long hitCount = 0;
+    int mismatchCount = 0;
+
+    for (int frame = 0; frame < CheckFrameCount; ++frame)
+    {
+        model->Update();
+        if (frame % CheckInterval != 0)
+        {
+            continue;
+        }
+
+        for (csmInt32 drawable = 0; drawable < cubismModel.GetDrawableCount(); ++drawable)
+        {
+            const CubismModel::DrawableBounds& bounds = cubismModel.GetDrawableBounds(drawable);
+            for (int k = 0; k < PointsPerDrawable; ++k)
+            {
+                csmFloat32 x = bounds.MinX + position(random) * (bounds.MaxX - bounds.MinX);
+                csmFloat32 y = bounds.MinY + position(random) * (bounds.MaxY - bounds.MinY);
+                if (k == 0 && cubismModel.GetDrawableVertexCount(drawable) > 0)
+                {
+                    x = cubismModel.GetDrawableVertices(drawable)[0];
+                    y = cubismModel.GetDrawableVertices(drawable)[1];
+                }
+
+                const bool expected = IsHitBruteForce(cubismModel, drawable, x, y);
+                ++checkCount;
+                hitCount += expected ? 1 : 0;
+                if (hitTester.IsHit(cubismModel, drawable, x, y) != expected)
+                {
+                    if (mismatchCount < 5)
+                    {
+                        std::printf("  frame %d drawable %d (%f, %f) differs from brute force\n", frame, drawable, x, y);
+                    }
+                    ++mismatchCount;
+                }
+            }
+        }
+    }
+
+    std::printf("%ld queries over %d drawables, %ld hits, %d mismatches, %d trees built\n",
+                checkCount, cubismModel.GetDrawableCount(), hitCount, mismatchCount, hitTester.GetBuildCount());
+    LAPP_TEST_CHECK(checkCount == static_cast<long>(CheckFrameCount / CheckInterval) * cubismModel.GetDrawableCount() * PointsPerDrawable);
+    LAPP_TEST_CHECK(hitCount > 0 && hitCount < checkCount);
+    LAPP_TEST_CHECK(mismatchCount == 0);
+
+    CSM_DELETE(model);
+}
+
+// 階層は判定したDrawableにだけ作られ、頂点が変わったDrawableだけが作り直されることを確かめる
+void TestLazyRebuild()
+{
+    HitModel* model = CSM_NEW HitModel();
+    LAPP_TEST_CHECK(model->Setup());
+    CubismModel& cubismModel = *model->GetModel();
+    const csmInt32 drawableCount = cubismModel.GetDrawableCount();
+
+    // 判定していないDrawableの階層は作らない
+    CubismDrawableHitTester hitTester;
+    for (csmInt32 drawable = 0; drawable < drawableCount; drawable += 2)
+    {
+        hitTester.IsHit(cubismModel, drawable, 0.0f, 0.0f);
+    }
+    LAPP_TEST_CHECK(hitTester.GetBuildCount() == (drawableCount + 1) / 2);
+
+    // 頂点が変わらなければ、何度判定しても作り直さない
+    for (int round = 0; round < 3; ++round)
+    {
+        for (csmInt32 drawable = 0; drawable < drawableCount; ++drawable)
+        {
+            hitTester.IsHit(cubismModel, drawable, 0.0f, 0.0f);
+        }
+    }
+    LAPP_TEST_CHECK(hitTester.GetBuildCount() == drawableCount);
+
+    // 同じパラメータで更新しても頂点は変わらないため、作り直さない
+    cubismModel.LoadParameters();
+    cubismModel.Update();
+    for (csmInt32 drawable = 0; drawable < drawableCount; ++drawable)
+    {
+        hitTester.IsHit(cubismModel, drawable, 0.0f, 0.0f);
+    }
+    LAPP_TEST_CHECK(hitTester.GetBuildCount() == drawableCount);
+
+    // 目を閉じた後は頂点が変わったDrawableだけを作り直す。判定の間に複数回更新しても1回で済む
+    std::vector<csmUint32> revisions(drawableCount);
+    for (csmInt32 drawable = 0; drawable < drawableCount; ++drawable)
+    {
+        revisions[drawable] = cubismModel.GetDrawableVertexRevision(drawable);
+    }
+    const CubismIdHandle eyeOpenId = CubismFramework::GetIdManager()->GetId("ParamEyeLOpen");
+    const csmFloat32 eyeOpenValues[] = { 0.5f, 0.2f, 0.0f };
+    for (size_t i = 0; i < sizeof(eyeOpenValues) / sizeof(eyeOpenValues[0]); ++i)
+    {
+        cubismModel.SetParameterValue(eyeOpenId, eyeOpenValues[i]);
+        cubismModel.Update();
+    }
+    int changedCount = 0;
+    for (csmInt32 drawable = 0; drawable < drawableCount; ++drawable)
+    {
+        changedCount += (cubismModel.GetDrawableVertexRevision(drawable) != revisions[drawable]) ? 1 : 0;
+    }
+    const csmInt32 buildCount = hitTester.GetBuildCount();
+    for (int round = 0; round < 2; ++round)
+    {
+        for (csmInt32 drawable = 0; drawable < drawableCount; ++drawable)
+        {
+            hitTester.IsHit(cubismModel, drawable, 0.0f, 0.0f);
+        }
+    }
+    std::printf("closing the left eye moved %d of %d drawables, %d trees rebuilt\n",
+                changedCount, drawableCount, hitTester.GetBuildCount() - buildCount);
+    LAPP_TEST_CHECK(changedCount > 0 && changedCount < drawableCount);
+    LAPP_TEST_CHECK(hitTester.GetBuildCount() - buildCount == changedCount);
+
+    CSM_DELETE(model);
+}
+
+// モデルを横に並べたシーン
+std::vector<HitModel*> CreateScene(int modelCount, bool isPrecise)
+{
+    std::vector<HitModel*> scene;
+    for (int i = 0; i < modelCount; ++i)
+    {
+        HitModel* model = CSM_NEW HitModel();
+        LAPP_TEST_CHECK(model->Setup());
+        model->UsePreciseHitTest(isPrecise);
+        model->GetModelMatrix()->SetWidth(2.0f);
+        model->GetModelMatrix()->TranslateX(-0.6f + 1.2f * i / std::max(modelCount - 1, 1));
+        scene.push_back(model);
+    }
+    return scene;
+}
+
+// 後に描くモデルから順にヒット領域を判定し、最初に当たったモデルのインデックスを返す。LAppLive2DManager::FindHitModelと同じ順
+int FindHitModel(const std::vector<HitModel*>& scene, csmFloat32 x, csmFloat32 y)
+{
+    for (int i = static_cast<int>(scene.size()) - 1; i >= 0; --i)
+    {
+        if (scene[i]->IsHitAnyArea(x, y))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 毎フレーム全モデルの頂点が変わる最悪の場合に、シーン全体のタップ1回の判定時間を矩形だけの判定と比べる
+void TestSceneTapBenchmark()
+{
+    std::printf("scene tap with all models animated, mean / worst per tap\n");
+    for (size_t s = 0; s < sizeof(SceneModelCounts) / sizeof(SceneModelCounts[0]); ++s)
+    {
+        const int modelCount = SceneModelCounts[s];
+        std::vector<HitModel*> rectangleScene = CreateScene(modelCount, false);
+        std::vector<HitModel*> preciseScene = CreateScene(modelCount, true);
+
+        std::mt19937 random(11);
+        std::uniform_real_distribution<csmFloat32> position(-1.0f, 1.0f);
+        double rectangleMicroseconds = 0.0;
+        double preciseMicroseconds = 0.0;
+        double preciseWorstMicroseconds = 0.0;
+        int rectangleHitCount = 0;
+        int preciseHitCount = 0;
+        int narrowedCount = 0;
+
+        for (int frame = 0; frame < TapFrameCount; ++frame)
+        {
+            for (int i = 0; i < modelCount; ++i)
+            {
+                rectangleScene[i]->Update();
+                preciseScene[i]->Update();
+            }
+            const csmFloat32 x = position(random);
+            const csmFloat32 y = position(random);
+
+            LAppTest::Timer rectangleTimer;
+            const int rectangleHit = FindHitModel(rectangleScene, x, y);
+            rectangleMicroseconds += rectangleTimer.ElapsedMilliseconds() * 1000.0;
+
+            LAppTest::Timer preciseTimer;
+            const int preciseHit = FindHitModel(preciseScene, x, y);
+            const double microseconds = preciseTimer.ElapsedMilliseconds() * 1000.0;
+            preciseMicroseconds += microseconds;
+            preciseWorstMicroseconds = std::max(preciseWorstMicroseconds, microseconds);
+
+            rectangleHitCount += (rectangleHit >= 0) ? 1 : 0;
+            preciseHitCount += (preciseHit >= 0) ? 1 : 0;
+            narrowedCount += (preciseHit != rectangleHit) ? 1 : 0;
+        }
+
+        std::printf("  %d models: triangles %6.2f / %6.2f us (%3d hits), rectangles %5.2f us (%3d hits), %d taps resolved differently\n",
+                    modelCount, preciseMicroseconds / TapFrameCount, preciseWorstMicroseconds, preciseHitCount,
+                    rectangleMicroseconds / TapFrameCount, rectangleHitCount, narrowedCount);
+
+        // 三角形はヒット領域の矩形の内側にあるため、三角形で当たれば矩形でも当たる
+        LAPP_TEST_CHECK(preciseHitCount <= rectangleHitCount);
+
+        for (int i = 0; i < modelCount; ++i)
+        {
+            CSM_DELETE(rectangleScene[i]);
+            CSM_DELETE(preciseScene[i]);
+        }
+    }
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestMatchesBruteForce();
+    TestLazyRebuild();
+    TestSceneTapBenchmark();
+
+    return LAppTest::Finish("CubismDrawableHitTesterTest");
+}
@@ -0,0 +1,132 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <Id/CubismId.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <cstring>
+#include <thread>
+
+using namespace Live2D::Cubism::Framework;
+
+namespace {
+
+const int IdCount = 50000;
+const int ThreadCount = 4;
+
+std::vector<std::string> MakeNames()
+{
+    std::vector<std::string> names;
+    names.reserve(IdCount);
+    for (int i = 0; i < IdCount; ++i)
+    {
+        names.push_back("ParamBenchmarkId" + std::to_string(i));
+    }
+    return names;
+}
+
+// 50k個のIDの登録と検索の時間を測り、同じ名前で同じIDが返ることを確かめる
+void TestRegisterAndLookup(const std::vector<std::string>& names)
+{
+    CubismIdManager* manager = CSM_NEW CubismIdManager();
+    std::vector<const CubismId*> ids(IdCount);
+
+    LAppTest::Timer registerTimer;
+    for (int i = 0; i < IdCount; ++i)
+    {
+        ids[i] = manager->GetId(names[i].c_str());
+    }
+    const double registerTime = registerTimer.ElapsedMilliseconds();
+
+    int mismatches = 0;
+    LAppTest::Timer lookupTimer;
+    for (int i = 0; i < IdCount; ++i)
+    {
+        if (manager->GetId(names[i].c_str()) != ids[i])
+        {
+            ++mismatches;
+        }
+    }
+    const double lookupTime = lookupTimer.ElapsedMilliseconds();
+
+    for (int i = 0; i < IdCount; ++i)
+    {
+        if (std::strcmp(ids[i]->GetString().GetRawString(), names[i].c_str()) != 0)
+        {
+            ++mismatches;
+        }
+    }
+
+    std::printf("register %d ids: %.2f ms, lookup: %.2f ms\n", IdCount, registerTime, lookupTime);
+
+    LAPP_TEST_CHECK(mismatches == 0);
+    LAPP_TEST_CHECK(manager->IsExist(names[7].c_str()));
+    LAPP_TEST_CHECK(!manager->IsExist("ParamNotRegistered"));
+
+    CSM_DELETE(manager);
+}
+
+// 複数スレッドから同時に登録しても、名前ごとにIDが一つだけ作られることを確かめる
+void TestConcurrentRegistration(const std::vector<std::string>& names)
+{
+    CubismIdManager* manager = CSM_NEW CubismIdManager();
+    std::vector<std::vector<const CubismId*> > results(ThreadCount, std::vector<const CubismId*>(IdCount));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            // スレッドごとに異なる順序で登録する
+            for (int k = 0; k < IdCount; ++k)
+            {
+                const int i = static_cast<int>((static_cast<long long>(k) * 7919 + t * 12345) % IdCount);
+                results[t][i] = manager->GetId(names[i].c_str());
+            }
+        });
+    }
+    for (size_t t = 0; t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+
+    int mismatches = 0;
+    for (int t = 1; t < ThreadCount; ++t)
+    {
+        for (int i = 0; i < IdCount; ++i)
+        {
+            if (results[t][i] != results[0][i])
+            {
+                ++mismatches;
+            }
+        }
+    }
+    for (int i = 0; i < IdCount; ++i)
+    {
+        if (std::strcmp(results[0][i]->GetString().GetRawString(), names[i].c_str()) != 0)
+        {
+            ++mismatches;
+        }
+    }
+    LAPP_TEST_CHECK(mismatches == 0);
+
+    CSM_DELETE(manager);
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    const std::vector<std::string> names = MakeNames();
+    TestRegisterAndLookup(names);
+    TestConcurrentRegistration(names);
+
+    return LAppTest::Finish("CubismIdManagerTest");
+}
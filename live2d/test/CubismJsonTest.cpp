@@ -0,0 +1,211 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <Utils/CubismJson.hpp>
+#include <Utils/CubismString.hpp>
+#include <clocale>
+#include <cstring>
+
+using namespace Live2D::Cubism::Framework;
+using namespace Live2D::Cubism::Framework::Utils;
+
+namespace {
+
+// 速い経路と、桁数や指数の大きい数値、16進数、無限大、非数などstrtofに任せる経路の両方を含む
+const char* FloatStrings[] =
+{
+    "0", "-0", "1", "-1.5", "0.1", "3.14159", "1e10", "2.5E-3", "1.", ".5", "-.25e+2", "123456789",
+    "0.333333333333333314829616256247390992939472198486328125",
+    "1234567890123456789012345", "1e30", "1e-30", "1.4e-45", "3.5e38", "1e39", "1e-50",
+    "0x1.8p1", "-0X10", "inf", "-Infinity", "nan", "1.5xyz", "1.e5", "-", ".", "e5",
+};
+
+// LC_NUMERICの小数点が','になるロケールの候補
+const char* CommaLocales[] = { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR" };
+
+// Haruのjsonファイル。繰り返して連結し、解析速度を測るコーパスにする
+const char* CorpusPaths[] =
+{
+    "Haru/Haru.model3.json",
+    "Haru/Haru.physics3.json",
+    "Haru/Haru.pose3.json",
+    "Haru/Haru.userdata3.json",
+    "Haru/Haru.cdi3.json",
+    "Haru/expressions/F01.exp3.json",
+    "Haru/motions/haru_g_idle.motion3.json",
+    "Haru/motions/haru_g_m01.motion3.json",
+    "Haru/motions/haru_g_m05.motion3.json",
+    "Haru/motions/haru_g_m10.motion3.json",
+};
+const size_t CorpusTargetBytes = 8 * 1024 * 1024;
+const int BenchmarkRounds = 5;
+
+struct ParsedFloat
+{
+    csmUint32 Bits;
+    csmInt32 EndPosition;
+};
+
+// ParseFloatで全ての文字列を解析する
+std::vector<ParsedFloat> ParseAll()
+{
+    std::vector<ParsedFloat> results;
+    for (size_t i = 0; i < sizeof(FloatStrings) / sizeof(FloatStrings[0]); ++i)
+    {
+        const char* string = FloatStrings[i];
+        ParsedFloat result;
+        const csmFloat32 value = CubismString::ParseFloat(string, static_cast<csmInt32>(std::strlen(string)), 0, &result.EndPosition);
+        std::memcpy(&result.Bits, &value, sizeof(result.Bits));
+        results.push_back(result);
+    }
+    return results;
+}
+
+// CロケールでParseFloatがstrtofと同じ値と終了位置を返すことを確かめる
+void TestParseFloatMatchesStrtof()
+{
+    const std::vector<ParsedFloat> results = ParseAll();
+    int mismatches = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        char* end;
+        const float expected = std::strtof(FloatStrings[i], &end);
+        csmUint32 expectedBits;
+        std::memcpy(&expectedBits, &expected, sizeof(expectedBits));
+        if (results[i].Bits != expectedBits || results[i].EndPosition != end - FloatStrings[i])
+        {
+            std::printf("ParseFloat(\"%s\") differs from strtof\n", FloatStrings[i]);
+            ++mismatches;
+        }
+    }
+    LAPP_TEST_CHECK(mismatches == 0);
+}
+
+// jsonの配列の数値を全て読む
+std::vector<csmFloat32> ParseJsonValues(const char* json)
+{
+    std::vector<csmFloat32> values;
+    CubismJson* parsed = CubismJson::Create(reinterpret_cast<const csmByte*>(json), static_cast<csmSizeInt>(std::strlen(json)));
+    LAPP_TEST_CHECK(parsed != NULL);
+    if (parsed != NULL)
+    {
+        Value& array = parsed->GetRoot()["Values"];
+        for (csmInt32 i = 0; i < array.GetSize(); ++i)
+        {
+            values.push_back(array[i].ToFloat());
+        }
+        CubismJson::Delete(parsed);
+    }
+    return values;
+}
+
+// 小数点が','のロケールでも、ParseFloatとjsonの解析結果がCロケールと変わらないことを確かめる
+void TestParseFloatIgnoresLocale()
+{
+    const char* json = "{\"Values\":[0.5,-1.25,0.333333333333333314829616256247390992939472198486328125,1e-40,12345678901234567890.5]}";
+    const std::vector<ParsedFloat> expected = ParseAll();
+    const std::vector<csmFloat32> expectedValues = ParseJsonValues(json);
+
+    const char* localeName = NULL;
+    for (size_t i = 0; i < sizeof(CommaLocales) / sizeof(CommaLocales[0]) && localeName == NULL; ++i)
+    {
+        localeName = std::setlocale(LC_NUMERIC, CommaLocales[i]);
+    }
+    if (localeName == NULL)
+    {
+        std::printf("no locale with a comma decimal point is installed, skipped\n");
+        return;
+    }
+
+    const std::vector<ParsedFloat> results = ParseAll();
+    int mismatches = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        if (results[i].Bits != expected[i].Bits || results[i].EndPosition != expected[i].EndPosition)
+        {
+            std::printf("ParseFloat(\"%s\") depends on %s\n", FloatStrings[i], localeName);
+            ++mismatches;
+        }
+    }
+    LAPP_TEST_CHECK(mismatches == 0);
+
+    const std::vector<csmFloat32> values = ParseJsonValues(json);
+    const bool isJsonSame = values.size() == expectedValues.size()
+        && std::memcmp(values.data(), expectedValues.data(), sizeof(csmFloat32) * expectedValues.size()) == 0;
+    LAPP_TEST_CHECK(isJsonSame);
+
+    std::printf("LC_NUMERIC=%s: %s\n", localeName, (mismatches == 0 && isJsonSame) ? "same results as the C locale" : "results differ");
+    std::setlocale(LC_NUMERIC, "C");
+}
+
+// Haruのjsonを配列として連結したコーパスを作り、解析の速度[MB/s]を測る
+void TestParseBenchmark()
+{
+    std::vector<std::vector<csmByte> > files;
+    size_t filesBytes = 0;
+    for (size_t i = 0; i < sizeof(CorpusPaths) / sizeof(CorpusPaths[0]); ++i)
+    {
+        files.push_back(LAppTest::ReadResource(CorpusPaths[i]));
+        LAPP_TEST_CHECK(!files.back().empty());
+        filesBytes += files.back().size() + 1;
+    }
+
+    std::vector<csmByte> corpus;
+    corpus.reserve(CorpusTargetBytes + filesBytes + 2);
+    corpus.push_back('[');
+    int documentCount = 0;
+    while (corpus.size() < CorpusTargetBytes)
+    {
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            if (documentCount > 0)
+            {
+                corpus.push_back(',');
+            }
+            corpus.insert(corpus.end(), files[i].begin(), files[i].end());
+            ++documentCount;
+        }
+    }
+    corpus.push_back(']');
+
+    double bestMilliseconds = 0.0;
+    for (int round = 0; round < BenchmarkRounds; ++round)
+    {
+        LAppTest::Timer timer;
+        CubismJson* json = CubismJson::Create(corpus.data(), static_cast<csmSizeInt>(corpus.size()));
+        const double milliseconds = timer.ElapsedMilliseconds();
+
+        LAPP_TEST_CHECK(json != NULL);
+        if (json == NULL)
+        {
+            return;
+        }
+        LAPP_TEST_CHECK(json->GetRoot().GetSize() == documentCount);
+        CubismJson::Delete(json);
+
+        bestMilliseconds = (round == 0 || milliseconds < bestMilliseconds) ? milliseconds : bestMilliseconds;
+    }
+
+    const double megabytes = static_cast<double>(corpus.size()) / (1024.0 * 1024.0);
+    std::printf("Haru corpus of %d documents, %.1f MB: %.2f ms, %.1f MB/s\n",
+        documentCount, megabytes, bestMilliseconds, megabytes / (bestMilliseconds / 1000.0));
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestParseFloatMatchesStrtof();
+    TestParseFloatIgnoresLocale();
+    TestParseBenchmark();
+
+    return LAppTest::Finish("CubismJsonTest");
+}
@@ -0,0 +1,183 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include "LAppJobSystem.hpp"
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <Physics/CubismPhysicsBatch.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <cmath>
+#include <cstring>
+
+using namespace Live2D::Cubism::Framework;
+namespace Core = Live2D::Cubism::Core;
+
+namespace {
+
+const char* MocPath = "Haru/Haru.moc3";
+const char* PhysicsPath = "Haru/Haru.physics3.json";
+const int FrameCount = 600;
+
+/**
+ * 同じ入力で動かす単独評価と一括評価のモデル
+ */
+struct Instances
+{
+    CubismMoc* Moc;
+    CubismPhysics* Source;
+    std::vector<CubismModel*> Single;
+    std::vector<CubismModel*> Batched;
+    std::vector<CubismPhysics*> Physics;
+    CubismPhysicsBatch* Batch;
+
+    Instances(const std::vector<csmByte>& moc, const std::vector<csmByte>& physicsJson, int count)
+    {
+        Moc = CubismMoc::Create(moc.data(), static_cast<csmSizeInt>(moc.size()));
+        Source = CubismPhysics::Create(physicsJson.data(), static_cast<csmSizeInt>(physicsJson.size()));
+        for (int i = 0; i < count; ++i)
+        {
+            Single.push_back(Moc->CreateModel());
+            Batched.push_back(Moc->CreateModel());
+            Physics.push_back(CubismPhysics::Create(Source));
+        }
+        Batch = CubismPhysicsBatch::Create(Source, count);
+    }
+
+    ~Instances()
+    {
+        CubismPhysicsBatch::Delete(Batch);
+        for (size_t i = 0; i < Single.size(); ++i)
+        {
+            CubismPhysics::Delete(Physics[i]);
+            Moc->DeleteModel(Single[i]);
+            Moc->DeleteModel(Batched[i]);
+        }
+        CubismPhysics::Delete(Source);
+        CubismMoc::Delete(Moc);
+    }
+};
+
+// instance番目のモデルにframeフレーム目の入力を設定する。インスタンスごとに位相をずらす
+void DriveInstance(CubismModel* model, int instance, int frame)
+{
+    CubismIdManager* ids = CubismFramework::GetIdManager();
+    const csmFloat32 t = frame * 0.0167f + instance * 0.37f;
+
+    model->LoadParameters();
+    model->SetParameterValue(ids->GetId("ParamAngleX"), 30.0f * sinf(t * 3.1f));
+    model->SetParameterValue(ids->GetId("ParamAngleY"), 25.0f * sinf(t * 1.7f + 1.0f));
+    model->SetParameterValue(ids->GetId("ParamBodyAngleX"), 10.0f * sinf(t * 5.3f));
+    model->SaveParameters();
+}
+
+// frameフレーム目の時間の刻み。揃えないことで補間と入力の線形補間も比べる
+csmFloat32 GetDeltaTime(int frame)
+{
+    return (frame % 7 == 3) ? 0.033f : 0.0161f + 0.0003f * (frame % 5);
+}
+
+// count個のインスタンスを単独と一括で評価し、全パラメータがビット単位で一致することを確かめる
+void CompareBatchWithSingle(const std::vector<csmByte>& moc, const std::vector<csmByte>& physicsJson, int count, bool stabilize)
+{
+    Instances instances(moc, physicsJson, count);
+    LAPP_TEST_CHECK(instances.Batch != NULL);
+    if (instances.Batch == NULL)
+    {
+        return;
+    }
+
+    if (stabilize)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            DriveInstance(instances.Single[i], i, 0);
+            DriveInstance(instances.Batched[i], i, 0);
+            instances.Physics[i]->Stabilization(instances.Single[i]);
+        }
+        instances.Batch->Stabilization(instances.Batched.data());
+    }
+
+    const csmInt32 parameterCount = instances.Single[0]->GetParameterCount();
+    int mismatchCount = 0;
+    double singleMilliseconds = 0.0;
+    double batchMilliseconds = 0.0;
+    for (int frame = 0; frame < FrameCount; ++frame)
+    {
+        const csmFloat32 deltaTime = GetDeltaTime(frame);
+        for (int i = 0; i < count; ++i)
+        {
+            DriveInstance(instances.Single[i], i, frame);
+            DriveInstance(instances.Batched[i], i, frame);
+        }
+
+        LAppTest::Timer singleTimer;
+        for (int i = 0; i < count; ++i)
+        {
+            instances.Physics[i]->Evaluate(instances.Single[i], deltaTime);
+        }
+        singleMilliseconds += singleTimer.ElapsedMilliseconds();
+
+        LAppTest::Timer batchTimer;
+        instances.Batch->Evaluate(instances.Batched.data(), deltaTime);
+        batchMilliseconds += batchTimer.ElapsedMilliseconds();
+
+        for (int i = 0; i < count; ++i)
+        {
+            const csmFloat32* single = Core::csmGetParameterValues(instances.Single[i]->GetModel());
+            const csmFloat32* batched = Core::csmGetParameterValues(instances.Batched[i]->GetModel());
+            if (std::memcmp(single, batched, sizeof(csmFloat32) * parameterCount) != 0)
+            {
+                ++mismatchCount;
+            }
+        }
+    }
+
+    std::printf("%2d instances%s: single %.2f us/frame, batch %.2f us/frame, %d mismatches\n",
+        count, stabilize ? " (stabilized)" : "", singleMilliseconds * 1000.0 / FrameCount, batchMilliseconds * 1000.0 / FrameCount, mismatchCount);
+    LAPP_TEST_CHECK(mismatchCount == 0);
+}
+
+// 4の倍数でない数を含むインスタンス数で、一括評価が単独評価とビット単位で一致することを確かめる
+void TestBatchMatchesSingle()
+{
+    const std::vector<csmByte> moc = LAppTest::ReadResource(MocPath);
+    const std::vector<csmByte> physicsJson = LAppTest::ReadResource(PhysicsPath);
+    const int counts[] = { 1, 4, 7, 16, 64 };
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+    {
+        CompareBatchWithSingle(moc, physicsJson, counts[i], false);
+    }
+    CompareBatchWithSingle(moc, physicsJson, 7, true);
+}
+
+// ジョブシステムでブロックを並列に評価しても、単独評価とビット単位で一致することを確かめる
+void TestBatchWithJobSystem()
+{
+    const std::vector<csmByte> moc = LAppTest::ReadResource(MocPath);
+    const std::vector<csmByte> physicsJson = LAppTest::ReadResource(PhysicsPath);
+    LAppJobSystem jobSystem(3);
+
+    CubismFramework::SetJobSystem(&jobSystem);
+    CompareBatchWithSingle(moc, physicsJson, 16, false);
+    CubismFramework::SetJobSystem(NULL);
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestBatchMatchesSingle();
+    TestBatchWithJobSystem();
+
+    return LAppTest::Finish("CubismPhysicsBatchTest");
+}
@@ -0,0 +1,590 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <Math/CubismMath.hpp>
+#include <Math/CubismVector2.hpp>
+#include <Model/CubismMoc.hpp>
+#include <Model/CubismModel.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <Physics/CubismPhysicsJson.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <cmath>
+#include <cstring>
+
+using namespace Live2D::Cubism::Framework;
+namespace Core = Live2D::Cubism::Core;
+
+namespace {
+
+const char* MocPath = "Haru/Haru.moc3";
+const char* PhysicsPath = "Haru/Haru.physics3.json";
+const int FrameCount = 2000;
+const csmFloat32 Tolerance = 1.0e-4f;
+
+/**
+ * コンパイル済みのカーネルに置き換える前の物理演算をそのまま書いた参照実装
+ *
+ * 設定ごと、入力ごと、粒子ごとに順に計算する。モデルに存在しない入力パラメータは、値と範囲を0として扱う。
+ */
+class ReferencePhysics
+{
+public:
+    explicit ReferencePhysics(const std::vector<csmByte>& buffer)
+        : _remainTime(0.0f)
+    {
+        CubismPhysicsJson json(buffer.data(), static_cast<csmSizeInt>(buffer.size()));
+
+        _fps = json.GetFps();
+        _settings.resize(json.GetSubRigCount());
+        for (csmInt32 i = 0; i < json.GetSubRigCount(); ++i)
+        {
+            Setting& setting = _settings[i];
+            setting.PositionMinimum = json.GetNormalizationPositionMinimumValue(i);
+            setting.PositionMaximum = json.GetNormalizationPositionMaximumValue(i);
+            setting.PositionDefault = json.GetNormalizationPositionDefaultValue(i);
+            setting.AngleMinimum = json.GetNormalizationAngleMinimumValue(i);
+            setting.AngleMaximum = json.GetNormalizationAngleMaximumValue(i);
+            setting.AngleDefault = json.GetNormalizationAngleDefaultValue(i);
+
+            for (csmInt32 j = 0; j < json.GetInputCount(i); ++j)
+            {
+                Input input;
+                input.Id = json.GetInputSourceId(i, j);
+                input.Type = GetType(json.GetInputType(i, j));
+                input.Weight = json.GetInputWeight(i, j);
+                input.Reflect = json.GetInputReflect(i, j);
+                input.ParameterIndex = -1;
+                setting.Inputs.push_back(input);
+            }
+
+            for (csmInt32 j = 0; j < json.GetOutputCount(i); ++j)
+            {
+                Output output;
+                output.Id = json.GetOutputsDestinationId(i, j);
+                output.Type = GetType(json.GetOutputType(i, j));
+                output.VertexIndex = json.GetOutputVertexIndex(i, j);
+                output.AngleScale = json.GetOutputAngleScale(i, j);
+                output.Weight = json.GetOutputWeight(i, j);
+                output.Reflect = json.GetOutputReflect(i, j);
+                output.ParameterIndex = -1;
+                output.Current = 0.0f;
+                output.Previous = 0.0f;
+                setting.Outputs.push_back(output);
+            }
+
+            for (csmInt32 j = 0; j < json.GetParticleCount(i); ++j)
+            {
+                Particle particle;
+                particle.Mobility = json.GetParticleMobility(i, j);
+                particle.Delay = json.GetParticleDelay(i, j);
+                particle.Acceleration = json.GetParticleAcceleration(i, j);
+                particle.Radius = json.GetParticleRadius(i, j);
+                particle.Position = json.GetParticlePosition(i, j);
+                setting.Particles.push_back(particle);
+            }
+
+            // 2番目以降の粒子は、根元から半径の分だけ順に並べた位置から始める
+            std::vector<Particle>& strand = setting.Particles;
+            CubismVector2 initialPosition(0.0f, 0.0f);
+            for (size_t j = 0; j < strand.size(); ++j)
+            {
+                if (j > 0)
+                {
+                    initialPosition.Y += strand[j].Radius;
+                    strand[j].Position = initialPosition;
+                }
+                strand[j].LastPosition = initialPosition;
+                strand[j].LastGravity = CubismVector2(0.0f, 1.0f);
+                strand[j].Velocity = CubismVector2(0.0f, 0.0f);
+                strand[j].Force = CubismVector2(0.0f, 0.0f);
+            }
+        }
+    }
+
+    /**
+     * CubismPhysics::Evaluateと同じ手順で1回分を計算する
+     */
+    void Evaluate(CubismModel* model, csmFloat32 deltaTimeSeconds)
+    {
+        if (deltaTimeSeconds <= 0.0f)
+        {
+            return;
+        }
+
+        const csmInt32 parameterCount = model->GetParameterCount();
+        csmFloat32* values = Core::csmGetParameterValues(model->GetModel());
+        const csmFloat32* minimums = Core::csmGetParameterMinimumValues(model->GetModel());
+        const csmFloat32* maximums = Core::csmGetParameterMaximumValues(model->GetModel());
+
+        _remainTime += deltaTimeSeconds;
+        if (_remainTime > 5.0f)
+        {
+            _remainTime = 0.0f;
+        }
+
+        if (_caches.empty())
+        {
+            _caches.resize(parameterCount);
+            _inputCaches.assign(values, values + parameterCount);
+        }
+
+        const csmFloat32 physicsDeltaTime = (_fps > 0.0f) ? 1.0f / _fps : deltaTimeSeconds;
+
+        while (_remainTime >= physicsDeltaTime)
+        {
+            for (size_t s = 0; s < _settings.size(); ++s)
+            {
+                for (size_t i = 0; i < _settings[s].Outputs.size(); ++i)
+                {
+                    _settings[s].Outputs[i].Previous = _settings[s].Outputs[i].Current;
+                }
+            }
+
+            const csmFloat32 inputWeight = physicsDeltaTime / _remainTime;
+            for (csmInt32 j = 0; j < parameterCount; ++j)
+            {
+                _caches[j] = _inputCaches[j] * (1.0f - inputWeight) + values[j] * inputWeight;
+                _inputCaches[j] = _caches[j];
+            }
+
+            for (size_t s = 0; s < _settings.size(); ++s)
+            {
+                Setting& setting = _settings[s];
+                CubismVector2 translation(0.0f, 0.0f);
+                csmFloat32 angle = 0.0f;
+
+                for (size_t i = 0; i < setting.Inputs.size(); ++i)
+                {
+                    Input& input = setting.Inputs[i];
+                    if (input.ParameterIndex == -1)
+                    {
+                        input.ParameterIndex = model->GetParameterIndex(input.Id);
+                    }
+
+                    const csmBool exists = input.ParameterIndex < parameterCount;
+                    const csmFloat32 value = exists ? _caches[input.ParameterIndex] : 0.0f;
+                    const csmFloat32 minimum = exists ? minimums[input.ParameterIndex] : 0.0f;
+                    const csmFloat32 maximum = exists ? maximums[input.ParameterIndex] : 0.0f;
+                    const csmFloat32 weight = input.Weight / 100.0f;
+
+                    if (input.Type == Type_Angle)
+                    {
+                        angle += Normalize(value, minimum, maximum, setting.AngleMinimum, setting.AngleMaximum, setting.AngleDefault, input.Reflect) * weight;
+                    }
+                    else
+                    {
+                        const csmFloat32 normalized = Normalize(value, minimum, maximum, setting.PositionMinimum, setting.PositionMaximum, setting.PositionDefault, input.Reflect) * weight;
+                        (input.Type == Type_X ? translation.X : translation.Y) += normalized;
+                    }
+                }
+
+                // 元の実装どおり、Yの計算には回転後のXを使う
+                const csmFloat32 radian = CubismMath::DegreesToRadian(-angle);
+                translation.X = translation.X * CubismMath::CosF(radian) - translation.Y * CubismMath::SinF(radian);
+                translation.Y = translation.X * CubismMath::SinF(radian) + translation.Y * CubismMath::CosF(radian);
+
+                UpdateParticles(setting.Particles, translation, angle, 0.001f * setting.PositionMaximum, physicsDeltaTime);
+
+                for (size_t i = 0; i < setting.Outputs.size(); ++i)
+                {
+                    Output& output = setting.Outputs[i];
+                    if (output.ParameterIndex == -1)
+                    {
+                        output.ParameterIndex = model->GetParameterIndex(output.Id);
+                    }
+
+                    const csmInt32 particleIndex = output.VertexIndex;
+                    if (particleIndex < 1 || particleIndex >= static_cast<csmInt32>(setting.Particles.size()))
+                    {
+                        continue;
+                    }
+
+                    output.Current = GetOutputValue(output, setting.Particles, particleIndex);
+                    UpdateOutput(&_caches[output.ParameterIndex], minimums[output.ParameterIndex], maximums[output.ParameterIndex], output.Current, output);
+                }
+            }
+
+            _remainTime -= physicsDeltaTime;
+        }
+
+        // 前回と今回の出力を残り時間で補間してモデルに書き込む
+        const csmFloat32 alpha = _remainTime / physicsDeltaTime;
+        for (size_t s = 0; s < _settings.size(); ++s)
+        {
+            for (size_t i = 0; i < _settings[s].Outputs.size(); ++i)
+            {
+                Output& output = _settings[s].Outputs[i];
+                if (output.ParameterIndex == -1)
+                {
+                    continue;
+                }
+
+                UpdateOutput(&values[output.ParameterIndex], minimums[output.ParameterIndex], maximums[output.ParameterIndex],
+                             output.Previous * (1 - alpha) + output.Current * alpha, output);
+            }
+        }
+    }
+
+private:
+    enum SourceType
+    {
+        Type_X,
+        Type_Y,
+        Type_Angle,
+    };
+
+    struct Input
+    {
+        CubismIdHandle Id;
+        SourceType Type;
+        csmFloat32 Weight;
+        csmBool Reflect;
+        csmInt32 ParameterIndex;
+    };
+
+    struct Output
+    {
+        CubismIdHandle Id;
+        SourceType Type;
+        csmInt32 VertexIndex;
+        csmFloat32 AngleScale;
+        csmFloat32 Weight;
+        csmBool Reflect;
+        csmInt32 ParameterIndex;
+        csmFloat32 Current;
+        csmFloat32 Previous;
+    };
+
+    struct Particle
+    {
+        csmFloat32 Mobility;
+        csmFloat32 Delay;
+        csmFloat32 Acceleration;
+        csmFloat32 Radius;
+        CubismVector2 Position;
+        CubismVector2 LastPosition;
+        CubismVector2 LastGravity;
+        CubismVector2 Velocity;
+        CubismVector2 Force;
+    };
+
+    struct Setting
+    {
+        csmFloat32 PositionMinimum, PositionMaximum, PositionDefault;
+        csmFloat32 AngleMinimum, AngleMaximum, AngleDefault;
+        std::vector<Input> Inputs;
+        std::vector<Output> Outputs;
+        std::vector<Particle> Particles;
+    };
+
+    static SourceType GetType(const csmChar* tag)
+    {
+        if (strcmp(tag, "X") == 0)
+        {
+            return Type_X;
+        }
+        return (strcmp(tag, "Y") == 0) ? Type_Y : Type_Angle;
+    }
+
+    static csmFloat32 Normalize(csmFloat32 value, csmFloat32 parameterMinimum, csmFloat32 parameterMaximum,
+                                csmFloat32 normalizedMinimum, csmFloat32 normalizedMaximum, csmFloat32 normalizedDefault, csmBool isInverted)
+    {
+        const csmFloat32 maxValue = CubismMath::Max(parameterMaximum, parameterMinimum);
+        const csmFloat32 minValue = CubismMath::Min(parameterMaximum, parameterMinimum);
+        value = CubismMath::Min(value, maxValue);
+        value = CubismMath::Max(value, minValue);
+
+        const csmFloat32 minNormValue = CubismMath::Min(normalizedMinimum, normalizedMaximum);
+        const csmFloat32 maxNormValue = CubismMath::Max(normalizedMinimum, normalizedMaximum);
+        const csmFloat32 middleValue = minValue + CubismMath::AbsF(maxValue - minValue) / 2.0f;
+        const csmFloat32 paramValue = value - middleValue;
+
+        csmFloat32 result = normalizedDefault;
+        if (paramValue > 0.0f)
+        {
+            const csmFloat32 length = maxValue - middleValue;
+            result = (length != 0.0f) ? paramValue * ((maxNormValue - normalizedDefault) / length) + normalizedDefault : 0.0f;
+        }
+        else if (paramValue < 0.0f)
+        {
+            const csmFloat32 length = minValue - middleValue;
+            result = (length != 0.0f) ? paramValue * ((minNormValue - normalizedDefault) / length) + normalizedDefault : 0.0f;
+        }
+
+        return isInverted ? result : -result;
+    }
+
+    static void UpdateParticles(std::vector<Particle>& strand, CubismVector2 totalTranslation, csmFloat32 totalAngle,
+                                csmFloat32 thresholdValue, csmFloat32 deltaTimeSeconds)
+    {
+        strand[0].Position = totalTranslation;
+
+        CubismVector2 currentGravity = CubismMath::RadianToDirection(CubismMath::DegreesToRadian(totalAngle));
+        currentGravity.Normalize();
+
+        for (size_t i = 1; i < strand.size(); ++i)
+        {
+            strand[i].Force = currentGravity * strand[i].Acceleration;
+            strand[i].LastPosition = strand[i].Position;
+
+            const csmFloat32 delay = strand[i].Delay * deltaTimeSeconds * 30.0f;
+
+            CubismVector2 direction = strand[i].Position - strand[i - 1].Position;
+            const csmFloat32 radian = CubismMath::DirectionToRadian(strand[i].LastGravity, currentGravity) / 5.0f;
+            direction.X = CubismMath::CosF(radian) * direction.X - direction.Y * CubismMath::SinF(radian);
+            direction.Y = CubismMath::SinF(radian) * direction.X + direction.Y * CubismMath::CosF(radian);
+
+            strand[i].Position = strand[i - 1].Position + direction;
+            const CubismVector2 velocity(strand[i].Velocity.X * delay, strand[i].Velocity.Y * delay);
+            const CubismVector2 force = strand[i].Force * delay * delay;
+            strand[i].Position = strand[i].Position + velocity + force;
+
+            CubismVector2 newDirection = strand[i].Position - strand[i - 1].Position;
+            newDirection.Normalize();
+            strand[i].Position = strand[i - 1].Position + newDirection * strand[i].Radius;
+
+            if (CubismMath::AbsF(strand[i].Position.X) < thresholdValue)
+            {
+                strand[i].Position.X = 0.0f;
+            }
+
+            if (delay != 0.0f)
+            {
+                strand[i].Velocity = strand[i].Position - strand[i].LastPosition;
+                strand[i].Velocity /= delay;
+                strand[i].Velocity *= strand[i].Mobility;
+            }
+
+            strand[i].Force = CubismVector2(0.0f, 0.0f);
+            strand[i].LastGravity = currentGravity;
+        }
+    }
+
+    static csmFloat32 GetOutputValue(const Output& output, const std::vector<Particle>& particles, csmInt32 particleIndex)
+    {
+        const CubismVector2 translation = particles[particleIndex].Position - particles[particleIndex - 1].Position;
+        csmFloat32 value;
+
+        if (output.Type == Type_Angle)
+        {
+            const CubismVector2 parentGravity = (particleIndex >= 2)
+                ? particles[particleIndex - 1].Position - particles[particleIndex - 2].Position
+                : CubismVector2(0.0f, 1.0f);
+            value = CubismMath::DirectionToRadian(parentGravity, translation);
+        }
+        else
+        {
+            value = (output.Type == Type_X) ? translation.X : translation.Y;
+        }
+
+        return output.Reflect ? -value : value;
+    }
+
+    static void UpdateOutput(csmFloat32* parameterValue, csmFloat32 minimum, csmFloat32 maximum, csmFloat32 translation, const Output& output)
+    {
+        // 平行移動のスケールはjsonから読まれないため0のまま
+        csmFloat32 value = translation * ((output.Type == Type_Angle) ? output.AngleScale : 0.0f);
+        value = CubismMath::Max(value, minimum);
+        value = CubismMath::Min(value, maximum);
+
+        const csmFloat32 weight = output.Weight / 100.0f;
+        *parameterValue = (weight >= 1.0f) ? value : (*parameterValue * (1.0f - weight)) + (value * weight);
+    }
+
+    std::vector<Setting> _settings;
+    std::vector<csmFloat32> _caches;
+    std::vector<csmFloat32> _inputCaches;
+    csmFloat32 _fps;
+    csmFloat32 _remainTime;
+};
+
+/**
+ * 同じ入力で動かす2つのモデル
+ */
+struct ModelPair
+{
+    CubismMoc* Moc;
+    CubismModel* Compiled;
+    CubismModel* Reference;
+
+    explicit ModelPair(const std::vector<csmByte>& moc)
+    {
+        Moc = CubismMoc::Create(moc.data(), static_cast<csmSizeInt>(moc.size()));
+        Compiled = Moc->CreateModel();
+        Reference = Moc->CreateModel();
+    }
+
+    ~ModelPair()
+    {
+        Moc->DeleteModel(Compiled);
+        Moc->DeleteModel(Reference);
+        CubismMoc::Delete(Moc);
+    }
+};
+
+// frameフレーム目の入力を両方のモデルに設定し、時間の刻みを返す
+csmFloat32 DriveFrame(CubismModel* model, int frame)
+{
+    CubismIdManager* ids = CubismFramework::GetIdManager();
+    const csmFloat32 t = frame * 0.0167f;
+    model->SetParameterValue(ids->GetId("ParamAngleX"), 30.0f * sinf(t * 3.1f));
+    model->SetParameterValue(ids->GetId("ParamAngleY"), 25.0f * sinf(t * 1.7f + 1.0f));
+    model->SetParameterValue(ids->GetId("ParamBodyAngleX"), 10.0f * sinf(t * 5.3f));
+
+    // 刻みを揃えないことで、補間と入力の線形補間も比べる
+    return (frame % 7 == 3) ? 0.033f : 0.0161f + 0.0003f * (frame % 5);
+}
+
+// コンパイル済みのカーネルと参照実装をframeCountフレーム動かし、全パラメータの最大の差を返す
+csmFloat32 CompareWithReference(const std::vector<csmByte>& moc, const std::vector<csmByte>& physicsJson, int frameCount)
+{
+    ModelPair models(moc);
+    CubismPhysics* physics = CubismPhysics::Create(physicsJson.data(), static_cast<csmSizeInt>(physicsJson.size()));
+    ReferencePhysics reference(physicsJson);
+    LAPP_TEST_CHECK(physics != NULL);
+    if (physics == NULL)
+    {
+        return 0.0f;
+    }
+
+    csmFloat32 maxDifference = 0.0f;
+    const csmInt32 parameterCount = models.Compiled->GetParameterCount();
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        const csmFloat32 deltaTime = DriveFrame(models.Compiled, frame);
+        DriveFrame(models.Reference, frame);
+
+        physics->Evaluate(models.Compiled, deltaTime);
+        reference.Evaluate(models.Reference, deltaTime);
+
+        for (csmInt32 i = 0; i < parameterCount; ++i)
+        {
+            const csmFloat32 difference = fabsf(models.Compiled->GetParameterValue(i) - models.Reference->GetParameterValue(i));
+            maxDifference = (difference > maxDifference || difference != difference) ? difference : maxDifference;
+        }
+    }
+
+    CubismPhysics::Delete(physics);
+    return maxDifference;
+}
+
+// Haruの物理演算がコンパイル前の手順と許容誤差内で一致することを確かめる
+void TestCompiledMatchesReference()
+{
+    const std::vector<csmByte> moc = LAppTest::ReadResource(MocPath);
+    const std::vector<csmByte> physicsJson = LAppTest::ReadResource(PhysicsPath);
+
+    const csmFloat32 maxDifference = CompareWithReference(moc, physicsJson, FrameCount);
+    std::printf("Haru, %d frames: max difference %g\n", FrameCount, maxDifference);
+    LAPP_TEST_CHECK(maxDifference <= Tolerance);
+}
+
+// モデルに存在しない入力パラメータがあっても範囲外を読まず、参照実装と一致することを確かめる
+void TestMissingInputParameter()
+{
+    const std::vector<csmByte> moc = LAppTest::ReadResource(MocPath);
+    std::vector<csmByte> physicsJson = LAppTest::ReadResource(PhysicsPath);
+
+    // 最初の入力のIDを同じ長さの存在しないIDに置き換える
+    const std::string text(physicsJson.begin(), physicsJson.end());
+    const std::string sourceId = "\"ParamAngleX\"";
+    const std::string missingId = "\"ParamNoSuchX\"";
+    const size_t position = text.find(sourceId);
+    LAPP_TEST_CHECK(position != std::string::npos);
+    if (position == std::string::npos)
+    {
+        return;
+    }
+    std::copy(missingId.begin(), missingId.end(), physicsJson.begin() + position);
+
+    const csmFloat32 maxDifference = CompareWithReference(moc, physicsJson, FrameCount / 4);
+    std::printf("Haru with a missing input, %d frames: max difference %g\n", FrameCount / 4, maxDifference);
+    LAPP_TEST_CHECK(maxDifference <= Tolerance);
+}
+
+// 入力を記録してframeCountフレーム動かし、各フレームの全パラメータのバイト列を返す。
+// startFrameより前のフレームは実行せず、モデルと物理演算が呼び出し元で復元されている前提で続きから動かす
+std::vector<csmByte> ReplayFixedStep(CubismPhysics* physics, CubismModel* model, int startFrame, int frameCount)
+{
+    std::vector<csmByte> bytes;
+    const csmFloat32* parameterValues = Core::csmGetParameterValues(model->GetModel());
+    const size_t parameterSize = sizeof(csmFloat32) * model->GetParameterCount();
+
+    for (int frame = startFrame; frame < frameCount; ++frame)
+    {
+        physics->Evaluate(model, DriveFrame(model, frame));
+        bytes.insert(bytes.end(), reinterpret_cast<const csmByte*>(parameterValues),
+            reinterpret_cast<const csmByte*>(parameterValues) + parameterSize);
+    }
+
+    return bytes;
+}
+
+// 固定時間ステップで途中の状態を保存して復元し、続きを再生すると同じバイト列になることを確かめる
+void TestSnapshotReplay()
+{
+    const std::vector<csmByte> moc = LAppTest::ReadResource(MocPath);
+    const std::vector<csmByte> physicsJson = LAppTest::ReadResource(PhysicsPath);
+    const int saveFrame = FrameCount / 4;
+    const int endFrame = FrameCount / 2;
+    const csmFloat32 fixedTimeStep = 1.0f / 60.0f;
+
+    ModelPair models(moc);
+    CubismPhysics* physics = CubismPhysics::Create(physicsJson.data(), static_cast<csmSizeInt>(physicsJson.size()));
+    LAPP_TEST_CHECK(physics != NULL);
+    if (physics == NULL)
+    {
+        return;
+    }
+    physics->SetFixedTimeStep(fixedTimeStep);
+
+    // 保存時点の状態。出力の重みが1未満のパラメータは元の値と合成されるため、モデルのパラメータも保存する
+    ReplayFixedStep(physics, models.Compiled, 0, saveFrame);
+    std::vector<csmByte> snapshot(physics->GetSnapshotSize());
+    LAPP_TEST_CHECK(physics->SaveSnapshot(snapshot.data(), static_cast<csmSizeInt>(snapshot.size())));
+
+    csmFloat32* parameterValues = Core::csmGetParameterValues(models.Compiled->GetModel());
+    const std::vector<csmFloat32> savedParameters(parameterValues, parameterValues + models.Compiled->GetParameterCount());
+
+    const std::vector<csmByte> recorded = ReplayFixedStep(physics, models.Compiled, saveFrame, endFrame);
+
+    // 同じインスタンスに巻き戻して再生する
+    LAPP_TEST_CHECK(physics->LoadSnapshot(models.Compiled, snapshot.data(), static_cast<csmSizeInt>(snapshot.size())));
+    std::copy(savedParameters.begin(), savedParameters.end(), parameterValues);
+    const std::vector<csmByte> rewound = ReplayFixedStep(physics, models.Compiled, saveFrame, endFrame);
+    LAPP_TEST_CHECK(rewound == recorded);
+
+    // まだ評価していない別のインスタンスと別のモデルに復元して再生する。復元時にこのモデルでデータが解決される
+    CubismPhysics* restored = CubismPhysics::Create(physicsJson.data(), static_cast<csmSizeInt>(physicsJson.size()));
+    restored->SetFixedTimeStep(fixedTimeStep);
+    LAPP_TEST_CHECK(!restored->LoadSnapshot(models.Reference, snapshot.data(), static_cast<csmSizeInt>(snapshot.size()) - 1));
+    LAPP_TEST_CHECK(restored->LoadSnapshot(models.Reference, snapshot.data(), static_cast<csmSizeInt>(snapshot.size())));
+    std::copy(savedParameters.begin(), savedParameters.end(), Core::csmGetParameterValues(models.Reference->GetModel()));
+    const std::vector<csmByte> replayed = ReplayFixedStep(restored, models.Reference, saveFrame, endFrame);
+    LAPP_TEST_CHECK(replayed == recorded);
+
+    std::printf("Snapshot of %d bytes at frame %d, replayed %d frames: %s\n", static_cast<int>(snapshot.size()), saveFrame,
+        endFrame - saveFrame, (rewound == recorded && replayed == recorded) ? "identical" : "different");
+
+    CubismPhysics::Delete(restored);
+    CubismPhysics::Delete(physics);
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestCompiledMatchesReference();
+    TestMissingInputParameter();
+    TestSnapshotReplay();
+
+    return LAppTest::Finish("CubismPhysicsTest");
+}
@@ -0,0 +1,287 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include <CubismModelSettingJson.hpp>
+#include <Model/CubismUserModel.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <Rendering/Null/CubismRenderer_Null.hpp>
+
+using namespace Live2D::Cubism::Framework;
+using namespace Live2D::Cubism::Framework::Rendering;
+
+namespace {
+
+typedef CubismRenderCommandList::Command Command;
+typedef CubismRenderCommandList::Statistics Statistics;
+
+const char* ModelDirectory = "Haru/";
+const char* ModelFileName = "Haru.model3.json";
+const int FrameCount = 600;
+const int CheckInterval = 10;
+const csmFloat32 DeltaTimeSeconds = 1.0f / 60.0f;
+
+/**
+ * 全モーションを順に再生し、Nullレンダラで描画命令を記録するモデル
+ */
+class RecordModel : public CubismUserModel
+{
+public:
+    RecordModel() : _nextMotion(0) {}
+
+    virtual ~RecordModel()
+    {
+        for (size_t i = 0; i < _motions.size(); ++i)
+        {
+            ACubismMotion::Delete(_motions[i]);
+        }
+    }
+
+    csmBool Setup(csmInt32 maskBufferCount)
+    {
+        const std::string directory = ModelDirectory;
+        const std::vector<csmByte> settingBuffer = LAppTest::ReadResource(directory + ModelFileName);
+        if (settingBuffer.empty())
+        {
+            return false;
+        }
+        CubismModelSettingJson setting(settingBuffer.data(), static_cast<csmSizeInt>(settingBuffer.size()));
+
+        const std::vector<csmByte> mocBuffer = LAppTest::ReadResource(directory + setting.GetModelFileName());
+        LoadModel(mocBuffer.data(), static_cast<csmSizeInt>(mocBuffer.size()));
+        if (_model == NULL)
+        {
+            return false;
+        }
+
+        for (csmInt32 group = 0; group < setting.GetMotionGroupCount(); ++group)
+        {
+            const csmChar* groupName = setting.GetMotionGroupName(group);
+            for (csmInt32 i = 0; i < setting.GetMotionCount(groupName); ++i)
+            {
+                const std::vector<csmByte> buffer = LAppTest::ReadResource(directory + setting.GetMotionFileName(groupName, i));
+                _motions.push_back(LoadMotion(buffer.data(), static_cast<csmSizeInt>(buffer.size()), groupName));
+            }
+        }
+        const std::vector<csmByte> physicsBuffer = LAppTest::ReadResource(directory + setting.GetPhysicsFileName());
+        LoadPhysics(physicsBuffer.data(), static_cast<csmSizeInt>(physicsBuffer.size()));
+
+        CreateRenderer(maskBufferCount);
+        return !_motions.empty();
+    }
+
+    void Update(csmFloat32 deltaTimeSeconds)
+    {
+        _model->LoadParameters();
+        if (_motionManager->IsFinished())
+        {
+            _motionManager->StartMotionPriority(_motions[_nextMotion], false, 1);
+            _nextMotion = (_nextMotion + 1) % _motions.size();
+        }
+        else
+        {
+            _motionManager->UpdateMotion(_model, deltaTimeSeconds);
+        }
+        _model->SaveParameters();
+        _physics->Evaluate(_model, deltaTimeSeconds);
+        _model->Update();
+    }
+
+private:
+    std::vector<ACubismMotion*> _motions;
+    size_t _nextMotion;
+};
+
+// 全ての種類の描画ステートで、並べ替えた後の切り替え回数が記録した順以下であることを確かめる
+bool IsStateChangeCountReduced(const Statistics& sorted, const Statistics& recorded)
+{
+    return sorted.TargetChangeCount <= recorded.TargetChangeCount
+        && sorted.ClipContextChangeCount <= recorded.ClipContextChangeCount
+        && sorted.ShaderChangeCount <= recorded.ShaderChangeCount
+        && sorted.BlendChangeCount <= recorded.BlendChangeCount
+        && sorted.TextureChangeCount <= recorded.TextureChangeCount
+        && sorted.CullingChangeCount <= recorded.CullingChangeCount;
+}
+
+// 並べ替えた命令で、描画が記録した順と描画順のまま並び、マスクを作る命令がそれを使う描画を越えないことを確かめる
+void CheckRenderOrder(const CubismModel& model, const CubismRenderCommandList& commandList)
+{
+    const csmInt32* renderOrders = model.GetDrawableRenderOrders();
+    csmInt32 lastRenderOrder = -1;
+    csmUint32 lastSequence = 0;
+    csmBool hasDraw = false;
+    int violationCount = 0;
+
+    for (csmInt32 i = 0; i < commandList.GetCommandCount(); ++i)
+    {
+        const Command& command = commandList.GetCommand(i);
+        if (command.Type == CubismRenderCommandList::CommandType_Draw)
+        {
+            const csmInt32 renderOrder = renderOrders[command.DrawableIndex];
+            if (renderOrder <= lastRenderOrder || (hasDraw && command.Sequence <= lastSequence))
+            {
+                ++violationCount;
+            }
+            lastRenderOrder = renderOrder;
+            lastSequence = command.Sequence;
+            hasDraw = true;
+            continue;
+        }
+
+        // マスクの命令のグループは、まとめて作るマスクなら0、描画ごとのマスクなら使う描画の描画順+1
+        const csmInt32 group = static_cast<csmInt32>(command.SortKey >> 48);
+        if ((group == 0 && hasDraw) || (group > 0 && group - 1 <= lastRenderOrder))
+        {
+            ++violationCount;
+        }
+    }
+
+    LAPP_TEST_CHECK(violationCount == 0);
+}
+
+// Haruのアニメーション中のフレームを記録し、並べ替えで描画順が変わらず、切り替え回数が増えないことを確かめる
+void TestSortKeepsRenderOrder(csmInt32 maskBufferCount, csmBool isUsingHighPrecisionMask)
+{
+    RecordModel* model = CSM_NEW RecordModel();
+    LAPP_TEST_CHECK(model->Setup(maskBufferCount));
+
+    CubismModel* cubismModel = model->GetModel();
+    CubismRenderer_Null* renderer = model->GetRenderer<CubismRenderer_Null>();
+    LAPP_TEST_CHECK(renderer != NULL);
+    if (cubismModel == NULL || renderer == NULL)
+    {
+        CSM_DELETE(model);
+        return;
+    }
+    renderer->UseHighPrecisionMask(isUsingHighPrecisionMask);
+
+    long recordedTextureChanges = 0;
+    long sortedTextureChanges = 0;
+    long recordedTargetChanges = 0;
+    long sortedTargetChanges = 0;
+    int checkedFrameCount = 0;
+    for (int frame = 0; frame < FrameCount; ++frame)
+    {
+        model->Update(DeltaTimeSeconds);
+        if (frame % CheckInterval != 0)
+        {
+            continue;
+        }
+        renderer->DrawModel();
+        CheckRenderOrder(*cubismModel, renderer->GetCommandList());
+
+        const Statistics& recorded = renderer->GetRecordedStatistics();
+        const Statistics& sorted = renderer->GetSortedStatistics();
+        LAPP_TEST_CHECK(sorted.CommandCount == recorded.CommandCount);
+        LAPP_TEST_CHECK(sorted.DrawCount == recorded.DrawCount);
+        LAPP_TEST_CHECK(sorted.MaskDrawCount == recorded.MaskDrawCount);
+        LAPP_TEST_CHECK(IsStateChangeCountReduced(sorted, recorded));
+
+        recordedTextureChanges += recorded.TextureChangeCount;
+        sortedTextureChanges += sorted.TextureChangeCount;
+        recordedTargetChanges += recorded.TargetChangeCount;
+        sortedTargetChanges += sorted.TargetChangeCount;
+        ++checkedFrameCount;
+    }
+
+    std::printf("%d buffer(s), %s masks: texture changes %.1f -> %.1f, target changes %.1f -> %.1f per frame\n",
+                maskBufferCount, isUsingHighPrecisionMask ? "high precision" : "shared",
+                static_cast<double>(recordedTextureChanges) / checkedFrameCount, static_cast<double>(sortedTextureChanges) / checkedFrameCount,
+                static_cast<double>(recordedTargetChanges) / checkedFrameCount, static_cast<double>(sortedTargetChanges) / checkedFrameCount);
+
+    CSM_DELETE(model);
+}
+
+// 2つのマスク用バッファにテクスチャが交互のマスクを記録した命令で、並べ替えが切り替えを減らすことを確かめる
+void TestSortGroupsInterleavedTextures()
+{
+    const std::vector<csmByte> mocBuffer = LAppTest::ReadResource(std::string(ModelDirectory) + "Haru.moc3");
+    CubismUserModel* userModel = CSM_NEW CubismUserModel();
+    userModel->LoadModel(mocBuffer.data(), static_cast<csmSizeInt>(mocBuffer.size()));
+    CubismModel* model = userModel->GetModel();
+    LAPP_TEST_CHECK(model != NULL);
+    if (model == NULL)
+    {
+        CSM_DELETE(userModel);
+        return;
+    }
+    model->Update();
+
+    // テクスチャごとの描画オブジェクト
+    std::vector<csmInt32> texture0;
+    std::vector<csmInt32> texture1;
+    for (csmInt32 i = 0; i < model->GetDrawableCount(); ++i)
+    {
+        (model->GetDrawableTextureIndex(i) != 0 ? texture1 : texture0).push_back(i);
+    }
+    LAPP_TEST_CHECK(texture0.size() >= 10 && texture1.size() >= 10);
+    if (texture0.size() < 10 || texture1.size() < 10)
+    {
+        CSM_DELETE(userModel);
+        return;
+    }
+
+    const csmInt32 clippingIds[] = { 0 };
+    CubismClippingContext context0(clippingIds, 1);
+    CubismClippingContext context1(clippingIds, 1);
+    context0._bufferIndex = 1;
+    context1._bufferIndex = 0;
+
+    // バッファ1のマスク、バッファ0のマスクの順に、テクスチャが交互になるように記録する
+    CubismRenderCommandList commandList;
+    commandList.AddClearMaskBuffer(CubismRenderCommandList::PrePassRenderOrder, 1);
+    commandList.AddClearMaskBuffer(CubismRenderCommandList::PrePassRenderOrder, 0);
+    for (int i = 0; i < 4; ++i)
+    {
+        commandList.AddDrawMask(*model, CubismRenderCommandList::PrePassRenderOrder, 0, &context0, (i % 2 != 0 ? texture1 : texture0)[i]);
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        commandList.AddDrawMask(*model, CubismRenderCommandList::PrePassRenderOrder, 1, &context1, (i % 2 != 0 ? texture1 : texture0)[i]);
+    }
+    commandList.AddDraw(*model, 5, &context1, texture0[9]);
+    commandList.AddDraw(*model, 3, NULL, texture1[9]);
+    commandList.AddDraw(*model, 4, &context0, texture0[8]);
+
+    Statistics recorded;
+    Statistics sorted;
+    commandList.CountStateChanges(recorded);
+    commandList.Sort();
+    commandList.CountStateChanges(sorted);
+
+    std::printf("interleaved textures: texture changes %d -> %d, target changes %d -> %d\n",
+                recorded.TextureChangeCount, sorted.TextureChangeCount, recorded.TargetChangeCount, sorted.TargetChangeCount);
+    LAPP_TEST_CHECK(recorded.TextureChangeCount == 11);
+    LAPP_TEST_CHECK(sorted.TextureChangeCount == 5);
+    LAPP_TEST_CHECK(recorded.TargetChangeCount == 5);
+    LAPP_TEST_CHECK(sorted.TargetChangeCount == 3);
+    LAPP_TEST_CHECK(IsStateChangeCountReduced(sorted, recorded));
+
+    // 描画は描画順に並ぶ
+    LAPP_TEST_CHECK(commandList.GetCommand(commandList.GetCommandCount() - 3).DrawableIndex == texture1[9]);
+    LAPP_TEST_CHECK(commandList.GetCommand(commandList.GetCommandCount() - 2).DrawableIndex == texture0[8]);
+    LAPP_TEST_CHECK(commandList.GetCommand(commandList.GetCommandCount() - 1).DrawableIndex == texture0[9]);
+
+    CSM_DELETE(userModel);
+}
+
+}
+
+int main()
+{
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    TestSortKeepsRenderOrder(1, false);
+    TestSortKeepsRenderOrder(2, false);
+    TestSortKeepsRenderOrder(1, true);
+    TestSortGroupsInterleavedTextures();
+
+    return LAppTest::Finish("CubismRenderCommandListTest");
+}
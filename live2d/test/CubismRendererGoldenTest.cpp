@@ -0,0 +1,351 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "GoldenSupport.hpp"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <Math/CubismMatrix44.hpp>
+#include <Rendering/OpenGL/CubismOffscreenSurface_OpenGLES2.hpp>
+#include <Rendering/OpenGL/CubismRenderer_OpenGLES2.hpp>
+#include <zlib.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include "stb_image.h"
+
+using namespace Live2D::Cubism::Framework;
+using namespace Live2D::Cubism::Framework::Rendering;
+using namespace LAppTest;
+
+namespace {
+
+/**
+ * レンダラの設定
+ */
+struct RendererConfig
+{
+    const char* Name;
+    csmInt32 MaskBufferCount;
+    csmBool IsUsingHighPrecisionMask;
+    csmBool IsUsingPackedMaskLayout;
+    csmBool IsUsingDrawBatching;
+    csmBool IsUsingVertexBufferObjects;
+    csmBool IsUsingCooperativeStateMode;
+};
+
+// 全ての設定を同じ参照画像と比べる。参照画像は最初の設定で記録する
+const RendererConfig RendererConfigs[] =
+{
+    { "default",                1, false, false, false, false, false },
+    { "draw batching",          1, false, false, true,  false, false },
+    { "vertex buffer objects",  1, false, false, false, true,  false },
+    { "batching + VBO",         1, false, false, true,  true,  false },
+    { "cooperative state",      1, false, false, true,  true,  true  },
+    { "2 mask buffers",         2, false, false, false, false, false },
+    { "packed mask layout",     1, false, true,  false, false, false },
+    { "high precision mask",    1, true,  false, false, false, false },
+};
+
+/**
+ * 描画先のないEGLのコンテキスト
+ */
+class HeadlessContext
+{
+public:
+    HeadlessContext() : _display(EGL_NO_DISPLAY), _context(EGL_NO_CONTEXT) {}
+
+    ~HeadlessContext()
+    {
+        if (_display != EGL_NO_DISPLAY)
+        {
+            eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (_context != EGL_NO_CONTEXT)
+            {
+                eglDestroyContext(_display, _context);
+            }
+            eglTerminate(_display);
+        }
+    }
+
+    /**
+     * Mesaのsurfacelessプラットフォームでコンテキストを作ってカレントにする
+     */
+    bool Create()
+    {
+        _display = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (_display == EGL_NO_DISPLAY || !eglInitialize(_display, NULL, NULL))
+        {
+            return false;
+        }
+        eglBindAPI(EGL_OPENGL_ES_API);
+
+        const EGLint configAttributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT, EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_NONE };
+        EGLConfig config;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(_display, configAttributes, &config, 1, &configCount) || configCount == 0)
+        {
+            return false;
+        }
+
+        const EGLint contextAttributes[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+        _context = eglCreateContext(_display, config, EGL_NO_CONTEXT, contextAttributes);
+        return _context != EGL_NO_CONTEXT && eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, _context);
+    }
+
+private:
+    EGLDisplay _display;
+    EGLContext _context;
+};
+
+// レンダラを設定し、モデルのテクスチャをGLのテクスチャに読み込む
+bool SetupRenderer(GoldenModel& model, const RendererConfig& config, std::vector<GLuint>& textures)
+{
+    CubismRenderer_OpenGLES2* renderer = model.GetRenderer<CubismRenderer_OpenGLES2>();
+    renderer->UseHighPrecisionMask(config.IsUsingHighPrecisionMask);
+    renderer->UsePackedMaskLayout(config.IsUsingPackedMaskLayout);
+    renderer->UseDrawBatching(config.IsUsingDrawBatching);
+    renderer->UseVertexBufferObjects(config.IsUsingVertexBufferObjects);
+    renderer->UseCooperativeStateMode(config.IsUsingCooperativeStateMode);
+
+    const std::vector<std::string>& texturePaths = model.GetTexturePaths();
+    for (size_t i = 0; i < texturePaths.size(); ++i)
+    {
+        int width = 0;
+        int height = 0;
+        stbi_uc* pixels = LoadResourceImage(texturePaths[i], width, height);
+        if (pixels == NULL)
+        {
+            return false;
+        }
+
+        GLuint texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        stbi_image_free(pixels);
+
+        textures.push_back(texture);
+        renderer->BindTexture(static_cast<csmUint32>(i), texture);
+    }
+    return true;
+}
+
+void AppendBigEndian(std::vector<csmByte>& buffer, csmUint32 value)
+{
+    buffer.push_back(static_cast<csmByte>(value >> 24));
+    buffer.push_back(static_cast<csmByte>(value >> 16));
+    buffer.push_back(static_cast<csmByte>(value >> 8));
+    buffer.push_back(static_cast<csmByte>(value));
+}
+
+void AppendChunk(std::vector<csmByte>& png, const char* type, const std::vector<csmByte>& data)
+{
+    AppendBigEndian(png, static_cast<csmUint32>(data.size()));
+    const size_t typeOffset = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+    AppendBigEndian(png, static_cast<csmUint32>(crc32(0, &png[typeOffset], static_cast<uInt>(png.size() - typeOffset))));
+}
+
+// RGBAの画像をPNGで書き出す。行は下から上の順で渡す
+bool WritePng(const std::string& path, const std::vector<csmByte>& pixels)
+{
+    const size_t rowSize = GoldenImageSize * 4;
+    std::vector<csmByte> filtered;
+    for (int y = GoldenImageSize - 1; y >= 0; --y)
+    {
+        filtered.push_back(0);
+        filtered.insert(filtered.end(), pixels.begin() + y * rowSize, pixels.begin() + (y + 1) * rowSize);
+    }
+    uLongf compressedSize = compressBound(static_cast<uLong>(filtered.size()));
+    std::vector<csmByte> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, filtered.data(), static_cast<uLong>(filtered.size()), Z_BEST_COMPRESSION) != Z_OK)
+    {
+        return false;
+    }
+    compressed.resize(compressedSize);
+
+    std::vector<csmByte> header;
+    AppendBigEndian(header, GoldenImageSize);
+    AppendBigEndian(header, GoldenImageSize);
+    header.push_back(8);    // ビット深度
+    header.push_back(6);    // RGBA
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+
+    const csmByte signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    std::vector<csmByte> png(signature, signature + sizeof(signature));
+    AppendChunk(png, "IHDR", header);
+    AppendChunk(png, "IDAT", compressed);
+    AppendChunk(png, "IEND", std::vector<csmByte>());
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    const bool written = std::fwrite(png.data(), 1, png.size(), file) == png.size();
+    std::fclose(file);
+    return written;
+}
+
+// 1つの設定で全フレームを描画し、参照画像と比べるか記録する
+void RunConfig(const RendererConfig& config, const std::string& referenceDirectory, bool isRecording)
+{
+    GoldenModel* model = CSM_NEW GoldenModel();
+    std::vector<GLuint> textures;
+    if (!model->Setup(config.MaskBufferCount) || !SetupRenderer(*model, config, textures))
+    {
+        LAPP_TEST_CHECK(!"model setup failed");
+        if (!textures.empty())
+        {
+            glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+        }
+        CSM_DELETE(model);
+        return;
+    }
+    CubismRenderer_OpenGLES2* renderer = model->GetRenderer<CubismRenderer_OpenGLES2>();
+
+    CubismOffscreenSurface_OpenGLES2 surface;
+    surface.CreateOffscreenSurface(GoldenImageSize, GoldenImageSize);
+
+    std::vector<csmByte> pixels(GoldenImageSize * GoldenImageSize * 4);
+    std::vector<csmByte> reference;
+    std::vector<double> drawTimes;
+    long issuedGlCalls = 0;
+    long avoidedGlCalls = 0;
+    int glErrors = 0;
+    int failedFrames = 0;
+    double worstPsnr = 99.0;
+
+    for (int frame = 0; frame < GoldenFrameCount; ++frame)
+    {
+        model->Update(frame);
+
+        CubismMatrix44 projection;
+        projection.MultiplyByMatrix(model->GetModelMatrix());
+        renderer->SetMvpMatrix(&projection);
+
+        surface.BeginDraw();
+        glViewport(0, 0, GoldenImageSize, GoldenImageSize);
+        surface.Clear(0.0f, 0.0f, 0.0f, 0.0f);
+        if (config.IsUsingCooperativeStateMode)
+        {
+            GLint framebuffer;
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+            renderer->SetCooperativeRenderTarget(framebuffer, 0, 0, GoldenImageSize, GoldenImageSize);
+        }
+
+        // GPUの処理を含めた時間を測る
+        glFinish();
+        LAppTest::Timer timer;
+        renderer->DrawModel();
+        glFinish();
+        drawTimes.push_back(timer.ElapsedMilliseconds() * 1000.0);
+        surface.EndDraw();
+
+        issuedGlCalls += renderer->GetIssuedGlCallCount();
+        avoidedGlCalls += renderer->GetAvoidedGlCallCount();
+        if (glGetError() != GL_NO_ERROR)
+        {
+            ++glErrors;
+        }
+
+        if (frame % GoldenCheckInterval != 0)
+        {
+            continue;
+        }
+        surface.ReadPixels(pixels.data());
+
+        const std::string path = GetReferencePath(referenceDirectory, frame);
+        if (isRecording)
+        {
+            LAPP_TEST_CHECK(WritePng(path, pixels));
+            continue;
+        }
+        if (!ReadPng(path, reference))
+        {
+            std::printf("  missing reference %s\n", path.c_str());
+            ++failedFrames;
+            continue;
+        }
+        const FrameDifference difference = CompareFrame(reference, pixels);
+        worstPsnr = std::min(worstPsnr, difference.Psnr);
+        if (difference.DifferentPixels > GoldenMaxDifferentPixels)
+        {
+            std::printf("  frame %d: %d pixels over tolerance, max %.1f, PSNR %.1f dB\n",
+                        frame, difference.DifferentPixels, difference.MaxDifference, difference.Psnr);
+            ++failedFrames;
+        }
+    }
+
+    std::sort(drawTimes.begin(), drawTimes.end());
+    double drawTimeSum = 0.0;
+    for (size_t i = 0; i < drawTimes.size(); ++i)
+    {
+        drawTimeSum += drawTimes[i];
+    }
+    std::printf("%-22s draw mean %6.0f us p50 %6.0f us p95 %6.0f us | GL calls/frame %6.1f issued %6.1f avoided",
+                config.Name, drawTimeSum / GoldenFrameCount, drawTimes[GoldenFrameCount / 2], drawTimes[GoldenFrameCount * 95 / 100],
+                static_cast<double>(issuedGlCalls) / GoldenFrameCount, static_cast<double>(avoidedGlCalls) / GoldenFrameCount);
+    if (isRecording)
+    {
+        std::printf(" | recorded\n");
+    }
+    else
+    {
+        std::printf(" | worst PSNR %.1f dB\n", worstPsnr);
+    }
+
+    LAPP_TEST_CHECK(glErrors == 0);
+    LAPP_TEST_CHECK(failedFrames == 0);
+
+    surface.DestroyOffscreenSurface();
+    glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+    CSM_DELETE(model);
+}
+
+}
+
+/**
+ * 使い方: CubismRendererGoldenTest <参照画像のディレクトリ> [--record]
+ *
+ * --recordを付けると、最初の設定で参照画像を記録し直す。
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("usage: %s <reference directory> [--record]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const std::string referenceDirectory = argv[1];
+    const bool isRecording = argc > 2 && std::strcmp(argv[2], "--record") == 0;
+
+    HeadlessContext context;
+    if (!context.Create())
+    {
+        std::printf("cannot create a surfaceless EGL context\n");
+        return EXIT_FAILURE;
+    }
+    std::printf("GL_RENDERER: %s\n", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+
+    LAppTest::Allocator allocator;
+    LAppTest::FrameworkScope framework(&allocator);
+
+    const size_t configCount = isRecording ? 1 : sizeof(RendererConfigs) / sizeof(RendererConfigs[0]);
+    for (size_t i = 0; i < configCount; ++i)
+    {
+        RunConfig(RendererConfigs[i], referenceDirectory, isRecording);
+    }
+
+    return LAppTest::Finish("CubismRendererGoldenTest");
+}
@@ -0,0 +1,188 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "GoldenSupport.hpp"
+#include "LAppJobSystem.hpp"
+#include <Math/CubismMatrix44.hpp>
+#include <Rendering/Software/CubismRenderer_Software.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include "stb_image.h"
+
+using namespace Live2D::Cubism::Framework;
+using namespace Live2D::Cubism::Framework::Rendering;
+using namespace LAppTest;
+
+namespace {
+
+const csmUint32 WorkerCount = 3;
+
+/**
+ * レンダラの設定
+ */
+struct RendererConfig
+{
+    const char* Name;
+    csmInt32 MaskBufferCount;
+    csmBool IsUsingHighPrecisionMask;
+    csmBool IsUsingPackedMaskLayout;
+};
+
+// 全ての設定をOpenGL ES 2.0で記録した同じ参照画像と比べる
+const RendererConfig RendererConfigs[] =
+{
+    { "default",                1, false, false },
+    { "2 mask buffers",         2, false, false },
+    { "packed mask layout",     1, false, true  },
+    { "high precision mask",    1, true,  false },
+};
+
+/**
+ * 1つの設定で描いた結果
+ */
+struct RenderResult
+{
+    std::vector<std::vector<csmByte> > Frames;  ///< GoldenCheckIntervalごとのフレームの画素。行は下から上の順
+    double DrawMilliseconds;                    ///< DrawModelの合計時間
+};
+
+// 1つの設定で全フレームを描き、参照画像と比べるフレームの画素を返す
+bool Render(const RendererConfig& config, RenderResult& result)
+{
+    result.Frames.clear();
+    result.DrawMilliseconds = 0.0;
+
+    GoldenModel* model = CSM_NEW GoldenModel();
+    std::vector<stbi_uc*> textures;
+    bool isReady = model->Setup(config.MaskBufferCount);
+
+    CubismRenderer_Software* renderer = isReady ? model->GetRenderer<CubismRenderer_Software>() : NULL;
+    const std::vector<std::string>& texturePaths = model->GetTexturePaths();
+    for (size_t i = 0; isReady && i < texturePaths.size(); ++i)
+    {
+        int width = 0;
+        int height = 0;
+        textures.push_back(LoadResourceImage(texturePaths[i], width, height));
+        isReady = textures.back() != NULL;
+        if (isReady)
+        {
+            renderer->BindTexture(static_cast<csmUint32>(i), textures.back(), width, height);
+        }
+    }
+
+    if (isReady)
+    {
+        renderer->UseHighPrecisionMask(config.IsUsingHighPrecisionMask);
+        renderer->UsePackedMaskLayout(config.IsUsingPackedMaskLayout);
+
+        std::vector<csmByte> pixels(GoldenImageSize * GoldenImageSize * 4);
+        renderer->SetRenderTarget(pixels.data(), GoldenImageSize, GoldenImageSize);
+
+        for (int frame = 0; frame < GoldenFrameCount; ++frame)
+        {
+            model->Update(frame);
+
+            CubismMatrix44 projection;
+            projection.MultiplyByMatrix(model->GetModelMatrix());
+            renderer->SetMvpMatrix(&projection);
+
+            std::fill(pixels.begin(), pixels.end(), 0);
+            Timer timer;
+            renderer->DrawModel();
+            result.DrawMilliseconds += timer.ElapsedMilliseconds();
+
+            if (frame % GoldenCheckInterval == 0)
+            {
+                result.Frames.push_back(pixels);
+            }
+        }
+    }
+
+    CSM_DELETE(model);
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+        stbi_image_free(textures[i]);
+    }
+    return isReady;
+}
+
+// 1つの設定を直列とジョブシステムで描き、参照画像と許容差の範囲で一致し、直列と並列の結果がバイト単位で一致することを確かめる
+void RunConfig(const RendererConfig& config, const std::string& referenceDirectory, LAppJobSystem& jobSystem)
+{
+    RenderResult serial;
+    RenderResult parallel;
+    LAPP_TEST_CHECK(Render(config, serial));
+
+    CubismFramework::SetJobSystem(&jobSystem);
+    LAPP_TEST_CHECK(Render(config, parallel));
+    CubismFramework::SetJobSystem(NULL);
+
+    std::vector<csmByte> reference;
+    int failedFrames = 0;
+    int mismatchedFrames = 0;
+    double worstPsnr = 99.0;
+    for (size_t i = 0; i < serial.Frames.size(); ++i)
+    {
+        const int frame = static_cast<int>(i) * GoldenCheckInterval;
+        if (i >= parallel.Frames.size() || serial.Frames[i] != parallel.Frames[i])
+        {
+            std::printf("  frame %d: serial and job system output differ\n", frame);
+            ++mismatchedFrames;
+        }
+
+        const std::string path = GetReferencePath(referenceDirectory, frame);
+        if (!ReadPng(path, reference))
+        {
+            std::printf("  missing reference %s\n", path.c_str());
+            ++failedFrames;
+            continue;
+        }
+        const FrameDifference difference = CompareFrame(reference, serial.Frames[i]);
+        worstPsnr = std::min(worstPsnr, difference.Psnr);
+        if (difference.DifferentPixels > GoldenMaxDifferentPixels)
+        {
+            std::printf("  frame %d: %d pixels over tolerance, max %.1f, PSNR %.1f dB\n",
+                        frame, difference.DifferentPixels, difference.MaxDifference, difference.Psnr);
+            ++failedFrames;
+        }
+    }
+
+    std::printf("%-22s draw serial %6.2f ms, %u workers %6.2f ms | worst PSNR %.1f dB\n",
+                config.Name, serial.DrawMilliseconds / GoldenFrameCount, WorkerCount,
+                parallel.DrawMilliseconds / GoldenFrameCount, worstPsnr);
+
+    LAPP_TEST_CHECK(serial.Frames.size() == static_cast<size_t>(GoldenFrameCount / GoldenCheckInterval));
+    LAPP_TEST_CHECK(failedFrames == 0);
+    LAPP_TEST_CHECK(mismatchedFrames == 0);
+}
+
+}
+
+/**
+ * 使い方: CubismRendererSoftwareTest <参照画像のディレクトリ>
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("usage: %s <reference directory>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const std::string referenceDirectory = argv[1];
+
+    Allocator allocator;
+    FrameworkScope framework(&allocator);
+    LAppJobSystem jobSystem(WorkerCount);
+
+    for (size_t i = 0; i < sizeof(RendererConfigs) / sizeof(RendererConfigs[0]); ++i)
+    {
+        RunConfig(RendererConfigs[i], referenceDirectory, jobSystem);
+    }
+
+    return Finish("CubismRendererSoftwareTest");
+}
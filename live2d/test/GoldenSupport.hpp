@@ -0,0 +1,214 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "TestSupport.hpp"
+#include <CubismModelSettingJson.hpp>
+#include <Model/CubismUserModel.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "stb_image.h"
+
+/**
+ * @brief golden/Haruの参照画像と比べるテストで共通に使う処理
+ *
+ * 参照画像はOpenGL ES 2.0のレンダラで記録したもので、どのレンダラも同じモデルの動きを同じ大きさで描いて比べます。
+ */
+namespace LAppTest {
+
+const char* const GoldenModelDirectory = "Haru/";
+const char* const GoldenModelFileName = "Haru.model3.json";
+const int GoldenImageSize = 512;                    ///< 描画先の幅と高さ
+const int GoldenFrameCount = 600;                   ///< 再生するフレーム数
+const int GoldenCheckInterval = 60;                 ///< 参照画像と比べるフレームの間隔
+const int GoldenMotionInterval = 150;               ///< モーションを切り替えるフレームの間隔
+const Csm::csmFloat32 GoldenDeltaTimeSeconds = 1.0f / 60.0f;
+const double GoldenPixelTolerance = 6.0;            ///< 画素が異なるとみなす差(0〜255)
+const int GoldenMaxDifferentPixels = GoldenImageSize * GoldenImageSize / 1000;  ///< 1フレームで許す異なる画素の数(0.1%)
+
+/**
+ * @brief 決まった順にモーションを再生するモデル
+ *
+ * テクスチャは各テストがレンダラに合わせて読み込みます。
+ */
+class GoldenModel : public Csm::CubismUserModel
+{
+public:
+    GoldenModel() : _nextMotion(0) {}
+
+    virtual ~GoldenModel()
+    {
+        for (size_t i = 0; i < _motions.size(); ++i)
+        {
+            Csm::ACubismMotion::Delete(_motions[i]);
+        }
+    }
+
+    /**
+     * @brief モデル、物理演算と、TapBodyの全モーションとIdleの先頭のモーションを読み込み、レンダラを作る
+     */
+    bool Setup(Csm::csmInt32 maskBufferCount)
+    {
+        const std::string directory = GoldenModelDirectory;
+        const std::vector<Csm::csmByte> settingBuffer = ReadResource(directory + GoldenModelFileName);
+        if (settingBuffer.empty())
+        {
+            return false;
+        }
+        Csm::CubismModelSettingJson setting(settingBuffer.data(), static_cast<Csm::csmSizeInt>(settingBuffer.size()));
+
+        const std::vector<Csm::csmByte> mocBuffer = ReadResource(directory + setting.GetModelFileName());
+        LoadModel(mocBuffer.data(), static_cast<Csm::csmSizeInt>(mocBuffer.size()));
+        if (_model == NULL)
+        {
+            return false;
+        }
+
+        const Csm::csmChar* motionGroups[] = { "TapBody", "Idle" };
+        for (size_t group = 0; group < sizeof(motionGroups) / sizeof(motionGroups[0]); ++group)
+        {
+            const Csm::csmInt32 count = (group == 0) ? setting.GetMotionCount(motionGroups[group]) : 1;
+            for (Csm::csmInt32 i = 0; i < count; ++i)
+            {
+                const std::vector<Csm::csmByte> buffer = ReadResource(directory + setting.GetMotionFileName(motionGroups[group], i));
+                _motions.push_back(LoadMotion(buffer.data(), static_cast<Csm::csmSizeInt>(buffer.size()), motionGroups[group]));
+            }
+        }
+        const std::vector<Csm::csmByte> physicsBuffer = ReadResource(directory + setting.GetPhysicsFileName());
+        LoadPhysics(physicsBuffer.data(), static_cast<Csm::csmSizeInt>(physicsBuffer.size()));
+
+        for (Csm::csmInt32 i = 0; i < setting.GetTextureCount(); ++i)
+        {
+            _texturePaths.push_back(directory + setting.GetTextureFileName(i));
+        }
+
+        CreateRenderer(maskBufferCount);
+        return !_motions.empty();
+    }
+
+    /**
+     * @brief Resourcesからのテクスチャのパス。番号はモデルのテクスチャ番号
+     */
+    const std::vector<std::string>& GetTexturePaths() const
+    {
+        return _texturePaths;
+    }
+
+    /**
+     * @brief 1フレーム分パラメータを更新する。GoldenMotionIntervalごとか再生が終わったら次のモーションに切り替える
+     */
+    void Update(int frame)
+    {
+        if (_motionManager->IsFinished() || frame % GoldenMotionInterval == 0)
+        {
+            _motionManager->StartMotionPriority(_motions[_nextMotion], false, 2);
+            _nextMotion = (_nextMotion + 1) % _motions.size();
+        }
+        _model->LoadParameters();
+        _motionManager->UpdateMotion(_model, GoldenDeltaTimeSeconds);
+        _model->SaveParameters();
+        _physics->Evaluate(_model, GoldenDeltaTimeSeconds);
+        _model->Update();
+    }
+
+private:
+    std::vector<Csm::ACubismMotion*> _motions;
+    std::vector<std::string> _texturePaths;
+    size_t _nextMotion;
+};
+
+/**
+ * @brief Resources以下のPNGをRGBAで読み込む。先頭の行は画像の上端
+ *
+ * @return  stbi_image_freeで解放する画素。読めなければNULL
+ */
+inline stbi_uc* LoadResourceImage(const std::string& path, int& width, int& height)
+{
+    const std::vector<Csm::csmByte> png = ReadResource(path);
+    int channels = 0;
+    return stbi_load_from_memory(png.data(), static_cast<int>(png.size()), &width, &height, &channels, STBI_rgb_alpha);
+}
+
+/**
+ * @brief 参照画像のパス
+ */
+inline std::string GetReferencePath(const std::string& referenceDirectory, int frame)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "/frame%04d.png", frame);
+    return referenceDirectory + name;
+}
+
+/**
+ * @brief 参照画像を読み込み、行を下から上の順に並べ替える
+ */
+inline bool ReadPng(const std::string& path, std::vector<Csm::csmByte>& pixels)
+{
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    stbi_uc* image = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (image == NULL || width != GoldenImageSize || height != GoldenImageSize)
+    {
+        stbi_image_free(image);
+        return false;
+    }
+    const size_t rowSize = GoldenImageSize * 4;
+    pixels.resize(rowSize * GoldenImageSize);
+    for (int y = 0; y < GoldenImageSize; ++y)
+    {
+        std::memcpy(&pixels[y * rowSize], image + (GoldenImageSize - 1 - y) * rowSize, rowSize);
+    }
+    stbi_image_free(image);
+    return true;
+}
+
+/**
+ * @brief 1フレームの比較結果
+ */
+struct FrameDifference
+{
+    int DifferentPixels;    ///< 許容差を超えた画素の数
+    double MaxDifference;   ///< 差の最大値
+    double Psnr;            ///< PSNR[dB]
+};
+
+/**
+ * @brief アルファを掛けた色を輝度の重みで比べる。アルファだけの差は半分の重みで数える
+ */
+inline FrameDifference CompareFrame(const std::vector<Csm::csmByte>& expected, const std::vector<Csm::csmByte>& actual)
+{
+    static const double LumaWeights[3] = { 0.299, 0.587, 0.114 };
+
+    FrameDifference result = { 0, 0.0, 0.0 };
+    double squaredErrorSum = 0.0;
+    for (int i = 0; i < GoldenImageSize * GoldenImageSize; ++i)
+    {
+        const Csm::csmByte* a = &expected[i * 4];
+        const Csm::csmByte* b = &actual[i * 4];
+        double difference = 0.0;
+        for (int c = 0; c < 3; ++c)
+        {
+            difference += LumaWeights[c] * std::fabs(a[c] * a[3] / 255.0 - b[c] * b[3] / 255.0);
+        }
+        difference = std::max(difference, std::fabs(static_cast<double>(a[3]) - b[3]) * 0.5);
+
+        squaredErrorSum += difference * difference;
+        result.MaxDifference = std::max(result.MaxDifference, difference);
+        result.DifferentPixels += (difference > GoldenPixelTolerance) ? 1 : 0;
+    }
+    const double meanSquaredError = squaredErrorSum / (GoldenImageSize * GoldenImageSize);
+    result.Psnr = (meanSquaredError == 0.0) ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+    return result;
+}
+
+}
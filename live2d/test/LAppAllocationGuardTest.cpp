@@ -0,0 +1,240 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include "LAppAllocationTracker.hpp"
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+#include <CubismDefaultParameterId.hpp>
+#include <CubismModelSettingJson.hpp>
+#include <Effect/CubismBreath.hpp>
+#include <Effect/CubismEyeBlink.hpp>
+#include <Effect/CubismPose.hpp>
+#include <Id/CubismIdManager.hpp>
+#include <Model/CubismUserModel.hpp>
+#include <Motion/CubismExpressionMotionManager.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <cstdarg>
+
+using namespace Live2D::Cubism::Framework;
+
+// LAppPal.cppはAndroid専用なので、ログ出力だけをここで実装する
+void LAppPal::PrintLogLn(const csmChar* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    std::vprintf(format, args);
+    va_end(args);
+    std::printf("\n");
+}
+
+namespace {
+
+const char* ModelDirectory = "Haru/";
+const char* ModelFileName = "Haru.model3.json";
+const csmChar* MotionGroupIdle = "Idle";
+const csmUint32 WarmUpFrameCount = 10;
+// haru_g_idle(10秒)とharu_g_m15(5.33秒)の後で待機モーションが2回以上再開されるフレーム数
+const int FrameCount = 1300;
+const csmFloat32 DeltaTimeSeconds = 1.0f / 60.0f;
+
+/**
+ * LAppModel::Updateと同じ順序でパラメータを更新するモデル
+ */
+class GuardModel : public CubismUserModel
+{
+public:
+    GuardModel() : _setting(NULL), _nextIdleMotion(0), _idleStartCount(0) {}
+
+    virtual ~GuardModel()
+    {
+        for (size_t i = 0; i < _motions.size(); ++i)
+        {
+            ACubismMotion::Delete(_motions[i]);
+        }
+        for (size_t i = 0; i < _expressions.size(); ++i)
+        {
+            ACubismMotion::Delete(_expressions[i]);
+        }
+        CSM_DELETE(_setting);
+    }
+
+    /**
+     * モデル、待機モーション、表情、物理演算、ポーズ、まばたき、呼吸を読み込む
+     */
+    csmBool Setup()
+    {
+        const std::string directory = ModelDirectory;
+        const std::vector<csmByte> settingBuffer = LAppTest::ReadResource(directory + ModelFileName);
+        if (settingBuffer.empty())
+        {
+            return false;
+        }
+        _setting = CSM_NEW CubismModelSettingJson(settingBuffer.data(), static_cast<csmSizeInt>(settingBuffer.size()));
+
+        const std::vector<csmByte> mocBuffer = LAppTest::ReadResource(directory + _setting->GetModelFileName());
+        LoadModel(mocBuffer.data(), static_cast<csmSizeInt>(mocBuffer.size()));
+        if (_model == NULL)
+        {
+            return false;
+        }
+
+        for (csmInt32 i = 0; i < _setting->GetMotionCount(MotionGroupIdle); ++i)
+        {
+            const std::vector<csmByte> buffer = LAppTest::ReadResource(directory + _setting->GetMotionFileName(MotionGroupIdle, i));
+            _motions.push_back(LoadMotion(buffer.data(), static_cast<csmSizeInt>(buffer.size()), MotionGroupIdle));
+        }
+        for (csmInt32 i = 0; i < _setting->GetExpressionCount(); ++i)
+        {
+            const std::vector<csmByte> buffer = LAppTest::ReadResource(directory + _setting->GetExpressionFileName(i));
+            _expressions.push_back(LoadExpression(buffer.data(), static_cast<csmSizeInt>(buffer.size()), _setting->GetExpressionName(i)));
+        }
+
+        const std::vector<csmByte> physicsBuffer = LAppTest::ReadResource(directory + _setting->GetPhysicsFileName());
+        LoadPhysics(physicsBuffer.data(), static_cast<csmSizeInt>(physicsBuffer.size()));
+        const std::vector<csmByte> poseBuffer = LAppTest::ReadResource(directory + _setting->GetPoseFileName());
+        LoadPose(poseBuffer.data(), static_cast<csmSizeInt>(poseBuffer.size()));
+
+        _eyeBlink = CubismEyeBlink::Create(_setting);
+
+        csmVector<CubismBreath::BreathParameterData> breathParameters;
+        breathParameters.PushBack(CubismBreath::BreathParameterData(CubismFramework::GetIdManager()->GetId(DefaultParameterId::ParamAngleX), 0.0f, 15.0f, 6.5345f, 0.5f));
+        breathParameters.PushBack(CubismBreath::BreathParameterData(CubismFramework::GetIdManager()->GetId(DefaultParameterId::ParamBreath), 0.5f, 0.5f, 3.2345f, 1.0f));
+        _breath = CubismBreath::Create();
+        _breath->SetParameters(breathParameters);
+
+        if (!_expressions.empty())
+        {
+            _expressionManager->StartMotionPriority(_expressions[0], false, 3);
+        }
+
+        return !_motions.empty();
+    }
+
+    /**
+     * 1フレーム分パラメータを更新する
+     */
+    void Update(csmFloat32 deltaTimeSeconds)
+    {
+        csmBool motionUpdated = false;
+
+        _model->LoadParameters();
+        if (_motionManager->IsFinished())
+        {
+            // 待機モーションを順番に再生する
+            _motionManager->StartMotionPriority(_motions[_nextIdleMotion], false, 1);
+            _nextIdleMotion = (_nextIdleMotion + 1) % _motions.size();
+            ++_idleStartCount;
+        }
+        else
+        {
+            motionUpdated = _motionManager->UpdateMotion(_model, deltaTimeSeconds);
+        }
+        _model->SaveParameters();
+
+        if (!motionUpdated)
+        {
+            _eyeBlink->UpdateParameters(_model, deltaTimeSeconds);
+        }
+        _expressionManager->UpdateMotion(_model, deltaTimeSeconds);
+        _breath->UpdateParameters(_model, deltaTimeSeconds);
+        _physics->Evaluate(_model, deltaTimeSeconds);
+        _pose->UpdateParameters(_model, deltaTimeSeconds);
+
+        _model->Update();
+    }
+
+    /**
+     * 最初の再生を除いた待機モーションの再開回数
+     */
+    csmUint32 GetIdleRestartCount() const
+    {
+        return _idleStartCount > 0 ? _idleStartCount - 1 : 0;
+    }
+
+private:
+    ICubismModelSetting* _setting;
+    std::vector<ACubismMotion*> _motions;
+    std::vector<ACubismMotion*> _expressions;
+    size_t _nextIdleMotion;
+    csmUint32 _idleStartCount;
+};
+
+// ウォームアップ後のGuardScope内の確保が違反として数えられることを確かめる
+void TestGuardDetectsAllocation(LAppAllocationTracker& tracker)
+{
+    const csmSizeType violations = tracker.GetViolationCount();
+
+    // ウォームアップ中は数えない
+    tracker.ResetWarmUp();
+    tracker.BeginFrame();
+    {
+        LAppAllocationTracker::GuardScope guard(&tracker, "WarmUp");
+        CSM_FREE(CSM_MALLOC(16));
+    }
+    LAPP_TEST_CHECK(tracker.GetViolationCount() == violations);
+
+    for (csmUint32 i = 0; i < WarmUpFrameCount; ++i)
+    {
+        tracker.BeginFrame();
+    }
+    std::printf("expecting one violation:\n");
+    {
+        LAppAllocationTracker::GuardScope guard(&tracker, "Check");
+        CSM_FREE(CSM_MALLOC(16));
+    }
+    LAPP_TEST_CHECK(tracker.GetViolationCount() == violations + 1);
+
+    // GuardScopeの外では数えない
+    CSM_FREE(CSM_MALLOC(16));
+    LAPP_TEST_CHECK(tracker.GetViolationCount() == violations + 1);
+}
+
+// モデルの更新がウォームアップ後に確保しないことを確かめる
+void TestModelUpdateDoesNotAllocate(LAppAllocationTracker& tracker)
+{
+    GuardModel* model = CSM_NEW GuardModel();
+    LAPP_TEST_CHECK(model->Setup());
+
+    tracker.ResetWarmUp();
+    const csmSizeType violations = tracker.GetViolationCount();
+    for (int frame = 0; frame < FrameCount; ++frame)
+    {
+        tracker.BeginFrame();
+        LAppAllocationTracker::GuardScope guard(&tracker, "GuardModel::Update");
+        model->Update(DeltaTimeSeconds);
+    }
+
+    const csmSizeType frameViolations = tracker.GetViolationCount() - violations;
+    std::printf("%d frames after %u warm-up frames, %u idle motion restarts: %lu allocations in guard\n",
+                FrameCount, WarmUpFrameCount, model->GetIdleRestartCount(), static_cast<unsigned long>(frameViolations));
+    LAPP_TEST_CHECK(model->GetIdleRestartCount() >= 2);
+    if (frameViolations != 0)
+    {
+        tracker.PrintReport(8);
+    }
+    LAPP_TEST_CHECK(frameViolations == 0);
+
+    CSM_DELETE(model);
+}
+
+}
+
+int main()
+{
+    LAppAllocator allocator;
+    LAppAllocationTracker tracker(allocator);
+    tracker.SetWarmUpFrameCount(WarmUpFrameCount);
+    LAppTest::FrameworkScope framework(&tracker);
+
+    TestGuardDetectsAllocation(tracker);
+    TestModelUpdateDoesNotAllocate(tracker);
+
+    return LAppTest::Finish("LAppAllocationGuardTest");
+}
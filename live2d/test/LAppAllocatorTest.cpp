@@ -0,0 +1,212 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "TestSupport.hpp"
+#include "LAppAllocator.hpp"
+#include "LAppPal.hpp"
+#include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+using namespace Live2D::Cubism::Framework;
+
+// LAppPal.cppはAndroid専用なので、ログ出力だけをここで実装する
+void LAppPal::PrintLogLn(const csmChar* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    std::vprintf(format, args);
+    va_end(args);
+    std::printf("\n");
+}
+
+namespace {
+
+const int ThreadCount = 4;
+const int BlocksPerThread = 20000;
+const csmUint32 MaxAlignment = 4096;
+
+/**
+ * ブロックと、書き込んだ値
+ */
+struct TaggedBlock
+{
+    csmUint8* Memory;
+    csmSizeType Size;
+    csmUint8 Tag;
+};
+
+// index番目に確保するブロックのサイズ。全てのサイズクラスと専用領域を含める
+csmSizeType GetBlockSize(int index)
+{
+    return (index % 97 == 0) ? 1000 + index % 3000 : 1 + (index * 37) % LAppAllocator::SmallBlockMaxSize;
+}
+
+// 全てのサイズクラスのブロックとスパンが解放されていることを確かめる
+void CheckNothingUsed(const LAppAllocator& allocator)
+{
+    for (csmUint32 i = 0; i < LAppAllocator::SizeClassCount; ++i)
+    {
+        LAPP_TEST_CHECK(allocator.GetPoolStatistics(i).UsedBlockCount == 0);
+        LAPP_TEST_CHECK(allocator.GetPoolStatistics(i).SpanCount == 0);
+    }
+    LAPP_TEST_CHECK(allocator.GetLargeStatistics().BlockCount == 0);
+    LAPP_TEST_CHECK(allocator.GetLargeStatistics().ByteCount == 0);
+}
+
+// 各スレッドで確保したブロックを別のスレッドで解放し、内容が壊れず、スレッドの終了後に全てプールへ戻ることを確かめる
+void TestCrossThreadFree()
+{
+    LAppAllocator allocator;
+    std::vector<std::vector<TaggedBlock> > blocks(ThreadCount);
+    std::vector<int> corruptedCounts(ThreadCount, 0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.push_back(std::thread([&allocator, &blocks, t]()
+        {
+            for (int i = 0; i < BlocksPerThread; ++i)
+            {
+                TaggedBlock block;
+                block.Size = GetBlockSize(i);
+                block.Memory = static_cast<csmUint8*>(allocator.Allocate(block.Size));
+                block.Tag = static_cast<csmUint8>(t * 61 + i);
+                std::memset(block.Memory, block.Tag, block.Size);
+                blocks[t].push_back(block);
+            }
+        }));
+    }
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads[t].join();
+    }
+    threads.clear();
+
+    // 隣のスレッドが確保したブロックを解放する。解放の前に他のブロックと重なっていないかを確かめる
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.push_back(std::thread([&allocator, &blocks, &corruptedCounts, t]()
+        {
+            std::vector<TaggedBlock>& freed = blocks[(t + 1) % ThreadCount];
+            for (size_t i = 0; i < freed.size(); ++i)
+            {
+                for (csmSizeType j = 0; j < freed[i].Size; ++j)
+                {
+                    if (freed[i].Memory[j] != freed[i].Tag)
+                    {
+                        ++corruptedCounts[t];
+                        break;
+                    }
+                }
+                allocator.Deallocate(freed[i].Memory);
+            }
+        }));
+    }
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads[t].join();
+        LAPP_TEST_CHECK(corruptedCounts[t] == 0);
+    }
+
+    // 解放したスレッドのキャッシュは終了時に持ち主のプールへ戻り、空いたスパンはプール毎に一つを残して解放される
+    for (csmUint32 i = 0; i < LAppAllocator::SizeClassCount; ++i)
+    {
+        const LAppAllocator::PoolStatistics statistics = allocator.GetPoolStatistics(i);
+        LAPP_TEST_CHECK(statistics.UsedBlockCount == 0);
+        LAPP_TEST_CHECK(statistics.SpanCount <= 1);
+        LAPP_TEST_CHECK(statistics.ReleasedSpanCount > 0);
+    }
+
+    allocator.Trim();
+    CheckNothingUsed(allocator);
+}
+
+// 空いたスパンはプール毎に一つだけ残り、Trimでそれも解放されることを確かめる
+void TestTrimReleasesSpans()
+{
+    LAppAllocator allocator;
+    const csmUint32 sizeClass = 3;
+    const csmSizeType blockSize = allocator.GetPoolStatistics(sizeClass).BlockSize;
+
+    // 64KBのスパンが8個以上必要な数を確保する
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8 * 1024; ++i)
+    {
+        blocks.push_back(allocator.Allocate(blockSize));
+    }
+    const LAppAllocator::PoolStatistics allocated = allocator.GetPoolStatistics(sizeClass);
+    LAPP_TEST_CHECK(allocated.SpanCount >= 8);
+    LAPP_TEST_CHECK(allocated.ReleasedSpanCount == 0);
+
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        allocator.Deallocate(blocks[i]);
+    }
+    allocator.Trim();
+
+    const LAppAllocator::PoolStatistics trimmed = allocator.GetPoolStatistics(sizeClass);
+    LAPP_TEST_CHECK(trimmed.UsedBlockCount == 0);
+    LAPP_TEST_CHECK(trimmed.SpanCount == 0);
+    LAPP_TEST_CHECK(trimmed.ReleasedSpanCount == allocated.SpanCount);
+
+    // フレーム用のチャンクは使用中の位置より後ろが解放される
+    const LAppAllocator::FrameMarker marker = allocator.GetFrameMarker();
+    for (int i = 0; i < 64; ++i)
+    {
+        LAPP_TEST_CHECK(allocator.AllocateFrame(16 * 1024) != NULL);
+    }
+    const csmSizeType reserved = allocator.GetFrameStatistics().ReservedByteCount;
+    LAPP_TEST_CHECK(reserved >= 64 * 16 * 1024);
+    allocator.RewindFrame(marker);
+    allocator.Trim();
+    LAPP_TEST_CHECK(allocator.GetFrameStatistics().ReservedByteCount == 0);
+
+    CheckNothingUsed(allocator);
+}
+
+// 4096までの各アライメントで、境界が揃い、要求したサイズの全体に書き込めることを確かめる
+void TestAlignment()
+{
+    LAppAllocator allocator;
+    const csmSizeType sizes[] = { 1, 16, 100, 512, 513, 5000, 70000 };
+
+    for (csmUint32 alignment = 1; alignment <= MaxAlignment; alignment *= 2)
+    {
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+        {
+            csmUint8* memory = static_cast<csmUint8*>(allocator.AllocateAligned(sizes[i], alignment));
+            LAPP_TEST_CHECK(memory != NULL);
+            LAPP_TEST_CHECK(reinterpret_cast<uintptr_t>(memory) % alignment == 0);
+            std::memset(memory, 0xA5, sizes[i]);
+            allocator.DeallocateAligned(memory);
+
+            {
+                LAppAllocator::FrameScope scope(allocator);
+                csmUint8* frameMemory = static_cast<csmUint8*>(allocator.AllocateFrame(sizes[i], alignment));
+                LAPP_TEST_CHECK(frameMemory != NULL);
+                LAPP_TEST_CHECK(reinterpret_cast<uintptr_t>(frameMemory) % alignment == 0);
+                std::memset(frameMemory, 0x5A, sizes[i]);
+            }
+        }
+    }
+
+    allocator.Trim();
+    CheckNothingUsed(allocator);
+}
+
+}
+
+int main()
+{
+    TestCrossThreadFree();
+    TestTrimReleasesSpans();
+    TestAlignment();
+
+    return LAppTest::Finish("LAppAllocatorTest");
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <ICubismAllocator.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * @brief テストで共通に使う処理
+ *
+ * 各テストは単独の実行ファイルで、失敗があれば0以外を返します。
+ * ベンチマークの計測値は標準出力に表示するだけで、判定には使いません。
+ */
+namespace LAppTest {
+
+/**
+ * @brief 失敗数
+ */
+inline int& FailureCount()
+{
+    static int count = 0;
+    return count;
+}
+
+/**
+ * @brief 条件が偽なら失敗として記録する
+ */
+#define LAPP_TEST_CHECK(condition) \
+    do { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++LAppTest::FailureCount(); \
+        } \
+    } while (0)
+
+/**
+ * @brief 結果を表示して終了コードを返す
+ */
+inline int Finish(const char* name)
+{
+    std::printf("%s: %s (%d failures)\n", name, FailureCount() == 0 ? "PASSED" : "FAILED", FailureCount());
+    return FailureCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief mallocを使うアロケータ
+ *
+ * 確保回数を数えるので、処理中の確保の有無を調べられます。
+ */
+class Allocator : public Csm::ICubismAllocator
+{
+public:
+    void* Allocate(const Csm::csmSizeType size) override
+    {
+        ++_allocationCount;
+        return std::malloc(size);
+    }
+
+    void Deallocate(void* memory) override
+    {
+        std::free(memory);
+    }
+
+    void* AllocateAligned(const Csm::csmSizeType size, const Csm::csmUint32 alignment) override
+    {
+        ++_allocationCount;
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void DeallocateAligned(void* alignedMemory) override
+    {
+        std::free(alignedMemory);
+    }
+
+    /**
+     * @brief これまでの確保回数
+     */
+    Csm::csmUint64 GetAllocationCount() const
+    {
+        return _allocationCount.load();
+    }
+
+private:
+    std::atomic<Csm::csmUint64> _allocationCount{0};
+};
+
+/**
+ * @brief スコープの間だけフレームワークを初期化する
+ */
+class FrameworkScope
+{
+public:
+    explicit FrameworkScope(Csm::ICubismAllocator* allocator)
+    {
+        Csm::CubismFramework::StartUp(allocator, &_option);
+        Csm::CubismFramework::Initialize();
+    }
+
+    ~FrameworkScope()
+    {
+        Csm::CubismFramework::Dispose();
+        Csm::CubismFramework::CleanUp();
+    }
+
+private:
+    Csm::CubismFramework::Option _option{};
+};
+
+/**
+ * @brief Resources以下のファイルを読み込む
+ *
+ * @param[in]   path    Resourcesからの相対パス
+ * @return  ファイルの内容。読めなければ空
+ */
+inline std::vector<Csm::csmByte> ReadResource(const std::string& path)
+{
+    std::vector<Csm::csmByte> buffer;
+    std::FILE* file = std::fopen((std::string(LIVE2D_TEST_RESOURCES_PATH) + path).c_str(), "rb");
+    if (file == NULL)
+    {
+        std::printf("cannot open %s\n", path.c_str());
+        return buffer;
+    }
+    std::fseek(file, 0, SEEK_END);
+    buffer.resize(static_cast<size_t>(std::ftell(file)));
+    std::fseek(file, 0, SEEK_SET);
+    if (std::fread(buffer.data(), 1, buffer.size(), file) != buffer.size())
+    {
+        buffer.clear();
+    }
+    std::fclose(file);
+    return buffer;
+}
+
+/**
+ * @brief 経過時間を測る
+ */
+class Timer
+{
+public:
+    Timer() : _start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief 開始からの経過時間[ms]
+     */
+    double ElapsedMilliseconds() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
+
+}
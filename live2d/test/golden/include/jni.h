@@ -0,0 +1,11 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+// FrameworkのOpenGL ESのヘッダはCSM_TARGET_ANDROID_ES2のときに<jni.h>をインクルードするが、中身は使わない。
+// JDKのないホストでゴールデンイメージのテストをビルドするための空のヘッダ。